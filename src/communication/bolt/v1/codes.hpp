@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -78,6 +78,10 @@ enum class Marker : uint8_t {
   Int32 = 0xCA,
   Int64 = 0xCB,
 
+  Bytes8 = 0xCC,
+  Bytes16 = 0xCD,
+  Bytes32 = 0xCE,
+
   String8 = 0xD0,
   String16 = 0xD1,
   String32 = 0xD2,
@@ -65,13 +65,15 @@ class ChunkedDecoderBuffer {
     if (len > Size()) return false;
     memcpy(data, &data_[pos_], len);
     pos_ += len;
-    if (Size() == 0) {
-      pos_ = 0;
-      data_.clear();
-    }
     return true;
   }
 
+  /**
+   * Makes the data which was read since the last chunk was loaded into an
+   * empty buffer readable again, e.g. to execute a message again.
+   */
+  void Rewind() { pos_ = 0; }
+
   /**
    * Peeks data from the internal buffer.
    * Reads data, but doesn't remove it from the buffer.
@@ -118,6 +120,12 @@ class ChunkedDecoderBuffer {
       return ChunkState::Partial;
     }
 
+    // The data which was read completely is dropped only now, so that it
+    // can be read again with `Rewind` until the next chunk is loaded.
+    if (Size() == 0) {
+      pos_ = 0;
+      data_.clear();
+    }
     std::copy(data + 2, data + chunk_size + 2, std::back_inserter(data_));
     buffer_.Shift(chunk_size + 2);
 
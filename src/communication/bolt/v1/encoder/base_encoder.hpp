@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,9 +11,12 @@
 
 #pragma once
 
+#include <limits>
+#include <string_view>
 #include <type_traits>
 
 #include "communication/bolt/v1/codes.hpp"
+#include "communication/bolt/v1/exceptions.hpp"
 #include "communication/bolt/v1/value.hpp"
 #include "utils/cast.hpp"
 #include "utils/endian.hpp"
@@ -97,9 +100,27 @@ class BaseEncoder {
     }
   }
 
-  void WriteString(const std::string &value) {
+  void WriteString(const std::string_view value) {
     WriteTypeSize(value.size(), MarkerString);
-    WriteRAW(value.c_str(), value.size());
+    WriteRAW(value.data(), value.size());
+  }
+
+  /// @throw ClientError if the size doesn't fit the 32-bit size of a byte array
+  void WriteBytes(const uint8_t *data, const size_t size) {
+    if (size > std::numeric_limits<uint32_t>::max()) {
+      throw ClientError("Byte array of {} bytes is too large for Bolt.", size);
+    }
+    if (size <= 255) {
+      WriteRAW(utils::UnderlyingCast(Marker::Bytes8));
+      WriteRAW(static_cast<uint8_t>(size));
+    } else if (size <= 65535) {
+      WriteRAW(utils::UnderlyingCast(Marker::Bytes16));
+      WritePrimitiveValue(static_cast<uint16_t>(size));
+    } else {
+      WriteRAW(utils::UnderlyingCast(Marker::Bytes32));
+      WritePrimitiveValue(static_cast<uint32_t>(size));
+    }
+    WriteRAW(data, size);
   }
 
   void WriteList(const std::vector<Value> &value) {
@@ -0,0 +1,98 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <zlib.h>
+
+#include "communication/bolt/v1/constants.hpp"
+
+namespace memgraph::communication::bolt {
+
+/**
+ * Output stream which compresses everything written to it into a single raw
+ * deflate stream once the compression was negotiated with the client, see
+ * `Enable`.
+ *
+ * The compressed data is flushed to the underlying stream (Z_SYNC_FLUSH)
+ * whenever the writer has nothing more ready (`have_more` is false), so the
+ * client can decompress every response as soon as it arrives, while the
+ * records streamed back to back are compressed together.
+ *
+ * @tparam TOutputStream type of the output stream the compressed data is
+ * written to
+ */
+template <typename TOutputStream>
+class DeflateOutputStream {
+ public:
+  explicit DeflateOutputStream(TOutputStream &output_stream) : output_stream_(output_stream) {}
+
+  DeflateOutputStream(const DeflateOutputStream &) = delete;
+  DeflateOutputStream &operator=(const DeflateOutputStream &) = delete;
+  DeflateOutputStream(DeflateOutputStream &&) = delete;
+  DeflateOutputStream &operator=(DeflateOutputStream &&) = delete;
+
+  ~DeflateOutputStream() {
+    if (enabled_) deflateEnd(&stream_);
+  }
+
+  /**
+   * Compresses all the data written from now on.
+   * @return false if the compressor couldn't be initialized
+   */
+  bool Enable() {
+    if (enabled_) return true;
+    stream_ = z_stream{};
+    // Negative window bits produce raw deflate data without the zlib header,
+    // the same as permessage-deflate in WebSocket.
+    if (deflateInit2(&stream_, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, kMemLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+    // The buffer is allocated only here, uncompressed sessions don't need it.
+    buffer_.resize(kChunkWholeSize);
+    enabled_ = true;
+    return true;
+  }
+
+  bool IsEnabled() const { return enabled_; }
+
+  bool Write(const uint8_t *data, size_t len, bool have_more = false) {
+    if (!enabled_) return output_stream_.Write(data, len, have_more);
+    stream_.next_in = const_cast<Bytef *>(data);
+    stream_.avail_in = static_cast<uInt>(len);
+    const int flush = have_more ? Z_NO_FLUSH : Z_SYNC_FLUSH;
+    // When deflate fills the whole output buffer there may be more output
+    // pending, so it's called until it leaves some of the buffer unused.
+    do {
+      stream_.next_out = buffer_.data();
+      stream_.avail_out = buffer_.size();
+      if (deflate(&stream_, flush) == Z_STREAM_ERROR) return false;
+      const size_t produced = buffer_.size() - stream_.avail_out;
+      if (produced > 0 && !output_stream_.Write(buffer_.data(), produced, have_more || stream_.avail_out == 0)) {
+        return false;
+      }
+    } while (stream_.avail_out == 0);
+    return true;
+  }
+
+ private:
+  static constexpr int kMemLevel = 8;
+
+  TOutputStream &output_stream_;
+  z_stream stream_{};
+  bool enabled_{false};
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace memgraph::communication::bolt
@@ -32,6 +32,17 @@ class ClientError : public utils::BasicException {
   using utils::BasicException::BasicException;
 };
 
+/**
+ * Thrown by `Session::Interpret` when the query can't be executed yet, e.g.
+ * because it waits for admission. It isn't sent to the client. The session
+ * stops executing and executes the same message again once it's resumed, see
+ * `Session::AwaitResume`.
+ */
+class SessionSuspendedException : public utils::BasicException {
+ public:
+  SessionSuspendedException() : utils::BasicException("The execution of the session is suspended.") {}
+};
+
 /**
  * All exceptions that are sent to the client consist of two parts. The first
  * part is `code` it specifies the type of exception that was raised. The second
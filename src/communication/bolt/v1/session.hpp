@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,14 +11,20 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "communication/bolt/v1/constants.hpp"
 #include "communication/bolt/v1/decoder/chunked_decoder_buffer.hpp"
 #include "communication/bolt/v1/decoder/decoder.hpp"
 #include "communication/bolt/v1/encoder/chunked_encoder_buffer.hpp"
+#include "communication/bolt/v1/encoder/deflate_output_stream.hpp"
 #include "communication/bolt/v1/encoder/encoder.hpp"
+#include "communication/bolt/v1/exceptions.hpp"
 #include "communication/bolt/v1/state.hpp"
 #include "communication/bolt/v1/states/error.hpp"
 #include "communication/bolt/v1/states/executing.hpp"
@@ -39,6 +45,58 @@ class SessionException : public utils::BasicException {
   using utils::BasicException::BasicException;
 };
 
+/**
+ * Output stream of a Bolt session which holds back the responses to the
+ * pipelined messages, see `Session::SetPipelining`.
+ *
+ * @tparam TOutputStream type of the output stream the responses are written to
+ */
+template <typename TOutputStream>
+class PipelinedOutputStream {
+ public:
+  /**
+   * @param before_release called before the held responses are written, also
+   * when too much output was held back in the middle of a pipeline
+   */
+  PipelinedOutputStream(TOutputStream &output_stream, std::function<void()> before_release)
+      : output_stream_(output_stream), before_release_(std::move(before_release)) {}
+
+  bool Write(const uint8_t *data, size_t len, bool have_more = false) {
+    if (!holding_) return output_stream_.Write(data, len, have_more);
+    held_.insert(held_.end(), data, data + len);
+    if (held_.size() < kMaxHeldSize) return true;
+    return Release(true);
+  }
+
+  /** Holds back all the output until `Release` is called. */
+  void Hold() { holding_ = true; }
+
+  /**
+   * Writes the held output to the output stream.
+   * @param keep_holding whether the output written afterwards is held back too
+   */
+  bool Release(bool keep_holding = false) {
+    holding_ = keep_holding;
+    if (held_.empty()) return true;
+    before_release_();
+    const auto ret = output_stream_.Write(held_.data(), held_.size());
+    held_.clear();
+    return ret;
+  }
+
+  bool IsHolding() const { return holding_; }
+
+ private:
+  // Bounds the memory of a session whose pipelined queries return a lot of
+  // results.
+  static constexpr size_t kMaxHeldSize = 4UL * 1024 * 1024;
+
+  TOutputStream &output_stream_;
+  std::function<void()> before_release_;
+  std::vector<uint8_t> held_;
+  bool holding_{false};
+};
+
 /**
  * Bolt Session
  *
@@ -50,7 +108,8 @@ class SessionException : public utils::BasicException {
 template <typename TInputStream, typename TOutputStream>
 class Session {
  public:
-  using TEncoder = Encoder<ChunkedEncoderBuffer<TOutputStream>>;
+  using TCompressedOutputStream = DeflateOutputStream<TOutputStream>;
+  using TEncoder = Encoder<ChunkedEncoderBuffer<PipelinedOutputStream<TCompressedOutputStream>>>;
 
   Session(TInputStream *input_stream, TOutputStream *output_stream)
       : input_stream_(*input_stream), output_stream_(*output_stream) {}
@@ -58,12 +117,15 @@ class Session {
   virtual ~Session() {}
 
   /**
-   * Process the given `query` with `params`.
-   * @return A pair which contains list of headers and qid which is set only
-   * if an explicit transaction was started.
+   * Process the given `query` with `params` and the `extra` fields of the RUN
+   * message.
+   * @return A pair which contains list of headers and the metadata which is
+   * sent with them, e.g. qid which is set only if an explicit transaction was
+   * started.
    */
-  virtual std::pair<std::vector<std::string>, std::optional<int>> Interpret(
-      const std::string &query, const std::map<std::string, Value> &params) = 0;
+  virtual std::pair<std::vector<std::string>, std::map<std::string, Value>> Interpret(
+      const std::string &query, const std::map<std::string, Value> &params,
+      const std::map<std::string, Value> &extra) = 0;
 
   /**
    * Put results of the processed query in the `encoder`.
@@ -99,6 +161,49 @@ class Session {
    * message. */
   virtual std::optional<std::string> GetServerNameForInit() = 0;
 
+  /**
+   * Called with true before executing a message which the client pipelined,
+   * i.e. which is followed by more already received input, and with false
+   * before executing a message which isn't. The responses to the pipelined
+   * messages are held back and sent together after `FlushDeferredCommits`,
+   * so the session may e.g. group the commits of the pipelined queries.
+   */
+  virtual void SetPipelining(bool /*pipelining*/) {}
+
+  /**
+   * Makes the commits done while pipelining durable. Called before the
+   * held back responses, which acknowledge the commits, are sent.
+   */
+  virtual void FlushDeferredCommits() {}
+
+  /**
+   * Called by the network session when `Execute` returned with
+   * `IsSuspended()`, see `SessionSuspendedException`. `resume` has to be
+   * called once the suspended message can be executed again, possibly right
+   * away and from another thread. `Execute` is then called again without
+   * reading more input.
+   */
+  virtual void AwaitResume(std::function<void()> resume) { resume(); }
+
+  /** Returns whether the execution stopped at a message which has to be executed again. */
+  bool IsSuspended() const { return suspended_; }
+
+  /**
+   * Return `true` if the client may ask for the compression of the output in
+   * the Bolt INIT message, see `EnableCompression`.
+   */
+  virtual bool IsCompressionAllowed() { return false; }
+
+  /**
+   * Compresses all the output written from now on. The output written so far,
+   * e.g. the response which confirms the compression to the client, is sent
+   * uncompressed before that.
+   */
+  bool EnableCompression() {
+    if (!pipelined_output_.Release(pipelined_output_.IsHolding())) return false;
+    return compressed_output_.Enable();
+  }
+
   /**
    * Executes the session after data has been read into the buffer.
    * Goes through the bolt states in order to execute commands from the client.
@@ -122,29 +227,47 @@ class Session {
       handshake_done_ = true;
     }
 
-    ChunkState chunk_state;
-    while ((chunk_state = decoder_buffer_.GetChunk()) != ChunkState::Partial) {
-      if (chunk_state == ChunkState::Whole) {
+    // A suspended message is still whole in the decoder buffer, so it's
+    // executed again before any more input.
+    bool resumed = std::exchange(suspended_, false);
+    ChunkState chunk_state{ChunkState::Done};
+    while (resumed || (chunk_state = decoder_buffer_.GetChunk()) != ChunkState::Partial) {
+      if (!resumed && chunk_state == ChunkState::Whole) {
         // The chunk is whole, we need to read one more chunk
         // (the 0x00 0x00 end marker).
         continue;
       }
+      resumed = false;
 
-      switch (state_) {
-        case State::Init:
-          state_ = StateInitRun(*this);
-          break;
-        case State::Idle:
-        case State::Result:
-          state_ = StateExecutingRun(*this, state_);
-          break;
-        case State::Error:
-          state_ = StateErrorRun(*this, state_);
-          break;
-        default:
-          // State::Handshake is handled above
-          // State::Close is handled below
-          break;
+      // The client didn't wait for the response before sending more input.
+      const bool pipelined = input_stream_.size() > 0;
+      if (pipelined && !pipelined_output_.IsHolding()) {
+        pipelined_output_.Hold();
+      }
+      SetPipelining(pipelined);
+
+      try {
+        switch (state_) {
+          case State::Init:
+            state_ = StateInitRun(*this);
+            break;
+          case State::Idle:
+          case State::Result:
+            state_ = StateExecutingRun(*this, state_);
+            break;
+          case State::Error:
+            state_ = StateErrorRun(*this, state_);
+            break;
+          default:
+            // State::Handshake is handled above
+            // State::Close is handled below
+            break;
+        }
+      } catch (const SessionSuspendedException &) {
+        // The responses to the messages executed so far are still sent.
+        decoder_buffer_.Rewind();
+        suspended_ = true;
+        break;
       }
 
       // State::Close is handled here because we always want to check for
@@ -155,6 +278,11 @@ class Session {
         return;
       }
     }
+    SetPipelining(false);
+    if (!pipelined_output_.Release()) {
+      spdlog::trace("Couldn't send the responses to the pipelined messages!");
+      ClientFailureInvalidData();
+    }
   }
 
   // TODO: Rethink if there is a way to hide some members. At the momement all
@@ -162,13 +290,17 @@ class Session {
   TInputStream &input_stream_;
   TOutputStream &output_stream_;
 
-  ChunkedEncoderBuffer<TOutputStream> encoder_buffer_{output_stream_};
+  TCompressedOutputStream compressed_output_{output_stream_};
+  PipelinedOutputStream<TCompressedOutputStream> pipelined_output_{compressed_output_,
+                                                                   [this] { FlushDeferredCommits(); }};
+  ChunkedEncoderBuffer<PipelinedOutputStream<TCompressedOutputStream>> encoder_buffer_{pipelined_output_};
   TEncoder encoder_{encoder_buffer_};
 
   ChunkedDecoderBuffer<TInputStream> decoder_buffer_{input_stream_};
   Decoder<ChunkedDecoderBuffer<TInputStream>> decoder_{decoder_buffer_};
 
   bool handshake_done_{false};
+  bool suspended_{false};
   State state_{State::Handshake};
 
   struct Version {
@@ -189,6 +321,8 @@ class Session {
                              {"message",
                               "Something went wrong while executing the query! "
                               "Check the server logs for more details."}});
+    SetPipelining(false);
+    pipelined_output_.Release();
     // Throw an exception to indicate that something went wrong with execution
     // of the session to trigger session cleanup and socket close.
     throw SessionException("Something went wrong during session execution!");
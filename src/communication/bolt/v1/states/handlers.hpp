@@ -209,7 +209,7 @@ State HandleRunV1(TSession &session, const State state, const Marker marker) {
 
   try {
     // Interpret can throw.
-    const auto [header, qid] = session.Interpret(query.ValueString(), params.ValueMap());
+    auto [header, metadata] = session.Interpret(query.ValueString(), params.ValueMap(), {});
     // Convert std::string to Value
     std::vector<Value> vec;
     std::map<std::string, Value> data;
@@ -222,6 +222,8 @@ State HandleRunV1(TSession &session, const State state, const Marker marker) {
       return State::Close;
     }
     return State::Result;
+  } catch (const SessionSuspendedException &) {
+    throw;
   } catch (const std::exception &e) {
     return HandleFailure(session, e);
   }
@@ -250,6 +252,7 @@ State HandleRunV4(TSession &session, const State state, const Marker marker) {
   // Even though this part seems unnecessary it is needed to move the buffer
   if (!session.decoder_.ReadValue(&extra, Value::Type::Map)) {
     spdlog::trace("Couldn't read extra field!");
+    extra = std::map<std::string, Value>{};
   }
 
   if (state != State::Idle) {
@@ -266,16 +269,13 @@ State HandleRunV4(TSession &session, const State state, const Marker marker) {
 
   try {
     // Interpret can throw.
-    const auto [header, qid] = session.Interpret(query.ValueString(), params.ValueMap());
+    auto [header, metadata] = session.Interpret(query.ValueString(), params.ValueMap(), extra.ValueMap());
     // Convert std::string to Value
     std::vector<Value> vec;
-    std::map<std::string, Value> data;
+    std::map<std::string, Value> data = std::move(metadata);
     vec.reserve(header.size());
     for (auto &i : header) vec.emplace_back(std::move(i));
     data.emplace("fields", std::move(vec));
-    if (qid.has_value()) {
-      data.emplace("qid", Value{*qid});
-    }
 
     // Send the header.
     if (!session.encoder_.MessageSuccess(data)) {
@@ -283,6 +283,8 @@ State HandleRunV4(TSession &session, const State state, const Marker marker) {
       return State::Close;
     }
     return State::Result;
+  } catch (const SessionSuspendedException &) {
+    throw;
   } catch (const std::exception &e) {
     return HandleFailure(session, e);
   }
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -13,6 +13,7 @@
 
 #include <fmt/format.h>
 #include <optional>
+#include <string_view>
 
 #include "communication/bolt/v1/codes.hpp"
 #include "communication/bolt/v1/state.hpp"
@@ -117,8 +118,28 @@ std::optional<Value> GetMetadataV4(TSession &session, const Marker marker) {
   return metadata;
 }
 
+// The only compression of the output which the client can ask for with the
+// "compression" field of the HELLO message.
+inline constexpr std::string_view kCompressionDeflate = "deflate";
+
 template <typename TSession>
-State SendSuccessMessage(TSession &session) {
+bool IsCompressionRequested(TSession &session, const Value &metadata) {
+  const auto &data = metadata.ValueMap();
+  auto it = data.find("compression");
+  if (it == data.end()) return false;
+  if (!it->second.IsString() || it->second.ValueString() != kCompressionDeflate) {
+    spdlog::warn("Unsupported compression requested by the client, the output won't be compressed!");
+    return false;
+  }
+  if (!session.IsCompressionAllowed()) {
+    spdlog::debug("The client requested compression which isn't allowed, the output won't be compressed.");
+    return false;
+  }
+  return true;
+}
+
+template <typename TSession>
+State SendSuccessMessage(TSession &session, bool compress = false) {
   // Neo4j's Java driver 4.1.1+ requires connection_id.
   // The only usage in the mentioned version is for logging purposes.
   // Because it's not critical for the regular usage of the driver
@@ -127,11 +148,18 @@ State SendSuccessMessage(TSession &session) {
   if (auto server_name = session.GetServerNameForInit(); server_name) {
     metadata.insert({"server", *server_name});
   }
+  if (compress) {
+    metadata.insert({"compression", std::string(kCompressionDeflate)});
+  }
   bool success_sent = session.encoder_.MessageSuccess(metadata);
   if (!success_sent) {
     spdlog::trace("Couldn't send success message to the client!");
     return State::Close;
   }
+  if (compress && !session.EnableCompression()) {
+    spdlog::trace("Couldn't enable the compression of the output!");
+    return State::Close;
+  }
 
   return State::Idle;
 }
@@ -178,7 +206,7 @@ State StateInitRunV4(TSession &session, Marker marker, Signature signature) {
     return result.value();
   }
 
-  return SendSuccessMessage(session);
+  return SendSuccessMessage(session, IsCompressionRequested(session, *maybeMetadata));
 }
 }  // namespace details
 
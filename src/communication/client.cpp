@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -74,6 +74,13 @@ bool Client::Connect(const io::network::Endpoint &endpoint) {
       socket_.Close();
       return false;
     }
+
+    // The reads and the writes may be done from different threads, and they
+    // are serialized on `ssl_lock_`. The socket is non-blocking so that
+    // neither of them waits for the socket while holding the lock, otherwise a
+    // writer blocked on a full socket would keep the reader from receiving
+    // the data the other side waits to send before reading more.
+    socket_.SetNonBlocking();
   }
 
   return true;
@@ -101,6 +108,17 @@ bool Client::Read(size_t len, bool exactly_len) {
   do {
     auto buff = buffer_.write_end()->Allocate();
     if (ssl_) {
+      // The reads can run concurrently with the writes from another thread,
+      // which OpenSSL doesn't allow on the same SSL object, so the calls are
+      // serialized. The wait for new data is done without holding the lock
+      // so that the writes aren't blocked by an idle connection.
+      std::unique_lock<std::mutex> guard(ssl_lock_);
+      if (SSL_pending(ssl_) == 0) {
+        guard.unlock();
+        if (!socket_.WaitForReadyRead()) return false;
+        guard.lock();
+      }
+
       // We clear errors here to prevent errors piling up in the internal
       // OpenSSL error queue. To see when could that be an issue read this:
       // https://www.arangodb.com/2014/07/started-hate-openssl/
@@ -112,10 +130,10 @@ bool Client::Read(size_t len, bool exactly_len) {
       // Handle errors that might have occurred.
       if (got < 0) {
         auto err = SSL_get_error(ssl_, got);
+        guard.unlock();
         if (err == SSL_ERROR_WANT_READ) {
-          // OpenSSL want's to read more data from the socket. We wait for
-          // more data to be ready and retry the call.
-          socket_.WaitForReadyRead();
+          // OpenSSL want's to read more data from the socket. We retry the
+          // call after more data is ready.
           continue;
         } else if (err == SSL_ERROR_WANT_WRITE) {
           // The OpenSSL library probably wants to perform some kind of
@@ -174,10 +192,14 @@ bool Client::Write(const uint8_t *data, size_t len, bool have_more) {
       // https://www.arangodb.com/2014/07/started-hate-openssl/
       ERR_clear_error();
 
-      // Write data to the socket using OpenSSL.
+      // Write data to the socket using OpenSSL. The socket is non-blocking, so
+      // the lock is held only while OpenSSL processes the data and the waits
+      // are done without it.
+      std::unique_lock<std::mutex> guard(ssl_lock_);
       auto written = SSL_write(ssl_, data, len);
-      if (written < 0) {
+      if (written <= 0) {
         auto err = SSL_get_error(ssl_, written);
+        guard.unlock();
         if (err == SSL_ERROR_WANT_READ) {
           // OpenSSL wants to perform some kind of handshake, we need to
           // ensure that there is data available for the next call to
@@ -188,12 +210,9 @@ bool Client::Write(const uint8_t *data, size_t len, bool have_more) {
           // the output buffers to clear and reattempt the send.
           socket_.WaitForReadyWrite();
         } else {
-          // This is a fatal error.
+          // This is a fatal error, or the connection was closed.
           return false;
         }
-      } else if (written == 0) {
-        // The client closed the connection.
-        return false;
       } else {
         len -= written;
         data += written;
@@ -209,6 +228,18 @@ bool Client::Write(const std::string &str, bool have_more) {
   return Write(reinterpret_cast<const uint8_t *>(str.data()), str.size(), have_more);
 }
 
+bool Client::Write(std::span<const std::span<const uint8_t>> buffers, bool have_more) {
+  if (ssl_) {
+    // OpenSSL has no scatter-gather writes, so the buffers are written one by
+    // one.
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      if (!Write(buffers[i].data(), buffers[i].size(), have_more || i + 1 < buffers.size())) return false;
+    }
+    return true;
+  }
+  return socket_.Write(buffers, have_more);
+}
+
 const io::network::Endpoint &Client::endpoint() { return socket_.endpoint(); }
 
 void Client::ReleaseSslObjects() {
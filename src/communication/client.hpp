@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -15,6 +15,9 @@
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 
+#include <mutex>
+#include <span>
+
 #include "communication/buffer.hpp"
 #include "communication/context.hpp"
 #include "communication/init.hpp"
@@ -26,7 +29,8 @@ namespace memgraph::communication {
 /**
  * This class implements a generic network Client.
  * It uses blocking sockets and provides an API that can be used to receive/send
- * data over the network connection.
+ * data over the network connection. One thread may read from the client while
+ * another one writes to it.
  *
  * NOTE: If you use this client you **must** create `memgraph::communication::SSLInit`
  * from the `main` function before using the client!
@@ -110,6 +114,13 @@ class Client final {
    */
   bool Write(const std::string &str, bool have_more = false);
 
+  /**
+   * This function writes all of the buffers to the socket, one after another.
+   * Without OpenSSL they are written with scatter-gather I/O, so that they
+   * don't have to be copied into a single buffer first.
+   */
+  bool Write(std::span<const std::span<const uint8_t>> buffers, bool have_more = false);
+
   const io::network::Endpoint &endpoint();
 
  private:
@@ -121,6 +132,10 @@ class Client final {
   ClientContext *context_;
   SSL *ssl_{nullptr};
   BIO *bio_{nullptr};
+  // Serializes the calls on `ssl_` between the reading and the writing thread.
+  // The socket is non-blocking when SSL is used, so the lock is never held
+  // while waiting for the socket.
+  std::mutex ssl_lock_;
 };
 
 /**
@@ -163,6 +178,13 @@ class ClientOutputStream final {
 
   bool Write(const std::string &str, bool have_more = false);
 
+  /**
+   * This function writes all of the buffers to the socket, one after another.
+   * Without OpenSSL they are written with scatter-gather I/O, so that they
+   * don't have to be copied into a single buffer first.
+   */
+  bool Write(std::span<const std::span<const uint8_t>> buffers, bool have_more = false);
+
  private:
   Client &client_;
 };
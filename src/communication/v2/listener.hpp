@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -32,6 +32,7 @@
 #include "communication/v2/session.hpp"
 #include "utils/spin_lock.hpp"
 #include "utils/synchronized.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace memgraph::communication::v2 {
 
@@ -59,14 +60,17 @@ class Listener final : public std::enable_shared_from_this<Listener<TSession, TS
 
  private:
   Listener(boost::asio::io_context &io_context, TSessionData *data, ServerContext *server_context,
-           tcp::endpoint &endpoint, const std::string_view service_name, const uint64_t inactivity_timeout_sec)
+           tcp::endpoint &endpoint, const std::string_view service_name, const uint64_t inactivity_timeout_sec,
+           utils::ThreadPool *execution_pool, const bool websocket_compression)
       : io_context_(io_context),
         data_(data),
         server_context_(server_context),
         acceptor_(io_context_),
         endpoint_{endpoint},
         service_name_{service_name},
-        inactivity_timeout_{inactivity_timeout_sec} {
+        inactivity_timeout_{inactivity_timeout_sec},
+        execution_pool_{execution_pool},
+        websocket_compression_{websocket_compression} {
     boost::system::error_code ec;
     // Open the acceptor
     acceptor_.open(endpoint.protocol(), ec);
@@ -111,7 +115,7 @@ class Listener final : public std::enable_shared_from_this<Listener<TSession, TS
     }
 
     auto session = SessionHandler::Create(std::move(socket), data_, *server_context_, endpoint_, inactivity_timeout_,
-                                          service_name_);
+                                          service_name_, execution_pool_, websocket_compression_);
     session->Start();
     DoAccept();
   }
@@ -129,6 +133,8 @@ class Listener final : public std::enable_shared_from_this<Listener<TSession, TS
   tcp::endpoint endpoint_;
   std::string_view service_name_;
   std::chrono::seconds inactivity_timeout_;
+  utils::ThreadPool *execution_pool_;
+  bool websocket_compression_;
 
   std::atomic<bool> alive_;
 };
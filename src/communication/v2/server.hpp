@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -32,6 +32,7 @@
 #include "utils/logging.hpp"
 #include "utils/message.hpp"
 #include "utils/thread.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace memgraph::communication::v2 {
 
@@ -70,17 +71,25 @@ class Server final {
  public:
   /**
    * Constructs and binds server to endpoint, operates on session data and
-   * invokes workers_count workers
+   * invokes workers_count workers for network I/O. If execution_workers_count
+   * is positive, sessions execute their input in a separate pool of that many
+   * workers, otherwise they execute it on the I/O workers. If
+   * websocket_compression is set, the clients connecting over WebSocket may
+   * negotiate the permessage-deflate extension.
    */
   Server(ServerEndpoint &endpoint, TSessionData *session_data, ServerContext *server_context,
          const int inactivity_timeout_sec, const std::string_view service_name,
-         size_t workers_count = std::thread::hardware_concurrency())
+         size_t workers_count = std::thread::hardware_concurrency(), size_t execution_workers_count = 0,
+         bool websocket_compression = false)
       : endpoint_{endpoint},
         service_name_{service_name},
         context_thread_pool_{workers_count},
+        execution_pool_{execution_workers_count > 0 ? std::make_unique<utils::ThreadPool>(execution_workers_count)
+                                                    : nullptr},
         listener_{Listener<TSession, TSessionData>::Create(context_thread_pool_.GetIOContext(), session_data,
                                                            server_context, endpoint_, service_name_,
-                                                           inactivity_timeout_sec)} {}
+                                                           inactivity_timeout_sec, execution_pool_.get(),
+                                                           websocket_compression)} {}
 
   ~Server() { MG_ASSERT(!IsRunning(), "Server wasn't shutdown properly"); }
 
@@ -113,7 +122,12 @@ class Server final {
     spdlog::info("{} shutting down...", service_name_);
   }
 
-  void AwaitShutdown() { context_thread_pool_.AwaitShutdown(); }
+  void AwaitShutdown() {
+    context_thread_pool_.AwaitShutdown();
+    if (execution_pool_) {
+      execution_pool_->Shutdown();
+    }
+  }
 
   bool IsRunning() const noexcept { return context_thread_pool_.IsRunning() && listener_->IsRunning(); }
 
@@ -122,6 +136,9 @@ class Server final {
   std::string service_name_;
 
   IOContextThreadPool context_thread_pool_;
+  /// Sessions execute their input in this pool, leaving the io threads only
+  /// for network I/O. Without it, the input is executed on the io threads.
+  std::unique_ptr<utils::ThreadPool> execution_pool_;
   std::shared_ptr<Listener<TSession, TSessionData>> listener_;
 };
 
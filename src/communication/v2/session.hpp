@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -18,15 +19,18 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/socket_base.hpp>
 #include <boost/asio/ssl/stream.hpp>
@@ -41,9 +45,12 @@
 #include <boost/beast/websocket/rfc6455.hpp>
 #include <boost/system/detail/error_code.hpp>
 
+#include <sys/socket.h>
+
 #include "communication/context.hpp"
 #include "communication/exceptions.hpp"
 #include "utils/logging.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/variant_helpers.hpp"
 
 namespace memgraph::communication::v2 {
@@ -55,6 +62,14 @@ namespace memgraph::communication::v2 {
 using InputStream = communication::Buffer::ReadEnd;
 using tcp = boost::asio::ip::tcp;
 
+/// Output of a `Session` is collected into blocks of this size before being
+/// written to the socket.
+inline constexpr size_t kOutputBlockSize = 256UL * 1024;
+
+/// When more output than this is pending while the session is executing, it
+/// is written to the socket before the execution continues.
+inline constexpr size_t kMaxPendingOutputSize = 4UL * 1024 * 1024;
+
 /**
  * This is used to provide output from user Sessions. All Sessions used with the
  * network stack should use this class for their output stream.
@@ -117,6 +132,12 @@ class WebsocketSession : public std::enable_shared_from_this<WebsocketSession<TS
       }
     }));
     ws_.binary(true);
+    if (compression_) {
+      // Used only if the client offers the extension in its upgrade request.
+      boost::beast::websocket::permessage_deflate deflate;
+      deflate.server_enable = true;
+      ws_.set_option(deflate);
+    }
 
     // Accept the websocket handshake
     ws_.async_accept(
@@ -140,14 +161,15 @@ class WebsocketSession : public std::enable_shared_from_this<WebsocketSession<TS
  private:
   // Take ownership of the socket
   explicit WebsocketSession(tcp::socket &&socket, TSessionData *data, tcp::endpoint endpoint,
-                            std::string_view service_name)
+                            std::string_view service_name, const bool compression)
       : ws_(std::move(socket)),
         strand_{boost::asio::make_strand(ws_.get_executor())},
         output_stream_([this](const uint8_t *data, size_t len, bool /*have_more*/) { return Write(data, len); }),
         session_(data, endpoint, input_buffer_.read_end(), &output_stream_),
         endpoint_{endpoint},
         remote_endpoint_{ws_.next_layer().socket().remote_endpoint()},
-        service_name_{service_name} {}
+        service_name_{service_name},
+        compression_{compression} {}
 
   void OnAccept(boost::beast::error_code ec) {
     if (ec) {
@@ -178,10 +200,13 @@ class WebsocketSession : public std::enable_shared_from_this<WebsocketSession<TS
       OnError(ec, "read");
     }
     input_buffer_.write_end()->Written(bytes_transferred);
+    DoExecute();
+  }
 
+  void DoExecute() {
     try {
       session_.Execute();
-      DoRead();
+      DoContinue();
     } catch (const SessionClosedException &e) {
       spdlog::info("{} client {}:{} closed the connection.", service_name_, remote_endpoint_.address(),
                    remote_endpoint_.port());
@@ -196,6 +221,27 @@ class WebsocketSession : public std::enable_shared_from_this<WebsocketSession<TS
     }
   }
 
+  /// Reads more input, or waits until a suspended session can be resumed
+  /// without reading any.
+  void DoContinue() {
+    if (!IsConnected()) {
+      return;
+    }
+    if (!session_.IsSuspended()) {
+      return DoRead();
+    }
+    session_.AwaitResume([shared_this = shared_from_this()] {
+      boost::asio::post(shared_this->strand_, [shared_this] { shared_this->OnResume(); });
+    });
+  }
+
+  void OnResume() {
+    if (!IsConnected()) {
+      return;
+    }
+    DoExecute();
+  }
+
   void OnError(const boost::system::error_code &ec, const std::string_view action) {
     spdlog::error("Websocket Bolt session error: {} on {}", ec.message(), action);
 
@@ -229,6 +275,7 @@ class WebsocketSession : public std::enable_shared_from_this<WebsocketSession<TS
   tcp::endpoint endpoint_;
   tcp::endpoint remote_endpoint_;
   std::string_view service_name_;
+  bool compression_;
   bool execution_active_{false};
 };
 
@@ -270,39 +317,29 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
     return true;
   }
 
-  bool Write(const uint8_t *data, size_t len, bool have_more = false) {
+  /// Output is only collected here while the session is executing. It is
+  /// sent with a single gather write once the execution is done, see
+  /// `DoWrite`, or synchronously when too much of it piles up, see
+  /// `FlushPendingOutput`.
+  bool Write(const uint8_t *data, size_t len, bool /*have_more*/ = false) {
     if (!IsConnected()) {
       return false;
     }
-    return std::visit(
-        utils::Overloaded{[shared_this = shared_from_this(), data, len, have_more](TCPSocket &socket) mutable {
-                            boost::system::error_code ec;
-                            while (len > 0) {
-                              const auto sent = socket.send(boost::asio::buffer(data, len),
-                                                            MSG_NOSIGNAL | (have_more ? MSG_MORE : 0), ec);
-                              if (ec) {
-                                shared_this->OnError(ec);
-                                return false;
-                              }
-                              data += sent;
-                              len -= sent;
-                            }
-                            return true;
-                          },
-                          [shared_this = shared_from_this(), data, len](SSLSocket &socket) mutable {
-                            boost::system::error_code ec;
-                            while (len > 0) {
-                              const auto sent = socket.write_some(boost::asio::buffer(data, len), ec);
-                              if (ec) {
-                                shared_this->OnError(ec);
-                                return false;
-                              }
-                              data += sent;
-                              len -= sent;
-                            }
-                            return true;
-                          }},
-        socket_);
+    pending_output_size_ += len;
+    while (len > 0) {
+      if (pending_output_.empty() || pending_output_.back().size() == pending_output_.back().capacity()) {
+        pending_output_.emplace_back().reserve(kOutputBlockSize);
+      }
+      auto &block = pending_output_.back();
+      const auto size = std::min(len, block.capacity() - block.size());
+      block.insert(block.end(), data, data + size);
+      data += size;
+      len -= size;
+    }
+    if (pending_output_size_ < kMaxPendingOutputSize) {
+      return true;
+    }
+    return FlushPendingOutput();
   }
 
   bool IsConnected() const {
@@ -312,7 +349,8 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
 
  private:
   explicit Session(tcp::socket &&socket, TSessionData *data, ServerContext &server_context, tcp::endpoint endpoint,
-                   const std::chrono::seconds inactivity_timeout_sec, std::string_view service_name)
+                   const std::chrono::seconds inactivity_timeout_sec, std::string_view service_name,
+                   utils::ThreadPool *execution_pool = nullptr, const bool websocket_compression = false)
       : socket_(CreateSocket(std::move(socket), server_context)),
         strand_{boost::asio::make_strand(GetExecutor())},
         output_stream_([this](const uint8_t *data, size_t len, bool have_more) { return Write(data, len, have_more); }),
@@ -322,7 +360,10 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
         remote_endpoint_{GetRemoteEndpoint()},
         service_name_{service_name},
         timeout_seconds_(inactivity_timeout_sec),
-        timeout_timer_(GetExecutor()) {
+        timeout_timer_(GetExecutor()),
+        flush_timer_(GetExecutor()),
+        execution_pool_{execution_pool},
+        websocket_compression_{websocket_compression} {
     ExecuteForSocket([](auto &&socket) {
       socket.lowest_layer().set_option(tcp::no_delay(true));                         // enable PSH
       socket.lowest_layer().set_option(boost::asio::socket_base::keep_alive(true));  // enable SO_KEEPALIVE
@@ -373,7 +414,8 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
         spdlog::info("Switching {} to websocket connection", remote_endpoint_);
         if (std::holds_alternative<TCPSocket>(socket_)) {
           auto sock = std::get<TCPSocket>(std::move(socket_));
-          WebsocketSession<TSession, TSessionData>::Create(std::move(sock), data_, endpoint_, service_name_)
+          WebsocketSession<TSession, TSessionData>::Create(std::move(sock), data_, endpoint_, service_name_,
+                                                            websocket_compression_)
               ->DoAccept(parser.release());
           execution_active_ = false;
           return;
@@ -383,21 +425,200 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
       }
     }
 
+    DoExecute();
+  }
+
+  void DoExecute() {
+    if (!execution_pool_) {
+      return OnExecuted(Execute());
+    }
+    // The session is inactive only while waiting for the client, not while
+    // executing its queries. The timeout actor is stopped until the execution
+    // is done, since it runs on the strand and could close the socket which
+    // the execution writes to.
+    executing_off_strand_ = true;
+    timeout_timer_.cancel();
+    execution_pool_->AddTask([shared_this = shared_from_this()] {
+      const auto success = shared_this->Execute();
+      boost::asio::post(shared_this->strand_, [shared_this, success] { shared_this->OnExecuted(success); });
+    });
+  }
+
+  /// Executes the input read so far. The next read is started only once the
+  /// output is written and the timeout actor is stopped while executing on the
+  /// execution pool, so nothing else touches the session in the meantime. The
+  /// errors are only recorded here and handled on the strand in `OnExecuted`.
+  /// @return false if the session should be closed
+  bool Execute() {
     try {
       session_.Execute();
-      DoRead();
+      return true;
     } catch (const SessionClosedException &e) {
       spdlog::info("{} client {}:{} closed the connection.", service_name_, remote_endpoint_.address(),
                    remote_endpoint_.port());
-      DoShutdown();
     } catch (const std::exception &e) {
       spdlog::error(
           "Exception was thrown while processing event in {} session "
           "associated with {}:{}",
           service_name_, remote_endpoint_.address(), remote_endpoint_.port());
       spdlog::debug("Exception message: {}", e.what());
-      DoShutdown();
     }
+    return false;
+  }
+
+  void OnExecuted(const bool success) {
+    if (executing_off_strand_) {
+      executing_off_strand_ = false;
+      timeout_timer_.async_wait(
+          boost::asio::bind_executor(strand_, std::bind(&Session::OnTimeout, shared_from_this())));
+    }
+    if (write_error_) {
+      const auto ec = std::exchange(write_error_, {});
+      return OnError(ec);
+    }
+    if (!success) {
+      return DoFinalWrite();
+    }
+    DoWrite();
+  }
+
+  static std::vector<boost::asio::const_buffer> OutputBuffers(const std::vector<std::vector<uint8_t>> &blocks) {
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(blocks.size());
+    for (const auto &block : blocks) {
+      buffers.emplace_back(block.data(), block.size());
+    }
+    return buffers;
+  }
+
+  /// Sends the output of the last execution and continues reading once it has
+  /// been written. The io thread isn't blocked by a slow client meanwhile, and
+  /// since no more input is executed until then, the client can't make the
+  /// session produce more output than it reads.
+  void DoWrite() {
+    if (!IsConnected()) {
+      return;
+    }
+    if (pending_output_.empty()) {
+      return DoContinue();
+    }
+    timeout_timer_.expires_after(timeout_seconds_);
+    writing_output_.swap(pending_output_);
+    pending_output_.clear();
+    pending_output_size_ = 0;
+    ExecuteForSocket([this](auto &&socket) {
+      boost::asio::async_write(
+          socket, OutputBuffers(writing_output_),
+          boost::asio::bind_executor(strand_, std::bind_front(&Session::OnWrite, shared_from_this())));
+    });
+  }
+
+  void OnWrite(const boost::system::error_code &ec, const size_t /*bytes_transferred*/) {
+    if (ec) {
+      return OnError(ec);
+    }
+    writing_output_.clear();
+    DoContinue();
+  }
+
+  /// Reads more input, or waits until a suspended session can be resumed
+  /// without reading any. The session is executing meanwhile, so the timeout
+  /// actor is stopped and no thread is blocked while waiting.
+  void DoContinue() {
+    if (!IsConnected()) {
+      return;
+    }
+    if (!session_.IsSuspended()) {
+      return DoRead();
+    }
+    executing_off_strand_ = true;
+    timeout_timer_.cancel();
+    session_.AwaitResume([shared_this = shared_from_this()] {
+      boost::asio::post(shared_this->strand_, [shared_this] { shared_this->OnResume(); });
+    });
+  }
+
+  void OnResume() {
+    if (!IsConnected()) {
+      return;
+    }
+    DoExecute();
+  }
+
+  /// Sends the output of a failed execution and closes the session once it has
+  /// been written, so the client still receives the output produced before the
+  /// failure, e.g. a FAILURE message or a rejected handshake.
+  void DoFinalWrite() {
+    if (!IsConnected()) {
+      return;
+    }
+    if (pending_output_.empty()) {
+      return DoShutdown();
+    }
+    timeout_timer_.expires_after(timeout_seconds_);
+    writing_output_.swap(pending_output_);
+    pending_output_.clear();
+    pending_output_size_ = 0;
+    ExecuteForSocket([this](auto &&socket) {
+      boost::asio::async_write(
+          socket, OutputBuffers(writing_output_),
+          boost::asio::bind_executor(strand_, std::bind_front(&Session::OnFinalWrite, shared_from_this())));
+    });
+  }
+
+  void OnFinalWrite(const boost::system::error_code &ec, const size_t /*bytes_transferred*/) {
+    writing_output_.clear();
+    if (ec) {
+      return OnError(ec);
+    }
+    DoShutdown();
+  }
+
+  /// Writes the pending output in the middle of an execution. There is never
+  /// an asynchronous write in progress at that point, because the input is
+  /// executed only after the previous output was written. A failed write is
+  /// handled once the execution is done, as this may run outside the strand.
+  /// The write blocks, so it is bounded by the inactivity timeout: a client
+  /// which stops reading its results gets disconnected instead of holding the
+  /// execution thread forever.
+  bool FlushPendingOutput() {
+    const auto handle = ExecuteForSocket([](auto &socket) { return socket.lowest_layer().native_handle(); });
+    {
+      std::lock_guard<std::mutex> guard(flush_lock_);
+      flushing_output_ = true;
+    }
+    // The timer isn't bound to the strand, which may be blocked by this write
+    // when the session executes on the io threads.
+    flush_timer_.expires_after(timeout_seconds_);
+    flush_timer_.async_wait([shared_this = shared_from_this(), handle](const boost::system::error_code &ec) {
+      if (!ec) shared_this->OnFlushTimeout(handle);
+    });
+    boost::system::error_code ec;
+    ExecuteForSocket([this, &ec](auto &&socket) { boost::asio::write(socket, OutputBuffers(pending_output_), ec); });
+    flush_timer_.cancel();
+    {
+      std::lock_guard<std::mutex> guard(flush_lock_);
+      flushing_output_ = false;
+      if (std::exchange(flush_timed_out_, false)) ec = boost::asio::error::timed_out;
+    }
+    pending_output_.clear();
+    pending_output_size_ = 0;
+    if (ec) {
+      write_error_ = ec;
+      return false;
+    }
+    return true;
+  }
+
+  /// Fails the write blocked in `FlushPendingOutput` by shutting the socket
+  /// down. This runs concurrently with the write, so only the native socket is
+  /// used, and only while the write is still in progress. The socket is closed
+  /// once the execution is done.
+  void OnFlushTimeout(const tcp::socket::native_handle_type handle) {
+    std::lock_guard<std::mutex> guard(flush_lock_);
+    if (!flushing_output_) return;
+    flush_timed_out_ = true;
+    ::shutdown(handle, SHUT_RDWR);
   }
 
   void OnError(const boost::system::error_code &ec) {
@@ -456,7 +677,8 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
   }
 
   void OnTimeout() {
-    if (!IsConnected()) {
+    if (!IsConnected() || executing_off_strand_) {
+      // The actor is restarted once the execution is done.
       return;
     }
     // Check whether the deadline has passed. We compare the deadline against
@@ -502,6 +724,9 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
   boost::asio::strand<tcp::socket::executor_type> strand_;
 
   communication::Buffer input_buffer_;
+  std::vector<std::vector<uint8_t>> pending_output_;
+  size_t pending_output_size_{0};
+  std::vector<std::vector<uint8_t>> writing_output_;
   OutputStream output_stream_;
   TSession session_;
   TSessionData *data_;
@@ -510,7 +735,19 @@ class Session final : public std::enable_shared_from_this<Session<TSession, TSes
   std::string_view service_name_;
   std::chrono::seconds timeout_seconds_;
   boost::asio::steady_timer timeout_timer_;
+  boost::asio::steady_timer flush_timer_;
+  // Guards the state shared by a blocked flush and its timeout.
+  std::mutex flush_lock_;
+  bool flushing_output_{false};
+  bool flush_timed_out_{false};
+  utils::ThreadPool *execution_pool_;
+  bool websocket_compression_;
   bool execution_active_{false};
   bool has_received_msg_{false};
+  // Set while the input is executed on the execution pool, or while a
+  // suspended session waits to be resumed.
+  bool executing_off_strand_{false};
+  // The error of a write done during the execution.
+  boost::system::error_code write_error_;
 };
 }  // namespace memgraph::communication::v2
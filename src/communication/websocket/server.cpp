@@ -38,6 +38,8 @@ bool Server::IsRunning() const { return background_thread_ && !ioc_.stopped(); }
 
 boost::asio::ip::tcp::endpoint Server::GetEndpoint() const { return listener_->GetEndpoint(); };
 
+void Server::WriteToAll(std::shared_ptr<std::string> message) { listener_->WriteToAll(std::move(message)); }
+
 namespace {
 class QuoteEscapeFormatter : public spdlog::custom_flag_formatter {
  public:
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -26,9 +26,13 @@ class Server final {
   using tcp = boost::asio::ip::tcp;
 
  public:
-  explicit Server(io::network::Endpoint endpoint, ServerContext *context, AuthenticationInterface &auth)
-      : listener_{Listener::Create(
-            ioc_, context, tcp::endpoint{boost::asio::ip::make_address(endpoint.address), endpoint.port}, auth)} {}
+  /// If `compression` is set, the clients may negotiate the permessage-deflate
+  /// extension.
+  explicit Server(io::network::Endpoint endpoint, ServerContext *context, AuthenticationInterface &auth,
+                  bool compression = false)
+      : listener_{Listener::Create(ioc_, context,
+                                   tcp::endpoint{boost::asio::ip::make_address(endpoint.address), endpoint.port}, auth,
+                                   compression)} {}
 
   Server(const Server &) = delete;
   Server(Server &&) = delete;
@@ -43,6 +47,9 @@ class Server final {
   bool IsRunning() const;
   tcp::endpoint GetEndpoint() const;
 
+  /// Sends the message to all the authenticated sessions.
+  void WriteToAll(std::shared_ptr<std::string> message);
+
   class LoggingSink : public spdlog::sinks::base_sink<std::mutex> {
    public:
     explicit LoggingSink(std::weak_ptr<Listener> listener) : listener_(listener) {}
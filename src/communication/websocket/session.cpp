@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -43,16 +43,26 @@ std::variant<Session::PlainWebSocket, Session::SSLWebSocket> Session::CreateWebS
   return Session::PlainWebSocket{std::move(socket)};
 }
 
-Session::Session(tcp::socket &&socket, ServerContext &context, AuthenticationInterface &auth)
-    : ws_(CreateWebSocket(std::move(socket), context)), strand_{boost::asio::make_strand(GetExecutor())}, auth_{auth} {}
+Session::Session(tcp::socket &&socket, ServerContext &context, AuthenticationInterface &auth, const bool compression)
+    : ws_(CreateWebSocket(std::move(socket), context)),
+      strand_{boost::asio::make_strand(GetExecutor())},
+      auth_{auth},
+      compression_{compression} {}
 
 bool Session::Run() {
-  ExecuteForWebsocket([](auto &&ws) {
+  ExecuteForWebsocket([this](auto &&ws) {
     ws.set_option(boost::beast::websocket::stream_base::timeout::suggested(boost::beast::role_type::server));
 
     ws.set_option(boost::beast::websocket::stream_base::decorator([](boost::beast::websocket::response_type &res) {
       res.set(boost::beast::http::field::server, "Memgraph WS");
     }));
+
+    if (compression_) {
+      // Used only if the client offers the extension in its upgrade request.
+      boost::beast::websocket::permessage_deflate deflate;
+      deflate.server_enable = true;
+      ws.set_option(deflate);
+    }
   });
 
   if (auto *ssl_ws = std::get_if<SSLWebSocket>(&ws_); ssl_ws != nullptr) {
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -48,7 +48,7 @@ class Session : public std::enable_shared_from_this<Session> {
   using PlainWebSocket = boost::beast::websocket::stream<boost::beast::tcp_stream>;
   using SSLWebSocket = boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>>;
 
-  explicit Session(tcp::socket &&socket, ServerContext &context, AuthenticationInterface &auth);
+  explicit Session(tcp::socket &&socket, ServerContext &context, AuthenticationInterface &auth, bool compression);
 
   void DoWrite();
   void OnWrite(boost::beast::error_code ec, size_t bytes_transferred);
@@ -85,5 +85,6 @@ class Session : public std::enable_shared_from_this<Session> {
   bool authenticated_{false};
   bool close_{false};
   AuthenticationInterface &auth_;
+  bool compression_;
 };
 }  // namespace memgraph::communication::websocket
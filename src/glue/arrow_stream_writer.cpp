@@ -0,0 +1,512 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "glue/arrow_stream_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+#include "query/exceptions.hpp"
+#include "utils/temporal.hpp"
+
+namespace memgraph::glue {
+
+namespace {
+
+// The metadata of the messages is encoded with FlatBuffers, which are little
+// endian, and is written from the in-memory representation of the values.
+static_assert(std::endian::native == std::endian::little);
+
+/// Minimal FlatBuffers builder for the Arrow IPC metadata. It lays out the
+/// buffer the same way as the reference builder: back to front, so an object
+/// can only refer to the objects built before it, without the fields which are
+/// set to their default values and with identical vtables shared. Together with
+/// adding the fields in the order of the generated `Create*` functions, this
+/// gives the same bytes as the Arrow library. The bytes are kept in reverse
+/// order until the buffer is finished.
+class FlatBufferBuilder {
+ public:
+  /// Position of an object as its distance from the end of the buffer.
+  using Ref = uint32_t;
+
+  Ref Size() const { return static_cast<Ref>(bytes_.size()); }
+
+  template <typename T>
+  void Push(const T value) {
+    Align(sizeof(T));
+    PushBytes(&value, sizeof(T));
+  }
+
+  Ref CreateString(const std::string_view str) {
+    Align(sizeof(uint32_t), str.size() + 1);
+    bytes_.push_back(0);
+    PushBytes(str.data(), str.size());
+    Push(static_cast<uint32_t>(str.size()));
+    return Size();
+  }
+
+  /// Creates a vector of structs whose fields are all 64-bit.
+  template <size_t N>
+  Ref CreateStructVector(const std::vector<std::array<int64_t, N>> &elements) {
+    const auto size = elements.size() * sizeof(std::array<int64_t, N>);
+    PreAlign(sizeof(uint32_t), size);
+    PreAlign(sizeof(int64_t), size);
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it) PushBytes(it->data(), sizeof(*it));
+    Push(static_cast<uint32_t>(elements.size()));
+    return Size();
+  }
+
+  Ref CreateOffsetVector(const std::vector<Ref> &refs) {
+    PreAlign(sizeof(uint32_t), refs.size() * sizeof(uint32_t));
+    for (auto it = refs.rbegin(); it != refs.rend(); ++it) PushOffset(*it);
+    Push(static_cast<uint32_t>(refs.size()));
+    return Size();
+  }
+
+  void StartTable() {
+    table_start_ = Size();
+    fields_.clear();
+  }
+
+  /// Adds the scalar field, unless it has the default value of the field.
+  template <typename T>
+  void AddField(const uint16_t id, const T value, const T default_value = T{}) {
+    if (value == default_value) return;
+    Push(value);
+    fields_.emplace_back(id, Size());
+  }
+
+  void AddOffsetField(const uint16_t id, const Ref ref) {
+    PushOffset(ref);
+    fields_.emplace_back(id, Size());
+  }
+
+  Ref EndTable() {
+    // The table starts with the offset of its vtable, which is written right
+    // before the table and patched in once its position is known.
+    Push<int32_t>(0);
+    const auto table = Size();
+    uint16_t num_fields = 0;
+    for (const auto &[id, ref] : fields_) num_fields = std::max<uint16_t>(num_fields, id + 1);
+    std::vector<uint16_t> field_offsets(num_fields, 0);
+    for (const auto &[id, ref] : fields_) field_offsets[id] = static_cast<uint16_t>(table - ref);
+    for (auto it = field_offsets.rbegin(); it != field_offsets.rend(); ++it) Push(*it);
+    Push(static_cast<uint16_t>(table - table_start_));
+    Push(static_cast<uint16_t>(sizeof(uint16_t) * (num_fields + 2)));
+    auto vtable = Size();
+    // An identical vtable which was already written is used instead.
+    const auto vtable_size = vtable - table;
+    for (const auto other : vtables_) {
+      if (ReadVtableSize(other) == vtable_size &&
+          std::equal(bytes_.begin() + table, bytes_.end(), bytes_.begin() + (other - vtable_size))) {
+        bytes_.resize(table);
+        vtable = other;
+        break;
+      }
+    }
+    if (vtable == Size()) vtables_.push_back(vtable);
+    const auto vtable_offset = static_cast<int32_t>(vtable) - static_cast<int32_t>(table);
+    for (size_t i = 0; i < sizeof(vtable_offset); ++i) {
+      bytes_[table - 1 - i] = reinterpret_cast<const uint8_t *>(&vtable_offset)[i];
+    }
+    return table;
+  }
+
+  /// Finishes the buffer with `root` as its root table.
+  std::vector<uint8_t> Finish(const Ref root) {
+    PreAlign(min_alignment_, sizeof(uint32_t));
+    PushOffset(root);
+    return {bytes_.rbegin(), bytes_.rend()};
+  }
+
+ private:
+  void Align(const size_t alignment, const size_t extra = 0) {
+    min_alignment_ = std::max(min_alignment_, alignment);
+    while ((bytes_.size() + extra) % alignment != 0) bytes_.push_back(0);
+  }
+
+  // Aligns for `size` bytes which are pushed next, which isn't needed if there
+  // are none.
+  void PreAlign(const size_t alignment, const size_t size) {
+    if (size > 0) Align(alignment, size);
+  }
+
+  // Size of the vtable written at `vtable`, which is its first field.
+  Ref ReadVtableSize(const Ref vtable) const { return bytes_[vtable - 1] | (bytes_[vtable - 2] << 8); }
+
+  void PushBytes(const void *data, const size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = size; i > 0; --i) bytes_.push_back(bytes[i - 1]);
+  }
+
+  void PushOffset(const Ref ref) {
+    Align(sizeof(uint32_t));
+    Push(Size() + static_cast<uint32_t>(sizeof(uint32_t)) - ref);
+  }
+
+  std::vector<uint8_t> bytes_;
+  size_t min_alignment_{1};
+  Ref table_start_{0};
+  std::vector<std::pair<uint16_t, Ref>> fields_;
+  std::vector<Ref> vtables_;
+};
+
+// Values of the enums and ids of the table fields from the Arrow format
+// definitions in Schema.fbs and Message.fbs. The fields are added in the order
+// of the generated `Create*` functions, by size and then by descending id.
+constexpr int16_t kMetadataVersionV5 = 4;
+constexpr uint8_t kMessageHeaderSchema = 1;
+constexpr uint8_t kMessageHeaderRecordBatch = 3;
+constexpr uint8_t kTypeNull = 1;
+constexpr uint8_t kTypeInt = 2;
+constexpr uint8_t kTypeFloatingPoint = 3;
+constexpr uint8_t kTypeUtf8 = 5;
+constexpr uint8_t kTypeBool = 6;
+constexpr uint8_t kTypeDate = 8;
+constexpr uint8_t kTypeTime = 9;
+constexpr uint8_t kTypeTimestamp = 10;
+constexpr uint8_t kTypeDuration = 18;
+constexpr int16_t kPrecisionDouble = 2;
+constexpr int16_t kDateUnitDay = 0;
+constexpr int16_t kDateUnitMillisecond = 1;
+constexpr int16_t kTimeUnitMillisecond = 1;
+constexpr int16_t kTimeUnitMicrosecond = 2;
+
+// Every IPC message starts with the continuation marker and the size of its
+// metadata. The stream ends with the marker followed by a zero size.
+constexpr uint32_t kContinuationMarker = 0xFFFFFFFF;
+constexpr size_t kBodyAlignment = 8;
+
+// The offsets of the string columns are 32-bit.
+constexpr size_t kMaxStringColumnSize = std::numeric_limits<int32_t>::max();
+
+using ColumnType = ArrowStreamWriter::ColumnType;
+
+std::string TypeName(const query::TypedValue &value) {
+  std::ostringstream name;
+  name << value.type();
+  return name.str();
+}
+
+std::optional<ColumnType> ColumnTypeOf(const query::TypedValue &value) {
+  switch (value.type()) {
+    case query::TypedValue::Type::Null:
+      return ColumnType::Null;
+    case query::TypedValue::Type::Bool:
+      return ColumnType::Bool;
+    case query::TypedValue::Type::Int:
+      return ColumnType::Int;
+    case query::TypedValue::Type::Double:
+      return ColumnType::Float;
+    case query::TypedValue::Type::String:
+      return ColumnType::String;
+    case query::TypedValue::Type::Date:
+      return ColumnType::Date;
+    case query::TypedValue::Type::LocalTime:
+      return ColumnType::LocalTime;
+    case query::TypedValue::Type::LocalDateTime:
+      return ColumnType::LocalDateTime;
+    case query::TypedValue::Type::Duration:
+      return ColumnType::Duration;
+    case query::TypedValue::Type::List:
+    case query::TypedValue::Type::Map:
+    case query::TypedValue::Type::Vertex:
+    case query::TypedValue::Type::Edge:
+    case query::TypedValue::Type::Path:
+    case query::TypedValue::Type::Graph:
+      return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+/// Creates the table of the Arrow type of the column, returns the type id of
+/// the table in the Type union.
+std::pair<uint8_t, FlatBufferBuilder::Ref> CreateType(FlatBufferBuilder &builder, const ColumnType type) {
+  builder.StartTable();
+  switch (type) {
+    case ColumnType::Null:
+      return {kTypeNull, builder.EndTable()};
+    case ColumnType::Bool:
+      return {kTypeBool, builder.EndTable()};
+    case ColumnType::Int:
+      builder.AddField<int32_t>(0, 64);  // bitWidth
+      builder.AddField<uint8_t>(1, 1);   // is_signed
+      return {kTypeInt, builder.EndTable()};
+    case ColumnType::Float:
+      builder.AddField(0, kPrecisionDouble);
+      return {kTypeFloatingPoint, builder.EndTable()};
+    case ColumnType::String:
+      return {kTypeUtf8, builder.EndTable()};
+    case ColumnType::Date:
+      builder.AddField(0, kDateUnitDay, kDateUnitMillisecond);
+      return {kTypeDate, builder.EndTable()};
+    case ColumnType::LocalTime:
+      builder.AddField<int32_t>(1, 64, 32);  // bitWidth
+      builder.AddField(0, kTimeUnitMicrosecond, kTimeUnitMillisecond);
+      return {kTypeTime, builder.EndTable()};
+    case ColumnType::LocalDateTime:
+      // Without a time zone, i.e. a local date and time.
+      builder.AddField(0, kTimeUnitMicrosecond);
+      return {kTypeTimestamp, builder.EndTable()};
+    case ColumnType::Duration:
+      builder.AddField(0, kTimeUnitMicrosecond, kTimeUnitMillisecond);
+      return {kTypeDuration, builder.EndTable()};
+  }
+  return {kTypeNull, builder.EndTable()};
+}
+
+std::vector<uint8_t> FinishMessage(FlatBufferBuilder &builder, const uint8_t header_type,
+                                   const FlatBufferBuilder::Ref header, const int64_t body_length) {
+  builder.StartTable();
+  builder.AddField(3, body_length);
+  builder.AddOffsetField(2, header);
+  builder.AddField(0, kMetadataVersionV5);
+  builder.AddField(1, header_type);
+  return builder.Finish(builder.EndTable());
+}
+
+template <typename T>
+void Append(std::vector<uint8_t> *output, const T value) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+  output->insert(output->end(), bytes, bytes + sizeof(T));
+}
+
+/// Appends the encapsulated message with the metadata, padded to 8 bytes, and
+/// the body.
+void AppendMessage(std::vector<uint8_t> *output, const std::vector<uint8_t> &metadata,
+                   const std::vector<uint8_t> &body) {
+  const auto padded_size = (metadata.size() + kBodyAlignment - 1) / kBodyAlignment * kBodyAlignment;
+  Append(output, kContinuationMarker);
+  Append(output, static_cast<int32_t>(padded_size));
+  output->insert(output->end(), metadata.begin(), metadata.end());
+  output->resize(output->size() + padded_size - metadata.size(), 0);
+  output->insert(output->end(), body.begin(), body.end());
+}
+
+/// Body of a record batch, which consists of the buffers of all columns.
+class RecordBatchBody {
+ public:
+  template <typename T>
+  void AddBuffer(const std::vector<T> &data) {
+    AddBuffer(data.data(), data.size() * sizeof(T));
+  }
+
+  void AddBuffer(const void *data, const size_t size) {
+    buffers_.push_back({static_cast<int64_t>(body_.size()), static_cast<int64_t>(size)});
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    body_.insert(body_.end(), bytes, bytes + size);
+    body_.resize((body_.size() + kBodyAlignment - 1) / kBodyAlignment * kBodyAlignment, 0);
+  }
+
+  void AddNode(const size_t length, const size_t null_count) {
+    nodes_.push_back({static_cast<int64_t>(length), static_cast<int64_t>(null_count)});
+  }
+
+  const std::vector<uint8_t> &body() const { return body_; }
+  const std::vector<std::array<int64_t, 2>> &nodes() const { return nodes_; }
+  const std::vector<std::array<int64_t, 2>> &buffers() const { return buffers_; }
+
+ private:
+  std::vector<uint8_t> body_;
+  // FieldNode and Buffer structs, both with two 64-bit fields.
+  std::vector<std::array<int64_t, 2>> nodes_;
+  std::vector<std::array<int64_t, 2>> buffers_;
+};
+
+void SetBit(std::vector<uint8_t> *bitmap, const size_t index) { (*bitmap)[index / 8] |= 1U << (index % 8); }
+
+template <typename T, typename TGetter>
+void AddFixedWidthColumn(RecordBatchBody *body, const std::vector<const query::TypedValue *> &values,
+                         std::vector<uint8_t> *validity, TGetter &&getter) {
+  std::vector<T> data(values.size(), T{});
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (!values[i]->IsNull()) data[i] = getter(*values[i]);
+  }
+  body->AddBuffer(*validity);
+  body->AddBuffer(data);
+}
+
+}  // namespace
+
+ArrowStreamWriter::ArrowStreamWriter(std::vector<std::string> column_names) : column_names_(std::move(column_names)) {}
+
+void ArrowStreamWriter::AddRow(const std::vector<query::TypedValue> &values) { rows_.push_back(values); }
+
+void ArrowStreamWriter::WriteBatch(std::vector<uint8_t> *output) {
+  if (!column_types_) {
+    DeriveSchema();
+    WriteSchema(output);
+  }
+  if (rows_.empty()) return;
+  WriteRecordBatch(output);
+  rows_.clear();
+}
+
+void ArrowStreamWriter::WriteEnd(std::vector<uint8_t> *output) {
+  WriteBatch(output);
+  Append(output, kContinuationMarker);
+  Append(output, int32_t{0});
+}
+
+void ArrowStreamWriter::DeriveSchema() {
+  std::vector<ColumnType> types(column_names_.size(), ColumnType::Null);
+  for (const auto &row : rows_) {
+    for (size_t i = 0; i < std::min(row.size(), types.size()); ++i) {
+      const auto type = ColumnTypeOf(row[i]);
+      if (!type) {
+        throw query::QueryRuntimeException("Column '{}' has a value of type {}, which can't be written to Arrow.",
+                                           column_names_[i], TypeName(row[i]));
+      }
+      if (*type == ColumnType::Null) continue;
+      if (types[i] == ColumnType::Null) {
+        types[i] = *type;
+      } else if ((types[i] == ColumnType::Int && *type == ColumnType::Float) ||
+                 (types[i] == ColumnType::Float && *type == ColumnType::Int)) {
+        types[i] = ColumnType::Float;
+      }
+    }
+  }
+  column_types_ = std::move(types);
+}
+
+void ArrowStreamWriter::WriteSchema(std::vector<uint8_t> *output) const {
+  FlatBufferBuilder builder;
+  std::vector<FlatBufferBuilder::Ref> fields;
+  fields.reserve(column_names_.size());
+  for (size_t i = 0; i < column_names_.size(); ++i) {
+    const auto [type_type, type] = CreateType(builder, (*column_types_)[i]);
+    const auto name = builder.CreateString(column_names_[i]);
+    const auto children = builder.CreateOffsetVector({});
+    builder.StartTable();
+    builder.AddOffsetField(5, children);
+    builder.AddOffsetField(3, type);
+    builder.AddOffsetField(0, name);
+    builder.AddField(2, type_type);
+    builder.AddField<uint8_t>(1, 1);  // nullable
+    fields.push_back(builder.EndTable());
+  }
+  const auto fields_vector = builder.CreateOffsetVector(fields);
+  // The endianness is left at its default, little endian.
+  builder.StartTable();
+  builder.AddOffsetField(1, fields_vector);
+  const auto schema = builder.EndTable();
+  AppendMessage(output, FinishMessage(builder, kMessageHeaderSchema, schema, 0), {});
+}
+
+void ArrowStreamWriter::WriteRecordBatch(std::vector<uint8_t> *output) const {
+  RecordBatchBody body;
+  std::vector<const query::TypedValue *> values(rows_.size());
+  const query::TypedValue null;
+  for (size_t column = 0; column < column_names_.size(); ++column) {
+    const auto type = (*column_types_)[column];
+    std::vector<uint8_t> validity((rows_.size() + 7) / 8, 0);
+    size_t null_count = 0;
+    for (size_t row = 0; row < rows_.size(); ++row) {
+      values[row] = column < rows_[row].size() ? &rows_[row][column] : &null;
+      const auto &value = *values[row];
+      if (value.IsNull()) {
+        ++null_count;
+        continue;
+      }
+      const auto value_type = ColumnTypeOf(value);
+      if (value_type != type && !(type == ColumnType::Float && value_type == ColumnType::Int)) {
+        throw query::QueryRuntimeException(
+            "Column '{}' has a value of type {}, which doesn't match the Arrow type of the column derived from the "
+            "first batch of results.",
+            column_names_[column], TypeName(value));
+      }
+      SetBit(&validity, row);
+    }
+    body.AddNode(rows_.size(), null_count);
+    // The validity bitmap of a column without nulls is left out.
+    if (null_count == 0) validity.clear();
+
+    switch (type) {
+      case ColumnType::Null:
+        // Null columns have no buffers.
+        break;
+      case ColumnType::Bool: {
+        std::vector<uint8_t> data((rows_.size() + 7) / 8, 0);
+        for (size_t row = 0; row < rows_.size(); ++row) {
+          if (!values[row]->IsNull() && values[row]->ValueBool()) SetBit(&data, row);
+        }
+        body.AddBuffer(validity);
+        body.AddBuffer(data);
+        break;
+      }
+      case ColumnType::Int:
+        AddFixedWidthColumn<int64_t>(&body, values, &validity, [](const auto &value) { return value.ValueInt(); });
+        break;
+      case ColumnType::Float:
+        AddFixedWidthColumn<double>(&body, values, &validity, [](const auto &value) {
+          return value.IsInt() ? static_cast<double>(value.ValueInt()) : value.ValueDouble();
+        });
+        break;
+      case ColumnType::Date:
+        AddFixedWidthColumn<int32_t>(&body, values, &validity, [](const auto &value) {
+          return static_cast<int32_t>(utils::Duration(value.ValueDate().MicrosecondsSinceEpoch()).Days());
+        });
+        break;
+      case ColumnType::LocalTime:
+        AddFixedWidthColumn<int64_t>(&body, values, &validity,
+                                     [](const auto &value) { return value.ValueLocalTime().MicrosecondsSinceEpoch(); });
+        break;
+      case ColumnType::LocalDateTime:
+        AddFixedWidthColumn<int64_t>(&body, values, &validity, [](const auto &value) {
+          return value.ValueLocalDateTime().MicrosecondsSinceEpoch();
+        });
+        break;
+      case ColumnType::Duration:
+        AddFixedWidthColumn<int64_t>(&body, values, &validity,
+                                     [](const auto &value) { return value.ValueDuration().microseconds; });
+        break;
+      case ColumnType::String: {
+        std::vector<int32_t> offsets(rows_.size() + 1, 0);
+        std::vector<char> data;
+        for (size_t row = 0; row < rows_.size(); ++row) {
+          if (!values[row]->IsNull()) {
+            const auto &str = values[row]->ValueString();
+            if (data.size() + str.size() > kMaxStringColumnSize) {
+              throw query::QueryRuntimeException("Column '{}' has too many characters for a batch of Arrow results.",
+                                                 column_names_[column]);
+            }
+            data.insert(data.end(), str.begin(), str.end());
+          }
+          offsets[row + 1] = static_cast<int32_t>(data.size());
+        }
+        body.AddBuffer(validity);
+        body.AddBuffer(offsets);
+        body.AddBuffer(data);
+        break;
+      }
+    }
+  }
+
+  FlatBufferBuilder builder;
+  const auto nodes = builder.CreateStructVector(body.nodes());
+  const auto buffers = builder.CreateStructVector(body.buffers());
+  builder.StartTable();
+  builder.AddField(0, static_cast<int64_t>(rows_.size()));  // length
+  builder.AddOffsetField(2, buffers);
+  builder.AddOffsetField(1, nodes);
+  const auto record_batch = builder.EndTable();
+  AppendMessage(output,
+                FinishMessage(builder, kMessageHeaderRecordBatch, record_batch, static_cast<int64_t>(body.body().size())),
+                body.body());
+}
+
+}  // namespace memgraph::glue
@@ -0,0 +1,72 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file Encoding of query results into the Arrow IPC streaming format, for
+/// clients which read the results into columnar data frames.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "query/typed_value.hpp"
+
+namespace memgraph::glue {
+
+/// Writer of query results as an Arrow IPC stream: the schema message, followed
+/// by a record batch message per batch of rows and the end-of-stream marker.
+///
+/// The column types are derived from the values in the first batch, by the
+/// first value of each column which isn't null. Integers and floats in the same
+/// column are written as floats, and a column with only nulls in the first
+/// batch stays a null column. Booleans, integers, floats, strings and temporal
+/// values are supported, while lists, maps, vertices, edges, paths and graphs
+/// have no column type.
+class ArrowStreamWriter {
+ public:
+  explicit ArrowStreamWriter(std::vector<std::string> column_names);
+
+  /// Adds the row to the current batch.
+  void AddRow(const std::vector<query::TypedValue> &values);
+
+  /// Number of rows in the current batch.
+  size_t BatchRows() const { return rows_.size(); }
+
+  /// Appends the current batch to `output`, preceded by the schema if it
+  /// wasn't written yet. A batch without rows isn't written, so only the
+  /// schema may be appended.
+  ///
+  /// @throw query::QueryRuntimeException if a value doesn't match the type of
+  ///        its column or has no column type
+  void WriteBatch(std::vector<uint8_t> *output);
+
+  /// Appends the current batch, if it isn't empty, and the end-of-stream
+  /// marker to `output`. The stream of an empty result has only the schema.
+  ///
+  /// @throw query::QueryRuntimeException if a value doesn't match the type of
+  ///        its column or has no column type
+  void WriteEnd(std::vector<uint8_t> *output);
+
+  enum class ColumnType : uint8_t { Null, Bool, Int, Float, String, Date, LocalTime, LocalDateTime, Duration };
+
+ private:
+  void DeriveSchema();
+  void WriteSchema(std::vector<uint8_t> *output) const;
+  void WriteRecordBatch(std::vector<uint8_t> *output) const;
+
+  std::vector<std::string> column_names_;
+  // Set once the schema was derived from the first batch.
+  std::optional<std::vector<ColumnType>> column_types_;
+  std::vector<std::vector<query::TypedValue>> rows_;
+};
+
+}  // namespace memgraph::glue
@@ -0,0 +1,218 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "glue/bolt_encoder.hpp"
+
+#include "glue/communication.hpp"
+#include "storage/v2/edge_accessor.hpp"
+#include "storage/v2/storage.hpp"
+#include "storage/v2/vertex_accessor.hpp"
+#include "utils/temporal.hpp"
+
+namespace memgraph::glue {
+
+namespace {
+
+/// Output buffer of `BaseEncoder` which appends to a string.
+class StringBuffer {
+ public:
+  explicit StringBuffer(std::string *str) : str_(str) {}
+
+  void Write(const uint8_t *data, size_t size) { str_->append(reinterpret_cast<const char *>(data), size); }
+
+ private:
+  std::string *str_;
+};
+
+template <class TName>
+const std::string &GetEncodedName(std::unordered_map<uint64_t, std::string> *cache, uint64_t id, TName &&name) {
+  auto it = cache->find(id);
+  if (it != cache->end()) return it->second;
+  std::string encoded;
+  StringBuffer buffer(&encoded);
+  communication::bolt::BaseEncoder<StringBuffer> encoder(buffer);
+  encoder.WriteString(name());
+  return cache->emplace(id, std::move(encoded)).first->second;
+}
+
+}  // namespace
+
+const std::string &BoltNameCache::Label(storage::LabelId label, const storage::Storage &db) {
+  return GetEncodedName(&labels_, label.AsUint(), [&]() -> const std::string & { return db.LabelToName(label); });
+}
+
+const std::string &BoltNameCache::Property(storage::PropertyId property, const storage::Storage &db) {
+  return GetEncodedName(&properties_, property.AsUint(),
+                        [&]() -> const std::string & { return db.PropertyToName(property); });
+}
+
+const std::string &BoltNameCache::EdgeType(storage::EdgeTypeId edge_type, const storage::Storage &db) {
+  return GetEncodedName(&edge_types_, edge_type.AsUint(),
+                        [&]() -> const std::string & { return db.EdgeTypeToName(edge_type); });
+}
+
+TypedValueBoltEncoder::TypedValueBoltEncoder(BoltRecordBuffer &buffer, const storage::Storage &db,
+                                             storage::View view, BoltNameCache &names)
+    : BaseEncoder(buffer), db_(&db), view_(view), names_(&names) {}
+
+storage::Result<void> TypedValueBoltEncoder::WriteTypedValue(const query::TypedValue &value) {
+  switch (value.type()) {
+    case query::TypedValue::Type::Null:
+      WriteNull();
+      break;
+    case query::TypedValue::Type::Bool:
+      WriteBool(value.ValueBool());
+      break;
+    case query::TypedValue::Type::Int:
+      WriteInt(value.ValueInt());
+      break;
+    case query::TypedValue::Type::Double:
+      WriteDouble(value.ValueDouble());
+      break;
+    case query::TypedValue::Type::String:
+      WriteString(value.ValueString());
+      break;
+    case query::TypedValue::Type::List:
+      WriteTypeSize(value.ValueList().size(), communication::bolt::MarkerList);
+      for (const auto &element : value.ValueList()) {
+        auto result = WriteTypedValue(element);
+        if (result.HasError()) return result.GetError();
+      }
+      break;
+    case query::TypedValue::Type::Map:
+      WriteTypeSize(value.ValueMap().size(), communication::bolt::MarkerMap);
+      for (const auto &[key, element] : value.ValueMap()) {
+        WriteString(key);
+        auto result = WriteTypedValue(element);
+        if (result.HasError()) return result.GetError();
+      }
+      break;
+    case query::TypedValue::Type::Vertex:
+      return WriteVertex(value.ValueVertex().impl_);
+    case query::TypedValue::Type::Edge:
+      return WriteEdge(value.ValueEdge().impl_);
+    case query::TypedValue::Type::Path:
+    case query::TypedValue::Type::Graph: {
+      auto maybe_value = ToBoltValue(value, *db_, view_);
+      if (maybe_value.HasError()) return maybe_value.GetError();
+      WriteValue(*maybe_value);
+      break;
+    }
+    case query::TypedValue::Type::Date:
+      WriteDate(value.ValueDate());
+      break;
+    case query::TypedValue::Type::LocalTime:
+      WriteLocalTime(value.ValueLocalTime());
+      break;
+    case query::TypedValue::Type::LocalDateTime:
+      WriteLocalDateTime(value.ValueLocalDateTime());
+      break;
+    case query::TypedValue::Type::Duration:
+      WriteDuration(value.ValueDuration());
+      break;
+  }
+  return {};
+}
+
+storage::Result<void> TypedValueBoltEncoder::WriteVertex(const storage::VertexAccessor &vertex) {
+  // Both are read before anything is written, so an error leaves the buffer
+  // as it was.
+  auto maybe_labels = vertex.Labels(view_);
+  if (maybe_labels.HasError()) return maybe_labels.GetError();
+  auto maybe_properties = vertex.Properties(view_);
+  if (maybe_properties.HasError()) return maybe_properties.GetError();
+
+  WriteRAW(utils::UnderlyingCast(communication::bolt::Marker::TinyStruct) + 3);
+  WriteRAW(utils::UnderlyingCast(communication::bolt::Signature::Node));
+  WriteInt(vertex.Gid().AsInt());
+  WriteTypeSize(maybe_labels->size(), communication::bolt::MarkerList);
+  for (const auto label : *maybe_labels) {
+    const auto &name = names_->Label(label, *db_);
+    WriteRAW(name.data(), name.size());
+  }
+  WriteProperties(*maybe_properties);
+  return {};
+}
+
+storage::Result<void> TypedValueBoltEncoder::WriteEdge(const storage::EdgeAccessor &edge) {
+  auto maybe_properties = edge.Properties(view_);
+  if (maybe_properties.HasError()) return maybe_properties.GetError();
+
+  WriteRAW(utils::UnderlyingCast(communication::bolt::Marker::TinyStruct) + 5);
+  WriteRAW(utils::UnderlyingCast(communication::bolt::Signature::Relationship));
+  WriteInt(edge.Gid().AsInt());
+  WriteInt(edge.FromVertex().Gid().AsInt());
+  WriteInt(edge.ToVertex().Gid().AsInt());
+  const auto &type = names_->EdgeType(edge.EdgeType(), *db_);
+  WriteRAW(type.data(), type.size());
+  WriteProperties(*maybe_properties);
+  return {};
+}
+
+void TypedValueBoltEncoder::WriteProperties(const std::map<storage::PropertyId, storage::PropertyValue> &properties) {
+  WriteTypeSize(properties.size(), communication::bolt::MarkerMap);
+  for (const auto &[property, value] : properties) {
+    const auto &name = names_->Property(property, *db_);
+    WriteRAW(name.data(), name.size());
+    WritePropertyValue(value);
+  }
+}
+
+void TypedValueBoltEncoder::WritePropertyValue(const storage::PropertyValue &value) {
+  switch (value.type()) {
+    case storage::PropertyValue::Type::Null:
+      WriteNull();
+      break;
+    case storage::PropertyValue::Type::Bool:
+      WriteBool(value.ValueBool());
+      break;
+    case storage::PropertyValue::Type::Int:
+      WriteInt(value.ValueInt());
+      break;
+    case storage::PropertyValue::Type::Double:
+      WriteDouble(value.ValueDouble());
+      break;
+    case storage::PropertyValue::Type::String:
+      WriteString(value.ValueString());
+      break;
+    case storage::PropertyValue::Type::List:
+      WriteTypeSize(value.ValueList().size(), communication::bolt::MarkerList);
+      for (const auto &element : value.ValueList()) WritePropertyValue(element);
+      break;
+    case storage::PropertyValue::Type::Map:
+      WriteTypeSize(value.ValueMap().size(), communication::bolt::MarkerMap);
+      for (const auto &[key, element] : value.ValueMap()) {
+        WriteString(key);
+        WritePropertyValue(element);
+      }
+      break;
+    case storage::PropertyValue::Type::TemporalData: {
+      const auto &temporal_data = value.ValueTemporalData();
+      switch (temporal_data.type) {
+        case storage::TemporalType::Date:
+          WriteDate(utils::Date(temporal_data.microseconds));
+          break;
+        case storage::TemporalType::LocalTime:
+          WriteLocalTime(utils::LocalTime(temporal_data.microseconds));
+          break;
+        case storage::TemporalType::LocalDateTime:
+          WriteLocalDateTime(utils::LocalDateTime(temporal_data.microseconds));
+          break;
+        case storage::TemporalType::Duration:
+          WriteDuration(utils::Duration(temporal_data.microseconds));
+          break;
+      }
+      break;
+    }
+  }
+}
+
+}  // namespace memgraph::glue
@@ -0,0 +1,105 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file Encoding of query values into Bolt without converting them to
+/// communication::bolt::Value first.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "communication/bolt/v1/encoder/base_encoder.hpp"
+#include "query/typed_value.hpp"
+#include "storage/v2/id_types.hpp"
+#include "storage/v2/property_value.hpp"
+#include "storage/v2/result.hpp"
+#include "storage/v2/view.hpp"
+
+namespace memgraph::storage {
+class EdgeAccessor;
+class Storage;
+class VertexAccessor;
+}  // namespace memgraph::storage
+
+namespace memgraph::glue {
+
+/// Buffer which keeps a whole Bolt encoded record in memory. The record is
+/// handed to the session's encoder only once it was encoded completely, so a
+/// value which can't be encoded (e.g. a deleted vertex) doesn't leave a partial
+/// message in the output stream. The memory is kept between records.
+class BoltRecordBuffer {
+ public:
+  void Write(const uint8_t *data, size_t size) { data_.insert(data_.end(), data, data + size); }
+
+  void Clear() { data_.clear(); }
+
+  const uint8_t *data() const { return data_.data(); }
+  size_t size() const { return data_.size(); }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+/// Bolt encoded label, property and edge type names, looked up by id. Mapping
+/// of ids to names never changes, so the cache can live as long as the
+/// session.
+class BoltNameCache {
+ public:
+  const std::string &Label(storage::LabelId label, const storage::Storage &db);
+  const std::string &Property(storage::PropertyId property, const storage::Storage &db);
+  const std::string &EdgeType(storage::EdgeTypeId edge_type, const storage::Storage &db);
+
+ private:
+  std::unordered_map<uint64_t, std::string> labels_;
+  std::unordered_map<uint64_t, std::string> properties_;
+  std::unordered_map<uint64_t, std::string> edge_types_;
+};
+
+/// Bolt encoder which writes `query::TypedValue`s, vertices and edges straight
+/// from the storage into the buffer, without building intermediate
+/// `communication::bolt::Value` trees.
+///
+/// Paths and graphs are rare in results and are still converted with
+/// `ToBoltValue` before being written.
+class TypedValueBoltEncoder : public communication::bolt::BaseEncoder<BoltRecordBuffer> {
+ public:
+  using communication::bolt::BaseEncoder<BoltRecordBuffer>::WriteEdge;
+  using communication::bolt::BaseEncoder<BoltRecordBuffer>::WriteVertex;
+
+  /// @param storage::Storage for getting label, property and edge type names.
+  /// @param storage::View for deciding which vertex and edge attributes are
+  ///        visible.
+  /// @param BoltNameCache for reusing the encoded names between records.
+  TypedValueBoltEncoder(BoltRecordBuffer &buffer, const storage::Storage &db, storage::View view,
+                        BoltNameCache &names);
+
+  /// @throw std::bad_alloc
+  storage::Result<void> WriteTypedValue(const query::TypedValue &value);
+
+  /// @throw std::bad_alloc
+  storage::Result<void> WriteVertex(const storage::VertexAccessor &vertex);
+
+  /// @throw std::bad_alloc
+  storage::Result<void> WriteEdge(const storage::EdgeAccessor &edge);
+
+  void WritePropertyValue(const storage::PropertyValue &value);
+
+ private:
+  void WriteProperties(const std::map<storage::PropertyId, storage::PropertyValue> &properties);
+
+  const storage::Storage *db_;
+  storage::View view_;
+  BoltNameCache *names_;
+};
+
+}  // namespace memgraph::glue
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -13,6 +13,11 @@
 #include <fcntl.h>
 #include <netinet/tcp.h>
 #include <poll.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <climits>
+#include <vector>
 
 #include "io/network/addrinfo.hpp"
 #include "io/network/socket.hpp"
@@ -220,6 +225,49 @@ bool Socket::Write(const std::string &s, bool have_more) {
   return Write(reinterpret_cast<const uint8_t *>(s.data()), s.size(), have_more);
 }
 
+bool Socket::Write(std::span<const std::span<const uint8_t>> buffers, bool have_more) {
+  constexpr unsigned msg_nosignal = MSG_NOSIGNAL;
+  constexpr unsigned msg_more = MSG_MORE;
+  const unsigned flags = msg_nosignal | (have_more ? msg_more : 0);
+  std::vector<iovec> iov;
+  iov.reserve(buffers.size());
+  for (const auto &buffer : buffers) {
+    if (buffer.empty()) continue;
+    iov.push_back({const_cast<uint8_t *>(buffer.data()), buffer.size()});
+  }
+  size_t first = 0;
+  while (first < iov.size()) {
+    msghdr msg{};
+    msg.msg_iov = iov.data() + first;
+    msg.msg_iovlen = std::min(iov.size() - first, static_cast<size_t>(IOV_MAX));
+    auto written = sendmsg(socket_, &msg, static_cast<int>(flags));
+    if (written == -1) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        // Terminal error, return failure.
+        return false;
+      }
+      // Non-fatal error, retry after the socket is ready.
+      if (!WaitForReadyWrite()) return false;
+    } else if (written == 0) {
+      // The client closed the connection.
+      return false;
+    } else {
+      // Skip the buffers that were written and move the start of the one that
+      // was written partially.
+      auto remaining = static_cast<size_t>(written);
+      while (remaining > 0 && remaining >= iov[first].iov_len) {
+        remaining -= iov[first].iov_len;
+        ++first;
+      }
+      if (remaining > 0) {
+        iov[first].iov_base = static_cast<uint8_t *>(iov[first].iov_base) + remaining;
+        iov[first].iov_len -= remaining;
+      }
+    }
+  }
+  return true;
+}
+
 ssize_t Socket::Read(void *buffer, size_t len, bool nonblock) {
   return recv(socket_, buffer, len, nonblock ? MSG_DONTWAIT : 0);
 }
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -14,6 +14,7 @@
 #include <functional>
 #include <iostream>
 #include <optional>
+#include <span>
 
 #include "io/network/endpoint.hpp"
 
@@ -151,6 +152,20 @@ class Socket {
   bool Write(const uint8_t *data, size_t len, bool have_more = false);
   bool Write(const std::string &s, bool have_more = false);
 
+  /**
+   * Write all of the buffers to the socket, one after another, with a single
+   * system call when the socket accepts all of the data at once.
+   *
+   * @param buffers buffers that should be written
+   * @param have_more set to true if you plan to send more data to allow the
+   * kernel to buffer the data instead of immediately sending it out
+   *
+   * @return write success status:
+   *             true if write succeeded
+   *             false if write failed
+   */
+  bool Write(std::span<const std::span<const uint8_t>> buffers, bool have_more = false);
+
   /**
    * Read data from the socket.
    * This function is a direct wrapper for the read function.
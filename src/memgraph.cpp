@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -90,6 +90,8 @@
 #include "communication/init.hpp"
 #include "communication/v2/server.hpp"
 #include "communication/v2/session.hpp"
+#include "glue/arrow_stream_writer.hpp"
+#include "glue/bolt_encoder.hpp"
 #include "glue/communication.hpp"
 
 #include "auth/auth.hpp"
@@ -155,11 +157,33 @@ DEFINE_VALIDATED_int32(monitoring_port, 7444,
                        "Port on which the websocket server for Memgraph monitoring should listen.",
                        FLAG_IN_RANGE(0, std::numeric_limits<uint16_t>::max()));
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_int32(monitoring_query_statistics_interval_sec, 60,
+                       "Interval in seconds at which the statistics of the most expensive queries are sent to the "
+                       "monitoring websocket. 0 disables sending them.",
+                       FLAG_IN_RANGE(0, std::numeric_limits<int32_t>::max()));
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_bool(monitoring_compression, false,
+            "Allows the clients of the monitoring websocket to negotiate the permessage-deflate extension.");
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 DEFINE_VALIDATED_int32(bolt_num_workers, std::max(std::thread::hardware_concurrency(), 1U),
                        "Number of workers used by the Bolt server. By default, this will be the "
                        "number of processing units available on the machine.",
                        FLAG_IN_RANGE(1, INT32_MAX));
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_int32(bolt_num_execution_workers, std::max(std::thread::hardware_concurrency(), 1U),
+                       "Number of workers executing the queries received by the Bolt server, separate from the "
+                       "workers handling the network I/O. If set to 0, the queries are executed by the Bolt server "
+                       "workers. By default, this will be the number of processing units available on the machine.",
+                       FLAG_IN_RANGE(0, INT32_MAX));
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_bool(bolt_group_pipelined_commits, true,
+            "Controls whether the queries a client pipelines in auto-commit mode write the WAL once after the last "
+            "of them, instead of once per query. Their results are sent after that in any case.");
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_bool(bolt_compression, false,
+            "Allows the clients to ask for compressed results: with the \"compression\": \"deflate\" field of the "
+            "Bolt HELLO message, or with the permessage-deflate extension when connecting over WebSocket.");
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 DEFINE_VALIDATED_int32(bolt_session_inactivity_timeout, 1800,
                        "Time in seconds after which inactive Bolt sessions will be "
                        "closed.",
@@ -275,6 +299,12 @@ DEFINE_uint64(replication_replica_check_frequency_sec, 1,
               "The time duration between two replica checks/pings. If < 1, replicas will NOT be checked at all. NOTE: "
               "The MAIN instance allocates a new thread for each REPLICA.");
 
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_uint64(replication_async_queue_size, memgraph::storage::Config::Replication().async_queue_size,
+                        "The number of committed transactions that can wait to be sent to an ASYNC replica. A replica "
+                        "that falls further behind is recovered from the snapshot and WAL files.",
+                        FLAG_IN_RANGE(1, 1000000));
+
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DEFINE_uint64(
     memory_limit, 0,
@@ -529,6 +559,9 @@ class BoltSession final : public memgraph::communication::bolt::Session<memgraph
 #endif
         endpoint_(endpoint),
         run_id_(data->run_id) {
+    // A query waiting for admission suspends the session instead of blocking
+    // the thread executing it, see AwaitResume.
+    interpreter_.SetNonBlockingAdmission(true);
   }
 
   using memgraph::communication::bolt::Session<memgraph::communication::v2::InputStream,
@@ -540,30 +573,65 @@ class BoltSession final : public memgraph::communication::bolt::Session<memgraph
 
   void RollbackTransaction() override { interpreter_.RollbackTransaction(); }
 
-  std::pair<std::vector<std::string>, std::optional<int>> Interpret(
-      const std::string &query, const std::map<std::string, memgraph::communication::bolt::Value> &params) override {
+  std::pair<std::vector<std::string>, std::map<std::string, memgraph::communication::bolt::Value>> Interpret(
+      const std::string &query, const std::map<std::string, memgraph::communication::bolt::Value> &params,
+      const std::map<std::string, memgraph::communication::bolt::Value> &extra) override {
     std::map<std::string, memgraph::storage::PropertyValue> params_pv;
     for (const auto &kv : params) params_pv.emplace(kv.first, memgraph::glue::ToPropertyValue(kv.second));
     const std::string *username{nullptr};
     if (user_) {
       username = &user_->username();
     }
+    // A RUN with a statement_id executes the session's prepared statement and
+    // ignores the query, while "prepare": true asks for the query to be
+    // prepared.
+    std::optional<int64_t> statement_id;
+    if (auto it = extra.find("statement_id"); it != extra.end() && it->second.IsInt()) {
+      statement_id = it->second.ValueInt();
+    }
+    const auto prepare_it = extra.find("prepare");
+    const bool prepare = prepare_it != extra.end() && prepare_it->second.IsBool() && prepare_it->second.ValueBool();
+    // "format": "arrow" asks for the results as Arrow IPC record batches, see
+    // ArrowResultStream.
+    bool arrow = false;
+    if (auto it = extra.find("format"); it != extra.end()) {
+      if (!it->second.IsString() || it->second.ValueString() != kArrowFormat) {
+        throw memgraph::communication::bolt::ClientError("Unsupported result format, the only one supported is '{}'.",
+                                                         kArrowFormat);
+      }
+      arrow = true;
+    }
 #ifdef MG_ENTERPRISE
-    if (memgraph::license::global_license_checker.IsEnterpriseValidFast()) {
-      audit_log_->Record(endpoint_.address().to_string(), user_ ? *username : "", query,
-                         memgraph::storage::PropertyValue(params_pv));
+    // A query which waited for admission was recorded when it was first run.
+    if (memgraph::license::global_license_checker.IsEnterpriseValidFast() && !interpreter_.IsAdmissionPending()) {
+      const auto *statement_query = statement_id ? interpreter_.PreparedStatementQuery(*statement_id) : nullptr;
+      audit_log_->Record(endpoint_.address().to_string(), user_ ? *username : "",
+                         statement_query ? *statement_query : query, memgraph::storage::PropertyValue(params_pv));
     }
 #endif
     try {
-      auto result = interpreter_.Prepare(query, params_pv, username);
+      auto result = statement_id ? interpreter_.PrepareStatement(*statement_id, params_pv, username)
+                                 : interpreter_.Prepare(query, params_pv, username, prepare);
       if (user_ && !memgraph::glue::AuthChecker::IsUserAuthorized(*user_, result.privileges)) {
         interpreter_.Abort();
         throw memgraph::communication::bolt::ClientError(
             "You are not authorized to execute this query! Please contact "
             "your database administrator.");
       }
-      return {result.headers, result.qid};
+      std::map<std::string, memgraph::communication::bolt::Value> metadata;
+      if (result.qid) metadata.emplace("qid", *result.qid);
+      if (result.statement_id) metadata.emplace("statement_id", *result.statement_id);
+      last_qid_ = result.qid.value_or(kNoQid);
+      if (arrow) {
+        arrow_results_.insert_or_assign(last_qid_, memgraph::glue::ArrowStreamWriter(std::move(result.headers)));
+        metadata.emplace("format", std::string(kArrowFormat));
+        return {{std::string(kArrowFormat)}, std::move(metadata)};
+      }
+      arrow_results_.erase(last_qid_);
+      return {std::move(result.headers), std::move(metadata)};
 
+    } catch (const memgraph::query::AdmissionPendingException &) {
+      throw memgraph::communication::bolt::SessionSuspendedException();
     } catch (const memgraph::query::QueryException &e) {
       // Wrap QueryException into ClientError, because we want to allow the
       // client to fix their query.
@@ -575,14 +643,20 @@ class BoltSession final : public memgraph::communication::bolt::Session<memgraph
 
   std::map<std::string, memgraph::communication::bolt::Value> Pull(TEncoder *encoder, std::optional<int> n,
                                                                    std::optional<int> qid) override {
-    TypedValueResultStream stream(encoder, db_);
+    if (auto it = arrow_results_.find(qid.value_or(last_qid_)); it != arrow_results_.end()) {
+      return PullArrowResults(encoder, it, n, qid);
+    }
+    TypedValueResultStream stream(encoder, db_, &record_buffer_, &bolt_names_);
     return PullResults(stream, n, qid);
   }
 
   std::map<std::string, memgraph::communication::bolt::Value> Discard(std::optional<int> n,
                                                                       std::optional<int> qid) override {
+    const auto key = qid.value_or(last_qid_);
     memgraph::query::DiscardValueResultStream stream;
-    return PullResults(stream, n, qid);
+    auto summary = PullResults(stream, n, qid);
+    if (!HasMore(summary)) arrow_results_.erase(key);
+    return summary;
   }
 
   void Abort() override { interpreter_.Abort(); }
@@ -601,7 +675,49 @@ class BoltSession final : public memgraph::communication::bolt::Session<memgraph
     return FLAGS_bolt_server_name_for_init;
   }
 
+  void SetPipelining(const bool pipelining) override {
+    interpreter_.SetDeferCommitFlush(pipelining && FLAGS_bolt_group_pipelined_commits);
+  }
+
+  void FlushDeferredCommits() override { interpreter_.FlushDeferredCommits(); }
+
+  void AwaitResume(std::function<void()> resume) override { interpreter_.AwaitAdmission(std::move(resume)); }
+
+  bool IsCompressionAllowed() override { return FLAGS_bolt_compression; }
+
  private:
+  static constexpr std::string_view kArrowFormat = "arrow";
+  // Key of the query run outside of an explicit transaction, which has no qid.
+  static constexpr int kNoQid = -1;
+  static constexpr size_t kArrowBatchRows = 65536;
+
+  static bool HasMore(const std::map<std::string, memgraph::communication::bolt::Value> &summary) {
+    const auto it = summary.find("has_more");
+    return it != summary.end() && it->second.IsBool() && it->second.ValueBool();
+  }
+
+  std::map<std::string, memgraph::communication::bolt::Value> PullArrowResults(
+      TEncoder *encoder, std::map<int, memgraph::glue::ArrowStreamWriter>::iterator writer, std::optional<int> n,
+      std::optional<int> qid) {
+    ArrowResultStream stream(encoder, &writer->second, &arrow_batch_, &record_buffer_);
+    try {
+      auto summary = PullResults(stream, n, qid);
+      if (HasMore(summary)) {
+        stream.SendBatch();
+      } else {
+        stream.SendEnd();
+        arrow_results_.erase(writer);
+      }
+      return summary;
+    } catch (const memgraph::query::QueryException &e) {
+      arrow_results_.erase(writer);
+      throw memgraph::communication::bolt::ClientError(e.what());
+    } catch (...) {
+      arrow_results_.erase(writer);
+      throw;
+    }
+  }
+
   template <typename TStream>
   std::map<std::string, memgraph::communication::bolt::Value> PullResults(TStream &stream, std::optional<int> n,
                                                                           std::optional<int> qid) {
@@ -638,19 +754,22 @@ class BoltSession final : public memgraph::communication::bolt::Session<memgraph
     }
   }
 
-  /// Wrapper around TEncoder which converts TypedValue to Value
-  /// before forwarding the calls to original TEncoder.
+  /// Wrapper around TEncoder which encodes TypedValue straight into Bolt
+  /// before forwarding the record to the original TEncoder.
   class TypedValueResultStream {
    public:
-    TypedValueResultStream(TEncoder *encoder, const memgraph::storage::Storage *db) : encoder_(encoder), db_(db) {}
+    TypedValueResultStream(TEncoder *encoder, const memgraph::storage::Storage *db,
+                           memgraph::glue::BoltRecordBuffer *record, memgraph::glue::BoltNameCache *names)
+        : encoder_(encoder), db_(db), record_(record), names_(names) {}
 
     void Result(const std::vector<memgraph::query::TypedValue> &values) {
-      std::vector<memgraph::communication::bolt::Value> decoded_values;
-      decoded_values.reserve(values.size());
+      record_->Clear();
+      memgraph::glue::TypedValueBoltEncoder value_encoder(*record_, *db_, memgraph::storage::View::NEW, *names_);
+      value_encoder.WriteTypeSize(values.size(), memgraph::communication::bolt::MarkerList);
       for (const auto &v : values) {
-        auto maybe_value = memgraph::glue::ToBoltValue(v, *db_, memgraph::storage::View::NEW);
-        if (maybe_value.HasError()) {
-          switch (maybe_value.GetError()) {
+        auto result = value_encoder.WriteTypedValue(v);
+        if (result.HasError()) {
+          switch (result.GetError()) {
             case memgraph::storage::Error::DELETED_OBJECT:
               throw memgraph::communication::bolt::ClientError("Returning a deleted object as a result.");
             case memgraph::storage::Error::NONEXISTENT_OBJECT:
@@ -661,19 +780,70 @@ class BoltSession final : public memgraph::communication::bolt::Session<memgraph
               throw memgraph::communication::bolt::ClientError("Unexpected storage error when streaming results.");
           }
         }
-        decoded_values.emplace_back(std::move(*maybe_value));
       }
-      encoder_->MessageRecord(decoded_values);
+      encoder_->MessageRecord(record_->data(), record_->size());
     }
 
    private:
     TEncoder *encoder_;
-    // NOTE: Needed only for ToBoltValue conversions
+    // NOTE: Needed only for name lookups and ToBoltValue conversions
     const memgraph::storage::Storage *db_;
+    memgraph::glue::BoltRecordBuffer *record_;
+    memgraph::glue::BoltNameCache *names_;
+  };
+
+  /// Collects the results into Arrow record batches, each of which is sent in
+  /// a record with a single byte array field. The client reads the stream by
+  /// concatenating the fields of the records.
+  class ArrowResultStream {
+   public:
+    ArrowResultStream(TEncoder *encoder, memgraph::glue::ArrowStreamWriter *writer, std::vector<uint8_t> *batch,
+                      memgraph::glue::BoltRecordBuffer *record)
+        : encoder_(encoder), writer_(writer), batch_(batch), record_(record) {}
+
+    void Result(const std::vector<memgraph::query::TypedValue> &values) {
+      writer_->AddRow(values);
+      if (writer_->BatchRows() >= kArrowBatchRows) SendBatch();
+    }
+
+    void SendBatch() {
+      batch_->clear();
+      writer_->WriteBatch(batch_);
+      // Nothing is written when a pull ends right after a full batch was sent.
+      if (!batch_->empty()) Send();
+    }
+
+    void SendEnd() {
+      batch_->clear();
+      writer_->WriteEnd(batch_);
+      Send();
+    }
+
+   private:
+    void Send() {
+      record_->Clear();
+      memgraph::communication::bolt::BaseEncoder<memgraph::glue::BoltRecordBuffer> record_encoder(*record_);
+      record_encoder.WriteTypeSize(1, memgraph::communication::bolt::MarkerList);
+      record_encoder.WriteBytes(batch_->data(), batch_->size());
+      encoder_->MessageRecord(record_->data(), record_->size());
+    }
+
+    TEncoder *encoder_;
+    memgraph::glue::ArrowStreamWriter *writer_;
+    std::vector<uint8_t> *batch_;
+    memgraph::glue::BoltRecordBuffer *record_;
   };
 
   // NOTE: Needed only for ToBoltValue conversions
   const memgraph::storage::Storage *db_;
+  // Reused between the records of the session.
+  memgraph::glue::BoltRecordBuffer record_buffer_;
+  memgraph::glue::BoltNameCache bolt_names_;
+  // Writers of the queries whose results are sent in the Arrow format, by the
+  // qid of the query.
+  std::map<int, memgraph::glue::ArrowStreamWriter> arrow_results_;
+  int last_qid_{kNoQid};
+  std::vector<uint8_t> arrow_batch_;
   memgraph::query::Interpreter interpreter_;
   memgraph::utils::Synchronized<memgraph::auth::Auth, memgraph::utils::WritePrioritizedRWLock> *auth_;
   std::optional<memgraph::auth::User> user_;
@@ -881,7 +1051,8 @@ int main(int argc, char **argv) {
                      .wal_file_flush_every_n_tx = FLAGS_storage_wal_file_flush_every_n_tx,
                      .snapshot_on_exit = FLAGS_storage_snapshot_on_exit,
                      .restore_replicas_on_startup = true},
-      .transaction = {.isolation_level = ParseIsolationLevel()}};
+      .transaction = {.isolation_level = ParseIsolationLevel()},
+      .replication = {.async_queue_size = FLAGS_replication_async_queue_size}};
   if (FLAGS_storage_snapshot_interval_sec == 0) {
     if (FLAGS_storage_wal_enabled) {
       LOG_FATAL(
@@ -975,7 +1146,7 @@ int main(int argc, char **argv) {
   auto server_endpoint = memgraph::communication::v2::ServerEndpoint{
       boost::asio::ip::address::from_string(FLAGS_bolt_address), static_cast<uint16_t>(FLAGS_bolt_port)};
   ServerT server(server_endpoint, &session_data, &context, FLAGS_bolt_session_inactivity_timeout, service_name,
-                 FLAGS_bolt_num_workers);
+                 FLAGS_bolt_num_workers, FLAGS_bolt_num_execution_workers, FLAGS_bolt_compression);
 
   const auto run_id = memgraph::utils::GenerateUUID();
   const auto machine_id = memgraph::utils::GetMachineId();
@@ -1006,9 +1177,24 @@ int main(int argc, char **argv) {
 
   memgraph::communication::websocket::SafeAuth websocket_auth{&auth};
   memgraph::communication::websocket::Server websocket_server{
-      {FLAGS_monitoring_address, static_cast<uint16_t>(FLAGS_monitoring_port)}, &context, websocket_auth};
+      {FLAGS_monitoring_address, static_cast<uint16_t>(FLAGS_monitoring_port)}, &context, websocket_auth,
+      FLAGS_monitoring_compression};
   AddLoggerSink(websocket_server.GetLoggingSink());
 
+  memgraph::utils::Scheduler query_statistics_scheduler;
+  if (FLAGS_monitoring_query_statistics_interval_sec > 0) {
+    query_statistics_scheduler.Run(
+        "Query statistics", std::chrono::seconds(FLAGS_monitoring_query_statistics_interval_sec),
+        [&websocket_server, &interpreter_context] {
+          static constexpr size_t kMaxReportedQueries = 20;
+          nlohmann::json message;
+          message["event"] = "query_statistics";
+          message["statistics"] =
+              memgraph::query::QueryStatisticsToJson(interpreter_context.query_statistics.Snapshot(kMaxReportedQueries));
+          websocket_server.WriteToAll(std::make_shared<std::string>(message.dump()));
+        });
+  }
+
   // Handler for regular termination signals
   auto shutdown = [&websocket_server, &server, &interpreter_context] {
     // Server needs to be shutdown first and then the database. This prevents
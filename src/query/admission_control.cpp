@@ -0,0 +1,432 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "query/admission_control.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+#include "query/exceptions.hpp"
+#include "utils/event_counter.hpp"
+#include "utils/flag_validation.hpp"
+#include "utils/logging.hpp"
+#include "utils/string.hpp"
+#include "utils/timer.hpp"
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_string(resource_pools, "",
+                        "Comma separated resource pools in the form name:max_concurrent_queries[:memory_limit_mib]. "
+                        "The queries of a pool wait for admission while the pool already runs its maximum number of "
+                        "queries, and each of them is limited to an equal share of the pool's memory limit. Queries "
+                        "of users without a pool run in the pool named default, or without limits if there is none.",
+                        {
+                          try {
+                            memgraph::query::ParseResourcePools(value);
+                            return true;
+                          } catch (const memgraph::utils::BasicException &e) {
+                            std::cout << "Invalid resource pools: " << e.what() << std::endl;
+                            return false;
+                          }
+                        });
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_string(resource_pool_assignments, "",
+                        "Comma separated assignments of users and roles to the resource pools in the form "
+                        "username=pool[:priority] or role:rolename=pool[:priority]. Waiting queries with higher "
+                        "priority are admitted first, the default priority is 0. A user's own assignment takes "
+                        "precedence over the assignment of their role.",
+                        {
+                          try {
+                            memgraph::query::ParseResourcePoolAssignments(value);
+                            return true;
+                          } catch (const memgraph::utils::BasicException &e) {
+                            std::cout << "Invalid resource pool assignments: " << e.what() << std::endl;
+                            return false;
+                          }
+                        });
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_uint64(query_admission_timeout_sec, 600,
+                        "Maximum time in seconds a query waits for admission into its resource pool. The wait also "
+                        "counts towards the execution timeout.",
+                        FLAG_IN_RANGE(1, 24 * 3600));
+
+namespace EventCounter {
+extern const Event QueuedQuery;
+extern const Event QueryAdmissionWaitMicroseconds;
+extern const Event QueryAdmissionTimedOut;
+}  // namespace EventCounter
+
+namespace memgraph::query {
+
+namespace {
+
+// How often a waiting query checks whether the database is shutting down.
+constexpr std::chrono::milliseconds kAbortCheckInterval{100};
+
+constexpr std::string_view kDefaultPool = "default";
+constexpr std::string_view kRolePrefix = "role:";
+
+void RecordQueuedAdmission(ResourcePoolStatistics *statistics, const std::chrono::duration<double> wait) {
+  ++statistics->admitted;
+  ++statistics->queued;
+  statistics->total_wait += wait;
+  statistics->max_wait = std::max(statistics->max_wait, wait);
+  statistics->wait_histogram.Add(wait);
+  EventCounter::IncrementCounter(EventCounter::QueuedQuery);
+  EventCounter::IncrementCounter(EventCounter::QueryAdmissionWaitMicroseconds,
+                                 std::chrono::duration_cast<std::chrono::microseconds>(wait).count());
+}
+
+int64_t ParseNumber(const std::string_view value, const std::string_view what, const std::string_view definition) {
+  try {
+    return utils::ParseInt(utils::Trim(value));
+  } catch (const utils::BasicException &) {
+    throw utils::BasicException("Invalid {} '{}' in '{}'.", what, value, definition);
+  }
+}
+
+}  // namespace
+
+std::vector<ResourcePoolConfig> ParseResourcePools(const std::string_view pools) {
+  std::vector<ResourcePoolConfig> result;
+  for (const auto &definition : utils::Split(pools, ",")) {
+    if (utils::Trim(definition).empty()) continue;
+    const auto parts = utils::Split(definition, ":");
+    if (parts.size() < 2 || parts.size() > 3) {
+      throw utils::BasicException("Resource pool '{}' isn't in the form name:max_concurrent_queries[:memory_limit_mib].",
+                                  definition);
+    }
+    ResourcePoolConfig config;
+    config.name = utils::Trim(parts[0]);
+    if (config.name.empty()) {
+      throw utils::BasicException("Resource pool '{}' has no name.", definition);
+    }
+    if (std::any_of(result.begin(), result.end(), [&](const auto &pool) { return pool.name == config.name; })) {
+      throw utils::BasicException("Resource pool '{}' is defined more than once.", config.name);
+    }
+    const auto max_concurrent_queries = ParseNumber(parts[1], "maximum number of concurrent queries", definition);
+    if (max_concurrent_queries <= 0) {
+      throw utils::BasicException("Resource pool '{}' must allow at least one concurrent query.", config.name);
+    }
+    config.max_concurrent_queries = static_cast<size_t>(max_concurrent_queries);
+    if (parts.size() == 3) {
+      const auto memory_limit_mib = ParseNumber(parts[2], "memory limit", definition);
+      if (memory_limit_mib <= 0) {
+        throw utils::BasicException("Resource pool '{}' must have a positive memory limit.", config.name);
+      }
+      config.memory_limit = static_cast<size_t>(memory_limit_mib) * 1024 * 1024;
+    }
+    result.push_back(std::move(config));
+  }
+  return result;
+}
+
+ResourcePoolAssignments ParseResourcePoolAssignments(const std::string_view assignments) {
+  ResourcePoolAssignments result;
+  for (const auto &definition : utils::Split(assignments, ",")) {
+    if (utils::Trim(definition).empty()) continue;
+    const auto sides = utils::Split(definition, "=");
+    if (sides.size() != 2) {
+      throw utils::BasicException("Resource pool assignment '{}' isn't in the form name=pool[:priority].", definition);
+    }
+    auto name = utils::Trim(sides[0]);
+    auto *target = &result.users;
+    if (name.starts_with(kRolePrefix)) {
+      name = utils::Trim(name.substr(kRolePrefix.size()));
+      target = &result.roles;
+    }
+    const auto pool_and_priority = utils::Split(sides[1], ":");
+    if (name.empty() || pool_and_priority.empty() || pool_and_priority.size() > 2 ||
+        utils::Trim(pool_and_priority[0]).empty()) {
+      throw utils::BasicException("Resource pool assignment '{}' isn't in the form name=pool[:priority].", definition);
+    }
+    ResourcePoolAssignment assignment{std::string(utils::Trim(pool_and_priority[0]))};
+    if (pool_and_priority.size() == 2) {
+      assignment.priority = ParseNumber(pool_and_priority[1], "priority", definition);
+    }
+    if (!target->emplace(std::string(name), std::move(assignment)).second) {
+      throw utils::BasicException("'{}' is assigned to more than one resource pool.", utils::Trim(sides[0]));
+    }
+  }
+  return result;
+}
+
+AdmissionController::Ticket &AdmissionController::Ticket::operator=(Ticket &&other) noexcept {
+  if (this != &other) {
+    Release();
+    pool_ = std::exchange(other.pool_, nullptr);
+  }
+  return *this;
+}
+
+std::optional<size_t> AdmissionController::Ticket::memory_limit() const {
+  if (!pool_ || !pool_->statistics.config.memory_limit) return std::nullopt;
+  const auto &config = pool_->statistics.config;
+  return *config.memory_limit / config.max_concurrent_queries;
+}
+
+void AdmissionController::Ticket::Release() {
+  if (!pool_) return;
+  std::vector<std::function<void()>> admitted;
+  {
+    std::lock_guard guard(pool_->lock);
+    --pool_->statistics.running;
+    admitted = AdmitWaiting(pool_);
+  }
+  for (auto &on_ready : admitted) on_ready();
+  pool_ = nullptr;
+}
+
+AdmissionController::PendingAdmission &AdmissionController::PendingAdmission::operator=(
+    PendingAdmission &&other) noexcept {
+  if (this != &other) {
+    Cancel();
+    state_ = std::move(other.state_);
+  }
+  return *this;
+}
+
+void AdmissionController::PendingAdmission::OnReady(std::function<void()> on_ready) {
+  MG_ASSERT(state_, "Waiting for an admission which isn't pending");
+  {
+    std::lock_guard guard(state_->pool->lock);
+    if (state_->status == PendingState::Status::WAITING) {
+      state_->on_ready = std::move(on_ready);
+      return;
+    }
+  }
+  on_ready();
+}
+
+void AdmissionController::PendingAdmission::Cancel() {
+  if (!state_) return;
+  const auto state = std::move(state_);
+  auto &pool = *state->pool;
+  // The callback is destroyed without holding the lock, since it may own the
+  // object which owns this one.
+  std::function<void()> on_ready;
+  std::vector<std::function<void()>> admitted;
+  {
+    std::lock_guard guard(pool.lock);
+    on_ready = std::move(state->on_ready);
+    if (state->status == PendingState::Status::WAITING) {
+      pool.waiting.erase(state->position);
+      --pool.statistics.waiting;
+    } else if (state->status == PendingState::Status::ADMITTED) {
+      // The slot reserved for the query is freed.
+      --pool.statistics.running;
+    }
+    admitted = AdmitWaiting(&pool);
+  }
+  for (auto &ready : admitted) ready();
+}
+
+AdmissionController::AdmissionController(const std::vector<ResourcePoolConfig> &pools,
+                                         ResourcePoolAssignments assignments)
+    : assignments_(std::move(assignments)) {
+  for (const auto &config : pools) {
+    pools_.emplace(config.name, std::make_unique<Pool>(config));
+  }
+  for (const auto *assigned : {&assignments_.users, &assignments_.roles}) {
+    for (const auto &[name, assignment] : *assigned) {
+      MG_ASSERT(pools_.contains(assignment.pool), "Resource pool '{}' assigned to '{}' isn't defined.",
+                assignment.pool, name);
+    }
+  }
+  if (Enabled()) {
+    expiry_scheduler_.Run("AdmissionTimer", kAbortCheckInterval, [this] { ExpireWaiting(); });
+  }
+}
+
+std::optional<ResourcePoolAssignment> AdmissionController::FindAssignment(
+    const std::string *username, const std::function<std::optional<std::string>()> &get_rolename) const {
+  if (username) {
+    if (auto it = assignments_.users.find(*username); it != assignments_.users.end()) {
+      return it->second;
+    }
+    // Looking up the role reads the auth storage, so it's avoided when no
+    // role could match.
+    if (!assignments_.roles.empty()) {
+      if (const auto rolename = get_rolename()) {
+        if (auto it = assignments_.roles.find(*rolename); it != assignments_.roles.end()) {
+          return it->second;
+        }
+      }
+    }
+  }
+  if (pools_.contains(std::string(kDefaultPool))) {
+    return ResourcePoolAssignment{std::string(kDefaultPool)};
+  }
+  return std::nullopt;
+}
+
+AdmissionController::Ticket AdmissionController::Admit(
+    const std::string *username, const std::function<std::optional<std::string>()> &get_rolename,
+    const std::chrono::steady_clock::time_point deadline, const std::atomic<bool> *abort) {
+  if (!Enabled()) return {};
+  const auto assignment = FindAssignment(username, get_rolename);
+  if (!assignment) return {};
+  auto &pool = *pools_.at(assignment->pool);
+  auto &statistics = pool.statistics;
+
+  std::unique_lock guard(pool.lock);
+  if (TakeFreeSlot(&pool)) return Ticket(&pool);
+
+  const auto position = pool.waiting.emplace(std::make_pair(-assignment->priority, pool.next_arrival++), nullptr).first;
+  ++statistics.waiting;
+  utils::Timer wait_timer;
+  // Removes the query from the waiting ones and admits the next ones, which
+  // may run now.
+  const auto stop_waiting = [&] {
+    pool.waiting.erase(position);
+    --statistics.waiting;
+    auto admitted = AdmitWaiting(&pool);
+    guard.unlock();
+    for (auto &on_ready : admitted) on_ready();
+  };
+  while (pool.waiting.begin() != position || statistics.running >= statistics.config.max_concurrent_queries) {
+    if (abort && abort->load(std::memory_order_acquire)) {
+      stop_waiting();
+      throw HintedAbortError();
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      ++statistics.timed_out;
+      EventCounter::IncrementCounter(EventCounter::QueryAdmissionTimedOut);
+      stop_waiting();
+      throw AdmissionTimeoutException(assignment->pool);
+    }
+    pool.cv.wait_until(guard, std::min(deadline, now + kAbortCheckInterval));
+  }
+  ++statistics.running;
+  RecordQueuedAdmission(&statistics, wait_timer.Elapsed());
+  stop_waiting();
+  return Ticket(&pool);
+}
+
+std::variant<AdmissionController::Ticket, AdmissionController::PendingAdmission> AdmissionController::TryAdmit(
+    const std::string *username, const std::function<std::optional<std::string>()> &get_rolename,
+    const std::chrono::steady_clock::time_point deadline, const std::atomic<bool> *abort) {
+  if (!Enabled()) return Ticket{};
+  const auto assignment = FindAssignment(username, get_rolename);
+  if (!assignment) return Ticket{};
+  auto &pool = *pools_.at(assignment->pool);
+
+  std::lock_guard guard(pool.lock);
+  if (TakeFreeSlot(&pool)) return Ticket(&pool);
+
+  auto state = std::make_shared<PendingState>();
+  state->pool = &pool;
+  state->position = {-assignment->priority, pool.next_arrival++};
+  state->deadline = deadline;
+  state->abort = abort;
+  pool.waiting.emplace(state->position, state);
+  ++pool.statistics.waiting;
+  return PendingAdmission(std::move(state));
+}
+
+std::optional<AdmissionController::Ticket> AdmissionController::TakeTicket(PendingAdmission *pending) {
+  MG_ASSERT(pending->state_, "Taking the ticket of an admission which isn't pending");
+  // The state is destroyed after the lock is released.
+  auto state = std::move(pending->state_);
+  auto &pool = *state->pool;
+  std::lock_guard guard(pool.lock);
+  switch (state->status) {
+    case PendingState::Status::WAITING:
+      pending->state_ = std::move(state);
+      return std::nullopt;
+    case PendingState::Status::ADMITTED:
+      return Ticket(&pool);
+    case PendingState::Status::TIMED_OUT:
+      throw AdmissionTimeoutException(pool.statistics.config.name);
+    case PendingState::Status::ABORTED:
+      throw HintedAbortError();
+  }
+  LOG_FATAL("Unknown admission status");
+}
+
+bool AdmissionController::TakeFreeSlot(Pool *pool) {
+  auto &statistics = pool->statistics;
+  if (!pool->waiting.empty() || statistics.running >= statistics.config.max_concurrent_queries) return false;
+  ++statistics.running;
+  ++statistics.admitted;
+  statistics.wait_histogram.Add(std::chrono::duration<double>{0});
+  return true;
+}
+
+std::vector<std::function<void()>> AdmissionController::AdmitWaiting(Pool *pool) {
+  std::vector<std::function<void()>> admitted;
+  auto &statistics = pool->statistics;
+  while (!pool->waiting.empty() && statistics.running < statistics.config.max_concurrent_queries) {
+    auto first = pool->waiting.begin();
+    if (!first->second) {
+      // All blocked queries are woken up, the first of them in the admission
+      // order takes the slot.
+      pool->cv.notify_all();
+      break;
+    }
+    const auto state = std::move(first->second);
+    pool->waiting.erase(first);
+    --statistics.waiting;
+    ++statistics.running;
+    state->status = PendingState::Status::ADMITTED;
+    RecordQueuedAdmission(&statistics, state->wait_timer.Elapsed());
+    if (state->on_ready) admitted.push_back(std::move(state->on_ready));
+  }
+  return admitted;
+}
+
+void AdmissionController::ExpireWaiting() {
+  const auto now = std::chrono::steady_clock::now();
+  for (auto &[name, pool] : pools_) {
+    std::vector<std::function<void()>> ready;
+    {
+      std::lock_guard guard(pool->lock);
+      for (auto it = pool->waiting.begin(); it != pool->waiting.end();) {
+        const auto &state = it->second;
+        if (!state) {
+          ++it;
+          continue;
+        }
+        if (state->abort && state->abort->load(std::memory_order_acquire)) {
+          state->status = PendingState::Status::ABORTED;
+        } else if (now >= state->deadline) {
+          state->status = PendingState::Status::TIMED_OUT;
+          ++pool->statistics.timed_out;
+          EventCounter::IncrementCounter(EventCounter::QueryAdmissionTimedOut);
+        } else {
+          ++it;
+          continue;
+        }
+        if (state->on_ready) ready.push_back(std::move(state->on_ready));
+        it = pool->waiting.erase(it);
+        --pool->statistics.waiting;
+      }
+      auto admitted = AdmitWaiting(pool.get());
+      ready.insert(ready.end(), std::make_move_iterator(admitted.begin()), std::make_move_iterator(admitted.end()));
+    }
+    for (auto &on_ready : ready) on_ready();
+  }
+}
+
+std::vector<ResourcePoolStatistics> AdmissionController::Statistics() const {
+  std::vector<ResourcePoolStatistics> result;
+  result.reserve(pools_.size());
+  for (const auto &[name, pool] : pools_) {
+    std::lock_guard guard(pool->lock);
+    result.push_back(pool->statistics);
+  }
+  std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) { return a.config.name < b.config.name; });
+  return result;
+}
+
+}  // namespace memgraph::query
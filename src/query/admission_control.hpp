@@ -0,0 +1,245 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "query/query_statistics.hpp"
+#include "utils/scheduler.hpp"
+#include "utils/timer.hpp"
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_string(resource_pools);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_string(resource_pool_assignments);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_uint64(query_admission_timeout_sec);
+
+namespace memgraph::query {
+
+/// Resource pool limiting the queries which run in it, see `--resource-pools`.
+struct ResourcePoolConfig {
+  std::string name;
+  size_t max_concurrent_queries;
+  // Memory which the queries running in the pool may use together. Each query
+  // gets an equal share of it as its memory limit, so the pool stays within
+  // the limit even when all of its queries run at once.
+  std::optional<size_t> memory_limit;
+};
+
+/// Resource pool of a user or a role, see `--resource-pool-assignments`.
+struct ResourcePoolAssignment {
+  std::string pool;
+  // Queries waiting for admission into a pool are admitted by descending
+  // priority, and in the order of arrival within the same priority.
+  int64_t priority{0};
+};
+
+struct ResourcePoolAssignments {
+  std::unordered_map<std::string, ResourcePoolAssignment> users;
+  std::unordered_map<std::string, ResourcePoolAssignment> roles;
+};
+
+/// Parses the comma separated `name:max_concurrent_queries[:memory_limit_mib]`
+/// pool definitions.
+/// @throw utils::BasicException if the definitions are malformed
+std::vector<ResourcePoolConfig> ParseResourcePools(std::string_view pools);
+
+/// Parses the comma separated `user=pool[:priority]` and
+/// `role:rolename=pool[:priority]` assignments.
+/// @throw utils::BasicException if the assignments are malformed
+ResourcePoolAssignments ParseResourcePoolAssignments(std::string_view assignments);
+
+/// Statistics of a resource pool since the start of the database.
+struct ResourcePoolStatistics {
+  ResourcePoolConfig config;
+  size_t running{0};
+  size_t waiting{0};
+  int64_t admitted{0};
+  // Number of the admitted queries which had to wait for admission.
+  int64_t queued{0};
+  int64_t timed_out{0};
+  std::chrono::duration<double> total_wait{0};
+  std::chrono::duration<double> max_wait{0};
+  LatencyHistogram wait_histogram;
+};
+
+/// Admission control of the queries assigned to resource pools. A query is
+/// admitted into its pool only while fewer than `max_concurrent_queries` of
+/// the pool's queries are running, otherwise it waits for one of them to
+/// finish. Queries which aren't assigned to a pool go to the pool named
+/// `default`, and are admitted immediately if there is no such pool.
+///
+/// The pools and the assignments are fixed for the lifetime of the
+/// controller, so looking them up needs no locking.
+///
+/// A query can wait either by blocking its thread in `Admit`, or without
+/// blocking by `TryAdmit`. The latter is used by the Bolt sessions, whose
+/// threads are shared by many sessions and would otherwise be held by the
+/// waiting queries while the admitted ones can't continue.
+class AdmissionController {
+  struct Pool;
+  struct PendingState;
+
+ public:
+  /// Slot of an admitted query in its pool, which is freed when the ticket is
+  /// destroyed. An empty ticket belongs to a query which isn't limited by any
+  /// pool.
+  class Ticket {
+   public:
+    Ticket() = default;
+    Ticket(const Ticket &) = delete;
+    Ticket &operator=(const Ticket &) = delete;
+    Ticket(Ticket &&other) noexcept : pool_(std::exchange(other.pool_, nullptr)) {}
+    Ticket &operator=(Ticket &&other) noexcept;
+    ~Ticket() { Release(); }
+
+    /// Memory limit of the query derived from the pool's memory limit.
+    std::optional<size_t> memory_limit() const;
+
+   private:
+    friend class AdmissionController;
+    explicit Ticket(Pool *pool) : pool_(pool) {}
+
+    void Release();
+
+    Pool *pool_{nullptr};
+  };
+
+  /// Query waiting for admission without blocking a thread, see `TryAdmit`.
+  /// The query stops waiting when the object is destroyed.
+  class PendingAdmission {
+   public:
+    PendingAdmission(const PendingAdmission &) = delete;
+    PendingAdmission &operator=(const PendingAdmission &) = delete;
+    PendingAdmission(PendingAdmission &&other) noexcept = default;
+    PendingAdmission &operator=(PendingAdmission &&other) noexcept;
+    ~PendingAdmission() { Cancel(); }
+
+    /// Calls `on_ready` once the query is admitted or stops waiting because of
+    /// the deadline or the abort, or right away if it already did. It may be
+    /// called from any thread, and isn't called if this object is destroyed
+    /// first.
+    void OnReady(std::function<void()> on_ready);
+
+   private:
+    friend class AdmissionController;
+    explicit PendingAdmission(std::shared_ptr<PendingState> state) : state_(std::move(state)) {}
+
+    void Cancel();
+
+    std::shared_ptr<PendingState> state_;
+  };
+
+  AdmissionController(const std::vector<ResourcePoolConfig> &pools, ResourcePoolAssignments assignments);
+
+  /// Returns whether any pool is defined. Without pools, `Admit` never waits.
+  bool Enabled() const { return !pools_.empty(); }
+
+  /// Waits until the query of `username` can run in its pool. The role of
+  /// the user is looked up with `get_rolename` only if some roles are
+  /// assigned to pools and the user isn't assigned directly.
+  ///
+  /// @throw AdmissionTimeoutException if the query wasn't admitted by the
+  ///        `deadline`
+  /// @throw HintedAbortError if `abort` was set while waiting
+  Ticket Admit(const std::string *username, const std::function<std::optional<std::string>()> &get_rolename,
+               std::chrono::steady_clock::time_point deadline, const std::atomic<bool> *abort);
+
+  /// Same as `Admit`, but instead of waiting it returns a `PendingAdmission`
+  /// if the query can't run yet. The query keeps its place among the waiting
+  /// ones, and a slot which is freed is reserved for it when it's first in
+  /// line. The ticket is then taken with `TakeTicket`.
+  std::variant<Ticket, PendingAdmission> TryAdmit(const std::string *username,
+                                                  const std::function<std::optional<std::string>()> &get_rolename,
+                                                  std::chrono::steady_clock::time_point deadline,
+                                                  const std::atomic<bool> *abort);
+
+  /// Returns the ticket of the admitted `pending` query, or nothing if it's
+  /// still waiting. The `pending` object is empty afterwards unless the query
+  /// is still waiting.
+  ///
+  /// @throw AdmissionTimeoutException if the query wasn't admitted by its
+  ///        deadline
+  /// @throw HintedAbortError if its abort was set while waiting
+  std::optional<Ticket> TakeTicket(PendingAdmission *pending);
+
+  /// Returns the statistics of all pools ordered by name.
+  std::vector<ResourcePoolStatistics> Statistics() const;
+
+ private:
+  struct Pool {
+    explicit Pool(ResourcePoolConfig config) { statistics.config = std::move(config); }
+
+    mutable std::mutex lock;
+    std::condition_variable cv;
+    // The waiting queries ordered by admission, i.e. by the negated priority
+    // and the order of arrival. The queries blocked in `Admit` have no state,
+    // they take a free slot themselves when they are first in line.
+    std::map<std::pair<int64_t, uint64_t>, std::shared_ptr<PendingState>> waiting;
+    uint64_t next_arrival{0};
+    ResourcePoolStatistics statistics;
+  };
+
+  struct PendingState {
+    enum class Status : uint8_t { WAITING, ADMITTED, TIMED_OUT, ABORTED };
+
+    Pool *pool;
+    std::pair<int64_t, uint64_t> position;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool> *abort;
+    utils::Timer wait_timer;
+    // Guarded by the lock of the pool.
+    Status status{Status::WAITING};
+    std::function<void()> on_ready;
+  };
+
+  std::optional<ResourcePoolAssignment> FindAssignment(
+      const std::string *username, const std::function<std::optional<std::string>()> &get_rolename) const;
+
+  /// Takes a free slot of the `pool` if no query is waiting for one.
+  static bool TakeFreeSlot(Pool *pool);
+
+  /// Reserves the free slots for the `PendingAdmission` queries first in
+  /// line, or wakes up the blocked query which is first in line. Returns the
+  /// callbacks of the admitted queries, which are called without holding the
+  /// lock of the pool.
+  static std::vector<std::function<void()>> AdmitWaiting(Pool *pool);
+
+  /// Stops the waiting of the `PendingAdmission` queries whose deadline
+  /// passed or whose abort was set.
+  void ExpireWaiting();
+
+  std::unordered_map<std::string, std::unique_ptr<Pool>> pools_;
+  ResourcePoolAssignments assignments_;
+  // Checks the deadlines of the queries waiting without a thread, it's
+  // destroyed first so that it doesn't run on destroyed pools.
+  utils::Scheduler expiry_scheduler_;
+};
+
+}  // namespace memgraph::query
@@ -14,6 +14,7 @@
 
 #include <concepts>
 #include <cstdint>
+#include <map>
 #include <string>
 #include <string_view>
 
@@ -107,5 +108,36 @@ storage::PropertyValue PropsSetChecked(T *record, const storage::PropertyId &key
   }
 }
 
+template <typename T>
+concept AccessorWithInitProperties = requires(T accessor,
+                                              const std::map<storage::PropertyId, storage::PropertyValue> &properties) {
+  { accessor.InitProperties(properties) } -> std::same_as<storage::Result<bool>>;
+};
+
+/// Set all of the `properties` on a `record` which doesn't have any
+/// properties yet, like a newly created vertex or edge.
+///
+/// @throw QueryRuntimeException if the properties cannot be set
+template <AccessorWithInitProperties T>
+void MultiPropsInitChecked(T *record, const std::map<storage::PropertyId, storage::PropertyValue> &properties) {
+  auto maybe_initialized = record->InitProperties(properties);
+  if (maybe_initialized.HasError()) {
+    switch (maybe_initialized.GetError()) {
+      case storage::Error::SERIALIZATION_ERROR:
+        throw TransactionSerializationException();
+      case storage::Error::DELETED_OBJECT:
+        throw QueryRuntimeException("Trying to set properties on a deleted object.");
+      case storage::Error::PROPERTIES_DISABLED:
+        throw QueryRuntimeException("Can't set property because properties on edges are disabled.");
+      case storage::Error::VERTEX_HAS_EDGES:
+      case storage::Error::NONEXISTENT_OBJECT:
+        throw QueryRuntimeException("Unexpected error when setting a property.");
+    }
+  }
+  if (!*maybe_initialized) {
+    throw QueryRuntimeException("Unexpected error when setting a property.");
+  }
+}
+
 int64_t QueryTimestamp();
 }  // namespace memgraph::query
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <type_traits>
 
@@ -21,6 +22,7 @@
 #include "query/plan/profile.hpp"
 #include "query/trigger.hpp"
 #include "utils/async_timer.hpp"
+#include "utils/perf_events.hpp"
 
 namespace memgraph::query {
 
@@ -70,8 +72,17 @@ struct ExecutionContext {
   std::chrono::duration<double> profile_execution_time;
   plan::ProfilingStats stats;
   plan::ProfilingStats *stats_root{nullptr};
+  // Memory usage and hardware counters which are attributed to the operators
+  // when profiling, null if they aren't tracked.
+  plan::ProfilingMemoryUsage *profile_memory_usage{nullptr};
+  utils::PerfEventCounters *profile_perf_event_counters{nullptr};
   ExecutionStats execution_stats;
   TriggerContextCollector *trigger_context_collector{nullptr};
+  // Commits the transaction so far and continues in a new one, the same way
+  // the interpreter commits a whole transaction. Used by
+  // `CALL { ... } IN TRANSACTIONS`, empty if the query isn't run by an
+  // interpreter.
+  std::function<void()> periodic_commit;
   utils::AsyncTimer timer;
 #ifdef MG_ENTERPRISE
   std::unique_ptr<FineGrainedAuthChecker> auth_checker{nullptr};
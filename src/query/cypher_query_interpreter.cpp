@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -14,20 +14,43 @@
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DEFINE_bool(query_cost_planner, true, "Use the cost-estimating query planner.");
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-DEFINE_VALIDATED_int32(query_plan_cache_ttl, 60, "Time to live for cached query plans, in seconds.",
+DEFINE_VALIDATED_int32(query_plan_cache_ttl, 60,
+                       "Time to live for cached query plans, in seconds. The time is counted from the last use of the "
+                       "plan.",
                        FLAG_IN_RANGE(0, std::numeric_limits<int32_t>::max()));
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_int32(query_plan_cache_max_entries, 1000,
+                       "Maximum number of cached query plans, the least recently used plans are evicted. 0 means "
+                       "unlimited.",
+                       FLAG_IN_RANGE(0, std::numeric_limits<int32_t>::max()));
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_int32(query_ast_cache_max_entries, 10000,
+                       "Maximum number of cached parsed queries, the least recently used queries are evicted. 0 means "
+                       "unlimited.",
+                       FLAG_IN_RANGE(0, std::numeric_limits<int32_t>::max()));
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_double(query_plan_cache_replan_ratio, 10.0,
+                        "A cached plan is made again when a vertex count it was costed with grows or shrinks by more "
+                        "than this ratio. 0 disables re-planning.",
+                        FLAG_IN_RANGE(0, std::numeric_limits<double>::max()));
 
 namespace memgraph::query {
-CachedPlan::CachedPlan(std::unique_ptr<LogicalPlan> plan) : plan_(std::move(plan)) {}
 
-ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::string, storage::PropertyValue> &params,
-                       utils::SkipList<QueryCacheEntry> *cache, const InterpreterConfig::Query &query_config) {
-  // Strip the query for caching purposes. The process of stripping a query
-  // "normalizes" it by replacing any literals with new parameters. This
-  // results in just the *structure* of the query being taken into account for
-  // caching.
-  frontend::StrippedQuery stripped_query{query_string};
+namespace {
+// Changes of small counts don't change plans noticeably, so the counts are
+// compared as if they were at least this big.
+constexpr int64_t kReplanMinVerticesCount = 1000;
+
+bool CountDrifted(int64_t planned, int64_t current, double ratio) {
+  const auto lhs = static_cast<double>(std::max(planned, kReplanMinVerticesCount));
+  const auto rhs = static_cast<double>(std::max(current, kReplanMinVerticesCount));
+  return std::max(lhs, rhs) > ratio * std::min(lhs, rhs);
+}
 
+/// Returns the literals stripped from the query together with the values of
+/// the query parameters.
+Parameters MakeParameters(const frontend::StrippedQuery &stripped_query,
+                          const std::map<std::string, storage::PropertyValue> &params) {
   // Copy over the parameters that were introduced during stripping.
   Parameters parameters{stripped_query.literals()};
 
@@ -41,6 +64,78 @@ ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::stri
 
     parameters.Add(param_pair.first, it->second);
   }
+  return parameters;
+}
+
+/// Copies the query's AST into `ast_storage`.
+Query *CopyAst(const AstStorage &source, Query *query, AstStorage *ast_storage) {
+  ast_storage->properties_ = source.properties_;
+  ast_storage->labels_ = source.labels_;
+  ast_storage->edge_types_ = source.edge_types_;
+  return query->Clone(ast_storage);
+}
+}  // namespace
+
+CachedPlan::CachedPlan(std::unique_ptr<LogicalPlan> plan) : plan_(std::move(plan)) {}
+
+void CachedPlan::CollectDependencies(DbAccessor *db_accessor) {
+  const auto &ast_storage = plan_->GetAstStorage();
+  for (const auto &label_name : ast_storage.labels_) {
+    labels_.insert(db_accessor->NameToLabel(label_name));
+  }
+  for (const auto &property_name : ast_storage.properties_) {
+    properties_.insert(db_accessor->NameToProperty(property_name));
+  }
+  vertices_count_ = db_accessor->VerticesCount();
+  for (const auto label : labels_) {
+    if (db_accessor->LabelIndexExists(label)) {
+      label_vertices_counts_.emplace_back(label, db_accessor->VerticesCount(label));
+    }
+  }
+}
+
+bool CachedPlan::DependsOn(storage::LabelId label, std::optional<storage::PropertyId> property) const {
+  return labels_.contains(label) && (!property || properties_.contains(*property));
+}
+
+bool CachedPlan::IsStale(const DbAccessor &db_accessor) const {
+  const auto ratio = FLAGS_query_plan_cache_replan_ratio;
+  if (ratio == 0) return false;
+  if (CountDrifted(vertices_count_, db_accessor.VerticesCount(), ratio)) return true;
+  return std::any_of(label_vertices_counts_.begin(), label_vertices_counts_.end(), [&](const auto &label_count) {
+    return db_accessor.LabelIndexExists(label_count.first) &&
+           CountDrifted(label_count.second, db_accessor.VerticesCount(label_count.first), ratio);
+  });
+}
+
+void InvalidatePlanCache(utils::SkipList<PlanCacheEntry> *plan_cache, storage::LabelId label,
+                         std::optional<storage::PropertyId> property) {
+  auto access = plan_cache->access();
+  for (auto &kv : access) {
+    if (kv.second->DependsOn(label, property)) {
+      kv.second->Invalidate();
+      access.remove(kv.first);
+    }
+  }
+}
+
+void InvalidatePlanCache(utils::SkipList<PlanCacheEntry> *plan_cache) {
+  auto access = plan_cache->access();
+  for (auto &kv : access) {
+    kv.second->Invalidate();
+    access.remove(kv.first);
+  }
+}
+
+ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::string, storage::PropertyValue> &params,
+                       utils::SkipList<QueryCacheEntry> *cache, const InterpreterConfig::Query &query_config) {
+  // Strip the query for caching purposes. The process of stripping a query
+  // "normalizes" it by replacing any literals with new parameters. This
+  // results in just the *structure* of the query being taken into account for
+  // caching.
+  frontend::StrippedQuery stripped_query{query_string};
+
+  auto parameters = MakeParameters(stripped_query, params);
 
   // Cache the query's AST if it isn't already.
   auto hash = stripped_query.hash();
@@ -53,54 +148,57 @@ ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::stri
   bool is_cacheable = true;
 
   auto get_information_from_cache = [&](const auto &cached_query) {
-    result.ast_storage.properties_ = cached_query.ast_storage.properties_;
-    result.ast_storage.labels_ = cached_query.ast_storage.labels_;
-    result.ast_storage.edge_types_ = cached_query.ast_storage.edge_types_;
-
-    result.query = cached_query.query->Clone(&result.ast_storage);
+    result.query = CopyAst(cached_query.ast_storage, cached_query.query, &result.ast_storage);
     result.required_privileges = cached_query.required_privileges;
   };
 
   if (it == accessor.end()) {
-    try {
-      parser = std::make_unique<frontend::opencypher::Parser>(stripped_query.query());
-    } catch (const SyntaxException &e) {
-      // There is a syntax exception in the stripped query. Re-run the parser
-      // on the original query to get an appropriate error messsage.
-      parser = std::make_unique<frontend::opencypher::Parser>(query_string);
-
-      // If an exception was not thrown here, the stripper messed something
-      // up.
-      LOG_FATAL("The stripped query can't be parsed, but the original can.");
-    }
-
-    // Convert the ANTLR4 parse tree into an AST.
     AstStorage ast_storage;
-    frontend::ParsingContext context{true};
-    frontend::CypherMainVisitor visitor(context, &ast_storage);
+    frontend::CypherMainVisitor::QueryInfo query_info;
+    // Simple queries are parsed without ANTLR, which is the bulk of the cost
+    // of a cache miss.
+    Query *query = frontend::ParseSimpleQuery(stripped_query.query(), &ast_storage);
+    if (!query) {
+      try {
+        parser = std::make_unique<frontend::opencypher::Parser>(stripped_query.query());
+      } catch (const SyntaxException &e) {
+        // There is a syntax exception in the stripped query. Re-run the parser
+        // on the original query to get an appropriate error messsage.
+        parser = std::make_unique<frontend::opencypher::Parser>(query_string);
+
+        // If an exception was not thrown here, the stripper messed something
+        // up.
+        LOG_FATAL("The stripped query can't be parsed, but the original can.");
+      }
+
+      // Convert the ANTLR4 parse tree into an AST.
+      ast_storage = AstStorage();
+      frontend::ParsingContext context{true};
+      frontend::CypherMainVisitor visitor(context, &ast_storage);
 
-    visitor.visit(parser->tree());
+      visitor.visit(parser->tree());
+      query = visitor.query();
+      query_info = visitor.GetQueryInfo();
+    }
 
-    if (visitor.GetQueryInfo().has_load_csv && !query_config.allow_load_csv) {
+    if (query_info.has_load_csv && !query_config.allow_load_csv) {
       throw utils::BasicException("Load CSV not allowed on this instance because it was disabled by a config.");
     }
 
-    if (visitor.GetQueryInfo().is_cacheable) {
-      CachedQuery cached_query{std::move(ast_storage), visitor.query(), query::GetRequiredPrivileges(visitor.query())};
+    if (query_info.is_cacheable) {
+      CachedQuery cached_query{std::move(ast_storage), query, query::GetRequiredPrivileges(query)};
       it = accessor.insert({hash, std::move(cached_query)}).first;
 
       get_information_from_cache(it->second);
+      EvictLeastRecentlyUsed<QueryCacheEntry>(&accessor, FLAGS_query_ast_cache_max_entries);
     } else {
-      result.ast_storage.properties_ = ast_storage.properties_;
-      result.ast_storage.labels_ = ast_storage.labels_;
-      result.ast_storage.edge_types_ = ast_storage.edge_types_;
-
-      result.query = visitor.query()->Clone(&result.ast_storage);
-      result.required_privileges = query::GetRequiredPrivileges(visitor.query());
+      result.query = CopyAst(ast_storage, query, &result.ast_storage);
+      result.required_privileges = query::GetRequiredPrivileges(query);
 
       is_cacheable = false;
     }
   } else {
+    it->usage().Hit();
     get_information_from_cache(it->second);
   }
 
@@ -114,6 +212,27 @@ ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::stri
                      is_cacheable};
 }
 
+PreparedStatement::PreparedStatement(const ParsedQuery &parsed_query)
+    : query_string_(parsed_query.query_string),
+      stripped_query_(parsed_query.stripped_query.Clone()),
+      query_(CopyAst(parsed_query.ast_storage, parsed_query.query, &ast_storage_)),
+      required_privileges_(parsed_query.required_privileges),
+      is_cacheable_(parsed_query.is_cacheable) {}
+
+ParsedQuery PreparedStatement::Parse(const std::map<std::string, storage::PropertyValue> &params) const {
+  auto parameters = MakeParameters(stripped_query_, params);
+  AstStorage ast_storage;
+  auto *query = CopyAst(ast_storage_, query_, &ast_storage);
+  return ParsedQuery{query_string_,
+                     params,
+                     std::move(parameters),
+                     stripped_query_.Clone(),
+                     std::move(ast_storage),
+                     query,
+                     required_privileges_,
+                     is_cacheable_};
+}
+
 std::unique_ptr<LogicalPlan> MakeLogicalPlan(AstStorage ast_storage, CypherQuery *query, const Parameters &parameters,
                                              DbAccessor *db_accessor,
                                              const std::vector<Identifier *> &predefined_identifiers) {
@@ -128,25 +247,51 @@ std::unique_ptr<LogicalPlan> MakeLogicalPlan(AstStorage ast_storage, CypherQuery
 std::shared_ptr<CachedPlan> CypherQueryToPlan(uint64_t hash, AstStorage ast_storage, CypherQuery *query,
                                               const Parameters &parameters, utils::SkipList<PlanCacheEntry> *plan_cache,
                                               DbAccessor *db_accessor,
-                                              const std::vector<Identifier *> &predefined_identifiers) {
+                                              const std::vector<Identifier *> &predefined_identifiers,
+                                              std::optional<bool> *plan_cache_hit) {
   std::optional<utils::SkipList<PlanCacheEntry>::Accessor> plan_cache_access;
   if (plan_cache) {
     plan_cache_access.emplace(plan_cache->access());
     auto it = plan_cache_access->find(hash);
     if (it != plan_cache_access->end()) {
-      if (it->second->IsExpired()) {
+      if (it->second->IsExpired() || it->second->IsStale(*db_accessor)) {
+        it->second->Invalidate();
         plan_cache_access->remove(hash);
       } else {
+        it->usage().Hit();
+        if (plan_cache_hit) *plan_cache_hit = true;
         return it->second;
       }
     }
+    if (plan_cache_hit) *plan_cache_hit = false;
   }
 
   auto plan = std::make_shared<CachedPlan>(
       MakeLogicalPlan(std::move(ast_storage), query, parameters, db_accessor, predefined_identifiers));
   if (plan_cache_access) {
-    plan_cache_access->insert({hash, plan});
+    plan->CollectDependencies(db_accessor);
+    // Another session may have cached the same query in the meantime. Its plan
+    // is used instead, because only the cached plan is invalidated when an
+    // index changes and prepared statements may keep the returned plan.
+    plan = plan_cache_access->insert({hash, plan}).first->second;
+    EvictLeastRecentlyUsed<PlanCacheEntry>(&*plan_cache_access, FLAGS_query_plan_cache_max_entries);
   }
   return plan;
 }
+
+bool HasCallInTransactions(const CypherQuery &cypher_query) {
+  auto has_call_in_transactions = [](const SingleQuery *single_query) {
+    const auto &clauses = single_query->clauses_;
+    return std::any_of(clauses.begin(), clauses.end(), [](auto *clause) {
+      const auto *call_subquery = utils::Downcast<CallSubquery>(clause);
+      return call_subquery && call_subquery->in_transactions_;
+    });
+  };
+  const auto &cypher_unions = cypher_query.cypher_unions_;
+  return has_call_in_transactions(cypher_query.single_query_) ||
+         std::any_of(cypher_unions.begin(), cypher_unions.end(), [&](const auto *cypher_union) {
+           return has_call_in_transactions(cypher_union->single_query_);
+         });
+}
+
 }  // namespace memgraph::query
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,11 +11,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <type_traits>
+
 #include "query/config.hpp"
 #include "query/frontend/ast/cypher_main_visitor.hpp"
 #include "query/frontend/opencypher/parser.hpp"
 #include "query/frontend/semantic/required_privileges.hpp"
 #include "query/frontend/semantic/symbol_generator.hpp"
+#include "query/frontend/simple_query_parser.hpp"
 #include "query/frontend/stripped.hpp"
 #include "query/plan/planner.hpp"
 #include "utils/flag_validation.hpp"
@@ -25,6 +32,12 @@
 DECLARE_bool(query_cost_planner);
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DECLARE_int32(query_plan_cache_ttl);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_int32(query_plan_cache_max_entries);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_int32(query_ast_cache_max_entries);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_double(query_plan_cache_replan_ratio);
 
 namespace memgraph::query {
 
@@ -47,6 +60,36 @@ class LogicalPlan {
   virtual const AstStorage &GetAstStorage() const = 0;
 };
 
+/// Number of hits and the time of the last use of a cache entry. The counters
+/// are updated concurrently by all the interpreters which hit the entry.
+/// Copying takes a snapshot, so the entries holding the usage can still be
+/// moved into a skip list.
+class CacheEntryUsage {
+ public:
+  CacheEntryUsage() = default;
+  CacheEntryUsage(const CacheEntryUsage &other) : hits_(other.hits()), last_used_(other.last_used_ns()) {}
+  CacheEntryUsage &operator=(const CacheEntryUsage &other) {
+    hits_.store(other.hits(), std::memory_order_relaxed);
+    last_used_.store(other.last_used_ns(), std::memory_order_relaxed);
+    return *this;
+  }
+
+  void Hit() const {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    last_used_.store(Now(), std::memory_order_relaxed);
+  }
+
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  int64_t last_used_ns() const { return last_used_.load(std::memory_order_relaxed); }
+  std::chrono::nanoseconds IdleTime() const { return std::chrono::nanoseconds(Now() - last_used_ns()); }
+
+ private:
+  static int64_t Now() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+  mutable std::atomic<uint64_t> hits_{0};
+  mutable std::atomic<int64_t> last_used_{Now()};
+};
+
 class CachedPlan {
  public:
   explicit CachedPlan(std::unique_ptr<LogicalPlan> plan);
@@ -55,15 +98,42 @@ class CachedPlan {
   double cost() const { return plan_->GetCost(); }
   const auto &symbol_table() const { return plan_->GetSymbolTable(); }
   const auto &ast_storage() const { return plan_->GetAstStorage(); }
+  const auto &usage() const { return usage_; }
+  const auto &labels() const { return labels_; }
+  const auto &properties() const { return properties_; }
+
+  /// A plan expires when it isn't used for `--query_plan_cache_ttl` seconds.
+  bool IsExpired() const { return usage_.IdleTime() > std::chrono::seconds(FLAGS_query_plan_cache_ttl); }
 
-  bool IsExpired() const {
-    // NOLINTNEXTLINE (modernize-use-nullptr)
-    return cache_timer_.Elapsed() > std::chrono::seconds(FLAGS_query_plan_cache_ttl);
-  };
+  /// Remembers the labels and properties the plan uses, together with the
+  /// vertex counts the plan was costed with. Should be called before the plan
+  /// is shared through the cache.
+  void CollectDependencies(DbAccessor *db_accessor);
+
+  /// Whether the plan uses the label and, if given, the property. Index
+  /// changes only invalidate the plans which depend on the index.
+  bool DependsOn(storage::LabelId label, std::optional<storage::PropertyId> property = std::nullopt) const;
+
+  /// Whether the vertex counts changed more than `--query_plan_cache_replan_ratio`
+  /// times since the plan was made, so a different plan might be cheaper.
+  bool IsStale(const DbAccessor &db_accessor) const;
+
+  /// Marks that the plan was removed from the plan cache, so those who hold
+  /// it outside of the cache must plan the query again. Only the cache knows
+  /// when an index or a constraint change makes the plan invalid.
+  void Invalidate() const { invalidated_.store(true, std::memory_order_release); }
+  bool IsInvalidated() const { return invalidated_.load(std::memory_order_acquire); }
 
  private:
   std::unique_ptr<LogicalPlan> plan_;
-  utils::Timer cache_timer_;
+  CacheEntryUsage usage_;
+  mutable std::atomic<bool> invalidated_{false};
+  std::set<storage::LabelId> labels_;
+  std::set<storage::PropertyId> properties_;
+  int64_t vertices_count_{0};
+  // Vertex counts of the used labels which have a label index, others can't
+  // be counted cheaply.
+  std::vector<std::pair<storage::LabelId, int64_t>> label_vertices_counts_;
 };
 
 struct CachedQuery {
@@ -78,10 +148,13 @@ struct QueryCacheEntry {
   bool operator==(const uint64_t &other) const { return first == other; }
   bool operator<(const uint64_t &other) const { return first < other; }
 
+  const CacheEntryUsage &usage() const { return usage_; }
+
   uint64_t first;
   // TODO: Maybe store the query string here and use it as a key with the hash
   // so that we eliminate the risk of hash collisions.
   CachedQuery second;
+  CacheEntryUsage usage_{};
 };
 
 struct PlanCacheEntry {
@@ -90,12 +163,46 @@ struct PlanCacheEntry {
   bool operator==(const uint64_t &other) const { return first == other; }
   bool operator<(const uint64_t &other) const { return first < other; }
 
+  const CacheEntryUsage &usage() const { return second->usage(); }
+
   uint64_t first;
   // TODO: Maybe store the query string here and use it as a key with the hash
   // so that we eliminate the risk of hash collisions.
   std::shared_ptr<CachedPlan> second;
 };
 
+/// Removes the least recently used entries when the cache holds more than
+/// `max_entries` entries, 0 means the cache is unbounded. An eighth of the
+/// entries is evicted at once, so a full cache isn't scanned on every insert.
+template <typename TEntry>
+void EvictLeastRecentlyUsed(typename utils::SkipList<TEntry>::Accessor *accessor, size_t max_entries) {
+  if (max_entries == 0 || accessor->size() <= max_entries) return;
+  std::vector<std::pair<int64_t, uint64_t>> last_used;
+  last_used.reserve(accessor->size());
+  for (const auto &entry : *accessor) {
+    last_used.emplace_back(entry.usage().last_used_ns(), entry.first);
+  }
+  const auto keep = max_entries - max_entries / 8;
+  if (last_used.size() <= keep) return;
+  const auto evict = last_used.size() - keep;
+  std::nth_element(last_used.begin(), last_used.begin() + static_cast<std::ptrdiff_t>(evict - 1), last_used.end());
+  for (size_t i = 0; i < evict; ++i) {
+    if constexpr (std::is_same_v<TEntry, PlanCacheEntry>) {
+      // Prepared statements may keep the plan only while it is cached.
+      if (auto it = accessor->find(last_used[i].second); it != accessor->end()) it->second->Invalidate();
+    }
+    accessor->remove(last_used[i].second);
+  }
+}
+
+/// Removes the cached plans which depend on the label and, if given, the
+/// property.
+void InvalidatePlanCache(utils::SkipList<PlanCacheEntry> *plan_cache, storage::LabelId label,
+                         std::optional<storage::PropertyId> property = std::nullopt);
+
+/// Removes all the cached plans.
+void InvalidatePlanCache(utils::SkipList<PlanCacheEntry> *plan_cache);
+
 /**
  * A container for data related to the parsing of a query.
  */
@@ -113,6 +220,42 @@ struct ParsedQuery {
 ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::string, storage::PropertyValue> &params,
                        utils::SkipList<QueryCacheEntry> *cache, const InterpreterConfig::Query &query_config);
 
+/**
+ * A query kept by a session, so that executing it again doesn't strip, hash
+ * and look it up in the AST cache. The plan of a Cypher query is kept too,
+ * until it is invalidated or becomes stale.
+ */
+class PreparedStatement {
+ public:
+  explicit PreparedStatement(const ParsedQuery &parsed_query);
+
+  PreparedStatement(const PreparedStatement &) = delete;
+  PreparedStatement &operator=(const PreparedStatement &) = delete;
+  PreparedStatement(PreparedStatement &&) = default;
+  PreparedStatement &operator=(PreparedStatement &&) = default;
+  ~PreparedStatement() = default;
+
+  /**
+   * Makes a parsed query for executing the statement with `params`.
+   * @throw query::UnprovidedParameterError
+   */
+  ParsedQuery Parse(const std::map<std::string, storage::PropertyValue> &params) const;
+
+  const std::string &query_string() const { return query_string_; }
+
+  /// The plan of the last execution, null if it wasn't planned yet or if the
+  /// plan can't be kept.
+  std::shared_ptr<CachedPlan> plan;
+
+ private:
+  std::string query_string_;
+  frontend::StrippedQuery stripped_query_;
+  AstStorage ast_storage_;
+  Query *query_;
+  std::vector<AuthQuery::Privilege> required_privileges_;
+  bool is_cacheable_;
+};
+
 class SingleNodeLogicalPlan final : public LogicalPlan {
  public:
   SingleNodeLogicalPlan(std::unique_ptr<plan::LogicalOperator> root, double cost, AstStorage storage,
@@ -142,10 +285,16 @@ std::unique_ptr<LogicalPlan> MakeLogicalPlan(AstStorage ast_storage, CypherQuery
  * If an identifier is not defined in a scope, we check the predefined identifiers.
  * If an identifier is contained there, we inject it at that place and remove it,
  * because a predefined identifier can be used only in one scope.
+ * @param plan_cache_hit if given, it's set to whether the plan was found in the
+ * plan cache when the plan cache is used.
  */
 std::shared_ptr<CachedPlan> CypherQueryToPlan(uint64_t hash, AstStorage ast_storage, CypherQuery *query,
                                               const Parameters &parameters, utils::SkipList<PlanCacheEntry> *plan_cache,
                                               DbAccessor *db_accessor,
-                                              const std::vector<Identifier *> &predefined_identifiers = {});
+                                              const std::vector<Identifier *> &predefined_identifiers = {},
+                                              std::optional<bool> *plan_cache_hit = nullptr);
+
+/// Returns true if the query commits while running, in `CALL { ... } IN TRANSACTIONS`.
+bool HasCallInTransactions(const CypherQuery &cypher_query);
 
 }  // namespace memgraph::query
@@ -71,6 +71,10 @@ class EdgeAccessor final {
     return impl_.SetProperty(key, value);
   }
 
+  storage::Result<bool> InitProperties(const std::map<storage::PropertyId, storage::PropertyValue> &properties) {
+    return impl_.InitProperties(properties);
+  }
+
   storage::Result<storage::PropertyValue> RemoveProperty(storage::PropertyId key) {
     return SetProperty(key, storage::PropertyValue());
   }
@@ -125,6 +129,10 @@ class VertexAccessor final {
     return impl_.SetProperty(key, value);
   }
 
+  storage::Result<bool> InitProperties(const std::map<storage::PropertyId, storage::PropertyValue> &properties) {
+    return impl_.InitProperties(properties);
+  }
+
   storage::Result<storage::PropertyValue> RemoveProperty(storage::PropertyId key) {
     return SetProperty(key, storage::PropertyValue());
   }
@@ -337,8 +345,18 @@ class DbAccessor final {
     return VerticesIterable(accessor_->Vertices(label, property, lower, upper, view));
   }
 
+  storage::Result<void> LockKey(storage::LabelId label, storage::PropertyId property,
+                                const storage::PropertyValue &value, const std::function<bool()> &must_abort = {}) {
+    return accessor_->LockKey(label, property, value, must_abort);
+  }
+
   VertexAccessor InsertVertex() { return VertexAccessor(accessor_->CreateVertex()); }
 
+  std::vector<VertexAccessor> InsertVertices(uint64_t count) {
+    auto vertices = accessor_->CreateVertices(count);
+    return {vertices.begin(), vertices.end()};
+  }
+
   storage::Result<EdgeAccessor> InsertEdge(VertexAccessor *from, VertexAccessor *to,
                                            const storage::EdgeTypeId &edge_type) {
     auto maybe_edge = accessor_->CreateEdge(&from->impl_, &to->impl_, edge_type);
@@ -414,6 +432,10 @@ class DbAccessor final {
 
   utils::BasicResult<storage::StorageDataManipulationError, void> Commit() { return accessor_->Commit(); }
 
+  utils::BasicResult<storage::StorageDataManipulationError, void> PeriodicCommit() {
+    return accessor_->PeriodicCommit();
+  }
+
   void Abort() { accessor_->Abort(); }
 
   bool LabelIndexExists(storage::LabelId label) const { return accessor_->LabelIndexExists(label); }
@@ -441,9 +463,29 @@ class DbAccessor final {
     return accessor_->ApproximateVertexCount(label, property, lower, upper);
   }
 
+  int64_t ExactVerticesCount(storage::View view, storage::LabelId label) { return accessor_->VertexCount(label, view); }
+
+  int64_t ExactVerticesCount(storage::View view, storage::LabelId label, storage::PropertyId property) {
+    return accessor_->VertexCount(label, property, view);
+  }
+
+  storage::PropertyValue MinPropertyValue(storage::View view, storage::LabelId label, storage::PropertyId property) {
+    return accessor_->MinPropertyValue(label, property, view);
+  }
+
+  storage::PropertyValue MaxPropertyValue(storage::View view, storage::LabelId label, storage::PropertyId property) {
+    return accessor_->MaxPropertyValue(label, property, view);
+  }
+
   storage::IndicesInfo ListAllIndices() const { return accessor_->ListAllIndices(); }
 
   storage::ConstraintsInfo ListAllConstraints() const { return accessor_->ListAllConstraints(); }
+
+  std::shared_ptr<const storage::GraphStatistics> AnalyzeGraph() { return accessor_->AnalyzeGraph(); }
+
+  std::shared_ptr<const storage::GraphStatistics> GetGraphStatistics() const {
+    return accessor_->GetGraphStatistics();
+  }
 };
 
 class SubgraphDbAccessor final {
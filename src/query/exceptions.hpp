@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -125,6 +125,26 @@ class HintedAbortError : public utils::BasicException {
             "--query-execution-timeout-sec flag.") {}
 };
 
+class AdmissionTimeoutException : public HintedAbortError {
+ public:
+  explicit AdmissionTimeoutException(const std::string_view pool)
+      : HintedAbortError(
+            "Query wasn't admitted into the resource pool '{}' within the time specified by "
+            "--query-admission-timeout-sec or --query-execution-timeout-sec flag, because the pool is running its "
+            "maximum number of queries.",
+            pool) {}
+};
+
+/**
+ * Thrown instead of waiting when a query can't be admitted into its resource
+ * pool yet, see `Interpreter::SetNonBlockingAdmission`. It isn't an error,
+ * the query is prepared again once it can be admitted.
+ */
+class AdmissionPendingException : public utils::BasicException {
+ public:
+  AdmissionPendingException() : utils::BasicException("Query is waiting for admission into its resource pool.") {}
+};
+
 class ExplicitTransactionUsageException : public QueryRuntimeException {
  public:
   using QueryRuntimeException::QueryRuntimeException;
@@ -230,6 +250,18 @@ class VersionInfoInMulticommandTxException : public QueryException {
       : QueryException("Version info query not allowed in multicommand transactions.") {}
 };
 
+class AnalyzeGraphInMulticommandTxException : public QueryException {
+ public:
+  AnalyzeGraphInMulticommandTxException()
+      : QueryException("Analyze graph query not allowed in multicommand transactions.") {}
+};
+
+class CallInTransactionsInMulticommandTxException : public QueryException {
+ public:
+  CallInTransactionsInMulticommandTxException()
+      : QueryException("CALL subqueries IN TRANSACTIONS not allowed in multicommand transactions.") {}
+};
+
 class ReplicationException : public utils::BasicException {
  public:
   using utils::BasicException::BasicException;
@@ -82,6 +82,7 @@ class IndexQuery;
 class InfoQuery;
 class ConstraintQuery;
 class RegexMatch;
+class Exists;
 class DumpQuery;
 class ReplicationQuery;
 class LockPathQuery;
@@ -94,7 +95,9 @@ class StreamQuery;
 class SettingQuery;
 class VersionQuery;
 class Foreach;
+class CallSubquery;
 class ShowConfigQuery;
+class AnalyzeGraphQuery;
 
 using TreeCompositeVisitor = utils::CompositeVisitor<
     SingleQuery, CypherUnion, NamedExpression, OrOperator, XorOperator, AndOperator, NotOperator, AdditionOperator,
@@ -103,7 +106,7 @@ using TreeCompositeVisitor = utils::CompositeVisitor<
     ListSlicingOperator, IfOperator, UnaryPlusOperator, UnaryMinusOperator, IsNullOperator, ListLiteral, MapLiteral,
     PropertyLookup, LabelsTest, Aggregation, Function, Reduce, Coalesce, Extract, All, Single, Any, None, CallProcedure,
     Create, Match, Return, With, Pattern, NodeAtom, EdgeAtom, Delete, Where, SetProperty, SetProperties, SetLabels,
-    RemoveProperty, RemoveLabels, Merge, Unwind, RegexMatch, LoadCsv, Foreach>;
+    RemoveProperty, RemoveLabels, Merge, Unwind, RegexMatch, Exists, LoadCsv, Foreach, CallSubquery>;
 
 using TreeLeafVisitor = utils::LeafVisitor<Identifier, PrimitiveLiteral, ParameterLookup>;
 
@@ -123,12 +126,13 @@ class ExpressionVisitor
           LessOperator, GreaterOperator, LessEqualOperator, GreaterEqualOperator, InListOperator, SubscriptOperator,
           ListSlicingOperator, IfOperator, UnaryPlusOperator, UnaryMinusOperator, IsNullOperator, ListLiteral,
           MapLiteral, PropertyLookup, LabelsTest, Aggregation, Function, Reduce, Coalesce, Extract, All, Single, Any,
-          None, ParameterLookup, Identifier, PrimitiveLiteral, RegexMatch> {};
+          None, ParameterLookup, Identifier, PrimitiveLiteral, RegexMatch, Exists> {};
 
 template <class TResult>
 class QueryVisitor : public utils::Visitor<TResult, CypherQuery, ExplainQuery, ProfileQuery, IndexQuery, AuthQuery,
                                            InfoQuery, ConstraintQuery, DumpQuery, ReplicationQuery, LockPathQuery,
                                            FreeMemoryQuery, TriggerQuery, IsolationLevelQuery, CreateSnapshotQuery,
-                                           StreamQuery, SettingQuery, VersionQuery, ShowConfigQuery> {};
+                                           StreamQuery, SettingQuery, VersionQuery, ShowConfigQuery,
+                                           AnalyzeGraphQuery> {};
 
 }  // namespace memgraph::query
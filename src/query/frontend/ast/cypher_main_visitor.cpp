@@ -122,6 +122,15 @@ antlrcpp::Any CypherMainVisitor::visitInfoQuery(MemgraphCypher::InfoQueryContext
   } else if (ctx->constraintInfo()) {
     info_query->info_type_ = InfoQuery::InfoType::CONSTRAINT;
     return info_query;
+  } else if (ctx->planCacheInfo()) {
+    info_query->info_type_ = InfoQuery::InfoType::PLAN_CACHE;
+    return info_query;
+  } else if (ctx->queryStatisticsInfo()) {
+    info_query->info_type_ = InfoQuery::InfoType::QUERY_STATISTICS;
+    return info_query;
+  } else if (ctx->resourcePoolsInfo()) {
+    info_query->info_type_ = InfoQuery::InfoType::RESOURCE_POOLS;
+    return info_query;
   } else {
     throw utils::NotYetImplemented("Info query: '{}'", ctx->getText());
   }
@@ -977,6 +986,17 @@ antlrcpp::Any CypherMainVisitor::visitSingleQuery(MemgraphCypher::SingleQueryCon
       check_write_procedure("Update clause");
       has_update = true;
       has_any_update = true;
+    } else if (const auto *call_subquery = utils::Downcast<CallSubquery>(clause); call_subquery != nullptr) {
+      if (has_return) {
+        throw SemanticException("CALL can't be put after RETURN clause.");
+      }
+      check_write_procedure("CALL");
+      // A subquery without RETURN is only run for its updates, so it counts
+      // as an update clause of the outer query.
+      if (!utils::IsSubtype(*call_subquery->single_query_->clauses_.back(), Return::kType)) {
+        has_update = true;
+        has_any_update = true;
+      }
     } else if (utils::IsSubtype(clause_type, Return::kType)) {
       if (has_return) {
         throw SemanticException("There can only be one RETURN in a clause.");
@@ -1053,6 +1073,9 @@ antlrcpp::Any CypherMainVisitor::visitClause(MemgraphCypher::ClauseContext *ctx)
   if (ctx->foreach ()) {
     return static_cast<Clause *>(std::any_cast<Foreach *>(ctx->foreach ()->accept(this)));
   }
+  if (ctx->callSubquery()) {
+    return static_cast<Clause *>(std::any_cast<CallSubquery *>(ctx->callSubquery()->accept(this)));
+  }
   // TODO: implement other clauses.
   throw utils::NotYetImplemented("clause '{}'", ctx->getText());
   return 0;
@@ -1698,6 +1721,18 @@ antlrcpp::Any CypherMainVisitor::visitPatternElement(MemgraphCypher::PatternElem
   return pattern;
 }
 
+antlrcpp::Any CypherMainVisitor::visitRelationshipsPattern(MemgraphCypher::RelationshipsPatternContext *ctx) {
+  auto *pattern = storage_->Create<Pattern>();
+  anonymous_identifiers.push_back(&pattern->identifier_);
+  pattern->atoms_.push_back(std::any_cast<NodeAtom *>(ctx->nodePattern()->accept(this)));
+  for (auto *pattern_element_chain : ctx->patternElementChain()) {
+    auto element = std::any_cast<std::pair<PatternAtom *, PatternAtom *>>(pattern_element_chain->accept(this));
+    pattern->atoms_.push_back(element.first);
+    pattern->atoms_.push_back(element.second);
+  }
+  return pattern;
+}
+
 antlrcpp::Any CypherMainVisitor::visitPatternElementChain(MemgraphCypher::PatternElementChainContext *ctx) {
   return std::pair<PatternAtom *, PatternAtom *>(std::any_cast<EdgeAtom *>(ctx->relationshipPattern()->accept(this)),
                                                  std::any_cast<NodeAtom *>(ctx->nodePattern()->accept(this)));
@@ -1801,6 +1836,16 @@ antlrcpp::Any CypherMainVisitor::visitRelationshipPattern(MemgraphCypher::Relati
         visit_total_weight();
         edge->filter_lambda_ = visit_lambda(relationshipLambdas[1]);
         break;
+      case 3:
+        // The third lambda is the A* heuristic, it estimates the remaining
+        // weight from the traversed node to the destination.
+        if (edge->type_ != EdgeAtom::Type::WEIGHTED_SHORTEST_PATH)
+          throw SemanticException("Heuristic lambda is allowed only with weighted shortest path expansion.");
+        edge->weight_lambda_ = visit_lambda(relationshipLambdas[0]);
+        visit_total_weight();
+        edge->filter_lambda_ = visit_lambda(relationshipLambdas[1]);
+        edge->heuristic_lambda_ = visit_lambda(relationshipLambdas[2]);
+        break;
       default:
         throw SemanticException("Only one filter lambda can be supplied.");
     }
@@ -2160,6 +2205,9 @@ antlrcpp::Any CypherMainVisitor::visitAtom(MemgraphCypher::AtomContext *ctx) {
     auto *list = std::any_cast<Expression *>(ctx->extractExpression()->idInColl()->expression()->accept(this));
     auto *expr = std::any_cast<Expression *>(ctx->extractExpression()->expression()->accept(this));
     return static_cast<Expression *>(storage_->Create<Extract>(ident, list, expr));
+  } else if (ctx->relationshipsPattern()) {
+    auto *pattern = std::any_cast<Pattern *>(ctx->relationshipsPattern()->accept(this));
+    return static_cast<Expression *>(storage_->Create<Exists>(pattern));
   }
   // TODO: Implement this. We don't support comprehensions, filtering... at
   // the moment.
@@ -2493,11 +2541,37 @@ antlrcpp::Any CypherMainVisitor::visitForeach(MemgraphCypher::ForeachContext *ct
   return for_each;
 }
 
+antlrcpp::Any CypherMainVisitor::visitCallSubquery(MemgraphCypher::CallSubqueryContext *ctx) {
+  auto *call_subquery = storage_->Create<CallSubquery>();
+  call_subquery->single_query_ = std::any_cast<SingleQuery *>(ctx->singleQuery()->accept(this));
+  for (auto *clause : call_subquery->single_query_->clauses_) {
+    if (const auto *nested = utils::Downcast<CallSubquery>(clause); nested && nested->in_transactions_) {
+      // The transaction of the outer subquery can't be committed halfway.
+      throw SemanticException("CALL subqueries IN TRANSACTIONS can't be nested in other CALL subqueries.");
+    }
+  }
+  if (auto *in_transactions_ctx = ctx->inTransactions()) {
+    call_subquery->in_transactions_ = true;
+    if (in_transactions_ctx->literal()) {
+      call_subquery->batch_size_ = std::any_cast<Expression *>(in_transactions_ctx->literal()->accept(this));
+    }
+  }
+  return call_subquery;
+}
+
 antlrcpp::Any CypherMainVisitor::visitShowConfigQuery(MemgraphCypher::ShowConfigQueryContext * /*ctx*/) {
   query_ = storage_->Create<ShowConfigQuery>();
   return query_;
 }
 
+antlrcpp::Any CypherMainVisitor::visitAnalyzeGraphQuery(MemgraphCypher::AnalyzeGraphQueryContext *ctx) {
+  auto *analyze_graph_query = storage_->Create<AnalyzeGraphQuery>();
+  analyze_graph_query->action_ =
+      ctx->DELETE() ? AnalyzeGraphQuery::Action::DELETE_STATISTICS : AnalyzeGraphQuery::Action::ANALYZE;
+  query_ = analyze_graph_query;
+  return query_;
+}
+
 LabelIx CypherMainVisitor::AddLabel(const std::string &name) { return storage_->GetLabelIx(name); }
 
 PropertyIx CypherMainVisitor::AddProperty(const std::string &name) { return storage_->GetPropertyIx(name); }
@@ -70,6 +70,7 @@ class ExpressionPrettyPrinter : public ExpressionVisitor<void> {
   void Visit(ParameterLookup &op) override;
   void Visit(NamedExpression &op) override;
   void Visit(RegexMatch &op) override;
+  void Visit(Exists &op) override;
 
  private:
   std::ostream *out_;
@@ -296,6 +297,13 @@ void ExpressionPrettyPrinter::Visit(NamedExpression &op) {
 
 void ExpressionPrettyPrinter::Visit(RegexMatch &op) { PrintOperator(out_, "=~", op.string_expr_, op.regex_); }
 
+void ExpressionPrettyPrinter::Visit(Exists &op) {
+  std::vector<Identifier *> identifiers;
+  identifiers.reserve(op.pattern_->atoms_.size());
+  for (auto *atom : op.pattern_->atoms_) identifiers.push_back(atom->identifier_);
+  PrintOperator(out_, "Exists", identifiers);
+}
+
 }  // namespace
 
 void PrintExpression(Expression *expr, std::ostream *out) {
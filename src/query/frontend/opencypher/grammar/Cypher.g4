@@ -46,7 +46,13 @@ indexInfo : INDEX INFO ;
 
 constraintInfo : CONSTRAINT INFO ;
 
-infoQuery : SHOW ( storageInfo | indexInfo | constraintInfo ) ;
+planCacheInfo : PLAN CACHE ;
+
+queryStatisticsInfo : QUERY STATISTICS ;
+
+resourcePoolsInfo : RESOURCE POOLS ;
+
+infoQuery : SHOW ( storageInfo | indexInfo | constraintInfo | planCacheInfo | queryStatisticsInfo | resourcePoolsInfo ) ;
 
 explainQuery : EXPLAIN cypherQuery ;
 
@@ -167,7 +173,7 @@ rightArrowHead : '>' | RightArrowHeadPart ;
 dash : '-' | DashPart ;
 
 relationshipDetail : '[' ( name=variable )? ( relationshipTypes )? ( variableExpansion )?  properties ']'
-                   | '[' ( name=variable )? ( relationshipTypes )? ( variableExpansion )? relationshipLambda ( total_weight=variable )? (relationshipLambda )? ']'
+                   | '[' ( name=variable )? ( relationshipTypes )? ( variableExpansion )? relationshipLambda ( total_weight=variable )? (relationshipLambda )? (relationshipLambda )? ']'
                    | '[' ( name=variable )? ( relationshipTypes )? ( variableExpansion )? (properties )* ( relationshipLambda total_weight=variable )? (relationshipLambda )? ']';
 
 relationshipLambda: '(' traversed_edge=variable ',' traversed_node=variable '|' expression ')';
@@ -325,6 +331,7 @@ cypherKeyword : ALL
               | ASSERT
               | BFS
               | BY
+              | CACHE
               | CALL
               | CASE
               | CONSTRAINT
@@ -361,16 +368,20 @@ cypherKeyword : ALL
               | OPTIONAL
               | OR
               | ORDER
+              | PLAN
+              | POOLS
               | PROCEDURE
               | PROFILE
               | QUERY
               | REDUCE
               | REMOVE
+              | RESOURCE
               | RETURN
               | SET
               | SHOW
               | SINGLE
               | STARTS
+              | STATISTICS
               | STORAGE
               | THEN
               | TRUE
@@ -77,6 +77,7 @@ ASCENDING      : A S C E N D I N G ;
 ASSERT         : A S S E R T ;
 BFS            : B F S ;
 BY             : B Y ;
+CACHE          : C A C H E ;
 CALL           : C A L L ;
 CASE           : C A S E ;
 COALESCE       : C O A L E S C E ;
@@ -118,16 +119,20 @@ ON             : O N ;
 OPTIONAL       : O P T I O N A L ;
 OR             : O R ;
 ORDER          : O R D E R ;
+PLAN           : P L A N ;
+POOLS          : P O O L S ;
 PROCEDURE      : P R O C E D U R E ;
 PROFILE        : P R O F I L E ;
 QUERY          : Q U E R Y ;
 REDUCE         : R E D U C E ;
 REMOVE         : R E M O V E ;
+RESOURCE       : R E S O U R C E ;
 RETURN         : R E T U R N ;
 SET            : S E T ;
 SHOW           : S H O W ;
 SINGLE         : S I N G L E ;
 STARTS         : S T A R T S ;
+STATISTICS     : S T A T I S T I C S ;
 STORAGE        : S T O R A G E ;
 THEN           : T H E N ;
 TRUE           : T R U E ;
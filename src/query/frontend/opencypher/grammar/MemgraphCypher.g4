@@ -22,6 +22,7 @@ import Cypher ;
 memgraphCypherKeyword : cypherKeyword
                       | AFTER
                       | ALTER
+                      | ANALYZE
                       | ASYNC
                       | AUTH
                       | BAD
@@ -54,6 +55,7 @@ memgraphCypherKeyword : cypherKeyword
                       | FROM
                       | GLOBAL
                       | GRANT
+                      | GRAPH
                       | HEADER
                       | IDENTIFIED
                       | ISOLATION
@@ -67,6 +69,7 @@ memgraphCypherKeyword : cypherKeyword
                       | NEXT
                       | NO
                       | NOTHING
+                      | OF
                       | PASSWORD
                       | PULSAR
                       | PORT
@@ -79,6 +82,7 @@ memgraphCypherKeyword : cypherKeyword
                       | REVOKE
                       | ROLE
                       | ROLES
+                      | ROWS
                       | QUOTE
                       | SESSION
                       | SETTING
@@ -93,6 +97,7 @@ memgraphCypherKeyword : cypherKeyword
                       | TO
                       | TOPICS
                       | TRANSACTION
+                      | TRANSACTIONS
                       | TRANSFORM
                       | TRIGGER
                       | TRIGGERS
@@ -127,6 +132,7 @@ query : cypherQuery
       | settingQuery
       | versionQuery
       | showConfigQuery
+      | analyzeGraphQuery
       ;
 
 authQuery : createRole
@@ -170,6 +176,7 @@ clause : cypherMatch
        | callProcedure
        | loadCsv
        | foreach
+       | callSubquery
        ;
 
 updateClause : set
@@ -182,6 +189,10 @@ updateClause : set
 
 foreach :  FOREACH '(' variable IN expression '|' updateClause+  ')' ;
 
+callSubquery : CALL '{' singleQuery '}' ( inTransactions )? ;
+
+inTransactions : IN TRANSACTIONS ( OF literal ROWS )? ;
+
 streamQuery : checkStream
             | createStream
             | dropStream
@@ -402,3 +413,5 @@ showSettings : SHOW DATABASE SETTINGS ;
 showConfigQuery : SHOW CONFIG ;
 
 versionQuery : SHOW VERSION ;
+
+analyzeGraphQuery : ANALYZE GRAPH ( DELETE STATISTICS )? ;
@@ -27,6 +27,7 @@ UNDERSCORE : '_' ;
 
 AFTER               : A F T E R ;
 ALTER               : A L T E R ;
+ANALYZE             : A N A L Y Z E ;
 ASYNC               : A S Y N C ;
 AUTH                : A U T H ;
 BAD                 : B A D ;
@@ -62,6 +63,7 @@ FROM                : F R O M ;
 GLOBAL              : G L O B A L ;
 GRANT               : G R A N T ;
 GRANTS              : G R A N T S ;
+GRAPH               : G R A P H ;
 HEADER              : H E A D E R ;
 IDENTIFIED          : I D E N T I F I E D ;
 IGNORE              : I G N O R E ;
@@ -78,6 +80,7 @@ MODULE_WRITE        : M O D U L E UNDERSCORE W R I T E ;
 NEXT                : N E X T ;
 NO                  : N O ;
 NOTHING             : N O T H I N G ;
+OF                  : O F ;
 PASSWORD            : P A S S W O R D ;
 PORT                : P O R T ;
 PRIVILEGES          : P R I V I L E G E S ;
@@ -91,6 +94,7 @@ REPLICATION         : R E P L I C A T I O N ;
 REVOKE              : R E V O K E ;
 ROLE                : R O L E ;
 ROLES               : R O L E S ;
+ROWS                : R O W S ;
 QUOTE               : Q U O T E ;
 SERVICE_URL         : S E R V I C E UNDERSCORE U R L ;
 SESSION             : S E S S I O N ;
@@ -107,6 +111,7 @@ TIMEOUT             : T I M E O U T ;
 TO                  : T O ;
 TOPICS              : T O P I C S;
 TRANSACTION         : T R A N S A C T I O N ;
+TRANSACTIONS        : T R A N S A C T I O N S ;
 TRANSFORM           : T R A N S F O R M ;
 TRIGGER             : T R I G G E R ;
 TRIGGERS            : T R I G G E R S ;
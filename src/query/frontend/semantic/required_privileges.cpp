@@ -48,6 +48,11 @@ class PrivilegeExtractor : public QueryVisitor<void>, public HierarchicalTreeVis
         // for *or* with privileges.
         AddPrivilege(AuthQuery::Privilege::CONSTRAINT);
         break;
+      case InfoQuery::InfoType::PLAN_CACHE:
+      case InfoQuery::InfoType::QUERY_STATISTICS:
+      case InfoQuery::InfoType::RESOURCE_POOLS:
+        AddPrivilege(AuthQuery::Privilege::STATS);
+        break;
     }
   }
 
@@ -68,6 +73,8 @@ class PrivilegeExtractor : public QueryVisitor<void>, public HierarchicalTreeVis
 
   void Visit(ShowConfigQuery & /*show_config_query*/) override { AddPrivilege(AuthQuery::Privilege::CONFIG); }
 
+  void Visit(AnalyzeGraphQuery & /*analyze_graph_query*/) override { AddPrivilege(AuthQuery::Privilege::INDEX); }
+
   void Visit(TriggerQuery &trigger_query) override { AddPrivilege(AuthQuery::Privilege::TRIGGER); }
 
   void Visit(StreamQuery &stream_query) override { AddPrivilege(AuthQuery::Privilege::STREAM); }
@@ -19,6 +19,7 @@
 #include <optional>
 #include <ranges>
 #include <unordered_set>
+#include <utility>
 #include <variant>
 
 #include "query/frontend/ast/ast.hpp"
@@ -295,6 +296,39 @@ bool SymbolGenerator::PostVisit([[maybe_unused]] Foreach &for_each) {
   return true;
 }
 
+bool SymbolGenerator::PreVisit(CallSubquery &call_subquery) {
+  if (call_subquery.batch_size_) {
+    call_subquery.batch_size_->Accept(*this);
+  }
+  auto &clauses = call_subquery.single_query_->clauses_;
+  // The subquery sees only the variables imported by its leading WITH, so it
+  // gets its own scope. The leading WITH starts from the outer variables and
+  // then replaces them with the imported ones, like it does in the outer query.
+  Scope subquery_scope;
+  if (utils::IsSubtype(*clauses.front(), With::kType)) {
+    subquery_scope.symbols = scopes_.back().symbols;
+  }
+  auto outer_scopes = std::exchange(scopes_, std::vector<Scope>{std::move(subquery_scope)});
+  auto prev_return_names = std::move(prev_return_names_);
+  auto curr_return_names = std::move(curr_return_names_);
+  call_subquery.single_query_->Accept(*this);
+  std::map<std::string, Symbol> returned_symbols;
+  if (utils::IsSubtype(*clauses.back(), Return::kType)) {
+    returned_symbols = std::move(scopes_.back().symbols);
+  }
+  scopes_ = std::move(outer_scopes);
+  prev_return_names_ = std::move(prev_return_names);
+  curr_return_names_ = std::move(curr_return_names);
+  // Variables returned from the subquery are added to the outer variables.
+  for (auto &[name, symbol] : returned_symbols) {
+    if (HasSymbol(name)) {
+      throw RedeclareVariableError(name);
+    }
+    scopes_.back().symbols.emplace(name, symbol);
+  }
+  return false;  // We handled the traversal ourselves.
+}
+
 // Expressions
 
 SymbolGenerator::ReturnType SymbolGenerator::Visit(Identifier &ident) {
@@ -317,6 +351,9 @@ SymbolGenerator::ReturnType SymbolGenerator::Visit(Identifier &ident) {
     if ((scope.in_create_node || scope.in_create_edge) && HasSymbol(ident.name_)) {
       throw RedeclareVariableError(ident.name_);
     }
+    if (scope.in_exists && ident.user_declared_ && !HasSymbol(ident.name_)) {
+      throw SemanticException("Pattern predicates can't introduce new variables, but '{}' isn't bound.", ident.name_);
+    }
     auto type = Symbol::Type::VERTEX;
     if (scope.visiting_edge) {
       // Edge referencing is not allowed (like in Neo4j):
@@ -430,6 +467,23 @@ bool SymbolGenerator::PreVisit(Extract &extract) {
   return false;
 }
 
+bool SymbolGenerator::PreVisit(Exists &) {
+  auto &scope = scopes_.back();
+  if (!scope.in_match || !scope.in_where) {
+    throw SemanticException("Pattern predicates are only supported in WHERE of MATCH.");
+  }
+  if (scope.in_exists) {
+    throw SemanticException("Pattern predicates can't be nested.");
+  }
+  scope.in_exists = true;
+  return true;
+}
+
+bool SymbolGenerator::PostVisit(Exists &) {
+  scopes_.back().in_exists = false;
+  return true;
+}
+
 // Pattern and its subparts.
 
 bool SymbolGenerator::PreVisit(Pattern &pattern) {
@@ -541,6 +595,10 @@ bool SymbolGenerator::PreVisit(EdgeAtom &edge_atom) {
       VisitWithIdentifiers(edge_atom.weight_lambda_.expression,
                            {edge_atom.weight_lambda_.inner_edge, edge_atom.weight_lambda_.inner_node});
     }
+    if (edge_atom.heuristic_lambda_.expression) {
+      VisitWithIdentifiers(edge_atom.heuristic_lambda_.expression,
+                           {edge_atom.heuristic_lambda_.inner_edge, edge_atom.heuristic_lambda_.inner_node});
+    }
     scope.in_pattern = true;
   }
   scope.in_pattern_atom_identifier = true;
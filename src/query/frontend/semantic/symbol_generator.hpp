@@ -64,6 +64,7 @@ class SymbolGenerator : public HierarchicalTreeVisitor {
   bool PostVisit(Match &) override;
   bool PreVisit(Foreach &) override;
   bool PostVisit(Foreach &) override;
+  bool PreVisit(CallSubquery &) override;
 
   // Expressions
   ReturnType Visit(Identifier &) override;
@@ -79,6 +80,8 @@ class SymbolGenerator : public HierarchicalTreeVisitor {
   bool PreVisit(None &) override;
   bool PreVisit(Reduce &) override;
   bool PreVisit(Extract &) override;
+  bool PreVisit(Exists &) override;
+  bool PostVisit(Exists &) override;
 
   // Pattern and its subparts.
   bool PreVisit(Pattern &) override;
@@ -113,6 +116,9 @@ class SymbolGenerator : public HierarchicalTreeVisitor {
     bool in_where{false};
     bool in_match{false};
     bool in_foreach{false};
+    // True when visiting the pattern of a pattern predicate, which can't
+    // declare new named variables.
+    bool in_exists{false};
     // True when visiting a pattern atom (node or edge) identifier, which can be
     // reused or created in the pattern itself.
     bool in_pattern_atom_identifier{false};
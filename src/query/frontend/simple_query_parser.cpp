@@ -0,0 +1,489 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "query/frontend/simple_query_parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "query/frontend/ast/cypher_main_visitor.hpp"
+#include "query/frontend/stripped.hpp"
+#include "query/typed_value.hpp"
+#include "utils/string.hpp"
+
+namespace memgraph::query::frontend {
+
+namespace {
+
+// Keywords which have a meaning in the handled clauses and expressions, or
+// which the grammar doesn't accept as a symbolic name. Such names are left to
+// ANTLR.
+constexpr auto kReservedNames = std::to_array<std::string_view>({
+    "all", "and", "any", "as", "asc", "ascending", "by", "call", "case", "coalesce", "contains", "count", "create",
+    "delete", "desc", "descending", "detach", "directory", "distinct", "durability", "else", "end", "ends", "exists",
+    "explain", "extract", "false", "filter", "foreach", "grants", "ignore", "in", "is", "kb", "limit", "load",
+    "match", "mb", "memory", "merge", "none", "not", "null", "on", "optional", "or", "order", "profile", "query",
+    "reduce", "remove", "return", "set", "single", "skip", "starts", "stop", "then", "true", "union", "unlimited",
+    "unwind", "when", "where", "with", "xor"});
+
+bool IsReservedName(std::string_view name) {
+  return std::any_of(kReservedNames.begin(), kReservedNames.end(),
+                     [name](std::string_view reserved) { return utils::IEquals(name, reserved); });
+}
+
+// Only plain ASCII names are handled, escaped and unicode names are left to
+// ANTLR.
+bool IsName(std::string_view text) {
+  if (text.empty() || !(std::isalpha(static_cast<unsigned char>(text[0])) || text[0] == '_') || text == "_") {
+    return false;
+  }
+  return std::all_of(text.begin(), text.end(),
+                     [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }) &&
+         !IsReservedName(text);
+}
+
+bool IsParameter(std::string_view text) {
+  if (text.size() < 2U || text[0] != '$') return false;
+  auto name = text.substr(1);
+  if (std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return (name == "0" || name[0] != '0') &&
+           std::all_of(name.begin(), name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+  }
+  return IsName(name);
+}
+
+// Literals are replaced with these tokens in the stripped query, and the
+// visitor turns them into parameter lookups.
+bool IsStrippedLiteral(std::string_view text) {
+  return text == kStrippedIntToken || text == kStrippedDoubleToken || text == kStrippedStringToken ||
+         text == kStrippedBooleanToken;
+}
+
+// Thrown when the query isn't in the handled subset.
+struct UnsupportedQuery {};
+
+class SimpleQueryParser {
+ public:
+  SimpleQueryParser(const std::string &stripped_query, AstStorage *storage) : storage_(storage) {
+    // Tokens in the stripped query are separated by single spaces. Token
+    // positions are those of the ANTLR token stream, where a parameter is two
+    // tokens.
+    std::vector<std::string_view> texts;
+    utils::Split(&texts, stripped_query, " ");
+    int position = 0;
+    for (auto text : texts) {
+      tokens_.push_back({text, position});
+      position += text.size() > 1U && text[0] == '$' ? 2 : 1;
+    }
+    if (!tokens_.empty() && tokens_.back().text == ";") {
+      tokens_.pop_back();
+    }
+  }
+
+  Query *Parse() {
+    auto *cypher_query = storage_->Create<CypherQuery>();
+    auto *single_query = storage_->Create<SingleQuery>();
+    do {
+      ParseClause(&single_query->clauses_);
+    } while (pos_ < tokens_.size());
+    if (!has_update_ && !has_return_) throw UnsupportedQuery();
+
+    int id = 1;
+    for (auto **identifier : anonymous_identifiers_) {
+      while (true) {
+        std::string id_name = CypherMainVisitor::kAnonPrefix + std::to_string(id++);
+        if (!users_identifiers_.contains(id_name)) {
+          *identifier = storage_->Create<Identifier>(id_name, false);
+          break;
+        }
+      }
+    }
+    cypher_query->single_query_ = single_query;
+    return cypher_query;
+  }
+
+ private:
+  struct Token {
+    std::string_view text;
+    int position;
+  };
+
+  std::string_view Peek(size_t ahead = 0) const {
+    return pos_ + ahead < tokens_.size() ? tokens_[pos_ + ahead].text : std::string_view();
+  }
+
+  bool Accept(std::string_view text) {
+    if (pos_ == tokens_.size() || !utils::IEquals(tokens_[pos_].text, text)) return false;
+    ++pos_;
+    return true;
+  }
+
+  void Expect(std::string_view text) {
+    if (!Accept(text)) throw UnsupportedQuery();
+  }
+
+  std::string ParseName() {
+    if (!IsName(Peek())) throw UnsupportedQuery();
+    return std::string(tokens_[pos_++].text);
+  }
+
+  void ParseClause(std::vector<Clause *> *clauses) {
+    // Same clause order checks as in CypherMainVisitor::visitSingleQuery.
+    if (Accept("MATCH")) {
+      if (has_update_ || has_return_) throw UnsupportedQuery();
+      auto *match = storage_->Create<Match>();
+      match->patterns_ = ParsePatterns();
+      if (Accept("WHERE")) {
+        match->where_ = storage_->Create<Where>();
+        match->where_->expression_ = ParseExpression();
+      }
+      clauses->push_back(match);
+    } else if (Accept("UNWIND")) {
+      if (has_update_ || has_return_) throw UnsupportedQuery();
+      auto *named_expr = storage_->Create<NamedExpression>();
+      named_expr->expression_ = ParseExpression();
+      Expect("AS");
+      named_expr->name_ = ParseName();
+      clauses->push_back(storage_->Create<Unwind>(named_expr));
+    } else if (Accept("RETURN")) {
+      if (has_return_) throw UnsupportedQuery();
+      has_return_ = true;
+      clauses->push_back(ParseReturn());
+    } else {
+      if (has_return_) throw UnsupportedQuery();
+      has_update_ = true;
+      if (Accept("CREATE")) {
+        auto *create = storage_->Create<Create>();
+        create->patterns_ = ParsePatterns();
+        clauses->push_back(create);
+      } else if (Accept("MERGE")) {
+        auto *merge = storage_->Create<Merge>();
+        merge->pattern_ = ParsePatternPart();
+        while (Accept("ON")) {
+          if (Accept("MATCH")) {
+            ParseSet(&merge->on_match_);
+          } else {
+            Expect("CREATE");
+            ParseSet(&merge->on_create_);
+          }
+        }
+        clauses->push_back(merge);
+      } else {
+        ParseSet(clauses);
+      }
+    }
+  }
+
+  void ParseSet(std::vector<Clause *> *items) {
+    Expect("SET");
+    do {
+      auto name = ParseName();
+      if (Peek() == ".") {
+        auto *set_property = storage_->Create<SetProperty>();
+        set_property->property_lookup_ = static_cast<PropertyLookup *>(ParsePropertyLookups(MakeIdentifier(name)));
+        Expect("=");
+        set_property->expression_ = ParseExpression();
+        items->push_back(set_property);
+      } else if (Peek() == "=" || Peek() == "+=") {
+        auto *set_properties = storage_->Create<SetProperties>();
+        set_properties->identifier_ = storage_->Create<Identifier>(name);
+        set_properties->update_ = tokens_[pos_++].text == "+=";
+        set_properties->expression_ = ParseExpression();
+        items->push_back(set_properties);
+      } else {
+        auto *set_labels = storage_->Create<SetLabels>();
+        set_labels->identifier_ = storage_->Create<Identifier>(name);
+        set_labels->labels_ = ParseLabels();
+        if (set_labels->labels_.empty()) throw UnsupportedQuery();
+        items->push_back(set_labels);
+      }
+    } while (Accept(","));
+  }
+
+  Return *ParseReturn() {
+    auto *return_clause = storage_->Create<Return>();
+    auto &body = return_clause->body_;
+    body.distinct = Accept("DISTINCT");
+    do {
+      auto *named_expr = storage_->Create<NamedExpression>();
+      auto start = pos_;
+      named_expr->expression_ = ParseExpression();
+      if (Accept("AS")) {
+        named_expr->name_ = ParseName();
+        users_identifiers_.insert(named_expr->name_);
+      } else {
+        for (auto i = start; i < pos_; ++i) {
+          named_expr->name_ += tokens_[i].text;
+        }
+        named_expr->token_position_ = tokens_[start].position;
+      }
+      body.named_expressions.push_back(named_expr);
+    } while (Accept(","));
+    if (Accept("ORDER")) {
+      Expect("BY");
+      do {
+        auto *expression = ParseExpression();
+        auto ordering = Ordering::ASC;
+        if (Accept("DESC") || Accept("DESCENDING")) {
+          ordering = Ordering::DESC;
+        } else if (!Accept("ASC")) {
+          Accept("ASCENDING");
+        }
+        body.order_by.push_back(SortItem{ordering, expression});
+      } while (Accept(","));
+    }
+    if (Accept("SKIP")) {
+      body.skip = ParseExpression();
+    }
+    if (Accept("LIMIT")) {
+      body.limit = ParseExpression();
+    }
+    return return_clause;
+  }
+
+  std::vector<Pattern *> ParsePatterns() {
+    std::vector<Pattern *> patterns;
+    do {
+      patterns.push_back(ParsePatternPart());
+    } while (Accept(","));
+    return patterns;
+  }
+
+  Pattern *ParsePatternPart() {
+    std::optional<std::string> variable;
+    if (Peek(1) == "=") {
+      variable = ParseName();
+      ++pos_;
+    }
+    auto *pattern = storage_->Create<Pattern>();
+    pattern->atoms_.push_back(ParseNode());
+    while (Peek() == "-" || Peek() == "<") {
+      pattern->atoms_.push_back(ParseEdge());
+      pattern->atoms_.push_back(ParseNode());
+    }
+    if (variable) {
+      pattern->identifier_ = MakeIdentifier(*variable);
+    } else {
+      anonymous_identifiers_.push_back(&pattern->identifier_);
+    }
+    return pattern;
+  }
+
+  NodeAtom *ParseNode() {
+    Expect("(");
+    auto *node = storage_->Create<NodeAtom>();
+    if (IsName(Peek())) {
+      node->identifier_ = MakeIdentifier(ParseName());
+    } else {
+      anonymous_identifiers_.push_back(&node->identifier_);
+    }
+    node->labels_ = ParseLabels();
+    ParseProperties(&node->properties_);
+    Expect(")");
+    return node;
+  }
+
+  EdgeAtom *ParseEdge() {
+    const bool left_arrow = Accept("<");
+    Expect("-");
+    auto *edge = storage_->Create<EdgeAtom>();
+    edge->type_ = EdgeAtom::Type::SINGLE;
+    if (Accept("[")) {
+      if (IsName(Peek())) {
+        edge->identifier_ = MakeIdentifier(ParseName());
+      } else {
+        anonymous_identifiers_.push_back(&edge->identifier_);
+      }
+      if (Accept(":")) {
+        edge->edge_types_.push_back(storage_->GetEdgeTypeIx(ParseName()));
+        while (Accept("|")) {
+          Accept(":");
+          edge->edge_types_.push_back(storage_->GetEdgeTypeIx(ParseName()));
+        }
+      }
+      ParseProperties(&edge->properties_);
+      Expect("]");
+    } else {
+      anonymous_identifiers_.push_back(&edge->identifier_);
+    }
+    Expect("-");
+    const bool right_arrow = Accept(">");
+    if (left_arrow && !right_arrow) {
+      edge->direction_ = EdgeAtom::Direction::IN;
+    } else if (!left_arrow && right_arrow) {
+      edge->direction_ = EdgeAtom::Direction::OUT;
+    } else {
+      edge->direction_ = EdgeAtom::Direction::BOTH;
+    }
+    return edge;
+  }
+
+  std::vector<LabelIx> ParseLabels() {
+    std::vector<LabelIx> labels;
+    while (Accept(":")) {
+      labels.push_back(storage_->GetLabelIx(ParseName()));
+    }
+    return labels;
+  }
+
+  void ParseProperties(std::variant<std::unordered_map<PropertyIx, Expression *>, ParameterLookup *> *properties) {
+    if (Peek() == "{") {
+      *properties = ParseMap();
+    } else if (IsParameter(Peek())) {
+      *properties = storage_->Create<ParameterLookup>(tokens_[pos_++].position);
+    }
+  }
+
+  std::unordered_map<PropertyIx, Expression *> ParseMap() {
+    Expect("{");
+    std::unordered_map<PropertyIx, Expression *> map;
+    if (Accept("}")) return map;
+    do {
+      auto key = storage_->GetPropertyIx(ParseName());
+      Expect(":");
+      if (!map.emplace(key, ParseExpression()).second) throw UnsupportedQuery();
+    } while (Accept(","));
+    Expect("}");
+    return map;
+  }
+
+  Expression *ParseExpression() {
+    auto *expression = ParseAnd();
+    while (Accept("OR")) {
+      expression = storage_->Create<OrOperator>(expression, ParseAnd());
+    }
+    return expression;
+  }
+
+  Expression *ParseAnd() {
+    auto *expression = ParseComparison();
+    while (Accept("AND")) {
+      expression = storage_->Create<AndOperator>(expression, ParseComparison());
+    }
+    return expression;
+  }
+
+  // Chained comparisons are split into an AND of single comparisons, as in
+  // CypherMainVisitor::visitExpression8.
+  Expression *ParseComparison() {
+    auto *lhs = ParseAdditive();
+    Expression *result = nullptr;
+    while (true) {
+      auto op = Peek();
+      if (op != "=" && op != "<>" && op != "!=" && op != "<" && op != ">" && op != "<=" && op != ">=") break;
+      ++pos_;
+      auto *rhs = ParseAdditive();
+      Expression *comparison = nullptr;
+      if (op == "=") {
+        comparison = storage_->Create<EqualOperator>(lhs, rhs);
+      } else if (op == "<>" || op == "!=") {
+        comparison = storage_->Create<NotEqualOperator>(lhs, rhs);
+      } else if (op == "<") {
+        comparison = storage_->Create<LessOperator>(lhs, rhs);
+      } else if (op == ">") {
+        comparison = storage_->Create<GreaterOperator>(lhs, rhs);
+      } else if (op == "<=") {
+        comparison = storage_->Create<LessEqualOperator>(lhs, rhs);
+      } else {
+        comparison = storage_->Create<GreaterEqualOperator>(lhs, rhs);
+      }
+      result = result ? storage_->Create<AndOperator>(result, comparison) : comparison;
+      lhs = rhs;
+    }
+    return result ? result : lhs;
+  }
+
+  Expression *ParseAdditive() {
+    auto *expression = ParseMultiplicative();
+    while (true) {
+      if (Accept("+")) {
+        expression = storage_->Create<AdditionOperator>(expression, ParseMultiplicative());
+      } else if (Accept("-")) {
+        expression = storage_->Create<SubtractionOperator>(expression, ParseMultiplicative());
+      } else {
+        return expression;
+      }
+    }
+  }
+
+  Expression *ParseMultiplicative() {
+    auto *expression = ParsePropertyLookups(ParseAtom());
+    while (true) {
+      if (Accept("*")) {
+        expression = storage_->Create<MultiplicationOperator>(expression, ParsePropertyLookups(ParseAtom()));
+      } else if (Accept("/")) {
+        expression = storage_->Create<DivisionOperator>(expression, ParsePropertyLookups(ParseAtom()));
+      } else if (Accept("%")) {
+        expression = storage_->Create<ModOperator>(expression, ParsePropertyLookups(ParseAtom()));
+      } else {
+        return expression;
+      }
+    }
+  }
+
+  Expression *ParsePropertyLookups(Expression *expression) {
+    while (Accept(".")) {
+      expression = storage_->Create<PropertyLookup>(expression, storage_->GetPropertyIx(ParseName()));
+    }
+    return expression;
+  }
+
+  Expression *ParseAtom() {
+    auto text = Peek();
+    if (IsStrippedLiteral(text) || IsParameter(text)) {
+      // Literals of a cached query are looked up among the stripped literals
+      // like parameters are.
+      return storage_->Create<ParameterLookup>(tokens_[pos_++].position);
+    }
+    if (utils::IEquals(text, "null")) {
+      return storage_->Create<PrimitiveLiteral>(TypedValue(), tokens_[pos_++].position);
+    }
+    if (text == "{") {
+      return storage_->Create<MapLiteral>(ParseMap());
+    }
+    return MakeIdentifier(ParseName());
+  }
+
+  Identifier *MakeIdentifier(const std::string &name) {
+    users_identifiers_.insert(name);
+    return storage_->Create<Identifier>(name);
+  }
+
+  AstStorage *storage_;
+  std::vector<Token> tokens_;
+  size_t pos_{0};
+  bool has_update_{false};
+  bool has_return_{false};
+  std::unordered_set<std::string> users_identifiers_;
+  std::vector<Identifier **> anonymous_identifiers_;
+};
+
+}  // namespace
+
+Query *ParseSimpleQuery(const std::string &stripped_query, AstStorage *storage) {
+  // Escaped names may contain spaces, so the query can't be split into tokens.
+  if (stripped_query.find('`') != std::string::npos) return nullptr;
+  try {
+    return SimpleQueryParser(stripped_query, storage).Parse();
+  } catch (const UnsupportedQuery &) {
+    return nullptr;
+  }
+}
+
+}  // namespace memgraph::query::frontend
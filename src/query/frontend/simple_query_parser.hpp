@@ -0,0 +1,36 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <string>
+
+#include "query/frontend/ast/ast.hpp"
+
+namespace memgraph::query::frontend {
+
+/// Recursive descent parser for the most common shapes of simple queries, used
+/// to build the AST of a stripped query without going through ANTLR.
+///
+/// It handles a single query made of MATCH (with WHERE), MERGE (with ON MATCH
+/// and ON CREATE), CREATE, SET, UNWIND and RETURN clauses over node and single
+/// edge patterns, and expressions built from literals, parameters, variables,
+/// property lookups, map literals, arithmetic, comparisons, AND and OR. That
+/// covers point lookups, upserts and batched `UNWIND $batch AS row CREATE ...`
+/// imports.
+///
+/// The produced AST is the same one CypherMainVisitor produces for the stripped
+/// query when `is_query_cached` is set. `nullptr` is returned for anything
+/// else, including queries the visitor would reject, and the query should then
+/// be parsed with ANTLR. `storage` may contain unreachable nodes in that case.
+Query *ParseSimpleQuery(const std::string &stripped_query, AstStorage *storage);
+
+}  // namespace memgraph::query::frontend
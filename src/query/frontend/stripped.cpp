@@ -11,11 +11,13 @@
 
 #include "query/frontend/stripped.hpp"
 
+#include <array>
 #include <cctype>
 #include <cstdint>
 #include <iostream>
 #include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "query/exceptions.hpp"
@@ -32,6 +34,46 @@ namespace memgraph::query::frontend {
 
 using namespace lexer_constants;
 
+namespace {
+
+// Lexer rules of the stripped query tokens. Each rule has a bit in the
+// candidate mask of the characters its tokens can start with.
+enum LexerRule : uint16_t {
+  KEYWORD_RULE = 1U << 0U,
+  SPECIAL_RULE = 1U << 1U,
+  STRING_RULE = 1U << 2U,
+  NUMBER_RULE = 1U << 3U,  // Decimal, octal, hexadecimal and real.
+  PARAMETER_RULE = 1U << 4U,
+  ESCAPED_NAME_RULE = 1U << 5U,
+  UNESCAPED_NAME_RULE = 1U << 6U,
+  SPACE_RULE = 1U << 7U,
+};
+
+// For every first byte of a token, the rules which can match a token starting
+// with it. Every other rule would return a zero length match, so it doesn't
+// have to be tried. Bytes of multibyte UTF-8 characters can start names and
+// spaces.
+const std::array<uint16_t, 256> &LexerRuleCandidates() {
+  static const auto candidates = [] {
+    std::array<uint16_t, 256> candidates{};
+    for (int c = 0; c < 256; ++c) {
+      auto &mask = candidates[c];
+      if (kKeywords.MayStartWith(tolower(c))) mask |= KEYWORD_RULE;
+      if (kSpecialTokens.MayStartWith(c)) mask |= SPECIAL_RULE;
+      if (c == '"' || c == '\'') mask |= STRING_RULE;
+      if (isdigit(c) || c == '.') mask |= NUMBER_RULE;
+      if (c == '$') mask |= PARAMETER_RULE;
+      if (c == '`') mask |= ESCAPED_NAME_RULE;
+      if (c >= 0x80 || kUnescapedNameAllowedStarts[c]) mask |= UNESCAPED_NAME_RULE;
+      if (c >= 0x80 || kSpaceParts[c] || c == '/') mask |= SPACE_RULE;
+    }
+    return candidates;
+  }();
+  return candidates;
+}
+
+}  // namespace
+
 StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
   enum class Token {
     UNMATCHED,
@@ -46,8 +88,12 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
     SPACE
   };
 
-  std::vector<std::pair<Token, std::string>> tokens;
-  std::string unstripped_chunk;
+  const auto &rule_candidates = LexerRuleCandidates();
+  // Tokens point into `original_`, which isn't changed until the end of the
+  // constructor.
+  const std::string_view original_view = original_;
+  std::vector<std::pair<Token, std::string_view>> tokens;
+  std::string_view unstripped_chunk;
   for (int i = 0; i < static_cast<int>(original_.size());) {
     Token token = Token::UNMATCHED;
     int len = 0;
@@ -57,24 +103,29 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
         token = new_token;
       }
     };
-    update(MatchKeyword(i), Token::KEYWORD);
-    update(MatchSpecial(i), Token::SPECIAL);
-    update(MatchString(i), Token::STRING);
-    update(MatchDecimalInt(i), Token::INT);
-    update(MatchOctalInt(i), Token::INT);
-    update(MatchHexadecimalInt(i), Token::INT);
-    update(MatchReal(i), Token::REAL);
-    update(MatchParameter(i), Token::PARAMETER);
-    update(MatchEscapedName(i), Token::ESCAPED_NAME);
-    update(MatchUnescapedName(i), Token::UNESCAPED_NAME);
-    update(MatchWhitespaceAndComments(i), Token::SPACE);
+    // The order of the rules decides the token type when more of them match
+    // the same length.
+    const auto candidates = rule_candidates[static_cast<unsigned char>(original_[i])];
+    if (candidates & KEYWORD_RULE) update(MatchKeyword(i), Token::KEYWORD);
+    if (candidates & SPECIAL_RULE) update(MatchSpecial(i), Token::SPECIAL);
+    if (candidates & STRING_RULE) update(MatchString(i), Token::STRING);
+    if (candidates & NUMBER_RULE) {
+      update(MatchDecimalInt(i), Token::INT);
+      update(MatchOctalInt(i), Token::INT);
+      update(MatchHexadecimalInt(i), Token::INT);
+      update(MatchReal(i), Token::REAL);
+    }
+    if (candidates & PARAMETER_RULE) update(MatchParameter(i), Token::PARAMETER);
+    if (candidates & ESCAPED_NAME_RULE) update(MatchEscapedName(i), Token::ESCAPED_NAME);
+    if (candidates & UNESCAPED_NAME_RULE) update(MatchUnescapedName(i), Token::UNESCAPED_NAME);
+    if (candidates & SPACE_RULE) update(MatchWhitespaceAndComments(i), Token::SPACE);
     if (token == Token::UNMATCHED) throw LexingException("Invalid query.");
-    tokens.emplace_back(token, original_.substr(i, len));
+    tokens.emplace_back(token, original_view.substr(i, len));
     i += len;
 
     // If we notice execute, we possibly create a trigger which has defined statements.
     // The statements will be parsed separately later on so we skip it for now.
-    if (utils::IEquals(tokens.back().second, "execute")) {
+    if (len == 7 && utils::IEquals(tokens.back().second, "execute")) {
       // check if it's CREATE TRIGGER query
       std::span token_span{tokens};
 
@@ -88,24 +139,22 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
       // trigger-name (5th element) can also be "execute" so we verify that the size is larger than 5
       if (token_span.size() > 5 && utils::IEquals(token_span[0].second, "create") &&
           utils::IEquals(token_span[2].second, "trigger")) {
-        unstripped_chunk = original_.substr(i);
+        unstripped_chunk = original_view.substr(i);
         break;
       }
     }
   }
 
-  std::vector<std::string> token_strings;
+  std::vector<std::string_view> token_strings;
+  token_strings.reserve(tokens.size() + 1);
   // A helper function that stores literal and its token position in a
   // literals_. In stripped query text literal is replaced with a new_value.
   // new_value can be any value that is lexed as a literal.
   auto replace_stripped = [this, &token_strings](int position, const auto &value, const std::string &new_value) {
     literals_.Add(position, storage::PropertyValue(value));
-    token_strings.push_back(new_value);
+    token_strings.emplace_back(new_value);
   };
 
-  // Copy original tokens because we need to use original case in named
-  // expressions and keywords in tokens will be lowercased in the next loop.
-  auto original_tokens = tokens;
   // For every token in original query remember token index in stripped query.
   std::vector<int> position_mapping(tokens.size(), -1);
 
@@ -134,13 +183,13 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
       case Token::SPACE:
         break;
       case Token::STRING:
-        replace_stripped(token_index, ParseStringLiteral(token.second), kStrippedStringToken);
+        replace_stripped(token_index, ParseStringLiteral(std::string(token.second)), kStrippedStringToken);
         break;
       case Token::INT:
-        replace_stripped(token_index, ParseIntegerLiteral(token.second), kStrippedIntToken);
+        replace_stripped(token_index, ParseIntegerLiteral(std::string(token.second)), kStrippedIntToken);
         break;
       case Token::REAL:
-        replace_stripped(token_index, ParseDoubleLiteral(token.second), kStrippedDoubleToken);
+        replace_stripped(token_index, ParseDoubleLiteral(std::string(token.second)), kStrippedDoubleToken);
         break;
       case Token::SPECIAL:
       case Token::ESCAPED_NAME:
@@ -148,7 +197,7 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
         token_strings.push_back(token.second);
         break;
       case Token::PARAMETER:
-        parameters_[token_index] = ParseParameter(token.second);
+        parameters_[token_index] = ParseParameter(std::string(token.second));
         token_strings.push_back(token.second);
         break;
     }
@@ -159,17 +208,25 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
   }
 
   if (!unstripped_chunk.empty()) {
-    token_strings.push_back(std::move(unstripped_chunk));
+    token_strings.push_back(unstripped_chunk);
   }
 
-  query_ = utils::Join(token_strings, " ");
+  size_t query_size = token_strings.size();
+  for (const auto token_string : token_strings) {
+    query_size += token_string.size();
+  }
+  query_.reserve(query_size);
+  for (const auto token_string : token_strings) {
+    if (!query_.empty()) query_ += ' ';
+    query_ += token_string;
+  }
   hash_ = utils::Fnv(query_);
 
   auto it = tokens.begin();
   while (it != tokens.end()) {
     // Store nonaliased named expressions in returns in named_exprs_.
     it = std::find_if(it, tokens.end(),
-                      [](const std::pair<Token, std::string> &a) { return utils::IEquals(a.second, "return"); });
+                      [](const std::pair<Token, std::string_view> &a) { return utils::IEquals(a.second, "return"); });
     // There is no RETURN so there is nothing to do here.
     if (it == tokens.end()) return;
     // Skip RETURN;
@@ -233,12 +290,10 @@ StrippedQuery::StrippedQuery(const std::string &query) : original_(query) {
         // Named expression is not aliased. Save string disregarding leading and
         // trailing whitespaces.
         std::string s;
-        auto begin_token = it - tokens.begin() + original_tokens.begin();
-        auto end_token = last_non_space - tokens.begin() + original_tokens.begin() + 1;
-        for (auto kt = begin_token; kt != end_token; ++kt) {
+        for (auto kt = it; kt != last_non_space + 1; ++kt) {
           s += kt->second;
         }
-        named_exprs_[position_mapping[it - tokens.begin()]] = s;
+        named_exprs_[position_mapping[it - tokens.begin()]] = std::move(s);
       }
       if (jt != tokens.end() && jt->second == ",") {
         // There are more named expressions.
@@ -467,6 +522,13 @@ int StrippedQuery::MatchUnescapedName(int start) const {
   }
   i += got.second;
   while (i < static_cast<int>(original_.size())) {
+    // Most names are ASCII, which doesn't need UTF-8 decoding.
+    const auto c = static_cast<unsigned char>(original_[i]);
+    if (c < 0x80) {
+      if (!kUnescapedNameAllowedParts[c]) break;
+      ++i;
+      continue;
+    }
     got = GetFirstUtf8SymbolCodepoint(original_.data() + i);
     if (got.first >= lexer_constants::kBitsetSize || !kUnescapedNameAllowedParts[got.first]) {
       break;
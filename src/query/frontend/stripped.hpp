@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -43,10 +43,9 @@ class StrippedQuery {
   explicit StrippedQuery(const std::string &query);
 
   /**
-   * Copy constructor is deleted because we don't want to make unnecessary
+   * Copy constructor is private because we don't want to make unnecessary
    * copies of this object (copying of string and vector could be expensive)
    */
-  StrippedQuery(const StrippedQuery &other) = delete;
   StrippedQuery &operator=(const StrippedQuery &other) = delete;
 
   /**
@@ -63,7 +62,15 @@ class StrippedQuery {
   const auto &parameters() const { return parameters_; }
   uint64_t hash() const { return hash_; }
 
+  /**
+   * Makes an explicit copy, which is still cheaper than stripping the query
+   * again.
+   */
+  StrippedQuery Clone() const { return StrippedQuery(*this); }
+
  private:
+  StrippedQuery(const StrippedQuery &other) = default;
+
   // Return len of matched keyword if something is matched, otherwise 0.
   int MatchKeyword(int start) const;
   int MatchString(int start) const;
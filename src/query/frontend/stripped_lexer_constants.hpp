@@ -74,6 +74,9 @@ class Trie {
     return longest_found_len;
   }
 
+  // Whether some inserted string starts with the given character.
+  bool MayStartWith(unsigned char c) const { return nodes_[kRootIndex].next[c] != 0; }
+
  private:
   struct Node {
     int next[1 << (sizeof(unsigned char) * 8)] = {};
@@ -208,7 +211,17 @@ const trie::Trie kKeywords = {"union",
                               "websocket",
                               "foreach",
                               "labels",
-                              "edge_types"};
+                              "edge_types",
+                              "analyze",
+                              "graph",
+                              "statistics",
+                              "plan",
+                              "cache",
+                              "resource",
+                              "pools",
+                              "of",
+                              "rows",
+                              "transactions"};
 
 // Unicode codepoints that are allowed at the start of the unescaped name.
 const std::bitset<kBitsetSize> kUnescapedNameAllowedStarts(
@@ -714,6 +714,12 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
     }
   }
 
+  TypedValue Visit(Exists &) override {
+    // Pattern predicates are planned as SemiApply operators, so they can't
+    // be evaluated here.
+    throw QueryRuntimeException("Pattern predicates are only supported as conditions of WHERE in MATCH.");
+  }
+
  private:
   template <class TRecordAccessor>
   storage::PropertyValue GetProperty(const TRecordAccessor &record_accessor, PropertyIx prop) {
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -41,6 +41,7 @@
 #include "query/frontend/semantic/symbol_generator.hpp"
 #include "query/interpret/eval.hpp"
 #include "query/metadata.hpp"
+#include "query/plan/operator_estimator.hpp"
 #include "query/plan/planner.hpp"
 #include "query/plan/profile.hpp"
 #include "query/plan/vertex_count_cache.hpp"
@@ -65,6 +66,11 @@
 #include "utils/tsc.hpp"
 #include "utils/variant_helpers.hpp"
 
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_bool(query_profile_hardware_counters, false,
+            "Report the CPU cycles and cache misses of each operator in PROFILE, if the kernel allows reading the "
+            "hardware counters.");
+
 namespace EventCounter {
 extern Event ReadQuery;
 extern Event WriteQuery;
@@ -83,6 +89,16 @@ template <typename>
 constexpr auto kAlwaysFalse = false;
 
 namespace {
+// Bounds the memory a session can hold in prepared statements.
+constexpr size_t kMaxPreparedStatements = 1024;
+
+/// Returns the stricter of the two memory limits.
+std::optional<size_t> MinMemoryLimit(const std::optional<size_t> lhs, const std::optional<size_t> rhs) {
+  if (!lhs) return rhs;
+  if (!rhs) return lhs;
+  return std::min(*lhs, *rhs);
+}
+
 void UpdateTypeCount(const plan::ReadWriteTypeChecker::RWType type) {
   switch (type) {
     case plan::ReadWriteTypeChecker::RWType::R:
@@ -256,6 +272,9 @@ class ReplQueryHandler final : public query::ReplicationQueryHandler {
           break;
       }
 
+      replica.queued_transactions = repl_info.queue_info.queued_transactions;
+      replica.queue_lag_ms = repl_info.queue_info.lag.count();
+
       return replica;
     };
 
@@ -556,9 +575,14 @@ Callback HandleReplicationQuery(ReplicationQuery *repl_query, const Parameters &
     }
 
     case ReplicationQuery::Action::SHOW_REPLICAS: {
-      callback.header = {
-          "name", "socket_address", "sync_mode", "current_timestamp_of_replica", "number_of_timestamp_behind_master",
-          "state"};
+      callback.header = {"name",
+                         "socket_address",
+                         "sync_mode",
+                         "current_timestamp_of_replica",
+                         "number_of_timestamp_behind_master",
+                         "state",
+                         "queued_transactions",
+                         "queue_lag_ms"};
       callback.fn = [handler = ReplQueryHandler{interpreter_context->db}, replica_nfields = callback.header.size()] {
         const auto &replicas = handler.ShowReplicas();
         auto typed_replicas = std::vector<std::vector<TypedValue>>{};
@@ -598,6 +622,9 @@ Callback HandleReplicationQuery(ReplicationQuery *repl_query, const Parameters &
               break;
           }
 
+          typed_replica.emplace_back(TypedValue(static_cast<int64_t>(replica.queued_transactions)));
+          typed_replica.emplace_back(TypedValue(static_cast<int64_t>(replica.queue_lag_ms)));
+
           typed_replicas.emplace_back(std::move(typed_replica));
         }
         return typed_replicas;
@@ -976,17 +1003,28 @@ struct PullPlan {
   explicit PullPlan(std::shared_ptr<CachedPlan> plan, const Parameters &parameters, bool is_profile_query,
                     DbAccessor *dba, InterpreterContext *interpreter_context, utils::MemoryResource *execution_memory,
                     std::optional<std::string> username, TriggerContextCollector *trigger_context_collector = nullptr,
-                    std::optional<size_t> memory_limit = {});
+                    std::optional<size_t> memory_limit = {}, std::function<void()> periodic_commit = {},
+                    int64_t *peak_pull_memory_bytes = nullptr);
   std::optional<plan::ProfilingStatsWithTotalTime> Pull(AnyStream *stream, std::optional<int> n,
                                                         const std::vector<Symbol> &output_symbols,
                                                         std::map<std::string, TypedValue> *summary);
 
  private:
   std::shared_ptr<CachedPlan> plan_ = nullptr;
+  // When profiling, the memory used by the cursor and by each pull goes through
+  // a `ProfilingMemoryResource`, so it can be attributed to the operators. The
+  // members are declared before `cursor_` as the cursor is created with them.
+  plan::ProfilingMemoryUsage profile_memory_usage_;
+  std::optional<plan::ProfilingMemoryResource> profile_execution_memory_;
   plan::UniqueCursorPtr cursor_ = nullptr;
   Frame frame_;
   ExecutionContext ctx_;
   std::optional<size_t> memory_limit_;
+  // The memory the pool resource of each pull draws from its upstream
+  // resources. It's freed at the end of the pull, so only the peak is kept and
+  // reported through `peak_pull_memory_bytes_`.
+  plan::ProfilingMemoryUsage pull_memory_usage_;
+  int64_t *peak_pull_memory_bytes_;
 
   // As it's possible to query execution using multiple pulls
   // we need the keep track of the total execution time across
@@ -1005,11 +1043,15 @@ struct PullPlan {
 PullPlan::PullPlan(const std::shared_ptr<CachedPlan> plan, const Parameters &parameters, const bool is_profile_query,
                    DbAccessor *dba, InterpreterContext *interpreter_context, utils::MemoryResource *execution_memory,
                    std::optional<std::string> username, TriggerContextCollector *trigger_context_collector,
-                   const std::optional<size_t> memory_limit)
+                   const std::optional<size_t> memory_limit, std::function<void()> periodic_commit,
+                   int64_t *peak_pull_memory_bytes)
     : plan_(plan),
-      cursor_(plan->plan().MakeCursor(execution_memory)),
+      cursor_(plan->plan().MakeCursor(
+          is_profile_query ? &profile_execution_memory_.emplace(execution_memory, &profile_memory_usage_)
+                           : execution_memory)),
       frame_(plan->symbol_table().max_position(), execution_memory),
-      memory_limit_(memory_limit) {
+      memory_limit_(memory_limit),
+      peak_pull_memory_bytes_(peak_pull_memory_bytes) {
   ctx_.db_accessor = dba;
   ctx_.symbol_table = plan->symbol_table();
   ctx_.evaluation_context.timestamp = QueryTimestamp();
@@ -1026,7 +1068,11 @@ PullPlan::PullPlan(const std::shared_ptr<CachedPlan> plan, const Parameters &par
   }
   ctx_.is_shutting_down = &interpreter_context->is_shutting_down;
   ctx_.is_profile_query = is_profile_query;
+  if (is_profile_query) {
+    ctx_.profile_memory_usage = &profile_memory_usage_;
+  }
   ctx_.trigger_context_collector = trigger_context_collector;
+  ctx_.periodic_commit = std::move(periodic_commit);
 }
 
 std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *stream, std::optional<int> n,
@@ -1044,7 +1090,11 @@ std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *strea
   // Also, we want to throw only when the query engine requests more memory and not the storage
   // so we add the exception to the allocator.
   // TODO (mferencevic): Tune the parameters accordingly.
-  utils::PoolResource pool_memory(128, 1024, &monotonic_memory, utils::NewDeleteResource());
+  // The chunks and the unpooled blocks of the pool are counted, so the memory
+  // held by the pull is included in the peak memory of the query.
+  plan::ProfilingMemoryResource pool_chunks_memory(&monotonic_memory, &pull_memory_usage_);
+  plan::ProfilingMemoryResource pool_blocks_memory(utils::NewDeleteResource(), &pull_memory_usage_);
+  utils::PoolResource pool_memory(128, 1024, &pool_chunks_memory, &pool_blocks_memory);
   std::optional<utils::LimitedMemoryResource> maybe_limited_resource;
 
   if (memory_limit_) {
@@ -1054,6 +1104,22 @@ std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *strea
     ctx_.evaluation_context.memory = &pool_memory;
   }
 
+  std::optional<plan::ProfilingMemoryResource> profile_pull_memory;
+  std::optional<utils::PerfEventCounters> perf_event_counters;
+  ctx_.profile_perf_event_counters = nullptr;
+  if (ctx_.is_profile_query) {
+    ctx_.evaluation_context.memory =
+        &profile_pull_memory.emplace(ctx_.evaluation_context.memory, &profile_memory_usage_);
+    if (FLAGS_query_profile_hardware_counters) {
+      perf_event_counters.emplace();
+      if (perf_event_counters->IsAvailable()) {
+        ctx_.profile_perf_event_counters = &*perf_event_counters;
+      } else {
+        spdlog::debug("The hardware counters are not available for PROFILE.");
+      }
+    }
+  }
+
   // Returns true if a result was pulled.
   const auto pull_result = [&]() -> bool { return cursor_->Pull(frame_, ctx_); };
 
@@ -1096,6 +1162,7 @@ std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *strea
   has_unsent_results_ = i == n && pull_result();
 
   execution_time_ += timer.Elapsed();
+  if (peak_pull_memory_bytes_) *peak_pull_memory_bytes_ = pull_memory_usage_.peak;
 
   if (has_unsent_results_) {
     return std::nullopt;
@@ -1115,7 +1182,11 @@ std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *strea
   }
   cursor_->Shutdown();
   ctx_.profile_execution_time = execution_time_;
-  return GetStatsWithTotalTime(ctx_);
+  auto stats = GetStatsWithTotalTime(ctx_);
+  stats.report_hardware_counters = FLAGS_query_profile_hardware_counters;
+  stats.hardware_counters_available = ctx_.profile_perf_event_counters != nullptr;
+  ctx_.profile_perf_event_counters = nullptr;
+  return stats;
 }
 
 using RWType = plan::ReadWriteTypeChecker::RWType;
@@ -1123,7 +1194,12 @@ using RWType = plan::ReadWriteTypeChecker::RWType;
 
 InterpreterContext::InterpreterContext(storage::Storage *db, const InterpreterConfig config,
                                        const std::filesystem::path &data_directory)
-    : db(db), trigger_store(data_directory / "triggers"), config(config), streams{this, data_directory / "streams"} {}
+    : db(db),
+      admission_controller(ParseResourcePools(FLAGS_resource_pools),
+                           ParseResourcePoolAssignments(FLAGS_resource_pool_assignments)),
+      trigger_store(data_directory / "triggers"),
+      config(config),
+      streams{this, data_directory / "streams"} {}
 
 Interpreter::Interpreter(InterpreterContext *interpreter_context) : interpreter_context_(interpreter_context) {
   MG_ASSERT(interpreter_context_, "Interpreter context must not be NULL");
@@ -1168,6 +1244,7 @@ PreparedQuery Interpreter::PrepareTransactionQuery(std::string_view query_upper)
 
       expect_rollback_ = false;
       in_explicit_transaction_ = false;
+      transaction_admission_.reset();
     };
   } else if (query_upper == "ROLLBACK") {
     handler = [this] {
@@ -1194,8 +1271,11 @@ PreparedQuery Interpreter::PrepareTransactionQuery(std::string_view query_upper)
 PreparedQuery PrepareCypherQuery(ParsedQuery parsed_query, std::map<std::string, TypedValue> *summary,
                                  InterpreterContext *interpreter_context, DbAccessor *dba,
                                  utils::MemoryResource *execution_memory, std::vector<Notification> *notifications,
-                                 const std::string *username,
-                                 TriggerContextCollector *trigger_context_collector = nullptr) {
+                                 const std::string *username, std::optional<bool> *plan_cache_hit,
+                                 int64_t *peak_pull_memory_bytes, std::optional<size_t> pool_memory_limit,
+                                 std::shared_ptr<CachedPlan> *pinned_plan = nullptr,
+                                 TriggerContextCollector *trigger_context_collector = nullptr,
+                                 std::function<void()> periodic_commit = {}) {
   auto *cypher_query = utils::Downcast<CypherQuery>(parsed_query.query);
 
   Frame frame(0);
@@ -1205,7 +1285,8 @@ PreparedQuery PrepareCypherQuery(ParsedQuery parsed_query, std::map<std::string,
   evaluation_context.parameters = parsed_query.parameters;
 
   ExpressionEvaluator evaluator(&frame, symbol_table, evaluation_context, dba, storage::View::OLD);
-  const auto memory_limit = EvaluateMemoryLimit(&evaluator, cypher_query->memory_limit_, cypher_query->memory_scale_);
+  const auto memory_limit = MinMemoryLimit(
+      EvaluateMemoryLimit(&evaluator, cypher_query->memory_limit_, cypher_query->memory_scale_), pool_memory_limit);
   if (memory_limit) {
     spdlog::info("Running query with memory limit of {}", utils::GetReadableSize(*memory_limit));
   }
@@ -1219,9 +1300,20 @@ PreparedQuery PrepareCypherQuery(ParsedQuery parsed_query, std::map<std::string,
         "conversion functions such as ToInteger, ToFloat, ToBoolean etc.");
   }
 
-  auto plan = CypherQueryToPlan(parsed_query.stripped_query.hash(), std::move(parsed_query.ast_storage), cypher_query,
-                                parsed_query.parameters,
-                                parsed_query.is_cacheable ? &interpreter_context->plan_cache : nullptr, dba);
+  // A prepared statement keeps its plan and skips the plan cache lookup while
+  // the cache still holds the plan and the plan isn't stale.
+  std::shared_ptr<CachedPlan> plan;
+  if (pinned_plan && *pinned_plan && !(*pinned_plan)->IsInvalidated() && !(*pinned_plan)->IsStale(*dba)) {
+    plan = *pinned_plan;
+    plan->usage().Hit();
+    if (plan_cache_hit) *plan_cache_hit = true;
+  } else {
+    plan = CypherQueryToPlan(parsed_query.stripped_query.hash(), std::move(parsed_query.ast_storage), cypher_query,
+                             parsed_query.parameters,
+                             parsed_query.is_cacheable ? &interpreter_context->plan_cache : nullptr, dba, {},
+                             plan_cache_hit);
+    if (pinned_plan) *pinned_plan = parsed_query.is_cacheable ? plan : nullptr;
+  }
 
   summary->insert_or_assign("cost_estimate", plan->cost());
   auto rw_type_checker = plan::ReadWriteTypeChecker();
@@ -1241,7 +1333,8 @@ PreparedQuery PrepareCypherQuery(ParsedQuery parsed_query, std::map<std::string,
   }
   auto pull_plan =
       std::make_shared<PullPlan>(plan, parsed_query.parameters, false, dba, interpreter_context, execution_memory,
-                                 StringPointerToOptional(username), trigger_context_collector, memory_limit);
+                                 StringPointerToOptional(username), trigger_context_collector, memory_limit,
+                                 std::move(periodic_commit), peak_pull_memory_bytes);
   return PreparedQuery{std::move(header), std::move(parsed_query.required_privileges),
                        [pull_plan = std::move(pull_plan), output_symbols = std::move(output_symbols), summary](
                            AnyStream *stream, std::optional<int> n) -> std::optional<QueryHandlerResult> {
@@ -1277,15 +1370,20 @@ PreparedQuery PrepareExplainQuery(ParsedQuery parsed_query, std::map<std::string
       parsed_inner_query.stripped_query.hash(), std::move(parsed_inner_query.ast_storage), cypher_query,
       parsed_inner_query.parameters, parsed_inner_query.is_cacheable ? &interpreter_context->plan_cache : nullptr, dba);
 
+  auto vertex_counts = plan::MakeVertexCountCache(dba);
+  const auto estimator =
+      plan::MakeOperatorEstimator(&vertex_counts, parsed_inner_query.parameters, cypher_query_plan->symbol_table(),
+                                  const_cast<plan::LogicalOperator &>(cypher_query_plan->plan()));
+
   std::stringstream printed_plan;
-  plan::PrettyPrint(*dba, &cypher_query_plan->plan(), &printed_plan);
+  plan::PrettyPrint(*dba, &cypher_query_plan->plan(), estimator, &printed_plan);
 
   std::vector<std::vector<TypedValue>> printed_plan_rows;
   for (const auto &row : utils::Split(utils::RTrim(printed_plan.str()), "\n")) {
     printed_plan_rows.push_back(std::vector<TypedValue>{TypedValue(row)});
   }
 
-  summary->insert_or_assign("explain", plan::PlanToJson(*dba, &cypher_query_plan->plan()).dump());
+  summary->insert_or_assign("explain", plan::PlanToJson(*dba, &cypher_query_plan->plan(), estimator).dump());
 
   return PreparedQuery{{"QUERY PLAN"},
                        std::move(parsed_query.required_privileges),
@@ -1302,7 +1400,7 @@ PreparedQuery PrepareExplainQuery(ParsedQuery parsed_query, std::map<std::string
 PreparedQuery PrepareProfileQuery(ParsedQuery parsed_query, bool in_explicit_transaction,
                                   std::map<std::string, TypedValue> *summary, InterpreterContext *interpreter_context,
                                   DbAccessor *dba, utils::MemoryResource *execution_memory,
-                                  const std::string *username) {
+                                  const std::string *username, std::optional<size_t> pool_memory_limit) {
   const std::string kProfileQueryStart = "profile ";
 
   MG_ASSERT(utils::StartsWith(utils::ToLowerCase(parsed_query.stripped_query.query()), kProfileQueryStart),
@@ -1340,13 +1438,19 @@ PreparedQuery PrepareProfileQuery(ParsedQuery parsed_query, bool in_explicit_tra
 
   auto *cypher_query = utils::Downcast<CypherQuery>(parsed_inner_query.query);
   MG_ASSERT(cypher_query, "Cypher grammar should not allow other queries in PROFILE");
+  // The transaction of a PROFILE query is aborted, which the batches committed
+  // by `IN TRANSACTIONS` can't be.
+  if (HasCallInTransactions(*cypher_query)) {
+    throw QueryException("CALL subqueries IN TRANSACTIONS not allowed in PROFILE queries.");
+  }
   Frame frame(0);
   SymbolTable symbol_table;
   EvaluationContext evaluation_context;
   evaluation_context.timestamp = QueryTimestamp();
   evaluation_context.parameters = parsed_inner_query.parameters;
   ExpressionEvaluator evaluator(&frame, symbol_table, evaluation_context, dba, storage::View::OLD);
-  const auto memory_limit = EvaluateMemoryLimit(&evaluator, cypher_query->memory_limit_, cypher_query->memory_scale_);
+  const auto memory_limit = MinMemoryLimit(
+      EvaluateMemoryLimit(&evaluator, cypher_query->memory_limit_, cypher_query->memory_scale_), pool_memory_limit);
 
   auto cypher_query_plan = CypherQueryToPlan(
       parsed_inner_query.stripped_query.hash(), std::move(parsed_inner_query.ast_storage), cypher_query,
@@ -1356,7 +1460,14 @@ PreparedQuery PrepareProfileQuery(ParsedQuery parsed_query, bool in_explicit_tra
 
   rw_type_checker.InferRWType(const_cast<plan::LogicalOperator &>(cypher_query_plan->plan()));
 
-  return PreparedQuery{{"OPERATOR", "ACTUAL HITS", "RELATIVE TIME", "ABSOLUTE TIME"},
+  std::vector<std::string> header{"OPERATOR",      "ACTUAL HITS",      "RELATIVE TIME",
+                                  "ABSOLUTE TIME", "ALLOCATED MEMORY", "PEAK MEMORY"};
+  if (FLAGS_query_profile_hardware_counters) {
+    header.emplace_back("CPU CYCLES");
+    header.emplace_back("CACHE MISSES");
+  }
+
+  return PreparedQuery{std::move(header),
                        std::move(parsed_query.required_privileges),
                        [plan = std::move(cypher_query_plan), parameters = std::move(parsed_inner_query.parameters),
                         summary, dba, interpreter_context, execution_memory, memory_limit, optional_username,
@@ -1408,14 +1519,6 @@ PreparedQuery PrepareIndexQuery(ParsedQuery parsed_query, bool in_explicit_trans
   auto *index_query = utils::Downcast<IndexQuery>(parsed_query.query);
   std::function<void(Notification &)> handler;
 
-  // Creating an index influences computed plan costs.
-  auto invalidate_plan_cache = [plan_cache = &interpreter_context->plan_cache] {
-    auto access = plan_cache->access();
-    for (auto &kv : access) {
-      access.remove(kv.first);
-    }
-  };
-
   auto label = interpreter_context->db->NameToLabel(index_query->label_.name);
 
   std::vector<storage::PropertyId> properties;
@@ -1432,6 +1535,13 @@ PreparedQuery PrepareIndexQuery(ParsedQuery parsed_query, bool in_explicit_trans
     throw utils::NotYetImplemented("index on multiple properties");
   }
 
+  // Creating an index influences computed plan costs of the plans which use
+  // the indexed label and property.
+  auto invalidate_plan_cache = [plan_cache = &interpreter_context->plan_cache, label,
+                                property = properties.empty() ? std::nullopt : std::make_optional(properties[0])] {
+    InvalidatePlanCache(plan_cache, label, property);
+  };
+
   Notification index_notification(SeverityLevel::INFO);
   switch (index_query->action_) {
     case IndexQuery::Action::CREATE: {
@@ -1927,6 +2037,72 @@ PreparedQuery PrepareVersionQuery(ParsedQuery parsed_query, const bool in_explic
                        RWType::NONE};
 }
 
+PreparedQuery PrepareAnalyzeGraphQuery(ParsedQuery parsed_query, const bool in_explicit_transaction,
+                                       InterpreterContext *interpreter_context) {
+  if (in_explicit_transaction) {
+    throw AnalyzeGraphInMulticommandTxException();
+  }
+
+  auto *analyze_graph_query = utils::Downcast<AnalyzeGraphQuery>(parsed_query.query);
+  std::vector<std::string> header;
+  std::function<std::vector<std::vector<TypedValue>>()> handler;
+
+  // Graph statistics influence computed plan costs.
+  auto invalidate_plan_cache = [plan_cache = &interpreter_context->plan_cache] { InvalidatePlanCache(plan_cache); };
+
+  switch (analyze_graph_query->action_) {
+    case AnalyzeGraphQuery::Action::ANALYZE:
+      header = {"statistics type", "name", "property", "count", "distinct values", "average degree"};
+      handler = [interpreter_context, invalidate_plan_cache = std::move(invalidate_plan_cache)] {
+        auto *db = interpreter_context->db;
+        auto statistics = db->Access().AnalyzeGraph();
+        invalidate_plan_cache();
+
+        std::vector<std::vector<TypedValue>> results;
+        results.reserve(statistics->labels.size() + statistics->label_properties.size() +
+                        statistics->edge_types.size());
+        for (const auto &[label, stats] : statistics->labels) {
+          results.push_back({TypedValue("label"), TypedValue(db->LabelToName(label)), TypedValue(),
+                             TypedValue(stats.count), TypedValue(), TypedValue(stats.avg_degree)});
+        }
+        for (const auto &[label_property, stats] : statistics->label_properties) {
+          results.push_back({TypedValue("label+property"), TypedValue(db->LabelToName(label_property.first)),
+                             TypedValue(db->PropertyToName(label_property.second)), TypedValue(stats.count),
+                             TypedValue(stats.distinct_values_count), TypedValue()});
+        }
+        for (const auto &[edge_type, stats] : statistics->edge_types) {
+          results.push_back({TypedValue("edge type"), TypedValue(db->EdgeTypeToName(edge_type)), TypedValue(),
+                             TypedValue(stats.count), TypedValue(), TypedValue()});
+        }
+        return results;
+      };
+      break;
+    case AnalyzeGraphQuery::Action::DELETE_STATISTICS:
+      handler = [interpreter_context, invalidate_plan_cache = std::move(invalidate_plan_cache)] {
+        if (!interpreter_context->db->ClearGraphStatistics()) {
+          throw QueryRuntimeException("Couldn't delete the persisted graph statistics.");
+        }
+        invalidate_plan_cache();
+        return std::vector<std::vector<TypedValue>>{};
+      };
+      break;
+  }
+
+  return PreparedQuery{std::move(header), std::move(parsed_query.required_privileges),
+                       [handler = std::move(handler), pull_plan = std::shared_ptr<PullPlanVector>(nullptr)](
+                           AnyStream *stream, std::optional<int> n) mutable -> std::optional<QueryHandlerResult> {
+                         if (!pull_plan) {
+                           pull_plan = std::make_shared<PullPlanVector>(handler());
+                         }
+
+                         if (pull_plan->Pull(stream, n)) {
+                           return QueryHandlerResult::COMMIT;
+                         }
+                         return std::nullopt;
+                       },
+                       RWType::NONE};
+}
+
 PreparedQuery PrepareInfoQuery(ParsedQuery parsed_query, bool in_explicit_transaction,
                                std::map<std::string, TypedValue> *summary, InterpreterContext *interpreter_context,
                                storage::Storage *db, utils::MemoryResource *execution_memory) {
@@ -1995,6 +2171,72 @@ PreparedQuery PrepareInfoQuery(ParsedQuery parsed_query, bool in_explicit_transa
         return std::pair{results, QueryHandlerResult::NOTHING};
       };
       break;
+    case InfoQuery::InfoType::PLAN_CACHE:
+      header = {"query hash", "hits", "idle seconds", "cost", "labels", "properties"};
+      handler = [interpreter_context] {
+        auto *db = interpreter_context->db;
+        std::vector<std::vector<TypedValue>> results;
+        auto access = interpreter_context->plan_cache.access();
+        results.reserve(access.size());
+        for (const auto &[hash, plan] : access) {
+          std::vector<TypedValue> labels;
+          labels.reserve(plan->labels().size());
+          for (const auto label : plan->labels()) {
+            labels.emplace_back(db->LabelToName(label));
+          }
+          std::vector<TypedValue> properties;
+          properties.reserve(plan->properties().size());
+          for (const auto property : plan->properties()) {
+            properties.emplace_back(db->PropertyToName(property));
+          }
+          const auto idle_seconds = std::chrono::duration<double>(plan->usage().IdleTime()).count();
+          results.push_back({TypedValue(std::to_string(hash)), TypedValue(static_cast<int64_t>(plan->usage().hits())),
+                             TypedValue(idle_seconds), TypedValue(plan->cost()), TypedValue(std::move(labels)),
+                             TypedValue(std::move(properties))});
+        }
+        return std::pair{results, QueryHandlerResult::NOTHING};
+      };
+      break;
+    case InfoQuery::InfoType::QUERY_STATISTICS:
+      header = {"query hash",  "query",       "calls", "total seconds",        "max seconds",
+                "p50 seconds", "p99 seconds", "rows",  "plan cache hit ratio", "peak memory bytes"};
+      handler = [interpreter_context] {
+        const auto statistics = interpreter_context->query_statistics.Snapshot();
+        std::vector<std::vector<TypedValue>> results;
+        results.reserve(statistics.size());
+        for (const auto &[hash, entry] : statistics) {
+          const auto hit_ratio = entry.PlanCacheHitRatio();
+          results.push_back({TypedValue(std::to_string(hash)), TypedValue(entry.query), TypedValue(entry.calls),
+                             TypedValue(entry.total_latency.count()), TypedValue(entry.max_latency.count()),
+                             TypedValue(entry.LatencyPercentile(50).count()),
+                             TypedValue(entry.LatencyPercentile(99).count()), TypedValue(entry.rows),
+                             hit_ratio ? TypedValue(*hit_ratio) : TypedValue(), TypedValue(entry.peak_memory_bytes)});
+        }
+        return std::pair{results, QueryHandlerResult::NOTHING};
+      };
+      break;
+    case InfoQuery::InfoType::RESOURCE_POOLS:
+      header = {"pool",     "max concurrent queries", "memory limit bytes", "running",          "waiting",
+                "admitted", "queued",                 "timed out",          "p50 wait seconds", "p99 wait seconds",
+                "max wait seconds"};
+      handler = [interpreter_context] {
+        const auto statistics = interpreter_context->admission_controller.Statistics();
+        std::vector<std::vector<TypedValue>> results;
+        results.reserve(statistics.size());
+        for (const auto &pool : statistics) {
+          const auto wait_percentile = [&pool](const double percentile) {
+            return TypedValue(std::min(pool.wait_histogram.Percentile(percentile), pool.max_wait).count());
+          };
+          results.push_back(
+              {TypedValue(pool.config.name), TypedValue(static_cast<int64_t>(pool.config.max_concurrent_queries)),
+               pool.config.memory_limit ? TypedValue(static_cast<int64_t>(*pool.config.memory_limit)) : TypedValue(),
+               TypedValue(static_cast<int64_t>(pool.running)), TypedValue(static_cast<int64_t>(pool.waiting)),
+               TypedValue(pool.admitted), TypedValue(pool.queued), TypedValue(pool.timed_out), wait_percentile(50),
+               wait_percentile(99), TypedValue(pool.max_wait.count())});
+        }
+        return std::pair{results, QueryHandlerResult::NOTHING};
+      };
+      break;
   }
 
   return PreparedQuery{std::move(header), std::move(parsed_query.required_privileges),
@@ -2280,17 +2522,19 @@ void Interpreter::RollbackTransaction() {
   query_executions_.clear();
 }
 
-Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
-                                                const std::map<std::string, storage::PropertyValue> &params,
-                                                const std::string *username) {
+std::optional<int> Interpreter::AddQueryExecution() {
   if (!in_explicit_transaction_) {
     query_executions_.clear();
   }
 
   query_executions_.emplace_back(std::make_unique<QueryExecution>());
-  auto &query_execution = query_executions_.back();
-  std::optional<int> qid =
-      in_explicit_transaction_ ? static_cast<int>(query_executions_.size() - 1) : std::optional<int>{};
+  return in_explicit_transaction_ ? static_cast<int>(query_executions_.size() - 1) : std::optional<int>{};
+}
+
+Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
+                                                const std::map<std::string, storage::PropertyValue> &params,
+                                                const std::string *username, const bool prepare_statement) {
+  const auto qid = AddQueryExecution();
 
   // Handle transaction control queries.
 
@@ -2298,10 +2542,51 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
   const auto trimmed_query = utils::Trim(upper_case_query);
 
   if (trimmed_query == "BEGIN" || trimmed_query == "COMMIT" || trimmed_query == "ROLLBACK") {
+    auto &query_execution = query_executions_.back();
     query_execution->prepared_query.emplace(PrepareTransactionQuery(trimmed_query));
     return {query_execution->prepared_query->header, query_execution->prepared_query->privileges, qid};
   }
 
+  return PrepareQuery(query_string, params, username, qid, nullptr, prepare_statement);
+}
+
+Interpreter::PrepareResult Interpreter::PrepareStatement(const int64_t statement_id,
+                                                         const std::map<std::string, storage::PropertyValue> &params,
+                                                         const std::string *username) {
+  auto it = prepared_statements_.find(statement_id);
+  if (it == prepared_statements_.end()) {
+    throw QueryException("There is no prepared statement with id {}.", statement_id);
+  }
+  // Transaction control queries are never kept as statements, so the
+  // statement doesn't have to be checked for them.
+  const auto qid = AddQueryExecution();
+  return PrepareQuery(it->second.query_string(), params, username, qid, &it->second, false);
+}
+
+const std::string *Interpreter::PreparedStatementQuery(const int64_t statement_id) const {
+  auto it = prepared_statements_.find(statement_id);
+  return it == prepared_statements_.end() ? nullptr : &it->second.query_string();
+}
+
+std::pair<int64_t, PreparedStatement *> Interpreter::AddPreparedStatement(const ParsedQuery &parsed_query) {
+  if (auto it = prepared_statement_ids_.find(parsed_query.query_string); it != prepared_statement_ids_.end()) {
+    return {it->second, &prepared_statements_.at(it->second)};
+  }
+  if (prepared_statements_.size() >= kMaxPreparedStatements) {
+    throw QueryException("A session can't have more than {} prepared statements.", kMaxPreparedStatements);
+  }
+  const auto statement_id = next_statement_id_++;
+  auto *statement = &prepared_statements_.emplace(statement_id, PreparedStatement(parsed_query)).first->second;
+  prepared_statement_ids_.emplace(parsed_query.query_string, statement_id);
+  return {statement_id, statement};
+}
+
+Interpreter::PrepareResult Interpreter::PrepareQuery(const std::string &query_string,
+                                                     const std::map<std::string, storage::PropertyValue> &params,
+                                                     const std::string *username, const std::optional<int> qid,
+                                                     PreparedStatement *statement, const bool prepare_statement) {
+  auto &query_execution = query_executions_.back();
+
   // All queries other than transaction control queries advance the command in
   // an explicit transaction block.
   if (in_explicit_transaction_) {
@@ -2320,8 +2605,35 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
 
     utils::Timer parsing_timer;
     ParsedQuery parsed_query =
-        ParseQuery(query_string, params, &interpreter_context_->ast_cache, interpreter_context_->config.query);
-    query_execution->summary["parsing_time"] = parsing_timer.Elapsed().count();
+        statement ? statement->Parse(params)
+                  : ParseQuery(query_string, params, &interpreter_context_->ast_cache, interpreter_context_->config.query);
+    std::optional<int64_t> statement_id;
+    if (prepare_statement) {
+      std::tie(statement_id, statement) = AddPreparedStatement(parsed_query);
+    }
+    const auto parsing_time = parsing_timer.Elapsed();
+    query_execution->summary["parsing_time"] = parsing_time.count();
+    if (FLAGS_query_statistics_max_entries > 0) {
+      query_execution->statistics_key.emplace(parsed_query.stripped_query.hash(),
+                                              parsed_query.stripped_query.query());
+    }
+
+    // Queries executing a plan have to be admitted into their resource pool.
+    // They wait for it before starting a transaction, so that a waiting query
+    // doesn't hold one. An explicit transaction is admitted once, by its first
+    // such query, and its queries share the ticket until it ends. Otherwise
+    // they would wait while holding the transaction, and possibly for a slot
+    // held by the earlier queries of the same transaction.
+    std::optional<size_t> pool_memory_limit;
+    if (utils::Downcast<CypherQuery>(parsed_query.query) || utils::Downcast<ProfileQuery>(parsed_query.query)) {
+      if (in_explicit_transaction_) {
+        if (!transaction_admission_) transaction_admission_.emplace(AdmitQuery(username));
+        pool_memory_limit = transaction_admission_->memory_limit();
+      } else {
+        query_execution->admission = AdmitQuery(username);
+        pool_memory_limit = query_execution->admission.memory_limit();
+      }
+    }
 
     // Some queries require an active transaction in order to be prepared.
     if (!in_explicit_transaction_ &&
@@ -2340,18 +2652,26 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
     utils::Timer planning_timer;
     PreparedQuery prepared_query;
 
-    if (utils::Downcast<CypherQuery>(parsed_query.query)) {
+    if (auto *cypher_query = utils::Downcast<CypherQuery>(parsed_query.query)) {
+      if (in_explicit_transaction_ && HasCallInTransactions(*cypher_query)) {
+        throw CallInTransactionsInMulticommandTxException();
+      }
       prepared_query = PrepareCypherQuery(std::move(parsed_query), &query_execution->summary, interpreter_context_,
                                           &*execution_db_accessor_, &query_execution->execution_memory,
                                           &query_execution->notifications, username,
-                                          trigger_context_collector_ ? &*trigger_context_collector_ : nullptr);
+                                          &query_execution->statistics.plan_cache_hit,
+                                          &query_execution->statistics.peak_pull_memory_bytes, pool_memory_limit,
+                                          statement ? &statement->plan : nullptr,
+                                          trigger_context_collector_ ? &*trigger_context_collector_ : nullptr,
+                                          [this] { PeriodicCommit(); });
     } else if (utils::Downcast<ExplainQuery>(parsed_query.query)) {
       prepared_query = PrepareExplainQuery(std::move(parsed_query), &query_execution->summary, interpreter_context_,
                                            &*execution_db_accessor_, &query_execution->execution_memory_with_exception);
     } else if (utils::Downcast<ProfileQuery>(parsed_query.query)) {
       prepared_query = PrepareProfileQuery(std::move(parsed_query), in_explicit_transaction_, &query_execution->summary,
                                            interpreter_context_, &*execution_db_accessor_,
-                                           &query_execution->execution_memory_with_exception, username);
+                                           &query_execution->execution_memory_with_exception, username,
+                                           pool_memory_limit);
     } else if (utils::Downcast<DumpQuery>(parsed_query.query)) {
       prepared_query = PrepareDumpQuery(std::move(parsed_query), &query_execution->summary, &*execution_db_accessor_,
                                         &query_execution->execution_memory);
@@ -2398,11 +2718,15 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
       prepared_query = PrepareSettingQuery(std::move(parsed_query), in_explicit_transaction_, &*execution_db_accessor_);
     } else if (utils::Downcast<VersionQuery>(parsed_query.query)) {
       prepared_query = PrepareVersionQuery(std::move(parsed_query), in_explicit_transaction_);
+    } else if (utils::Downcast<AnalyzeGraphQuery>(parsed_query.query)) {
+      prepared_query = PrepareAnalyzeGraphQuery(std::move(parsed_query), in_explicit_transaction_, interpreter_context_);
     } else {
       LOG_FATAL("Should not get here -- unknown query type!");
     }
 
-    query_execution->summary["planning_time"] = planning_timer.Elapsed().count();
+    const auto planning_time = planning_timer.Elapsed();
+    query_execution->summary["planning_time"] = planning_time.count();
+    query_execution->statistics.latency = parsing_time + planning_time;
     query_execution->prepared_query.emplace(std::move(prepared_query));
 
     const auto rw_type = query_execution->prepared_query->rw_type;
@@ -2417,7 +2741,12 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
       throw QueryException("Write query forbidden on the replica!");
     }
 
-    return {query_execution->prepared_query->header, query_execution->prepared_query->privileges, qid};
+    return {query_execution->prepared_query->header, query_execution->prepared_query->privileges, qid, statement_id};
+  } catch (const AdmissionPendingException &) {
+    // The query is prepared again once it can be admitted, so it neither
+    // fails nor aborts the explicit transaction, and it gets the same qid.
+    query_executions_.pop_back();
+    throw;
   } catch (const utils::BasicException &) {
     EventCounter::IncrementCounter(EventCounter::FailedQuery);
     AbortCommand(&query_execution);
@@ -2425,9 +2754,16 @@ Interpreter::PrepareResult Interpreter::Prepare(const std::string &query_string,
   }
 }
 
+void Interpreter::FlushDeferredCommits() {
+  if (!commit_flush_deferred_) return;
+  interpreter_context_->db->FlushWal();
+  commit_flush_deferred_ = false;
+}
+
 void Interpreter::Abort() {
   expect_rollback_ = false;
   in_explicit_transaction_ = false;
+  transaction_admission_.reset();
   if (!db_accessor_) return;
   db_accessor_->Abort();
   execution_db_accessor_.reset();
@@ -2496,14 +2832,7 @@ void RunTriggersIndividually(const utils::SkipList<Trigger> &triggers, Interpret
 }
 }  // namespace
 
-void Interpreter::Commit() {
-  // It's possible that some queries did not finish because the user did
-  // not pull all of the results from the query.
-  // For now, we will not check if there are some unfinished queries.
-  // We should document clearly that all results should be pulled to complete
-  // a query.
-  if (!db_accessor_) return;
-
+std::optional<TriggerContext> Interpreter::RunBeforeCommitTriggers() {
   std::optional<TriggerContext> trigger_context = std::nullopt;
   if (trigger_context_collector_) {
     trigger_context.emplace(std::move(*trigger_context_collector_).TransformToTriggerContext());
@@ -2525,53 +2854,49 @@ void Interpreter::Commit() {
     }
     SPDLOG_DEBUG("Finished executing before commit triggers");
   }
+  return trigger_context;
+}
 
-  const auto reset_necessary_members = [this]() {
-    execution_db_accessor_.reset();
-    db_accessor_.reset();
-    trigger_context_collector_.reset();
-  };
-  utils::OnScopeExit members_reseter(reset_necessary_members);
-
+bool Interpreter::HandleCommitError(
+    const utils::BasicResult<storage::StorageDataManipulationError, void> &maybe_commit_error) {
+  if (!maybe_commit_error.HasError()) return true;
   auto commit_confirmed_by_all_sync_repplicas = true;
-
-  auto maybe_commit_error = db_accessor_->Commit();
-  if (maybe_commit_error.HasError()) {
-    const auto &error = maybe_commit_error.GetError();
-
-    std::visit(
-        [&execution_db_accessor = execution_db_accessor_,
-         &commit_confirmed_by_all_sync_repplicas]<typename T>(T &&arg) {
-          using ErrorType = std::remove_cvref_t<T>;
-          if constexpr (std::is_same_v<ErrorType, storage::ReplicationError>) {
-            commit_confirmed_by_all_sync_repplicas = false;
-          } else if constexpr (std::is_same_v<ErrorType, storage::ConstraintViolation>) {
-            const auto &constraint_violation = arg;
-            auto &label_name = execution_db_accessor->LabelToName(constraint_violation.label);
-            switch (constraint_violation.type) {
-              case storage::ConstraintViolation::Type::EXISTENCE: {
-                MG_ASSERT(constraint_violation.properties.size() == 1U);
-                auto &property_name = execution_db_accessor->PropertyToName(*constraint_violation.properties.begin());
-                throw QueryException("Unable to commit due to existence constraint violation on :{}({})", label_name,
-                                     property_name);
-              }
-              case storage::ConstraintViolation::Type::UNIQUE: {
-                std::stringstream property_names_stream;
-                utils::PrintIterable(property_names_stream, constraint_violation.properties, ", ",
-                                     [&execution_db_accessor](auto &stream, const auto &prop) {
-                                       stream << execution_db_accessor->PropertyToName(prop);
-                                     });
-                throw QueryException("Unable to commit due to unique constraint violation on :{}({})", label_name,
-                                     property_names_stream.str());
-              }
+  std::visit(
+      [&execution_db_accessor = execution_db_accessor_,
+       &commit_confirmed_by_all_sync_repplicas]<typename T>(T &&arg) {
+        using ErrorType = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<ErrorType, storage::ReplicationError>) {
+          commit_confirmed_by_all_sync_repplicas = false;
+        } else if constexpr (std::is_same_v<ErrorType, storage::ConstraintViolation>) {
+          const auto &constraint_violation = arg;
+          auto &label_name = execution_db_accessor->LabelToName(constraint_violation.label);
+          switch (constraint_violation.type) {
+            case storage::ConstraintViolation::Type::EXISTENCE: {
+              MG_ASSERT(constraint_violation.properties.size() == 1U);
+              auto &property_name = execution_db_accessor->PropertyToName(*constraint_violation.properties.begin());
+              throw QueryException("Unable to commit due to existence constraint violation on :{}({})", label_name,
+                                   property_name);
+            }
+            case storage::ConstraintViolation::Type::UNIQUE: {
+              std::stringstream property_names_stream;
+              utils::PrintIterable(property_names_stream, constraint_violation.properties, ", ",
+                                   [&execution_db_accessor](auto &stream, const auto &prop) {
+                                     stream << execution_db_accessor->PropertyToName(prop);
+                                   });
+              throw QueryException("Unable to commit due to unique constraint violation on :{}({})", label_name,
+                                   property_names_stream.str());
             }
-          } else {
-            static_assert(kAlwaysFalse<T>, "Missing type from variant visitor");
           }
-        },
-        error);
-  }
+        } else {
+          static_assert(kAlwaysFalse<T>, "Missing type from variant visitor");
+        }
+      },
+      maybe_commit_error.GetError());
+  return commit_confirmed_by_all_sync_repplicas;
+}
 
+void Interpreter::RunAfterCommitTriggers(std::optional<TriggerContext> trigger_context,
+                                         std::unique_ptr<storage::Storage::Accessor> user_transaction) {
   // The ordered execution of after commit triggers is heavily depending on the exclusiveness of db_accessor_->Commit():
   // only one of the transactions can be commiting at the same time, so when the commit is finished, that transaction
   // probably will schedule its after commit triggers, because the other transactions that want to commit are still
@@ -2580,13 +2905,46 @@ void Interpreter::Commit() {
   if (trigger_context && interpreter_context_->trigger_store.AfterCommitTriggers().size() > 0) {
     interpreter_context_->after_commit_trigger_pool.AddTask(
         [trigger_context = std::move(*trigger_context), interpreter_context = this->interpreter_context_,
-         user_transaction = std::shared_ptr(std::move(db_accessor_))]() mutable {
+         user_transaction = std::shared_ptr(std::move(user_transaction))]() mutable {
           RunTriggersIndividually(interpreter_context->trigger_store.AfterCommitTriggers(), interpreter_context,
                                   std::move(trigger_context));
           user_transaction->FinalizeTransaction();
           SPDLOG_DEBUG("Finished executing after commit triggers");  // NOLINT(bugprone-lambda-function-name)
         });
   }
+}
+
+void Interpreter::Commit() {
+  // It's possible that some queries did not finish because the user did
+  // not pull all of the results from the query.
+  // For now, we will not check if there are some unfinished queries.
+  // We should document clearly that all results should be pulled to complete
+  // a query.
+  if (!db_accessor_) return;
+
+  auto trigger_context = RunBeforeCommitTriggers();
+
+  const auto reset_necessary_members = [this]() {
+    execution_db_accessor_.reset();
+    db_accessor_.reset();
+    trigger_context_collector_.reset();
+  };
+  utils::OnScopeExit members_reseter(reset_necessary_members);
+
+  if (defer_commit_flush_) {
+    db_accessor_->DeferWalFlush();
+    commit_flush_deferred_ = true;
+  }
+  auto maybe_commit_error = db_accessor_->Commit();
+  // A commit which wrote the WAL also wrote the buffer left by the deferred
+  // ones. A read-only transaction doesn't write it, so they still have to be
+  // flushed.
+  if (db_accessor_->WalFlushed()) {
+    commit_flush_deferred_ = false;
+  }
+  const auto commit_confirmed_by_all_sync_repplicas = HandleCommitError(maybe_commit_error);
+
+  RunAfterCommitTriggers(std::move(trigger_context), std::move(db_accessor_));
 
   SPDLOG_DEBUG("Finished committing the transaction");
   if (!commit_confirmed_by_all_sync_repplicas) {
@@ -2594,6 +2952,31 @@ void Interpreter::Commit() {
   }
 }
 
+void Interpreter::PeriodicCommit() {
+  MG_ASSERT(db_accessor_, "Periodic commit without an active transaction");
+  const bool collects_triggers = trigger_context_collector_.has_value();
+  auto trigger_context = RunBeforeCommitTriggers();
+  // The next batch fires the triggers as well. The collector is recreated in
+  // place, so the running query keeps a valid pointer to it.
+  if (collects_triggers) {
+    trigger_context_collector_.emplace(interpreter_context_->trigger_store.GetEventTypes());
+  }
+
+  // The after commit triggers need the committed batch until they finish.
+  std::unique_ptr<storage::Storage::Accessor> committed_batch;
+  const bool keep_committed_batch =
+      trigger_context && interpreter_context_->trigger_store.AfterCommitTriggers().size() > 0;
+  const auto commit_confirmed_by_all_sync_repplicas =
+      HandleCommitError(db_accessor_->PeriodicCommit(keep_committed_batch ? &committed_batch : nullptr));
+
+  RunAfterCommitTriggers(std::move(trigger_context), std::move(committed_batch));
+
+  SPDLOG_DEBUG("Finished committing a batch of the transaction");
+  if (!commit_confirmed_by_all_sync_repplicas) {
+    throw ReplicationException("At least one SYNC replica has not confirmed committing last batch.");
+  }
+}
+
 void Interpreter::AdvanceCommand() {
   if (!db_accessor_) return;
   db_accessor_->AdvanceCommand();
@@ -2610,6 +2993,64 @@ void Interpreter::AbortCommand(std::unique_ptr<QueryExecution> *query_execution)
   }
 }
 
+AdmissionController::Ticket Interpreter::AdmitQuery(const std::string *username) {
+  auto &admission_controller = interpreter_context_->admission_controller;
+  if (!admission_controller.Enabled()) return {};
+  // Waiting for admission counts towards the execution timeout, and it's
+  // capped even without one.
+  const auto now = std::chrono::steady_clock::now();
+  auto deadline = now + std::chrono::seconds(FLAGS_query_admission_timeout_sec);
+  if (const auto timeout_sec = interpreter_context_->config.execution_timeout_sec; timeout_sec > 0) {
+    deadline = std::min(deadline, now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                            std::chrono::duration<double>(timeout_sec)));
+  }
+  auto get_rolename = [this, username]() -> std::optional<std::string> {
+    if (!interpreter_context_->auth) return std::nullopt;
+    try {
+      return interpreter_context_->auth->GetRolenameForUser(*username);
+    } catch (const QueryRuntimeException &) {
+      // Users authenticated by an auth module don't have to exist locally.
+      return std::nullopt;
+    }
+  };
+  if (!non_blocking_admission_) {
+    return admission_controller.Admit(username, get_rolename, deadline, &interpreter_context_->is_shutting_down);
+  }
+  if (!pending_admission_) {
+    auto result =
+        admission_controller.TryAdmit(username, get_rolename, deadline, &interpreter_context_->is_shutting_down);
+    if (auto *ticket = std::get_if<AdmissionController::Ticket>(&result)) return std::move(*ticket);
+    pending_admission_.emplace(std::get<AdmissionController::PendingAdmission>(std::move(result)));
+    throw AdmissionPendingException();
+  }
+  // The query is prepared again after it stopped waiting.
+  auto pending = std::move(*pending_admission_);
+  pending_admission_.reset();
+  auto ticket = admission_controller.TakeTicket(&pending);
+  if (!ticket) {
+    pending_admission_.emplace(std::move(pending));
+    throw AdmissionPendingException();
+  }
+  return std::move(*ticket);
+}
+
+void Interpreter::AwaitAdmission(std::function<void()> on_ready) {
+  if (!pending_admission_) {
+    on_ready();
+    return;
+  }
+  pending_admission_->OnReady(std::move(on_ready));
+}
+
+void Interpreter::RecordQueryStatistics(QueryExecution *query_execution) {
+  if (!query_execution->statistics_key) return;
+  query_execution->statistics.peak_memory_bytes =
+      static_cast<int64_t>(query_execution->execution_memory.GetUpstreamAllocatedBytes()) +
+      query_execution->statistics.peak_pull_memory_bytes;
+  const auto &[hash, stripped_query] = *query_execution->statistics_key;
+  interpreter_context_->query_statistics.Record(hash, stripped_query, query_execution->statistics);
+}
+
 std::optional<storage::IsolationLevel> Interpreter::GetIsolationLevelOverride() {
   if (next_transaction_isolation_level) {
     const auto isolation_level = *next_transaction_isolation_level;
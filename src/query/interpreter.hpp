@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -13,6 +13,7 @@
 
 #include <gflags/gflags.h>
 
+#include "query/admission_control.hpp"
 #include "query/auth_checker.hpp"
 #include "query/config.hpp"
 #include "query/context.hpp"
@@ -26,6 +27,7 @@
 #include "query/metadata.hpp"
 #include "query/plan/operator.hpp"
 #include "query/plan/read_write_type_checker.hpp"
+#include "query/query_statistics.hpp"
 #include "query/stream.hpp"
 #include "query/stream/streams.hpp"
 #include "query/trigger.hpp"
@@ -149,6 +151,8 @@ class ReplicationQueryHandler {
     uint64_t current_timestamp_of_replica;
     uint64_t current_number_of_timestamp_behind_master;
     ReplicationQuery::ReplicaState state;
+    uint64_t queued_transactions;
+    uint64_t queue_lag_ms;
   };
 
   /// @throw QueryRuntimeException if an error ocurred.
@@ -208,6 +212,10 @@ struct InterpreterContext {
   utils::SkipList<QueryCacheEntry> ast_cache;
   utils::SkipList<PlanCacheEntry> plan_cache;
 
+  QueryStatisticsRegistry query_statistics;
+
+  AdmissionController admission_controller;
+
   TriggerStore trigger_store;
   utils::ThreadPool after_commit_trigger_pool{1};
 
@@ -233,6 +241,8 @@ class Interpreter final {
     std::vector<std::string> headers;
     std::vector<query::AuthQuery::Privilege> privileges;
     std::optional<int> qid;
+    // Set when the query was kept as a prepared statement.
+    std::optional<int64_t> statement_id;
   };
 
   /**
@@ -241,10 +251,29 @@ class Interpreter final {
    * Preparing a query means to preprocess the query and save it for
    * future calls of `Pull`.
    *
+   * @param prepare_statement If set, the parsed query is also kept as a
+   * prepared statement of the session, which can be executed again with
+   * `PrepareStatement` without parsing the query. Preparing the same query
+   * again returns the same statement.
+   *
    * @throw query::QueryException
    */
   PrepareResult Prepare(const std::string &query, const std::map<std::string, storage::PropertyValue> &params,
-                        const std::string *username);
+                        const std::string *username, bool prepare_statement = false);
+
+  /**
+   * Prepare a prepared statement for execution with the given `params`. The
+   * query isn't stripped nor looked up in the AST cache, and the plan of the
+   * previous execution is reused while it is valid.
+   *
+   * @throw query::QueryException
+   */
+  PrepareResult PrepareStatement(int64_t statement_id, const std::map<std::string, storage::PropertyValue> &params,
+                                 const std::string *username);
+
+  /// Returns the query of the prepared statement, nullptr if there is no
+  /// such statement.
+  const std::string *PreparedStatementQuery(int64_t statement_id) const;
 
   /**
    * Execute the last prepared query and stream *all* of the results into the
@@ -297,6 +326,22 @@ class Interpreter final {
   void SetNextTransactionIsolationLevel(storage::IsolationLevel isolation_level);
   void SetSessionIsolationLevel(storage::IsolationLevel isolation_level);
 
+  /// While set, a query which has to wait for admission into its resource
+  /// pool doesn't block the thread. `Prepare` throws
+  /// `AdmissionPendingException` instead, and has to be called again with the
+  /// same query once the callback given to `AwaitAdmission` is called.
+  void SetNonBlockingAdmission(bool non_blocking) { non_blocking_admission_ = non_blocking; }
+  /// Calls `on_ready`, possibly right away and from another thread, once the
+  /// query which is waiting for admission can be prepared again.
+  void AwaitAdmission(std::function<void()> on_ready);
+  bool IsAdmissionPending() const { return pending_admission_.has_value(); }
+
+  /// While set, the commits don't write the WAL, which is done for all of
+  /// them at once by `FlushDeferredCommits`. Used for the queries pipelined
+  /// by a client, which are acknowledged together.
+  void SetDeferCommitFlush(bool defer) { defer_commit_flush_ = defer; }
+  void FlushDeferredCommits();
+
   /**
    * Abort the current multicommand transaction.
    */
@@ -311,6 +356,15 @@ class Interpreter final {
     std::map<std::string, TypedValue> summary;
     std::vector<Notification> notifications;
 
+    // The stripped query and its hash under which the statistics of this
+    // execution are recorded once it finishes. Not set for the queries which
+    // aren't recorded.
+    std::optional<std::pair<uint64_t, std::string>> statistics_key;
+    QueryExecutionStatistics statistics;
+
+    // Slot of the query in its resource pool, held until the query finishes.
+    AdmissionController::Ticket admission;
+
     explicit QueryExecution() = default;
     QueryExecution(const QueryExecution &) = delete;
     QueryExecution(QueryExecution &&) = default;
@@ -349,14 +403,45 @@ class Interpreter final {
   std::optional<TriggerContextCollector> trigger_context_collector_;
   bool in_explicit_transaction_{false};
   bool expect_rollback_{false};
+  // Admission of the current explicit transaction, shared by its queries.
+  std::optional<AdmissionController::Ticket> transaction_admission_;
+  bool non_blocking_admission_{false};
+  // Set while the query which is prepared next waits for admission.
+  std::optional<AdmissionController::PendingAdmission> pending_admission_;
 
   std::optional<storage::IsolationLevel> interpreter_isolation_level;
   std::optional<storage::IsolationLevel> next_transaction_isolation_level;
 
+  // Prepared statements of the session by their ids, and their ids by the
+  // query, so a query which is prepared again gets the existing statement.
+  std::unordered_map<int64_t, PreparedStatement> prepared_statements_;
+  std::unordered_map<std::string, int64_t> prepared_statement_ids_;
+  int64_t next_statement_id_{0};
+
+  bool defer_commit_flush_{false};
+  // Whether some commit didn't write the WAL since the last flush.
+  bool commit_flush_deferred_{false};
+
+  std::optional<int> AddQueryExecution();
+  PrepareResult PrepareQuery(const std::string &query_string, const std::map<std::string, storage::PropertyValue> &params,
+                             const std::string *username, std::optional<int> qid, PreparedStatement *statement,
+                             bool prepare_statement);
+  std::pair<int64_t, PreparedStatement *> AddPreparedStatement(const ParsedQuery &parsed_query);
   PreparedQuery PrepareTransactionQuery(std::string_view query_upper);
+  std::optional<TriggerContext> RunBeforeCommitTriggers();
+  /// Throws if the commit failed. Returns false if the transaction was
+  /// committed, but some SYNC replica didn't confirm it.
+  bool HandleCommitError(const utils::BasicResult<storage::StorageDataManipulationError, void> &maybe_commit_error);
+  void RunAfterCommitTriggers(std::optional<TriggerContext> trigger_context,
+                              std::unique_ptr<storage::Storage::Accessor> user_transaction);
   void Commit();
+  /// Commits the transaction so far and continues in a new one, for
+  /// `CALL { ... } IN TRANSACTIONS`.
+  void PeriodicCommit();
   void AdvanceCommand();
   void AbortCommand(std::unique_ptr<QueryExecution> *query_execution);
+  void RecordQueryStatistics(QueryExecution *query_execution);
+  AdmissionController::Ticket AdmitQuery(const std::string *username);
   std::optional<storage::IsolationLevel> GetIsolationLevelOverride();
 
   size_t ActiveQueryExecutions() {
@@ -391,7 +476,10 @@ std::map<std::string, TypedValue> Interpreter::Pull(TStream *result_stream, std:
     // Wrap the (statically polymorphic) stream type into a common type which
     // the handler knows.
     AnyStream stream{result_stream, &query_execution->execution_memory};
+    utils::Timer pull_timer;
     const auto maybe_res = query_execution->prepared_query->query_handler(&stream, n);
+    query_execution->statistics.latency += pull_timer.Elapsed();
+    query_execution->statistics.rows += stream.results_count();
     // Stream is using execution memory of the query_execution which
     // can be deleted after its execution so the stream should be cleared
     // first.
@@ -411,6 +499,7 @@ std::map<std::string, TypedValue> Interpreter::Pull(TStream *result_stream, std:
         maybe_summary->insert_or_assign("notifications", std::move(notifications));
       }
       if (!in_explicit_transaction_) {
+        utils::Timer commit_timer;
         switch (*maybe_res) {
           case QueryHandlerResult::COMMIT:
             Commit();
@@ -425,12 +514,15 @@ std::map<std::string, TypedValue> Interpreter::Pull(TStream *result_stream, std:
             MG_ASSERT(in_explicit_transaction_ || !db_accessor_);
             break;
         }
+        query_execution->statistics.latency += commit_timer.Elapsed();
+        RecordQueryStatistics(query_execution.get());
         // As the transaction is done we can clear all the executions
         // NOTE: we cannot clear query_execution inside the Abort and Commit
         // methods as we will delete summary contained in them which we need
         // after our query finished executing.
         query_executions_.clear();
       } else {
+        RecordQueryStatistics(query_execution.get());
         // We can only clear this execution as some of the queries
         // in the transaction can be in unfinished state
         query_execution.reset(nullptr);
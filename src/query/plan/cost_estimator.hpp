@@ -11,10 +11,15 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "query/frontend/ast/ast.hpp"
 #include "query/parameters.hpp"
 #include "query/plan/operator.hpp"
 #include "query/typed_value.hpp"
+#include "storage/v2/statistics.hpp"
 
 namespace memgraph::query::plan {
 
@@ -46,6 +51,10 @@ namespace memgraph::query::plan {
  * It's aim is to estimate cost(A) to be less then cost(B) in every case where
  * actual query execution for plan A is less then that of plan B. It can NOT be
  * used to estimate how MUCH execution between A and B will differ.
+ *
+ * When the graph statistics were collected (`ANALYZE GRAPH`), they are used
+ * instead of the constant parameters for expansions, filters on properties and
+ * labels, and property value lookups with values unknown at planning time.
  */
 template <class TDbAccessor>
 class CostEstimator : public HierarchicalLogicalOperatorVisitor {
@@ -53,6 +62,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   struct CostParam {
     static constexpr double kScanAll{1.0};
     static constexpr double kScanAllByLabel{1.1};
+    static constexpr double kScanAllById{1.0};
     static constexpr double MakeScanAllByLabelPropertyValue{1.1};
     static constexpr double MakeScanAllByLabelPropertyRange{1.1};
     static constexpr double MakeScanAllByLabelProperty{1.1};
@@ -80,7 +90,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   using HierarchicalLogicalOperatorVisitor::PreVisit;
 
   CostEstimator(TDbAccessor *db_accessor, const Parameters &parameters)
-      : db_accessor_(db_accessor), parameters(parameters) {}
+      : db_accessor_(db_accessor), parameters(parameters), statistics_(db_accessor->GetGraphStatistics()) {}
 
   bool PostVisit(ScanAll &) override {
     cardinality_ *= db_accessor_->VerticesCount();
@@ -91,6 +101,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
 
   bool PostVisit(ScanAllByLabel &scan_all_by_label) override {
     cardinality_ *= db_accessor_->VerticesCount(scan_all_by_label.label_);
+    labels_[scan_all_by_label.output_symbol_.position()] = scan_all_by_label.label_;
     // ScanAll performs some work for every element that is produced
     IncrementCost(CostParam::kScanAllByLabel);
     return true;
@@ -102,14 +113,19 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     // we estimate
     auto property_value = ConstPropertyValue(logical_op.expression_);
     double factor = 1.0;
+    const auto *stats = GetLabelPropertyStats(logical_op.label_, logical_op.property_);
     if (property_value)
       // get the exact influence based on ScanAll(label, property, value)
       factor = db_accessor_->VerticesCount(logical_op.label_, logical_op.property_, property_value.value());
+    else if (stats)
+      // on average this many vertices share the same property value
+      factor = stats->avg_group_size;
     else
       // estimate the influence as ScanAll(label, property) * filtering
       factor = db_accessor_->VerticesCount(logical_op.label_, logical_op.property_) * CardParam::kFilter;
 
     cardinality_ *= factor;
+    labels_[logical_op.output_symbol_.position()] = logical_op.label_;
 
     // ScanAll performs some work for every element that is produced
     IncrementCost(CostParam::MakeScanAllByLabelPropertyValue);
@@ -135,6 +151,7 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     if ((logical_op.upper_bound_ && !upper) || (logical_op.lower_bound_ && !lower)) factor *= CardParam::kFilter;
 
     cardinality_ *= factor;
+    labels_[logical_op.output_symbol_.position()] = logical_op.label_;
 
     // ScanAll performs some work for every element that is produced
     IncrementCost(CostParam::MakeScanAllByLabelPropertyRange);
@@ -144,11 +161,22 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   bool PostVisit(ScanAllByLabelProperty &logical_op) override {
     const auto factor = db_accessor_->VerticesCount(logical_op.label_, logical_op.property_);
     cardinality_ *= factor;
+    labels_[logical_op.output_symbol_.position()] = logical_op.label_;
     IncrementCost(CostParam::MakeScanAllByLabelProperty);
     return true;
   }
 
-  // TODO: Cost estimate ScanAllById?
+  bool PostVisit(ScanAllById &) override {
+    // at most a single vertex is produced, so the cardinality stays the same
+    IncrementCost(CostParam::kScanAllById);
+    return true;
+  }
+
+  bool PostVisit(Expand &expand) override {
+    cardinality_ *= ExpandFactor(expand);
+    IncrementCost(CostParam::kExpand);
+    return true;
+  }
 
 // For the given op first increments the cardinality and then cost.
 #define POST_VISIT_CARD_FIRST(NAME)     \
@@ -158,11 +186,16 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     return true;                        \
   }
 
-  POST_VISIT_CARD_FIRST(Expand);
   POST_VISIT_CARD_FIRST(ExpandVariable);
 
 #undef POST_VISIT_CARD_FIRST
 
+  bool PostVisit(Filter &filter) override {
+    IncrementCost(CostParam::kFilter);
+    cardinality_ *= FilterSelectivity(filter.expression_);
+    return true;
+  }
+
 // For the given op first increments the cost and then cardinality.
 #define POST_VISIT_COST_FIRST(LOGICAL_OP, PARAM_NAME) \
   bool PostVisit(LOGICAL_OP &) override {             \
@@ -171,7 +204,6 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     return true;                                      \
   }
 
-  POST_VISIT_COST_FIRST(Filter, kFilter)
   POST_VISIT_COST_FIRST(EdgeUniquenessFilter, kEdgeUniquenessFilter);
 
 #undef POST_VISIT_COST_FIRST
@@ -182,16 +214,14 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     // for that reason first increment cost, then modify cardinality
     IncrementCost(CostParam::kUnwind);
 
-    // try to determine how many values will be yielded by Unwind
-    // if the Unwind expression is a list literal, we can deduce cardinality
-    // exactly, otherwise we approximate
-    double unwind_value;
-    if (auto *literal = utils::Downcast<query::ListLiteral>(unwind.input_expression_))
-      unwind_value = literal->elements_.size();
-    else
-      unwind_value = MiscParam::kUnwindNoLiteral;
+    cardinality_ *= UnwindCardinality(unwind.input_expression_);
+    return true;
+  }
 
-    cardinality_ *= unwind_value;
+  bool PostVisit(UnwindCreateNode &unwind) override {
+    // Creating the nodes doesn't add to the cost, same as with CreateNode.
+    IncrementCost(CostParam::kUnwind);
+    cardinality_ *= UnwindCardinality(unwind.input_expression_);
     return true;
   }
 
@@ -212,6 +242,30 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     return true;
   }
 
+  bool PreVisit(SemiApply &op) override {
+    op.input()->Accept(*this);
+    // The subplan is executed once for every input row, but it starts from a
+    // single row, so estimate it separately.
+    CostEstimator<TDbAccessor> subplan_estimator(db_accessor_, parameters);
+    op.subplan_->Accept(subplan_estimator);
+    IncrementCost(subplan_estimator.cost());
+    cardinality_ *= CardParam::kFilter;
+    return false;
+  }
+
+  bool PreVisit(Apply &op) override {
+    op.input()->Accept(*this);
+    // The subquery is executed once for every input row, starting from that
+    // single row.
+    CostEstimator<TDbAccessor> subquery_estimator(db_accessor_, parameters);
+    op.subquery_->Accept(subquery_estimator);
+    IncrementCost(subquery_estimator.cost());
+    if (op.subquery_has_return_) {
+      cardinality_ *= subquery_estimator.cardinality();
+    }
+    return false;
+  }
+
   bool Visit(Once &) override { return true; }
 
   auto cost() const { return cost_; }
@@ -230,8 +284,22 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
   TDbAccessor *db_accessor_;
   const Parameters &parameters;
 
+  // statistics collected with ANALYZE GRAPH, nullptr if there are none
+  std::shared_ptr<const storage::GraphStatistics> statistics_;
+
+  // labels of the symbols produced by label scans, keyed by symbol position
+  std::unordered_map<int32_t, storage::LabelId> labels_;
+
   void IncrementCost(double param) { cost_ += param * cardinality_; }
 
+  // try to determine how many values will be yielded by Unwind
+  // if the Unwind expression is a list literal, we can deduce cardinality
+  // exactly, otherwise we approximate
+  static double UnwindCardinality(Expression *input_expression) {
+    if (auto *literal = utils::Downcast<query::ListLiteral>(input_expression)) return literal->elements_.size();
+    return MiscParam::kUnwindNoLiteral;
+  }
+
   // converts an optional ScanAll range bound into a property value
   // if the bound is present and is a constant expression convertible to
   // a property value. otherwise returns nullopt
@@ -254,6 +322,141 @@ class CostEstimator : public HierarchicalLogicalOperatorVisitor {
     }
     return std::nullopt;
   }
+
+  const storage::LabelPropertyStats *GetLabelPropertyStats(storage::LabelId label, storage::PropertyId property) const {
+    if (!statistics_) return nullptr;
+    return statistics_->GetLabelPropertyStats(label, property);
+  }
+
+  // Estimates the number of edges expanded from a single vertex. When the
+  // label of the input vertex is known, its average degree in the expanded
+  // direction is used, scaled by the share of the expanded edge types among
+  // all edges. Otherwise the edges of the expanded types are spread evenly
+  // over all vertices. Falls back to CardParam::kExpand if there are no
+  // statistics or some of the edge types weren't analyzed.
+  double ExpandFactor(const Expand &expand) const {
+    if (!statistics_ || statistics_->vertices_count == 0) return CardParam::kExpand;
+    const auto &common = expand.common_;
+    double edges_count = statistics_->edges_count;
+    if (!common.edge_types.empty()) {
+      edges_count = 0;
+      for (const auto edge_type : common.edge_types) {
+        const auto *stats = statistics_->GetEdgeTypeStats(edge_type);
+        if (!stats) return CardParam::kExpand;
+        edges_count += stats->count;
+      }
+    }
+
+    if (auto found = labels_.find(expand.input_symbol_.position()); found != labels_.end()) {
+      if (const auto *stats = statistics_->GetLabelStats(found->second)) {
+        if (statistics_->edges_count == 0) return 0;
+        double degree = 0;
+        if (common.direction != EdgeAtom::Direction::IN) degree += stats->avg_out_degree;
+        if (common.direction != EdgeAtom::Direction::OUT) degree += stats->avg_in_degree;
+        return degree * edges_count / statistics_->edges_count;
+      }
+    }
+
+    const double directions = common.direction == EdgeAtom::Direction::BOTH ? 2.0 : 1.0;
+    return directions * edges_count / statistics_->vertices_count;
+  }
+
+  // Estimates the selectivity of a filter expression. Conjuncts on labels and
+  // on properties of vertices with known labels are estimated from the graph
+  // statistics, the rest of the expression is estimated as CardParam::kFilter.
+  double FilterSelectivity(Expression *expression) {
+    if (!statistics_) return CardParam::kFilter;
+    std::vector<Expression *> conjuncts;
+    SplitConjuncts(expression, &conjuncts);
+    // labels tests may tell us the label of a vertex used in property filters
+    std::vector<std::optional<double>> estimates;
+    estimates.reserve(conjuncts.size());
+    for (auto *conjunct : conjuncts) estimates.push_back(LabelsTestSelectivity(conjunct));
+    double selectivity = 1.0;
+    bool unknown_conjuncts = false;
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+      if (!estimates[i]) estimates[i] = PropertyFilterSelectivity(conjuncts[i]);
+      if (estimates[i]) {
+        selectivity *= *estimates[i];
+      } else {
+        unknown_conjuncts = true;
+      }
+    }
+    if (unknown_conjuncts) selectivity *= CardParam::kFilter;
+    return selectivity;
+  }
+
+  static void SplitConjuncts(Expression *expression, std::vector<Expression *> *conjuncts) {
+    if (auto *and_op = utils::Downcast<AndOperator>(expression)) {
+      SplitConjuncts(and_op->expression1_, conjuncts);
+      SplitConjuncts(and_op->expression2_, conjuncts);
+    } else {
+      conjuncts->push_back(expression);
+    }
+  }
+
+  std::optional<double> LabelsTestSelectivity(Expression *expression) {
+    auto *labels_test = utils::Downcast<LabelsTest>(expression);
+    if (!labels_test || statistics_->vertices_count == 0) return std::nullopt;
+    auto *identifier = utils::Downcast<Identifier>(labels_test->expression_);
+    if (!identifier) return std::nullopt;
+    double selectivity = 1.0;
+    for (const auto &label_ix : labels_test->labels_) {
+      const auto label = db_accessor_->NameToLabel(label_ix.name);
+      const auto *stats = statistics_->GetLabelStats(label);
+      // A label missing from the statistics may have been added since they
+      // were collected, so it's estimated like any other filter.
+      selectivity *= stats ? static_cast<double>(stats->count) / statistics_->vertices_count : CardParam::kFilter;
+      labels_.emplace(identifier->symbol_pos_, label);
+    }
+    return selectivity;
+  }
+
+  // Estimates filters of the form `n.prop <op> value`, where `n` is a vertex
+  // with a known label and `value` is known at planning time.
+  std::optional<double> PropertyFilterSelectivity(Expression *expression) {
+    auto *binary_op = utils::Downcast<BinaryOperator>(expression);
+    if (!binary_op) return std::nullopt;
+    auto *lookup = utils::Downcast<PropertyLookup>(binary_op->expression1_);
+    auto value = ConstPropertyValue(binary_op->expression2_);
+    // `value <op> n.prop` is the same as `n.prop <reversed op> value`
+    bool reversed = false;
+    if (!lookup || !value) {
+      lookup = utils::Downcast<PropertyLookup>(binary_op->expression2_);
+      value = ConstPropertyValue(binary_op->expression1_);
+      reversed = true;
+    }
+    if (!lookup || !value) return std::nullopt;
+    auto *identifier = utils::Downcast<Identifier>(lookup->expression_);
+    if (!identifier) return std::nullopt;
+    auto found = labels_.find(identifier->symbol_pos_);
+    if (found == labels_.end()) return std::nullopt;
+    const auto label = found->second;
+    const auto *label_stats = statistics_->GetLabelStats(label);
+    const auto *stats = GetLabelPropertyStats(label, db_accessor_->NameToProperty(lookup->property_.name));
+    if (!label_stats || !stats || label_stats->count == 0) return std::nullopt;
+
+    auto bound = [&](auto type) { return std::make_optional(utils::Bound<storage::PropertyValue>(*value, type)); };
+    double count = 0;
+    if (utils::Downcast<EqualOperator>(expression)) {
+      count = stats->histogram.EstimateEqual(*value);
+    } else if (utils::Downcast<LessOperator>(expression)) {
+      count = reversed ? stats->histogram.EstimateRange(bound(utils::BoundType::EXCLUSIVE), std::nullopt)
+                       : stats->histogram.EstimateRange(std::nullopt, bound(utils::BoundType::EXCLUSIVE));
+    } else if (utils::Downcast<LessEqualOperator>(expression)) {
+      count = reversed ? stats->histogram.EstimateRange(bound(utils::BoundType::INCLUSIVE), std::nullopt)
+                       : stats->histogram.EstimateRange(std::nullopt, bound(utils::BoundType::INCLUSIVE));
+    } else if (utils::Downcast<GreaterOperator>(expression)) {
+      count = reversed ? stats->histogram.EstimateRange(std::nullopt, bound(utils::BoundType::EXCLUSIVE))
+                       : stats->histogram.EstimateRange(bound(utils::BoundType::EXCLUSIVE), std::nullopt);
+    } else if (utils::Downcast<GreaterEqualOperator>(expression)) {
+      count = reversed ? stats->histogram.EstimateRange(std::nullopt, bound(utils::BoundType::INCLUSIVE))
+                       : stats->histogram.EstimateRange(bound(utils::BoundType::INCLUSIVE), std::nullopt);
+    } else {
+      return std::nullopt;
+    }
+    return count / label_stats->count;
+  }
 };
 
 /** Returns the estimated cost of the given plan. */
@@ -12,11 +12,17 @@
 #include "query/plan/operator.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <compare>
 #include <cstdint>
+#include <latch>
 #include <limits>
 #include <queue>
 #include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
@@ -59,6 +65,7 @@
 #include "utils/readable_size.hpp"
 #include "utils/string.hpp"
 #include "utils/temporal.hpp"
+#include "utils/thread_pool.hpp"
 
 // macro for the default implementation of LogicalOperator::Accept
 // that accepts the visitor and visits it's input_ operator
@@ -82,6 +89,7 @@
 namespace EventCounter {
 extern const Event OnceOperator;
 extern const Event CreateNodeOperator;
+extern const Event UnwindCreateNodeOperator;
 extern const Event CreateExpandOperator;
 extern const Event ScanAllOperator;
 extern const Event ScanAllByLabelOperator;
@@ -103,11 +111,15 @@ extern const Event RemoveLabelsOperator;
 extern const Event EdgeUniquenessFilterOperator;
 extern const Event AccumulateOperator;
 extern const Event AggregateOperator;
+extern const Event AggregateFromIndexOperator;
 extern const Event SkipOperator;
 extern const Event LimitOperator;
 extern const Event OrderByOperator;
 extern const Event MergeOperator;
+extern const Event MergeByLabelPropertyOperator;
 extern const Event OptionalOperator;
+extern const Event SemiApplyOperator;
+extern const Event ApplyOperator;
 extern const Event UnwindOperator;
 extern const Event DistinctOperator;
 extern const Event UnionOperator;
@@ -180,12 +192,39 @@ void Once::OnceCursor::Reset() { did_pull_ = false; }
 CreateNode::CreateNode(const std::shared_ptr<LogicalOperator> &input, const NodeCreationInfo &node_info)
     : input_(input ? input : std::make_shared<Once>()), node_info_(node_info) {}
 
-// Creates a vertex on this GraphDb. Returns a reference to vertex placed on the
-// frame.
-VertexAccessor &CreateLocalVertex(const NodeCreationInfo &node_info, Frame *frame, ExecutionContext &context) {
+namespace {
+
+// Evaluates the properties of a node or an edge which is being created, so
+// that they can all be set on the new object at once.
+std::map<storage::PropertyId, storage::PropertyValue> EvaluateCreationProperties(
+    const std::variant<PropertiesMapList, ParameterLookup *> &properties, ExpressionEvaluator *evaluator,
+    DbAccessor *dba) {
+  std::map<storage::PropertyId, storage::PropertyValue> evaluated;
+  auto add_property = [&evaluated](storage::PropertyId key, const TypedValue &value) {
+    try {
+      evaluated.insert_or_assign(key, storage::PropertyValue(value));
+    } catch (const TypedValueException &) {
+      throw QueryRuntimeException("'{}' cannot be used as a property value.", value.type());
+    }
+  };
+  if (const auto *properties_list = std::get_if<PropertiesMapList>(&properties)) {
+    for (const auto &[key, value_expression] : *properties_list) {
+      add_property(key, value_expression->Accept(*evaluator));
+    }
+  } else {
+    auto property_map = evaluator->Visit(*std::get<ParameterLookup *>(properties));
+    for (const auto &[key, value] : property_map.ValueMap()) {
+      add_property(dba->NameToProperty(key), value);
+    }
+  }
+  return evaluated;
+}
+
+// Sets the labels and the properties of a newly created vertex and places it
+// on the frame. Returns a reference to the vertex placed on the frame.
+VertexAccessor &InitLocalVertex(const NodeCreationInfo &node_info, VertexAccessor new_node, Frame *frame,
+                                ExecutionContext &context) {
   auto &dba = *context.db_accessor;
-  auto new_node = dba.InsertVertex();
-  context.execution_stats[ExecutionStats::Key::CREATED_NODES] += 1;
   for (auto label : node_info.labels) {
     auto maybe_error = new_node.AddLabel(label);
     if (maybe_error.HasError()) {
@@ -206,24 +245,27 @@ VertexAccessor &CreateLocalVertex(const NodeCreationInfo &node_info, Frame *fram
   // setting properties on new nodes.
   ExpressionEvaluator evaluator(frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                 storage::View::NEW);
-  // TODO: PropsSetChecked allocates a PropertyValue, make it use context.memory
-  // when we update PropertyValue with custom allocator.
-  if (const auto *node_info_properties = std::get_if<PropertiesMapList>(&node_info.properties)) {
-    for (const auto &[key, value_expression] : *node_info_properties) {
-      PropsSetChecked(&new_node, key, value_expression->Accept(evaluator));
-    }
-  } else {
-    auto property_map = evaluator.Visit(*std::get<ParameterLookup *>(node_info.properties));
-    for (const auto &[key, value] : property_map.ValueMap()) {
-      auto property_id = dba.NameToProperty(key);
-      PropsSetChecked(&new_node, property_id, value);
-    }
+  // TODO: PropertyValue doesn't use context.memory, make it do so when we
+  // update PropertyValue with custom allocator.
+  auto properties = EvaluateCreationProperties(node_info.properties, &evaluator, &dba);
+  if (!properties.empty()) {
+    MultiPropsInitChecked(&new_node, properties);
   }
 
   (*frame)[node_info.symbol] = new_node;
   return (*frame)[node_info.symbol].ValueVertex();
 }
 
+}  // namespace
+
+// Creates a vertex on this GraphDb. Returns a reference to vertex placed on the
+// frame.
+VertexAccessor &CreateLocalVertex(const NodeCreationInfo &node_info, Frame *frame, ExecutionContext &context) {
+  auto new_node = context.db_accessor->InsertVertex();
+  context.execution_stats[ExecutionStats::Key::CREATED_NODES] += 1;
+  return InitLocalVertex(node_info, new_node, frame, context);
+}
+
 ACCEPT_WITH_INPUT(CreateNode)
 
 UniqueCursorPtr CreateNode::MakeCursor(utils::MemoryResource *mem) const {
@@ -266,6 +308,126 @@ void CreateNode::CreateNodeCursor::Shutdown() { input_cursor_->Shutdown(); }
 
 void CreateNode::CreateNodeCursor::Reset() { input_cursor_->Reset(); }
 
+UnwindCreateNode::UnwindCreateNode(const std::shared_ptr<LogicalOperator> &input, Expression *input_expression,
+                                   Symbol output_symbol, const NodeCreationInfo &node_info)
+    : input_(input ? input : std::make_shared<Once>()),
+      input_expression_(input_expression),
+      output_symbol_(std::move(output_symbol)),
+      node_info_(node_info) {}
+
+ACCEPT_WITH_INPUT(UnwindCreateNode)
+
+std::vector<Symbol> UnwindCreateNode::ModifiedSymbols(const SymbolTable &table) const {
+  auto symbols = input_->ModifiedSymbols(table);
+  symbols.emplace_back(output_symbol_);
+  symbols.emplace_back(node_info_.symbol);
+  return symbols;
+}
+
+class UnwindCreateNodeCursor : public Cursor {
+ public:
+  // Upper bound on the number of vertices created at once, so that unwinding
+  // a huge list doesn't hold all of the vertex accessors in memory.
+  static constexpr size_t kMaxBatchSize = 1024;
+
+  UnwindCreateNodeCursor(const UnwindCreateNode &self, utils::MemoryResource *mem)
+      : self_(self), input_cursor_(self.input_->MakeCursor(mem)), input_value_(mem) {}
+
+  bool Pull(Frame &frame, ExecutionContext &context) override {
+    SCOPED_PROFILE_OP("UnwindCreateNode");
+#ifdef MG_ENTERPRISE
+    if (license::global_license_checker.IsEnterpriseValidFast() && context.auth_checker &&
+        !context.auth_checker->Has(self_.node_info_.labels,
+                                   memgraph::query::AuthQuery::FineGrainedPrivilege::CREATE_DELETE)) {
+      throw QueryRuntimeException("Vertex not created due to not having enough permission!");
+    }
+#endif
+    while (true) {
+      if (MustAbort(context)) throw HintedAbortError();
+      // if we reached the end of our list of values
+      // pull from the input
+      if (input_value_it_ == input_value_.end()) {
+        if (!input_cursor_->Pull(frame, context)) return false;
+
+        ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                      storage::View::OLD);
+        TypedValue input_value = self_.input_expression_->Accept(evaluator);
+        if (input_value.type() != TypedValue::Type::List)
+          throw QueryRuntimeException("Argument of UNWIND must be a list, but '{}' was provided.", input_value.type());
+        input_value_ = input_value.ValueList();
+        input_value_it_ = input_value_.begin();
+        created_vertices_.clear();
+        created_vertices_it_ = created_vertices_.end();
+      }
+
+      // if we reached the end of our list of values goto back to top
+      if (input_value_it_ == input_value_.end()) continue;
+
+      // A vertex is created for each of the remaining values, so the created
+      // vertices run out together with the values.
+      if (created_vertices_it_ == created_vertices_.end()) {
+        const auto batch_size =
+            std::min(static_cast<size_t>(std::distance(input_value_it_, input_value_.end())), kMaxBatchSize);
+        created_vertices_ = context.db_accessor->InsertVertices(batch_size);
+        created_vertices_it_ = created_vertices_.begin();
+        db_accessor_ = context.db_accessor;
+      }
+
+      frame[self_.output_symbol_] = *input_value_it_++;
+      context.execution_stats[ExecutionStats::Key::CREATED_NODES] += 1;
+      auto &created_vertex = InitLocalVertex(self_.node_info_, *created_vertices_it_++, &frame, context);
+      if (context.trigger_context_collector) {
+        context.trigger_context_collector->RegisterCreatedObject(created_vertex);
+      }
+      return true;
+    }
+  }
+
+  void Shutdown() override {
+    RemoveUnconsumedVertices();
+    input_cursor_->Shutdown();
+  }
+
+  void Reset() override {
+    RemoveUnconsumedVertices();
+    input_cursor_->Reset();
+    input_value_.clear();
+    input_value_it_ = input_value_.end();
+  }
+
+ private:
+  // Removes the vertices created in advance for the values which weren't
+  // pulled, because the cursor was reset or the pulling stopped early.
+  void RemoveUnconsumedVertices() {
+    for (; created_vertices_it_ != created_vertices_.end(); ++created_vertices_it_) {
+      // the vertex was created by this transaction and has no edges yet
+      [[maybe_unused]] auto maybe_removed = db_accessor_->RemoveVertex(&*created_vertices_it_);
+      DMG_ASSERT(maybe_removed.HasValue(), "Couldn't remove an unused vertex created by UNWIND");
+    }
+    created_vertices_.clear();
+    created_vertices_it_ = created_vertices_.end();
+  }
+
+  const UnwindCreateNode &self_;
+  const UniqueCursorPtr input_cursor_;
+  // typed values we are unwinding and yielding
+  utils::pmr::vector<TypedValue> input_value_;
+  // current position in input_value_
+  decltype(input_value_)::iterator input_value_it_ = input_value_.end();
+  // vertices created in advance for the values we are unwinding
+  std::vector<VertexAccessor> created_vertices_;
+  // current position in created_vertices_
+  decltype(created_vertices_)::iterator created_vertices_it_ = created_vertices_.end();
+  // accessor which created the vertices in created_vertices_
+  DbAccessor *db_accessor_{nullptr};
+};
+
+UniqueCursorPtr UnwindCreateNode::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::UnwindCreateNodeOperator);
+
+  return MakeUniqueCursorPtr<UnwindCreateNodeCursor>(mem, *this, mem);
+}
+
 CreateExpand::CreateExpand(const NodeCreationInfo &node_info, const EdgeCreationInfo &edge_info,
                            const std::shared_ptr<LogicalOperator> &input, Symbol input_symbol, bool existing_node)
     : node_info_(node_info),
@@ -299,16 +461,9 @@ EdgeAccessor CreateEdge(const EdgeCreationInfo &edge_info, DbAccessor *dba, Vert
   auto maybe_edge = dba->InsertEdge(from, to, edge_info.edge_type);
   if (maybe_edge.HasValue()) {
     auto &edge = *maybe_edge;
-    if (const auto *properties = std::get_if<PropertiesMapList>(&edge_info.properties)) {
-      for (const auto &[key, value_expression] : *properties) {
-        PropsSetChecked(&edge, key, value_expression->Accept(*evaluator));
-      }
-    } else {
-      auto property_map = evaluator->Visit(*std::get<ParameterLookup *>(edge_info.properties));
-      for (const auto &[key, value] : property_map.ValueMap()) {
-        auto property_id = dba->NameToProperty(key);
-        PropsSetChecked(&edge, property_id, value);
-      }
+    auto properties = EvaluateCreationProperties(edge_info.properties, evaluator, dba);
+    if (!properties.empty()) {
+      MultiPropsInitChecked(&edge, properties);
     }
 
     (*frame)[edge_info.symbol] = edge;
@@ -840,7 +995,7 @@ ExpandVariable::ExpandVariable(const std::shared_ptr<LogicalOperator> &input, Sy
                                const std::vector<storage::EdgeTypeId> &edge_types, bool is_reverse,
                                Expression *lower_bound, Expression *upper_bound, bool existing_node,
                                ExpansionLambda filter_lambda, std::optional<ExpansionLambda> weight_lambda,
-                               std::optional<Symbol> total_weight)
+                               std::optional<Symbol> total_weight, std::optional<ExpansionLambda> heuristic_lambda)
     : input_(input ? input : std::make_shared<Once>()),
       input_symbol_(input_symbol),
       common_{node_symbol, edge_symbol, direction, edge_types, existing_node},
@@ -850,12 +1005,15 @@ ExpandVariable::ExpandVariable(const std::shared_ptr<LogicalOperator> &input, Sy
       upper_bound_(upper_bound),
       filter_lambda_(filter_lambda),
       weight_lambda_(weight_lambda),
-      total_weight_(total_weight) {
+      total_weight_(total_weight),
+      heuristic_lambda_(heuristic_lambda) {
   DMG_ASSERT(type_ == EdgeAtom::Type::DEPTH_FIRST || type_ == EdgeAtom::Type::BREADTH_FIRST ||
                  type_ == EdgeAtom::Type::WEIGHTED_SHORTEST_PATH || type_ == EdgeAtom::Type::ALL_SHORTEST_PATHS,
              "ExpandVariable can only be used with breadth first, depth first, "
              "weighted shortest path or all shortest paths type");
   DMG_ASSERT(!(type_ == EdgeAtom::Type::BREADTH_FIRST && is_reverse), "Breadth first expansion can't be reversed");
+  DMG_ASSERT(!heuristic_lambda_ || type_ == EdgeAtom::Type::WEIGHTED_SHORTEST_PATH,
+             "Heuristic lambda can only be used with weighted shortest path");
 }
 
 ACCEPT_WITH_INPUT(ExpandVariable)
@@ -1128,10 +1286,87 @@ class ExpandVariableCursor : public Cursor {
   }
 };
 
+namespace {
+
+// Set of vertices keyed by their Gid. Gids are handed out by a counter, so
+// they are dense enough for a bitmap to be smaller and much faster than a hash
+// set of vertex accessors. A set which is small compared to its largest Gid is
+// kept in a hash set of Gids instead, until the bitmap becomes the smaller of
+// the two. The bitmap grows on demand and remembers the words it set, so
+// clearing it only touches those and it can be reused between expansions.
+class GidBitset {
+ public:
+  explicit GidBitset(utils::MemoryResource *memory) : words_(memory), set_words_(memory), gids_(memory) {}
+
+  bool Contains(storage::Gid gid) const {
+    const auto bit = gid.AsUint();
+    if (!use_bitmap_) return gids_.contains(bit);
+    const auto word = bit / kWordBits;
+    return word < words_.size() && ((words_[word] >> (bit % kWordBits)) & 1U) != 0;
+  }
+
+  void Insert(storage::Gid gid) {
+    const auto bit = gid.AsUint();
+    if (use_bitmap_) return SetBit(bit);
+    gids_.insert(bit);
+    max_bit_ = std::max(max_bit_, bit);
+    if (gids_.size() * kHashSetBitsPerGid <= max_bit_) return;
+    use_bitmap_ = true;
+    for (const auto set_bit : gids_) SetBit(set_bit);
+    gids_.clear();
+  }
+
+  void Clear() {
+    for (const auto word : set_words_) words_[word] = 0;
+    set_words_.clear();
+    gids_.clear();
+    max_bit_ = 0;
+  }
+
+ private:
+  static constexpr uint64_t kWordBits = 64;
+  // Roughly the size of a hash set entry, including its node and bucket.
+  static constexpr uint64_t kHashSetBitsPerGid = 256;
+
+  void SetBit(uint64_t bit) {
+    const auto word = bit / kWordBits;
+    if (word >= words_.size()) words_.resize(std::max<size_t>(word + 1, words_.size() * 2), 0);
+    if (words_[word] == 0) set_words_.push_back(word);
+    words_[word] |= uint64_t{1} << (bit % kWordBits);
+  }
+
+  utils::pmr::vector<uint64_t> words_;
+  // The nonzero words of `words_`.
+  utils::pmr::vector<uint64_t> set_words_;
+  utils::pmr::unordered_set<uint64_t> gids_;
+  uint64_t max_bit_{0};
+  // Once allocated, the bitmap is used until the set is destroyed.
+  bool use_bitmap_{false};
+};
+
+// Frontiers with at least this many vertices per thread are expanded in
+// parallel.
+constexpr size_t kBfsMinVerticesPerThread = 1024;
+// Frontiers smaller than this are always expanded top-down.
+constexpr size_t kBfsMinBottomUpFrontier = 1024;
+// Expansion switches to bottom-up once the frontier holds more than 1/alpha
+// of the unvisited vertices. The value is the one suggested for
+// direction-optimizing BFS by Beamer et al.
+constexpr size_t kBfsBottomUpAlpha = 14;
+
+// Threads shared by all the parallel breadth-first expansions, so concurrent
+// queries can't start more threads than there are cores.
+utils::ThreadPool &BfsThreadPool() {
+  static utils::ThreadPool pool(std::max(1U, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+}  // namespace
+
 class STShortestPathCursor : public query::plan::Cursor {
  public:
   STShortestPathCursor(const ExpandVariable &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self_.input()->MakeCursor(mem)) {
+      : self_(self), input_cursor_(self_.input()->MakeCursor(mem)), source_visited_(mem), sink_visited_(mem) {
     MG_ASSERT(self_.common_.existing_node,
               "s-t shortest path algorithm should only "
               "be used when `existing_node` flag is "
@@ -1176,6 +1411,10 @@ class STShortestPathCursor : public query::plan::Cursor {
  private:
   const ExpandVariable &self_;
   UniqueCursorPtr input_cursor_;
+  // The vertices visited expanding from the source (sink), reused by all the
+  // paths found by the cursor.
+  GidBitset source_visited_;
+  GidBitset sink_visited_;
 
   using VertexEdgeMapT = utils::pmr::unordered_map<VertexAccessor, std::optional<EdgeAccessor>>;
 
@@ -1216,8 +1455,6 @@ class STShortestPathCursor : public query::plan::Cursor {
 
   bool FindPath(const DbAccessor &dba, const VertexAccessor &source, const VertexAccessor &sink, int64_t lower_bound,
                 int64_t upper_bound, Frame *frame, ExpressionEvaluator *evaluator, const ExecutionContext &context) {
-    using utils::Contains;
-
     if (source == sink) return false;
 
     // We expand from both directions, both from the source and the sink.
@@ -1240,13 +1477,19 @@ class STShortestPathCursor : public query::plan::Cursor {
     // edge used. Necessary for path reconstruction.
     VertexEdgeMapT in_edge(pull_memory);
     VertexEdgeMapT out_edge(pull_memory);
+    // The vertices in `in_edge` (`out_edge`) are also kept in
+    // `source_visited_` (`sink_visited_`), for fast lookups.
+    source_visited_.Clear();
+    sink_visited_.Clear();
 
     size_t current_length = 0;
 
     source_frontier.emplace_back(source);
     in_edge[source] = std::nullopt;
+    source_visited_.Insert(source.Gid());
     sink_frontier.emplace_back(sink);
     out_edge[sink] = std::nullopt;
+    sink_visited_.Insert(sink.Gid());
 
     while (true) {
       if (MustAbort(context)) throw HintedAbortError();
@@ -1267,9 +1510,10 @@ class STShortestPathCursor : public query::plan::Cursor {
             }
 #endif
 
-            if (ShouldExpand(edge.To(), edge, frame, evaluator) && !Contains(in_edge, edge.To())) {
+            if (ShouldExpand(edge.To(), edge, frame, evaluator) && !source_visited_.Contains(edge.To().Gid())) {
               in_edge.emplace(edge.To(), edge);
-              if (Contains(out_edge, edge.To())) {
+              source_visited_.Insert(edge.To().Gid());
+              if (sink_visited_.Contains(edge.To().Gid())) {
                 if (current_length >= lower_bound) {
                   ReconstructPath(edge.To(), in_edge, out_edge, frame, pull_memory);
                   return true;
@@ -1293,9 +1537,10 @@ class STShortestPathCursor : public query::plan::Cursor {
             }
 #endif
 
-            if (ShouldExpand(edge.From(), edge, frame, evaluator) && !Contains(in_edge, edge.From())) {
+            if (ShouldExpand(edge.From(), edge, frame, evaluator) && !source_visited_.Contains(edge.From().Gid())) {
               in_edge.emplace(edge.From(), edge);
-              if (Contains(out_edge, edge.From())) {
+              source_visited_.Insert(edge.From().Gid());
+              if (sink_visited_.Contains(edge.From().Gid())) {
                 if (current_length >= lower_bound) {
                   ReconstructPath(edge.From(), in_edge, out_edge, frame, pull_memory);
                   return true;
@@ -1332,9 +1577,10 @@ class STShortestPathCursor : public query::plan::Cursor {
               continue;
             }
 #endif
-            if (ShouldExpand(vertex, edge, frame, evaluator) && !Contains(out_edge, edge.To())) {
+            if (ShouldExpand(vertex, edge, frame, evaluator) && !sink_visited_.Contains(edge.To().Gid())) {
               out_edge.emplace(edge.To(), edge);
-              if (Contains(in_edge, edge.To())) {
+              sink_visited_.Insert(edge.To().Gid());
+              if (source_visited_.Contains(edge.To().Gid())) {
                 if (current_length >= lower_bound) {
                   ReconstructPath(edge.To(), in_edge, out_edge, frame, pull_memory);
                   return true;
@@ -1357,9 +1603,10 @@ class STShortestPathCursor : public query::plan::Cursor {
               continue;
             }
 #endif
-            if (ShouldExpand(vertex, edge, frame, evaluator) && !Contains(out_edge, edge.From())) {
+            if (ShouldExpand(vertex, edge, frame, evaluator) && !sink_visited_.Contains(edge.From().Gid())) {
               out_edge.emplace(edge.From(), edge);
-              if (Contains(in_edge, edge.From())) {
+              sink_visited_.Insert(edge.From().Gid());
+              if (source_visited_.Contains(edge.From().Gid())) {
                 if (current_length >= lower_bound) {
                   ReconstructPath(edge.From(), in_edge, out_edge, frame, pull_memory);
                   return true;
@@ -1383,11 +1630,7 @@ class STShortestPathCursor : public query::plan::Cursor {
 class SingleSourceShortestPathCursor : public query::plan::Cursor {
  public:
   SingleSourceShortestPathCursor(const ExpandVariable &self, utils::MemoryResource *mem)
-      : self_(self),
-        input_cursor_(self_.input()->MakeCursor(mem)),
-        processed_(mem),
-        to_visit_current_(mem),
-        to_visit_next_(mem) {
+      : self_(self), input_cursor_(self_.input()->MakeCursor(mem)), nodes_(mem), visited_(mem) {
     MG_ASSERT(!self_.common_.existing_node,
               "Single source shortest path algorithm "
               "should not be used when `existing_node` "
@@ -1401,66 +1644,17 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
     ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                   storage::View::OLD);
 
-    // for the given (edge, vertex) pair checks if they satisfy the
-    // "where" condition. if so, places them in the to_visit_ structure.
-    auto expand_pair = [this, &evaluator, &frame, &context](EdgeAccessor edge, VertexAccessor vertex) {
-      // if we already processed the given vertex it doesn't get expanded
-      if (processed_.find(vertex) != processed_.end()) return;
-#ifdef MG_ENTERPRISE
-      if (license::global_license_checker.IsEnterpriseValidFast() && context.auth_checker &&
-          !(context.auth_checker->Has(vertex, storage::View::OLD,
-                                      memgraph::query::AuthQuery::FineGrainedPrivilege::READ) &&
-            context.auth_checker->Has(edge, memgraph::query::AuthQuery::FineGrainedPrivilege::READ))) {
-        return;
-      }
-#endif
-      frame[self_.filter_lambda_.inner_edge_symbol] = edge;
-      frame[self_.filter_lambda_.inner_node_symbol] = vertex;
-
-      if (self_.filter_lambda_.expression) {
-        TypedValue result = self_.filter_lambda_.expression->Accept(evaluator);
-        switch (result.type()) {
-          case TypedValue::Type::Null:
-            return;
-          case TypedValue::Type::Bool:
-            if (!result.ValueBool()) return;
-            break;
-          default:
-            throw QueryRuntimeException("Expansion condition must evaluate to boolean or null.");
-        }
-      }
-      to_visit_next_.emplace_back(edge, vertex);
-      processed_.emplace(vertex, edge);
-    };
-
-    // populates the to_visit_next_ structure with expansions
-    // from the given vertex. skips expansions that don't satisfy
-    // the "where" condition.
-    auto expand_from_vertex = [this, &expand_pair](const auto &vertex) {
-      if (self_.common_.direction != EdgeAtom::Direction::IN) {
-        auto out_edges = UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types));
-        for (const auto &edge : out_edges) expand_pair(edge, edge.To());
-      }
-      if (self_.common_.direction != EdgeAtom::Direction::OUT) {
-        auto in_edges = UnwrapEdgesResult(vertex.InEdges(storage::View::OLD, self_.common_.edge_types));
-        for (const auto &edge : in_edges) expand_pair(edge, edge.From());
-      }
-    };
-
     // do it all in a loop because we skip some elements
     while (true) {
       if (MustAbort(context)) throw HintedAbortError();
-      // if we have nothing to visit on the current depth, switch to next
-      if (to_visit_current_.empty()) to_visit_current_.swap(to_visit_next_);
 
-      // if current is still empty, it means both are empty, so pull from
-      // input
-      if (to_visit_current_.empty()) {
+      // once all the visited vertices are yielded, expand the last level. if
+      // that's not possible, the expansion from the current source is done and
+      // we pull the next source from the input
+      if (next_ == nodes_.size() && (depth_ >= upper_bound_ || !ExpandLevel(frame, &evaluator, context))) {
         if (!input_cursor_->Pull(frame, context)) return false;
 
-        to_visit_current_.clear();
-        to_visit_next_.clear();
-        processed_.clear();
+        ClearVisited();
 
         const auto &vertex_value = frame[self_.input_symbol_];
         // it is possible that the vertex is Null due to optional matching
@@ -1475,39 +1669,32 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
         if (upper_bound_ < 1 || lower_bound_ > upper_bound_) continue;
 
         const auto &vertex = vertex_value.ValueVertex();
-        processed_.emplace(vertex, std::nullopt);
-
-        expand_from_vertex(vertex);
+        visited_.Insert(vertex.Gid());
+        nodes_.push_back(Node{vertex, std::nullopt, 0});
+        level_begin_ = 0;
+        level_end_ = 1;
+        next_ = 1;
+        depth_ = 0;
+        continue;
+      }
 
-        // go back to loop start and see if we expanded anything
+      // vertices closer than the lower bound are expanded, but not yielded
+      if (depth_ < lower_bound_) {
+        next_ = level_end_;
         continue;
       }
 
-      // take the next expansion from the queue
-      auto expansion = to_visit_current_.back();
-      to_visit_current_.pop_back();
+      const auto index = next_++;
 
-      // create the frame value for the edges
+      // create the frame value for the edges by walking back to the source
       auto *pull_memory = context.evaluation_context.memory;
       utils::pmr::vector<TypedValue> edge_list(pull_memory);
-      edge_list.emplace_back(expansion.first);
-      auto last_vertex = expansion.second;
-      while (true) {
-        const EdgeAccessor &last_edge = edge_list.back().ValueEdge();
-        last_vertex = last_edge.From() == last_vertex ? last_edge.To() : last_edge.From();
-        // origin_vertex must be in processed
-        const auto &previous_edge = processed_.find(last_vertex)->second;
-        if (!previous_edge) break;
-
-        edge_list.emplace_back(previous_edge.value());
+      edge_list.reserve(depth_);
+      for (auto current = index; nodes_[current].edge; current = nodes_[current].parent) {
+        edge_list.emplace_back(*nodes_[current].edge);
       }
 
-      // expand only if what we've just expanded is less then max depth
-      if (static_cast<int64_t>(edge_list.size()) < upper_bound_) expand_from_vertex(expansion.second);
-
-      if (static_cast<int64_t>(edge_list.size()) < lower_bound_) continue;
-
-      frame[self_.common_.node_symbol] = expansion.second;
+      frame[self_.common_.node_symbol] = nodes_[index].vertex;
 
       // place edges on the frame in the correct order
       std::reverse(edge_list.begin(), edge_list.end());
@@ -1521,12 +1708,19 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
 
   void Reset() override {
     input_cursor_->Reset();
-    processed_.clear();
-    to_visit_next_.clear();
-    to_visit_current_.clear();
+    ClearVisited();
   }
 
  private:
+  // A visited vertex and the edge it got expanded from. The edge is optional
+  // because the source does not get expanded from anything. `parent` is the
+  // position of the vertex the edge was expanded from.
+  struct Node {
+    VertexAccessor vertex;
+    std::optional<EdgeAccessor> edge;
+    size_t parent;
+  };
+
   const ExpandVariable &self_;
   const UniqueCursorPtr input_cursor_;
 
@@ -1535,13 +1729,251 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
   int64_t lower_bound_{-1};
   int64_t upper_bound_{-1};
 
-  // maps vertices to the edge they got expanded from. it is an optional
-  // edge because the root does not get expanded from anything.
-  // contains visited vertices as well as those scheduled to be visited.
-  utils::pmr::unordered_map<VertexAccessor, std::optional<EdgeAccessor>> processed_;
-  // edge/vertex pairs we have yet to visit, for current and next depth
-  utils::pmr::vector<std::pair<EdgeAccessor, VertexAccessor>> to_visit_current_;
-  utils::pmr::vector<std::pair<EdgeAccessor, VertexAccessor>> to_visit_next_;
+  // all the visited vertices in the order of their expansion. vertices are
+  // expanded level by level, so every level is a contiguous range.
+  utils::pmr::vector<Node> nodes_;
+  GidBitset visited_;
+  // the range of `nodes_` at distance `depth_` from the source
+  size_t level_begin_{0};
+  size_t level_end_{0};
+  int64_t depth_{0};
+  // the position of the next vertex to yield
+  size_t next_{0};
+  // the vertices not visited yet, collected once the expansion goes bottom-up
+  std::optional<utils::pmr::vector<VertexAccessor>> unvisited_;
+
+  void ClearVisited() {
+    visited_.Clear();
+    nodes_.clear();
+    unvisited_.reset();
+    level_begin_ = level_end_ = next_ = 0;
+    depth_ = 0;
+  }
+
+  bool HasFineGrainedAuth([[maybe_unused]] const ExecutionContext &context) const {
+#ifdef MG_ENTERPRISE
+    return license::global_license_checker.IsEnterpriseValidFast() && context.auth_checker;
+#else
+    return false;
+#endif
+  }
+
+  // Expands the vertices of the current level and makes the newly visited
+  // vertices the current level. Returns false if nothing was visited.
+  bool ExpandLevel(Frame &frame, ExpressionEvaluator *evaluator, ExecutionContext &context) {
+    const auto level_size = level_end_ - level_begin_;
+    // without the filter lambda and the fine grained access checks, expansion
+    // doesn't touch the frame nor the evaluation memory and the level can be
+    // expanded in any order
+    const bool unrestricted = !self_.filter_lambda_.expression && !HasFineGrainedAuth(context);
+    const auto threads_count =
+        std::min<size_t>(std::thread::hardware_concurrency(), level_size / kBfsMinVerticesPerThread);
+
+    if (unrestricted && ShouldExpandBottomUp(level_size, context)) {
+      ExpandBottomUp(context);
+    } else if (unrestricted && threads_count > 1) {
+      ExpandTopDownParallel(threads_count, context);
+    } else {
+      ExpandTopDown(frame, evaluator, context);
+    }
+
+    level_begin_ = level_end_;
+    level_end_ = nodes_.size();
+    ++depth_;
+    return level_begin_ != level_end_;
+  }
+
+  void ExpandTopDown(Frame &frame, ExpressionEvaluator *evaluator, const ExecutionContext &context) {
+    // for the given (edge, vertex) pair checks if they satisfy the
+    // "where" condition. if so, marks the vertex as visited.
+    auto expand_pair = [&](const EdgeAccessor &edge, const VertexAccessor &vertex, size_t parent) {
+      // if we already visited the given vertex it doesn't get expanded
+      if (visited_.Contains(vertex.Gid())) return;
+#ifdef MG_ENTERPRISE
+      if (license::global_license_checker.IsEnterpriseValidFast() && context.auth_checker &&
+          !(context.auth_checker->Has(vertex, storage::View::OLD,
+                                      memgraph::query::AuthQuery::FineGrainedPrivilege::READ) &&
+            context.auth_checker->Has(edge, memgraph::query::AuthQuery::FineGrainedPrivilege::READ))) {
+        return;
+      }
+#endif
+      if (self_.filter_lambda_.expression) {
+        frame[self_.filter_lambda_.inner_edge_symbol] = edge;
+        frame[self_.filter_lambda_.inner_node_symbol] = vertex;
+
+        TypedValue result = self_.filter_lambda_.expression->Accept(*evaluator);
+        switch (result.type()) {
+          case TypedValue::Type::Null:
+            return;
+          case TypedValue::Type::Bool:
+            if (!result.ValueBool()) return;
+            break;
+          default:
+            throw QueryRuntimeException("Expansion condition must evaluate to boolean or null.");
+        }
+      }
+      visited_.Insert(vertex.Gid());
+      nodes_.push_back(Node{vertex, edge, parent});
+    };
+
+    for (auto parent = level_begin_; parent < level_end_; ++parent) {
+      // `nodes_` grows while expanding, so the vertex is copied
+      const auto vertex = nodes_[parent].vertex;
+      if (self_.common_.direction != EdgeAtom::Direction::IN) {
+        auto out_edges = UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types));
+        for (const auto &edge : out_edges) expand_pair(edge, edge.To(), parent);
+      }
+      if (self_.common_.direction != EdgeAtom::Direction::OUT) {
+        auto in_edges = UnwrapEdgesResult(vertex.InEdges(storage::View::OLD, self_.common_.edge_types));
+        for (const auto &edge : in_edges) expand_pair(edge, edge.From(), parent);
+      }
+    }
+  }
+
+  // The level is split into chunks which the threads take one by one. Each
+  // chunk collects the edges leading out of its part of the level into
+  // unvisited vertices. The results are merged in the order of the level, so
+  // the expansion is the same as the sequential one.
+  void ExpandTopDownParallel(size_t threads_count, const ExecutionContext &context) {
+    struct Expansion {
+      EdgeAccessor edge;
+      VertexAccessor vertex;
+      size_t parent;
+    };
+    const auto level_size = level_end_ - level_begin_;
+    const auto chunks_count = (level_size + kBfsMinVerticesPerThread - 1) / kBfsMinVerticesPerThread;
+    // the query memory isn't thread safe, so the threads allocate from it
+    // through a synchronized pool
+    auto *query_memory = nodes_.get_allocator().GetMemoryResource();
+    utils::SynchronizedPoolResource memory(128, 1024, query_memory, query_memory);
+    utils::pmr::vector<utils::pmr::vector<Expansion>> expansions(chunks_count, &memory);
+    utils::pmr::vector<std::exception_ptr> errors(threads_count, &memory);
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<bool> aborted{false};
+
+    auto expand_chunks = [&](size_t thread) {
+      try {
+        for (auto chunk = next_chunk++; chunk < chunks_count; chunk = next_chunk++) {
+          if (aborted.load(std::memory_order_relaxed)) return;
+          if (MustAbort(context)) {
+            aborted.store(true, std::memory_order_relaxed);
+            return;
+          }
+          const auto begin = level_begin_ + chunk * kBfsMinVerticesPerThread;
+          const auto end = std::min(begin + kBfsMinVerticesPerThread, level_end_);
+          auto &chunk_expansions = expansions[chunk];
+          for (auto parent = begin; parent < end; ++parent) {
+            const auto &vertex = nodes_[parent].vertex;
+            if (self_.common_.direction != EdgeAtom::Direction::IN) {
+              for (const auto &edge :
+                   UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types))) {
+                if (!visited_.Contains(edge.To().Gid())) chunk_expansions.push_back({edge, edge.To(), parent});
+              }
+            }
+            if (self_.common_.direction != EdgeAtom::Direction::OUT) {
+              for (const auto &edge :
+                   UnwrapEdgesResult(vertex.InEdges(storage::View::OLD, self_.common_.edge_types))) {
+                if (!visited_.Contains(edge.From().Gid())) chunk_expansions.push_back({edge, edge.From(), parent});
+              }
+            }
+          }
+        }
+      } catch (...) {
+        errors[thread] = std::current_exception();
+        aborted.store(true, std::memory_order_relaxed);
+      }
+    };
+
+    // the calling thread expands chunks as well, so the expansion progresses
+    // even when the shared threads are busy with other queries
+    std::latch done(static_cast<std::ptrdiff_t>(threads_count - 1));
+    for (size_t thread = 1; thread < threads_count; ++thread) {
+      BfsThreadPool().AddTask([&, thread] {
+        expand_chunks(thread);
+        done.count_down();
+      });
+    }
+    expand_chunks(0);
+    done.wait();
+
+    for (const auto &error : errors) {
+      if (error) std::rethrow_exception(error);
+    }
+    if (aborted) throw HintedAbortError();
+
+    for (const auto &chunk_expansions : expansions) {
+      for (const auto &expansion : chunk_expansions) {
+        if (visited_.Contains(expansion.vertex.Gid())) continue;
+        visited_.Insert(expansion.vertex.Gid());
+        nodes_.push_back(Node{expansion.vertex, expansion.edge, expansion.parent});
+      }
+    }
+  }
+
+  bool ShouldExpandBottomUp(size_t level_size, ExecutionContext &context) const {
+    if (level_size < kBfsMinBottomUpFrontier) return false;
+    const auto vertices_count = static_cast<size_t>(std::max<int64_t>(context.db_accessor->VerticesCount(), 0));
+    const auto unvisited_count = vertices_count > nodes_.size() ? vertices_count - nodes_.size() : 0;
+    return level_size * kBfsBottomUpAlpha > unvisited_count;
+  }
+
+  // Instead of expanding the (large) level, every unvisited vertex looks for
+  // an edge coming from the level. This touches each unvisited vertex once and
+  // stops at the first edge found, which is cheaper than expanding all the
+  // edges of the level once most of the graph is in it.
+  void ExpandBottomUp(ExecutionContext &context) {
+    auto *memory = nodes_.get_allocator().GetMemoryResource();
+    // the unvisited vertices are collected by the first bottom-up level and
+    // only shrink afterwards, so the following levels don't scan the vertices
+    // which were already visited
+    if (!unvisited_) {
+      unvisited_.emplace(memory);
+      for (auto vertex : context.db_accessor->Vertices(storage::View::OLD)) {
+        if (!visited_.Contains(vertex.Gid())) unvisited_->push_back(vertex);
+      }
+    }
+
+    GidBitset level(memory);
+    utils::pmr::unordered_map<storage::Gid, size_t> level_positions(memory);
+    level_positions.reserve(level_end_ - level_begin_);
+    for (auto position = level_begin_; position < level_end_; ++position) {
+      const auto gid = nodes_[position].vertex.Gid();
+      level.Insert(gid);
+      level_positions.emplace(gid, position);
+    }
+
+    size_t still_unvisited = 0;
+    for (size_t i = 0; i < unvisited_->size(); ++i) {
+      if (i % kBfsMinVerticesPerThread == 0 && MustAbort(context)) throw HintedAbortError();
+      const auto vertex = (*unvisited_)[i];
+      if (visited_.Contains(vertex.Gid())) continue;
+      std::optional<std::pair<EdgeAccessor, size_t>> parent;
+      // the edges are followed in the opposite direction of the expansion
+      if (self_.common_.direction != EdgeAtom::Direction::IN) {
+        for (const auto &edge : UnwrapEdgesResult(vertex.InEdges(storage::View::OLD, self_.common_.edge_types))) {
+          if (level.Contains(edge.From().Gid())) {
+            parent.emplace(edge, level_positions.at(edge.From().Gid()));
+            break;
+          }
+        }
+      }
+      if (!parent && self_.common_.direction != EdgeAtom::Direction::OUT) {
+        for (const auto &edge : UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types))) {
+          if (level.Contains(edge.To().Gid())) {
+            parent.emplace(edge, level_positions.at(edge.To().Gid()));
+            break;
+          }
+        }
+      }
+      if (!parent) {
+        (*unvisited_)[still_unvisited++] = vertex;
+        continue;
+      }
+      visited_.Insert(vertex.Gid());
+      nodes_.push_back(Node{vertex, parent->first, parent->second});
+    }
+    unvisited_->erase(unvisited_->begin() + static_cast<std::ptrdiff_t>(still_unvisited), unvisited_->end());
+  }
 };
 
 namespace {
@@ -1564,6 +1996,70 @@ void CheckWeightType(TypedValue current_weight, utils::MemoryResource *memory) {
   }
 }
 
+// A validated weight mapped onto a number which orders the same way as the
+// weight, so the expansion sums and compares weights without TypedValue
+// arithmetic. Integer weights stay integers, so they don't lose precision above
+// 2^53. Durations are mapped to their microseconds.
+class WeightKey {
+ public:
+  WeightKey() = default;
+
+  explicit WeightKey(const TypedValue &weight) {
+    if (weight.IsDouble()) {
+      is_int_ = false;
+      double_value_ = weight.ValueDouble();
+    } else {
+      int_value_ = weight.IsInt() ? weight.ValueInt() : weight.ValueDuration().microseconds;
+    }
+  }
+
+  WeightKey &operator+=(const WeightKey &other) {
+    int64_t sum = 0;
+    if (is_int_ && other.is_int_ && !__builtin_add_overflow(int_value_, other.int_value_, &sum)) {
+      int_value_ = sum;
+      return *this;
+    }
+    double_value_ = AsDouble() + other.AsDouble();
+    is_int_ = false;
+    return *this;
+  }
+
+  friend std::partial_ordering operator<=>(const WeightKey &lhs, const WeightKey &rhs) {
+    if (lhs.is_int_ && rhs.is_int_) return lhs.int_value_ <=> rhs.int_value_;
+    if (!lhs.is_int_ && !rhs.is_int_) return lhs.double_value_ <=> rhs.double_value_;
+    if (lhs.is_int_) return 0 <=> Compare(rhs.double_value_, lhs.int_value_);
+    return Compare(lhs.double_value_, rhs.int_value_);
+  }
+
+  friend bool operator==(const WeightKey &lhs, const WeightKey &rhs) { return (lhs <=> rhs) == 0; }
+
+  // Converts the total weight back, which is only done for the yielded paths.
+  TypedValue ToTypedValue(bool is_duration, utils::MemoryResource *memory) const {
+    if (is_duration) {
+      return TypedValue(utils::Duration(is_int_ ? int_value_ : static_cast<int64_t>(double_value_)), memory);
+    }
+    if (is_int_) return TypedValue(int_value_, memory);
+    return TypedValue(double_value_, memory);
+  }
+
+ private:
+  bool is_int_{true};
+  int64_t int_value_{0};
+  double double_value_{0};
+
+  double AsDouble() const { return is_int_ ? static_cast<double>(int_value_) : double_value_; }
+
+  // Compares without converting the integer to a double.
+  static std::partial_ordering Compare(double lhs, int64_t rhs) {
+    if (std::isnan(lhs)) return std::partial_ordering::unordered;
+    if (lhs >= 0x1p63) return std::partial_ordering::greater;
+    if (lhs < -0x1p63) return std::partial_ordering::less;
+    const auto whole = std::trunc(lhs);
+    if (const auto cmp = static_cast<int64_t>(whole) <=> rhs; cmp != 0) return cmp;
+    return lhs <=> whole;
+  }
+};
+
 }  // namespace
 
 class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
@@ -1587,9 +2083,10 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
 
     // For the given (edge, vertex, weight, depth) tuple checks if they
     // satisfy the "where" condition. if so, places them in the priority
-    // queue.
+    // queue. The priority is the total weight increased by the heuristic
+    // estimate of the remaining weight, when the heuristic is given (A*).
     auto expand_pair = [this, &evaluator, &frame, &create_state, &context](
-                           const EdgeAccessor &edge, const VertexAccessor &vertex, const TypedValue &total_weight,
+                           const EdgeAccessor &edge, const VertexAccessor &vertex, const WeightKey &total_weight,
                            int64_t depth) {
       auto *memory = evaluator.GetMemoryResource();
 #ifdef MG_ENTERPRISE
@@ -1613,30 +2110,35 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
       TypedValue current_weight = self_.weight_lambda_->expression->Accept(evaluator);
 
       CheckWeightType(current_weight, memory);
+      // The weights are summed and compared as plain numbers, so mixing
+      // numeric and Duration weights has to be caught here.
+      if (!duration_weights_) duration_weights_ = current_weight.IsDuration();
+      if (*duration_weights_ != current_weight.IsDuration()) ThrowMixedWeightTypes();
 
       auto next_state = create_state(vertex, depth);
 
-      TypedValue next_weight = std::invoke([&] {
-        if (total_weight.IsNull()) {
-          return current_weight;
-        }
-
-        ValidateWeightTypes(current_weight, total_weight);
-
-        return TypedValue(current_weight, memory) + total_weight;
-      });
-
+      auto next_weight = total_weight;
+      next_weight += WeightKey(current_weight);
       auto found_it = total_cost_.find(next_state);
-      if (found_it != total_cost_.end() && (found_it->second.IsNull() || (found_it->second <= next_weight).ValueBool()))
-        return;
+      if (found_it != total_cost_.end() && found_it->second <= next_weight) return;
+
+      auto priority = next_weight;
+      if (self_.heuristic_lambda_) {
+        frame[self_.heuristic_lambda_->inner_edge_symbol] = edge;
+        frame[self_.heuristic_lambda_->inner_node_symbol] = vertex;
+        TypedValue estimate = self_.heuristic_lambda_->expression->Accept(evaluator);
+        CheckWeightType(estimate, memory);
+        if (estimate.IsDuration() != *duration_weights_) ThrowMixedWeightTypes();
+        priority += WeightKey(estimate);
+      }
 
-      pq_.push({next_weight, depth + 1, vertex, edge});
+      pq_.push({priority, next_weight, depth + 1, vertex, edge});
     };
 
     // Populates the priority queue structure with expansions
     // from the given vertex. skips expansions that don't satisfy
     // the "where" condition.
-    auto expand_from_vertex = [this, &expand_pair](const VertexAccessor &vertex, const TypedValue &weight,
+    auto expand_from_vertex = [this, &expand_pair](const VertexAccessor &vertex, const WeightKey &weight,
                                                    int64_t depth) {
       if (self_.common_.direction != EdgeAtom::Direction::IN) {
         auto out_edges = UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types));
@@ -1681,8 +2183,9 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
         previous_.clear();
         total_cost_.clear();
         yielded_vertices_.clear();
+        duration_weights_.reset();
 
-        pq_.push({TypedValue(), 0, vertex, std::nullopt});
+        pq_.push({WeightKey(), WeightKey(), 0, vertex, std::nullopt});
         // We are adding the starting vertex to the set of yielded vertices
         // because we don't want to yield paths that end with the starting
         // vertex.
@@ -1691,7 +2194,7 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
 
       while (!pq_.empty()) {
         if (MustAbort(context)) throw HintedAbortError();
-        auto [current_weight, current_depth, current_vertex, current_edge] = pq_.top();
+        auto [priority, current_weight, current_depth, current_vertex, current_edge] = pq_.top();
         pq_.pop();
 
         auto current_state = create_state(current_vertex, current_depth);
@@ -1742,7 +2245,7 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
           std::reverse(edge_list.begin(), edge_list.end());
         }
         frame[self_.common_.edge_symbol] = std::move(edge_list);
-        frame[self_.total_weight_.value()] = current_weight;
+        frame[self_.total_weight_.value()] = current_weight.ToTypedValue(*duration_weights_, pull_memory);
         yielded_vertices_.insert(current_vertex);
         return true;
       }
@@ -1773,49 +2276,41 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
     }
   };
 
-  // Maps vertices to weights they got in expansion.
-  utils::pmr::unordered_map<std::pair<VertexAccessor, int64_t>, TypedValue, WspStateHash> total_cost_;
+  // Maps vertices to weights (as `WeightKey`) they got in expansion.
+  utils::pmr::unordered_map<std::pair<VertexAccessor, int64_t>, WeightKey, WspStateHash> total_cost_;
 
   // Maps vertices to edges used to reach them.
   utils::pmr::unordered_map<std::pair<VertexAccessor, int64_t>, std::optional<EdgeAccessor>, WspStateHash> previous_;
 
-  // Keeps track of vertices for which we yielded a path already.
-  utils::pmr::unordered_set<VertexAccessor> yielded_vertices_;
-
-  static void ValidateWeightTypes(const TypedValue &lhs, const TypedValue &rhs) {
-    if (!((lhs.IsNumeric() && lhs.IsNumeric()) || (rhs.IsDuration() && rhs.IsDuration()))) {
-      throw QueryRuntimeException(utils::MessageWithLink(
-          "All weights should be of the same type, either numeric or a Duration. Please update the weight "
-          "expression or the filter expression.",
-          "https://memgr.ph/wsp"));
-    }
-  }
-
-  // Priority queue comparator. Keep lowest weight on top of the queue.
-  class PriorityQueueComparator {
-   public:
-    bool operator()(const std::tuple<TypedValue, int64_t, VertexAccessor, std::optional<EdgeAccessor>> &lhs,
-                    const std::tuple<TypedValue, int64_t, VertexAccessor, std::optional<EdgeAccessor>> &rhs) {
-      const auto &lhs_weight = std::get<0>(lhs);
-      const auto &rhs_weight = std::get<0>(rhs);
-      // Null defines minimum value for all types
-      if (lhs_weight.IsNull()) {
-        return false;
-      }
-
-      if (rhs_weight.IsNull()) {
-        return true;
-      }
+  // Keeps track of vertices for which we yielded a path already.
+  utils::pmr::unordered_set<VertexAccessor> yielded_vertices_;
 
-      ValidateWeightTypes(lhs_weight, rhs_weight);
-      return (lhs_weight > rhs_weight).ValueBool();
-    }
+  // Whether the weights of the current expansion are Durations, set by the
+  // first calculated weight.
+  std::optional<bool> duration_weights_;
+
+  static void ThrowMixedWeightTypes() {
+    throw QueryRuntimeException(utils::MessageWithLink(
+        "All weights should be of the same type, either numeric or a Duration. Please update the weight "
+        "expression or the filter expression.",
+        "https://memgr.ph/wsp"));
+  }
+
+  struct QueueEntry {
+    // Total weight, increased by the heuristic estimate in A*.
+    WeightKey priority;
+    WeightKey weight;
+    int64_t depth;
+    VertexAccessor vertex;
+    std::optional<EdgeAccessor> edge;
   };
 
-  std::priority_queue<std::tuple<TypedValue, int64_t, VertexAccessor, std::optional<EdgeAccessor>>,
-                      utils::pmr::vector<std::tuple<TypedValue, int64_t, VertexAccessor, std::optional<EdgeAccessor>>>,
-                      PriorityQueueComparator>
-      pq_;
+  // Priority queue comparator. Keep lowest priority on top of the queue.
+  struct PriorityQueueComparator {
+    bool operator()(const QueueEntry &lhs, const QueueEntry &rhs) const { return lhs.priority > rhs.priority; }
+  };
+
+  std::priority_queue<QueueEntry, utils::pmr::vector<QueueEntry>, PriorityQueueComparator> pq_;
 
   void ClearQueue() {
     while (!pq_.empty()) pq_.pop();
@@ -3207,38 +3702,31 @@ TypedValue DefaultAggregationOpValue(const Aggregate::Element &element, utils::M
 class AggregateCursor : public Cursor {
  public:
   AggregateCursor(const Aggregate &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self_.input_->MakeCursor(mem)), aggregation_(mem) {}
+      : self_(self),
+        input_cursor_(self_.input_->MakeCursor(mem)),
+        streamed_memory_(128, 1024, mem, utils::NewDeleteResource()),
+        aggregation_(self_.ordered_group_by_ ? &streamed_memory_ : mem),
+        finished_aggregation_(aggregation_.get_allocator().GetMemoryResource()) {}
 
   bool Pull(Frame &frame, ExecutionContext &context) override {
     SCOPED_PROFILE_OP("Aggregate");
 
+    if (self_.ordered_group_by_) return PullOrdered(frame, context);
+
     if (!pulled_all_input_) {
       ProcessAll(&frame, &context);
       pulled_all_input_ = true;
       aggregation_it_ = aggregation_.begin();
 
       if (aggregation_.empty()) {
-        auto *pull_memory = context.evaluation_context.memory;
-        // place default aggregation values on the frame
-        for (const auto &elem : self_.aggregations_)
-          frame[elem.output_sym] = DefaultAggregationOpValue(elem, pull_memory);
-        // place null as remember values on the frame
-        for (const Symbol &remember_sym : self_.remember_) frame[remember_sym] = TypedValue(pull_memory);
+        PlaceDefaultValues(frame, context);
         return true;
       }
     }
 
     if (aggregation_it_ == aggregation_.end()) return false;
 
-    // place aggregation values on the frame
-    auto aggregation_values_it = aggregation_it_->second.values_.begin();
-    for (const auto &aggregation_elem : self_.aggregations_)
-      frame[aggregation_elem.output_sym] = *aggregation_values_it++;
-
-    // place remember values on the frame
-    auto remember_values_it = aggregation_it_->second.remember_.begin();
-    for (const Symbol &remember_sym : self_.remember_) frame[remember_sym] = *remember_values_it++;
-
+    PlaceValues(frame, aggregation_it_->second);
     aggregation_it_++;
     return true;
   }
@@ -3249,6 +3737,10 @@ class AggregateCursor : public Cursor {
     input_cursor_->Reset();
     aggregation_.clear();
     aggregation_it_ = aggregation_.begin();
+    finished_aggregation_.clear();
+    finished_it_ = finished_aggregation_.begin();
+    ordered_value_.reset();
+    pulled_any_input_ = false;
     pulled_all_input_ = false;
   }
 
@@ -3280,6 +3772,10 @@ class AggregateCursor : public Cursor {
 
   const Aggregate &self_;
   const UniqueCursorPtr input_cursor_;
+  // memory of the streamed aggregation. The groups are freed once they are
+  // produced, so their memory is reused by the following groups instead of
+  // growing with the number of groups.
+  utils::PoolResource streamed_memory_;
   // storage for aggregated data
   // map key is the vector of group-by values
   // map value is an AggregationValue struct
@@ -3295,6 +3791,14 @@ class AggregateCursor : public Cursor {
   // this LogicalOp pulls all from the input on it's first pull
   // this switch tracks if this has been performed
   bool pulled_all_input_{false};
+  // groups which are done in the streamed aggregation, i.e. the groups of the
+  // previous value of the ordered group-by expression
+  decltype(aggregation_) finished_aggregation_;
+  // iterator over the finished groups
+  decltype(finished_aggregation_.begin()) finished_it_ = finished_aggregation_.begin();
+  // value of the ordered group-by expression for the groups in `aggregation_`
+  std::optional<TypedValue> ordered_value_;
+  bool pulled_any_input_{false};
 
   /**
    * Pulls from the input operator until exhausted and aggregates the
@@ -3309,16 +3813,70 @@ class AggregateCursor : public Cursor {
     ExpressionEvaluator evaluator(frame, context->symbol_table, context->evaluation_context, context->db_accessor,
                                   storage::View::NEW);
     while (input_cursor_->Pull(*frame, *context)) {
-      ProcessOne(*frame, &evaluator);
+      ProcessOne(*frame, &evaluator, EvaluateGroupBy(&evaluator));
+    }
+    CalculateAverages(&aggregation_, context->evaluation_context.memory);
+  }
+
+  /**
+   * Pull of the streamed aggregation. The input is ordered by the ordered
+   * group-by expression, so all the groups of one of its values are done
+   * when the input moves to the next value. Those groups are produced
+   * before pulling any further.
+   */
+  bool PullOrdered(Frame &frame, ExecutionContext &context) {
+    while (finished_it_ == finished_aggregation_.end()) {
+      if (pulled_all_input_) return false;
+      ProcessOrderedValue(&frame, &context);
+      if (pulled_all_input_ && !pulled_any_input_) {
+        PlaceDefaultValues(frame, context);
+        return true;
+      }
+    }
+    PlaceValues(frame, finished_it_->second);
+    finished_it_++;
+    return true;
+  }
+
+  /**
+   * Aggregates the input rows until the value of the ordered group-by
+   * expression changes or the input is exhausted. The finished groups are
+   * moved to `finished_aggregation_`, while the row with the new value starts
+   * the next groups in `aggregation_`.
+   */
+  void ProcessOrderedValue(Frame *frame, ExecutionContext *context) {
+    ExpressionEvaluator evaluator(frame, context->symbol_table, context->evaluation_context, context->db_accessor,
+                                  storage::View::NEW);
+    finished_aggregation_.clear();
+    bool value_changed = false;
+    while (!value_changed) {
+      if (!input_cursor_->Pull(*frame, *context)) {
+        pulled_all_input_ = true;
+        finished_aggregation_.swap(aggregation_);
+        break;
+      }
+      pulled_any_input_ = true;
+      auto group_by = EvaluateGroupBy(&evaluator);
+      const auto &value = group_by[*self_.ordered_group_by_];
+      value_changed = ordered_value_ && !TypedValue::BoolEqual{}(*ordered_value_, value);
+      if (value_changed) finished_aggregation_.swap(aggregation_);
+      if (value_changed || !ordered_value_) {
+        ordered_value_.emplace(value, aggregation_.get_allocator().GetMemoryResource());
+      }
+      ProcessOne(*frame, &evaluator, std::move(group_by));
     }
+    CalculateAverages(&finished_aggregation_, context->evaluation_context.memory);
+    finished_it_ = finished_aggregation_.begin();
+  }
 
-    // calculate AVG aggregations (so far they have only been summed)
+  /** Calculates AVG aggregations of the given groups, which have only been
+   * summed so far. */
+  void CalculateAverages(decltype(aggregation_) *aggregation, utils::MemoryResource *pull_memory) const {
     for (size_t pos = 0; pos < self_.aggregations_.size(); ++pos) {
       if (self_.aggregations_[pos].op != Aggregation::Op::AVG) continue;
-      for (auto &kv : aggregation_) {
+      for (auto &kv : *aggregation) {
         AggregationValue &agg_value = kv.second;
         auto count = agg_value.counts_[pos];
-        auto *pull_memory = context->evaluation_context.memory;
         if (count > 0) {
           agg_value.values_[pos] = agg_value.values_[pos] / TypedValue(static_cast<double>(count), pull_memory);
         }
@@ -3326,16 +3884,41 @@ class AggregateCursor : public Cursor {
     }
   }
 
-  /**
-   * Performs a single accumulation.
-   */
-  void ProcessOne(const Frame &frame, ExpressionEvaluator *evaluator) {
-    auto *mem = aggregation_.get_allocator().GetMemoryResource();
-    utils::pmr::vector<TypedValue> group_by(mem);
+  /** Places the aggregated and remember values of a group on the frame. */
+  void PlaceValues(Frame &frame, const AggregationValue &agg_value) const {
+    // place aggregation values on the frame
+    auto aggregation_values_it = agg_value.values_.begin();
+    for (const auto &aggregation_elem : self_.aggregations_)
+      frame[aggregation_elem.output_sym] = *aggregation_values_it++;
+
+    // place remember values on the frame
+    auto remember_values_it = agg_value.remember_.begin();
+    for (const Symbol &remember_sym : self_.remember_) frame[remember_sym] = *remember_values_it++;
+  }
+
+  /** Places the values produced when there is no input on the frame. */
+  void PlaceDefaultValues(Frame &frame, ExecutionContext &context) const {
+    auto *pull_memory = context.evaluation_context.memory;
+    // place default aggregation values on the frame
+    for (const auto &elem : self_.aggregations_) frame[elem.output_sym] = DefaultAggregationOpValue(elem, pull_memory);
+    // place null as remember values on the frame
+    for (const Symbol &remember_sym : self_.remember_) frame[remember_sym] = TypedValue(pull_memory);
+  }
+
+  utils::pmr::vector<TypedValue> EvaluateGroupBy(ExpressionEvaluator *evaluator) const {
+    utils::pmr::vector<TypedValue> group_by(aggregation_.get_allocator().GetMemoryResource());
     group_by.reserve(self_.group_by_.size());
     for (Expression *expression : self_.group_by_) {
       group_by.emplace_back(expression->Accept(*evaluator));
     }
+    return group_by;
+  }
+
+  /**
+   * Performs a single accumulation.
+   */
+  void ProcessOne(const Frame &frame, ExpressionEvaluator *evaluator, utils::pmr::vector<TypedValue> group_by) {
+    auto *mem = aggregation_.get_allocator().GetMemoryResource();
     auto &agg_value = aggregation_.try_emplace(std::move(group_by), mem).first->second;
     EnsureInitialized(frame, &agg_value);
     Update(evaluator, &agg_value);
@@ -3527,6 +4110,132 @@ UniqueCursorPtr Aggregate::MakeCursor(utils::MemoryResource *mem) const {
   return MakeUniqueCursorPtr<AggregateCursor>(mem, *this, mem);
 }
 
+AggregateFromIndex::AggregateFromIndex(const std::shared_ptr<LogicalOperator> &input,
+                                       const std::shared_ptr<LogicalOperator> &fallback, storage::LabelId label,
+                                       const std::vector<AggregateFromIndex::Element> &aggregations,
+                                       storage::View view)
+    : input_(input ? input : std::make_shared<Once>()),
+      fallback_(fallback),
+      label_(label),
+      aggregations_(aggregations),
+      view_(view) {}
+
+ACCEPT_WITH_INPUT(AggregateFromIndex)
+
+std::vector<Symbol> AggregateFromIndex::ModifiedSymbols(const SymbolTable &) const {
+  std::vector<Symbol> symbols;
+  symbols.reserve(aggregations_.size());
+  for (const auto &elem : aggregations_) symbols.push_back(elem.output_sym);
+  return symbols;
+}
+
+namespace {
+
+/** Checks if MIN and MAX read from an index yield the same result as the
+ * Aggregate operator would. The index is ordered by value type first, so the
+ * endpoints are enough to know that all values have a single comparable type.
+ * Booleans are excluded because comparing two of them raises an error in
+ * Aggregate, which can't be detected from the endpoints alone. */
+bool AreIndexEndpointsComparable(const storage::PropertyValue &min, const storage::PropertyValue &max) {
+  if (min.IsNull() && max.IsNull()) return true;
+  const auto is_number = [](const auto &value) { return value.IsInt() || value.IsDouble(); };
+  if (is_number(min) && is_number(max)) return true;
+  return min.IsString() && max.IsString();
+}
+
+}  // namespace
+
+class AggregateFromIndexCursor : public Cursor {
+ public:
+  AggregateFromIndexCursor(const AggregateFromIndex &self, utils::MemoryResource *mem)
+      : self_(self), mem_(mem), input_cursor_(self_.input_->MakeCursor(mem)), values_(mem) {}
+
+  bool Pull(Frame &frame, ExecutionContext &context) override {
+    SCOPED_PROFILE_OP("AggregateFromIndex");
+
+    if (fallback_cursor_) return fallback_cursor_->Pull(frame, context);
+    if (!evaluated_) {
+      evaluated_ = true;
+      if (!EvaluateFromIndex(context)) {
+        fallback_cursor_ = self_.fallback_->MakeCursor(mem_);
+        return fallback_cursor_->Pull(frame, context);
+      }
+    }
+
+    if (!input_cursor_->Pull(frame, context)) return false;
+    for (size_t i = 0; i < values_.size(); ++i) {
+      frame[self_.aggregations_[i].output_sym] = values_[i];
+    }
+    return true;
+  }
+
+  void Shutdown() override {
+    input_cursor_->Shutdown();
+    if (fallback_cursor_) fallback_cursor_->Shutdown();
+  }
+
+  void Reset() override {
+    input_cursor_->Reset();
+    fallback_cursor_ = nullptr;
+    values_.clear();
+    evaluated_ = false;
+  }
+
+ private:
+  const AggregateFromIndex &self_;
+  utils::MemoryResource *mem_;
+  const UniqueCursorPtr input_cursor_;
+  UniqueCursorPtr fallback_cursor_{nullptr};
+  utils::pmr::vector<TypedValue> values_;
+  bool evaluated_{false};
+
+  /** Reads all the aggregation results from the indices. Returns false if
+   * they can't be used, in which case the fallback branch has to be
+   * executed. */
+  bool EvaluateFromIndex(ExecutionContext &context) {
+#ifdef MG_ENTERPRISE
+    // The indices contain vertices the user may not be allowed to read.
+    if (license::global_license_checker.IsEnterpriseValidFast() && context.auth_checker) {
+      return false;
+    }
+#endif
+    auto *dba = context.db_accessor;
+    values_.reserve(self_.aggregations_.size());
+    for (const auto &elem : self_.aggregations_) {
+      switch (elem.op) {
+        case Aggregation::Op::COUNT:
+          if (elem.property) {
+            values_.emplace_back(dba->ExactVerticesCount(self_.view_, self_.label_, *elem.property));
+          } else {
+            values_.emplace_back(dba->ExactVerticesCount(self_.view_, self_.label_));
+          }
+          break;
+        case Aggregation::Op::MIN:
+        case Aggregation::Op::MAX: {
+          MG_ASSERT(elem.property, "MIN and MAX from index require an indexed property");
+          auto min = dba->MinPropertyValue(self_.view_, self_.label_, *elem.property);
+          auto max = dba->MaxPropertyValue(self_.view_, self_.label_, *elem.property);
+          if (!AreIndexEndpointsComparable(min, max)) {
+            values_.clear();
+            return false;
+          }
+          values_.emplace_back(elem.op == Aggregation::Op::MIN ? min : max);
+          break;
+        }
+        default:
+          LOG_FATAL("Unexpected aggregation in AggregateFromIndex");
+      }
+    }
+    return true;
+  }
+};
+
+UniqueCursorPtr AggregateFromIndex::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::AggregateFromIndexOperator);
+
+  return MakeUniqueCursorPtr<AggregateFromIndexCursor>(mem, *this, mem);
+}
+
 Skip::Skip(const std::shared_ptr<LogicalOperator> &input, Expression *expression)
     : input_(input), expression_(expression) {}
 
@@ -3819,6 +4528,97 @@ void Merge::MergeCursor::Reset() {
   pull_input_ = true;
 }
 
+MergeByLabelProperty::MergeByLabelProperty(const std::shared_ptr<LogicalOperator> &input,
+                                           const std::shared_ptr<LogicalOperator> &merge_match,
+                                           const std::shared_ptr<LogicalOperator> &merge_create,
+                                           storage::LabelId label, storage::PropertyId property,
+                                           Expression *expression)
+    : input_(input ? input : std::make_shared<Once>()),
+      merge_match_(merge_match),
+      merge_create_(merge_create),
+      label_(label),
+      property_(property),
+      expression_(expression) {}
+
+bool MergeByLabelProperty::Accept(HierarchicalLogicalOperatorVisitor &visitor) {
+  if (visitor.PreVisit(*this)) {
+    input_->Accept(visitor) && merge_match_->Accept(visitor) && merge_create_->Accept(visitor);
+  }
+  return visitor.PostVisit(*this);
+}
+
+UniqueCursorPtr MergeByLabelProperty::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::MergeByLabelPropertyOperator);
+
+  return MakeUniqueCursorPtr<MergeByLabelPropertyCursor>(mem, *this, mem);
+}
+
+std::vector<Symbol> MergeByLabelProperty::ModifiedSymbols(const SymbolTable &table) const {
+  auto symbols = input_->ModifiedSymbols(table);
+  auto my_symbols = merge_match_->OutputSymbols(table);
+  symbols.insert(symbols.end(), my_symbols.begin(), my_symbols.end());
+  return symbols;
+}
+
+MergeByLabelProperty::MergeByLabelPropertyCursor::MergeByLabelPropertyCursor(const MergeByLabelProperty &self,
+                                                                             utils::MemoryResource *mem)
+    : self_(self),
+      input_cursor_(self.input_->MakeCursor(mem)),
+      merge_match_cursor_(self.merge_match_->MakeCursor(mem)),
+      merge_create_cursor_(self.merge_create_->MakeCursor(mem)) {}
+
+void MergeByLabelProperty::MergeByLabelPropertyCursor::LockKey(Frame &frame, ExecutionContext &context) {
+  ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                storage::View::NEW);
+  auto value = self_.expression_->Accept(evaluator);
+  // Null and values which can't be stored are never found by the lookup and
+  // fail when creating the node, so there is nothing to lock.
+  if (value.IsNull() || !value.IsPropertyValue()) return;
+  auto result = context.db_accessor->LockKey(self_.label_, self_.property_, storage::PropertyValue(value),
+                                             [&context] { return MustAbort(context); });
+  if (result.HasError()) {
+    if (MustAbort(context)) throw HintedAbortError();
+    throw TransactionSerializationException();
+  }
+}
+
+bool MergeByLabelProperty::MergeByLabelPropertyCursor::Pull(Frame &frame, ExecutionContext &context) {
+  SCOPED_PROFILE_OP("MergeByLabelProperty");
+
+  while (true) {
+    if (pull_input_) {
+      if (!input_cursor_->Pull(frame, context)) return false;
+      merge_match_cursor_->Reset();
+      merge_create_cursor_->Reset();
+      // The key stays locked until the end of the transaction, so nobody else
+      // can create the node between our lookup and our create.
+      LockKey(frame, context);
+    }
+
+    if (merge_match_cursor_->Pull(frame, context)) {
+      pull_input_ = false;
+      return true;
+    }
+    if (pull_input_) {
+      return merge_create_cursor_->Pull(frame, context);
+    }
+    pull_input_ = true;
+  }
+}
+
+void MergeByLabelProperty::MergeByLabelPropertyCursor::Shutdown() {
+  input_cursor_->Shutdown();
+  merge_match_cursor_->Shutdown();
+  merge_create_cursor_->Shutdown();
+}
+
+void MergeByLabelProperty::MergeByLabelPropertyCursor::Reset() {
+  input_cursor_->Reset();
+  merge_match_cursor_->Reset();
+  merge_create_cursor_->Reset();
+  pull_input_ = true;
+}
+
 Optional::Optional(const std::shared_ptr<LogicalOperator> &input, const std::shared_ptr<LogicalOperator> &optional,
                    const std::vector<Symbol> &optional_symbols)
     : input_(input ? input : std::make_shared<Once>()), optional_(optional), optional_symbols_(optional_symbols) {}
@@ -3895,6 +4695,167 @@ void Optional::OptionalCursor::Reset() {
   pull_input_ = true;
 }
 
+SemiApply::SemiApply(const std::shared_ptr<LogicalOperator> &input, const std::shared_ptr<LogicalOperator> &subplan,
+                     bool anti)
+    : input_(input ? input : std::make_shared<Once>()), subplan_(subplan), anti_(anti) {}
+
+bool SemiApply::Accept(HierarchicalLogicalOperatorVisitor &visitor) {
+  if (visitor.PreVisit(*this)) {
+    input_->Accept(visitor) && subplan_->Accept(visitor);
+  }
+  return visitor.PostVisit(*this);
+}
+
+UniqueCursorPtr SemiApply::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::SemiApplyOperator);
+
+  return MakeUniqueCursorPtr<SemiApplyCursor>(mem, *this, mem);
+}
+
+std::vector<Symbol> SemiApply::ModifiedSymbols(const SymbolTable &table) const {
+  // Symbols bound in the subplan are only used for checking the pattern, they
+  // aren't visible after this operator.
+  return input_->ModifiedSymbols(table);
+}
+
+SemiApply::SemiApplyCursor::SemiApplyCursor(const SemiApply &self, utils::MemoryResource *mem)
+    : self_(self), input_cursor_(self.input_->MakeCursor(mem)), subplan_cursor_(self.subplan_->MakeCursor(mem)) {}
+
+bool SemiApply::SemiApplyCursor::Pull(Frame &frame, ExecutionContext &context) {
+  SCOPED_PROFILE_OP(self_.anti_ ? "AntiSemiApply" : "SemiApply");
+
+  while (input_cursor_->Pull(frame, context)) {
+    // The subplan keeps the state of its expansions, so it needs to be reset
+    // for every input row. Only the first result is needed, the rest of the
+    // subplan results are never produced.
+    subplan_cursor_->Reset();
+    if (subplan_cursor_->Pull(frame, context) != self_.anti_) return true;
+  }
+  return false;
+}
+
+void SemiApply::SemiApplyCursor::Shutdown() {
+  input_cursor_->Shutdown();
+  subplan_cursor_->Shutdown();
+}
+
+void SemiApply::SemiApplyCursor::Reset() {
+  input_cursor_->Reset();
+  subplan_cursor_->Reset();
+}
+
+Apply::Apply(const std::shared_ptr<LogicalOperator> &input, const std::shared_ptr<LogicalOperator> &subquery,
+             bool subquery_has_return, bool in_transactions, Expression *batch_size)
+    : input_(input ? input : std::make_shared<Once>()),
+      subquery_(subquery),
+      subquery_has_return_(subquery_has_return),
+      in_transactions_(in_transactions),
+      batch_size_(batch_size) {}
+
+bool Apply::Accept(HierarchicalLogicalOperatorVisitor &visitor) {
+  if (visitor.PreVisit(*this)) {
+    input_->Accept(visitor) && subquery_->Accept(visitor);
+  }
+  return visitor.PostVisit(*this);
+}
+
+UniqueCursorPtr Apply::MakeCursor(utils::MemoryResource *mem) const {
+  EventCounter::IncrementCounter(EventCounter::ApplyOperator);
+
+  return MakeUniqueCursorPtr<ApplyCursor>(mem, *this, mem);
+}
+
+std::vector<Symbol> Apply::ModifiedSymbols(const SymbolTable &table) const {
+  auto symbols = input_->ModifiedSymbols(table);
+  auto subquery_symbols = subquery_->ModifiedSymbols(table);
+  symbols.insert(symbols.end(), subquery_symbols.begin(), subquery_symbols.end());
+  return symbols;
+}
+
+Apply::ApplyCursor::ApplyCursor(const Apply &self, utils::MemoryResource *mem)
+    : self_(self), input_cursor_(self.input_->MakeCursor(mem)), subquery_cursor_(self.subquery_->MakeCursor(mem)) {}
+
+namespace {
+
+// Number of input rows per transaction for `IN TRANSACTIONS` without `OF n ROWS`.
+constexpr int64_t kDefaultRowsPerTransaction = 1000;
+
+void PeriodicCommit(DbAccessor *dba) {
+  auto maybe_error = dba->PeriodicCommit();
+  if (!maybe_error.HasError()) return;
+  // On `ReplicationError` the changes are committed, only some SYNC replicas
+  // didn't confirm them, which doesn't stop the query.
+  if (const auto *constraint_violation = std::get_if<storage::ConstraintViolation>(&maybe_error.GetError())) {
+    std::stringstream property_names_stream;
+    utils::PrintIterable(property_names_stream, constraint_violation->properties, ", ",
+                         [dba](auto &stream, const auto &property) { stream << dba->PropertyToName(property); });
+    throw QueryRuntimeException(
+        "Unable to commit due to {} constraint violation on :{}({})",
+        constraint_violation->type == storage::ConstraintViolation::Type::EXISTENCE ? "existence" : "unique",
+        dba->LabelToName(constraint_violation->label), property_names_stream.str());
+  }
+}
+
+}  // namespace
+
+void Apply::ApplyCursor::CommitFinishedBatch(Frame &frame, ExecutionContext &context) {
+  if (!batch_size_) {
+    batch_size_ = kDefaultRowsPerTransaction;
+    if (self_.batch_size_) {
+      ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                    storage::View::OLD);
+      batch_size_ = EvaluateInt(&evaluator, self_.batch_size_, "Number of rows per transaction");
+      if (*batch_size_ <= 0) {
+        throw QueryRuntimeException("Number of rows per transaction must be a positive integer.");
+      }
+    }
+  }
+  if (rows_in_batch_ == *batch_size_) {
+    if (context.periodic_commit) {
+      context.periodic_commit();
+    } else {
+      PeriodicCommit(context.db_accessor);
+    }
+    rows_in_batch_ = 0;
+  }
+  ++rows_in_batch_;
+}
+
+bool Apply::ApplyCursor::Pull(Frame &frame, ExecutionContext &context) {
+  SCOPED_PROFILE_OP("Apply");
+
+  while (true) {
+    if (MustAbort(context)) throw HintedAbortError();
+    if (!pull_input_) {
+      if (subquery_cursor_->Pull(frame, context)) return true;
+      pull_input_ = true;
+    }
+    if (!input_cursor_->Pull(frame, context)) return false;
+    if (self_.in_transactions_) CommitFinishedBatch(frame, context);
+    // The subquery keeps the state of the previous input row, so it needs to
+    // be reset for every input row.
+    subquery_cursor_->Reset();
+    if (!self_.subquery_has_return_) {
+      while (subquery_cursor_->Pull(frame, context)) {
+      }
+      return true;
+    }
+    pull_input_ = false;
+  }
+}
+
+void Apply::ApplyCursor::Shutdown() {
+  input_cursor_->Shutdown();
+  subquery_cursor_->Shutdown();
+}
+
+void Apply::ApplyCursor::Reset() {
+  input_cursor_->Reset();
+  subquery_cursor_->Reset();
+  pull_input_ = true;
+  rows_in_batch_ = 0;
+}
+
 Unwind::Unwind(const std::shared_ptr<LogicalOperator> &input, Expression *input_expression, Symbol output_symbol)
     : input_(input ? input : std::make_shared<Once>()),
       input_expression_(input_expression),
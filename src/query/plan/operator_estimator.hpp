@@ -0,0 +1,126 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "query/exceptions.hpp"
+#include "query/parameters.hpp"
+#include "query/plan/cost_estimator.hpp"
+#include "query/plan/preprocess.hpp"
+#include "query/plan/pretty_print.hpp"
+
+namespace memgraph::query::plan {
+
+namespace impl {
+
+/// Collects the expressions of all `Filter` operators in a plan.
+class FilterExpressionCollector : public HierarchicalLogicalOperatorVisitor {
+ public:
+  using HierarchicalLogicalOperatorVisitor::PostVisit;
+  using HierarchicalLogicalOperatorVisitor::PreVisit;
+  using HierarchicalLogicalOperatorVisitor::Visit;
+
+  bool PreVisit(Filter &op) override {
+    expressions_.push_back(op.expression_);
+    return true;
+  }
+
+  bool Visit(Once &) override { return true; }
+
+  std::vector<Expression *> expressions_;
+};
+
+/// Returns the indices which could be used for producing the vertices of
+/// `scan`. The planner consumes the filters it turns into an index lookup, so
+/// the candidates are the labels and properties the remaining filters test
+/// for the scanned symbol, together with whatever the scan itself looks up.
+template <class TDbAccessor>
+std::vector<IndexAlternative> IndexAlternatives(TDbAccessor *db, const Filters &filters, const ScanAll &scan) {
+  std::optional<storage::LabelId> chosen_label;
+  std::optional<storage::PropertyId> chosen_property;
+  if (const auto *by_label = dynamic_cast<const ScanAllByLabel *>(&scan)) {
+    chosen_label = by_label->label_;
+  } else if (const auto *by_value = dynamic_cast<const ScanAllByLabelPropertyValue *>(&scan)) {
+    chosen_label = by_value->label_;
+    chosen_property = by_value->property_;
+  } else if (const auto *by_range = dynamic_cast<const ScanAllByLabelPropertyRange *>(&scan)) {
+    chosen_label = by_range->label_;
+    chosen_property = by_range->property_;
+  } else if (const auto *by_property = dynamic_cast<const ScanAllByLabelProperty *>(&scan)) {
+    chosen_label = by_property->label_;
+    chosen_property = by_property->property_;
+  }
+
+  std::set<storage::LabelId> labels;
+  std::set<storage::PropertyId> properties;
+  if (chosen_label) labels.insert(*chosen_label);
+  if (chosen_property) properties.insert(*chosen_property);
+  for (const auto &label : filters.FilteredLabels(scan.output_symbol_)) {
+    labels.insert(db->NameToLabel(label.name));
+  }
+  for (const auto &filter : filters.PropertyFilters(scan.output_symbol_)) {
+    properties.insert(db->NameToProperty(filter.property_filter->property_.name));
+  }
+
+  std::vector<IndexAlternative> alternatives;
+  for (const auto label : labels) {
+    if (db->LabelIndexExists(label)) {
+      alternatives.push_back(
+          {label, std::nullopt, db->VerticesCount(label), chosen_label == label && !chosen_property});
+    }
+    for (const auto property : properties) {
+      if (!db->LabelPropertyIndexExists(label, property)) continue;
+      alternatives.push_back(
+          {label, property, db->VerticesCount(label, property), chosen_label == label && chosen_property == property});
+    }
+  }
+  return alternatives;
+}
+
+}  // namespace impl
+
+/// Makes an `OperatorEstimator` for operators of the plan rooted at
+/// `plan_root`. The estimates of an operator are those the `CostEstimator`
+/// computes for the subplan rooted at it, which makes estimating the whole
+/// plan quadratic in its size; that is fine for EXPLAIN.
+template <class TDbAccessor>
+OperatorEstimator MakeOperatorEstimator(TDbAccessor *db, const Parameters &parameters, const SymbolTable &symbol_table,
+                                        LogicalOperator &plan_root) {
+  impl::FilterExpressionCollector collector;
+  plan_root.Accept(collector);
+  auto filters = std::make_shared<Filters>();
+  for (auto *expression : collector.expressions_) {
+    try {
+      filters->CollectFilterExpression(expression, symbol_table);
+    } catch (const SemanticException &) {
+      // The expression can't be analyzed for index lookups, so it doesn't
+      // contribute any alternatives.
+    }
+  }
+  return [db, &parameters, filters = std::move(filters)](LogicalOperator &op) {
+    CostEstimator<TDbAccessor> estimator(db, parameters);
+    op.Accept(estimator);
+    OperatorEstimates estimates{estimator.cardinality(), estimator.cost(), {}};
+    if (const auto *scan = dynamic_cast<const ScanAll *>(&op)) {
+      estimates.index_alternatives = impl::IndexAlternatives(db, *filters, *scan);
+    }
+    return estimates;
+  };
+}
+
+}  // namespace memgraph::query::plan
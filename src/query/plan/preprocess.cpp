@@ -69,6 +69,11 @@ std::vector<Expansion> NormalizePatterns(const SymbolTable &symbol_table, const
         collector.symbols_.erase(symbol_table.at(*edge->weight_lambda_.inner_edge));
         collector.symbols_.erase(symbol_table.at(*edge->weight_lambda_.inner_node));
       }
+      if (edge->heuristic_lambda_.expression) {
+        edge->heuristic_lambda_.expression->Accept(collector);
+        collector.symbols_.erase(symbol_table.at(*edge->heuristic_lambda_.inner_edge));
+        collector.symbols_.erase(symbol_table.at(*edge->heuristic_lambda_.inner_node));
+      }
     }
     expansions.emplace_back(Expansion{prev_node, edge, edge->direction_, false, collector.symbols_, current_node});
   };
@@ -153,6 +158,25 @@ auto SplitExpressionOnAnd(Expression *expression) {
   return expressions;
 }
 
+// Finds out whether an expression contains a pattern predicate.
+class PatternPredicateFinder : public HierarchicalTreeVisitor {
+ public:
+  using HierarchicalTreeVisitor::PostVisit;
+  using HierarchicalTreeVisitor::PreVisit;
+  using HierarchicalTreeVisitor::Visit;
+
+  bool PreVisit(Exists &) override {
+    found_ = true;
+    return false;
+  }
+
+  bool Visit(Identifier &) override { return true; }
+  bool Visit(PrimitiveLiteral &) override { return true; }
+  bool Visit(ParameterLookup &) override { return true; }
+
+  bool found_{false};
+};
+
 }  // namespace
 
 PropertyFilter::PropertyFilter(const SymbolTable &symbol_table, const Symbol &symbol, PropertyIx property,
@@ -453,6 +477,22 @@ void Filters::AnalyzeAndStoreFilter(Expression *expr, const SymbolTable &symbol_
   // We are only interested to see the insides of And, because Or prevents
   // indexing since any labels and properties found there may be optional.
   DMG_ASSERT(!utils::IsSubtype(*expr, AndOperator::kType), "Expected AndOperators have been split.");
+  // Pattern predicates are matched by a subplan, which is only possible when
+  // the whole filter is the (negated) pattern predicate.
+  auto *not_op = utils::Downcast<NotOperator>(expr);
+  auto *exists = utils::Downcast<Exists>(not_op ? not_op->expression_ : expr);
+  if (exists) {
+    auto filter = make_filter(FilterInfo::Type::Pattern);
+    filter.pattern_filter = PatternFilter{exists, not_op != nullptr};
+    all_filters_.emplace_back(filter);
+    return;
+  }
+  PatternPredicateFinder pattern_predicate_finder;
+  expr->Accept(pattern_predicate_finder);
+  if (pattern_predicate_finder.found_) {
+    throw SemanticException(
+        "Pattern predicates are only supported as conditions of WHERE joined with AND, optionally negated with NOT.");
+  }
   if (auto *labels_test = utils::Downcast<LabelsTest>(expr)) {
     // Since LabelsTest may contain any expression, we can only use the
     // simplest test on an identifier.
@@ -562,6 +602,12 @@ std::vector<SingleQueryPart> CollectSingleQueryParts(SymbolTable &symbol_table,
         AddMatching({merge->pattern_}, nullptr, symbol_table, storage, query_part->merge_matching.back());
       } else if (auto *foreach = utils::Downcast<query::Foreach>(clause)) {
         ParseForeach(*foreach, *query_part, storage, symbol_table);
+      } else if (auto *call_subquery = utils::Downcast<query::CallSubquery>(clause)) {
+        auto subquery_parts = CollectSingleQueryParts(symbol_table, storage, call_subquery->single_query_);
+        query_part->subqueries.emplace_back(std::move(subquery_parts));
+        // The subquery binds its returned symbols, so continue with a new part.
+        query_parts.emplace_back(SingleQueryPart{});
+        query_part = &query_parts.back();
       } else if (utils::IsSubtype(*clause, With::kType) || utils::IsSubtype(*clause, query::Unwind::kType) ||
                  utils::IsSubtype(*clause, query::CallProcedure::kType) ||
                  utils::IsSubtype(*clause, query::LoadCsv::kType)) {
@@ -576,6 +622,12 @@ std::vector<SingleQueryPart> CollectSingleQueryParts(SymbolTable &symbol_table,
   return query_parts;
 }
 
+Matching MakePatternFilterMatching(Exists &exists, SymbolTable &symbol_table, AstStorage &storage) {
+  Matching matching;
+  AddMatching({exists.pattern_}, nullptr, symbol_table, storage, matching);
+  return matching;
+}
+
 QueryParts CollectQueryParts(SymbolTable &symbol_table, AstStorage &storage, CypherQuery *query) {
   std::vector<QueryPart> query_parts;
 
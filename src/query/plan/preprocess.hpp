@@ -69,6 +69,33 @@ class UsedSymbolsCollector : public HierarchicalTreeVisitor {
     return true;
   }
 
+  bool PreVisit(Exists &exists) override {
+    // Only the symbols bound outside of the pattern are used by the pattern
+    // predicate. Anonymous nodes, edges and lambda arguments are bound by
+    // matching the pattern itself.
+    UsedSymbolsCollector collector(symbol_table_);
+    exists.pattern_->Accept(collector);
+    collector.symbols_.erase(symbol_table_.at(*exists.pattern_->identifier_));
+    for (auto *atom : exists.pattern_->atoms_) {
+      if (!atom->identifier_->user_declared_) {
+        collector.symbols_.erase(symbol_table_.at(*atom->identifier_));
+      }
+      auto *edge = utils::Downcast<EdgeAtom>(atom);
+      if (!edge || !edge->IsVariable()) continue;
+      for (auto *lambda : {&edge->filter_lambda_, &edge->weight_lambda_, &edge->heuristic_lambda_}) {
+        if (!lambda->expression) continue;
+        lambda->expression->Accept(collector);
+        collector.symbols_.erase(symbol_table_.at(*lambda->inner_edge));
+        collector.symbols_.erase(symbol_table_.at(*lambda->inner_node));
+      }
+      if (edge->total_weight_) {
+        collector.symbols_.erase(symbol_table_.at(*edge->total_weight_));
+      }
+    }
+    symbols_.insert(collector.symbols_.begin(), collector.symbols_.end());
+    return false;
+  }
+
   bool Visit(Identifier &ident) override {
     symbols_.insert(symbol_table_.at(ident));
     return true;
@@ -147,13 +174,21 @@ class IdFilter {
   bool is_symbol_in_value_{false};
 };
 
+/// Filtering by a pattern predicate, for example `MATCH (n) WHERE (n) --> ()`.
+struct PatternFilter {
+  Exists *exists;
+  /// True if the pattern must not exist, for example `WHERE NOT (n) --> ()`.
+  bool negated{false};
+};
+
 /// Stores additional information for a filter expression.
 struct FilterInfo {
   /// A FilterInfo can be a generic filter expression or a specific filtering
   /// applied for labels or a property. Non generic types contain extra
   /// information which can be used to produce indexed scans of graph
-  /// elements.
-  enum class Type { Generic, Label, Property, Id };
+  /// elements. Type::Pattern filters can't be evaluated as an expression, they
+  /// are planned as a SemiApply.
+  enum class Type { Generic, Label, Property, Id, Pattern };
 
   Type type;
   /// The original filter expression which must be satisfied.
@@ -166,6 +201,8 @@ struct FilterInfo {
   std::optional<PropertyFilter> property_filter;
   /// Information for Type::Id filtering.
   std::optional<IdFilter> id_filter;
+  /// Information for Type::Pattern filtering.
+  std::optional<PatternFilter> pattern_filter;
 };
 
 /// Stores information on filters used inside the @c Matching of a @c QueryPart.
@@ -295,7 +332,8 @@ struct Matching {
 ///  * `RETURN` clause;
 ///  * `WITH` clause;
 ///  * `UNWIND` clause;
-///  * `CALL` clause or
+///  * `CALL` clause;
+///  * `CALL { ... }` subquery or
 ///  * any of the write clauses.
 ///
 /// For a query `MATCH (n) MERGE (n) -[e]- (m) SET n.x = 42 MERGE (l)` the
@@ -329,6 +367,11 @@ struct SingleQueryPart {
   /// in the `remaining_clauses` but rather in the `Foreach` itself and are guranteed
   /// to be processed in the same order by the semantics of the `RuleBasedPlanner`.
   std::vector<Matching> merge_matching{};
+  /// @brief Query parts of each `CALL { ... }` subquery.
+  ///
+  /// Like with `merge_matching`, the subqueries are in the same order as their
+  /// @c CallSubquery clauses appear in `remaining_clauses`.
+  std::vector<std::vector<SingleQueryPart>> subqueries{};
   /// @brief All the remaining clauses (without @c Match).
   std::vector<Clause *> remaining_clauses{};
 };
@@ -349,6 +392,12 @@ struct QueryParts {
   bool distinct = false;
 };
 
+/// @brief Convert the pattern of a pattern predicate to @c Matching.
+///
+/// The matching is used to plan the subplan of a SemiApply, in which the
+/// symbols bound before the predicate are already bound.
+Matching MakePatternFilterMatching(Exists &, SymbolTable &, AstStorage &);
+
 /// @brief Convert the AST to multiple @c QueryParts.
 ///
 /// This function will normalize patterns inside @c Match and @c Merge clauses
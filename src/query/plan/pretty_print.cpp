@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -18,18 +18,20 @@
 
 namespace memgraph::query::plan {
 
-PlanPrinter::PlanPrinter(const DbAccessor *dba, std::ostream *out) : dba_(dba), out_(out) {}
+PlanPrinter::PlanPrinter(const DbAccessor *dba, std::ostream *out, const OperatorEstimator *estimator)
+    : dba_(dba), out_(out), estimator_(estimator) {}
 
-#define PRE_VISIT(TOp)                                   \
-  bool PlanPrinter::PreVisit(TOp &) {                    \
-    WithPrintLn([](auto &out) { out << "* " << #TOp; }); \
-    return true;                                         \
+#define PRE_VISIT(TOp)                                       \
+  bool PlanPrinter::PreVisit(TOp &op) {                      \
+    WithPrintLn(op, [](auto &out) { out << "* " << #TOp; }); \
+    return true;                                             \
   }
 
 PRE_VISIT(CreateNode);
+PRE_VISIT(UnwindCreateNode);
 
 bool PlanPrinter::PreVisit(CreateExpand &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* CreateExpand (" << op.input_symbol_.name() << ")"
         << (op.edge_info_.direction == query::EdgeAtom::Direction::IN ? "<-" : "-") << "["
         << op.edge_info_.symbol.name() << ":" << dba_->EdgeTypeToName(op.edge_info_.edge_type) << "]"
@@ -42,7 +44,7 @@ bool PlanPrinter::PreVisit(CreateExpand &op) {
 PRE_VISIT(Delete);
 
 bool PlanPrinter::PreVisit(query::plan::ScanAll &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* ScanAll"
         << " (" << op.output_symbol_.name() << ")";
   });
@@ -50,7 +52,7 @@ bool PlanPrinter::PreVisit(query::plan::ScanAll &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::ScanAllByLabel &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* ScanAllByLabel"
         << " (" << op.output_symbol_.name() << " :" << dba_->LabelToName(op.label_) << ")";
   });
@@ -58,7 +60,7 @@ bool PlanPrinter::PreVisit(query::plan::ScanAllByLabel &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::ScanAllByLabelPropertyValue &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* ScanAllByLabelPropertyValue"
         << " (" << op.output_symbol_.name() << " :" << dba_->LabelToName(op.label_) << " {"
         << dba_->PropertyToName(op.property_) << "})";
@@ -67,7 +69,7 @@ bool PlanPrinter::PreVisit(query::plan::ScanAllByLabelPropertyValue &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::ScanAllByLabelPropertyRange &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* ScanAllByLabelPropertyRange"
         << " (" << op.output_symbol_.name() << " :" << dba_->LabelToName(op.label_) << " {"
         << dba_->PropertyToName(op.property_) << "})";
@@ -76,7 +78,7 @@ bool PlanPrinter::PreVisit(query::plan::ScanAllByLabelPropertyRange &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::ScanAllByLabelProperty &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* ScanAllByLabelProperty"
         << " (" << op.output_symbol_.name() << " :" << dba_->LabelToName(op.label_) << " {"
         << dba_->PropertyToName(op.property_) << "})";
@@ -85,7 +87,7 @@ bool PlanPrinter::PreVisit(query::plan::ScanAllByLabelProperty &op) {
 }
 
 bool PlanPrinter::PreVisit(ScanAllById &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* ScanAllById"
         << " (" << op.output_symbol_.name() << ")";
   });
@@ -93,7 +95,7 @@ bool PlanPrinter::PreVisit(ScanAllById &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::Expand &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     *out_ << "* Expand (" << op.input_symbol_.name() << ")"
           << (op.common_.direction == query::EdgeAtom::Direction::IN ? "<-" : "-") << "["
           << op.common_.edge_symbol.name();
@@ -108,7 +110,7 @@ bool PlanPrinter::PreVisit(query::plan::Expand &op) {
 
 bool PlanPrinter::PreVisit(query::plan::ExpandVariable &op) {
   using Type = query::EdgeAtom::Type;
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     *out_ << "* ";
     switch (op.type_) {
       case Type::DEPTH_FIRST:
@@ -139,7 +141,7 @@ bool PlanPrinter::PreVisit(query::plan::ExpandVariable &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::Produce &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* Produce {";
     utils::PrintIterable(out, op.named_expressions_, ", ", [](auto &out, const auto &nexpr) { out << nexpr->name_; });
     out << "}";
@@ -159,13 +161,24 @@ PRE_VISIT(Accumulate);
 PRE_VISIT(EmptyResult);
 
 bool PlanPrinter::PreVisit(query::plan::Aggregate &op) {
-  WithPrintLn([&](auto &out) {
+  WithPrintLn(op, [&](auto &out) {
     out << "* Aggregate {";
     utils::PrintIterable(out, op.aggregations_, ", ",
                          [](auto &out, const auto &aggr) { out << aggr.output_sym.name(); });
     out << "} {";
     utils::PrintIterable(out, op.remember_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
     out << "}";
+    if (op.ordered_group_by_) out << " (ordered)";
+  });
+  return true;
+}
+
+bool PlanPrinter::PreVisit(query::plan::AggregateFromIndex &op) {
+  WithPrintLn(op, [&](auto &out) {
+    out << "* AggregateFromIndex (:" << dba_->LabelToName(op.label_) << ") {";
+    utils::PrintIterable(out, op.aggregations_, ", ",
+                         [](auto &out, const auto &aggr) { out << aggr.output_sym.name(); });
+    out << "}";
   });
   return true;
 }
@@ -174,7 +187,7 @@ PRE_VISIT(Skip);
 PRE_VISIT(Limit);
 
 bool PlanPrinter::PreVisit(query::plan::OrderBy &op) {
-  WithPrintLn([&op](auto &out) {
+  WithPrintLn(op, [&op](auto &out) {
     out << "* OrderBy {";
     utils::PrintIterable(out, op.output_symbols_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
     out << "}";
@@ -183,7 +196,18 @@ bool PlanPrinter::PreVisit(query::plan::OrderBy &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::Merge &op) {
-  WithPrintLn([](auto &out) { out << "* Merge"; });
+  WithPrintLn(op, [](auto &out) { out << "* Merge"; });
+  Branch(*op.merge_match_, "On Match");
+  Branch(*op.merge_create_, "On Create");
+  op.input_->Accept(*this);
+  return false;
+}
+
+bool PlanPrinter::PreVisit(query::plan::MergeByLabelProperty &op) {
+  WithPrintLn(op, [&](auto &out) {
+    out << "* MergeByLabelProperty"
+        << " (:" << dba_->LabelToName(op.label_) << " {" << dba_->PropertyToName(op.property_) << "})";
+  });
   Branch(*op.merge_match_, "On Match");
   Branch(*op.merge_create_, "On Create");
   op.input_->Accept(*this);
@@ -191,17 +215,31 @@ bool PlanPrinter::PreVisit(query::plan::Merge &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::Optional &op) {
-  WithPrintLn([](auto &out) { out << "* Optional"; });
+  WithPrintLn(op, [](auto &out) { out << "* Optional"; });
   Branch(*op.optional_);
   op.input_->Accept(*this);
   return false;
 }
 
+bool PlanPrinter::PreVisit(query::plan::SemiApply &op) {
+  WithPrintLn(op, [&op](auto &out) { out << (op.anti_ ? "* AntiSemiApply" : "* SemiApply"); });
+  Branch(*op.subplan_);
+  op.input_->Accept(*this);
+  return false;
+}
+
+bool PlanPrinter::PreVisit(query::plan::Apply &op) {
+  WithPrintLn(op, [&op](auto &out) { out << (op.in_transactions_ ? "* Apply (in transactions)" : "* Apply"); });
+  Branch(*op.subquery_);
+  op.input_->Accept(*this);
+  return false;
+}
+
 PRE_VISIT(Unwind);
 PRE_VISIT(Distinct);
 
 bool PlanPrinter::PreVisit(query::plan::Union &op) {
-  WithPrintLn([&op](auto &out) {
+  WithPrintLn(op, [&op](auto &out) {
     out << "* Union {";
     utils::PrintIterable(out, op.left_symbols_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
     out << " : ";
@@ -214,7 +252,7 @@ bool PlanPrinter::PreVisit(query::plan::Union &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::CallProcedure &op) {
-  WithPrintLn([&op](auto &out) {
+  WithPrintLn(op, [&op](auto &out) {
     out << "* CallProcedure<" << op.procedure_name_ << "> {";
     utils::PrintIterable(out, op.result_symbols_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
     out << "}";
@@ -223,17 +261,17 @@ bool PlanPrinter::PreVisit(query::plan::CallProcedure &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::LoadCsv &op) {
-  WithPrintLn([&op](auto &out) { out << "* LoadCsv {" << op.row_var_.name() << "}"; });
+  WithPrintLn(op, [&op](auto &out) { out << "* LoadCsv {" << op.row_var_.name() << "}"; });
   return true;
 }
 
-bool PlanPrinter::Visit(query::plan::Once & /*op*/) {
-  WithPrintLn([](auto &out) { out << "* Once"; });
+bool PlanPrinter::Visit(query::plan::Once &op) {
+  WithPrintLn(op, [](auto &out) { out << "* Once"; });
   return true;
 }
 
 bool PlanPrinter::PreVisit(query::plan::Cartesian &op) {
-  WithPrintLn([&op](auto &out) {
+  WithPrintLn(op, [&op](auto &out) {
     out << "* Cartesian {";
     utils::PrintIterable(out, op.left_symbols_, ", ", [](auto &out, const auto &sym) { out << sym.name(); });
     out << " : ";
@@ -246,7 +284,7 @@ bool PlanPrinter::PreVisit(query::plan::Cartesian &op) {
 }
 
 bool PlanPrinter::PreVisit(query::plan::Foreach &op) {
-  WithPrintLn([](auto &out) { out << "* Foreach"; });
+  WithPrintLn(op, [](auto &out) { out << "* Foreach"; });
   Branch(*op.update_clauses_);
   op.input_->Accept(*this);
   return false;
@@ -265,12 +303,34 @@ void PlanPrinter::Branch(query::plan::LogicalOperator &op, const std::string &br
   --depth_;
 }
 
+void PlanPrinter::PrintEstimates(LogicalOperator &op) {
+  if (!estimator_) return;
+  const auto estimates = (*estimator_)(op);
+  *out_ << " [estimated rows: " << estimates.cardinality << ", cost: " << estimates.cost;
+  if (!estimates.index_alternatives.empty()) {
+    *out_ << ", indices: ";
+    utils::PrintIterable(*out_, estimates.index_alternatives, ", ", [this](auto &out, const auto &index) {
+      out << ":" << dba_->LabelToName(index.label);
+      if (index.property) out << " {" << dba_->PropertyToName(*index.property) << "}";
+      out << " " << index.vertices_count;
+      if (index.chosen) out << " (chosen)";
+    });
+  }
+  *out_ << "]";
+}
+
 void PrettyPrint(const DbAccessor &dba, const LogicalOperator *plan_root, std::ostream *out) {
   PlanPrinter printer(&dba, out);
   // FIXME(mtomic): We should make visitors that take const arguments.
   const_cast<LogicalOperator *>(plan_root)->Accept(printer);
 }
 
+void PrettyPrint(const DbAccessor &dba, const LogicalOperator *plan_root, const OperatorEstimator &estimator,
+                 std::ostream *out) {
+  PlanPrinter printer(&dba, out, &estimator);
+  const_cast<LogicalOperator *>(plan_root)->Accept(printer);
+}
+
 nlohmann::json PlanToJson(const DbAccessor &dba, const LogicalOperator *plan_root) {
   impl::PlanToJsonVisitor visitor(&dba);
   // FIXME(mtomic): We should make visitors that take const arguments.
@@ -278,6 +338,12 @@ nlohmann::json PlanToJson(const DbAccessor &dba, const LogicalOperator *plan_roo
   return visitor.output();
 }
 
+nlohmann::json PlanToJson(const DbAccessor &dba, const LogicalOperator *plan_root, const OperatorEstimator &estimator) {
+  impl::PlanToJsonVisitor visitor(&dba, &estimator);
+  const_cast<LogicalOperator *>(plan_root)->Accept(visitor);
+  return visitor.output();
+}
+
 namespace impl {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -406,13 +472,45 @@ json ToJson(const Aggregate::Element &elem) {
 
   return json;
 }
+
+json ToJson(const AggregateFromIndex::Element &elem, const DbAccessor &dba) {
+  json json;
+  if (elem.property) {
+    json["property"] = ToJson(*elem.property, dba);
+  }
+  json["op"] = utils::ToLowerCase(Aggregation::OpToString(elem.op));
+  json["output_symbol"] = ToJson(elem.output_sym);
+
+  return json;
+}
 ////////////////////////// END HELPER FUNCTIONS ////////////////////////////////
 
-bool PlanToJsonVisitor::Visit(Once &) {
+void PlanToJsonVisitor::SetOutput(LogicalOperator &op, json self) {
+  if (estimator_) {
+    const auto estimates = (*estimator_)(op);
+    self["estimated_rows"] = estimates.cardinality;
+    self["estimated_cost"] = estimates.cost;
+    if (!estimates.index_alternatives.empty()) {
+      json indices = json::array();
+      for (const auto &index : estimates.index_alternatives) {
+        json index_json;
+        index_json["label"] = ToJson(index.label, *dba_);
+        index_json["property"] = index.property ? ToJson(*index.property, *dba_) : json();
+        index_json["vertices_count"] = index.vertices_count;
+        index_json["chosen"] = index.chosen;
+        indices.emplace_back(std::move(index_json));
+      }
+      self["index_alternatives"] = std::move(indices);
+    }
+  }
+  output_ = std::move(self);
+}
+
+bool PlanToJsonVisitor::Visit(Once &op) {
   json self;
   self["name"] = "Once";
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -424,7 +522,7 @@ bool PlanToJsonVisitor::PreVisit(ScanAll &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -437,7 +535,7 @@ bool PlanToJsonVisitor::PreVisit(ScanAllByLabel &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -453,7 +551,7 @@ bool PlanToJsonVisitor::PreVisit(ScanAllByLabelPropertyRange &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -468,7 +566,7 @@ bool PlanToJsonVisitor::PreVisit(ScanAllByLabelPropertyValue &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -482,7 +580,7 @@ bool PlanToJsonVisitor::PreVisit(ScanAllByLabelProperty &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -492,7 +590,7 @@ bool PlanToJsonVisitor::PreVisit(ScanAllById &op) {
   self["output_symbol"] = ToJson(op.output_symbol_);
   op.input_->Accept(*this);
   self["input"] = PopOutput();
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -504,7 +602,21 @@ bool PlanToJsonVisitor::PreVisit(CreateNode &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
+  return false;
+}
+
+bool PlanToJsonVisitor::PreVisit(UnwindCreateNode &op) {
+  json self;
+  self["name"] = "UnwindCreateNode";
+  self["output_symbol"] = ToJson(op.output_symbol_);
+  self["input_expression"] = ToJson(op.input_expression_);
+  self["node_info"] = ToJson(op.node_info_, *dba_);
+
+  op.input_->Accept(*this);
+  self["input"] = PopOutput();
+
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -519,7 +631,7 @@ bool PlanToJsonVisitor::PreVisit(CreateExpand &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -536,7 +648,7 @@ bool PlanToJsonVisitor::PreVisit(Expand &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -560,11 +672,14 @@ bool PlanToJsonVisitor::PreVisit(ExpandVariable &op) {
     self["weight_lambda"] = ToJson(op.weight_lambda_->expression);
     self["total_weight_symbol"] = ToJson(*op.total_weight_);
   }
+  if (op.heuristic_lambda_) {
+    self["heuristic_lambda"] = ToJson(op.heuristic_lambda_->expression);
+  }
 
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -577,7 +692,7 @@ bool PlanToJsonVisitor::PreVisit(ConstructNamedPath &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -589,7 +704,7 @@ bool PlanToJsonVisitor::PreVisit(Filter &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -601,7 +716,7 @@ bool PlanToJsonVisitor::PreVisit(Produce &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -614,7 +729,7 @@ bool PlanToJsonVisitor::PreVisit(Delete &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -628,7 +743,7 @@ bool PlanToJsonVisitor::PreVisit(SetProperty &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -650,7 +765,7 @@ bool PlanToJsonVisitor::PreVisit(SetProperties &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -663,7 +778,7 @@ bool PlanToJsonVisitor::PreVisit(SetLabels &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -676,7 +791,7 @@ bool PlanToJsonVisitor::PreVisit(RemoveProperty &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -689,7 +804,7 @@ bool PlanToJsonVisitor::PreVisit(RemoveLabels &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -702,7 +817,7 @@ bool PlanToJsonVisitor::PreVisit(EdgeUniquenessFilter &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -713,7 +828,7 @@ bool PlanToJsonVisitor::PreVisit(EmptyResult &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -726,7 +841,7 @@ bool PlanToJsonVisitor::PreVisit(Accumulate &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -736,11 +851,25 @@ bool PlanToJsonVisitor::PreVisit(Aggregate &op) {
   self["aggregations"] = ToJson(op.aggregations_);
   self["group_by"] = ToJson(op.group_by_);
   self["remember"] = ToJson(op.remember_);
+  self["ordered_group_by"] = op.ordered_group_by_ ? ToJson(op.group_by_[*op.ordered_group_by_]) : json();
 
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
+  return false;
+}
+
+bool PlanToJsonVisitor::PreVisit(AggregateFromIndex &op) {
+  json self;
+  self["name"] = "AggregateFromIndex";
+  self["label"] = ToJson(op.label_, *dba_);
+  self["aggregations"] = ToJson(op.aggregations_, *dba_);
+
+  op.input_->Accept(*this);
+  self["input"] = PopOutput();
+
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -752,7 +881,7 @@ bool PlanToJsonVisitor::PreVisit(Skip &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -764,7 +893,7 @@ bool PlanToJsonVisitor::PreVisit(Limit &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -783,7 +912,7 @@ bool PlanToJsonVisitor::PreVisit(OrderBy &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -800,7 +929,27 @@ bool PlanToJsonVisitor::PreVisit(Merge &op) {
   op.merge_create_->Accept(*this);
   self["merge_create"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
+  return false;
+}
+
+bool PlanToJsonVisitor::PreVisit(MergeByLabelProperty &op) {
+  json self;
+  self["name"] = "MergeByLabelProperty";
+  self["label"] = ToJson(op.label_, *dba_);
+  self["property"] = ToJson(op.property_, *dba_);
+  self["expression"] = ToJson(op.expression_);
+
+  op.input_->Accept(*this);
+  self["input"] = PopOutput();
+
+  op.merge_match_->Accept(*this);
+  self["merge_match"] = PopOutput();
+
+  op.merge_create_->Accept(*this);
+  self["merge_create"] = PopOutput();
+
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -815,7 +964,38 @@ bool PlanToJsonVisitor::PreVisit(Optional &op) {
   op.optional_->Accept(*this);
   self["optional"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
+  return false;
+}
+
+bool PlanToJsonVisitor::PreVisit(SemiApply &op) {
+  json self;
+  self["name"] = op.anti_ ? "AntiSemiApply" : "SemiApply";
+
+  op.input_->Accept(*this);
+  self["input"] = PopOutput();
+
+  op.subplan_->Accept(*this);
+  self["subplan"] = PopOutput();
+
+  SetOutput(op, std::move(self));
+  return false;
+}
+
+bool PlanToJsonVisitor::PreVisit(Apply &op) {
+  json self;
+  self["name"] = "Apply";
+  self["subquery_has_return"] = op.subquery_has_return_;
+  self["in_transactions"] = op.in_transactions_;
+  self["batch_size"] = op.batch_size_ ? ToJson(op.batch_size_) : json();
+
+  op.input_->Accept(*this);
+  self["input"] = PopOutput();
+
+  op.subquery_->Accept(*this);
+  self["subquery"] = PopOutput();
+
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -828,7 +1008,7 @@ bool PlanToJsonVisitor::PreVisit(Unwind &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -843,7 +1023,7 @@ bool PlanToJsonVisitor::PreVisit(query::plan::CallProcedure &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -860,7 +1040,7 @@ bool PlanToJsonVisitor::PreVisit(query::plan::LoadCsv &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -872,7 +1052,7 @@ bool PlanToJsonVisitor::PreVisit(Distinct &op) {
   op.input_->Accept(*this);
   self["input"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -889,7 +1069,7 @@ bool PlanToJsonVisitor::PreVisit(Union &op) {
   op.right_op_->Accept(*this);
   self["right_op"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
@@ -905,7 +1085,7 @@ bool PlanToJsonVisitor::PreVisit(Cartesian &op) {
   op.right_op_->Accept(*this);
   self["right_op"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 bool PlanToJsonVisitor::PreVisit(Foreach &op) {
@@ -920,7 +1100,7 @@ bool PlanToJsonVisitor::PreVisit(Foreach &op) {
   op.update_clauses_->Accept(*this);
   self["update_clauses"] = PopOutput();
 
-  output_ = std::move(self);
+  SetOutput(op, std::move(self));
   return false;
 }
 
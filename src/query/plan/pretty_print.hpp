@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -12,7 +12,10 @@
 /// @file
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <optional>
+#include <vector>
 
 #include <json/json.hpp>
 
@@ -25,6 +28,29 @@ namespace plan {
 
 class LogicalOperator;
 
+/// An index which could have been used by a `ScanAll*` operator, together with
+/// the estimated number of vertices it contains.
+struct IndexAlternative {
+  storage::LabelId label;
+  std::optional<storage::PropertyId> property;
+  int64_t vertices_count;
+  /// True if this is the index the operator actually scans.
+  bool chosen;
+};
+
+/// Planner estimates for a single operator of a plan.
+struct OperatorEstimates {
+  /// Estimated number of rows the operator produces.
+  double cardinality;
+  /// Estimated cost of the subplan rooted at the operator.
+  double cost;
+  /// Indices considered for a `ScanAll*` operator, empty for other operators.
+  std::vector<IndexAlternative> index_alternatives;
+};
+
+/// Produces the estimates of an operator in the plan being printed.
+using OperatorEstimator = std::function<OperatorEstimates(LogicalOperator &)>;
+
 /// Pretty print a `LogicalOperator` plan to a `std::ostream`.
 /// DbAccessor is needed for resolving label and property names.
 /// Note that `plan_root` isn't modified, but we can't take it as a const
@@ -36,21 +62,31 @@ inline void PrettyPrint(const DbAccessor &dba, const LogicalOperator *plan_root)
   PrettyPrint(dba, plan_root, &std::cout);
 }
 
+/// Overload of `PrettyPrint` which appends the estimates produced by
+/// `estimator` to each printed operator.
+void PrettyPrint(const DbAccessor &dba, const LogicalOperator *plan_root, const OperatorEstimator &estimator,
+                 std::ostream *out);
+
 /// Convert a `LogicalOperator` plan to a JSON representation.
 /// DbAccessor is needed for resolving label and property names.
 nlohmann::json PlanToJson(const DbAccessor &dba, const LogicalOperator *plan_root);
 
+/// Overload of `PlanToJson` which adds the estimates produced by `estimator`
+/// to each operator.
+nlohmann::json PlanToJson(const DbAccessor &dba, const LogicalOperator *plan_root, const OperatorEstimator &estimator);
+
 class PlanPrinter : public virtual HierarchicalLogicalOperatorVisitor {
  public:
   using HierarchicalLogicalOperatorVisitor::PostVisit;
   using HierarchicalLogicalOperatorVisitor::PreVisit;
   using HierarchicalLogicalOperatorVisitor::Visit;
 
-  PlanPrinter(const DbAccessor *dba, std::ostream *out);
+  PlanPrinter(const DbAccessor *dba, std::ostream *out, const OperatorEstimator *estimator = nullptr);
 
   bool DefaultPreVisit() override;
 
   bool PreVisit(CreateNode &) override;
+  bool PreVisit(UnwindCreateNode &) override;
   bool PreVisit(CreateExpand &) override;
   bool PreVisit(Delete &) override;
 
@@ -77,13 +113,17 @@ class PlanPrinter : public virtual HierarchicalLogicalOperatorVisitor {
   bool PreVisit(EdgeUniquenessFilter &) override;
 
   bool PreVisit(Merge &) override;
+  bool PreVisit(MergeByLabelProperty &) override;
   bool PreVisit(Optional &) override;
+  bool PreVisit(SemiApply &) override;
+  bool PreVisit(Apply &) override;
   bool PreVisit(Cartesian &) override;
 
   bool PreVisit(EmptyResult &) override;
   bool PreVisit(Produce &) override;
   bool PreVisit(Accumulate &) override;
   bool PreVisit(Aggregate &) override;
+  bool PreVisit(AggregateFromIndex &) override;
   bool PreVisit(Skip &) override;
   bool PreVisit(Limit &) override;
   bool PreVisit(OrderBy &) override;
@@ -109,6 +149,18 @@ class PlanPrinter : public virtual HierarchicalLogicalOperatorVisitor {
     *out_ << std::endl;
   }
 
+  /// Same as `WithPrintLn`, but also prints the estimates of `op` at the end
+  /// of the line when the printer has an estimator.
+  template <class TFun>
+  void WithPrintLn(LogicalOperator &op, TFun fun) {
+    WithPrintLn([&](auto &out) {
+      fun(out);
+      PrintEstimates(op);
+    });
+  }
+
+  void PrintEstimates(LogicalOperator &op);
+
   /// Forward this printer to another operator branch by incrementing the depth
   /// and printing the branch name.
   void Branch(LogicalOperator &op, const std::string &branch_name = "");
@@ -116,6 +168,7 @@ class PlanPrinter : public virtual HierarchicalLogicalOperatorVisitor {
   int64_t depth_{0};
   const DbAccessor *dba_{nullptr};
   std::ostream *out_{nullptr};
+  const OperatorEstimator *estimator_{nullptr};
 };
 
 namespace impl {
@@ -149,6 +202,8 @@ nlohmann::json ToJson(const EdgeCreationInfo &edge_info, const DbAccessor &dba);
 
 nlohmann::json ToJson(const Aggregate::Element &elem);
 
+nlohmann::json ToJson(const AggregateFromIndex::Element &elem, const DbAccessor &dba);
+
 template <class T, class... Args>
 nlohmann::json ToJson(const std::vector<T> &items, Args &&...args) {
   nlohmann::json json;
@@ -160,13 +215,15 @@ nlohmann::json ToJson(const std::vector<T> &items, Args &&...args) {
 
 class PlanToJsonVisitor : public virtual HierarchicalLogicalOperatorVisitor {
  public:
-  explicit PlanToJsonVisitor(const DbAccessor *dba) : dba_(dba) {}
+  explicit PlanToJsonVisitor(const DbAccessor *dba, const OperatorEstimator *estimator = nullptr)
+      : dba_(dba), estimator_(estimator) {}
 
   using HierarchicalLogicalOperatorVisitor::PostVisit;
   using HierarchicalLogicalOperatorVisitor::PreVisit;
   using HierarchicalLogicalOperatorVisitor::Visit;
 
   bool PreVisit(CreateNode &) override;
+  bool PreVisit(UnwindCreateNode &) override;
   bool PreVisit(CreateExpand &) override;
   bool PreVisit(Delete &) override;
 
@@ -183,7 +240,10 @@ class PlanToJsonVisitor : public virtual HierarchicalLogicalOperatorVisitor {
   bool PreVisit(ConstructNamedPath &) override;
 
   bool PreVisit(Merge &) override;
+  bool PreVisit(MergeByLabelProperty &) override;
   bool PreVisit(Optional &) override;
+  bool PreVisit(SemiApply &) override;
+  bool PreVisit(Apply &) override;
 
   bool PreVisit(Filter &) override;
   bool PreVisit(EdgeUniquenessFilter &) override;
@@ -200,6 +260,7 @@ class PlanToJsonVisitor : public virtual HierarchicalLogicalOperatorVisitor {
   bool PreVisit(Produce &) override;
   bool PreVisit(Accumulate &) override;
   bool PreVisit(Aggregate &) override;
+  bool PreVisit(AggregateFromIndex &) override;
   bool PreVisit(Skip &) override;
   bool PreVisit(Limit &) override;
   bool PreVisit(OrderBy &) override;
@@ -218,12 +279,17 @@ class PlanToJsonVisitor : public virtual HierarchicalLogicalOperatorVisitor {
  protected:
   nlohmann::json output_;
   const DbAccessor *dba_;
+  const OperatorEstimator *estimator_;
 
   nlohmann::json PopOutput() {
     nlohmann::json tmp;
     tmp.swap(output_);
     return tmp;
   }
+
+  /// Set `self` as the output, adding the estimates of `op` when the visitor
+  /// has an estimator.
+  void SetOutput(LogicalOperator &op, nlohmann::json self);
 };
 
 }  // namespace impl
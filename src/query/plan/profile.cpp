@@ -19,9 +19,23 @@
 
 #include "query/context.hpp"
 #include "utils/likely.hpp"
+#include "utils/readable_size.hpp"
 
 namespace memgraph::query::plan {
 
+void *ProfilingMemoryResource::DoAllocate(size_t bytes, size_t alignment) {
+  auto *ptr = upstream_->Allocate(bytes, alignment);
+  usage_->allocated += static_cast<int64_t>(bytes);
+  usage_->in_use += static_cast<int64_t>(bytes);
+  usage_->peak = std::max(usage_->peak, usage_->in_use);
+  return ptr;
+}
+
+void ProfilingMemoryResource::DoDeallocate(void *p, size_t bytes, size_t alignment) {
+  upstream_->Deallocate(p, bytes, alignment);
+  usage_->in_use -= static_cast<int64_t>(bytes);
+}
+
 namespace {
 
 unsigned long long IndividualCycles(const ProfilingStats &cumulative_stats) {
@@ -30,6 +44,24 @@ unsigned long long IndividualCycles(const ProfilingStats &cumulative_stats) {
                                                        [](auto acc, auto &stats) { return acc + stats.num_cycles; });
 }
 
+int64_t IndividualAllocatedBytes(const ProfilingStats &cumulative_stats) {
+  return cumulative_stats.allocated_bytes -
+         std::accumulate(cumulative_stats.children.begin(), cumulative_stats.children.end(), int64_t{0},
+                         [](auto acc, auto &stats) { return acc + stats.allocated_bytes; });
+}
+
+uint64_t IndividualCpuCycles(const ProfilingStats &cumulative_stats) {
+  return cumulative_stats.num_cpu_cycles -
+         std::accumulate(cumulative_stats.children.begin(), cumulative_stats.children.end(), uint64_t{0},
+                         [](auto acc, auto &stats) { return acc + stats.num_cpu_cycles; });
+}
+
+uint64_t IndividualCacheMisses(const ProfilingStats &cumulative_stats) {
+  return cumulative_stats.num_cache_misses -
+         std::accumulate(cumulative_stats.children.begin(), cumulative_stats.children.end(), uint64_t{0},
+                         [](auto acc, auto &stats) { return acc + stats.num_cache_misses; });
+}
+
 double RelativeTime(unsigned long long num_cycles, unsigned long long total_cycles) {
   return static_cast<double>(num_cycles) / total_cycles;
 }
@@ -50,15 +82,31 @@ namespace {
 
 class ProfilingStatsToTableHelper {
  public:
-  ProfilingStatsToTableHelper(unsigned long long total_cycles, std::chrono::duration<double> total_time)
-      : total_cycles_(total_cycles), total_time_(total_time) {}
+  explicit ProfilingStatsToTableHelper(const ProfilingStatsWithTotalTime &stats)
+      : total_cycles_(stats.cumulative_stats.num_cycles),
+        total_time_(stats.total_time),
+        report_hardware_counters_(stats.report_hardware_counters),
+        hardware_counters_available_(stats.hardware_counters_available) {}
 
   void Output(const ProfilingStats &cumulative_stats) {
     auto cycles = IndividualCycles(cumulative_stats);
 
-    rows_.emplace_back(std::vector<TypedValue>{
-        TypedValue(FormatOperator(cumulative_stats.name)), TypedValue(cumulative_stats.actual_hits),
-        TypedValue(FormatRelativeTime(cycles)), TypedValue(FormatAbsoluteTime(cycles))});
+    std::vector<TypedValue> row{TypedValue(FormatOperator(cumulative_stats.name)),
+                                TypedValue(cumulative_stats.actual_hits),
+                                TypedValue(FormatRelativeTime(cycles)),
+                                TypedValue(FormatAbsoluteTime(cycles)),
+                                TypedValue(FormatMemory(IndividualAllocatedBytes(cumulative_stats))),
+                                TypedValue(FormatMemory(cumulative_stats.peak_memory_bytes))};
+    if (report_hardware_counters_) {
+      if (hardware_counters_available_) {
+        row.emplace_back(static_cast<int64_t>(IndividualCpuCycles(cumulative_stats)));
+        row.emplace_back(static_cast<int64_t>(IndividualCacheMisses(cumulative_stats)));
+      } else {
+        row.emplace_back();
+        row.emplace_back();
+      }
+    }
+    rows_.emplace_back(std::move(row));
 
     for (size_t i = 1; i < cumulative_stats.children.size(); ++i) {
       Branch(cumulative_stats.children[i]);
@@ -73,7 +121,9 @@ class ProfilingStatsToTableHelper {
 
  private:
   void Branch(const ProfilingStats &cumulative_stats) {
-    rows_.emplace_back(std::vector<TypedValue>{TypedValue("|\\"), TypedValue(""), TypedValue(""), TypedValue("")});
+    std::vector<TypedValue> row(report_hardware_counters_ ? 8 : 6, TypedValue(""));
+    row[0] = TypedValue("|\\");
+    rows_.emplace_back(std::move(row));
 
     ++depth_;
     Output(cumulative_stats);
@@ -101,16 +151,20 @@ class ProfilingStatsToTableHelper {
     return fmt::format("{: 10.6f} ms", AbsoluteTime(num_cycles, total_cycles_, total_time_));
   }
 
+  static std::string FormatMemory(int64_t bytes) { return utils::GetReadableSize(static_cast<double>(bytes)); }
+
   int64_t depth_{0};
   std::vector<std::vector<TypedValue>> rows_;
   unsigned long long total_cycles_;
   std::chrono::duration<double> total_time_;
+  bool report_hardware_counters_;
+  bool hardware_counters_available_;
 };
 
 }  // namespace
 
 std::vector<std::vector<TypedValue>> ProfilingStatsToTable(const ProfilingStatsWithTotalTime &stats) {
-  ProfilingStatsToTableHelper helper{stats.cumulative_stats.num_cycles, stats.total_time};
+  ProfilingStatsToTableHelper helper{stats};
   helper.Output(stats.cumulative_stats);
   return helper.rows();
 }
@@ -126,8 +180,11 @@ class ProfilingStatsToJsonHelper {
   using json = nlohmann::json;
 
  public:
-  ProfilingStatsToJsonHelper(unsigned long long total_cycles, std::chrono::duration<double> total_time)
-      : total_cycles_(total_cycles), total_time_(total_time) {}
+  explicit ProfilingStatsToJsonHelper(const ProfilingStatsWithTotalTime &stats)
+      : total_cycles_(stats.cumulative_stats.num_cycles),
+        total_time_(stats.total_time),
+        report_hardware_counters_(stats.report_hardware_counters),
+        hardware_counters_available_(stats.hardware_counters_available) {}
 
   void Output(const ProfilingStats &cumulative_stats) { return Output(cumulative_stats, &json_); }
 
@@ -141,6 +198,17 @@ class ProfilingStatsToJsonHelper {
     obj->emplace("actual_hits", cumulative_stats.actual_hits);
     obj->emplace("relative_time", RelativeTime(cycles, total_cycles_));
     obj->emplace("absolute_time", AbsoluteTime(cycles, total_cycles_, total_time_));
+    obj->emplace("allocated_memory", IndividualAllocatedBytes(cumulative_stats));
+    obj->emplace("peak_memory", cumulative_stats.peak_memory_bytes);
+    if (report_hardware_counters_) {
+      if (hardware_counters_available_) {
+        obj->emplace("cpu_cycles", IndividualCpuCycles(cumulative_stats));
+        obj->emplace("cache_misses", IndividualCacheMisses(cumulative_stats));
+      } else {
+        obj->emplace("cpu_cycles", nullptr);
+        obj->emplace("cache_misses", nullptr);
+      }
+    }
     obj->emplace("children", json::array());
 
     for (size_t i = 0; i < cumulative_stats.children.size(); ++i) {
@@ -153,12 +221,14 @@ class ProfilingStatsToJsonHelper {
   json json_;
   unsigned long long total_cycles_;
   std::chrono::duration<double> total_time_;
+  bool report_hardware_counters_;
+  bool hardware_counters_available_;
 };
 
 }  // namespace
 
 nlohmann::json ProfilingStatsToJson(const ProfilingStatsWithTotalTime &stats) {
-  ProfilingStatsToJsonHelper helper{stats.cumulative_stats.num_cycles, stats.total_time};
+  ProfilingStatsToJsonHelper helper{stats};
   helper.Output(stats.cumulative_stats);
   return helper.ToJson();
 }
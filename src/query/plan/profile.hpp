@@ -17,6 +17,7 @@
 #include <json/json.hpp>
 
 #include "query/typed_value.hpp"
+#include "utils/memory.hpp"
 
 namespace memgraph::query {
 
@@ -32,11 +33,54 @@ struct ProfilingStats {
   const char *name{nullptr};
   // TODO: This should use the allocator for query execution
   std::vector<ProfilingStats> children;
+  // Bytes allocated by the operator and the operators it pulled from.
+  int64_t allocated_bytes{0};
+  // The largest growth of the memory in use during a single pull from the
+  // operator, including the memory used by the operators it pulled from.
+  int64_t peak_memory_bytes{0};
+  uint64_t num_cpu_cycles{0};
+  uint64_t num_cache_misses{0};
 };
 
 struct ProfilingStatsWithTotalTime {
   ProfilingStats cumulative_stats{};
   std::chrono::duration<double> total_time{};
+  // Whether the hardware counters are part of the output.
+  bool report_hardware_counters{false};
+  // Whether the hardware counters could be read during the execution. If they
+  // are reported but not available, null is reported for them.
+  bool hardware_counters_available{false};
+};
+
+/**
+ * Memory usage of a profiled query, as seen by `ProfilingMemoryResource`.
+ */
+struct ProfilingMemoryUsage {
+  int64_t allocated{0};
+  int64_t in_use{0};
+  int64_t peak{0};
+};
+
+/**
+ * A MemoryResource which records the memory allocated through it in
+ * `ProfilingMemoryUsage` and forwards the allocations to the upstream resource.
+ * The memory usage is then attributed to the logical operators by
+ * `ScopedProfile`.
+ */
+class ProfilingMemoryResource final : public utils::MemoryResource {
+ public:
+  ProfilingMemoryResource(utils::MemoryResource *upstream, ProfilingMemoryUsage *usage)
+      : upstream_(upstream), usage_(usage) {}
+
+ private:
+  void *DoAllocate(size_t bytes, size_t alignment) override;
+
+  void DoDeallocate(void *p, size_t bytes, size_t alignment) override;
+
+  bool DoIsEqual(const utils::MemoryResource &other) const noexcept override { return this == &other; }
+
+  utils::MemoryResource *upstream_;
+  ProfilingMemoryUsage *usage_;
 };
 
 std::vector<std::vector<TypedValue>> ProfilingStatsToTable(const ProfilingStatsWithTotalTime &stats);
@@ -21,6 +21,7 @@
 namespace memgraph::query::plan {
 
 PRE_VISIT(CreateNode, RWType::W, true)
+PRE_VISIT(UnwindCreateNode, RWType::W, true)
 PRE_VISIT(CreateExpand, RWType::R, true)
 PRE_VISIT(Delete, RWType::W, true)
 
@@ -47,7 +48,10 @@ PRE_VISIT(Filter, RWType::NONE, true)
 PRE_VISIT(EdgeUniquenessFilter, RWType::NONE, true)
 
 PRE_VISIT(Merge, RWType::RW, false)
+PRE_VISIT(MergeByLabelProperty, RWType::RW, false)
 PRE_VISIT(Optional, RWType::NONE, true)
+PRE_VISIT(SemiApply, RWType::NONE, true)
+PRE_VISIT(Apply, RWType::NONE, true)
 
 bool ReadWriteTypeChecker::PreVisit(Cartesian &op) {
   op.left_op_->Accept(*this);
@@ -59,6 +63,7 @@ PRE_VISIT(EmptyResult, RWType::NONE, true)
 PRE_VISIT(Produce, RWType::NONE, true)
 PRE_VISIT(Accumulate, RWType::NONE, true)
 PRE_VISIT(Aggregate, RWType::NONE, true)
+PRE_VISIT(AggregateFromIndex, RWType::R, true)
 PRE_VISIT(Skip, RWType::NONE, true)
 PRE_VISIT(Limit, RWType::NONE, true)
 PRE_VISIT(OrderBy, RWType::NONE, true)
@@ -44,6 +44,7 @@ struct ReadWriteTypeChecker : public virtual HierarchicalLogicalOperatorVisitor
   static std::string TypeToString(const RWType type);
 
   bool PreVisit(CreateNode &) override;
+  bool PreVisit(UnwindCreateNode &) override;
   bool PreVisit(CreateExpand &) override;
   bool PreVisit(Delete &) override;
 
@@ -70,13 +71,17 @@ struct ReadWriteTypeChecker : public virtual HierarchicalLogicalOperatorVisitor
   bool PreVisit(EdgeUniquenessFilter &) override;
 
   bool PreVisit(Merge &) override;
+  bool PreVisit(MergeByLabelProperty &) override;
   bool PreVisit(Optional &) override;
+  bool PreVisit(SemiApply &) override;
+  bool PreVisit(Apply &) override;
   bool PreVisit(Cartesian &) override;
 
   bool PreVisit(EmptyResult &) override;
   bool PreVisit(Produce &) override;
   bool PreVisit(Accumulate &) override;
   bool PreVisit(Aggregate &) override;
+  bool PreVisit(AggregateFromIndex &) override;
   bool PreVisit(Skip &) override;
   bool PreVisit(Limit &) override;
   bool PreVisit(OrderBy &) override;
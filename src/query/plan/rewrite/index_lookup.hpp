@@ -27,6 +27,7 @@
 
 #include "query/plan/operator.hpp"
 #include "query/plan/preprocess.hpp"
+#include "query/plan/read_write_type_checker.hpp"
 
 DECLARE_int64(query_vertex_count_to_expand_existing);
 
@@ -41,8 +42,8 @@ Expression *RemoveAndExpressions(Expression *expr, const std::unordered_set<Expr
 template <class TDbAccessor>
 class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
  public:
-  IndexLookupRewriter(SymbolTable *symbol_table, AstStorage *ast_storage, TDbAccessor *db)
-      : symbol_table_(symbol_table), ast_storage_(ast_storage), db_(db) {}
+  IndexLookupRewriter(SymbolTable *symbol_table, AstStorage *ast_storage, TDbAccessor *db, bool plan_is_read_only)
+      : symbol_table_(symbol_table), ast_storage_(ast_storage), db_(db), plan_is_read_only_(plan_is_read_only) {}
 
   using HierarchicalLogicalOperatorVisitor::PostVisit;
   using HierarchicalLogicalOperatorVisitor::PreVisit;
@@ -148,7 +149,30 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     return false;
   }
 
-  bool PostVisit(Merge &) override {
+  // Replace Merge of a single node, which is looked up by a label-property
+  // index, with MergeByLabelProperty in PostVisit, because only then the
+  // merge_match_ branch has already been rewritten to use the index.
+  bool PostVisit(Merge &op) override {
+    prev_ops_.pop_back();
+    // Merge may also be the root, e.g. of the FOREACH update clauses.
+    if (!prev_ops_.empty() && (!prev_ops_.back()->HasSingleInput() || prev_ops_.back()->input().get() != &op)) {
+      return true;
+    }
+    auto merge_by_label_property = GenMergeByLabelProperty(op);
+    if (merge_by_label_property) {
+      SetOnParent(std::move(merge_by_label_property));
+    }
+    return true;
+  }
+
+  bool PreVisit(MergeByLabelProperty &op) override {
+    prev_ops_.push_back(&op);
+    op.input()->Accept(*this);
+    RewriteBranch(&op.merge_match_);
+    return false;
+  }
+
+  bool PostVisit(MergeByLabelProperty &) override {
     prev_ops_.pop_back();
     return true;
   }
@@ -165,6 +189,30 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     return true;
   }
 
+  bool PreVisit(SemiApply &op) override {
+    prev_ops_.push_back(&op);
+    op.input()->Accept(*this);
+    RewriteBranch(&op.subplan_);
+    return false;
+  }
+
+  bool PostVisit(SemiApply &) override {
+    prev_ops_.pop_back();
+    return true;
+  }
+
+  bool PreVisit(Apply &op) override {
+    prev_ops_.push_back(&op);
+    op.input()->Accept(*this);
+    RewriteBranch(&op.subquery_);
+    return false;
+  }
+
+  bool PostVisit(Apply &) override {
+    prev_ops_.pop_back();
+    return true;
+  }
+
   // Rewriting Cartesian assumes that the input plan will have Filter operations
   // as soon as they are possible. Therefore we do not track filters above
   // Cartesian because they should be irrelevant.
@@ -226,6 +274,15 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     return true;
   }
 
+  bool PreVisit(UnwindCreateNode &op) override {
+    prev_ops_.push_back(&op);
+    return true;
+  }
+  bool PostVisit(UnwindCreateNode &) override {
+    prev_ops_.pop_back();
+    return true;
+  }
+
   bool PreVisit(CreateExpand &op) override {
     prev_ops_.push_back(&op);
     return true;
@@ -383,7 +440,28 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     prev_ops_.push_back(&op);
     return true;
   }
-  bool PostVisit(Aggregate &) override {
+
+  // Replace Aggregate over ScanAllByLabel with AggregateFromIndex in
+  // PostVisit, because only then the ScanAll has already been replaced.
+  // For the same reason, the ordering of the input is also checked here.
+  bool PostVisit(Aggregate &op) override {
+    prev_ops_.pop_back();
+    op.ordered_group_by_ = FindOrderedGroupBy(op);
+    if (prev_ops_.empty() || !prev_ops_.back()->HasSingleInput()) return true;
+    auto aggregate = prev_ops_.back()->input();
+    if (aggregate.get() != &op) return true;
+    auto aggregate_from_index = GenAggregateFromIndex(op, aggregate);
+    if (aggregate_from_index) {
+      SetOnParent(std::move(aggregate_from_index));
+    }
+    return true;
+  }
+
+  bool PreVisit(AggregateFromIndex &op) override {
+    prev_ops_.push_back(&op);
+    return true;
+  }
+  bool PostVisit(AggregateFromIndex &) override {
     prev_ops_.pop_back();
     return true;
   }
@@ -460,6 +538,8 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
   SymbolTable *symbol_table_;
   AstStorage *ast_storage_;
   TDbAccessor *db_;
+  // Aggregations are streamed only if nothing in the plan writes.
+  bool plan_is_read_only_;
   // Collected filters, pending for examination if they can be used for advanced
   // lookup operations (by index, node ID, ...).
   Filters filters_;
@@ -487,7 +567,7 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
   }
 
   void RewriteBranch(std::shared_ptr<LogicalOperator> *branch) {
-    IndexLookupRewriter<TDbAccessor> rewriter(symbol_table_, ast_storage_, db_);
+    IndexLookupRewriter<TDbAccessor> rewriter(symbol_table_, ast_storage_, db_, plan_is_read_only_);
     (*branch)->Accept(rewriter);
     if (rewriter.new_root_) {
       *branch = rewriter.new_root_;
@@ -656,6 +736,122 @@ class IndexLookupRewriter final : public HierarchicalLogicalOperatorVisitor {
     filter_exprs_for_removal_.insert(removed_expressions.begin(), removed_expressions.end());
     return std::make_unique<ScanAllByLabel>(input, node_symbol, GetLabel(label), view);
   }
+
+  // Creates an AggregateFromIndex which computes the aggregations of `op`
+  // directly from the indices. This is possible only when `op` doesn't group,
+  // reads straight from a ScanAllByLabel which is the first operator in the
+  // plan and each aggregation is either a COUNT of the scanned vertices, or a
+  // COUNT, MIN or MAX of a property that has a label-property index. If any
+  // of the conditions isn't satisfied, `nullptr` is returned. The original
+  // `aggregate` is kept as the fallback of the new operator.
+  std::unique_ptr<AggregateFromIndex> GenAggregateFromIndex(const Aggregate &op,
+                                                            const std::shared_ptr<LogicalOperator> &aggregate) {
+    if (!op.group_by_.empty() || !op.remember_.empty()) return nullptr;
+    if (op.input()->GetTypeInfo() != ScanAllByLabel::kType) return nullptr;
+    const auto &scan = dynamic_cast<const ScanAllByLabel &>(*op.input());
+    if (scan.input()->GetTypeInfo() != Once::kType) return nullptr;
+    auto is_scanned_node = [this, &scan](Expression *expression) {
+      auto *identifier = utils::Downcast<Identifier>(expression);
+      return identifier && symbol_table_->at(*identifier) == scan.output_symbol_;
+    };
+    std::vector<AggregateFromIndex::Element> aggregations;
+    aggregations.reserve(op.aggregations_.size());
+    for (const auto &elem : op.aggregations_) {
+      if (elem.op == Aggregation::Op::COUNT && (!elem.value || is_scanned_node(elem.value))) {
+        aggregations.push_back({elem.op, std::nullopt, elem.output_sym});
+        continue;
+      }
+      if (elem.op != Aggregation::Op::COUNT && elem.op != Aggregation::Op::MIN && elem.op != Aggregation::Op::MAX) {
+        return nullptr;
+      }
+      // Distinct doesn't change MIN and MAX, but counting distinct values
+      // can't be done from the index.
+      if (elem.op == Aggregation::Op::COUNT && elem.distinct) return nullptr;
+      auto *property_lookup = utils::Downcast<PropertyLookup>(elem.value);
+      if (!property_lookup || !is_scanned_node(property_lookup->expression_)) return nullptr;
+      const auto property = GetProperty(property_lookup->property_);
+      if (!db_->LabelPropertyIndexExists(scan.label_, property)) return nullptr;
+      aggregations.push_back({elem.op, property, elem.output_sym});
+    }
+    return std::make_unique<AggregateFromIndex>(scan.input(), aggregate, scan.label_, aggregations, scan.view_);
+  }
+
+  // Returns the position of the group-by expression of `op` by which its
+  // input is ordered. That is a lookup of the property scanned by a
+  // label-property index scan at the start of the plan, when the operators
+  // between the scan and `op` keep the order of the scanned vertices. The
+  // index yields the vertices ordered by the property value. Returns
+  // `std::nullopt` if there is no such expression.
+  std::optional<size_t> FindOrderedGroupBy(const Aggregate &op) {
+    if (!plan_is_read_only_ || op.group_by_.empty()) return std::nullopt;
+    auto keeps_order = [](const LogicalOperator &input) {
+      static const std::vector<utils::TypeInfo> kOrderKeepingOps{
+          Filter::kType,  Expand::kType,   ExpandVariable::kType, ConstructNamedPath::kType, EdgeUniquenessFilter::kType,
+          Unwind::kType,  Optional::kType, SemiApply::kType,      ScanAll::kType,            ScanAllByLabel::kType,
+          ScanAllById::kType};
+      return std::find(kOrderKeepingOps.begin(), kOrderKeepingOps.end(), input.GetTypeInfo()) !=
+             kOrderKeepingOps.end();
+    };
+    auto ordered_by = [](const LogicalOperator &input) -> std::optional<std::pair<Symbol, storage::PropertyId>> {
+      if (const auto *scan = dynamic_cast<const ScanAllByLabelPropertyRange *>(&input)) {
+        return std::make_pair(scan->output_symbol_, scan->property_);
+      }
+      if (const auto *scan = dynamic_cast<const ScanAllByLabelPropertyValue *>(&input)) {
+        return std::make_pair(scan->output_symbol_, scan->property_);
+      }
+      if (const auto *scan = dynamic_cast<const ScanAllByLabelProperty *>(&input)) {
+        return std::make_pair(scan->output_symbol_, scan->property_);
+      }
+      return std::nullopt;
+    };
+    const LogicalOperator *input = op.input().get();
+    // An index scan which isn't at the start of the plan is run once for each
+    // of its input rows, so it keeps their order like the other scans.
+    while (input->HasSingleInput() && input->input()->GetTypeInfo() != Once::kType) {
+      if (!keeps_order(*input) && !ordered_by(*input)) return std::nullopt;
+      input = input->input().get();
+    }
+    const auto scanned = ordered_by(*input);
+    if (!scanned) return std::nullopt;
+    for (size_t pos = 0; pos < op.group_by_.size(); ++pos) {
+      auto *property_lookup = utils::Downcast<PropertyLookup>(op.group_by_[pos]);
+      if (!property_lookup) continue;
+      auto *identifier = utils::Downcast<Identifier>(property_lookup->expression_);
+      if (identifier && symbol_table_->at(*identifier) == scanned->first &&
+          GetProperty(property_lookup->property_) == scanned->second) {
+        return pos;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Creates a MergeByLabelProperty from `op` when its merge_match_ branch
+  // looks the node up with ScanAllByLabelPropertyValue, which is the first
+  // operator in the branch, and its merge_create_ branch creates only that
+  // node. Otherwise, `nullptr` is returned.
+  std::unique_ptr<MergeByLabelProperty> GenMergeByLabelProperty(const Merge &op) {
+    const ScanAllByLabelPropertyValue *scan = nullptr;
+    for (auto *match_op = op.merge_match_.get(); match_op->HasSingleInput(); match_op = match_op->input().get()) {
+      if (match_op->GetTypeInfo() == ScanAllByLabelPropertyValue::kType) {
+        scan = dynamic_cast<const ScanAllByLabelPropertyValue *>(match_op);
+        break;
+      }
+    }
+    if (!scan || scan->input()->GetTypeInfo() != Once::kType) return nullptr;
+    // ON CREATE SET clauses are planned on top of the created node.
+    bool creates_scanned_node = false;
+    for (auto *create_op = op.merge_create_.get(); create_op->HasSingleInput();
+         create_op = create_op->input().get()) {
+      if (create_op->GetTypeInfo() == CreateExpand::kType) return nullptr;
+      if (create_op->GetTypeInfo() != CreateNode::kType) continue;
+      const auto &create = dynamic_cast<const CreateNode &>(*create_op);
+      if (creates_scanned_node || create.node_info_.symbol != scan->output_symbol_) return nullptr;
+      creates_scanned_node = true;
+    }
+    if (!creates_scanned_node) return nullptr;
+    return std::make_unique<MergeByLabelProperty>(op.input(), op.merge_match_, op.merge_create_, scan->label_,
+                                                  scan->property_, scan->expression_);
+  }
 };
 
 }  // namespace impl
@@ -664,7 +860,13 @@ template <class TDbAccessor>
 std::unique_ptr<LogicalOperator> RewriteWithIndexLookup(std::unique_ptr<LogicalOperator> root_op,
                                                         SymbolTable *symbol_table, AstStorage *ast_storage,
                                                         TDbAccessor *db) {
-  impl::IndexLookupRewriter<TDbAccessor> rewriter(symbol_table, ast_storage, db);
+  // Streamed aggregations produce results before reading their whole input,
+  // so the operators after them mustn't write anything the input could see.
+  ReadWriteTypeChecker rw_type_checker;
+  rw_type_checker.InferRWType(*root_op);
+  const bool plan_is_read_only = rw_type_checker.type == ReadWriteTypeChecker::RWType::NONE ||
+                                 rw_type_checker.type == ReadWriteTypeChecker::RWType::R;
+  impl::IndexLookupRewriter<TDbAccessor> rewriter(symbol_table, ast_storage, db, plan_is_read_only);
   root_op->Accept(rewriter);
   if (rewriter.new_root_) {
     // This shouldn't happen in real use case, because IndexLookupRewriter
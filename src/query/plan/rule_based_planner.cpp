@@ -467,7 +467,8 @@ std::unique_ptr<LogicalOperator> GenReturnBody(std::unique_ptr<LogicalOperator>
     // We only advance the command in Accumulate. This is done for WITH clause,
     // when the first part updated the database. RETURN clause may only need an
     // accumulation after updates, without advancing the command.
-    last_op = std::make_unique<Accumulate>(std::move(last_op), used_symbols, advance_command);
+    last_op =
+        std::make_unique<Accumulate>(impl::FuseUnwindCreateNode(std::move(last_op)), used_symbols, advance_command);
   }
   if (!body.aggregations().empty()) {
     // When we have aggregation, SKIP/LIMIT should always come after it.
@@ -507,7 +508,7 @@ namespace impl {
 Expression *ExtractFilters(const std::unordered_set<Symbol> &bound_symbols, Filters &filters, AstStorage &storage) {
   Expression *filter_expr = nullptr;
   for (auto filters_it = filters.begin(); filters_it != filters.end();) {
-    if (HasBoundFilterSymbols(bound_symbols, *filters_it)) {
+    if (filters_it->type != FilterInfo::Type::Pattern && HasBoundFilterSymbols(bound_symbols, *filters_it)) {
       filter_expr = impl::BoolJoin<AndOperator>(storage, filter_expr, filters_it->expression);
       filters_it = filters.erase(filters_it);
     } else {
@@ -527,6 +528,19 @@ std::unique_ptr<LogicalOperator> GenFilters(std::unique_ptr<LogicalOperator> las
   return last_op;
 }
 
+std::vector<FilterInfo> ExtractPatternFilters(const std::unordered_set<Symbol> &bound_symbols, Filters &filters) {
+  std::vector<FilterInfo> pattern_filters;
+  for (auto filters_it = filters.begin(); filters_it != filters.end();) {
+    if (filters_it->type == FilterInfo::Type::Pattern && HasBoundFilterSymbols(bound_symbols, *filters_it)) {
+      pattern_filters.push_back(*filters_it);
+      filters_it = filters.erase(filters_it);
+    } else {
+      filters_it++;
+    }
+  }
+  return pattern_filters;
+}
+
 std::unique_ptr<LogicalOperator> GenNamedPaths(std::unique_ptr<LogicalOperator> last_op,
                                                std::unordered_set<Symbol> &bound_symbols,
                                                std::unordered_map<Symbol, std::vector<Symbol>> &named_paths) {
@@ -584,6 +598,27 @@ std::unique_ptr<LogicalOperator> GenWith(With &with, std::unique_ptr<LogicalOper
   return last_op;
 }
 
+std::unique_ptr<LogicalOperator> FuseUnwindCreateNode(std::unique_ptr<LogicalOperator> last_op) {
+  auto fuse = [](const LogicalOperator &op) -> std::unique_ptr<LogicalOperator> {
+    if (op.GetTypeInfo() != CreateNode::kType || op.input()->GetTypeInfo() != Unwind::kType) return nullptr;
+    const auto &create = dynamic_cast<const CreateNode &>(op);
+    const auto &unwind = dynamic_cast<const Unwind &>(*op.input());
+    return std::make_unique<UnwindCreateNode>(unwind.input(), unwind.input_expression_, unwind.output_symbol_,
+                                              create.node_info_);
+  };
+  if (auto fused = fuse(*last_op)) return fused;
+  // Creating nodes and edges doesn't read the graph, so the creations planned
+  // after the CREATE of the first node are skipped.
+  for (auto *op = last_op.get(); op->GetTypeInfo() == CreateNode::kType || op->GetTypeInfo() == CreateExpand::kType;
+       op = op->input().get()) {
+    if (auto fused = fuse(*op->input())) {
+      op->set_input(std::move(fused));
+      break;
+    }
+  }
+  return last_op;
+}
+
 std::unique_ptr<LogicalOperator> GenUnion(const CypherUnion &cypher_union, std::shared_ptr<LogicalOperator> left_op,
                                           std::shared_ptr<LogicalOperator> right_op, SymbolTable &symbol_table) {
   return std::make_unique<Union>(left_op, right_op, cypher_union.union_symbols_, left_op->OutputSymbols(symbol_table),
@@ -21,6 +21,7 @@
 #include "query/frontend/ast/ast_visitor.hpp"
 #include "query/plan/operator.hpp"
 #include "query/plan/preprocess.hpp"
+#include "query/plan/read_write_type_checker.hpp"
 #include "utils/logging.hpp"
 #include "utils/typeinfo.hpp"
 
@@ -84,6 +85,18 @@ Expression *ExtractFilters(const std::unordered_set<Symbol> &, Filters &, AstSto
 std::unique_ptr<LogicalOperator> GenFilters(std::unique_ptr<LogicalOperator>, const std::unordered_set<Symbol> &,
                                             Filters &, AstStorage &);
 
+// Removes the pattern filters whose used symbols are bound from `Filters` and
+// returns them. Pattern filters are never joined by `ExtractFilters`, because
+// they need to be planned as a SemiApply.
+std::vector<FilterInfo> ExtractPatternFilters(const std::unordered_set<Symbol> &, Filters &);
+
+// Replaces `Unwind` followed by `CreateNode` with `UnwindCreateNode` if only
+// other creations follow them up to the given operator, which must end the
+// query part (`EmptyResult` or `Accumulate` is planned on top of it). The nodes
+// are then created ahead of the rows, which nothing may observe by reading the
+// graph in between.
+std::unique_ptr<LogicalOperator> FuseUnwindCreateNode(std::unique_ptr<LogicalOperator>);
+
 /// Utility function for iterating pattern atoms and accumulating a result.
 ///
 /// Each pattern is of the form `NodeAtom (, EdgeAtom, NodeAtom)*`. Therefore,
@@ -184,6 +197,7 @@ class RuleBasedPlanner {
         }
       }
       uint64_t merge_id = 0;
+      uint64_t subquery_id = 0;
       for (const auto &clause : query_part.remaining_clauses) {
         MG_ASSERT(!utils::IsSubtype(*clause, Match::kType), "Unexpected Match in remaining clauses");
         if (auto *ret = utils::Downcast<Return>(clause)) {
@@ -234,6 +248,9 @@ class RuleBasedPlanner {
           is_write = true;
           input_op = HandleForeachClause(foreach, std::move(input_op), *context.symbol_table, context.bound_symbols,
                                          query_part, merge_id);
+        } else if (auto *call_subquery = utils::Downcast<query::CallSubquery>(clause)) {
+          input_op = HandleCallSubquery(*call_subquery, std::move(input_op), query_part.subqueries[subquery_id++],
+                                        is_write);
         } else {
           throw utils::NotYetImplemented("clause '{}' conversion to operator(s)", clause->GetTypeInfo().name);
         }
@@ -241,7 +258,7 @@ class RuleBasedPlanner {
     }
     // Is this the only situation that should be covered
     if (input_op->OutputSymbols(*context.symbol_table).empty()) {
-      input_op = std::make_unique<EmptyResult>(std::move(input_op));
+      input_op = std::make_unique<EmptyResult>(impl::FuseUnwindCreateNode(std::move(input_op)));
     }
     return input_op;
   }
@@ -398,16 +415,16 @@ class RuleBasedPlanner {
     // Try to generate any filters even before the 1st match operator. This
     // optimizes the optional match which filters only on symbols bound in
     // regular match.
-    auto last_op = impl::GenFilters(std::move(input_op), bound_symbols, filters, storage);
+    auto last_op = GenFilters(std::move(input_op), bound_symbols, filters);
     for (const auto &expansion : matching.expansions) {
       const auto &node1_symbol = symbol_table.at(*expansion.node1->identifier_);
       if (bound_symbols.insert(node1_symbol).second) {
         // We have just bound this symbol, so generate ScanAll which fills it.
         last_op = std::make_unique<ScanAll>(std::move(last_op), node1_symbol, match_context.view);
         match_context.new_symbols.emplace_back(node1_symbol);
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+        last_op = GenFilters(std::move(last_op), bound_symbols, filters);
         last_op = impl::GenNamedPaths(std::move(last_op), bound_symbols, named_paths);
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+        last_op = GenFilters(std::move(last_op), bound_symbols, filters);
       }
       // We have an edge, so generate Expand.
       if (expansion.edge) {
@@ -437,6 +454,13 @@ class RuleBasedPlanner {
             total_weight.emplace(symbol_table.at(*edge->total_weight_));
           }
 
+          std::optional<ExpansionLambda> heuristic_lambda;
+          if (edge->heuristic_lambda_.expression) {
+            heuristic_lambda.emplace(ExpansionLambda{symbol_table.at(*edge->heuristic_lambda_.inner_edge),
+                                                     symbol_table.at(*edge->heuristic_lambda_.inner_node),
+                                                     edge->heuristic_lambda_.expression});
+          }
+
           ExpansionLambda filter_lambda;
           filter_lambda.inner_edge_symbol = symbol_table.at(*edge->filter_lambda_.inner_edge);
           filter_lambda.inner_node_symbol = symbol_table.at(*edge->filter_lambda_.inner_node);
@@ -476,7 +500,7 @@ class RuleBasedPlanner {
           last_op = std::make_unique<ExpandVariable>(std::move(last_op), node1_symbol, node_symbol, edge_symbol,
                                                      edge->type_, expansion.direction, edge_types, expansion.is_flipped,
                                                      edge->lower_bound_, edge->upper_bound_, existing_node,
-                                                     filter_lambda, weight_lambda, total_weight);
+                                                     filter_lambda, weight_lambda, total_weight, heuristic_lambda);
         } else {
           last_op = std::make_unique<Expand>(std::move(last_op), node1_symbol, node_symbol, edge_symbol,
                                              expansion.direction, edge_types, existing_node, match_context.view);
@@ -506,9 +530,9 @@ class RuleBasedPlanner {
             last_op = std::make_unique<EdgeUniquenessFilter>(std::move(last_op), edge_symbol, other_symbols);
           }
         }
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+        last_op = GenFilters(std::move(last_op), bound_symbols, filters);
         last_op = impl::GenNamedPaths(std::move(last_op), bound_symbols, named_paths);
-        last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+        last_op = GenFilters(std::move(last_op), bound_symbols, filters);
       }
     }
     MG_ASSERT(named_paths.empty(), "Expected to generate all named paths");
@@ -521,6 +545,27 @@ class RuleBasedPlanner {
     return last_op;
   }
 
+  // Generates a Filter for the bound filter expressions and then a SemiApply
+  // for every bound pattern filter, so that the cheaper filters are checked
+  // before matching the patterns.
+  std::unique_ptr<LogicalOperator> GenFilters(std::unique_ptr<LogicalOperator> last_op,
+                                              const std::unordered_set<Symbol> &bound_symbols, Filters &filters) {
+    auto &storage = *context_->ast_storage;
+    auto &symbol_table = *context_->symbol_table;
+    last_op = impl::GenFilters(std::move(last_op), bound_symbols, filters, storage);
+    for (const auto &filter : impl::ExtractPatternFilters(bound_symbols, filters)) {
+      const auto &pattern_filter = *filter.pattern_filter;
+      auto matching = MakePatternFilterMatching(*pattern_filter.exists, symbol_table, storage);
+      // The subplan binds its own symbols, which aren't visible after it.
+      std::unordered_set<Symbol> subplan_bound_symbols(bound_symbols);
+      MatchContext match_ctx{matching, symbol_table, subplan_bound_symbols};
+      auto once_with_symbols = std::make_unique<Once>(std::vector<Symbol>(bound_symbols.begin(), bound_symbols.end()));
+      auto subplan = PlanMatching(match_ctx, std::move(once_with_symbols));
+      last_op = std::make_unique<SemiApply>(std::move(last_op), std::move(subplan), pattern_filter.negated);
+    }
+    return last_op;
+  }
+
   auto GenMerge(query::Merge &merge, std::unique_ptr<LogicalOperator> input_op, const Matching &matching) {
     // Copy the bound symbol set, because we don't want to use the updated
     // version when generating the create part.
@@ -567,6 +612,39 @@ class RuleBasedPlanner {
     return std::make_unique<plan::Foreach>(std::move(input_op), std::move(op), foreach->named_expression_->expression_,
                                            symbol);
   }
+
+  std::unique_ptr<LogicalOperator> HandleCallSubquery(query::CallSubquery &call_subquery,
+                                                      std::unique_ptr<LogicalOperator> input_op,
+                                                      const std::vector<SingleQueryPart> &subquery_parts,
+                                                      bool &is_write) {
+    auto &bound_symbols = context_->bound_symbols;
+    // The subquery is planned from the outer bound symbols, which are replaced
+    // by the imported ones in its leading WITH.
+    auto outer_bound_symbols = bound_symbols;
+    std::shared_ptr<LogicalOperator> subquery_op = Plan(subquery_parts);
+    bound_symbols = outer_bound_symbols;
+    const bool subquery_has_return =
+        utils::IsSubtype(*call_subquery.single_query_->clauses_.back(), query::Return::kType);
+    if (subquery_has_return) {
+      for (const auto &symbol : subquery_op->OutputSymbols(*context_->symbol_table)) {
+        bound_symbols.insert(symbol);
+      }
+    }
+    ReadWriteTypeChecker rw_type_checker;
+    rw_type_checker.InferRWType(*subquery_op);
+    if (rw_type_checker.type == ReadWriteTypeChecker::RWType::W ||
+        rw_type_checker.type == ReadWriteTypeChecker::RWType::RW) {
+      is_write = true;
+    }
+    if (call_subquery.in_transactions_ && input_op) {
+      // The input is read completely before the first commit, otherwise it
+      // would see the changes committed in the meantime.
+      input_op = std::make_unique<Accumulate>(
+          std::move(input_op), std::vector<Symbol>(outer_bound_symbols.begin(), outer_bound_symbols.end()));
+    }
+    return std::make_unique<Apply>(std::move(input_op), std::move(subquery_op), subquery_has_return,
+                                   call_subquery.in_transactions_, call_subquery.batch_size_);
+  }
 };
 
 }  // namespace memgraph::query::plan
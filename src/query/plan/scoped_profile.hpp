@@ -11,7 +11,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
 
 #include "query/context.hpp"
 #include "query/plan/profile.hpp"
@@ -25,6 +27,10 @@ namespace memgraph::query::plan {
  * update the profiling data stored within the `ExecutionContext` object and build
  * up a tree of `ProfilingStats` instances. The structure of the `ProfilingStats`
  * tree depends on the `LogicalOperator`s that were executed.
+ *
+ * When the context tracks the memory usage or the hardware counters, their
+ * change during the scope is attributed to the operator as well. The peak
+ * memory is tracked relative to the memory in use when the scope was entered.
  */
 class ScopedProfile {
  public:
@@ -56,6 +62,14 @@ class ScopedProfile {
 
       context_->stats_root = stats_;
       stats_->actual_hits++;
+      if (auto *memory_usage = context_->profile_memory_usage) {
+        allocated_at_start_ = memory_usage->allocated;
+        in_use_at_start_ = memory_usage->in_use;
+        outer_peak_ = std::exchange(memory_usage->peak, memory_usage->in_use);
+      }
+      if (auto *counters = context_->profile_perf_event_counters) {
+        counters_at_start_ = counters->Read();
+      }
       start_time_ = utils::ReadTSC();
     }
   }
@@ -63,6 +77,17 @@ class ScopedProfile {
   ~ScopedProfile() noexcept {
     if (UNLIKELY(context_->is_profile_query)) {
       stats_->num_cycles += utils::ReadTSC() - start_time_;
+      if (auto *counters = context_->profile_perf_event_counters) {
+        const auto counters_at_end = counters->Read();
+        stats_->num_cpu_cycles += counters_at_end.cpu_cycles - counters_at_start_.cpu_cycles;
+        stats_->num_cache_misses += counters_at_end.cache_misses - counters_at_start_.cache_misses;
+      }
+      if (auto *memory_usage = context_->profile_memory_usage) {
+        stats_->allocated_bytes += memory_usage->allocated - allocated_at_start_;
+        stats_->peak_memory_bytes = std::max(stats_->peak_memory_bytes, memory_usage->peak - in_use_at_start_);
+        // The peak of the enclosing scope includes the peak of this one.
+        memory_usage->peak = std::max(outer_peak_, memory_usage->peak);
+      }
 
       // Restore the old root ("pop")
       context_->stats_root = root_;
@@ -74,6 +99,10 @@ class ScopedProfile {
   ProfilingStats *root_{nullptr};
   ProfilingStats *stats_{nullptr};
   unsigned long long start_time_{0};
+  int64_t allocated_at_start_{0};
+  int64_t in_use_at_start_{0};
+  int64_t outer_peak_{0};
+  utils::PerfEventValues counters_at_start_{};
 };
 
 }  // namespace memgraph::query::plan
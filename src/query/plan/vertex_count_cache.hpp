@@ -12,18 +12,20 @@
 /// @file
 #pragma once
 
+#include <memory>
 #include <optional>
 
 #include "query/typed_value.hpp"
 #include "storage/v2/id_types.hpp"
 #include "storage/v2/property_value.hpp"
+#include "storage/v2/statistics.hpp"
 #include "utils/bound.hpp"
 #include "utils/fnv.hpp"
 
 namespace memgraph::query::plan {
 
 /// A stand in class for `TDbAccessor` which provides memoized calls to
-/// `VerticesCount`.
+/// `VerticesCount` and `GetGraphStatistics`.
 template <class TDbAccessor>
 class VertexCountCache {
  public:
@@ -78,6 +80,11 @@ class VertexCountCache {
     return db_->LabelPropertyIndexExists(label, property);
   }
 
+  std::shared_ptr<const storage::GraphStatistics> GetGraphStatistics() {
+    if (!graph_statistics_) graph_statistics_ = db_->GetGraphStatistics();
+    return *graph_statistics_;
+  }
+
  private:
   typedef std::pair<storage::LabelId, storage::PropertyId> LabelPropertyKey;
 
@@ -120,6 +127,7 @@ class VertexCountCache {
 
   TDbAccessor *db_;
   std::optional<int64_t> vertices_count_;
+  std::optional<std::shared_ptr<const storage::GraphStatistics>> graph_statistics_;
   std::unordered_map<storage::LabelId, int64_t> label_vertex_count_;
   std::unordered_map<LabelPropertyKey, int64_t, LabelPropertyHash> label_property_vertex_count_;
   std::unordered_map<
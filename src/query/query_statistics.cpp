@@ -0,0 +1,147 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "query/query_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "utils/flag_validation.hpp"
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_int32(query_statistics_max_entries, 1000,
+                       "Maximum number of distinct queries whose execution statistics are kept, the queries with the "
+                       "lowest total latency are evicted. 0 disables collecting the statistics.",
+                       FLAG_IN_RANGE(0, std::numeric_limits<int32_t>::max()));
+
+namespace memgraph::query {
+
+void LatencyHistogram::Add(const std::chrono::duration<double> latency) {
+  const auto microseconds = latency.count() * 1e6;
+  size_t bucket = 0;
+  if (microseconds >= 1) {
+    bucket = std::min(static_cast<size_t>(std::log2(microseconds) * kBucketsPerDoubling) + 1, kBucketsCount - 1);
+  }
+  ++buckets_[bucket];
+  ++count_;
+}
+
+std::chrono::duration<double> LatencyHistogram::Percentile(const double percentile) const {
+  if (count_ == 0) return std::chrono::duration<double>{0};
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * count_)));
+  uint64_t seen = 0;
+  size_t bucket = 0;
+  for (; bucket + 1 < kBucketsCount; ++bucket) {
+    seen += buckets_[bucket];
+    if (seen >= rank) break;
+  }
+  // The upper bound of the bucket.
+  const auto microseconds = std::exp2(static_cast<double>(bucket) / kBucketsPerDoubling);
+  return std::chrono::duration<double>{microseconds / 1e6};
+}
+
+void QueryStatistics::Add(const QueryExecutionStatistics &statistics) {
+  ++calls;
+  total_latency += statistics.latency;
+  max_latency = std::max(max_latency, statistics.latency);
+  latency_histogram.Add(statistics.latency);
+  rows += statistics.rows;
+  if (statistics.plan_cache_hit) {
+    ++plan_cache_lookups;
+    if (*statistics.plan_cache_hit) ++plan_cache_hits;
+  }
+  peak_memory_bytes = std::max(peak_memory_bytes, statistics.peak_memory_bytes);
+}
+
+std::chrono::duration<double> QueryStatistics::LatencyPercentile(const double percentile) const {
+  return std::min(latency_histogram.Percentile(percentile), max_latency);
+}
+
+std::optional<double> QueryStatistics::PlanCacheHitRatio() const {
+  if (plan_cache_lookups == 0) return std::nullopt;
+  return static_cast<double>(plan_cache_hits) / static_cast<double>(plan_cache_lookups);
+}
+
+void QueryStatisticsRegistry::Record(const uint64_t hash, const std::string &query,
+                                     const QueryExecutionStatistics &statistics) {
+  const auto max_entries = static_cast<size_t>(FLAGS_query_statistics_max_entries);
+  if (max_entries == 0) return;
+  auto entries = entries_.Lock();
+  auto it = entries->find(hash);
+  if (it == entries->end()) {
+    if (entries->size() >= max_entries) {
+      std::vector<std::pair<double, uint64_t>> total_latencies;
+      total_latencies.reserve(entries->size());
+      for (const auto &[entry_hash, entry] : *entries) {
+        total_latencies.emplace_back(entry.total_latency.count(), entry_hash);
+      }
+      // Make room for the new entry and evict an eighth of the entries at once,
+      // so a full registry isn't scanned on every new query.
+      const auto keep = max_entries - 1 - max_entries / 8;
+      const auto evict = total_latencies.size() - keep;
+      std::nth_element(total_latencies.begin(), total_latencies.begin() + static_cast<std::ptrdiff_t>(evict - 1),
+                       total_latencies.end());
+      for (size_t i = 0; i < evict; ++i) {
+        entries->erase(total_latencies[i].second);
+      }
+    }
+    it = entries->emplace(hash, QueryStatistics{.query = query}).first;
+  }
+  it->second.Add(statistics);
+}
+
+std::vector<std::pair<uint64_t, QueryStatistics>> QueryStatisticsRegistry::Snapshot(
+    const std::optional<size_t> limit) const {
+  std::vector<std::pair<uint64_t, QueryStatistics>> snapshot;
+  {
+    auto entries = entries_.Lock();
+    snapshot.assign(entries->begin(), entries->end());
+  }
+  const auto by_total_latency = [](const auto &lhs, const auto &rhs) {
+    return lhs.second.total_latency > rhs.second.total_latency;
+  };
+  if (limit && *limit < snapshot.size()) {
+    std::partial_sort(snapshot.begin(), snapshot.begin() + static_cast<std::ptrdiff_t>(*limit), snapshot.end(),
+                      by_total_latency);
+    snapshot.resize(*limit);
+  } else {
+    std::sort(snapshot.begin(), snapshot.end(), by_total_latency);
+  }
+  return snapshot;
+}
+
+void QueryStatisticsRegistry::Clear() { entries_->clear(); }
+
+nlohmann::json QueryStatisticsToJson(const std::vector<std::pair<uint64_t, QueryStatistics>> &statistics) {
+  auto json = nlohmann::json::array();
+  for (const auto &[hash, entry] : statistics) {
+    nlohmann::json entry_json;
+    entry_json["query_hash"] = std::to_string(hash);
+    entry_json["query"] = entry.query;
+    entry_json["calls"] = entry.calls;
+    entry_json["total_latency"] = entry.total_latency.count();
+    entry_json["max_latency"] = entry.max_latency.count();
+    entry_json["p50_latency"] = entry.LatencyPercentile(50).count();
+    entry_json["p99_latency"] = entry.LatencyPercentile(99).count();
+    entry_json["rows"] = entry.rows;
+    if (const auto ratio = entry.PlanCacheHitRatio()) {
+      entry_json["plan_cache_hit_ratio"] = *ratio;
+    } else {
+      entry_json["plan_cache_hit_ratio"] = nullptr;
+    }
+    entry_json["peak_memory"] = entry.peak_memory_bytes;
+    json.push_back(std::move(entry_json));
+  }
+  return json;
+}
+
+}  // namespace memgraph::query
@@ -0,0 +1,115 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <json/json.hpp>
+
+#include "utils/synchronized.hpp"
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_int32(query_statistics_max_entries);
+
+namespace memgraph::query {
+
+/// Histogram of latencies with logarithmic buckets, four buckets per doubling
+/// from a microsecond up to over an hour. Percentiles are estimated within
+/// 20% of the real value.
+class LatencyHistogram {
+ public:
+  void Add(std::chrono::duration<double> latency);
+
+  /// Returns the estimated latency which `percentile` percent of the added
+  /// latencies don't exceed.
+  std::chrono::duration<double> Percentile(double percentile) const;
+
+  uint64_t count() const { return count_; }
+
+ private:
+  static constexpr size_t kBucketsPerDoubling = 4;
+  // The first bucket holds latencies under a microsecond and the last one the
+  // latencies over 2^32 microseconds.
+  static constexpr size_t kBucketsCount = 32 * kBucketsPerDoubling + 2;
+
+  std::array<uint64_t, kBucketsCount> buckets_{};
+  uint64_t count_{0};
+};
+
+/// Statistics of a single finished execution of a query.
+struct QueryExecutionStatistics {
+  // Time spent parsing, planning and pulling the results, excluding the time
+  // spent waiting for the client between the pulls.
+  std::chrono::duration<double> latency{0};
+  int64_t rows{0};
+  // Whether the plan was taken from the plan cache, null if the query wasn't
+  // looked up in the plan cache.
+  std::optional<bool> plan_cache_hit;
+  // Peak bytes drawn by the pool resource of a single pull. The pull memory is
+  // freed at the end of each pull.
+  int64_t peak_pull_memory_bytes{0};
+  // Bytes of the execution memory held by the query when it finished, which
+  // is never freed before the query finishes, and the peak pull memory.
+  int64_t peak_memory_bytes{0};
+};
+
+/// Statistics of all the executions of the queries with the same stripped
+/// query, i.e. of the queries which differ only in literals.
+struct QueryStatistics {
+  std::string query;
+  int64_t calls{0};
+  std::chrono::duration<double> total_latency{0};
+  std::chrono::duration<double> max_latency{0};
+  LatencyHistogram latency_histogram;
+  int64_t rows{0};
+  int64_t plan_cache_lookups{0};
+  int64_t plan_cache_hits{0};
+  int64_t peak_memory_bytes{0};
+
+  void Add(const QueryExecutionStatistics &statistics);
+
+  /// Returns the estimated latency percentile, which is never over the
+  /// maximal latency.
+  std::chrono::duration<double> LatencyPercentile(double percentile) const;
+
+  std::optional<double> PlanCacheHitRatio() const;
+};
+
+/// Bounded registry of `QueryStatistics` keyed by the hash of the stripped
+/// query. The number of entries is limited by
+/// `--query-statistics-max-entries`; when the registry overflows, an eighth of
+/// the entries with the lowest total latency is evicted.
+class QueryStatisticsRegistry {
+ public:
+  void Record(uint64_t hash, const std::string &query, const QueryExecutionStatistics &statistics);
+
+  /// Returns the statistics ordered by the total latency, the most expensive
+  /// first. If `limit` is given, at most that many entries are returned.
+  std::vector<std::pair<uint64_t, QueryStatistics>> Snapshot(std::optional<size_t> limit = std::nullopt) const;
+
+  void Clear();
+
+ private:
+  mutable utils::Synchronized<std::unordered_map<uint64_t, QueryStatistics>> entries_;
+};
+
+nlohmann::json QueryStatisticsToJson(const std::vector<std::pair<uint64_t, QueryStatistics>> &statistics);
+
+}  // namespace memgraph::query
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -41,7 +42,12 @@ class AnyStream final {
                   .template delete_object<GenericWrapper<TStream>>(static_cast<GenericWrapper<TStream> *>(ptr));
             }} {}
 
-  void Result(const std::vector<TypedValue> &values) { content_->Result(values); }
+  void Result(const std::vector<TypedValue> &values) {
+    content_->Result(values);
+    ++results_count_;
+  }
+
+  int64_t results_count() const { return results_count_; }
 
  private:
   struct Wrapper {
@@ -58,6 +64,7 @@ class AnyStream final {
   };
 
   std::unique_ptr<Wrapper, std::function<void(Wrapper *)>> content_;
+  int64_t results_count_{0};
 };
 
 }  // namespace memgraph::query
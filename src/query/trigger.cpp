@@ -159,6 +159,12 @@ Trigger::Trigger(std::string name, const std::string &query,
       parsed_statements_{ParseQuery(query, user_parameters, query_cache, query_config)},
       event_type_{event_type},
       owner_{std::move(owner)} {
+  // Triggers run inside the transaction which fired them, so they can't
+  // commit it in batches.
+  if (const auto *cypher_query = utils::Downcast<CypherQuery>(parsed_statements_.query);
+      cypher_query && HasCallInTransactions(*cypher_query)) {
+    throw utils::BasicException("CALL subqueries IN TRANSACTIONS not allowed in trigger statements.");
+  }
   // We check immediately if the query is valid by trying to create a plan.
   GetPlan(db_accessor, auth_checker);
 }
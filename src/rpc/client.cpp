@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,17 +11,197 @@
 
 #include "rpc/client.hpp"
 
+#include <cstring>
+#include <vector>
+
 namespace memgraph::rpc {
 
 Client::Client(const io::network::Endpoint &endpoint, communication::ClientContext *context)
     : endpoint_(endpoint), context_(context) {}
 
+Client::~Client() { Abort(); }
+
 void Client::Abort() {
-  if (!client_) return;
+  std::shared_ptr<Connection> connection;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    connection = std::move(connection_);
+  }
+  if (!connection) return;
   // We need to call Shutdown on the client to abort any pending read or
   // write operations.
-  client_->Shutdown();
-  client_ = std::nullopt;
+  connection->Shutdown();
+}
+
+std::shared_ptr<Client::Connection> Client::GetConnection() {
+  std::shared_ptr<Connection> failed;
+  std::lock_guard<std::mutex> guard(mutex_);
+  // Check if the connection is broken (if we haven't used the client for a
+  // long time the server could have died).
+  if (connection_ && connection_->Failed()) {
+    failed = std::move(connection_);
+  }
+
+  // Connect to the remote server.
+  if (!connection_) {
+    auto connection = std::make_shared<Connection>(endpoint_, context_);
+    if (!connection->Connect()) {
+      SPDLOG_ERROR("Couldn't connect to remote address {}", endpoint_);
+      throw RpcFailedException(endpoint_);
+    }
+    connection_ = std::move(connection);
+  }
+  return connection_;
+}
+
+Client::Connection::Connection(const io::network::Endpoint &endpoint, communication::ClientContext *context)
+    : endpoint_(endpoint), client_(context) {}
+
+Client::Connection::~Connection() {
+  client_.Shutdown();
+  if (receiver_.joinable()) receiver_.join();
+}
+
+bool Client::Connection::Connect() {
+  if (!client_.Connect(endpoint_)) return false;
+
+  // Send the handshake and check the protocol version of the server.
+  const uint32_t handshake[] = {0, kProtocolMagic, kProtocolVersion};
+  if (!client_.Write(reinterpret_cast<const uint8_t *>(handshake), kHandshakeSize) ||
+      !client_.Read(sizeof(uint32_t))) {
+    SPDLOG_ERROR("RPC server {} didn't accept the protocol handshake", endpoint_);
+    client_.Close();
+    return false;
+  }
+  uint32_t server_version = 0;
+  memcpy(&server_version, client_.GetData(), sizeof(server_version));
+  client_.ShiftData(sizeof(server_version));
+  if (server_version != kProtocolVersion) {
+    SPDLOG_ERROR("RPC server {} uses protocol version {}, expected version {}", endpoint_, server_version,
+                 kProtocolVersion);
+    client_.Close();
+    return false;
+  }
+
+  receiver_ = std::thread([this] { ReceiveResponses(); });
+  return true;
+}
+
+bool Client::Connection::Failed() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (failed_) return true;
+  }
+  return client_.ErrorStatus();
+}
+
+uint64_t Client::Connection::AddPendingResponse(const utils::TypeInfo &res_type,
+                                                std::function<void(slk::Reader *)> load,
+                                                std::function<void(std::exception_ptr)> fail) {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (failed_) throw RpcFailedException(endpoint_);
+  const auto seq = next_seq_++;
+  pending_.emplace(seq, PendingResponse{res_type.id, std::move(load), std::move(fail)});
+  return seq;
+}
+
+void Client::Connection::WriteFrame(uint64_t seq, std::span<const std::span<const uint8_t>> buffers, FrameKind kind) {
+  uint32_t frame_size = 0;
+  for (const auto &buffer : buffers) frame_size += buffer.size();
+  DMG_ASSERT(frame_size <= kMaxFrameSize, "RPC frame of {} bytes is too large", frame_size);
+
+  uint8_t header[kFrameHeaderSize];
+  memcpy(header, &seq, sizeof(seq));
+  memcpy(header + sizeof(seq), &frame_size, sizeof(frame_size));
+  memcpy(header + sizeof(seq) + sizeof(frame_size), &kind, sizeof(kind));
+
+  std::vector<std::span<const uint8_t>> frame;
+  frame.reserve(buffers.size() + 1);
+  frame.emplace_back(header, kFrameHeaderSize);
+  frame.insert(frame.end(), buffers.begin(), buffers.end());
+
+  std::lock_guard<std::mutex> guard(write_mutex_);
+  if (!client_.Write(frame, kind == FrameKind::PART)) {
+    Shutdown();
+    throw RpcFailedException(endpoint_);
+  }
+}
+
+void Client::Connection::CancelRequest(uint64_t seq) {
+  // No response will be sent, so it isn't waited for anymore.
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    pending_.erase(seq);
+  }
+  try {
+    WriteFrame(seq, {}, FrameKind::CANCEL);
+  } catch (const RpcFailedException &) {
+    // The connection failed, so the server dropped the request anyway.
+  }
+}
+
+void Client::Connection::Shutdown() { client_.Shutdown(); }
+
+void Client::Connection::ReceiveResponses() {
+  while (true) {
+    auto ret = slk::CheckStreamComplete(client_.GetData(), client_.GetDataSize());
+    if (ret.status == slk::StreamStatus::INVALID) {
+      break;
+    } else if (ret.status == slk::StreamStatus::PARTIAL) {
+      if (!client_.Read(ret.stream_size - client_.GetDataSize(), /* exactly_len = */ false)) break;
+      continue;
+    }
+
+    // Load the response.
+    slk::Reader res_reader(client_.GetData(), ret.stream_size);
+    utils::OnScopeExit res_cleanup([&, ret] { client_.ShiftData(ret.stream_size); });
+
+    uint64_t seq = 0;
+    uint64_t res_id = 0;
+    try {
+      slk::Load(&seq, &res_reader);
+      slk::Load(&res_id, &res_reader);
+    } catch (const slk::SlkReaderException &) {
+      break;
+    }
+
+    std::optional<PendingResponse> pending;
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      if (auto it = pending_.find(seq); it != pending_.end()) {
+        pending.emplace(std::move(it->second));
+        pending_.erase(it);
+      }
+    }
+    if (!pending) {
+      spdlog::error("Message response was for an unknown request");
+      break;
+    }
+
+    // Check the response ID.
+    if (res_id != pending->res_type_id) {
+      spdlog::error("Message response was of unexpected type");
+      pending->fail(std::make_exception_ptr(RpcFailedException(endpoint_)));
+      break;
+    }
+
+    SPDLOG_TRACE("[RpcClient] received response to request {}", seq);
+    pending->load(&res_reader);
+  }
+  Fail();
+}
+
+void Client::Connection::Fail() {
+  std::unordered_map<uint64_t, PendingResponse> pending;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    failed_ = true;
+    pending.swap(pending_);
+  }
+  client_.Shutdown();
+  for (auto &[seq, response] : pending) {
+    response.fail(std::make_exception_ptr(RpcFailedException(endpoint_)));
+  }
 }
 
 }  // namespace memgraph::rpc
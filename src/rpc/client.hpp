@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,9 +11,16 @@
 
 #pragma once
 
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
 
 #include "communication/client.hpp"
 #include "io/network/endpoint.hpp"
@@ -26,25 +33,46 @@
 
 namespace memgraph::rpc {
 
-/// Client is thread safe, but it is recommended to use thread_local clients.
+/// Client is thread safe, and many calls can be in flight on its connection at
+/// the same time. The requests are sent in frames, and the frames of different
+/// requests can be interleaved, so a call isn't held back by a long streamed
+/// request. The responses are received by a background thread and matched to
+/// the requests by their sequence numbers, in whatever order the server sends
+/// them.
 class Client {
+  class Connection;
+
  public:
   Client(const io::network::Endpoint &endpoint, communication::ClientContext *context);
 
+  Client(const Client &) = delete;
+  Client(Client &&) = delete;
+  Client &operator=(const Client &) = delete;
+  Client &operator=(Client &&) = delete;
+
+  ~Client();
+
   /// Object used to handle streaming of request data to the RPC server.
   template <class TRequestResponse>
   class StreamHandler {
    private:
     friend class Client;
 
-    StreamHandler(Client *self, std::unique_lock<std::mutex> &&guard,
-                  std::function<typename TRequestResponse::Response(slk::Reader *)> res_load)
-        : self_(self),
-          guard_(std::move(guard)),
-          req_builder_([self](const uint8_t *data, size_t size, bool have_more) {
-            if (!self->client_->Write(data, size, have_more)) throw RpcFailedException(self->endpoint_);
-          }),
-          res_load_(res_load) {}
+    using Response = typename TRequestResponse::Response;
+
+    StreamHandler(std::shared_ptr<Connection> connection, uint64_t seq, std::future<Response> response)
+        : connection_(std::move(connection)),
+          seq_(seq),
+          req_builder_(
+              [connection = connection_.get(), seq](const uint8_t *data, size_t size, bool have_more) {
+                const std::span<const uint8_t> buffers[] = {{data, size}};
+                connection->WriteFrame(seq, buffers, have_more ? FrameKind::PART : FrameKind::LAST);
+              },
+              [connection = connection_.get(), seq](std::span<const std::span<const uint8_t>> buffers,
+                                                    bool have_more) {
+                connection->WriteFrame(seq, buffers, have_more ? FrameKind::PART : FrameKind::LAST);
+              }),
+          response_(std::move(response)) {}
 
    public:
     StreamHandler(StreamHandler &&) noexcept = default;
@@ -53,64 +81,43 @@ class Client {
     StreamHandler(const StreamHandler &) = delete;
     StreamHandler &operator=(const StreamHandler &) = delete;
 
-    ~StreamHandler() {}
+    ~StreamHandler() {
+      // The server would keep the part of a request which wasn't sent
+      // completely forever, so it's told to drop it.
+      if (connection_) connection_->CancelRequest(seq_);
+    }
 
     slk::Builder *GetBuilder() { return &req_builder_; }
 
-    typename TRequestResponse::Response AwaitResponse() {
-      auto res_type = TRequestResponse::Response::kType;
-
-      // Finalize the request.
+    /// Finalizes the request and returns the future response without waiting
+    /// for it.
+    ///
+    /// @throws RpcFailedException if the request couldn't be sent
+    std::future<Response> AsyncResponse() {
       req_builder_.Finalize();
-
-      // Receive the response.
-      uint64_t response_data_size = 0;
-      while (true) {
-        auto ret = slk::CheckStreamComplete(self_->client_->GetData(), self_->client_->GetDataSize());
-        if (ret.status == slk::StreamStatus::INVALID) {
-          throw RpcFailedException(self_->endpoint_);
-        } else if (ret.status == slk::StreamStatus::PARTIAL) {
-          if (!self_->client_->Read(ret.stream_size - self_->client_->GetDataSize(),
-                                    /* exactly_len = */ false)) {
-            throw RpcFailedException(self_->endpoint_);
-          }
-        } else {
-          response_data_size = ret.stream_size;
-          break;
-        }
-      }
-
-      // Load the response.
-      slk::Reader res_reader(self_->client_->GetData(), response_data_size);
-      utils::OnScopeExit res_cleanup([&, response_data_size] { self_->client_->ShiftData(response_data_size); });
-
-      uint64_t res_id = 0;
-      slk::Load(&res_id, &res_reader);
-
-      // Check the response ID.
-      if (res_id != res_type.id) {
-        spdlog::error("Message response was of unexpected type");
-        self_->client_ = std::nullopt;
-        throw RpcFailedException(self_->endpoint_);
-      }
-
-      SPDLOG_TRACE("[RpcClient] received {}", res_type.name);
-
-      return res_load_(&res_reader);
+      connection_ = nullptr;
+      return std::move(response_);
     }
 
+    /// Finalizes the request and waits for the response.
+    ///
+    /// @throws RpcFailedException if the request couldn't be sent or no
+    ///                            response was received
+    Response AwaitResponse() { return AsyncResponse().get(); }
+
    private:
-    Client *self_;
-    std::unique_lock<std::mutex> guard_;
+    std::shared_ptr<Connection> connection_;
+    uint64_t seq_;
     slk::Builder req_builder_;
-    std::function<typename TRequestResponse::Response(slk::Reader *)> res_load_;
+    std::future<Response> response_;
   };
 
-  /// Stream a previously defined and registered RPC call. This function can
-  /// initiate only one request at a time. The call returns a `StreamHandler`
-  /// object that can be used to send additional data to the request (with the
-  /// automatically sent `TRequestResponse::Request` object) and await until the
-  /// response is received from the server.
+  /// Stream a previously defined and registered RPC call. Other calls can be
+  /// sent while the returned `StreamHandler` is still sending its request, and
+  /// the server executes the requests in the order in which they are
+  /// finalized. The `StreamHandler` object can be used to send additional data
+  /// to the request (with the automatically sent `TRequestResponse::Request`
+  /// object) and to await the response from the server.
   ///
   /// @returns StreamHandler<TRequestResponse> object that is used to handle
   ///                                          streaming of additional data to
@@ -131,33 +138,32 @@ class Client {
   }
 
   /// Same as `Stream` but the first argument is a response loading function.
+  /// The function is called on the thread which receives the responses.
   template <class TRequestResponse, class... Args>
   StreamHandler<TRequestResponse> StreamWithLoad(std::function<typename TRequestResponse::Response(slk::Reader *)> load,
                                                  Args &&...args) {
+    using Response = typename TRequestResponse::Response;
     typename TRequestResponse::Request request(std::forward<Args>(args)...);
     auto req_type = TRequestResponse::Request::kType;
     SPDLOG_TRACE("[RpcClient] sent {}", req_type.name);
 
-    std::unique_lock<std::mutex> guard(mutex_);
-
-    // Check if the connection is broken (if we haven't used the client for a
-    // long time the server could have died).
-    if (client_ && client_->ErrorStatus()) {
-      client_ = std::nullopt;
-    }
-
-    // Connect to the remote server.
-    if (!client_) {
-      client_.emplace(context_);
-      if (!client_->Connect(endpoint_)) {
-        SPDLOG_ERROR("Couldn't connect to remote address {}", endpoint_);
-        client_ = std::nullopt;
-        throw RpcFailedException(endpoint_);
-      }
-    }
+    auto connection = GetConnection();
+
+    auto promise = std::make_shared<std::promise<Response>>();
+    auto response = promise->get_future();
+    const auto seq = connection->AddPendingResponse(
+        Response::kType,
+        [promise, load = std::move(load)](slk::Reader *reader) {
+          try {
+            promise->set_value(load(reader));
+          } catch (...) {
+            promise->set_exception(std::current_exception());
+          }
+        },
+        [promise](std::exception_ptr error) { promise->set_exception(std::move(error)); });
 
     // Create the stream handler.
-    StreamHandler<TRequestResponse> handler(this, std::move(guard), load);
+    StreamHandler<TRequestResponse> handler(std::move(connection), seq, std::move(response));
 
     // Build and send the request.
     slk::Save(req_type.id, handler.GetBuilder());
@@ -167,9 +173,9 @@ class Client {
     return std::move(handler);
   }
 
-  /// Call a previously defined and registered RPC call. This function can
-  /// initiate only one request at a time. The call blocks until a response is
-  /// received.
+  /// Call a previously defined and registered RPC call. The call blocks until
+  /// a response is received, while other calls may be in flight at the same
+  /// time.
   ///
   /// @returns TRequestResponse::Response object that was specified to be
   ///                                     returned by the RPC call
@@ -186,21 +192,102 @@ class Client {
   template <class TRequestResponse, class... Args>
   typename TRequestResponse::Response CallWithLoad(
       std::function<typename TRequestResponse::Response(slk::Reader *)> load, Args &&...args) {
-    auto stream = StreamWithLoad(load, std::forward<Args>(args)...);
+    auto stream = StreamWithLoad<TRequestResponse>(load, std::forward<Args>(args)...);
     return stream.AwaitResponse();
   }
 
-  /// Call this function from another thread to abort a pending RPC call.
+  /// Same as `Call` but returns as soon as the request is sent. The returned
+  /// future holds the response, or the `RpcFailedException` if the call
+  /// failed after the request was sent.
+  ///
+  /// @throws RpcFailedException if the request couldn't be sent
+  template <class TRequestResponse, class... Args>
+  std::future<typename TRequestResponse::Response> CallAsync(Args &&...args) {
+    auto stream = Stream<TRequestResponse>(std::forward<Args>(args)...);
+    return stream.AsyncResponse();
+  }
+
+  /// Call this function from another thread to abort the pending RPC calls.
   void Abort();
 
   const auto &Endpoint() const { return endpoint_; }
 
  private:
+  /// Connection to the server together with the thread receiving the
+  /// responses to the requests sent over it. A connection which failed isn't
+  /// used for new requests, the client opens a new one instead.
+  class Connection {
+   public:
+    struct PendingResponse {
+      uint64_t res_type_id;
+      std::function<void(slk::Reader *)> load;
+      std::function<void(std::exception_ptr)> fail;
+    };
+
+    Connection(const io::network::Endpoint &endpoint, communication::ClientContext *context);
+
+    Connection(const Connection &) = delete;
+    Connection(Connection &&) = delete;
+    Connection &operator=(const Connection &) = delete;
+    Connection &operator=(Connection &&) = delete;
+
+    ~Connection();
+
+    /// Connects to the server, checks that it uses the same protocol version
+    /// and starts receiving the responses.
+    bool Connect();
+
+    bool Failed();
+
+    /// Registers the response of the next request and returns the sequence
+    /// number of the request.
+    /// @throws RpcFailedException if the connection failed
+    uint64_t AddPendingResponse(const utils::TypeInfo &res_type, std::function<void(slk::Reader *)> load,
+                                std::function<void(std::exception_ptr)> fail);
+
+    /// Writes the `buffers` as one frame of the request with the sequence
+    /// number `seq`. Frames are written whole, so frames of other requests can
+    /// only be written between them.
+    /// @throws RpcFailedException if the data couldn't be written
+    void WriteFrame(uint64_t seq, std::span<const std::span<const uint8_t>> buffers, FrameKind kind);
+
+    /// Abandons the request with the sequence number `seq`, whose last frame
+    /// wasn't sent. The server drops the frames it received, and other
+    /// requests on the connection aren't affected.
+    void CancelRequest(uint64_t seq);
+
+    /// Shuts down the socket, which fails all pending responses.
+    void Shutdown();
+
+   private:
+    void ReceiveResponses();
+
+    // Fails the connection and all of its pending responses.
+    void Fail();
+
+    io::network::Endpoint endpoint_;
+    communication::Client client_;
+
+    // Held while a frame is being written.
+    std::mutex write_mutex_;
+
+    std::mutex lock_;
+    bool failed_{false};
+    uint64_t next_seq_{0};
+    std::unordered_map<uint64_t, PendingResponse> pending_;
+
+    std::thread receiver_;
+  };
+
+  // Returns the current connection, or a new one if there is none or it
+  // failed.
+  std::shared_ptr<Connection> GetConnection();
+
   io::network::Endpoint endpoint_;
   communication::ClientContext *context_;
-  std::optional<communication::Client> client_;
 
   std::mutex mutex_;
+  std::shared_ptr<Connection> connection_;
 };
 
 }  // namespace memgraph::rpc
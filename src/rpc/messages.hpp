@@ -14,12 +14,42 @@
 #include <cstdint>
 #include <memory>
 
+#include "slk/streams.hpp"
 #include "utils/typeinfo.hpp"
 
 namespace memgraph::rpc {
 
 using MessageSize = uint32_t;
 
+/// Identifies the RPC protocol in the handshake which the client sends when it
+/// connects. The handshake starts with a zero, which is never a valid start of
+/// an SLK stream, so that servers which don't expect a handshake close the
+/// connection instead of misreading it.
+inline constexpr uint32_t kProtocolMagic = 0x4D475250;
+/// Version of the RPC protocol. The server answers the handshake with its own
+/// version and closes the connection if the versions differ.
+inline constexpr uint32_t kProtocolVersion = 1;
+inline constexpr size_t kHandshakeSize = 3 * sizeof(uint32_t);
+
+/// The requests are sent in frames, each of which carries a part of the SLK
+/// stream of one request. The frame header holds the sequence number of the
+/// request (uint64_t), the size of the frame data (uint32_t) and the
+/// `FrameKind` (uint8_t).
+inline constexpr size_t kFrameHeaderSize = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint8_t);
+
+enum class FrameKind : uint8_t {
+  /// A part of the request which is followed by more frames.
+  PART = 0,
+  /// The last part of the request, after which the request is executed.
+  LAST = 1,
+  /// Frame without data which drops the parts of the request received so far,
+  /// sent when the request is abandoned before its last frame.
+  CANCEL = 2,
+};
+/// A frame holds the data of one write of the SLK builder, which is at most
+/// two segments.
+inline constexpr size_t kMaxFrameSize = 2 * slk::kSegmentMaxTotalSize;
+
 /// Each RPC is defined via this struct.
 ///
 /// `TRequest` and `TResponse` are required to be classes which have a static
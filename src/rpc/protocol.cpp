@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,6 +11,8 @@
 
 #include "rpc/protocol.hpp"
 
+#include <cstring>
+
 #include "rpc/messages.hpp"
 #include "rpc/server.hpp"
 #include "slk/serialization.hpp"
@@ -24,23 +26,146 @@ Session::Session(Server *server, const io::network::Endpoint &endpoint, communic
     : server_(server), endpoint_(endpoint), input_stream_(input_stream), output_stream_(output_stream) {}
 
 void Session::Execute() {
-  auto ret = slk::CheckStreamComplete(input_stream_->data(), input_stream_->size());
-  if (ret.status == slk::StreamStatus::INVALID) {
-    throw SessionException("Received an invalid SLK stream!");
-  } else if (ret.status == slk::StreamStatus::PARTIAL) {
-    input_stream_->Resize(ret.stream_size);
-    return;
+  if (!handshake_done_ && !Handshake()) return;
+
+  // The client may send its next requests before it receives the responses,
+  // and the frames of different requests may be interleaved, so all complete
+  // frames in the stream are processed. The frames of a request which isn't
+  // interleaved with others are left in the stream until its last frame
+  // arrives, so that it's executed without being copied.
+  while (true) {
+    if (input_stream_->size() < in_place_size_ + kFrameHeaderSize) {
+      input_stream_->Resize(in_place_size_ + kFrameHeaderSize);
+      return;
+    }
+    uint64_t seq = 0;
+    uint32_t frame_size = 0;
+    FrameKind kind = FrameKind::PART;
+    const auto *header = input_stream_->data() + in_place_size_;
+    memcpy(&seq, header, sizeof(seq));
+    memcpy(&frame_size, header + sizeof(seq), sizeof(frame_size));
+    memcpy(&kind, header + sizeof(seq) + sizeof(frame_size), sizeof(kind));
+    if (kind != FrameKind::PART && kind != FrameKind::LAST && kind != FrameKind::CANCEL) {
+      throw SessionException("Received an RPC frame of unknown kind {}!", static_cast<uint8_t>(kind));
+    }
+    if (frame_size > kMaxFrameSize) {
+      throw SessionException("Received an RPC frame of {} bytes, which is too large!", frame_size);
+    }
+    const bool last = kind == FrameKind::LAST;
+    const auto frame_end = in_place_size_ + kFrameHeaderSize + frame_size;
+    if (input_stream_->size() < frame_end) {
+      input_stream_->Resize(frame_end);
+      return;
+    }
+
+    if (!in_place_frames_.empty() && seq != in_place_seq_) {
+      // Another request is interleaved, so the frames left in the stream are
+      // copied out of its way.
+      CopyInPlaceFrames();
+      continue;
+    }
+
+    if (kind == FrameKind::CANCEL) {
+      // The client abandoned the request, so the frames received so far are
+      // dropped together with the cancel frame.
+      partial_requests_.erase(seq);
+      input_stream_->Shift(frame_end);
+      in_place_frames_.clear();
+      in_place_size_ = 0;
+      continue;
+    }
+
+    if (!in_place_frames_.empty() || (!last && !partial_requests_.contains(seq))) {
+      in_place_seq_ = seq;
+      in_place_frames_.emplace_back(in_place_size_ + kFrameHeaderSize, frame_size);
+      in_place_size_ = frame_end;
+      if (!last) continue;
+
+      // Remove the frames from the stream on scope exit.
+      utils::OnScopeExit shift_data([&] {
+        input_stream_->Shift(in_place_size_);
+        in_place_frames_.clear();
+        in_place_size_ = 0;
+      });
+      std::vector<std::span<const uint8_t>> frames;
+      frames.reserve(in_place_frames_.size());
+      for (const auto &[offset, size] : in_place_frames_) {
+        frames.emplace_back(input_stream_->data() + offset, size);
+      }
+      ExecuteRequest(seq, frames);
+      continue;
+    }
+
+    // Remove the frame from the stream on scope exit.
+    utils::OnScopeExit shift_data([&, frame_size] { input_stream_->Shift(kFrameHeaderSize + frame_size); });
+    const auto *data = input_stream_->data() + kFrameHeaderSize;
+
+    if (!last) {
+      auto &partial = partial_requests_[seq];
+      partial.insert(partial.end(), data, data + frame_size);
+      continue;
+    }
+    auto it = partial_requests_.find(seq);
+    if (it == partial_requests_.end()) {
+      // The whole request is in this frame, so it's executed straight from the
+      // input stream.
+      const std::span<const uint8_t> frames[] = {{data, frame_size}};
+      ExecuteRequest(seq, frames);
+      continue;
+    }
+    auto request = std::move(it->second);
+    partial_requests_.erase(it);
+    request.insert(request.end(), data, data + frame_size);
+    const std::span<const uint8_t> frames[] = {request};
+    ExecuteRequest(seq, frames);
+  }
+}
+
+void Session::CopyInPlaceFrames() {
+  auto &partial = partial_requests_[in_place_seq_];
+  for (const auto &[offset, size] : in_place_frames_) {
+    const auto *data = input_stream_->data() + offset;
+    partial.insert(partial.end(), data, data + size);
+  }
+  input_stream_->Shift(in_place_size_);
+  in_place_frames_.clear();
+  in_place_size_ = 0;
+}
+
+bool Session::Handshake() {
+  if (input_stream_->size() < kHandshakeSize) {
+    input_stream_->Resize(kHandshakeSize);
+    return false;
+  }
+  uint32_t handshake[3];
+  memcpy(handshake, input_stream_->data(), kHandshakeSize);
+  if (handshake[0] != 0 || handshake[1] != kProtocolMagic) {
+    throw SessionException("Received an invalid RPC handshake!");
+  }
+  // The version is sent back in any case so that the client can report the
+  // mismatch.
+  output_stream_->Write(reinterpret_cast<const uint8_t *>(&kProtocolVersion), sizeof(kProtocolVersion));
+  if (handshake[2] != kProtocolVersion) {
+    throw SessionException("Received a request with RPC protocol version {}, expected version {}!", handshake[2],
+                           kProtocolVersion);
   }
+  input_stream_->Shift(kHandshakeSize);
+  handshake_done_ = true;
+  return true;
+}
 
-  // Remove the data from the stream on scope exit.
-  utils::OnScopeExit shift_data([&, ret] { input_stream_->Shift(ret.stream_size); });
+void Session::ExecuteRequest(uint64_t seq, std::span<const std::span<const uint8_t>> frames) {
+  auto ret = slk::CheckStreamComplete(frames);
+  if (ret.status != slk::StreamStatus::COMPLETE) {
+    throw SessionException("Received an invalid SLK stream!");
+  }
 
   // Prepare SLK reader and builder.
-  slk::Reader req_reader(input_stream_->data(), input_stream_->size());
+  slk::Reader req_reader(frames);
   slk::Builder res_builder(
       [&](const uint8_t *data, size_t size, bool have_more) { output_stream_->Write(data, size, have_more); });
 
-  // Load the request ID.
+  // Load the message type ID.
   uint64_t req_id = 0;
   slk::Load(&req_id, &req_reader);
 
@@ -60,10 +185,12 @@ void Session::Execute() {
       throw SessionException("Session trying to execute an unregistered RPC call!");
     }
     SPDLOG_TRACE("[RpcServer] received {}", extended_it->second.req_type.name);
+    slk::Save(seq, &res_builder);
     slk::Save(extended_it->second.res_type.id, &res_builder);
     extended_it->second.callback(endpoint_, &req_reader, &res_builder);
   } else {
     SPDLOG_TRACE("[RpcServer] received {}", it->second.req_type.name);
+    slk::Save(seq, &res_builder);
     slk::Save(it->second.res_type.id, &res_builder);
     it->second.callback(&req_reader, &res_builder);
   }
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -14,6 +14,10 @@
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "communication/session.hpp"
 #include "rpc/messages.hpp"
@@ -24,8 +28,26 @@
  * Has classes and functions that implement the server side of our
  * RPC protocol.
  *
- * Message layout: MessageSize message_size,
- *                 message_size bytes serialized_message
+ * The connection starts with the handshake of the client, which is a zero,
+ * `kProtocolMagic` and the client's `kProtocolVersion`, each a uint32_t. The
+ * server answers with its own version and closes the connection if the
+ * handshake is invalid or the versions differ.
+ *
+ * Requests are sent in frames: uint64_t sequence number, uint32_t frame_size,
+ *                              uint8_t kind (see `FrameKind`),
+ *                              frame_size bytes of the serialized request
+ *
+ * The serialized request is an SLK stream starting with the ID of the message
+ * type, and it's split into frames so that the frames of different requests
+ * can be interleaved. Requests are executed in the order in which their last
+ * frames arrive, so a short request isn't held back by a long streamed one
+ * which started before it. A request which the client abandons is ended with
+ * a cancel frame instead, and the server drops its frames without executing
+ * it.
+ *
+ * Each response is an SLK stream which starts with the sequence number of its
+ * request, followed by the ID of the message type, so that the client can have
+ * many requests in flight on one connection and match the responses to them.
  */
 namespace memgraph::rpc {
 
@@ -58,10 +80,33 @@ class Session {
   void Execute();
 
  private:
+  // Checks the handshake at the start of the input stream, returns false if
+  // it wasn't received completely yet.
+  bool Handshake();
+
+  // Copies the frames left in the input stream to `partial_requests_` and
+  // removes them from the stream.
+  void CopyInPlaceFrames();
+
+  // Executes the complete serialized request, which is made of the data of
+  // the `frames`.
+  void ExecuteRequest(uint64_t seq, std::span<const std::span<const uint8_t>> frames);
+
   Server *server_;
   io::network::Endpoint endpoint_;
   communication::InputStream *input_stream_;
   communication::OutputStream *output_stream_;
+
+  bool handshake_done_{false};
+  // Frames received so far of the requests whose last frame didn't arrive yet
+  // and which were interleaved with other requests.
+  std::unordered_map<uint64_t, std::vector<uint8_t>> partial_requests_;
+  // The frames of the request `in_place_seq_` which are left at the start of
+  // the input stream, as the offsets and sizes of their data, and the size of
+  // the stream they take up.
+  uint64_t in_place_seq_{0};
+  std::vector<std::pair<size_t, size_t>> in_place_frames_;
+  size_t in_place_size_{0};
 };
 
 }  // namespace memgraph::rpc
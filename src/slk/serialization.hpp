@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -154,29 +154,35 @@ inline void Load(double *obj, Reader *reader) {
 
 // Implementation of serialization of complex types.
 
+// The strings are saved as references, so that large strings aren't copied
+// into the segment buffer.
+
 inline void Save(const std::string &obj, Builder *builder) {
   uint64_t size = obj.size();
   Save(size, builder);
-  builder->Save(reinterpret_cast<const uint8_t *>(obj.data()), size);
+  builder->SaveReference(reinterpret_cast<const uint8_t *>(obj.data()), size);
 }
 
 inline void Save(const char *obj, Builder *builder) {
   uint64_t size = strlen(obj);
   Save(size, builder);
-  builder->Save(reinterpret_cast<const uint8_t *>(obj), size);
+  builder->SaveReference(reinterpret_cast<const uint8_t *>(obj), size);
 }
 
 inline void Save(const std::string_view obj, Builder *builder) {
   uint64_t size = obj.size();
   Save(size, builder);
-  builder->Save(reinterpret_cast<const uint8_t *>(obj.data()), size);
+  builder->SaveReference(reinterpret_cast<const uint8_t *>(obj.data()), size);
 }
 
 inline void Load(std::string *obj, Reader *reader) {
   uint64_t size = 0;
   Load(&size, reader);
-  *obj = std::string(size, '\0');
-  reader->Load(reinterpret_cast<uint8_t *>(obj->data()), size);
+  obj->clear();
+  obj->reserve(size);
+  reader->LoadView(size, [obj](const uint8_t *data, size_t data_size) {
+    obj->append(reinterpret_cast<const char *>(data), data_size);
+  });
 }
 
 template <typename T>
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -11,6 +11,7 @@
 
 #include "slk/streams.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #include "utils/logging.hpp"
@@ -19,6 +20,9 @@ namespace memgraph::slk {
 
 Builder::Builder(std::function<void(const uint8_t *, size_t, bool)> write_func) : write_func_(write_func) {}
 
+Builder::Builder(std::function<void(const uint8_t *, size_t, bool)> write_func, WriteVectorFunction write_vector_func)
+    : write_func_(write_func), write_vector_func_(write_vector_func) {}
+
 void Builder::Save(const uint8_t *data, uint64_t size) {
   size_t offset = 0;
   while (size > 0) {
@@ -38,10 +42,49 @@ void Builder::Save(const uint8_t *data, uint64_t size) {
   }
 }
 
+void Builder::SaveReference(const uint8_t *data, uint64_t size) {
+  if (!write_vector_func_ || size < kSegmentMinReferenceSize) {
+    Save(data, size);
+    return;
+  }
+
+  // Close the buffered segment so that it is written out before the data.
+  std::span<const uint8_t> buffered;
+  if (pos_ > 0) {
+    SegmentSize buffered_size = pos_;
+    memcpy(segment_, &buffered_size, sizeof(SegmentSize));
+    buffered = {segment_, sizeof(SegmentSize) + pos_};
+    pos_ = 0;
+  }
+
+  while (size > 0) {
+    SegmentSize segment_size = std::min(size, kSegmentMaxDataSize);
+    const std::span<const uint8_t> buffers[] = {
+        buffered,
+        {reinterpret_cast<const uint8_t *>(&segment_size), sizeof(SegmentSize)},
+        {data, segment_size},
+    };
+    write_vector_func_(buffered.empty() ? std::span(buffers).subspan(1) : std::span(buffers), true);
+    buffered = {};
+    data += segment_size;
+    size -= segment_size;
+  }
+  flushed_ = true;
+}
+
 void Builder::Finalize() { FlushSegment(true); }
 
 void Builder::FlushSegment(bool final_segment) {
   if (!final_segment && pos_ < kSegmentMaxDataSize) return;
+  if (pos_ == 0 && final_segment && flushed_) {
+    // All of the data was written with `SaveReference`, only the footer is
+    // left.
+    SegmentSize footer = 0;
+    memcpy(segment_, &footer, sizeof(SegmentSize));
+    write_func_(segment_, sizeof(SegmentSize), false);
+    flushed_ = false;
+    return;
+  }
   MG_ASSERT(pos_ > 0, "Trying to flush out a segment that has no data in it!");
 
   size_t total_size = sizeof(SegmentSize) + pos_;
@@ -58,10 +101,13 @@ void Builder::FlushSegment(bool final_segment) {
   write_func_(segment_, total_size, !final_segment);
 
   pos_ = 0;
+  flushed_ = !final_segment;
 }
 
 Reader::Reader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
 
+Reader::Reader(std::span<const std::span<const uint8_t>> parts) : data_(nullptr), size_(0), next_parts_(parts) {}
+
 void Reader::Load(uint8_t *data, uint64_t size) {
   size_t offset = 0;
   while (size > 0) {
@@ -78,6 +124,20 @@ void Reader::Load(uint8_t *data, uint64_t size) {
   }
 }
 
+void Reader::LoadView(uint64_t size, const std::function<void(const uint8_t *, size_t)> &func) {
+  while (size > 0) {
+    GetSegment();
+    size_t to_read = size;
+    if (to_read > have_) {
+      to_read = have_;
+    }
+    func(data_ + pos_, to_read);
+    pos_ += to_read;
+    have_ -= to_read;
+    size -= to_read;
+  }
+}
+
 void Reader::Finalize() { GetSegment(true); }
 
 void Reader::GetSegment(bool should_be_final) {
@@ -88,6 +148,14 @@ void Reader::GetSegment(bool should_be_final) {
     return;
   }
 
+  // Move on to the next part once the current one is read.
+  while (pos_ == size_ && !next_parts_.empty()) {
+    data_ = next_parts_.front().data();
+    size_ = next_parts_.front().size();
+    pos_ = 0;
+    next_parts_ = next_parts_.subspan(1);
+  }
+
   // Load new segment.
   SegmentSize len = 0;
   if (pos_ + sizeof(SegmentSize) > size_) {
@@ -142,4 +210,40 @@ StreamInfo CheckStreamComplete(const uint8_t *data, size_t size) {
   return {StreamStatus::COMPLETE, pos, data_size};
 }
 
+StreamInfo CheckStreamComplete(std::span<const std::span<const uint8_t>> parts) {
+  size_t found_segments = 0;
+  size_t data_size = 0;
+
+  size_t stream_size = 0;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    const auto &part = parts[i];
+    size_t pos = 0;
+    while (pos < part.size()) {
+      SegmentSize len = 0;
+      if (pos + sizeof(SegmentSize) > part.size()) {
+        return {StreamStatus::INVALID, 0, 0};
+      }
+      memcpy(&len, part.data() + pos, sizeof(SegmentSize));
+      pos += sizeof(SegmentSize);
+      if (len == 0) {
+        // The footer has to be at the end of the last part.
+        if (found_segments < 1 || i + 1 != parts.size() || pos != part.size()) {
+          return {StreamStatus::INVALID, 0, 0};
+        }
+        return {StreamStatus::COMPLETE, stream_size + pos, data_size};
+      }
+
+      if (pos + len > part.size()) {
+        return {StreamStatus::INVALID, 0, 0};
+      }
+      pos += len;
+
+      ++found_segments;
+      data_size += len;
+    }
+    stream_size += pos;
+  }
+  return {StreamStatus::PARTIAL, stream_size + kSegmentMaxTotalSize, data_size};
+}
+
 }  // namespace memgraph::slk
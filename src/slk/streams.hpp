@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <span>
 
 #include "utils/exceptions.hpp"
 
@@ -31,6 +32,12 @@ const uint64_t kSegmentMaxTotalSize = kSegmentMaxDataSize + sizeof(SegmentSize)
 static_assert(kSegmentMaxDataSize <= std::numeric_limits<SegmentSize>::max(),
               "The SLK segment can't be larger than the type used to store its size!");
 
+// Data saved with `Builder::SaveReference` which is at least
+// `kSegmentMinReferenceSize` bytes large is written out from the memory it is
+// in instead of being copied into the segment buffer. Smaller data is cheaper
+// to copy than to give its own segment.
+const uint64_t kSegmentMinReferenceSize = 16384;
+
 /// SLK splits binary data into segments. Segments are used to avoid the need to
 /// have all of the encoded data in memory at once during the building process.
 /// That enables streaming during the building process and makes the whole
@@ -42,23 +49,45 @@ static_assert(kSegmentMaxDataSize <= std::numeric_limits<SegmentSize>::max(),
 /// size of `kSegmentMaxDataSize`. The `size` field itself has a size of
 /// `sizeof(SegmentSize)`. A segment of size 0 indicates that we have reached
 /// the end of a stream and that there is no more data to be read/written.
+///
+/// Large data can also be written straight from the memory it is in, without
+/// copying it into the segment buffer first. The builder then closes the
+/// buffered segment and writes the data as segments of their own, passing
+/// each segment header together with the referenced data to a scatter-gather
+/// write function.
+
+/// Function that writes out all of the `buffers` one after another.
+using WriteVectorFunction = std::function<void(std::span<const std::span<const uint8_t>>, bool)>;
 
 /// Builder used to create a SLK segment stream.
 class Builder {
  public:
   Builder(std::function<void(const uint8_t *, size_t, bool)> write_func);
 
+  /// The `write_vector_func` is used to write the data saved with
+  /// `SaveReference` without copying it.
+  Builder(std::function<void(const uint8_t *, size_t, bool)> write_func, WriteVectorFunction write_vector_func);
+
   /// Function used internally by SLK to serialize the data.
   void Save(const uint8_t *data, uint64_t size);
 
+  /// Same as `Save`, but large data is written from where it is instead of
+  /// being copied when the builder has a scatter-gather write function. The
+  /// data is written before the call returns, so it only has to stay valid
+  /// until then.
+  void SaveReference(const uint8_t *data, uint64_t size);
+
   /// Function that should be called after all `slk::Save` operations are done.
+  /// The builder can be used for a new stream afterwards.
   void Finalize();
 
  private:
   void FlushSegment(bool final_segment);
 
   std::function<void(const uint8_t *, size_t, bool)> write_func_;
+  WriteVectorFunction write_vector_func_;
   size_t pos_{0};
+  bool flushed_{false};
   uint8_t segment_[kSegmentMaxTotalSize];
 };
 
@@ -74,9 +103,20 @@ class Reader {
  public:
   Reader(const uint8_t *data, size_t size);
 
+  /// Reads the stream made of the `parts` one after another, so that a stream
+  /// which was received in parts doesn't have to be copied together. Each part
+  /// has to hold whole segments, and the parts have to stay valid while the
+  /// reader is used.
+  explicit Reader(std::span<const std::span<const uint8_t>> parts);
+
   /// Function used internally by SLK to deserialize the data.
   void Load(uint8_t *data, uint64_t size);
 
+  /// Passes the next `size` bytes of the stream to `func` instead of copying
+  /// them out, as one view for each segment they are in. The views point into
+  /// the data given to the reader.
+  void LoadView(uint64_t size, const std::function<void(const uint8_t *, size_t)> &func);
+
   /// Function that should be called after all `slk::Load` operations are done.
   void Finalize();
 
@@ -85,6 +125,7 @@ class Reader {
 
   const uint8_t *data_;
   size_t size_;
+  std::span<const std::span<const uint8_t>> next_parts_;
 
   size_t pos_{0};
   size_t have_{0};
@@ -118,4 +159,9 @@ struct StreamInfo {
 /// segment data.
 StreamInfo CheckStreamComplete(const uint8_t *data, size_t size);
 
+/// Same as above, but for a stream made of the `parts` one after another, each
+/// of which has to hold whole segments. A segment split between two parts makes
+/// the stream invalid.
+StreamInfo CheckStreamComplete(std::span<const std::span<const uint8_t>> parts);
+
 }  // namespace memgraph::slk
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -55,6 +55,13 @@ struct Config {
   struct Transaction {
     IsolationLevel isolation_level{IsolationLevel::SNAPSHOT_ISOLATION};
   } transaction;
+
+  struct Replication {
+    // The number of committed transactions that can wait to be sent to an
+    // ASYNC replica. The replica is recovered from the durability files once
+    // it falls further behind.
+    uint64_t async_queue_size{1000};
+  } replication;
 };
 
 }  // namespace memgraph::storage
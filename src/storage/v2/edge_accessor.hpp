@@ -58,6 +58,12 @@ class EdgeAccessor final {
   /// @throw std::bad_alloc
   Result<storage::PropertyValue> SetProperty(PropertyId property, const PropertyValue &value);
 
+  /// Set the properties of an edge which doesn't have any properties yet.
+  /// Returns `false` and doesn't set anything if the edge already has
+  /// properties.
+  /// @throw std::bad_alloc
+  Result<bool> InitProperties(const std::map<PropertyId, PropertyValue> &properties);
+
   /// Remove all properties and return old values for each removed property.
   /// @throw std::bad_alloc
   Result<std::map<PropertyId, PropertyValue>> ClearProperties();
@@ -363,6 +363,22 @@ LabelIndex::Iterable::Iterable(utils::SkipList<Entry>::Accessor index_accessor,
       constraints_(constraints),
       config_(config) {}
 
+int64_t LabelIndex::VertexCount(LabelId label, View view, Transaction *transaction) {
+  auto it = index_.find(label);
+  MG_ASSERT(it != index_.end(), "Index for label {} doesn't exist", label.AsUint());
+  auto acc = it->second.access();
+  int64_t count = 0;
+  Vertex *last_vertex = nullptr;
+  for (const auto &entry : acc) {
+    if (entry.vertex == last_vertex) continue;
+    if (CurrentVersionHasLabel(*entry.vertex, label, transaction, view)) {
+      last_vertex = entry.vertex;
+      ++count;
+    }
+  }
+  return count;
+}
+
 void LabelIndex::RunGC() {
   for (auto &index_entry : index_) {
     index_entry.second.run_gc();
@@ -688,6 +704,48 @@ int64_t LabelPropertyIndex::ApproximateVertexCount(LabelId label, PropertyId pro
   return acc.estimate_range_count(lower, upper, utils::SkipListLayerForCountEstimation(acc.size()));
 }
 
+int64_t LabelPropertyIndex::VertexCount(LabelId label, PropertyId property, View view, Transaction *transaction) {
+  auto it = index_.find({label, property});
+  MG_ASSERT(it != index_.end(), "Index for label {} and property {} doesn't exist", label.AsUint(), property.AsUint());
+  auto acc = it->second.access();
+  int64_t count = 0;
+  Vertex *last_vertex = nullptr;
+  for (const auto &entry : acc) {
+    if (entry.vertex == last_vertex) continue;
+    if (CurrentVersionHasLabelProperty(*entry.vertex, label, property, entry.value, transaction, view)) {
+      last_vertex = entry.vertex;
+      ++count;
+    }
+  }
+  return count;
+}
+
+PropertyValue LabelPropertyIndex::MinValue(LabelId label, PropertyId property, View view, Transaction *transaction) {
+  auto it = index_.find({label, property});
+  MG_ASSERT(it != index_.end(), "Index for label {} and property {} doesn't exist", label.AsUint(), property.AsUint());
+  auto acc = it->second.access();
+  for (const auto &entry : acc) {
+    if (CurrentVersionHasLabelProperty(*entry.vertex, label, property, entry.value, transaction, view)) {
+      return entry.value;
+    }
+  }
+  return PropertyValue();
+}
+
+PropertyValue LabelPropertyIndex::MaxValue(LabelId label, PropertyId property, View view, Transaction *transaction) {
+  auto it = index_.find({label, property});
+  MG_ASSERT(it != index_.end(), "Index for label {} and property {} doesn't exist", label.AsUint(), property.AsUint());
+  auto acc = it->second.access();
+  // The entries are walked from the back so that only the entries that aren't
+  // visible to the transaction (and are larger than the result) are checked.
+  for (auto entry_it = acc.last(); entry_it != acc.end(); entry_it = acc.find_last_smaller(*entry_it)) {
+    if (CurrentVersionHasLabelProperty(*entry_it->vertex, label, property, entry_it->value, transaction, view)) {
+      return entry_it->value;
+    }
+  }
+  return PropertyValue();
+}
+
 void LabelPropertyIndex::RunGC() {
   for (auto &index_entry : index_) {
     index_entry.second.run_gc();
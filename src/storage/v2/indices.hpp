@@ -120,6 +120,11 @@ class LabelIndex {
     return it->second.size();
   }
 
+  /// Returns the exact number of vertices with the given label that are
+  /// visible from the given transaction. The index entries are checked
+  /// directly, so no vertex accessors are created while counting.
+  int64_t VertexCount(LabelId label, View view, Transaction *transaction);
+
   void Clear() { index_.clear(); }
 
   void RunGC();
@@ -237,6 +242,20 @@ class LabelPropertyIndex {
                                  const std::optional<utils::Bound<PropertyValue>> &lower,
                                  const std::optional<utils::Bound<PropertyValue>> &upper) const;
 
+  /// Returns the exact number of vertices with the given label and property
+  /// that are visible from the given transaction.
+  int64_t VertexCount(LabelId label, PropertyId property, View view, Transaction *transaction);
+
+  /// Returns the smallest value of the property among the vertices visible
+  /// from the given transaction. `Null` is returned if there are no such
+  /// vertices.
+  PropertyValue MinValue(LabelId label, PropertyId property, View view, Transaction *transaction);
+
+  /// Returns the largest value of the property among the vertices visible
+  /// from the given transaction. `Null` is returned if there are no such
+  /// vertices.
+  PropertyValue MaxValue(LabelId label, PropertyId property, View view, Transaction *transaction);
+
   void Clear() { index_.clear(); }
 
   void RunGC();
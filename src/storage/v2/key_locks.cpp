@@ -0,0 +1,72 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "storage/v2/key_locks.hpp"
+
+#include <algorithm>
+
+namespace memgraph::storage {
+
+Result<bool> KeyLocks::Lock(const Key &key, const Transaction &transaction, std::chrono::milliseconds timeout,
+                            const std::function<bool()> &must_abort) {
+  std::unique_lock<std::mutex> guard(lock_);
+  auto &key_lock = locks_[key];
+  if (key_lock.owner == transaction.transaction_id) return false;
+  if (key_lock.owner) {
+    ++key_lock.waiters;
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool released = false;
+    while (true) {
+      const auto wait_until = std::min(deadline, std::chrono::steady_clock::now() + kAbortCheckInterval);
+      released = released_.wait_until(guard, wait_until, [&key_lock] { return !key_lock.owner; });
+      if (released || std::chrono::steady_clock::now() >= deadline || (must_abort && must_abort())) break;
+    }
+    --key_lock.waiters;
+    if (!released) return Error::SERIALIZATION_ERROR;
+  }
+  // Under snapshot isolation the changes of a previous owner aren't visible
+  // if it committed after this transaction started. Upserting the key would
+  // then miss them.
+  if (transaction.isolation_level == IsolationLevel::SNAPSHOT_ISOLATION &&
+      key_lock.last_commit_timestamp > transaction.start_timestamp) {
+    return Error::SERIALIZATION_ERROR;
+  }
+  key_lock.owner = transaction.transaction_id;
+  return true;
+}
+
+void KeyLocks::Unlock(const std::vector<Key> &keys, std::optional<uint64_t> commit_timestamp) {
+  if (keys.empty()) return;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    for (const auto &key : keys) {
+      auto it = locks_.find(key);
+      if (it == locks_.end()) continue;
+      auto &key_lock = it->second;
+      key_lock.owner.reset();
+      if (commit_timestamp) {
+        key_lock.last_commit_timestamp = std::max(key_lock.last_commit_timestamp, *commit_timestamp);
+      }
+      if (key_lock.waiters == 0 && key_lock.last_commit_timestamp == 0) locks_.erase(it);
+    }
+  }
+  released_.notify_all();
+}
+
+void KeyLocks::RemoveObsoleteEntries(uint64_t oldest_active_start_timestamp) {
+  std::lock_guard<std::mutex> guard(lock_);
+  std::erase_if(locks_, [oldest_active_start_timestamp](const auto &item) {
+    const auto &key_lock = item.second;
+    return !key_lock.owner && key_lock.waiters == 0 && key_lock.last_commit_timestamp < oldest_active_start_timestamp;
+  });
+}
+
+}  // namespace memgraph::storage
@@ -0,0 +1,81 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "storage/v2/id_types.hpp"
+#include "storage/v2/property_value.hpp"
+#include "storage/v2/result.hpp"
+#include "storage/v2/transaction.hpp"
+
+namespace memgraph::storage {
+
+/// Locks on (label, property, value) keys. A lock is owned by a transaction
+/// and it is held until the transaction ends. MERGE takes the lock of the key
+/// it upserts, so concurrent upserts of the same key run one after another
+/// instead of each of them creating its own vertex.
+///
+/// This class is thread-safe.
+class KeyLocks final {
+ public:
+  using Key = std::tuple<LabelId, PropertyId, PropertyValue>;
+
+  /// How long a transaction waits for a lock held by another transaction.
+  /// Waiting isn't unbounded, because two transactions which lock the same
+  /// keys in a different order would otherwise wait for each other forever.
+  static constexpr std::chrono::milliseconds kLockTimeout{1000};
+
+  /// How often a waiting transaction checks whether it should abort.
+  static constexpr std::chrono::milliseconds kAbortCheckInterval{10};
+
+  /// Lock `key` for `transaction`, waiting for the current owner to finish
+  /// if needed. Returns `true` if the lock was acquired and `false` if the
+  /// transaction already owns it. Returns `Error::SERIALIZATION_ERROR` if the
+  /// lock wasn't released within `timeout` or `must_abort` returned `true`
+  /// while waiting, or if a previous owner committed changes which a snapshot
+  /// isolated `transaction` can't see.
+  Result<bool> Lock(const Key &key, const Transaction &transaction, std::chrono::milliseconds timeout = kLockTimeout,
+                    const std::function<bool()> &must_abort = {});
+
+  /// Release the `keys` locked by the transaction which just finished.
+  /// `commit_timestamp` is the timestamp of its changes, if it committed any.
+  void Unlock(const std::vector<Key> &keys, std::optional<uint64_t> commit_timestamp);
+
+  /// Forget the commit timestamps of the keys whose changes are visible to
+  /// all the active transactions.
+  void RemoveObsoleteEntries(uint64_t oldest_active_start_timestamp);
+
+ private:
+  struct KeyLock {
+    std::optional<uint64_t> owner;
+    uint64_t waiters{0};
+    // Commit timestamp of the last owner which committed changes. It is kept
+    // until every active transaction sees the changes, so that a snapshot
+    // isolated transaction which started earlier can't upsert the key again.
+    uint64_t last_commit_timestamp{0};
+  };
+
+  std::mutex lock_;
+  std::condition_variable released_;
+  std::map<Key, KeyLock> locks_;
+};
+
+}  // namespace memgraph::storage
@@ -59,6 +59,14 @@ class PropertyStore {
   /// @throw std::bad_alloc
   bool SetProperty(PropertyId property, const PropertyValue &value);
 
+  /// Set all of the `properties` in a store which doesn't hold any properties
+  /// yet. The store is encoded in a single pass, which is much cheaper than
+  /// setting the properties one by one. `Null` values are skipped. Returns
+  /// `false` and doesn't modify the store if it already has properties. The
+  /// time complexity of this function is O(n).
+  /// @throw std::bad_alloc
+  bool InitProperties(const std::map<PropertyId, PropertyValue> &properties);
+
   /// Remove all properties and return `true` if any removal took place.
   /// `false` is returned if there were no properties to remove. The time
   /// complexity of this function is O(1).
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -27,6 +27,10 @@ namespace memgraph::storage {
 namespace {
 template <typename>
 [[maybe_unused]] inline constexpr bool always_false_v = false;
+
+// The number of queued transactions sent to an ASYNC replica before waiting
+// for their responses.
+constexpr size_t kMaxTransactionsInFlight = 64;
 }  // namespace
 
 ////// ReplicationClient //////
@@ -41,6 +45,11 @@ Storage::ReplicationClient::ReplicationClient(std::string name, Storage *storage
   }
 
   rpc_client_.emplace(endpoint, &*rpc_context_);
+  if (mode_ == replication::ReplicationMode::ASYNC) {
+    transaction_builder_ = std::make_unique<slk::Builder>([this](const uint8_t *data, size_t size, bool /*have_more*/) {
+      transaction_data_.insert(transaction_data_.end(), data, data + size);
+    });
+  }
   TryInitializeClientSync();
 
   // Help the user to get the most accurate replica state possible.
@@ -176,6 +185,11 @@ void Storage::ReplicationClient::StartTransactionReplication(const uint64_t curr
       spdlog::debug("Replica {} is behind MAIN instance", name_);
       return;
     case replication::ReplicaState::REPLICATING:
+      if (mode_ == replication::ReplicationMode::ASYNC) {
+        // The transaction is queued after the ones which are still being
+        // sent.
+        break;
+      }
       spdlog::debug("Replica {} missed a transaction", name_);
       // We missed a transaction because we're still replicating
       // the previous transaction so we need to go to RECOVERY
@@ -190,15 +204,16 @@ void Storage::ReplicationClient::StartTransactionReplication(const uint64_t curr
       HandleRpcFailure();
       return;
     case replication::ReplicaState::READY:
-      MG_ASSERT(!replica_stream_);
-      try {
-        replica_stream_.emplace(ReplicaStream{this, storage_->last_commit_timestamp_.load(), current_wal_seq_num});
-        replica_state_.store(replication::ReplicaState::REPLICATING);
-      } catch (const rpc::RpcFailedException &) {
-        replica_state_.store(replication::ReplicaState::INVALID);
-        HandleRpcFailure();
-      }
-      return;
+      break;
+  }
+
+  MG_ASSERT(!replica_stream_);
+  try {
+    replica_stream_.emplace(ReplicaStream{this, storage_->last_commit_timestamp_.load(), current_wal_seq_num});
+    replica_state_.store(replication::ReplicaState::REPLICATING);
+  } catch (const rpc::RpcFailedException &) {
+    replica_state_.store(replication::ReplicaState::INVALID);
+    HandleRpcFailure();
   }
 }
 
@@ -207,7 +222,10 @@ void Storage::ReplicationClient::IfStreamingTransaction(const std::function<void
   // valid during a single transaction replication (if the assumption
   // that this and other transaction replication functions can only be
   // called from a one thread stands)
-  if (replica_state_ != replication::ReplicaState::REPLICATING) {
+  // ASYNC replicas are REPLICATING while their queue is being sent, so the
+  // stream itself is checked.
+  if (mode_ == replication::ReplicationMode::ASYNC ? !replica_stream_
+                                                   : replica_state_ != replication::ReplicaState::REPLICATING) {
     return;
   }
 
@@ -223,6 +241,15 @@ void Storage::ReplicationClient::IfStreamingTransaction(const std::function<void
 }
 
 bool Storage::ReplicationClient::FinalizeTransactionReplication() {
+  if (mode_ == replication::ReplicationMode::ASYNC) {
+    if (!replica_stream_) {
+      return false;
+    }
+    auto transaction = replica_stream_->FinalizeQueued();
+    replica_stream_.reset();
+    return QueueTransaction(std::move(transaction));
+  }
+
   // We can only check the state because it guarantees to be only
   // valid during a single transaction replication (if the assumption
   // that this and other transaction replication functions can only be
@@ -231,12 +258,110 @@ bool Storage::ReplicationClient::FinalizeTransactionReplication() {
     return false;
   }
 
-  if (mode_ == replication::ReplicationMode::ASYNC) {
-    thread_pool_.AddTask([this] { static_cast<void>(this->FinalizeTransactionReplicationInternal()); });
-    return true;
-  } else {
-    return FinalizeTransactionReplicationInternal();
+  return FinalizeTransactionReplicationInternal();
+}
+
+bool Storage::ReplicationClient::QueueTransaction(QueuedTransaction transaction) {
+  {
+    std::unique_lock client_guard(client_lock_);
+    const auto status = replica_state_.load();
+    if (status == replication::ReplicaState::RECOVERY || status == replication::ReplicaState::INVALID) {
+      // The replica will get the transaction when it's recovered.
+      return false;
+    }
+    if (transaction_queue_.size() >= storage_->config_.replication.async_queue_size) {
+      // The queue is cleared by the task sending it, which then recovers the
+      // replica.
+      spdlog::debug("Replica {} fell behind by more than {} transactions", name_, transaction_queue_.size());
+      replica_state_.store(replication::ReplicaState::RECOVERY);
+      return false;
+    }
+    transaction_queue_.push_back(std::move(transaction));
+    replica_state_.store(replication::ReplicaState::REPLICATING);
+    if (sending_queue_) {
+      return true;
+    }
+    sending_queue_ = true;
   }
+  thread_pool_.AddTask([this] { this->SendTransactionQueue(); });
+  return true;
+}
+
+void Storage::ReplicationClient::SendTransactionQueue() {
+  // Commit timestamp of the replica from the last response.
+  std::optional<uint64_t> replica_commit;
+  while (true) {
+    std::vector<const QueuedTransaction *> batch;
+    {
+      std::unique_lock client_guard(client_lock_);
+      const auto status = replica_state_.load();
+      if (status != replication::ReplicaState::REPLICATING || transaction_queue_.empty()) {
+        transaction_queue_.clear();
+        sending_queue_ = false;
+        if (status == replication::ReplicaState::REPLICATING) {
+          replica_state_.store(replication::ReplicaState::READY);
+        }
+        if (status != replication::ReplicaState::RECOVERY) {
+          return;
+        }
+        // The replica fell behind too much or missed a transaction.
+        client_guard.unlock();
+        if (replica_commit) {
+          RecoverReplica(*replica_commit);
+        } else {
+          TryInitializeClientSync();
+        }
+        return;
+      }
+      const auto batch_size = std::min(transaction_queue_.size(), kMaxTransactionsInFlight);
+      batch.reserve(batch_size);
+      for (size_t i = 0; i < batch_size; ++i) {
+        batch.push_back(&transaction_queue_[i]);
+      }
+    }
+
+    auto success = true;
+    try {
+      std::vector<std::future<replication::AppendDeltasRes>> responses;
+      responses.reserve(batch.size());
+      for (const auto *transaction : batch) {
+        responses.push_back(SendQueuedTransaction(*transaction));
+      }
+      for (auto &response : responses) {
+        const auto res = response.get();
+        success = success && res.success;
+        replica_commit = res.current_commit_timestamp;
+      }
+    } catch (const rpc::RpcFailedException &) {
+      {
+        std::unique_lock client_guard(client_lock_);
+        transaction_queue_.clear();
+        sending_queue_ = false;
+        replica_state_.store(replication::ReplicaState::INVALID);
+      }
+      HandleRpcFailure();
+      return;
+    }
+
+    std::unique_lock client_guard(client_lock_);
+    transaction_queue_.erase(transaction_queue_.begin(), transaction_queue_.begin() + batch.size());
+    if (!success && replica_state_ == replication::ReplicaState::REPLICATING) {
+      replica_state_.store(replication::ReplicaState::RECOVERY);
+    }
+  }
+}
+
+std::future<replication::AppendDeltasRes> Storage::ReplicationClient::SendQueuedTransaction(
+    const QueuedTransaction &transaction) {
+  auto stream{rpc_client_->Stream<replication::AppendDeltasRpc>(transaction.previous_commit_timestamp,
+                                                                transaction.current_wal_seq_num)};
+  // The encoded transaction is copied into the request from the queue as it
+  // is, large values are sent straight from the queue.
+  slk::Reader reader(transaction.data.data(), transaction.data.size());
+  reader.LoadView(transaction.encoded_size,
+                  [&stream](const uint8_t *data, size_t size) { stream.GetBuilder()->SaveReference(data, size); });
+  reader.Finalize();
+  return stream.AsyncResponse();
 }
 
 bool Storage::ReplicationClient::FinalizeTransactionReplicationInternal() {
@@ -528,42 +653,78 @@ Storage::TimestampInfo Storage::ReplicationClient::GetTimestampInfo() {
   return info;
 }
 
+Storage::QueueInfo Storage::ReplicationClient::GetQueueInfo() {
+  std::unique_lock client_guard(client_lock_);
+  Storage::QueueInfo info{transaction_queue_.size(), std::chrono::milliseconds(0)};
+  if (!transaction_queue_.empty()) {
+    info.lag = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                     transaction_queue_.front().queued_at);
+  }
+  return info;
+}
+
 ////// ReplicaStream //////
 Storage::ReplicationClient::ReplicaStream::ReplicaStream(ReplicationClient *self,
                                                          const uint64_t previous_commit_timestamp,
                                                          const uint64_t current_seq_num)
-    : self_(self),
-      stream_(self_->rpc_client_->Stream<replication::AppendDeltasRpc>(previous_commit_timestamp, current_seq_num)) {
-  replication::Encoder encoder{stream_.GetBuilder()};
+    : self_(self) {
+  if (self_->mode_ == replication::ReplicationMode::ASYNC) {
+    transaction_.emplace(QueuedTransaction{.previous_commit_timestamp = previous_commit_timestamp,
+                                           .current_wal_seq_num = current_seq_num,
+                                           .data = {},
+                                           .encoded_size = 0,
+                                           .queued_at = {}});
+  } else {
+    stream_.emplace(
+        self_->rpc_client_->Stream<replication::AppendDeltasRpc>(previous_commit_timestamp, current_seq_num));
+  }
+  replication::Encoder encoder{GetBuilder()};
   encoder.WriteString(self_->storage_->epoch_id_);
 }
 
+slk::Builder *Storage::ReplicationClient::ReplicaStream::GetBuilder() {
+  if (stream_) return stream_->GetBuilder();
+  return self_->transaction_builder_.get();
+}
+
 void Storage::ReplicationClient::ReplicaStream::AppendDelta(const Delta &delta, const Vertex &vertex,
                                                             uint64_t final_commit_timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
+  replication::Encoder encoder(GetBuilder());
   EncodeDelta(&encoder, &self_->storage_->name_id_mapper_, self_->storage_->config_.items, delta, vertex,
               final_commit_timestamp);
 }
 
 void Storage::ReplicationClient::ReplicaStream::AppendDelta(const Delta &delta, const Edge &edge,
                                                             uint64_t final_commit_timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
+  replication::Encoder encoder(GetBuilder());
   EncodeDelta(&encoder, &self_->storage_->name_id_mapper_, delta, edge, final_commit_timestamp);
 }
 
 void Storage::ReplicationClient::ReplicaStream::AppendTransactionEnd(uint64_t final_commit_timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
+  replication::Encoder encoder(GetBuilder());
   EncodeTransactionEnd(&encoder, final_commit_timestamp);
 }
 
 void Storage::ReplicationClient::ReplicaStream::AppendOperation(durability::StorageGlobalOperation operation,
                                                                 LabelId label, const std::set<PropertyId> &properties,
                                                                 uint64_t timestamp) {
-  replication::Encoder encoder(stream_.GetBuilder());
+  replication::Encoder encoder(GetBuilder());
   EncodeOperation(&encoder, &self_->storage_->name_id_mapper_, operation, label, properties, timestamp);
 }
 
-replication::AppendDeltasRes Storage::ReplicationClient::ReplicaStream::Finalize() { return stream_.AwaitResponse(); }
+replication::AppendDeltasRes Storage::ReplicationClient::ReplicaStream::Finalize() { return stream_->AwaitResponse(); }
+
+Storage::ReplicationClient::QueuedTransaction Storage::ReplicationClient::ReplicaStream::FinalizeQueued() {
+  self_->transaction_builder_->Finalize();
+  auto transaction = std::move(*transaction_);
+  transaction.data = std::move(self_->transaction_data_);
+  self_->transaction_data_ = {};
+  const auto info = slk::CheckStreamComplete(transaction.data.data(), transaction.data.size());
+  MG_ASSERT(info.status == slk::StreamStatus::COMPLETE, "Invalid encoding of the replicated transaction");
+  transaction.encoded_size = info.encoded_data_size;
+  transaction.queued_at = std::chrono::steady_clock::now();
+  return transaction;
+}
 
 ////// CurrentWalHandler //////
 Storage::ReplicationClient::CurrentWalHandler::CurrentWalHandler(ReplicationClient *self)
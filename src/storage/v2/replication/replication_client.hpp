@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -13,8 +13,12 @@
 
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
 #include <thread>
 #include <variant>
+#include <vector>
 
 #include "rpc/client.hpp"
 #include "storage/v2/config.hpp"
@@ -42,7 +46,19 @@ class Storage::ReplicationClient {
   ReplicationClient(std::string name, Storage *storage, const io::network::Endpoint &endpoint,
                     replication::ReplicationMode mode, const replication::ReplicationClientConfig &config = {});
 
-  // Handler used for transfering the current transaction.
+  // Committed transaction waiting to be sent to an ASYNC replica.
+  struct QueuedTransaction {
+    uint64_t previous_commit_timestamp;
+    uint64_t current_wal_seq_num;
+    // SLK stream with the epoch id and the deltas of the transaction.
+    std::vector<uint8_t> data;
+    size_t encoded_size;
+    std::chrono::steady_clock::time_point queued_at;
+  };
+
+  // Handler used for transfering the current transaction. SYNC replicas
+  // receive the transaction while it's being committed, while for ASYNC
+  // replicas it's encoded into memory and queued.
   class ReplicaStream {
    private:
     friend class ReplicationClient;
@@ -63,11 +79,16 @@ class Storage::ReplicationClient {
                          const std::set<PropertyId> &properties, uint64_t timestamp);
 
    private:
+    slk::Builder *GetBuilder();
+
     /// @throw rpc::RpcFailedException
     replication::AppendDeltasRes Finalize();
 
+    QueuedTransaction FinalizeQueued();
+
     ReplicationClient *self_;
-    rpc::Client::StreamHandler<replication::AppendDeltasRpc> stream_;
+    std::optional<rpc::Client::StreamHandler<replication::AppendDeltasRpc>> stream_;
+    std::optional<QueuedTransaction> transaction_;
   };
 
   // Handler for transfering the current WAL file whose data is
@@ -125,9 +146,23 @@ class Storage::ReplicationClient {
 
   Storage::TimestampInfo GetTimestampInfo();
 
+  Storage::QueueInfo GetQueueInfo();
+
  private:
   [[nodiscard]] bool FinalizeTransactionReplicationInternal();
 
+  // Queues the transaction for an ASYNC replica and starts sending the queue
+  // if it isn't being sent already.
+  [[nodiscard]] bool QueueTransaction(QueuedTransaction transaction);
+
+  // Sends the queued transactions to the replica, a batch at a time, until the
+  // queue is empty. The transactions in a batch are sent without waiting for
+  // the responses in between.
+  void SendTransactionQueue();
+
+  /// @throw rpc::RpcFailedException
+  std::future<replication::AppendDeltasRes> SendQueuedTransaction(const QueuedTransaction &transaction);
+
   void RecoverReplica(uint64_t replica_commit);
 
   uint64_t ReplicateCurrentWal();
@@ -157,7 +192,18 @@ class Storage::ReplicationClient {
   std::optional<ReplicaStream> replica_stream_;
   replication::ReplicationMode mode_{replication::ReplicationMode::SYNC};
 
+  // Builder which encodes the transactions for an ASYNC replica into
+  // `transaction_data_`. It's kept between the transactions because it's
+  // large.
+  std::unique_ptr<slk::Builder> transaction_builder_;
+  std::vector<uint8_t> transaction_data_;
+
   utils::SpinLock client_lock_;
+  // The queue and the flag are protected by `client_lock_`. Only the task
+  // sending the queue removes the transactions from it, so the transactions
+  // it's sending stay valid without holding the lock.
+  std::deque<QueuedTransaction> transaction_queue_;
+  bool sending_queue_{false};
   // This thread pool is used for background tasks so we don't
   // block the main storage thread
   // We use only 1 thread for 2 reasons:
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -40,7 +40,9 @@ void Encoder::WritePropertyValue(const PropertyValue &value) {
   slk::Save(value, builder_);
 }
 
-void Encoder::WriteBuffer(const uint8_t *buffer, const size_t buffer_size) { builder_->Save(buffer, buffer_size); }
+void Encoder::WriteBuffer(const uint8_t *buffer, const size_t buffer_size) {
+  builder_->SaveReference(buffer, buffer_size);
+}
 
 void Encoder::WriteFileData(utils::InputFile *file) {
   auto file_size = file->GetSize();
@@ -110,8 +112,9 @@ std::optional<PropertyValue> Decoder::ReadPropertyValue() {
 
 bool Decoder::SkipString() {
   if (const auto marker = ReadMarker(); !marker || marker != durability::Marker::TYPE_STRING) return false;
-  std::string value;
-  slk::Load(&value, reader_);
+  uint64_t size = 0;
+  slk::Load(&size, reader_);
+  reader_->LoadView(size, [](const uint8_t * /*data*/, size_t /*size*/) {});
   return true;
 }
 
@@ -135,14 +138,8 @@ std::optional<std::filesystem::path> Decoder::ReadFile(const std::filesystem::pa
   file.Open(path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
   std::optional<size_t> maybe_file_size = ReadUint();
   MG_ASSERT(maybe_file_size, "File size missing");
-  auto file_size = *maybe_file_size;
-  uint8_t buffer[utils::kFileBufferSize];
-  while (file_size > 0) {
-    const auto chunk_size = std::min(file_size, utils::kFileBufferSize);
-    reader_->Load(buffer, chunk_size);
-    file.Write(buffer, chunk_size);
-    file_size -= chunk_size;
-  }
+  // The file data is written straight from the received segments.
+  reader_->LoadView(*maybe_file_size, [&file](const uint8_t *data, size_t size) { file.Write(data, size); });
   file.Close();
   return std::move(path);
 }
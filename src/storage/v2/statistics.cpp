@@ -0,0 +1,337 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "storage/v2/statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "storage/v2/temporal.hpp"
+#include "utils/logging.hpp"
+
+namespace {
+const std::string kVerticesCount = "vertices_count";
+const std::string kEdgesCount = "edges_count";
+const std::string kLabels = "labels";
+const std::string kLabelProperties = "label_properties";
+const std::string kEdgeTypes = "edge_types";
+const std::string kLabel = "label";
+const std::string kProperty = "property";
+const std::string kEdgeType = "edge_type";
+const std::string kCount = "count";
+const std::string kAvgDegree = "avg_degree";
+const std::string kAvgOutDegree = "avg_out_degree";
+const std::string kAvgInDegree = "avg_in_degree";
+const std::string kDistinctValuesCount = "distinct_values_count";
+const std::string kAvgGroupSize = "avg_group_size";
+const std::string kHistogram = "histogram";
+const std::string kLower = "lower";
+const std::string kUpper = "upper";
+const std::string kFromVerticesCount = "from_vertices_count";
+const std::string kToVerticesCount = "to_vertices_count";
+const std::string kMaxOutDegree = "max_out_degree";
+const std::string kMaxInDegree = "max_in_degree";
+const std::string kTemporalType = "temporal_type";
+const std::string kMicroseconds = "microseconds";
+}  // namespace
+
+namespace memgraph::storage {
+
+namespace {
+
+bool IsNumber(const PropertyValue &value) { return value.IsInt() || value.IsDouble(); }
+
+double ToDouble(const PropertyValue &value) {
+  return value.IsInt() ? static_cast<double>(value.ValueInt()) : value.ValueDouble();
+}
+
+// Lists and maps aren't put in the histogram because they can't be persisted
+// as bucket bounds and range filters over them aren't used in practice.
+bool IsHistogramValue(const PropertyValue &value) { return !value.IsList() && !value.IsMap() && !value.IsNull(); }
+
+nlohmann::json PropertyValueToJson(const PropertyValue &value) {
+  switch (value.type()) {
+    case PropertyValue::Type::Bool:
+      return value.ValueBool();
+    case PropertyValue::Type::Int:
+      return value.ValueInt();
+    case PropertyValue::Type::Double:
+      return value.ValueDouble();
+    case PropertyValue::Type::String:
+      return value.ValueString();
+    case PropertyValue::Type::TemporalData: {
+      auto data = nlohmann::json::object();
+      data[kTemporalType] = static_cast<uint8_t>(value.ValueTemporalData().type);
+      data[kMicroseconds] = value.ValueTemporalData().microseconds;
+      return data;
+    }
+    case PropertyValue::Type::Null:
+    case PropertyValue::Type::List:
+    case PropertyValue::Type::Map:
+      return nullptr;
+  }
+  LOG_FATAL("Unknown property value type");
+}
+
+PropertyValue JsonToPropertyValue(const nlohmann::json &data) {
+  if (data.is_boolean()) return PropertyValue(data.get<bool>());
+  if (data.is_number_integer()) return PropertyValue(data.get<int64_t>());
+  if (data.is_number_float()) return PropertyValue(data.get<double>());
+  if (data.is_string()) return PropertyValue(data.get<std::string>());
+  if (data.is_object()) {
+    return PropertyValue(TemporalData{static_cast<TemporalType>(data.at(kTemporalType).get<uint8_t>()),
+                                      data.at(kMicroseconds).get<int64_t>()});
+  }
+  return PropertyValue();
+}
+
+}  // namespace
+
+double Histogram::EstimateEqual(const PropertyValue &value) const {
+  for (const auto &bucket : buckets) {
+    if (value < bucket.lower || bucket.upper < value) continue;
+    if (!PropertyValue::AreComparableTypes(bucket.lower.type(), value.type())) continue;
+    return bucket.count / std::max(bucket.distinct_values_count, 1.0);
+  }
+  return 0;
+}
+
+double Histogram::EstimateRange(const std::optional<utils::Bound<PropertyValue>> &lower,
+                                const std::optional<utils::Bound<PropertyValue>> &upper) const {
+  double estimate = 0;
+  for (const auto &bucket : buckets) {
+    // Values of different types don't satisfy range filters, so only the
+    // buckets of the same type as the bounds are taken into account.
+    if (lower && !PropertyValue::AreComparableTypes(bucket.lower.type(), lower->value().type())) continue;
+    if (upper && !PropertyValue::AreComparableTypes(bucket.lower.type(), upper->value().type())) continue;
+    if (lower && (bucket.upper < lower->value() || (lower->IsExclusive() && bucket.upper == lower->value()))) continue;
+    if (upper && (upper->value() < bucket.lower || (upper->IsExclusive() && bucket.lower == upper->value()))) continue;
+
+    const bool cuts_lower = lower && bucket.lower < lower->value();
+    const bool cuts_upper = upper && upper->value() < bucket.upper;
+    if (!cuts_lower && !cuts_upper) {
+      estimate += bucket.count;
+      continue;
+    }
+    // The bucket is covered only partially. For numbers assume the values are
+    // uniformly distributed inside the bucket, otherwise take a half.
+    double fraction = 0.5;
+    if (IsNumber(bucket.lower) && IsNumber(bucket.upper)) {
+      const auto bucket_lower = ToDouble(bucket.lower);
+      const auto bucket_upper = ToDouble(bucket.upper);
+      const auto range_lower = cuts_lower ? ToDouble(lower->value()) : bucket_lower;
+      const auto range_upper = cuts_upper ? ToDouble(upper->value()) : bucket_upper;
+      if (bucket_upper > bucket_lower) {
+        fraction = std::clamp((range_upper - range_lower) / (bucket_upper - bucket_lower), 0.0, 1.0);
+      }
+    }
+    estimate += std::max(bucket.count * fraction, bucket.count / std::max(bucket.distinct_values_count, 1.0));
+  }
+  return estimate;
+}
+
+const LabelStats *GraphStatistics::GetLabelStats(LabelId label) const {
+  auto it = labels.find(label);
+  return it == labels.end() ? nullptr : &it->second;
+}
+
+const LabelPropertyStats *GraphStatistics::GetLabelPropertyStats(LabelId label, PropertyId property) const {
+  auto it = label_properties.find({label, property});
+  return it == label_properties.end() ? nullptr : &it->second;
+}
+
+const EdgeTypeStats *GraphStatistics::GetEdgeTypeStats(EdgeTypeId edge_type) const {
+  auto it = edge_types.find(edge_type);
+  return it == edge_types.end() ? nullptr : &it->second;
+}
+
+void PropertyValueSampler::Add(const PropertyValue &value) {
+  ++seen_;
+  if (sample_.size() < capacity_) {
+    sample_.push_back(value);
+    return;
+  }
+  std::uniform_int_distribution<int64_t> distribution(0, seen_ - 1);
+  auto position = distribution(generator_);
+  if (position < static_cast<int64_t>(capacity_)) {
+    sample_[position] = value;
+  }
+}
+
+LabelPropertyStats PropertyValueSampler::Finish(size_t buckets_count) && {
+  LabelPropertyStats stats;
+  stats.count = seen_;
+  if (sample_.empty()) return stats;
+
+  std::sort(sample_.begin(), sample_.end());
+
+  // Count how many values appear exactly once and how many appear more times
+  // in the sample.
+  int64_t sample_distinct = 0;
+  int64_t sample_singletons = 0;
+  for (size_t i = 0; i < sample_.size();) {
+    size_t j = i + 1;
+    while (j < sample_.size() && sample_[j] == sample_[i]) ++j;
+    ++sample_distinct;
+    if (j - i == 1) ++sample_singletons;
+    i = j;
+  }
+  if (static_cast<size_t>(seen_) == sample_.size()) {
+    stats.distinct_values_count = sample_distinct;
+  } else {
+    // GEE estimator: values seen once in the sample are scaled up, the values
+    // seen multiple times are assumed to be all the frequent ones.
+    const auto scale = std::sqrt(static_cast<double>(seen_) / static_cast<double>(sample_.size()));
+    stats.distinct_values_count = static_cast<int64_t>(
+        std::llround(scale * static_cast<double>(sample_singletons) + (sample_distinct - sample_singletons)));
+  }
+  stats.distinct_values_count = std::clamp<int64_t>(stats.distinct_values_count, 1, seen_);
+  stats.avg_group_size = static_cast<double>(seen_) / static_cast<double>(stats.distinct_values_count);
+
+  const auto count_scale = static_cast<double>(seen_) / static_cast<double>(sample_.size());
+  const auto distinct_scale = static_cast<double>(stats.distinct_values_count) / static_cast<double>(sample_distinct);
+  const auto bucket_size = std::max<size_t>(1, (sample_.size() + buckets_count - 1) / buckets_count);
+  size_t bucket_begin = 0;
+  size_t bucket_distinct = 0;
+  for (size_t i = 0; i < sample_.size(); ++i) {
+    if (i == 0 || !(sample_[i] == sample_[i - 1])) ++bucket_distinct;
+    const bool is_last = i + 1 == sample_.size();
+    // Buckets are closed only between different values, and never hold values
+    // of different types, so that they can be compared with the bounds.
+    const bool type_changes = !is_last && !PropertyValue::AreComparableTypes(sample_[i].type(), sample_[i + 1].type());
+    const bool value_changes = !is_last && !(sample_[i] == sample_[i + 1]);
+    if (!is_last && !type_changes && !(value_changes && i + 1 - bucket_begin >= bucket_size)) continue;
+    if (IsHistogramValue(sample_[bucket_begin])) {
+      stats.histogram.buckets.push_back({sample_[bucket_begin], sample_[i],
+                                         static_cast<double>(i + 1 - bucket_begin) * count_scale,
+                                         static_cast<double>(bucket_distinct) * distinct_scale});
+    }
+    bucket_begin = i + 1;
+    bucket_distinct = 0;
+  }
+  sample_.clear();
+  return stats;
+}
+
+nlohmann::json GraphStatisticsToJson(const GraphStatistics &statistics, const NameIdMapper &name_id_mapper) {
+  auto data = nlohmann::json::object();
+  data[kVerticesCount] = statistics.vertices_count;
+  data[kEdgesCount] = statistics.edges_count;
+
+  auto labels = nlohmann::json::array();
+  for (const auto &[label, stats] : statistics.labels) {
+    auto item = nlohmann::json::object();
+    item[kLabel] = name_id_mapper.IdToName(label.AsUint());
+    item[kCount] = stats.count;
+    item[kAvgDegree] = stats.avg_degree;
+    item[kAvgOutDegree] = stats.avg_out_degree;
+    item[kAvgInDegree] = stats.avg_in_degree;
+    labels.push_back(std::move(item));
+  }
+  data[kLabels] = std::move(labels);
+
+  auto label_properties = nlohmann::json::array();
+  for (const auto &[label_property, stats] : statistics.label_properties) {
+    auto item = nlohmann::json::object();
+    item[kLabel] = name_id_mapper.IdToName(label_property.first.AsUint());
+    item[kProperty] = name_id_mapper.IdToName(label_property.second.AsUint());
+    item[kCount] = stats.count;
+    item[kDistinctValuesCount] = stats.distinct_values_count;
+    item[kAvgGroupSize] = stats.avg_group_size;
+    auto histogram = nlohmann::json::array();
+    for (const auto &bucket : stats.histogram.buckets) {
+      auto json_bucket = nlohmann::json::object();
+      json_bucket[kLower] = PropertyValueToJson(bucket.lower);
+      json_bucket[kUpper] = PropertyValueToJson(bucket.upper);
+      json_bucket[kCount] = bucket.count;
+      json_bucket[kDistinctValuesCount] = bucket.distinct_values_count;
+      histogram.push_back(std::move(json_bucket));
+    }
+    item[kHistogram] = std::move(histogram);
+    label_properties.push_back(std::move(item));
+  }
+  data[kLabelProperties] = std::move(label_properties);
+
+  auto edge_types = nlohmann::json::array();
+  for (const auto &[edge_type, stats] : statistics.edge_types) {
+    auto item = nlohmann::json::object();
+    item[kEdgeType] = name_id_mapper.IdToName(edge_type.AsUint());
+    item[kCount] = stats.count;
+    item[kFromVerticesCount] = stats.from_vertices_count;
+    item[kToVerticesCount] = stats.to_vertices_count;
+    item[kMaxOutDegree] = stats.max_out_degree;
+    item[kMaxInDegree] = stats.max_in_degree;
+    edge_types.push_back(std::move(item));
+  }
+  data[kEdgeTypes] = std::move(edge_types);
+
+  return data;
+}
+
+std::optional<GraphStatistics> JsonToGraphStatistics(const nlohmann::json &data, NameIdMapper *name_id_mapper) {
+  GraphStatistics statistics;
+
+  const auto get_failed_message = [](const std::string_view message, const std::string_view nested_message) {
+    return fmt::format("Failed to deserialize graph statistics: {} : {}", message, nested_message);
+  };
+
+  const auto to_label = [&](const nlohmann::json &name) {
+    return LabelId::FromUint(name_id_mapper->NameToId(name.get<std::string>()));
+  };
+
+  try {
+    data.at(kVerticesCount).get_to(statistics.vertices_count);
+    data.at(kEdgesCount).get_to(statistics.edges_count);
+
+    for (const auto &item : data.at(kLabels)) {
+      auto &stats = statistics.labels[to_label(item.at(kLabel))];
+      item.at(kCount).get_to(stats.count);
+      item.at(kAvgDegree).get_to(stats.avg_degree);
+      item.at(kAvgOutDegree).get_to(stats.avg_out_degree);
+      item.at(kAvgInDegree).get_to(stats.avg_in_degree);
+    }
+
+    for (const auto &item : data.at(kLabelProperties)) {
+      auto property = PropertyId::FromUint(name_id_mapper->NameToId(item.at(kProperty).get<std::string>()));
+      auto &stats = statistics.label_properties[{to_label(item.at(kLabel)), property}];
+      item.at(kCount).get_to(stats.count);
+      item.at(kDistinctValuesCount).get_to(stats.distinct_values_count);
+      item.at(kAvgGroupSize).get_to(stats.avg_group_size);
+      for (const auto &json_bucket : item.at(kHistogram)) {
+        auto &bucket = stats.histogram.buckets.emplace_back();
+        bucket.lower = JsonToPropertyValue(json_bucket.at(kLower));
+        bucket.upper = JsonToPropertyValue(json_bucket.at(kUpper));
+        json_bucket.at(kCount).get_to(bucket.count);
+        json_bucket.at(kDistinctValuesCount).get_to(bucket.distinct_values_count);
+      }
+    }
+
+    for (const auto &item : data.at(kEdgeTypes)) {
+      auto edge_type = EdgeTypeId::FromUint(name_id_mapper->NameToId(item.at(kEdgeType).get<std::string>()));
+      auto &stats = statistics.edge_types[edge_type];
+      item.at(kCount).get_to(stats.count);
+      item.at(kFromVerticesCount).get_to(stats.from_vertices_count);
+      item.at(kToVerticesCount).get_to(stats.to_vertices_count);
+      item.at(kMaxOutDegree).get_to(stats.max_out_degree);
+      item.at(kMaxInDegree).get_to(stats.max_in_degree);
+    }
+  } catch (const nlohmann::json::type_error &exception) {
+    spdlog::error(get_failed_message("Invalid type conversion", exception.what()));
+    return std::nullopt;
+  } catch (const nlohmann::json::out_of_range &exception) {
+    spdlog::error(get_failed_message("Non existing field", exception.what()));
+    return std::nullopt;
+  }
+
+  return statistics;
+}
+
+}  // namespace memgraph::storage
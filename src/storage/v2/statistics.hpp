@@ -0,0 +1,129 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <json/json.hpp>
+
+#include "storage/v2/id_types.hpp"
+#include "storage/v2/name_id_mapper.hpp"
+#include "storage/v2/property_value.hpp"
+#include "utils/bound.hpp"
+
+namespace memgraph::storage {
+
+/// Equi-depth histogram of property values. Every bucket covers roughly the
+/// same number of values, so the value ranges that hold many values are split
+/// into more buckets. Equal values always fall into the same bucket.
+struct Histogram {
+  struct Bucket {
+    PropertyValue lower;
+    PropertyValue upper;
+    double count{0};
+    double distinct_values_count{0};
+  };
+
+  std::vector<Bucket> buckets;
+
+  /// Estimates the number of values equal to `value`.
+  double EstimateEqual(const PropertyValue &value) const;
+
+  /// Estimates the number of values inside the given bounds. Missing bound
+  /// means the range is unbounded on that side.
+  double EstimateRange(const std::optional<utils::Bound<PropertyValue>> &lower,
+                       const std::optional<utils::Bound<PropertyValue>> &upper) const;
+};
+
+struct LabelStats {
+  int64_t count{0};
+  /// Average number of edges (both directions) of the vertices with the label.
+  double avg_degree{0};
+  /// Average number of outgoing edges of the vertices with the label.
+  double avg_out_degree{0};
+  /// Average number of incoming edges of the vertices with the label.
+  double avg_in_degree{0};
+};
+
+struct LabelPropertyStats {
+  /// Number of vertices with the label which have the property set.
+  int64_t count{0};
+  /// Estimated number of distinct values of the property.
+  int64_t distinct_values_count{0};
+  /// Average number of vertices which share the same property value.
+  double avg_group_size{0};
+  Histogram histogram;
+};
+
+struct EdgeTypeStats {
+  int64_t count{0};
+  /// Number of vertices that have at least one outgoing edge of this type.
+  int64_t from_vertices_count{0};
+  /// Number of vertices that have at least one incoming edge of this type.
+  int64_t to_vertices_count{0};
+  int64_t max_out_degree{0};
+  int64_t max_in_degree{0};
+};
+
+/// Statistics of the whole graph collected by `ANALYZE GRAPH`. The statistics
+/// are a snapshot taken at the time of the analysis, they aren't updated when
+/// the graph changes.
+struct GraphStatistics {
+  int64_t vertices_count{0};
+  int64_t edges_count{0};
+  std::map<LabelId, LabelStats> labels;
+  std::map<std::pair<LabelId, PropertyId>, LabelPropertyStats> label_properties;
+  std::map<EdgeTypeId, EdgeTypeStats> edge_types;
+
+  /// @return nullptr if there are no statistics for the label.
+  const LabelStats *GetLabelStats(LabelId label) const;
+
+  /// @return nullptr if there are no statistics for the label and property.
+  const LabelPropertyStats *GetLabelPropertyStats(LabelId label, PropertyId property) const;
+
+  /// @return nullptr if there are no statistics for the edge type.
+  const EdgeTypeStats *GetEdgeTypeStats(EdgeTypeId edge_type) const;
+};
+
+/// Collects a bounded, uniformly random sample of property values (reservoir
+/// sampling), from which `LabelPropertyStats` are estimated. The number of
+/// distinct values is estimated with the GEE estimator when the sample
+/// doesn't contain all the values.
+class PropertyValueSampler {
+ public:
+  static constexpr size_t kDefaultCapacity = 8192;
+  static constexpr size_t kDefaultBucketsCount = 32;
+
+  explicit PropertyValueSampler(uint64_t seed, size_t capacity = kDefaultCapacity)
+      : capacity_(capacity), generator_(seed) {}
+
+  void Add(const PropertyValue &value);
+
+  LabelPropertyStats Finish(size_t buckets_count = kDefaultBucketsCount) &&;
+
+ private:
+  size_t capacity_;
+  int64_t seen_{0};
+  std::vector<PropertyValue> sample_;
+  std::mt19937_64 generator_;
+};
+
+nlohmann::json GraphStatisticsToJson(const GraphStatistics &statistics, const NameIdMapper &name_id_mapper);
+
+std::optional<GraphStatistics> JsonToGraphStatistics(const nlohmann::json &data, NameIdMapper *name_id_mapper);
+
+}  // namespace memgraph::storage
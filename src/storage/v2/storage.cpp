@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -54,6 +54,7 @@ using OOMExceptionEnabler = utils::MemoryTracker::OutOfMemoryExceptionEnabler;
 
 namespace {
 inline constexpr uint16_t kEpochHistoryRetention = 1000;
+const std::string kGraphStatisticsKey{"graph"};
 
 std::string RegisterReplicaErrorToString(Storage::RegisterReplicaError error) {
   switch (error) {
@@ -418,6 +419,16 @@ Storage::Storage(Config config)
     commit_log_.emplace(timestamp_);
   }
 
+  if (config_.durability.snapshot_wal_mode != Config::Durability::SnapshotWalMode::DISABLED ||
+      config_.durability.recover_on_startup) {
+    utils::EnsureDirOrDie(config_.durability.storage_directory / durability::kStatisticsDirectory);
+    statistics_storage_ =
+        std::make_unique<kvstore::KVStore>(config_.durability.storage_directory / durability::kStatisticsDirectory);
+    if (config_.durability.recover_on_startup) {
+      RestoreGraphStatistics();
+    }
+  }
+
   if (config_.durability.restore_replicas_on_startup) {
     spdlog::info("Replica's configuration will be stored and will be automatically restored in case of a crash.");
     utils::EnsureDirOrDie(config_.durability.storage_directory / durability::kReplicationDirectory);
@@ -472,7 +483,10 @@ Storage::Accessor::Accessor(Accessor &&other) noexcept
       transaction_(std::move(other.transaction_)),
       commit_timestamp_(other.commit_timestamp_),
       is_transaction_active_(other.is_transaction_active_),
-      config_(other.config_) {
+      config_(other.config_),
+      locked_keys_(std::move(other.locked_keys_)),
+      defer_wal_flush_(other.defer_wal_flush_),
+      wal_flushed_(other.wal_flushed_) {
   // Don't allow the other accessor to abort our transaction in destructor.
   other.is_transaction_active_ = false;
   other.commit_timestamp_.reset();
@@ -498,6 +512,33 @@ VertexAccessor Storage::Accessor::CreateVertex() {
   return VertexAccessor(&*it, &transaction_, &storage_->indices_, &storage_->constraints_, config_);
 }
 
+std::vector<VertexAccessor> Storage::Accessor::CreateVertices(uint64_t count) {
+  OOMExceptionEnabler oom_exception;
+  std::vector<VertexAccessor> vertices;
+  if (count == 0) return vertices;
+  vertices.reserve(count);
+  auto first_gid = storage_->vertex_id_.fetch_add(count, std::memory_order_acq_rel);
+  auto acc = storage_->vertices_.access();
+  for (uint64_t i = 0; i < count; ++i) {
+    auto delta = CreateDeleteObjectDelta(&transaction_);
+    auto [it, inserted] = acc.insert(Vertex{storage::Gid::FromUint(first_gid + i), delta});
+    MG_ASSERT(inserted, "The vertex must be inserted here!");
+    MG_ASSERT(it != acc.end(), "Invalid Vertex accessor!");
+    delta->prev.Set(&*it);
+    vertices.emplace_back(&*it, &transaction_, &storage_->indices_, &storage_->constraints_, config_);
+  }
+  return vertices;
+}
+
+Result<void> Storage::Accessor::LockKey(LabelId label, PropertyId property, const PropertyValue &value,
+                                        const std::function<bool()> &must_abort) {
+  KeyLocks::Key key{label, property, value};
+  auto maybe_locked = storage_->key_locks_.Lock(key, transaction_, KeyLocks::kLockTimeout, must_abort);
+  if (maybe_locked.HasError()) return maybe_locked.GetError();
+  if (*maybe_locked) locked_keys_.push_back(std::move(key));
+  return {};
+}
+
 VertexAccessor Storage::Accessor::CreateVertex(storage::Gid gid) {
   OOMExceptionEnabler oom_exception;
   // NOTE: When we update the next `vertex_id_` here we perform a RMW
@@ -845,6 +886,65 @@ PropertyId Storage::Accessor::NameToProperty(const std::string_view name) { retu
 
 EdgeTypeId Storage::Accessor::NameToEdgeType(const std::string_view name) { return storage_->NameToEdgeType(name); }
 
+std::shared_ptr<const GraphStatistics> Storage::Accessor::AnalyzeGraph() {
+  GraphStatistics statistics;
+  std::map<std::pair<LabelId, PropertyId>, PropertyValueSampler> samplers;
+  std::map<LabelId, int64_t> label_out_degrees;
+  std::map<LabelId, int64_t> label_in_degrees;
+  std::map<EdgeTypeId, int64_t> out_degrees;
+  std::map<EdgeTypeId, int64_t> in_degrees;
+
+  for (auto vertex : Vertices(View::OLD)) {
+    auto labels = vertex.Labels(View::OLD);
+    auto properties = vertex.Properties(View::OLD);
+    auto out_edges = vertex.OutEdges(View::OLD);
+    auto in_edges = vertex.InEdges(View::OLD);
+    if (labels.HasError() || properties.HasError() || out_edges.HasError() || in_edges.HasError()) continue;
+
+    ++statistics.vertices_count;
+    statistics.edges_count += static_cast<int64_t>(out_edges->size());
+
+    for (const auto label : *labels) {
+      ++statistics.labels[label].count;
+      label_out_degrees[label] += static_cast<int64_t>(out_edges->size());
+      label_in_degrees[label] += static_cast<int64_t>(in_edges->size());
+      for (const auto &[property, value] : *properties) {
+        auto [it, _] = samplers.try_emplace({label, property}, (label.AsUint() << 32U) ^ property.AsUint());
+        it->second.Add(value);
+      }
+    }
+
+    out_degrees.clear();
+    in_degrees.clear();
+    for (const auto &edge : *out_edges) ++out_degrees[edge.EdgeType()];
+    for (const auto &edge : *in_edges) ++in_degrees[edge.EdgeType()];
+    for (const auto &[edge_type, out_degree] : out_degrees) {
+      auto &stats = statistics.edge_types[edge_type];
+      stats.count += out_degree;
+      ++stats.from_vertices_count;
+      stats.max_out_degree = std::max(stats.max_out_degree, out_degree);
+    }
+    for (const auto &[edge_type, in_degree] : in_degrees) {
+      auto &stats = statistics.edge_types[edge_type];
+      ++stats.to_vertices_count;
+      stats.max_in_degree = std::max(stats.max_in_degree, in_degree);
+    }
+  }
+
+  for (auto &[label, stats] : statistics.labels) {
+    stats.avg_out_degree = static_cast<double>(label_out_degrees[label]) / static_cast<double>(stats.count);
+    stats.avg_in_degree = static_cast<double>(label_in_degrees[label]) / static_cast<double>(stats.count);
+    stats.avg_degree = stats.avg_out_degree + stats.avg_in_degree;
+  }
+  for (auto &[label_property, sampler] : samplers) {
+    statistics.label_properties.emplace(label_property, std::move(sampler).Finish());
+  }
+
+  auto result = std::make_shared<const GraphStatistics>(std::move(statistics));
+  storage_->SetGraphStatistics(result);
+  return result;
+}
+
 void Storage::Accessor::AdvanceCommand() { ++transaction_.command_id; }
 
 utils::BasicResult<StorageDataManipulationError, void> Storage::Accessor::Commit(
@@ -929,7 +1029,9 @@ utils::BasicResult<StorageDataManipulationError, void> Storage::Accessor::Commit
         // Replica can log only the write transaction received from Main
         // so the Wal files are consistent
         if (storage_->replication_role_ == ReplicationRole::MAIN || desired_commit_timestamp.has_value()) {
-          could_replicate_all_sync_replicas = storage_->AppendToWalDataManipulation(transaction_, *commit_timestamp_);
+          could_replicate_all_sync_replicas =
+              storage_->AppendToWalDataManipulation(transaction_, *commit_timestamp_, !defer_wal_flush_);
+          wal_flushed_ = wal_flushed_ || !defer_wal_flush_;
         }
 
         // Take committed_transactions lock while holding the engine lock to
@@ -960,6 +1062,8 @@ utils::BasicResult<StorageDataManipulationError, void> Storage::Accessor::Commit
       return StorageDataManipulationError{*unique_constraint_violation};
     }
   }
+  storage_->key_locks_.Unlock(locked_keys_, commit_timestamp_);
+  locked_keys_.clear();
   is_transaction_active_ = false;
 
   if (!could_replicate_all_sync_replicas) {
@@ -1132,9 +1236,32 @@ void Storage::Accessor::Abort() {
   }
 
   storage_->commit_log_->MarkFinished(transaction_.start_timestamp);
+  storage_->key_locks_.Unlock(locked_keys_, std::nullopt);
+  locked_keys_.clear();
   is_transaction_active_ = false;
 }
 
+utils::BasicResult<StorageDataManipulationError, void> Storage::Accessor::PeriodicCommit(
+    std::unique_ptr<Accessor> *committed) {
+  const auto isolation_level = transaction_.isolation_level;
+  auto result = Commit();
+  if (committed) {
+    *committed = std::make_unique<Accessor>(std::move(*this));
+    // The lock stays with this accessor, because the new transaction must be
+    // created under it. It can't be taken again instead: the lock prefers
+    // writers, so a pending exclusive operation would block this thread while
+    // the committed accessor still holds the lock.
+    storage_guard_ = std::move((*committed)->storage_guard_);
+  } else {
+    FinalizeTransaction();
+  }
+  // Accessors keep a pointer to `transaction_`, so the new transaction must
+  // take its place.
+  transaction_ = storage_->CreateTransaction(isolation_level);
+  is_transaction_active_ = true;
+  return result;
+}
+
 void Storage::Accessor::FinalizeTransaction() {
   if (commit_timestamp_) {
     storage_->commit_log_->MarkFinished(*commit_timestamp_);
@@ -1593,6 +1720,7 @@ void Storage::CollectGarbage() {
     RemoveObsoleteEntries(&indices_, oldest_active_start_timestamp);
     constraints_.unique_constraints.RemoveObsoleteEntries(oldest_active_start_timestamp);
   }
+  key_locks_.RemoveObsoleteEntries(oldest_active_start_timestamp);
 
   {
     std::unique_lock<utils::SpinLock> guard(engine_lock_);
@@ -1666,9 +1794,9 @@ bool Storage::InitializeWalFile() {
   return true;
 }
 
-void Storage::FinalizeWalFile() {
+void Storage::FinalizeWalFile(const bool flush) {
   ++wal_unsynced_transactions_;
-  if (wal_unsynced_transactions_ >= config_.durability.wal_file_flush_every_n_tx) {
+  if (flush && wal_unsynced_transactions_ >= config_.durability.wal_file_flush_every_n_tx) {
     wal_file_->Sync();
     wal_unsynced_transactions_ = 0;
   }
@@ -1676,7 +1804,7 @@ void Storage::FinalizeWalFile() {
     wal_file_->FinalizeWal();
     wal_file_ = std::nullopt;
     wal_unsynced_transactions_ = 0;
-  } else {
+  } else if (flush) {
     // Try writing the internal buffer if possible, if not
     // the data should be written as soon as it's possible
     // (triggered by the new transaction commit, or some
@@ -1685,7 +1813,19 @@ void Storage::FinalizeWalFile() {
   }
 }
 
-bool Storage::AppendToWalDataManipulation(const Transaction &transaction, uint64_t final_commit_timestamp) {
+void Storage::FlushWal() {
+  std::lock_guard<utils::SpinLock> guard(engine_lock_);
+  if (!wal_file_) return;
+  if (wal_unsynced_transactions_ >= config_.durability.wal_file_flush_every_n_tx) {
+    wal_file_->Sync();
+    wal_unsynced_transactions_ = 0;
+  } else {
+    wal_file_->TryFlushing();
+  }
+}
+
+bool Storage::AppendToWalDataManipulation(const Transaction &transaction, uint64_t final_commit_timestamp,
+                                          const bool flush) {
   if (!InitializeWalFile()) {
     return true;
   }
@@ -1855,7 +1995,7 @@ bool Storage::AppendToWalDataManipulation(const Transaction &transaction, uint64
   // file.
   wal_file_->AppendTransactionEnd(final_commit_timestamp);
 
-  FinalizeWalFile();
+  FinalizeWalFile(flush);
 
   auto finalized_on_all_replicas = true;
   replication_clients_.WithLock([&](auto &clients) {
@@ -1953,6 +2093,41 @@ void Storage::FreeMemory() {
   indices_.label_property_index.RunGC();
 }
 
+std::shared_ptr<const GraphStatistics> Storage::GetGraphStatistics() const {
+  return graph_statistics_.WithLock([](const auto &statistics) { return statistics; });
+}
+
+void Storage::SetGraphStatistics(std::shared_ptr<const GraphStatistics> statistics) {
+  if (statistics_storage_ &&
+      !statistics_storage_->Put(kGraphStatisticsKey, GraphStatisticsToJson(*statistics, name_id_mapper_).dump())) {
+    spdlog::error("Error when saving graph statistics.");
+  }
+  graph_statistics_.WithLock([&](auto &current) { current = std::move(statistics); });
+}
+
+bool Storage::ClearGraphStatistics() {
+  graph_statistics_.WithLock([](auto &current) { current.reset(); });
+  if (statistics_storage_ && !statistics_storage_->Delete(kGraphStatisticsKey)) {
+    spdlog::error("Error when removing graph statistics.");
+    return false;
+  }
+  return true;
+}
+
+void Storage::RestoreGraphStatistics() {
+  if (!statistics_storage_) return;
+  auto data = statistics_storage_->Get(kGraphStatisticsKey);
+  if (!data) return;
+  spdlog::info("Restoring graph statistics.");
+  auto statistics = JsonToGraphStatistics(nlohmann::json::parse(*data, nullptr, false), &name_id_mapper_);
+  if (!statistics) {
+    spdlog::warn("Graph statistics couldn't be restored, run ANALYZE GRAPH to collect them again.");
+    return;
+  }
+  graph_statistics_.WithLock(
+      [&](auto &current) { current = std::make_shared<const GraphStatistics>(std::move(*statistics)); });
+}
+
 uint64_t Storage::CommitTimestamp(const std::optional<uint64_t> desired_commit_timestamp) {
   if (!desired_commit_timestamp) {
     return timestamp_++;
@@ -2101,7 +2276,8 @@ std::vector<Storage::ReplicaInfo> Storage::ReplicasInfo() {
     replica_info.reserve(clients.size());
     std::transform(
         clients.begin(), clients.end(), std::back_inserter(replica_info), [](const auto &client) -> ReplicaInfo {
-          return {client->Name(), client->Mode(), client->Endpoint(), client->State(), client->GetTimestampInfo()};
+          return {client->Name(),  client->Mode(),             client->Endpoint(),
+                  client->State(), client->GetTimestampInfo(), client->GetQueueInfo()};
         });
     return replica_info;
   });
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -13,6 +13,7 @@
 
 #include <atomic>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <variant>
@@ -28,9 +29,11 @@
 #include "storage/v2/edge_accessor.hpp"
 #include "storage/v2/indices.hpp"
 #include "storage/v2/isolation_level.hpp"
+#include "storage/v2/key_locks.hpp"
 #include "storage/v2/mvcc.hpp"
 #include "storage/v2/name_id_mapper.hpp"
 #include "storage/v2/result.hpp"
+#include "storage/v2/statistics.hpp"
 #include "storage/v2/transaction.hpp"
 #include "storage/v2/vertex.hpp"
 #include "storage/v2/vertex_accessor.hpp"
@@ -214,6 +217,23 @@ class Storage final {
     /// @throw std::bad_alloc
     VertexAccessor CreateVertex();
 
+    /// Create `count` vertices at once. The vertex IDs are reserved with a
+    /// single atomic operation and all of the vertices are inserted through
+    /// the same skip list accessor, which is cheaper than calling
+    /// `CreateVertex` `count` times.
+    /// @throw std::bad_alloc
+    std::vector<VertexAccessor> CreateVertices(uint64_t count);
+
+    /// Lock the (label, property, value) key until the end of the transaction.
+    /// MERGE locks the key it upserts, so that concurrent upserts of the same
+    /// key wait for each other instead of creating duplicate vertices. Returns
+    /// `Error::SERIALIZATION_ERROR` if the lock can't be acquired, or if the
+    /// key was changed by a transaction which isn't visible to this one. The
+    /// wait for the lock stops early once `must_abort` returns `true`.
+    /// @throw std::bad_alloc
+    Result<void> LockKey(LabelId label, PropertyId property, const PropertyValue &value,
+                         const std::function<bool()> &must_abort = {});
+
     std::optional<VertexAccessor> FindVertex(Gid gid, View view);
 
     VerticesIterable Vertices(View view) {
@@ -264,6 +284,32 @@ class Storage final {
       return storage_->indices_.label_property_index.ApproximateVertexCount(label, property, lower, upper);
     }
 
+    /// Return the exact number of vertices with the given label that are
+    /// visible from this accessor's transaction.
+    int64_t VertexCount(LabelId label, View view) {
+      return storage_->indices_.label_index.VertexCount(label, view, &transaction_);
+    }
+
+    /// Return the exact number of vertices with the given label and property
+    /// that are visible from this accessor's transaction.
+    int64_t VertexCount(LabelId label, PropertyId property, View view) {
+      return storage_->indices_.label_property_index.VertexCount(label, property, view, &transaction_);
+    }
+
+    /// Return the smallest value of the given property among the vertices
+    /// with the given label, or `Null` if there are no such vertices. The
+    /// label-property index must exist.
+    PropertyValue MinPropertyValue(LabelId label, PropertyId property, View view) {
+      return storage_->indices_.label_property_index.MinValue(label, property, view, &transaction_);
+    }
+
+    /// Return the largest value of the given property among the vertices
+    /// with the given label, or `Null` if there are no such vertices. The
+    /// label-property index must exist.
+    PropertyValue MaxPropertyValue(LabelId label, PropertyId property, View view) {
+      return storage_->indices_.label_property_index.MaxValue(label, property, view, &transaction_);
+    }
+
     /// @return Accessor to the deleted vertex if a deletion took place, std::nullopt otherwise
     /// @throw std::bad_alloc
     Result<std::optional<VertexAccessor>> DeleteVertex(VertexAccessor *vertex);
@@ -303,6 +349,16 @@ class Storage final {
       return {storage_->indices_.label_index.ListIndices(), storage_->indices_.label_property_index.ListIndices()};
     }
 
+    /// Collects the statistics of the whole graph, as seen by this accessor's
+    /// transaction, and makes them available to the query planner. The
+    /// statistics are persisted if durability is enabled.
+    /// @throw std::bad_alloc
+    std::shared_ptr<const GraphStatistics> AnalyzeGraph();
+
+    /// @return The statistics collected by the last `AnalyzeGraph`, or
+    /// nullptr if the graph wasn't analyzed.
+    std::shared_ptr<const GraphStatistics> GetGraphStatistics() const { return storage_->GetGraphStatistics(); }
+
     ConstraintsInfo ListAllConstraints() const {
       return {ListExistenceConstraints(storage_->constraints_),
               storage_->constraints_.unique_constraints.ListConstraints()};
@@ -324,6 +380,30 @@ class Storage final {
 
     void FinalizeTransaction();
 
+    /// Commit the transaction like `Commit` and start a new one in the same
+    /// accessor. Vertex and edge accessors obtained from this accessor remain
+    /// valid and see the data through the new transaction. The new transaction
+    /// is started even if the commit fails, so the accessor is always usable.
+    /// Used for running large updates in multiple transactions, so that the
+    /// deltas of the finished ones can be garbage collected. If `committed`
+    /// is given, it receives an accessor which owns the committed transaction
+    /// and finalizes it when destroyed, so the committed changes stay
+    /// readable until then (e.g. by after commit triggers). That accessor
+    /// doesn't hold the storage lock.
+    /// @throw std::bad_alloc
+    utils::BasicResult<StorageDataManipulationError, void> PeriodicCommit(
+        std::unique_ptr<Accessor> *committed = nullptr);
+
+    /// The commit only appends the transaction to the WAL buffer. The buffer
+    /// is written, and synced when due, by the next commit which isn't
+    /// deferred or by `Storage::FlushWal`.
+    void DeferWalFlush() { defer_wal_flush_ = true; }
+
+    /// Whether a commit of this accessor wrote the WAL buffer, including what
+    /// the deferred commits left in it. Read-only transactions don't touch
+    /// the WAL.
+    bool WalFlushed() const { return wal_flushed_; }
+
    private:
     /// @throw std::bad_alloc
     VertexAccessor CreateVertex(storage::Gid gid);
@@ -337,6 +417,10 @@ class Storage final {
     std::optional<uint64_t> commit_timestamp_;
     bool is_transaction_active_;
     Config::Items config_;
+    // Keys locked with `LockKey`, released when the transaction ends.
+    std::vector<KeyLocks::Key> locked_keys_;
+    bool defer_wal_flush_{false};
+    bool wal_flushed_{false};
   };
 
   Accessor Access(std::optional<IsolationLevel> override_isolation_level = {}) {
@@ -469,18 +553,37 @@ class Storage final {
     uint64_t current_number_of_timestamp_behind_master;
   };
 
+  // Transactions waiting to be sent to an ASYNC replica, and how long ago the
+  // oldest of them was committed.
+  struct QueueInfo {
+    uint64_t queued_transactions;
+    std::chrono::milliseconds lag;
+  };
+
   struct ReplicaInfo {
     std::string name;
     replication::ReplicationMode mode;
     io::network::Endpoint endpoint;
     replication::ReplicaState state;
     TimestampInfo timestamp_info;
+    QueueInfo queue_info;
   };
 
   std::vector<ReplicaInfo> ReplicasInfo();
 
   void FreeMemory();
 
+  /// Writes the WAL buffer left by the commits with `Accessor::DeferWalFlush`
+  /// and syncs the WAL file if it's due.
+  void FlushWal();
+
+  std::shared_ptr<const GraphStatistics> GetGraphStatistics() const;
+
+  /// Removes the statistics collected by `Accessor::AnalyzeGraph`, both from
+  /// memory and from the disk.
+  /// @return false if the persisted statistics couldn't be removed.
+  bool ClearGraphStatistics();
+
   void SetIsolationLevel(IsolationLevel isolation_level);
 
   enum class CreateSnapshotError : uint8_t { DisabledForReplica };
@@ -505,10 +608,11 @@ class Storage final {
   void CollectGarbage();
 
   bool InitializeWalFile();
-  void FinalizeWalFile();
+  void FinalizeWalFile(bool flush = true);
 
   /// Return true in all cases excepted if any sync replicas have not sent confirmation.
-  [[nodiscard]] bool AppendToWalDataManipulation(const Transaction &transaction, uint64_t final_commit_timestamp);
+  [[nodiscard]] bool AppendToWalDataManipulation(const Transaction &transaction, uint64_t final_commit_timestamp,
+                                                 bool flush = true);
   /// Return true in all cases excepted if any sync replicas have not sent confirmation.
   [[nodiscard]] bool AppendToWalDataDefinition(durability::StorageGlobalOperation operation, LabelId label,
                                                const std::set<PropertyId> &properties, uint64_t final_commit_timestamp);
@@ -519,6 +623,10 @@ class Storage final {
 
   bool ShouldStoreAndRestoreReplicas() const;
 
+  void SetGraphStatistics(std::shared_ptr<const GraphStatistics> statistics);
+
+  void RestoreGraphStatistics();
+
   // Main storage lock.
   //
   // Accessors take a shared lock when starting, so it is possible to block
@@ -541,6 +649,7 @@ class Storage final {
 
   Constraints constraints_;
   Indices indices_;
+  KeyLocks key_locks_;
 
   // Transaction engine
   utils::SpinLock engine_lock_;
@@ -580,6 +689,11 @@ class Storage final {
   std::filesystem::path lock_file_path_;
   utils::OutputFile lock_file_handle_;
   std::unique_ptr<kvstore::KVStore> storage_;
+  std::unique_ptr<kvstore::KVStore> statistics_storage_;
+
+  // Statistics used by the query planner. The whole object is replaced on each
+  // analysis, so readers can keep using the old one.
+  utils::Synchronized<std::shared_ptr<const GraphStatistics>, utils::SpinLock> graph_statistics_;
 
   utils::Scheduler snapshot_runner_;
   utils::SpinLock snapshot_lock_;
@@ -49,7 +49,19 @@ struct Transaction {
 
   Transaction(const Transaction &) = delete;
   Transaction &operator=(const Transaction &) = delete;
-  Transaction &operator=(Transaction &&other) = delete;
+
+  /// Used for starting a new transaction in place of a finished one, whose
+  /// deltas were already moved out.
+  Transaction &operator=(Transaction &&other) noexcept {
+    transaction_id = other.transaction_id;
+    start_timestamp = other.start_timestamp;
+    commit_timestamp = std::move(other.commit_timestamp);
+    command_id = other.command_id;
+    deltas = std::move(other.deltas);
+    must_abort = other.must_abort;
+    isolation_level = other.isolation_level;
+    return *this;
+  }
 
   ~Transaction() {}
 
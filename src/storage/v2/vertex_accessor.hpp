@@ -68,6 +68,12 @@ class VertexAccessor final {
   /// @throw std::bad_alloc
   Result<PropertyValue> SetProperty(PropertyId property, const PropertyValue &value);
 
+  /// Set the properties of a vertex which doesn't have any properties yet, as
+  /// is the case for a newly created vertex. Returns `false` and doesn't set
+  /// anything if the vertex already has properties.
+  /// @throw std::bad_alloc
+  Result<bool> InitProperties(const std::map<PropertyId, PropertyValue> &properties);
+
   /// Remove all properties and return the values of the removed properties.
   /// @throw std::bad_alloc
   Result<std::map<PropertyId, PropertyValue>> ClearProperties();
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -18,6 +18,7 @@
                                                                                                            \
   M(OnceOperator, "Number of times Once operator was used.")                                               \
   M(CreateNodeOperator, "Number of times CreateNode operator was used.")                                   \
+  M(UnwindCreateNodeOperator, "Number of times UnwindCreateNode operator was used.")                       \
   M(CreateExpandOperator, "Number of times CreateExpand operator was used.")                               \
   M(ScanAllOperator, "Number of times ScanAll operator was used.")                                         \
   M(ScanAllByLabelOperator, "Number of times ScanAllByLabel operator was used.")                           \
@@ -40,11 +41,15 @@
   M(EmptyResultOperator, "Number of times EmptyResult operator was used.")                                 \
   M(AccumulateOperator, "Number of times Accumulate operator was used.")                                   \
   M(AggregateOperator, "Number of times Aggregate operator was used.")                                     \
+  M(AggregateFromIndexOperator, "Number of times AggregateFromIndex operator was used.")                   \
   M(SkipOperator, "Number of times Skip operator was used.")                                               \
   M(LimitOperator, "Number of times Limit operator was used.")                                             \
   M(OrderByOperator, "Number of times OrderBy operator was used.")                                         \
   M(MergeOperator, "Number of times Merge operator was used.")                                             \
+  M(MergeByLabelPropertyOperator, "Number of times MergeByLabelProperty operator was used.")               \
   M(OptionalOperator, "Number of times Optional operator was used.")                                       \
+  M(SemiApplyOperator, "Number of times SemiApply operator was used.")                                     \
+  M(ApplyOperator, "Number of times Apply operator was used.")                                             \
   M(UnwindOperator, "Number of times Unwind operator was used.")                                           \
   M(DistinctOperator, "Number of times Distinct operator was used.")                                       \
   M(UnionOperator, "Number of times Union operator was used.")                                             \
@@ -58,7 +63,11 @@
   M(StreamsCreated, "Number of Streams created.")                                                          \
   M(MessagesConsumed, "Number of consumed streamed messages.")                                             \
   M(TriggersCreated, "Number of Triggers created.")                                                        \
-  M(TriggersExecuted, "Number of Triggers executed.")
+  M(TriggersExecuted, "Number of Triggers executed.")                                                      \
+                                                                                                           \
+  M(QueuedQuery, "Number of queries which waited for admission into their resource pool.")                 \
+  M(QueryAdmissionWaitMicroseconds, "Total time queries waited for admission into their resource pool.")   \
+  M(QueryAdmissionTimedOut, "Number of queries which timed out waiting for admission into their pool.")
 
 namespace EventCounter {
 
@@ -85,6 +85,14 @@ void MonotonicBufferResource::Release() {
   allocated_ = 0U;
 }
 
+size_t MonotonicBufferResource::GetUpstreamAllocatedBytes() const {
+  size_t bytes = 0;
+  for (const auto *b = current_buffer_; b; b = b->next) {
+    bytes += b->size();
+  }
+  return bytes;
+}
+
 void *MonotonicBufferResource::DoAllocate(size_t bytes, size_t alignment) {
   static_assert(std::is_same_v<size_t, uintptr_t>);
   static_assert(std::is_same_v<size_t, uint64_t>);
@@ -348,6 +348,10 @@ class MonotonicBufferResource final : public MemoryResource {
 
   MemoryResource *GetUpstreamResource() const { return memory_; }
 
+  /// Get the total size of the buffers currently allocated from the upstream
+  /// MemoryResource.
+  size_t GetUpstreamAllocatedBytes() const;
+
  private:
   struct Buffer {
     Buffer *next;
@@ -519,8 +523,9 @@ class PoolResource final : public MemoryResource {
 class SynchronizedPoolResource final : public MemoryResource {
  public:
   SynchronizedPoolResource(size_t max_blocks_per_chunk, size_t max_block_size,
-                           MemoryResource *memory = NewDeleteResource())
-      : pool_memory_(max_blocks_per_chunk, max_block_size, memory) {}
+                           MemoryResource *memory = NewDeleteResource(),
+                           MemoryResource *memory_unpooled = NewDeleteResource())
+      : pool_memory_(max_blocks_per_chunk, max_block_size, memory, memory_unpooled) {}
 
  private:
   PoolResource pool_memory_;
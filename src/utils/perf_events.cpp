@@ -0,0 +1,67 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "utils/perf_events.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace memgraph::utils {
+
+namespace {
+
+int OpenPerfEvent(uint64_t config, int group_fd) {
+  perf_event_attr attr{};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  // The group leader is enabled once all the events are in the group.
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+}  // namespace
+
+PerfEventCounters::PerfEventCounters() {
+  group_fd_ = OpenPerfEvent(PERF_COUNT_HW_CPU_CYCLES, -1);
+  if (group_fd_ == -1) return;
+  cache_misses_fd_ = OpenPerfEvent(PERF_COUNT_HW_CACHE_MISSES, group_fd_);
+  if (cache_misses_fd_ == -1) {
+    close(group_fd_);
+    group_fd_ = -1;
+    return;
+  }
+  ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfEventCounters::~PerfEventCounters() {
+  if (cache_misses_fd_ != -1) close(cache_misses_fd_);
+  if (group_fd_ != -1) close(group_fd_);
+}
+
+PerfEventValues PerfEventCounters::Read() const noexcept {
+  if (group_fd_ == -1) return {};
+  // Layout of the data read from a group with PERF_FORMAT_GROUP.
+  struct {
+    uint64_t nr;
+    uint64_t values[2];
+  } data{};
+  if (read(group_fd_, &data, sizeof(data)) != sizeof(data) || data.nr != 2) return {};
+  return {data.values[0], data.values[1]};
+}
+
+}  // namespace memgraph::utils
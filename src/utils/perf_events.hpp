@@ -0,0 +1,47 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <cstdint>
+
+namespace memgraph::utils {
+
+struct PerfEventValues {
+  uint64_t cpu_cycles{0};
+  uint64_t cache_misses{0};
+};
+
+/// Hardware counters of the calling thread, which are read through
+/// `perf_event_open`. Only the user space events are counted. The kernel may
+/// not allow opening the counters, e.g. because of `perf_event_paranoid` or
+/// when running in a container, and then the counters aren't available and
+/// `Read` always returns zeros.
+class PerfEventCounters final {
+ public:
+  PerfEventCounters();
+  PerfEventCounters(const PerfEventCounters &) = delete;
+  PerfEventCounters &operator=(const PerfEventCounters &) = delete;
+  PerfEventCounters(PerfEventCounters &&) = delete;
+  PerfEventCounters &operator=(PerfEventCounters &&) = delete;
+  ~PerfEventCounters();
+
+  bool IsAvailable() const noexcept { return group_fd_ != -1; }
+
+  /// Returns the number of events counted since the counters were opened.
+  PerfEventValues Read() const noexcept;
+
+ private:
+  int group_fd_{-1};
+  int cache_misses_fd_{-1};
+};
+
+}  // namespace memgraph::utils
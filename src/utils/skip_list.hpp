@@ -691,6 +691,24 @@ class SkipList final {
       return skiplist_->template find_equal_or_greater(key);
     }
 
+    /// Finds the last item in the list that is smaller than the key and
+    /// returns an iterator to the item.
+    ///
+    /// @return Iterator to the item in the list, will be equal to `end()` when
+    ///                  no items match the search
+    template <typename TKey>
+    Iterator find_last_smaller(const TKey &key) const {
+      return skiplist_->template find_last_smaller(key);
+    }
+
+    /// Finds the last item in the list and returns an iterator to it. The
+    /// lookup descends through the layers of the list so it doesn't have to
+    /// traverse all of the items.
+    ///
+    /// @return Iterator to the last item in the list, will be equal to `end()`
+    ///                  when the list is empty
+    Iterator last() const { return skiplist_->last(); }
+
     /// Estimates the number of items that are contained in the list that are
     /// identical to the key determined using the equality operator. The default
     /// layer is chosen to optimize duration vs. precision. The lower the layer
@@ -798,6 +816,13 @@ class SkipList final {
       return skiplist_->template find_equal_or_greater(key);
     }
 
+    template <typename TKey>
+    ConstIterator find_last_smaller(const TKey &key) const {
+      return skiplist_->template find_last_smaller(key);
+    }
+
+    ConstIterator last() const { return skiplist_->last(); }
+
     template <typename TKey>
     uint64_t estimate_count(const TKey &key, int max_layer_for_estimation = kSkipListCountEstimateDefaultLayer) const {
       return skiplist_->template estimate_count(key, max_layer_for_estimation);
@@ -1020,6 +1045,48 @@ class SkipList final {
     return Iterator{nullptr};
   }
 
+  template <typename TKey>
+  Iterator find_last_smaller(const TKey &key) const {
+    TNode *pred = find_last_smaller_node(key);
+    // Nodes that are being removed (or aren't fully inserted yet) are skipped
+    // by searching for the node that is smaller than them.
+    while (pred != head_ && (!pred->fully_linked.load(std::memory_order_acquire) ||
+                             pred->marked.load(std::memory_order_acquire))) {
+      pred = find_last_smaller_node(pred->obj);
+    }
+    if (pred == head_) return Iterator{nullptr};
+    return Iterator{pred};
+  }
+
+  Iterator last() const {
+    TNode *pred = head_;
+    for (int layer = kSkipListMaxHeight - 1; layer >= 0; --layer) {
+      TNode *curr = pred->nexts[layer].load(std::memory_order_acquire);
+      while (curr != nullptr) {
+        pred = curr;
+        curr = pred->nexts[layer].load(std::memory_order_acquire);
+      }
+    }
+    if (pred == head_) return Iterator{nullptr};
+    if (!pred->fully_linked.load(std::memory_order_acquire) || pred->marked.load(std::memory_order_acquire)) {
+      return find_last_smaller(pred->obj);
+    }
+    return Iterator{pred};
+  }
+
+  template <typename TKey>
+  TNode *find_last_smaller_node(const TKey &key) const {
+    TNode *pred = head_;
+    for (int layer = kSkipListMaxHeight - 1; layer >= 0; --layer) {
+      TNode *curr = pred->nexts[layer].load(std::memory_order_acquire);
+      while (curr != nullptr && curr->obj < key) {
+        pred = curr;
+        curr = pred->nexts[layer].load(std::memory_order_acquire);
+      }
+    }
+    return pred;
+  }
+
   template <typename TKey>
   uint64_t estimate_count(const TKey &key, int max_layer_for_estimation) const {
     MG_ASSERT(max_layer_for_estimation >= 1 && max_layer_for_estimation <= kSkipListMaxHeight,
@@ -48,12 +48,27 @@ startup_config_dict = {
     ),
     "bolt_address": ("0.0.0.0", "0.0.0.0", "IP address on which the Bolt server should listen."),
     "bolt_cert_file": ("", "", "Certificate file which should be used for the Bolt server."),
+    "bolt_compression": (
+        "false",
+        "false",
+        'Allows the clients to ask for compressed results: with the "compression": "deflate" field of the Bolt HELLO message, or with the permessage-deflate extension when connecting over WebSocket.',
+    ),
     "bolt_key_file": ("", "", "Key file which should be used for the Bolt server."),
+    "bolt_group_pipelined_commits": (
+        "true",
+        "true",
+        "Controls whether the queries a client pipelines in auto-commit mode write the WAL once after the last of them, instead of once per query. Their results are sent after that in any case.",
+    ),
     "bolt_num_workers": (
         "12",
         "12",
         "Number of workers used by the Bolt server. By default, this will be the number of processing units available on the machine.",
     ),
+    "bolt_num_execution_workers": (
+        "12",
+        "12",
+        "Number of workers executing the queries received by the Bolt server, separate from the workers handling the network I/O. If set to 0, the queries are executed by the Bolt server workers. By default, this will be the number of processing units available on the machine.",
+    ),
     "bolt_port": ("7687", "7687", "Port on which the Bolt server should listen."),
     "bolt_server_name_for_init": (
         "",
@@ -97,7 +112,17 @@ startup_config_dict = {
         "0.0.0.0",
         "IP address on which the websocket server for Memgraph monitoring should listen.",
     ),
+    "monitoring_compression": (
+        "false",
+        "false",
+        "Allows the clients of the monitoring websocket to negotiate the permessage-deflate extension.",
+    ),
     "monitoring_port": ("7444", "7444", "Port on which the websocket server for Memgraph monitoring should listen."),
+    "monitoring_query_statistics_interval_sec": (
+        "60",
+        "60",
+        "Interval in seconds at which the statistics of the most expensive queries are sent to the monitoring websocket. 0 disables sending them.",
+    ),
     "pulsar_service_url": ("", "", "Default URL used while connecting to Pulsar brokers."),
     "query_execution_timeout_sec": (
         "600",
@@ -109,6 +134,11 @@ startup_config_dict = {
         "",
         "Directory where modules with custom query procedures are stored. NOTE: Multiple comma-separated directories can be defined.",
     ),
+    "replication_async_queue_size": (
+        "1000",
+        "1000",
+        "The number of committed transactions that can wait to be sent to an ASYNC replica. A replica that falls further behind is recovered from the snapshot and WAL files.",
+    ),
     "replication_replica_check_frequency_sec": (
         "1",
         "1",
@@ -155,7 +185,51 @@ startup_config_dict = {
         "Set to true to enable telemetry. We collect information about the running system (CPU and memory information) and information about the database runtime (vertex and edge counts and resource usage) to allow for easier improvement of the product.",
     ),
     "query_cost_planner": ("true", "true", "Use the cost-estimating query planner."),
-    "query_plan_cache_ttl": ("60", "60", "Time to live for cached query plans, in seconds."),
+    "query_plan_cache_ttl": (
+        "60",
+        "60",
+        "Time to live for cached query plans, in seconds. The time is counted from the last use of the plan.",
+    ),
+    "query_plan_cache_max_entries": (
+        "1000",
+        "1000",
+        "Maximum number of cached query plans, the least recently used plans are evicted. 0 means unlimited.",
+    ),
+    "query_ast_cache_max_entries": (
+        "10000",
+        "10000",
+        "Maximum number of cached parsed queries, the least recently used queries are evicted. 0 means unlimited.",
+    ),
+    "query_plan_cache_replan_ratio": (
+        "10",
+        "10",
+        "A cached plan is made again when a vertex count it was costed with grows or shrinks by more than this ratio. 0 disables re-planning.",
+    ),
+    "query_statistics_max_entries": (
+        "1000",
+        "1000",
+        "Maximum number of distinct queries whose execution statistics are kept, the queries with the lowest total latency are evicted. 0 disables collecting the statistics.",
+    ),
+    "query_profile_hardware_counters": (
+        "false",
+        "false",
+        "Report the CPU cycles and cache misses of each operator in PROFILE, if the kernel allows reading the hardware counters.",
+    ),
+    "resource_pools": (
+        "",
+        "",
+        "Comma separated resource pools in the form name:max_concurrent_queries[:memory_limit_mib]. The queries of a pool wait for admission while the pool already runs its maximum number of queries, and each of them is limited to an equal share of the pool's memory limit. Queries of users without a pool run in the pool named default, or without limits if there is none.",
+    ),
+    "resource_pool_assignments": (
+        "",
+        "",
+        "Comma separated assignments of users and roles to the resource pools in the form username=pool[:priority] or role:rolename=pool[:priority]. Waiting queries with higher priority are admitted first, the default priority is 0. A user's own assignment takes precedence over the assignment of their role.",
+    ),
+    "query_admission_timeout_sec": (
+        "600",
+        "600",
+        "Maximum time in seconds a query waits for admission into its resource pool. The wait also counts towards the execution timeout.",
+    ),
     "query_vertex_count_to_expand_existing": (
         "10",
         "10",
@@ -40,14 +40,16 @@ def test_show_replicas(connection):
         "current_timestamp_of_replica",
         "number_of_timestamp_behind_master",
         "state",
+        "queued_transactions",
+        "queue_lag_ms",
     }
     actual_column_names = {x.name for x in cursor.description}
     assert actual_column_names == expected_column_names
 
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready", 0, 0),
     }
     assert actual_data == expected_data
 
@@ -71,14 +73,16 @@ def test_show_replicas_while_inserting_data(connection):
         "current_timestamp_of_replica",
         "number_of_timestamp_behind_master",
         "state",
+        "queued_transactions",
+        "queue_lag_ms",
     }
     actual_column_names = {x.name for x in cursor.description}
     assert actual_column_names == expected_column_names
 
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready", 0, 0),
     }
     assert actual_data == expected_data
 
@@ -87,9 +91,9 @@ def test_show_replicas_while_inserting_data(connection):
 
     # 2/
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 4, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 4, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 4, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 4, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 4, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 4, 0, "ready", 0, 0),
     }
 
     def retrieve_data():
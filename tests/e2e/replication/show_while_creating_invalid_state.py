@@ -83,16 +83,18 @@ def test_show_replicas(connection):
         "current_timestamp_of_replica",
         "number_of_timestamp_behind_master",
         "state",
+        "queued_transactions",
+        "queue_lag_ms",
     }
 
     actual_column_names = {x.name for x in cursor.description}
     assert actual_column_names == EXPECTED_COLUMN_NAMES
 
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "ready", 0, 0),
     }
     assert actual_data == expected_data
 
@@ -100,9 +102,9 @@ def test_show_replicas(connection):
     execute_and_fetch_all(cursor, "DROP REPLICA replica_2")
     actual_data = set(execute_and_fetch_all(cursor, "SHOW REPLICAS;"))
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "ready", 0, 0),
     }
     assert actual_data == expected_data
 
@@ -116,9 +118,9 @@ def test_show_replicas(connection):
         return set(execute_and_fetch_all(cursor, "SHOW REPLICAS;"))
 
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "invalid"),
-        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "invalid"),
-        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "invalid"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "invalid", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "invalid", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "invalid", 0, 0),
     }
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
     assert actual_data == expected_data
@@ -186,10 +188,10 @@ def test_basic_recovery(connection):
 
     # 1/
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 0, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 0, 0, "ready", 0, 0),
     }
     actual_data = set(execute_and_fetch_all(cursor, "SHOW REPLICAS;"))
 
@@ -238,9 +240,9 @@ def test_basic_recovery(connection):
         assert res_from_main == interactive_mg_runner.MEMGRAPH_INSTANCES[f"replica_{index}"].query(QUERY_TO_CHECK)
 
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 2, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 2, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 2, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 2, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 2, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 2, 0, "ready", 0, 0),
     }
     actual_data = set(execute_and_fetch_all(cursor, "SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -261,10 +263,10 @@ def test_basic_recovery(connection):
     interactive_mg_runner.start(CONFIGURATION, "replica_3")
 
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 6, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 6, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 6, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 6, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 6, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 6, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 6, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 6, 0, "ready", 0, 0),
     }
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -276,10 +278,10 @@ def test_basic_recovery(connection):
     # 11/
     interactive_mg_runner.kill(CONFIGURATION, "replica_1")
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "invalid"),
-        ("replica_2", "127.0.0.1:10002", "sync", 6, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 6, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 6, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "invalid", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 6, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 6, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 6, 0, "ready", 0, 0),
     }
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -291,10 +293,10 @@ def test_basic_recovery(connection):
             "CREATE (p1:Number {name:'Magic_again_again', value:44})"
         )
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "invalid"),
-        ("replica_2", "127.0.0.1:10002", "sync", 9, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 9, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 9, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "invalid", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 9, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 9, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 9, 0, "ready", 0, 0),
     }
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -305,10 +307,10 @@ def test_basic_recovery(connection):
 
     # 14/
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 9, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 9, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 9, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 9, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 9, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 9, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 9, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 9, 0, "ready", 0, 0),
     }
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
     print("actual=", actual_data)
@@ -326,10 +328,10 @@ def test_basic_recovery(connection):
 
     # 16/
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 12, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 12, 0, "ready"),
-        ("replica_3", "127.0.0.1:10003", "async", 12, 0, "ready"),
-        ("replica_4", "127.0.0.1:10004", "async", 12, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 12, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 12, 0, "ready", 0, 0),
+        ("replica_3", "127.0.0.1:10003", "async", 12, 0, "ready", 0, 0),
+        ("replica_4", "127.0.0.1:10004", "async", 12, 0, "ready", 0, 0),
     }
     actual_data = set(execute_and_fetch_all(cursor, "SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -405,8 +407,8 @@ def test_basic_recovery_when_replica_is_kill_when_main_is_down():
 
     # 1/
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
     }
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
 
@@ -431,8 +433,8 @@ def test_basic_recovery_when_replica_is_kill_when_main_is_down():
 
     # 4/
     expected_data = {
-        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "invalid"),
+        ("replica_1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("replica_2", "127.0.0.1:10002", "sync", 0, 0, "invalid", 0, 0),
     }
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -597,8 +599,8 @@ def test_attempt_to_write_data_on_main_when_async_replica_is_down():
 
     # 1/
     expected_data = {
-        ("async_replica1", "127.0.0.1:10001", "async", 0, 0, "ready"),
-        ("async_replica2", "127.0.0.1:10002", "async", 0, 0, "ready"),
+        ("async_replica1", "127.0.0.1:10001", "async", 0, 0, "ready", 0, 0),
+        ("async_replica2", "127.0.0.1:10002", "async", 0, 0, "ready", 0, 0),
     }
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -628,7 +630,7 @@ def test_attempt_to_write_data_on_main_when_async_replica_is_down():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -676,8 +678,8 @@ def test_attempt_to_write_data_on_main_when_sync_replica_is_down():
 
     # 1/
     expected_data = {
-        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("sync_replica2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
+        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("sync_replica2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
     }
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -702,7 +704,7 @@ def test_attempt_to_write_data_on_main_when_sync_replica_is_down():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -718,8 +720,8 @@ def test_attempt_to_write_data_on_main_when_sync_replica_is_down():
 
     # 5/
     expected_data = {
-        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "invalid"),
-        ("sync_replica2", "127.0.0.1:10002", "sync", 5, 0, "ready"),
+        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "invalid", 0, 0),
+        ("sync_replica2", "127.0.0.1:10002", "sync", 5, 0, "ready", 0, 0),
     }
     res_from_main = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query(QUERY_TO_CHECK)
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
@@ -775,8 +777,8 @@ def test_attempt_to_create_indexes_on_main_when_async_replica_is_down():
 
     # 1/
     expected_data = {
-        ("async_replica1", "127.0.0.1:10001", "async", 0, 0, "ready"),
-        ("async_replica2", "127.0.0.1:10002", "async", 0, 0, "ready"),
+        ("async_replica1", "127.0.0.1:10001", "async", 0, 0, "ready", 0, 0),
+        ("async_replica2", "127.0.0.1:10002", "async", 0, 0, "ready", 0, 0),
     }
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -806,7 +808,7 @@ def test_attempt_to_create_indexes_on_main_when_async_replica_is_down():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -854,8 +856,8 @@ def test_attempt_to_create_indexes_on_main_when_sync_replica_is_down():
 
     # 1/
     expected_data = {
-        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "ready"),
-        ("sync_replica2", "127.0.0.1:10002", "sync", 0, 0, "ready"),
+        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "ready", 0, 0),
+        ("sync_replica2", "127.0.0.1:10002", "sync", 0, 0, "ready", 0, 0),
     }
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
     assert actual_data == expected_data
@@ -880,7 +882,7 @@ def test_attempt_to_create_indexes_on_main_when_sync_replica_is_down():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -896,8 +898,8 @@ def test_attempt_to_create_indexes_on_main_when_sync_replica_is_down():
 
     # 5/
     expected_data = {
-        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "invalid"),
-        ("sync_replica2", "127.0.0.1:10002", "sync", 2, 0, "ready"),
+        ("sync_replica1", "127.0.0.1:10001", "sync", 0, 0, "invalid", 0, 0),
+        ("sync_replica2", "127.0.0.1:10002", "sync", 2, 0, "ready", 0, 0),
     }
     res_from_main = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query(QUERY_TO_CHECK)
     actual_data = set(interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;"))
@@ -987,7 +989,7 @@ def test_trigger_on_create_before_commit_with_offline_sync_replica():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -1091,7 +1093,7 @@ def test_trigger_on_update_before_commit_with_offline_sync_replica():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -1199,7 +1201,7 @@ def test_trigger_on_delete_before_commit_with_offline_sync_replica():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -1306,7 +1308,7 @@ def test_trigger_on_create_before_and_after_commit_with_offline_sync_replica():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -1411,7 +1413,7 @@ def test_triggers_on_create_before_commit_with_offline_sync_replica():
         replicas = interactive_mg_runner.MEMGRAPH_INSTANCES["main"].query("SHOW REPLICAS;")
         return [
             (replica_name, mode, timestamp_behind_main, status)
-            for replica_name, ip, mode, timestamp, timestamp_behind_main, status in replicas
+            for replica_name, ip, mode, timestamp, timestamp_behind_main, status, queued, lag in replicas
         ]
 
     actual_data = mg_sleep_and_assert(expected_data, retrieve_data)
@@ -201,6 +201,8 @@ class InteractiveDbAccessor {
 
   bool LabelIndexExists(memgraph::storage::LabelId label) { return true; }
 
+  std::shared_ptr<const memgraph::storage::GraphStatistics> GetGraphStatistics() { return nullptr; }
+
   bool LabelPropertyIndexExists(memgraph::storage::LabelId label_id, memgraph::storage::PropertyId property_id) {
     auto label = dba_->LabelToName(label_id);
     auto property = dba_->PropertyToName(property_id);
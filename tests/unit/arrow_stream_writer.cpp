@@ -0,0 +1,185 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "glue/arrow_stream_writer.hpp"
+#include "query/exceptions.hpp"
+#include "query/typed_value.hpp"
+#include "utils/temporal.hpp"
+
+#include "arrow_testdata.hpp"
+
+using memgraph::glue::ArrowStreamWriter;
+using memgraph::query::TypedValue;
+
+namespace {
+
+struct Message {
+  std::vector<uint8_t> metadata;
+  int64_t body_length;
+};
+
+template <typename T>
+T Read(const std::vector<uint8_t> &data, size_t position) {
+  T value;
+  std::memcpy(&value, data.data() + position, sizeof(value));
+  return value;
+}
+
+// Reads the bodyLength field of the root Message table from the FlatBuffers
+// encoded metadata.
+int64_t ReadBodyLength(const std::vector<uint8_t> &metadata) {
+  constexpr uint16_t kBodyLengthField = 3;
+  const auto table = Read<uint32_t>(metadata, 0);
+  const auto vtable = table - Read<int32_t>(metadata, table);
+  const auto vtable_size = Read<uint16_t>(metadata, vtable);
+  const auto field_entry = vtable + sizeof(uint16_t) * (2 + kBodyLengthField);
+  if (field_entry >= vtable + vtable_size) return 0;
+  const auto field_offset = Read<uint16_t>(metadata, field_entry);
+  return field_offset == 0 ? 0 : Read<int64_t>(metadata, table + field_offset);
+}
+
+// Splits the stream into its encapsulated messages and checks that it ends
+// with the end-of-stream marker.
+std::vector<Message> ReadMessages(const std::vector<uint8_t> &stream) {
+  std::vector<Message> messages;
+  size_t position = 0;
+  while (true) {
+    if (position + 8 > stream.size()) {
+      ADD_FAILURE() << "The stream doesn't end with the end-of-stream marker.";
+      break;
+    }
+    EXPECT_EQ(Read<uint32_t>(stream, position), 0xFFFFFFFF);
+    const auto metadata_size = Read<int32_t>(stream, position + 4);
+    position += 8;
+    if (metadata_size == 0) break;
+    EXPECT_EQ(metadata_size % 8, 0);
+    Message message;
+    message.metadata.assign(stream.begin() + position, stream.begin() + position + metadata_size);
+    position += metadata_size;
+    message.body_length = ReadBodyLength(message.metadata);
+    position += message.body_length;
+    messages.push_back(std::move(message));
+  }
+  EXPECT_EQ(position, stream.size());
+  return messages;
+}
+
+}  // namespace
+
+TEST(ArrowStreamWriter, Batches) {
+  ArrowStreamWriter writer({"n", "name"});
+  writer.AddRow({TypedValue(1), TypedValue("one")});
+  writer.AddRow({TypedValue(), TypedValue("two")});
+  EXPECT_EQ(writer.BatchRows(), 2);
+
+  std::vector<uint8_t> stream;
+  writer.WriteBatch(&stream);
+  EXPECT_EQ(writer.BatchRows(), 0);
+  writer.AddRow({TypedValue(3), TypedValue()});
+  writer.WriteEnd(&stream);
+
+  const auto messages = ReadMessages(stream);
+  ASSERT_EQ(messages.size(), 3);
+  // The schema has no body.
+  EXPECT_EQ(messages[0].body_length, 0);
+  // Validity bitmaps and data of both columns and the offsets of the strings,
+  // each padded to 8 bytes. Columns without nulls have no validity bitmap.
+  EXPECT_EQ(messages[1].body_length, 8 + 16 + 0 + 16 + 8);
+  EXPECT_EQ(messages[2].body_length, 0 + 8 + 8 + 8 + 0);
+}
+
+TEST(ArrowStreamWriter, EmptyResult) {
+  ArrowStreamWriter writer({"n"});
+  std::vector<uint8_t> stream;
+  writer.WriteEnd(&stream);
+  const auto messages = ReadMessages(stream);
+  // Only the schema.
+  ASSERT_EQ(messages.size(), 1);
+  EXPECT_EQ(messages[0].body_length, 0);
+}
+
+TEST(ArrowStreamWriter, EmptyBatchesSkipped) {
+  ArrowStreamWriter writer({"n"});
+  std::vector<uint8_t> stream;
+  writer.AddRow({TypedValue(1)});
+  writer.WriteBatch(&stream);
+  const auto size = stream.size();
+  writer.WriteBatch(&stream);
+  EXPECT_EQ(stream.size(), size);
+  writer.WriteEnd(&stream);
+  const auto messages = ReadMessages(stream);
+  ASSERT_EQ(messages.size(), 2);
+  EXPECT_EQ(messages[1].body_length, 8);
+}
+
+TEST(ArrowStreamWriter, ColumnTypes) {
+  std::vector<uint8_t> stream;
+  {
+    // Integers and floats in the first batch make a float column.
+    ArrowStreamWriter writer({"x"});
+    writer.AddRow({TypedValue(1)});
+    writer.AddRow({TypedValue(1.5)});
+    writer.WriteBatch(&stream);
+    writer.AddRow({TypedValue(2)});
+    EXPECT_NO_THROW(writer.WriteBatch(&stream));
+    writer.AddRow({TypedValue("x")});
+    EXPECT_THROW(writer.WriteBatch(&stream), memgraph::query::QueryRuntimeException);
+  }
+  {
+    // The type is derived from the first batch only.
+    ArrowStreamWriter writer({"x"});
+    writer.AddRow({TypedValue()});
+    writer.WriteBatch(&stream);
+    writer.AddRow({TypedValue(1)});
+    EXPECT_THROW(writer.WriteBatch(&stream), memgraph::query::QueryRuntimeException);
+  }
+  {
+    ArrowStreamWriter writer({"x"});
+    writer.AddRow({TypedValue(std::vector<TypedValue>{TypedValue(1)})});
+    EXPECT_THROW(writer.WriteBatch(&stream), memgraph::query::QueryRuntimeException);
+  }
+}
+
+TEST(ArrowStreamWriter, MatchesPyarrow) {
+  ArrowStreamWriter writer({"n", "name"});
+  writer.AddRow({TypedValue(1), TypedValue("one")});
+  writer.AddRow({TypedValue(), TypedValue("two")});
+  std::vector<uint8_t> stream;
+  writer.WriteEnd(&stream);
+  EXPECT_EQ(stream, std::vector<uint8_t>(std::begin(arrow_small_stream), std::end(arrow_small_stream)));
+}
+
+TEST(ArrowStreamWriter, ColumnTypesMatchPyarrow) {
+  const memgraph::utils::Date date({2023, 1, 2});
+  const memgraph::utils::LocalTime time({13, 14, 15, 16, 17});
+  const memgraph::utils::LocalDateTime stamp(date, time);
+
+  ArrowStreamWriter writer({"b", "i", "f", "s", "d", "t", "dt", "dur", "z"});
+  writer.AddRow({TypedValue(true), TypedValue(1), TypedValue(1.5), TypedValue("a"), TypedValue(date), TypedValue(time),
+                 TypedValue(stamp), TypedValue(memgraph::utils::Duration(-5)), TypedValue()});
+  writer.AddRow({TypedValue(), TypedValue(-2), TypedValue(2), TypedValue(), TypedValue(), TypedValue(), TypedValue(),
+                 TypedValue(), TypedValue()});
+  writer.AddRow({TypedValue(false), TypedValue(), TypedValue(), TypedValue("ccc"), TypedValue(date), TypedValue(time),
+                 TypedValue(stamp), TypedValue(memgraph::utils::Duration(7)), TypedValue()});
+  std::vector<uint8_t> stream;
+  writer.WriteBatch(&stream);
+  writer.AddRow({TypedValue(true), TypedValue(3), TypedValue(), TypedValue(""), TypedValue(), TypedValue(), TypedValue(),
+                 TypedValue(), TypedValue()});
+  writer.WriteEnd(&stream);
+  EXPECT_EQ(stream, std::vector<uint8_t>(std::begin(arrow_column_types_stream), std::end(arrow_column_types_stream)));
+}
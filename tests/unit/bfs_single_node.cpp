@@ -111,3 +111,60 @@ INSTANTIATE_TEST_CASE_P(FilterLambda, SingleNodeBfsTest,
                                          testing::Values(FilterLambdaType::NONE, FilterLambdaType::USE_FRAME,
                                                          FilterLambdaType::USE_FRAME_NULL, FilterLambdaType::USE_CTX,
                                                          FilterLambdaType::ERROR)));
+
+// The levels of this graph are large enough to be expanded in parallel and
+// bottom-up, so all the expansion strategies get used during a single BFS.
+TEST(SingleNodeBfsLargeFrontierTest, ExpandsAllLevels) {
+  constexpr int kChainsCount = 2048;
+  constexpr int kChainLength = 16;
+
+  memgraph::storage::Storage db;
+  auto storage_dba = db.Access();
+  DbAccessor dba(&storage_dba);
+  const auto edge_type = dba.NameToEdgeType("edge");
+  auto source = dba.InsertVertex();
+  for (int chain = 0; chain < kChainsCount; ++chain) {
+    auto previous = source;
+    for (int i = 0; i < kChainLength; ++i) {
+      auto vertex = dba.InsertVertex();
+      ASSERT_TRUE(dba.InsertEdge(&previous, &vertex, edge_type).HasValue());
+      previous = vertex;
+    }
+  }
+  dba.AdvanceCommand();
+
+  ExecutionContext context{&dba};
+  auto source_sym = context.symbol_table.CreateSymbol("source", true);
+  auto sink_sym = context.symbol_table.CreateSymbol("sink", true);
+  auto edges_sym = context.symbol_table.CreateSymbol("edges", true);
+  auto inner_node_sym = context.symbol_table.CreateSymbol("inner_node", true);
+  auto inner_edge_sym = context.symbol_table.CreateSymbol("inner_edge", true);
+  auto input_op = std::make_shared<Yield>(nullptr, std::vector<Symbol>{source_sym},
+                                          std::vector<std::vector<TypedValue>>{{TypedValue(source)}});
+  auto bfs = std::make_shared<ExpandVariable>(input_op, source_sym, sink_sym, edges_sym, EdgeAtom::Type::BREADTH_FIRST,
+                                              EdgeAtom::Direction::BOTH, std::vector<memgraph::storage::EdgeTypeId>{},
+                                              false, nullptr, nullptr, false,
+                                              ExpansionLambda{inner_edge_sym, inner_node_sym, nullptr}, std::nullopt,
+                                              std::nullopt);
+
+  auto results = PullResults(bfs.get(), &context, std::vector<Symbol>{sink_sym, edges_sym});
+  ASSERT_EQ(results.size(), kChainsCount * kChainLength);
+
+  std::vector<int> depth_counts(kChainLength + 1, 0);
+  for (const auto &row : results) {
+    const auto &edges = row[1].ValueList();
+    ASSERT_LE(edges.size(), kChainLength);
+    ++depth_counts[edges.size()];
+    // The path has to lead from the source to the sink.
+    auto current = source;
+    for (const auto &edge : edges) {
+      ASSERT_TRUE(edge.ValueEdge().From() == current);
+      current = edge.ValueEdge().To();
+    }
+    EXPECT_TRUE(current == row[0].ValueVertex());
+  }
+  EXPECT_EQ(depth_counts[0], 0);
+  for (int depth = 1; depth <= kChainLength; ++depth) {
+    EXPECT_EQ(depth_counts[depth], kChainsCount);
+  }
+}
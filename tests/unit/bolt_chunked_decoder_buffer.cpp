@@ -138,3 +138,28 @@ TEST_F(BoltBuffer, GraduallyPopulatedChunkTrailingData) {
   ASSERT_EQ(buffer.read_end()->size(), 1000);
   for (int i = 0; i < 1000; ++i) EXPECT_EQ(data[i], leftover[i]);
 }
+
+TEST_F(BoltBuffer, RewoundMessage) {
+  uint8_t tmp[2000];
+  BufferT buffer;
+  DecoderBufferT decoder_buffer(*buffer.read_end());
+  StreamBufferT sb = buffer.write_end()->Allocate();
+
+  sb.data[0] = 0x03;
+  sb.data[1] = 0xe8;
+  memcpy(sb.data + 2, data, 1000);
+  sb.data[1002] = 0;
+  sb.data[1003] = 0;
+  buffer.write_end()->Written(1004);
+
+  ASSERT_EQ(decoder_buffer.GetChunk(), ChunkStateT::Whole);
+  ASSERT_EQ(decoder_buffer.GetChunk(), ChunkStateT::Done);
+
+  // The message is read again from its start after it's rewound.
+  for (int read = 0; read < 2; ++read) {
+    ASSERT_EQ(decoder_buffer.Read(tmp, 1000), true);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(data[i], tmp[i]);
+    ASSERT_EQ(decoder_buffer.Size(), 0);
+    decoder_buffer.Rewind();
+  }
+}
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -16,6 +16,7 @@
 #include "bolt_testdata.hpp"
 #include "communication/bolt/v1/codes.hpp"
 #include "communication/bolt/v1/encoder/encoder.hpp"
+#include "glue/bolt_encoder.hpp"
 #include "glue/communication.hpp"
 #include "storage/v2/storage.hpp"
 #include "utils/temporal.hpp"
@@ -126,6 +127,19 @@ TEST_F(BoltEncoder, String) {
   CheckOutput(output, nullptr, 0);
 }
 
+TEST_F(BoltEncoder, Bytes) {
+  output.clear();
+  memgraph::communication::bolt::BaseEncoder<TestBuffer> base_encoder(encoder_buffer);
+  const std::vector<std::pair<size_t, std::vector<uint8_t>>> headers{
+      {0, {0xCC, 0x00}}, {255, {0xCC, 0xFF}}, {256, {0xCD, 0x01, 0x00}}, {65536, {0xCE, 0x00, 0x01, 0x00, 0x00}}};
+  for (const auto &[size, header] : headers) {
+    base_encoder.WriteBytes(data, size);
+    CheckOutput(output, header.data(), header.size(), false);
+    CheckOutput(output, data, size, false);
+  }
+  CheckOutput(output, nullptr, 0);
+}
+
 TEST_F(BoltEncoder, List) {
   output.clear();
   std::vector<Value> vals;
@@ -225,6 +239,63 @@ TEST_F(BoltEncoder, VertexAndEdge) {
   CheckOutput(output, vertexedge_encoded + 48, 26);
 }
 
+TEST_F(BoltEncoder, TypedValueMatchesValue) {
+  memgraph::storage::Storage db;
+  auto dba = db.Access();
+  auto va1 = dba.CreateVertex();
+  auto va2 = dba.CreateVertex();
+  ASSERT_TRUE(va1.AddLabel(dba.NameToLabel("label1")).HasValue());
+  ASSERT_TRUE(va1.AddLabel(dba.NameToLabel("label2")).HasValue());
+  ASSERT_TRUE(va1.SetProperty(dba.NameToProperty("prop1"), memgraph::storage::PropertyValue(12)).HasValue());
+  ASSERT_TRUE(va1.SetProperty(dba.NameToProperty("prop2"),
+                              memgraph::storage::PropertyValue(std::vector<memgraph::storage::PropertyValue>{
+                                  memgraph::storage::PropertyValue("a"), memgraph::storage::PropertyValue(2.5)}))
+                  .HasValue());
+  auto ea = dba.CreateEdge(&va1, &va2, dba.NameToEdgeType("edgetype"));
+  ASSERT_TRUE(ea.HasValue());
+  ASSERT_TRUE(ea->SetProperty(dba.NameToProperty("prop3"), memgraph::storage::PropertyValue(42)).HasValue());
+
+  std::vector<memgraph::query::TypedValue> values;
+  values.emplace_back(memgraph::query::VertexAccessor(va1));
+  values.emplace_back(memgraph::query::VertexAccessor(va2));
+  values.emplace_back(memgraph::query::EdgeAccessor(*ea));
+  values.emplace_back(std::vector<memgraph::query::TypedValue>{memgraph::query::TypedValue(),
+                                                               memgraph::query::TypedValue("string")});
+  values.emplace_back(std::map<std::string, memgraph::query::TypedValue>{
+      {"key", memgraph::query::TypedValue(memgraph::query::VertexAccessor(va1))}});
+
+  output.clear();
+  std::vector<Value> decoded_values;
+  for (const auto &value : values) {
+    decoded_values.push_back(*memgraph::glue::ToBoltValue(value, db, memgraph::storage::View::NEW));
+  }
+  bolt_encoder.MessageRecord(decoded_values);
+  const auto expected = output;
+
+  memgraph::glue::BoltRecordBuffer record;
+  memgraph::glue::BoltNameCache names;
+  // Encode twice to check the cached names are reused correctly.
+  for (int i = 0; i < 2; ++i) {
+    output.clear();
+    record.Clear();
+    memgraph::glue::TypedValueBoltEncoder value_encoder(record, db, memgraph::storage::View::NEW, names);
+    value_encoder.WriteTypeSize(values.size(), memgraph::communication::bolt::MarkerList);
+    for (const auto &value : values) {
+      ASSERT_FALSE(value_encoder.WriteTypedValue(value).HasError());
+    }
+    bolt_encoder.MessageRecord(record.data(), record.size());
+    EXPECT_EQ(output, expected);
+  }
+
+  ASSERT_TRUE(dba.DetachDeleteVertex(&va2).HasValue());
+  record.Clear();
+  memgraph::glue::TypedValueBoltEncoder value_encoder(record, db, memgraph::storage::View::NEW, names);
+  const auto result = value_encoder.WriteTypedValue(memgraph::query::TypedValue(memgraph::query::VertexAccessor(va2)));
+  ASSERT_TRUE(result.HasError());
+  EXPECT_EQ(result.GetError(), memgraph::storage::Error::DELETED_OBJECT);
+  EXPECT_EQ(record.size(), 0);
+}
+
 TEST_F(BoltEncoder, BoltV1ExampleMessages) {
   // this test checks example messages from: http://boltprotocol.org/v1/
 
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -12,6 +12,7 @@
 #include <string>
 
 #include <gflags/gflags.h>
+#include <zlib.h>
 
 #include "bolt_common.hpp"
 #include "communication/bolt/v1/session.hpp"
@@ -21,6 +22,7 @@
 using memgraph::communication::bolt::ClientError;
 using memgraph::communication::bolt::Session;
 using memgraph::communication::bolt::SessionException;
+using memgraph::communication::bolt::SessionSuspendedException;
 using memgraph::communication::bolt::State;
 using memgraph::communication::bolt::Value;
 
@@ -36,10 +38,15 @@ class TestSession : public Session<TestInputStream, TestOutputStream> {
   using Session<TestInputStream, TestOutputStream>::TEncoder;
 
   TestSession(TestSessionData *data, TestInputStream *input_stream, TestOutputStream *output_stream)
-      : Session<TestInputStream, TestOutputStream>(input_stream, output_stream) {}
-
-  std::pair<std::vector<std::string>, std::optional<int>> Interpret(
-      const std::string &query, const std::map<std::string, Value> &params) override {
+      : Session<TestInputStream, TestOutputStream>(input_stream, output_stream), output_(&output_stream->output) {}
+
+  std::pair<std::vector<std::string>, std::map<std::string, Value>> Interpret(
+      const std::string &query, const std::map<std::string, Value> &params,
+      const std::map<std::string, Value> &extra) override {
+    if (suspensions > 0) {
+      --suspensions;
+      throw SessionSuspendedException();
+    }
     if (query == kQueryReturn42 || query == kQueryEmpty || query == kQueryReturnMultiple) {
       query_ = query;
       return {{"result_name"}, {}};
@@ -88,8 +95,21 @@ class TestSession : public Session<TestInputStream, TestOutputStream> {
 
   std::optional<std::string> GetServerNameForInit() override { return std::nullopt; }
 
+  bool IsCompressionAllowed() override { return compression_allowed; }
+
+  void SetPipelining(bool pipelining) override { pipelining_calls.push_back(pipelining); }
+
+  void FlushDeferredCommits() override { output_sizes_at_flush.push_back(output_->size()); }
+
+  std::vector<bool> pipelining_calls;
+  std::vector<size_t> output_sizes_at_flush;
+  bool compression_allowed{false};
+  // The number of times Interpret suspends the session before it runs a query.
+  int suspensions{0};
+
  private:
   std::string query_;
+  const std::vector<uint8_t> *output_;
 };
 
 // TODO: This could be done in fixture.
@@ -844,6 +864,157 @@ TEST(BoltSession, MultipleChunksInOneExecute) {
   ASSERT_EQ(num, 3);
 }
 
+TEST(BoltSession, PipelinedMessages) {
+  INIT_VARS;
+
+  ExecuteHandshake(input_stream, session, output);
+  ExecuteInit(input_stream, session, output);
+  session.pipelining_calls.clear();
+  EXPECT_TRUE(session.output_sizes_at_flush.empty());
+
+  // The RUN is followed by the already received PULL_ALL, so its response is
+  // held back until the commits are flushed.
+  WriteRunRequest(input_stream, kQueryReturn42);
+  ExecuteCommand(input_stream, session, pullall_req, sizeof(pullall_req));
+  ASSERT_EQ(session.state_, State::Idle);
+  EXPECT_EQ(session.pipelining_calls, (std::vector<bool>{true, false, false}));
+  EXPECT_EQ(session.output_sizes_at_flush, std::vector<size_t>{0});
+
+  int len{0}, num{0};
+  while (output.size() > 0) {
+    len = (output[0] << 8) + output[1];
+    output.erase(output.begin(), output.begin() + len + 4);
+    ++num;
+  }
+  ASSERT_EQ(num, 3);
+
+  // A message which isn't pipelined is answered right away.
+  session.output_sizes_at_flush.clear();
+  WriteRunRequest(input_stream, kQueryReturn42);
+  session.Execute();
+  ExecuteCommand(input_stream, session, pullall_req, sizeof(pullall_req));
+  EXPECT_TRUE(session.output_sizes_at_flush.empty());
+}
+
+TEST(BoltSession, SuspendedRun) {
+  INIT_VARS;
+
+  ExecuteHandshake(input_stream, session, output);
+  ExecuteInit(input_stream, session, output);
+
+  // The suspended RUN isn't answered and is run again once resumed, without
+  // any more input.
+  session.suspensions = 2;
+  WriteRunRequest(input_stream, kQueryReturn42);
+  session.Execute();
+  ASSERT_TRUE(session.IsSuspended());
+  ASSERT_EQ(session.state_, State::Idle);
+  EXPECT_TRUE(output.empty());
+  session.Execute();
+  ASSERT_TRUE(session.IsSuspended());
+  EXPECT_TRUE(output.empty());
+
+  bool resumed = false;
+  session.AwaitResume([&] { resumed = true; });
+  ASSERT_TRUE(resumed);
+  session.Execute();
+  ASSERT_FALSE(session.IsSuspended());
+  ASSERT_EQ(session.state_, State::Result);
+  CheckSuccessMessage(output);
+  ExecuteCommand(input_stream, session, pullall_req, sizeof(pullall_req));
+  ASSERT_EQ(session.state_, State::Idle);
+  output.clear();
+
+  // The messages pipelined after a suspended RUN wait for it.
+  session.suspensions = 1;
+  WriteRunRequest(input_stream, kQueryReturn42);
+  WriteChunkHeader(input_stream, sizeof(pullall_req));
+  input_stream.Write(pullall_req, sizeof(pullall_req));
+  WriteChunkTail(input_stream);
+  session.Execute();
+  ASSERT_TRUE(session.IsSuspended());
+  EXPECT_TRUE(output.empty());
+  session.Execute();
+  ASSERT_FALSE(session.IsSuspended());
+  ASSERT_EQ(session.state_, State::Idle);
+
+  int len{0}, num{0};
+  while (output.size() > 0) {
+    len = (output[0] << 8) + output[1];
+    output.erase(output.begin(), output.begin() + len + 4);
+    ++num;
+  }
+  ASSERT_EQ(num, 3);
+}
+
+// Inflates the raw deflate data the session sent after the compression was
+// enabled.
+std::vector<uint8_t> Inflate(const std::vector<uint8_t> &compressed) {
+  z_stream stream{};
+  EXPECT_EQ(inflateInit2(&stream, -MAX_WBITS), Z_OK);
+  std::vector<uint8_t> result(1024 * 1024);
+  stream.next_in = const_cast<Bytef *>(compressed.data());
+  stream.avail_in = compressed.size();
+  stream.next_out = result.data();
+  stream.avail_out = result.size();
+  EXPECT_EQ(inflate(&stream, Z_SYNC_FLUSH), Z_OK);
+  EXPECT_EQ(stream.avail_in, 0);
+  result.resize(result.size() - stream.avail_out);
+  inflateEnd(&stream);
+  return result;
+}
+
+TEST(BoltSession, Compression) {
+  // The v4 HELLO with the additional "compression": "deflate" field.
+  std::vector<uint8_t> init_req(std::begin(v4::init_req), std::end(v4::init_req));
+  init_req[2] = 0xa6;  // TinyMap6
+  const std::string_view field_str = "\x8b" "compression" "\x87" "deflate";
+  const std::vector<uint8_t> field(field_str.begin(), field_str.end());
+  init_req.insert(init_req.end(), field.begin(), field.end());
+
+  // The client can't enable the compression if the session doesn't allow it.
+  {
+    INIT_VARS;
+
+    ExecuteHandshake(input_stream, session, output, v4::handshake_req, v4::handshake_resp);
+    ExecuteCommand(input_stream, session, init_req.data(), init_req.size());
+    ASSERT_EQ(session.state_, State::Idle);
+    CheckOutput(output, v4::init_resp, sizeof(v4::init_resp));
+  }
+
+  {
+    INIT_VARS;
+    session.compression_allowed = true;
+
+    ExecuteHandshake(input_stream, session, output, v4::handshake_req, v4::handshake_resp);
+    // The RUN and PULL are pipelined with the HELLO, their responses are
+    // compressed nevertheless.
+    WriteChunkHeader(input_stream, init_req.size());
+    input_stream.Write(init_req.data(), init_req.size());
+    WriteChunkTail(input_stream);
+    WriteRunRequest(input_stream, kQueryReturn42, true);
+    ExecuteCommand(input_stream, session, v4::pullall_req, sizeof(v4::pullall_req));
+    ASSERT_EQ(session.state_, State::Idle);
+
+    // The response to the HELLO isn't compressed and confirms the compression.
+    const size_t init_resp_size = ((output[0] << 8) | output[1]) + 4;
+    ASSERT_GE(output.size(), init_resp_size);
+    const std::vector<uint8_t> init_resp(output.begin(), output.begin() + init_resp_size);
+    CheckSuccessMessage(output, false);
+    EXPECT_NE(std::search(init_resp.begin(), init_resp.end(), field.begin(), field.end()), init_resp.end());
+
+    auto responses = Inflate(std::vector<uint8_t>(output.begin() + init_resp_size, output.end()));
+    int num{0};
+    while (responses.size() > 0) {
+      const int len = (responses[0] << 8) + responses[1];
+      ASSERT_GE(responses.size(), len + 4);
+      responses.erase(responses.begin(), responses.begin() + len + 4);
+      ++num;
+    }
+    ASSERT_EQ(num, 3);
+  }
+}
+
 TEST(BoltSession, PartialPull) {
   INIT_VARS;
 
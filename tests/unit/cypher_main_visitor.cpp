@@ -36,6 +36,7 @@
 #include "query/frontend/ast/ast.hpp"
 #include "query/frontend/ast/cypher_main_visitor.hpp"
 #include "query/frontend/opencypher/parser.hpp"
+#include "query/frontend/simple_query_parser.hpp"
 #include "query/frontend/stripped.hpp"
 #include "query/procedure/cypher_types.hpp"
 #include "query/procedure/mg_procedure_impl.hpp"
@@ -197,6 +198,33 @@ class CachedAstGenerator : public Base {
   AstStorage ast_storage_;
 };
 
+// This generator parses the stripped query with the simple query parser, and
+// falls back to ANTLR for queries it doesn't handle, as the interpreter does.
+class SimpleQueryAstGenerator : public Base {
+ public:
+  Query *ParseQuery(const std::string &query_string) override {
+    context_.is_query_cached = true;
+    StrippedQuery stripped(query_string);
+    parameters_ = stripped.literals();
+    if (auto *query = ParseSimpleQuery(stripped.query(), &ast_storage_)) {
+      return query;
+    }
+    ::frontend::opencypher::Parser parser(stripped.query());
+    AstStorage tmp_storage;
+    CypherMainVisitor visitor(context_, &tmp_storage);
+    visitor.visit(parser.tree());
+    return visitor.query()->Clone(&ast_storage_);
+  }
+
+  PropertyIx Prop(const std::string &prop_name) override { return ast_storage_.GetPropertyIx(prop_name); }
+
+  LabelIx Label(const std::string &name) override { return ast_storage_.GetLabelIx(name); }
+
+  EdgeTypeIx EdgeType(const std::string &name) override { return ast_storage_.GetEdgeTypeIx(name); }
+
+  AstStorage ast_storage_;
+};
+
 class MockModule : public procedure::Module {
  public:
   MockModule(){};
@@ -292,6 +320,7 @@ std::shared_ptr<Base> gAstGeneratorTypes[] = {
     std::make_shared<OriginalAfterCloningAstGenerator>(),
     std::make_shared<ClonedAstGenerator>(),
     std::make_shared<CachedAstGenerator>(),
+    std::make_shared<SimpleQueryAstGenerator>(),
 };
 
 INSTANTIATE_TEST_CASE_P(AstGeneratorTypes, CypherMainVisitorTest, ::testing::ValuesIn(gAstGeneratorTypes));
@@ -839,6 +868,34 @@ TEST_P(CypherMainVisitorTest, UnaryMinusPlusOperators) {
   ast_generator.CheckLiteral(unary_plus_operator->expression_, 5);
 }
 
+TEST_P(CypherMainVisitorTest, PatternPredicate) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<CypherQuery *>(ast_generator.ParseQuery("MATCH (n) WHERE NOT (n)-[:T]->() RETURN n"));
+  ASSERT_TRUE(query);
+  ASSERT_TRUE(query->single_query_);
+  auto *match = dynamic_cast<Match *>(query->single_query_->clauses_[0]);
+  ASSERT_TRUE(match);
+  ASSERT_TRUE(match->where_);
+  auto *not_operator = dynamic_cast<NotOperator *>(match->where_->expression_);
+  ASSERT_TRUE(not_operator);
+  auto *exists = dynamic_cast<Exists *>(not_operator->expression_);
+  ASSERT_TRUE(exists);
+  ASSERT_TRUE(exists->pattern_);
+  EXPECT_FALSE(exists->pattern_->identifier_->user_declared_);
+  ASSERT_EQ(exists->pattern_->atoms_.size(), 3U);
+  auto *node = dynamic_cast<NodeAtom *>(exists->pattern_->atoms_[0]);
+  ASSERT_TRUE(node);
+  EXPECT_EQ(node->identifier_->name_, "n");
+  EXPECT_TRUE(node->identifier_->user_declared_);
+  auto *edge = dynamic_cast<EdgeAtom *>(exists->pattern_->atoms_[1]);
+  ASSERT_TRUE(edge);
+  EXPECT_EQ(edge->direction_, EdgeAtom::Direction::OUT);
+  EXPECT_FALSE(edge->identifier_->user_declared_);
+  auto *anonymous_node = dynamic_cast<NodeAtom *>(exists->pattern_->atoms_[2]);
+  ASSERT_TRUE(anonymous_node);
+  EXPECT_FALSE(anonymous_node->identifier_->user_declared_);
+}
+
 TEST_P(CypherMainVisitorTest, Aggregation) {
   auto &ast_generator = *GetParam();
   auto *query = dynamic_cast<CypherQuery *>(
@@ -1723,6 +1780,155 @@ TEST_P(CypherMainVisitorTest, UnwindWithoutAsError) {
   EXPECT_THROW(ast_generator.ParseQuery("UNWIND [1,2,3] RETURN 42"), SyntaxException);
 }
 
+TEST_P(CypherMainVisitorTest, UnwindBatchCreate) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<CypherQuery *>(
+      ast_generator.ParseQuery("UNWIND $batch AS row CREATE (n:Node {id: row.id, name: row.name})"));
+  ASSERT_TRUE(query);
+  ASSERT_TRUE(query->single_query_);
+  auto *single_query = query->single_query_;
+  ASSERT_EQ(single_query->clauses_.size(), 2U);
+  auto *unwind = dynamic_cast<Unwind *>(single_query->clauses_[0]);
+  ASSERT_TRUE(unwind);
+  EXPECT_EQ(unwind->named_expression_->name_, "row");
+  auto *batch = dynamic_cast<ParameterLookup *>(unwind->named_expression_->expression_);
+  ASSERT_TRUE(batch);
+  EXPECT_EQ(batch->token_position_, 1);
+  auto *create = dynamic_cast<Create *>(single_query->clauses_[1]);
+  ASSERT_TRUE(create);
+  ASSERT_EQ(create->patterns_.size(), 1U);
+  ASSERT_EQ(create->patterns_[0]->atoms_.size(), 1U);
+  auto *node = dynamic_cast<NodeAtom *>(create->patterns_[0]->atoms_[0]);
+  ASSERT_TRUE(node);
+  EXPECT_EQ(node->identifier_->name_, "n");
+  EXPECT_THAT(node->labels_, ElementsAre(ast_generator.Label("Node")));
+  auto &properties = std::get<0>(node->properties_);
+  ASSERT_EQ(properties.size(), 2U);
+  for (const auto &name : {"id", "name"}) {
+    auto *lookup = dynamic_cast<PropertyLookup *>(properties[ast_generator.Prop(name)]);
+    ASSERT_TRUE(lookup);
+    EXPECT_EQ(lookup->property_, ast_generator.Prop(name));
+    auto *identifier = dynamic_cast<Identifier *>(lookup->expression_);
+    ASSERT_TRUE(identifier);
+    EXPECT_EQ(identifier->name_, "row");
+  }
+}
+
+TEST_P(CypherMainVisitorTest, MergeUpsert) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<CypherQuery *>(
+      ast_generator.ParseQuery("MERGE (n:User {id: $id}) ON CREATE SET n.visits = 1 "
+                               "ON MATCH SET n.visits = n.visits + 1 RETURN n"));
+  ASSERT_TRUE(query);
+  ASSERT_TRUE(query->single_query_);
+  auto *single_query = query->single_query_;
+  ASSERT_EQ(single_query->clauses_.size(), 2U);
+  auto *merge = dynamic_cast<Merge *>(single_query->clauses_[0]);
+  ASSERT_TRUE(merge);
+  ASSERT_EQ(merge->pattern_->atoms_.size(), 1U);
+  auto *node = dynamic_cast<NodeAtom *>(merge->pattern_->atoms_[0]);
+  ASSERT_TRUE(node);
+  EXPECT_THAT(node->labels_, ElementsAre(ast_generator.Label("User")));
+  auto *id = dynamic_cast<ParameterLookup *>(std::get<0>(node->properties_)[ast_generator.Prop("id")]);
+  ASSERT_TRUE(id);
+  EXPECT_EQ(id->token_position_, 8);
+  EXPECT_FALSE(merge->pattern_->identifier_->user_declared_);
+
+  ASSERT_EQ(merge->on_create_.size(), 1U);
+  auto *on_create = dynamic_cast<SetProperty *>(merge->on_create_[0]);
+  ASSERT_TRUE(on_create);
+  EXPECT_EQ(on_create->property_lookup_->property_, ast_generator.Prop("visits"));
+  ast_generator.CheckLiteral(on_create->expression_, 1);
+
+  ASSERT_EQ(merge->on_match_.size(), 1U);
+  auto *on_match = dynamic_cast<SetProperty *>(merge->on_match_[0]);
+  ASSERT_TRUE(on_match);
+  auto *addition = dynamic_cast<AdditionOperator *>(on_match->expression_);
+  ASSERT_TRUE(addition);
+  EXPECT_TRUE(dynamic_cast<PropertyLookup *>(addition->expression1_));
+  ast_generator.CheckLiteral(addition->expression2_, 1);
+
+  auto *return_clause = dynamic_cast<Return *>(single_query->clauses_[1]);
+  ASSERT_TRUE(return_clause);
+  ASSERT_EQ(return_clause->body_.named_expressions.size(), 1U);
+  EXPECT_EQ(return_clause->body_.named_expressions[0]->name_, "n");
+}
+
+TEST_P(CypherMainVisitorTest, PointLookup) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<CypherQuery *>(
+      ast_generator.ParseQuery("MATCH (n:User)-[e:KNOWS]->(m) WHERE n.id = 42 AND 1 < m.age <= 2 "
+                               "RETURN m.name, e AS edge ORDER BY m.name DESC LIMIT 10"));
+  ASSERT_TRUE(query);
+  ASSERT_TRUE(query->single_query_);
+  auto *single_query = query->single_query_;
+  ASSERT_EQ(single_query->clauses_.size(), 2U);
+  auto *match = dynamic_cast<Match *>(single_query->clauses_[0]);
+  ASSERT_TRUE(match);
+  EXPECT_FALSE(match->optional_);
+  ASSERT_EQ(match->patterns_.size(), 1U);
+  ASSERT_EQ(match->patterns_[0]->atoms_.size(), 3U);
+  auto *edge = dynamic_cast<EdgeAtom *>(match->patterns_[0]->atoms_[1]);
+  ASSERT_TRUE(edge);
+  EXPECT_EQ(edge->identifier_->name_, "e");
+  EXPECT_EQ(edge->direction_, EdgeAtom::Direction::OUT);
+  EXPECT_THAT(edge->edge_types_, ElementsAre(ast_generator.EdgeType("KNOWS")));
+
+  ASSERT_TRUE(match->where_);
+  auto *and_operator = dynamic_cast<AndOperator *>(match->where_->expression_);
+  ASSERT_TRUE(and_operator);
+  auto *equal = dynamic_cast<EqualOperator *>(and_operator->expression1_);
+  ASSERT_TRUE(equal);
+  ast_generator.CheckLiteral(equal->expression2_, 42);
+  auto *chained = dynamic_cast<AndOperator *>(and_operator->expression2_);
+  ASSERT_TRUE(chained);
+  auto *less = dynamic_cast<LessOperator *>(chained->expression1_);
+  ASSERT_TRUE(less);
+  auto *less_equal = dynamic_cast<LessEqualOperator *>(chained->expression2_);
+  ASSERT_TRUE(less_equal);
+  EXPECT_EQ(less->expression2_, less_equal->expression1_);
+
+  auto *return_clause = dynamic_cast<Return *>(single_query->clauses_[1]);
+  ASSERT_TRUE(return_clause);
+  ASSERT_EQ(return_clause->body_.named_expressions.size(), 2U);
+  EXPECT_EQ(return_clause->body_.named_expressions[0]->name_, "m.name");
+  EXPECT_EQ(return_clause->body_.named_expressions[0]->token_position_, 32);
+  EXPECT_EQ(return_clause->body_.named_expressions[1]->name_, "edge");
+  EXPECT_EQ(return_clause->body_.named_expressions[1]->token_position_, -1);
+  ASSERT_EQ(return_clause->body_.order_by.size(), 1U);
+  EXPECT_EQ(return_clause->body_.order_by[0].ordering, Ordering::DESC);
+  ast_generator.CheckLiteral(return_clause->body_.limit, 10);
+}
+
+TEST(SimpleQueryParser, FallsBackToAntlr) {
+  auto parses = [](const std::string &query) {
+    AstStorage storage;
+    return ParseSimpleQuery(StrippedQuery(query).query(), &storage) != nullptr;
+  };
+  EXPECT_TRUE(parses("MATCH (n:User {id: $id}) RETURN n"));
+  EXPECT_TRUE(parses("MATCH (n:User) WHERE n.id = 5 RETURN n.name AS name LIMIT 1;"));
+  EXPECT_TRUE(parses("MERGE (n:User {id: $id}) ON CREATE SET n += $props ON MATCH SET n:Seen"));
+  EXPECT_TRUE(parses("UNWIND $batch AS row CREATE (n:Node {id: row.id})"));
+  EXPECT_TRUE(parses("UNWIND $batch AS row MATCH (a {id: row.a}), (b {id: row.b}) CREATE (a)-[:T $props]->(b)"));
+
+  // Outside of the handled subset.
+  EXPECT_FALSE(parses("OPTIONAL MATCH (n) RETURN n"));
+  EXPECT_FALSE(parses("MATCH (n) WITH n RETURN n"));
+  EXPECT_FALSE(parses("MATCH (n) RETURN count(n)"));
+  EXPECT_FALSE(parses("MATCH (n) WHERE NOT n.x RETURN n"));
+  EXPECT_FALSE(parses("MATCH (n)-[*]->(m) RETURN m"));
+  EXPECT_FALSE(parses("MATCH (`n m`) RETURN `n m`"));
+  EXPECT_FALSE(parses("UNWIND [1, 2] AS x RETURN x"));
+  EXPECT_FALSE(parses("RETURN -1"));
+  EXPECT_FALSE(parses("RETURN 1 UNION RETURN 2"));
+  EXPECT_FALSE(parses("EXPLAIN MATCH (n) RETURN n"));
+  // Rejected by the visitor.
+  EXPECT_FALSE(parses("MATCH (n)"));
+  EXPECT_FALSE(parses("CREATE (n) MATCH (m) RETURN m"));
+  EXPECT_FALSE(parses("RETURN 1 RETURN 2"));
+  EXPECT_FALSE(parses("CREATE ({a: 1, a: 2})"));
+}
+
 TEST_P(CypherMainVisitorTest, CreateIndex) {
   auto &ast_generator = *GetParam();
   auto *index_query = dynamic_cast<IndexQuery *>(ast_generator.ParseQuery("Create InDeX oN :mirko(slavko)"));
@@ -1970,6 +2176,38 @@ TEST_P(CypherMainVisitorTest, SemanticExceptionOnWShortestWithoutLambda) {
   ASSERT_THROW(ast_generator.ParseQuery("MATCH ()-[r *wShortest]-() RETURN r"), SemanticException);
 }
 
+TEST_P(CypherMainVisitorTest, MatchWShortestHeuristicReturn) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<CypherQuery *>(
+      ast_generator.ParseQuery("MATCH ()-[r *wShortest (we, wn | 42) total_weight (e, n | true) (he, hn | 7)]->() "
+                               "RETURN r"));
+  ASSERT_TRUE(query);
+  ASSERT_TRUE(query->single_query_);
+  auto *match = dynamic_cast<Match *>(query->single_query_->clauses_[0]);
+  ASSERT_TRUE(match);
+  auto *shortest = dynamic_cast<EdgeAtom *>(match->patterns_[0]->atoms_[1]);
+  ASSERT_TRUE(shortest);
+  EXPECT_EQ(shortest->type_, EdgeAtom::Type::WEIGHTED_SHORTEST_PATH);
+  ast_generator.CheckLiteral(shortest->weight_lambda_.expression, 42);
+  ast_generator.CheckLiteral(shortest->filter_lambda_.expression, true);
+  EXPECT_EQ(shortest->heuristic_lambda_.inner_edge->name_, "he");
+  EXPECT_TRUE(shortest->heuristic_lambda_.inner_edge->user_declared_);
+  EXPECT_EQ(shortest->heuristic_lambda_.inner_node->name_, "hn");
+  EXPECT_TRUE(shortest->heuristic_lambda_.inner_node->user_declared_);
+  ast_generator.CheckLiteral(shortest->heuristic_lambda_.expression, 7);
+  ASSERT_TRUE(shortest->total_weight_);
+  EXPECT_EQ(shortest->total_weight_->name_, "total_weight");
+}
+
+TEST_P(CypherMainVisitorTest, SemanticExceptionOnHeuristicWithoutWShortest) {
+  auto &ast_generator = *GetParam();
+  ASSERT_THROW(ast_generator.ParseQuery("MATCH ()-[r *allShortest (we, wn | 42) total_weight (e, n | true) (he, hn | "
+                                        "7)]-() RETURN r"),
+               SemanticException);
+  ASSERT_THROW(ast_generator.ParseQuery("MATCH ()-[r *bfs (e, n | true) (he, hn | 7) (oe, on | 1)]-() RETURN r"),
+               SemanticException);
+}
+
 TEST_P(CypherMainVisitorTest, SemanticExceptionOnUnionTypeMix) {
   auto &ast_generator = *GetParam();
   ASSERT_THROW(ast_generator.ParseQuery("RETURN 5 as X UNION ALL RETURN 6 AS X UNION RETURN 7 AS X"),
@@ -2559,6 +2797,27 @@ TEST_P(CypherMainVisitorTest, TestShowConstraintInfo) {
   EXPECT_EQ(query->info_type_, InfoQuery::InfoType::CONSTRAINT);
 }
 
+TEST_P(CypherMainVisitorTest, TestShowPlanCache) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<InfoQuery *>(ast_generator.ParseQuery("SHOW PLAN CACHE"));
+  ASSERT_TRUE(query);
+  EXPECT_EQ(query->info_type_, InfoQuery::InfoType::PLAN_CACHE);
+}
+
+TEST_P(CypherMainVisitorTest, TestShowQueryStatistics) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<InfoQuery *>(ast_generator.ParseQuery("SHOW QUERY STATISTICS"));
+  ASSERT_TRUE(query);
+  EXPECT_EQ(query->info_type_, InfoQuery::InfoType::QUERY_STATISTICS);
+}
+
+TEST_P(CypherMainVisitorTest, TestShowResourcePools) {
+  auto &ast_generator = *GetParam();
+  auto *query = dynamic_cast<InfoQuery *>(ast_generator.ParseQuery("SHOW RESOURCE POOLS"));
+  ASSERT_TRUE(query);
+  EXPECT_EQ(query->info_type_, InfoQuery::InfoType::RESOURCE_POOLS);
+}
+
 TEST_P(CypherMainVisitorTest, CreateConstraintSyntaxError) {
   auto &ast_generator = *GetParam();
   EXPECT_THROW(ast_generator.ParseQuery("CREATE CONSTRAINT ON (:label) ASSERT EXISTS"), SyntaxException);
@@ -4222,6 +4481,26 @@ TEST_P(CypherMainVisitorTest, ConfigQuery) {
   ASSERT_NO_THROW(ast_generator.ParseQuery("SHOW CONFIG"));
 }
 
+TEST_P(CypherMainVisitorTest, AnalyzeGraphQuery) {
+  auto &ast_generator = *GetParam();
+
+  TestInvalidQuery("ANALYZE", ast_generator);
+  TestInvalidQuery("ANALYZE GRAPHS", ast_generator);
+  TestInvalidQuery("ANALYZE GRAPH DELETE", ast_generator);
+  TestInvalidQuery("ANALYZE GRAPH DELETE STATS", ast_generator);
+
+  {
+    auto *query = dynamic_cast<AnalyzeGraphQuery *>(ast_generator.ParseQuery("ANALYZE GRAPH"));
+    ASSERT_TRUE(query);
+    EXPECT_EQ(query->action_, AnalyzeGraphQuery::Action::ANALYZE);
+  }
+  {
+    auto *query = dynamic_cast<AnalyzeGraphQuery *>(ast_generator.ParseQuery("ANALYZE GRAPH DELETE STATISTICS"));
+    ASSERT_TRUE(query);
+    EXPECT_EQ(query->action_, AnalyzeGraphQuery::Action::DELETE_STATISTICS);
+  }
+}
+
 TEST_P(CypherMainVisitorTest, ForeachThrow) {
   auto &ast_generator = *GetParam();
   EXPECT_THROW(ast_generator.ParseQuery("FOREACH(i IN [1, 2] | UNWIND [1,2,3] AS j CREATE (n))"), SyntaxException);
@@ -4307,3 +4586,50 @@ TEST_P(CypherMainVisitorTest, Foreach) {
     ASSERT_TRUE(dynamic_cast<RemoveProperty *>(*++clauses.begin()));
   }
 }
+
+TEST_P(CypherMainVisitorTest, CallSubquery) {
+  auto &ast_generator = *GetParam();
+  {
+    auto *query = dynamic_cast<CypherQuery *>(
+        ast_generator.ParseQuery("MATCH (n) CALL { WITH n MATCH (n)-->(m) RETURN m } RETURN n, m"));
+    ASSERT_TRUE(query);
+    auto *single_query = query->single_query_;
+    ASSERT_EQ(single_query->clauses_.size(), 3U);
+    auto *call_subquery = dynamic_cast<CallSubquery *>(single_query->clauses_[1]);
+    ASSERT_TRUE(call_subquery);
+    EXPECT_FALSE(call_subquery->in_transactions_);
+    EXPECT_FALSE(call_subquery->batch_size_);
+    const auto &clauses = call_subquery->single_query_->clauses_;
+    ASSERT_EQ(clauses.size(), 3U);
+    EXPECT_TRUE(dynamic_cast<With *>(clauses[0]));
+    EXPECT_TRUE(dynamic_cast<Match *>(clauses[1]));
+    EXPECT_TRUE(dynamic_cast<Return *>(clauses[2]));
+  }
+  {
+    auto *query = dynamic_cast<CypherQuery *>(
+        ast_generator.ParseQuery("UNWIND range(1, 10) AS x CALL { WITH x CREATE (:N {x: x}) } IN TRANSACTIONS"));
+    ASSERT_TRUE(query);
+    auto *call_subquery = dynamic_cast<CallSubquery *>(query->single_query_->clauses_[1]);
+    ASSERT_TRUE(call_subquery);
+    EXPECT_TRUE(call_subquery->in_transactions_);
+    EXPECT_FALSE(call_subquery->batch_size_);
+  }
+  {
+    auto *query = dynamic_cast<CypherQuery *>(ast_generator.ParseQuery(
+        "UNWIND range(1, 10) AS x CALL { WITH x CREATE (:N {x: x}) } IN TRANSACTIONS OF 10 ROWS"));
+    ASSERT_TRUE(query);
+    auto *call_subquery = dynamic_cast<CallSubquery *>(query->single_query_->clauses_[1]);
+    ASSERT_TRUE(call_subquery);
+    EXPECT_TRUE(call_subquery->in_transactions_);
+    ast_generator.CheckLiteral(call_subquery->batch_size_, 10);
+  }
+}
+
+TEST_P(CypherMainVisitorTest, CallSubqueryThrow) {
+  auto &ast_generator = *GetParam();
+  EXPECT_THROW(ast_generator.ParseQuery("RETURN 1 AS x CALL { RETURN 2 AS y }"), SemanticException);
+  EXPECT_THROW(ast_generator.ParseQuery(
+                   "UNWIND [1] AS x CALL { WITH x CALL { WITH x CREATE (:N) } IN TRANSACTIONS } IN TRANSACTIONS"),
+               SemanticException);
+  EXPECT_THROW(ast_generator.ParseQuery("CALL { CREATE (:N) } IN TRANSACTIONS OF ROWS"), SyntaxException);
+}
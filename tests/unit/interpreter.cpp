@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -10,8 +10,12 @@
 // licenses/APL.txt.
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
+#include <thread>
+
+#include <json/json.hpp>
 
 #include "communication/bolt/v1/value.hpp"
 #include "communication/result_stream_faker.hpp"
@@ -25,6 +29,7 @@
 #include "query/stream.hpp"
 #include "query/typed_value.hpp"
 #include "query_common.hpp"
+#include "storage/v2/durability/paths.hpp"
 #include "storage/v2/isolation_level.hpp"
 #include "storage/v2/property_value.hpp"
 #include "utils/csv_parsing.hpp"
@@ -50,7 +55,7 @@ struct InterpreterFaker {
   auto Prepare(const std::string &query, const std::map<std::string, memgraph::storage::PropertyValue> &params = {}) {
     ResultStreamFaker stream(interpreter_context.db);
 
-    const auto [header, _, qid] = interpreter.Prepare(query, params, nullptr);
+    const auto [header, _, qid, statement_id] = interpreter.Prepare(query, params, nullptr);
     stream.Header(header);
     return std::make_pair(std::move(stream), qid);
   }
@@ -557,6 +562,99 @@ TEST_F(InterpreterTest, ShowStorageInfoInMulticommandTransaction) {
   Interpret("ROLLBACK");
 }
 
+TEST_F(InterpreterTest, CallInTransactionsInMulticommandTransaction) {
+  Interpret("BEGIN");
+  ASSERT_THROW(Interpret("UNWIND range(1, 10) AS x CALL { WITH x CREATE (:N {x: x}) } IN TRANSACTIONS"),
+               memgraph::query::CallInTransactionsInMulticommandTxException);
+  Interpret("ROLLBACK");
+}
+
+TEST_F(InterpreterTest, CallSubquery) {
+  Interpret("UNWIND range(1, 3) AS x CREATE (:N {x: x})");
+  {
+    auto stream = Interpret("MATCH (n:N) CALL { WITH n RETURN n.x * 10 AS y } RETURN n.x AS x, y ORDER BY x");
+    ASSERT_EQ(stream.GetResults().size(), 3U);
+    for (int64_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(stream.GetResults()[i][0].ValueInt(), i + 1);
+      EXPECT_EQ(stream.GetResults()[i][1].ValueInt(), (i + 1) * 10);
+    }
+  }
+  {
+    // A unit subquery doesn't change the cardinality of the outer query.
+    auto stream = Interpret("MATCH (n:N) CALL { WITH n CREATE (:M {x: n.x}) } RETURN count(*) AS c");
+    ASSERT_EQ(stream.GetResults().size(), 1U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 3);
+  }
+  {
+    auto stream = Interpret("MATCH (m:M) RETURN count(m) AS c");
+    ASSERT_EQ(stream.GetResults().size(), 1U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 3);
+  }
+}
+
+TEST_F(InterpreterTest, CallInTransactions) {
+  Interpret("UNWIND range(1, 10) AS x CALL { WITH x CREATE (:N {x: x}) } IN TRANSACTIONS OF 3 ROWS");
+  {
+    auto stream = Interpret("MATCH (n:N) RETURN count(n) AS c, sum(n.x) AS s");
+    ASSERT_EQ(stream.GetResults().size(), 1U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 10);
+    EXPECT_EQ(stream.GetResults()[0][1].ValueInt(), 55);
+  }
+  // The outer rows are accumulated, so the subquery doesn't see its own writes.
+  Interpret("MATCH (n:N) CALL { WITH n CREATE (:N {x: n.x}) } IN TRANSACTIONS OF 4 ROWS");
+  {
+    auto stream = Interpret("MATCH (n:N) RETURN count(n) AS c");
+    ASSERT_EQ(stream.GetResults().size(), 1U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 20);
+  }
+  ASSERT_THROW(Interpret("UNWIND range(1, 10) AS x CALL { WITH x CREATE (:N {x: x}) } IN TRANSACTIONS OF 0 ROWS"),
+               memgraph::query::QueryRuntimeException);
+}
+
+TEST_F(InterpreterTest, CallInTransactionsRunsTriggers) {
+  Interpret(
+      "CREATE TRIGGER markCreated ON () CREATE BEFORE COMMIT EXECUTE "
+      "UNWIND createdVertices AS v SET v.marked = true");
+  // Every batch is committed like a whole transaction, so the trigger sees the
+  // vertices created in each of them.
+  Interpret("UNWIND range(1, 10) AS x CALL { WITH x CREATE (:N {x: x}) } IN TRANSACTIONS OF 3 ROWS");
+  Interpret("DROP TRIGGER markCreated");
+  auto stream = Interpret("MATCH (n:N) WHERE n.marked RETURN count(n) AS c");
+  ASSERT_EQ(stream.GetResults().size(), 1U);
+  EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 10);
+}
+
+TEST_F(InterpreterTest, CallInTransactionsWithAfterCommitTriggersDuringIndexCreation) {
+  Interpret("CREATE TRIGGER seen ON () CREATE AFTER COMMIT EXECUTE UNWIND createdVertices AS v SET v.seen = true");
+  auto [stream, qid] =
+      Prepare("UNWIND range(1, 4) AS x CALL { WITH x CREATE (n:N {x: x}) RETURN n } IN TRANSACTIONS OF 1 ROWS RETURN x");
+  Pull(&stream, 1, qid);
+  // The index creation waits for the running query. The storage lock prefers
+  // writers, so the batches committed in the meantime mustn't lock it again.
+  std::thread index_thread([this] {
+    memgraph::query::Interpreter interpreter(&default_interpreter.interpreter_context);
+    ResultStreamFaker index_stream(&db_);
+    const auto [header, _, index_qid, statement_id] = interpreter.Prepare("CREATE INDEX ON :N(x)", {}, nullptr);
+    interpreter.Pull(&index_stream, {}, index_qid);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  Pull(&stream, {}, qid);
+  index_thread.join();
+  EXPECT_EQ(stream.GetResults().size(), 4U);
+  Interpret("DROP TRIGGER seen");
+  auto count_stream = Interpret("MATCH (n:N) RETURN count(n) AS c");
+  ASSERT_EQ(count_stream.GetResults().size(), 1U);
+  EXPECT_EQ(count_stream.GetResults()[0][0].ValueInt(), 4);
+}
+
+TEST_F(InterpreterTest, CallInTransactionsNotAllowedInTriggersAndProfile) {
+  ASSERT_THROW(Interpret("CREATE TRIGGER batches ON CREATE BEFORE COMMIT EXECUTE "
+                         "UNWIND range(1, 10) AS x CALL { WITH x CREATE (:M) } IN TRANSACTIONS"),
+               memgraph::utils::BasicException);
+  ASSERT_THROW(Interpret("PROFILE UNWIND range(1, 10) AS x CALL { WITH x CREATE (:M) } IN TRANSACTIONS"),
+               memgraph::query::QueryException);
+}
+
 // NOLINTNEXTLINE(hicpp-special-member-functions)
 TEST_F(InterpreterTest, ExistenceConstraintTest) {
   Interpret("CREATE CONSTRAINT ON (n:A) ASSERT EXISTS (n.a);");
@@ -645,7 +743,9 @@ TEST_F(InterpreterTest, ExplainQuery) {
   auto stream = Interpret("EXPLAIN MATCH (n) RETURN *;");
   ASSERT_EQ(stream.GetHeader().size(), 1U);
   EXPECT_EQ(stream.GetHeader().front(), "QUERY PLAN");
-  std::vector<std::string> expected_rows{" * Produce {n}", " * ScanAll (n)", " * Once"};
+  std::vector<std::string> expected_rows{" * Produce {n} [estimated rows: 0, cost: 0]",
+                                         " * ScanAll (n) [estimated rows: 0, cost: 0]",
+                                         " * Once [estimated rows: 1, cost: 0]"};
   ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
   auto expected_it = expected_rows.begin();
   for (const auto &row : stream.GetResults()) {
@@ -670,7 +770,9 @@ TEST_F(InterpreterTest, ExplainQueryMultiplePulls) {
   auto [stream, qid] = Prepare("EXPLAIN MATCH (n) RETURN *;");
   ASSERT_EQ(stream.GetHeader().size(), 1U);
   EXPECT_EQ(stream.GetHeader().front(), "QUERY PLAN");
-  std::vector<std::string> expected_rows{" * Produce {n}", " * ScanAll (n)", " * Once"};
+  std::vector<std::string> expected_rows{" * Produce {n} [estimated rows: 0, cost: 0]",
+                                         " * ScanAll (n) [estimated rows: 0, cost: 0]",
+                                         " * Once [estimated rows: 1, cost: 0]"};
   Pull(&stream, 1);
   ASSERT_EQ(stream.GetResults().size(), 1);
   auto expected_it = expected_rows.begin();
@@ -697,6 +799,152 @@ TEST_F(InterpreterTest, ExplainQueryMultiplePulls) {
   EXPECT_EQ(interpreter_context.ast_cache.size(), 2U);
 }
 
+TEST_F(InterpreterTest, PlanCacheEviction) {
+  const auto &interpreter_context = default_interpreter.interpreter_context;
+  const auto max_entries = FLAGS_query_plan_cache_max_entries;
+  FLAGS_query_plan_cache_max_entries = 8;
+  for (int i = 0; i < 20; ++i) {
+    Interpret(fmt::format("MATCH (n:Label{}) RETURN n;", i));
+    EXPECT_LE(interpreter_context.plan_cache.size(), 8U);
+  }
+  // The plan that was used last must survive the eviction.
+  Interpret("MATCH (n:Label19) RETURN n;");
+  auto stream = Interpret("SHOW PLAN CACHE;");
+  EXPECT_TRUE(std::any_of(stream.GetResults().begin(), stream.GetResults().end(), [](const auto &row) {
+    return row[4].ValueList().size() == 1 && row[4].ValueList()[0].ValueString() == "Label19" &&
+           row[1].ValueInt() == 1;
+  }));
+  FLAGS_query_plan_cache_max_entries = max_entries;
+}
+
+TEST(InterpreterAdmissionTest, ExplicitTransactionSharesTicket) {
+  const auto resource_pools = FLAGS_resource_pools;
+  const auto admission_timeout_sec = FLAGS_query_admission_timeout_sec;
+  FLAGS_resource_pools = "default:1";
+  FLAGS_query_admission_timeout_sec = 1;
+  {
+    memgraph::storage::Storage db;
+    InterpreterFaker interpreter(&db, {}, std::filesystem::temp_directory_path() / "MG_tests_unit_interpreter");
+    interpreter.Interpret("BEGIN");
+    // The second query doesn't wait for the slot held by the first one.
+    auto [first_stream, first_qid] = interpreter.Prepare("UNWIND [1, 2] AS n RETURN n");
+    auto [second_stream, second_qid] = interpreter.Prepare("UNWIND [3, 4] AS n RETURN n");
+    interpreter.Pull(&first_stream, {}, first_qid);
+    interpreter.Pull(&second_stream, {}, second_qid);
+    EXPECT_EQ(first_stream.GetResults().size(), 2U);
+    EXPECT_EQ(second_stream.GetResults().size(), 2U);
+    interpreter.Interpret("COMMIT");
+
+    // The slot is released with the transaction.
+    EXPECT_EQ(interpreter.Interpret("RETURN 1").GetResults().size(), 1U);
+    interpreter.Interpret("BEGIN");
+    interpreter.Interpret("RETURN 1");
+    interpreter.Interpret("ROLLBACK");
+    EXPECT_EQ(interpreter.Interpret("RETURN 1").GetResults().size(), 1U);
+  }
+  FLAGS_resource_pools = resource_pools;
+  FLAGS_query_admission_timeout_sec = admission_timeout_sec;
+}
+
+TEST_F(InterpreterTest, PlanCacheScopedInvalidation) {
+  const auto &interpreter_context = default_interpreter.interpreter_context;
+  Interpret("MATCH (n:A) WHERE n.a = 1 RETURN n;");
+  Interpret("MATCH (n:B) RETURN n;");
+  EXPECT_EQ(interpreter_context.plan_cache.size(), 2U);
+  Interpret("CREATE INDEX ON :B(b);");
+  EXPECT_EQ(interpreter_context.plan_cache.size(), 2U);
+  Interpret("CREATE INDEX ON :A(a);");
+  EXPECT_EQ(interpreter_context.plan_cache.size(), 1U);
+  Interpret("CREATE INDEX ON :B;");
+  EXPECT_EQ(interpreter_context.plan_cache.size(), 0U);
+}
+
+TEST_F(InterpreterTest, PreparedStatement) {
+  auto &interpreter = default_interpreter.interpreter;
+  auto &plan_cache = default_interpreter.interpreter_context.plan_cache;
+  Interpret("UNWIND range(1, 3) AS x CREATE (:N {x: x})");
+  const std::string query = "MATCH (n:N) WHERE n.x = $x RETURN n.x AS x";
+  auto pull = [&](const auto &prepare_result) {
+    ResultStreamFaker stream(&db_);
+    stream.Header(prepare_result.headers);
+    stream.Summary(interpreter.Pull(&stream, {}, prepare_result.qid));
+    EXPECT_EQ(stream.GetHeader(), std::vector<std::string>{"x"});
+    return stream.GetResults();
+  };
+  auto params = [](const int64_t x) {
+    return std::map<std::string, memgraph::storage::PropertyValue>{{"x", memgraph::storage::PropertyValue(x)}};
+  };
+
+  const auto prepared = interpreter.Prepare(query, params(1), nullptr, true);
+  ASSERT_TRUE(prepared.statement_id);
+  const auto statement_id = *prepared.statement_id;
+  ASSERT_EQ(pull(prepared).size(), 1U);
+  EXPECT_EQ(*interpreter.PreparedStatementQuery(statement_id), query);
+  EXPECT_EQ(interpreter.Prepare(query, params(1), nullptr, true).statement_id, statement_id);
+  {
+    const auto results = pull(interpreter.PrepareStatement(statement_id, params(2), nullptr));
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0][0].ValueInt(), 2);
+  }
+  EXPECT_EQ(plan_cache.size(), 1U);
+
+  // An index on the used label invalidates the kept plan, so the statement is
+  // planned again.
+  Interpret("CREATE INDEX ON :N(x);");
+  EXPECT_EQ(plan_cache.size(), 0U);
+  {
+    const auto results = pull(interpreter.PrepareStatement(statement_id, params(3), nullptr));
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0][0].ValueInt(), 3);
+  }
+  EXPECT_EQ(plan_cache.size(), 1U);
+
+  ASSERT_THROW(interpreter.PrepareStatement(statement_id + 1, {}, nullptr), memgraph::query::QueryException);
+  EXPECT_EQ(interpreter.PreparedStatementQuery(statement_id + 1), nullptr);
+  ASSERT_THROW(interpreter.PrepareStatement(statement_id, {}, nullptr), memgraph::query::UnprovidedParameterError);
+}
+
+TEST_F(InterpreterTest, ShowPlanCache) {
+  Interpret("MATCH (n:A) WHERE n.a = 1 RETURN n;");
+  Interpret("MATCH (n:A) WHERE n.a = 2 RETURN n;");
+  auto stream = Interpret("SHOW PLAN CACHE;");
+  ASSERT_EQ(stream.GetHeader().size(), 6U);
+  ASSERT_EQ(stream.GetResults().size(), 1U);
+  const auto &row = stream.GetResults()[0];
+  EXPECT_EQ(row[1].ValueInt(), 1);
+  ASSERT_EQ(row[4].ValueList().size(), 1U);
+  EXPECT_EQ(row[4].ValueList()[0].ValueString(), "A");
+  ASSERT_EQ(row[5].ValueList().size(), 1U);
+  EXPECT_EQ(row[5].ValueList()[0].ValueString(), "a");
+}
+
+TEST_F(InterpreterTest, ShowQueryStatistics) {
+  Interpret("UNWIND range(1, 3) AS x RETURN x;");
+  Interpret("UNWIND range(1, 5) AS x RETURN x;");
+  auto stream = Interpret("SHOW QUERY STATISTICS;");
+  ASSERT_EQ(stream.GetHeader().size(), 10U);
+  const auto &results = stream.GetResults();
+  const auto it = std::find_if(results.begin(), results.end(), [](const auto &row) {
+    return row[1].ValueString().starts_with("UNWIND range");
+  });
+  ASSERT_NE(it, results.end());
+  const auto &row = *it;
+  EXPECT_EQ(row[2].ValueInt(), 2);
+  EXPECT_GE(row[3].ValueDouble(), row[4].ValueDouble());
+  EXPECT_GE(row[4].ValueDouble(), row[6].ValueDouble());
+  EXPECT_EQ(row[7].ValueInt(), 8);
+  EXPECT_DOUBLE_EQ(row[8].ValueDouble(), 0.5);
+  EXPECT_GT(row[9].ValueInt(), 0);
+}
+
+TEST_F(InterpreterTest, ShowResourcePools) {
+  // No resource pools are defined by default, so queries run without limits.
+  Interpret("UNWIND range(1, 3) AS x RETURN x;");
+  auto stream = Interpret("SHOW RESOURCE POOLS;");
+  ASSERT_EQ(stream.GetHeader().size(), 11U);
+  EXPECT_TRUE(stream.GetResults().empty());
+}
+
 TEST_F(InterpreterTest, ExplainQueryInMulticommandTransaction) {
   const auto &interpreter_context = default_interpreter.interpreter_context;
 
@@ -707,7 +955,9 @@ TEST_F(InterpreterTest, ExplainQueryInMulticommandTransaction) {
   Interpret("COMMIT");
   ASSERT_EQ(stream.GetHeader().size(), 1U);
   EXPECT_EQ(stream.GetHeader().front(), "QUERY PLAN");
-  std::vector<std::string> expected_rows{" * Produce {n}", " * ScanAll (n)", " * Once"};
+  std::vector<std::string> expected_rows{" * Produce {n} [estimated rows: 0, cost: 0]",
+                                         " * ScanAll (n) [estimated rows: 0, cost: 0]",
+                                         " * Once [estimated rows: 1, cost: 0]"};
   ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
   auto expected_it = expected_rows.begin();
   for (const auto &row : stream.GetResults()) {
@@ -733,7 +983,9 @@ TEST_F(InterpreterTest, ExplainQueryWithParams) {
       Interpret("EXPLAIN MATCH (n) WHERE n.id = $id RETURN *;", {{"id", memgraph::storage::PropertyValue(42)}});
   ASSERT_EQ(stream.GetHeader().size(), 1U);
   EXPECT_EQ(stream.GetHeader().front(), "QUERY PLAN");
-  std::vector<std::string> expected_rows{" * Produce {n}", " * Filter", " * ScanAll (n)", " * Once"};
+  std::vector<std::string> expected_rows{
+      " * Produce {n} [estimated rows: 0, cost: 0]", " * Filter [estimated rows: 0, cost: 0]",
+      " * ScanAll (n) [estimated rows: 0, cost: 0]", " * Once [estimated rows: 1, cost: 0]"};
   ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
   auto expected_it = expected_rows.begin();
   for (const auto &row : stream.GetResults()) {
@@ -750,19 +1002,49 @@ TEST_F(InterpreterTest, ExplainQueryWithParams) {
   EXPECT_EQ(interpreter_context.ast_cache.size(), 2U);
 }
 
+TEST_F(InterpreterTest, ExplainQueryIndexAlternatives) {
+  Interpret("CREATE INDEX ON :Person;");
+  Interpret("CREATE INDEX ON :Person(name);");
+  Interpret("CREATE (:Person {name: 'a'}), (:Person {name: 'b'});");
+  auto stream = Interpret("EXPLAIN MATCH (n:Person) WHERE n.name = 'a' RETURN n;");
+  std::vector<std::string> expected_rows{
+      " * Produce {n} [estimated rows: 1, cost: 1.1]",
+      " * ScanAllByLabelPropertyValue (n :Person {name}) [estimated rows: 1, cost: 1.1, indices: :Person 2, :Person "
+      "{name} 2 (chosen)]",
+      " * Once [estimated rows: 1, cost: 0]"};
+  ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
+  auto expected_it = expected_rows.begin();
+  for (const auto &row : stream.GetResults()) {
+    ASSERT_EQ(row.size(), 1U);
+    EXPECT_EQ(row.front().ValueString(), *expected_it);
+    ++expected_it;
+  }
+
+  ASSERT_EQ(stream.GetSummary().count("explain"), 1);
+  const auto explain = nlohmann::json::parse(stream.GetSummary().at("explain").ValueString());
+  const auto &scan = explain["input"];
+  EXPECT_EQ(scan["name"], "ScanAllByLabelPropertyValue");
+  EXPECT_DOUBLE_EQ(scan["estimated_rows"].get<double>(), 1);
+  ASSERT_EQ(scan["index_alternatives"].size(), 2);
+  EXPECT_FALSE(scan["index_alternatives"][0]["chosen"].get<bool>());
+  EXPECT_EQ(scan["index_alternatives"][1]["property"], "name");
+  EXPECT_TRUE(scan["index_alternatives"][1]["chosen"].get<bool>());
+}
+
 TEST_F(InterpreterTest, ProfileQuery) {
   const auto &interpreter_context = default_interpreter.interpreter_context;
 
   EXPECT_EQ(interpreter_context.plan_cache.size(), 0U);
   EXPECT_EQ(interpreter_context.ast_cache.size(), 0U);
   auto stream = Interpret("PROFILE MATCH (n) RETURN *;");
-  std::vector<std::string> expected_header{"OPERATOR", "ACTUAL HITS", "RELATIVE TIME", "ABSOLUTE TIME"};
+  std::vector<std::string> expected_header{"OPERATOR",      "ACTUAL HITS",      "RELATIVE TIME",
+                                           "ABSOLUTE TIME", "ALLOCATED MEMORY", "PEAK MEMORY"};
   EXPECT_EQ(stream.GetHeader(), expected_header);
   std::vector<std::string> expected_rows{"* Produce", "* ScanAll", "* Once"};
   ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
   auto expected_it = expected_rows.begin();
   for (const auto &row : stream.GetResults()) {
-    ASSERT_EQ(row.size(), 4U);
+    ASSERT_EQ(row.size(), 6U);
     EXPECT_EQ(row.front().ValueString(), *expected_it);
     ++expected_it;
   }
@@ -781,7 +1063,8 @@ TEST_F(InterpreterTest, ProfileQueryMultiplePulls) {
   EXPECT_EQ(interpreter_context.plan_cache.size(), 0U);
   EXPECT_EQ(interpreter_context.ast_cache.size(), 0U);
   auto [stream, qid] = Prepare("PROFILE MATCH (n) RETURN *;");
-  std::vector<std::string> expected_header{"OPERATOR", "ACTUAL HITS", "RELATIVE TIME", "ABSOLUTE TIME"};
+  std::vector<std::string> expected_header{"OPERATOR",      "ACTUAL HITS",      "RELATIVE TIME",
+                                           "ABSOLUTE TIME", "ALLOCATED MEMORY", "PEAK MEMORY"};
   EXPECT_EQ(stream.GetHeader(), expected_header);
 
   std::vector<std::string> expected_rows{"* Produce", "* ScanAll", "* Once"};
@@ -789,19 +1072,19 @@ TEST_F(InterpreterTest, ProfileQueryMultiplePulls) {
 
   Pull(&stream, 1);
   ASSERT_EQ(stream.GetResults().size(), 1U);
-  ASSERT_EQ(stream.GetResults()[0].size(), 4U);
+  ASSERT_EQ(stream.GetResults()[0].size(), 6U);
   ASSERT_EQ(stream.GetResults()[0][0].ValueString(), *expected_it);
   ++expected_it;
 
   Pull(&stream, 1);
   ASSERT_EQ(stream.GetResults().size(), 2U);
-  ASSERT_EQ(stream.GetResults()[1].size(), 4U);
+  ASSERT_EQ(stream.GetResults()[1].size(), 6U);
   ASSERT_EQ(stream.GetResults()[1][0].ValueString(), *expected_it);
   ++expected_it;
 
   Pull(&stream);
   ASSERT_EQ(stream.GetResults().size(), 3U);
-  ASSERT_EQ(stream.GetResults()[2].size(), 4U);
+  ASSERT_EQ(stream.GetResults()[2].size(), 6U);
   ASSERT_EQ(stream.GetResults()[2][0].ValueString(), *expected_it);
 
   // We should have a plan cache for MATCH ...
@@ -826,13 +1109,14 @@ TEST_F(InterpreterTest, ProfileQueryWithParams) {
   EXPECT_EQ(interpreter_context.ast_cache.size(), 0U);
   auto stream =
       Interpret("PROFILE MATCH (n) WHERE n.id = $id RETURN *;", {{"id", memgraph::storage::PropertyValue(42)}});
-  std::vector<std::string> expected_header{"OPERATOR", "ACTUAL HITS", "RELATIVE TIME", "ABSOLUTE TIME"};
+  std::vector<std::string> expected_header{"OPERATOR",      "ACTUAL HITS",      "RELATIVE TIME",
+                                           "ABSOLUTE TIME", "ALLOCATED MEMORY", "PEAK MEMORY"};
   EXPECT_EQ(stream.GetHeader(), expected_header);
   std::vector<std::string> expected_rows{"* Produce", "* Filter", "* ScanAll", "* Once"};
   ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
   auto expected_it = expected_rows.begin();
   for (const auto &row : stream.GetResults()) {
-    ASSERT_EQ(row.size(), 4U);
+    ASSERT_EQ(row.size(), 6U);
     EXPECT_EQ(row.front().ValueString(), *expected_it);
     ++expected_it;
   }
@@ -845,19 +1129,28 @@ TEST_F(InterpreterTest, ProfileQueryWithParams) {
   EXPECT_EQ(interpreter_context.ast_cache.size(), 2U);
 }
 
+TEST_F(InterpreterTest, UnwindCreateFollowedByMerge) {
+  // MERGE must see only the nodes created for the rows before it, so they
+  // can't be created in a batch ahead of the rows.
+  auto stream = Interpret("UNWIND [1, 2] AS x CREATE (n) MERGE (m) RETURN count(*) AS c");
+  ASSERT_EQ(stream.GetResults().size(), 1U);
+  EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 3);
+}
+
 TEST_F(InterpreterTest, ProfileQueryWithLiterals) {
   const auto &interpreter_context = default_interpreter.interpreter_context;
 
   EXPECT_EQ(interpreter_context.plan_cache.size(), 0U);
   EXPECT_EQ(interpreter_context.ast_cache.size(), 0U);
   auto stream = Interpret("PROFILE UNWIND range(1, 1000) AS x CREATE (:Node {id: x});", {});
-  std::vector<std::string> expected_header{"OPERATOR", "ACTUAL HITS", "RELATIVE TIME", "ABSOLUTE TIME"};
+  std::vector<std::string> expected_header{"OPERATOR",      "ACTUAL HITS",      "RELATIVE TIME",
+                                           "ABSOLUTE TIME", "ALLOCATED MEMORY", "PEAK MEMORY"};
   EXPECT_EQ(stream.GetHeader(), expected_header);
-  std::vector<std::string> expected_rows{"* EmptyResult", "* CreateNode", "* Unwind", "* Once"};
+  std::vector<std::string> expected_rows{"* EmptyResult", "* UnwindCreateNode", "* Once"};
   ASSERT_EQ(stream.GetResults().size(), expected_rows.size());
   auto expected_it = expected_rows.begin();
   for (const auto &row : stream.GetResults()) {
-    ASSERT_EQ(row.size(), 4U);
+    ASSERT_EQ(row.size(), 6U);
     EXPECT_EQ(row.front().ValueString(), *expected_it);
     ++expected_it;
   }
@@ -870,6 +1163,18 @@ TEST_F(InterpreterTest, ProfileQueryWithLiterals) {
   EXPECT_EQ(interpreter_context.ast_cache.size(), 2U);
 }
 
+TEST_F(InterpreterTest, ProfileQueryMemory) {
+  auto stream = Interpret("PROFILE UNWIND range(1, 1000) AS x RETURN x % 10 AS k, collect(x) AS xs;");
+  const auto &results = stream.GetResults();
+  ASSERT_EQ(results.size(), 4U);
+  EXPECT_EQ(results[1][0].ValueString(), "* Aggregate");
+  // The groups and the collected lists are allocated by the aggregation.
+  EXPECT_NE(results[1][4].ValueString(), "0B");
+  EXPECT_NE(results[1][5].ValueString(), "0B");
+  EXPECT_EQ(results[3][0].ValueString(), "* Once");
+  EXPECT_EQ(results[3][4].ValueString(), "0B");
+}
+
 TEST_F(InterpreterTest, Transactions) {
   auto &interpreter = default_interpreter.interpreter;
   {
@@ -1498,3 +1803,45 @@ TEST_F(InterpreterTest, LoadCsvClauseNotification) {
             "conversion functions such as ToInteger, ToFloat, ToBoolean etc.");
   ASSERT_EQ(notification["description"].ValueString(), "");
 }
+
+TEST(InterpreterDeferredCommitTest, ReadOnlyCommitKeepsDeferredFlush) {
+  const auto storage_directory =
+      std::filesystem::temp_directory_path() / "MG_tests_unit_interpreter_deferred_commit";
+  std::filesystem::remove_all(storage_directory);
+  {
+    memgraph::storage::Storage db(
+        {.durability = {.storage_directory = storage_directory,
+                        .snapshot_wal_mode =
+                            memgraph::storage::Config::Durability::SnapshotWalMode::PERIODIC_SNAPSHOT_WITH_WAL,
+                        .snapshot_interval = std::chrono::minutes(20)}});
+    InterpreterFaker faker(&db, {}, storage_directory);
+
+    const auto wal_size = [&] {
+      uint64_t size = 0;
+      for (const auto &item :
+           std::filesystem::directory_iterator(storage_directory / memgraph::storage::durability::kWalDirectory)) {
+        size += std::filesystem::file_size(item.path());
+      }
+      return size;
+    };
+
+    // The pipelined writes only append to the WAL buffer.
+    faker.interpreter.SetDeferCommitFlush(true);
+    faker.Interpret("CREATE (:Node {id: 1})");
+    faker.Interpret("CREATE (:Node {id: 2})");
+    const auto size_before = wal_size();
+
+    // The last pipelined message is read-only, so its commit doesn't write
+    // the WAL buffer.
+    faker.interpreter.SetDeferCommitFlush(false);
+    auto stream = faker.Interpret("MATCH (n:Node) RETURN count(n)");
+    ASSERT_EQ(stream.GetResults().size(), 1U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 2);
+    EXPECT_EQ(wal_size(), size_before);
+
+    // The deferred commits are written before they are acknowledged.
+    faker.interpreter.FlushDeferredCommits();
+    EXPECT_GT(wal_size(), size_before);
+  }
+  std::filesystem::remove_all(storage_directory);
+}
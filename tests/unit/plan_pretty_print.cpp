@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -663,6 +663,7 @@ TEST_F(PrintToJsonTest, Aggregate) {
               "(PropertyLookup (Identifier \"node\") \"type\")"
             ],
             "remember" : ["node"],
+            "ordered_group_by" : null,
             "input" : {
               "name" : "ScanAll",
               "output_symbol" : "node",
@@ -713,6 +714,7 @@ TEST_F(PrintToJsonTest, AggregateWithDistinct) {
               "(PropertyLookup (Identifier \"node\") \"type\")"
             ],
             "remember" : ["node"],
+            "ordered_group_by" : null,
             "input" : {
               "name" : "ScanAll",
               "output_symbol" : "node",
@@ -818,6 +820,49 @@ TEST_F(PrintToJsonTest, Merge) {
           })sep");
 }
 
+TEST_F(PrintToJsonTest, MergeByLabelProperty) {
+  Symbol node_sym = GetSymbol("node");
+  memgraph::storage::LabelId label = dba.NameToLabel("label");
+  memgraph::storage::PropertyId prop = dba.NameToProperty("prop");
+
+  std::shared_ptr<LogicalOperator> match =
+      std::make_shared<ScanAllByLabelPropertyValue>(nullptr, node_sym, label, prop, "prop", LITERAL(42));
+
+  std::shared_ptr<LogicalOperator> create =
+      std::make_shared<CreateNode>(nullptr, NodeCreationInfo{node_sym, {label}, {{prop, LITERAL(42)}}});
+
+  std::shared_ptr<LogicalOperator> last_op =
+      std::make_shared<MergeByLabelProperty>(nullptr, match, create, label, prop, LITERAL(42));
+
+  Check(last_op.get(), R"sep(
+          {
+            "name" : "MergeByLabelProperty",
+            "label" : "label",
+            "property" : "prop",
+            "expression" : "42",
+            "input" : { "name" : "Once" },
+            "merge_match" : {
+              "name" : "ScanAllByLabelPropertyValue",
+              "label" : "label",
+              "property" : "prop",
+              "expression" : "42",
+              "output_symbol" : "node",
+              "input" : { "name" : "Once" }
+            },
+            "merge_create" : {
+              "name" : "CreateNode",
+              "node_info" : {
+                "symbol" : "node",
+                "labels" : ["label"],
+                "properties" : {
+                  "prop" : "42"
+                }
+              },
+              "input" : { "name" : "Once" }
+            }
+          })sep");
+}
+
 TEST_F(PrintToJsonTest, Optional) {
   Symbol node1_sym = GetSymbol("node1");
   Symbol node2_sym = GetSymbol("node2");
@@ -854,6 +899,75 @@ TEST_F(PrintToJsonTest, Optional) {
           })sep");
 }
 
+TEST_F(PrintToJsonTest, SemiApply) {
+  Symbol node1_sym = GetSymbol("node1");
+  Symbol node2_sym = GetSymbol("node2");
+  Symbol edge_sym = GetSymbol("edge");
+
+  std::shared_ptr<LogicalOperator> input = std::make_shared<ScanAll>(nullptr, node1_sym);
+
+  std::shared_ptr<LogicalOperator> expand =
+      std::make_shared<Expand>(nullptr, node1_sym, node2_sym, edge_sym, EdgeAtom::Direction::OUT,
+                               std::vector<memgraph::storage::EdgeTypeId>{}, false, memgraph::storage::View::OLD);
+
+  std::shared_ptr<LogicalOperator> last_op = std::make_shared<SemiApply>(input, expand, true);
+
+  Check(last_op.get(), R"sep(
+          {
+            "name" : "AntiSemiApply",
+            "input" : {
+              "name" : "ScanAll",
+              "output_symbol" : "node1",
+              "input" : { "name" : "Once" }
+            },
+            "subplan" : {
+              "name" : "Expand",
+              "input_symbol" : "node1",
+              "node_symbol" : "node2",
+              "edge_symbol" : "edge",
+              "direction" : "out",
+              "edge_types" : null,
+              "existing_node" : false,
+              "input" : { "name" : "Once" }
+            }
+          })sep");
+}
+
+TEST_F(PrintToJsonTest, Apply) {
+  std::shared_ptr<LogicalOperator> input =
+      std::make_shared<plan::Unwind>(nullptr, LIST(LITERAL(1), LITERAL(2), LITERAL(3)), GetSymbol("x"));
+  std::shared_ptr<LogicalOperator> subquery = std::make_shared<CreateNode>(
+      nullptr,
+      NodeCreationInfo{GetSymbol("node"), {dba.NameToLabel("Label")}, {{dba.NameToProperty("prop"), LITERAL(5)}}});
+
+  std::shared_ptr<LogicalOperator> last_op = std::make_shared<Apply>(input, subquery, false, true, LITERAL(10));
+
+  Check(last_op.get(), R"sep(
+          {
+            "name" : "Apply",
+            "subquery_has_return" : false,
+            "in_transactions" : true,
+            "batch_size" : "10",
+            "input" : {
+              "name" : "Unwind",
+              "output_symbol" : "x",
+              "input_expression" : "(ListLiteral [1, 2, 3])",
+              "input" : { "name" : "Once" }
+            },
+            "subquery" : {
+              "name" : "CreateNode",
+              "node_info" : {
+                "symbol" : "node",
+                "labels" : ["Label"],
+                "properties" : {
+                  "prop" : "5"
+                }
+              },
+              "input" : { "name" : "Once" }
+            }
+          })sep");
+}
+
 TEST_F(PrintToJsonTest, Unwind) {
   std::shared_ptr<LogicalOperator> last_op =
       std::make_shared<plan::Unwind>(nullptr, LIST(LITERAL(1), LITERAL(2), LITERAL(3)), GetSymbol("x"));
@@ -995,3 +1109,37 @@ TEST_F(PrintToJsonTest, Foreach) {
            }
           })sep");
 }
+
+TEST_F(PrintToJsonTest, Estimates) {
+  const auto label = dba.NameToLabel("Label");
+  const auto property = dba.NameToProperty("prop");
+  std::shared_ptr<LogicalOperator> last_op = std::make_shared<ScanAllByLabel>(nullptr, GetSymbol("node"), label);
+  OperatorEstimator estimator = [&](LogicalOperator &op) {
+    if (dynamic_cast<ScanAllByLabel *>(&op)) {
+      return OperatorEstimates{10, 11, {{label, std::nullopt, 10, true}, {label, property, 4, false}}};
+    }
+    return OperatorEstimates{1, 0, {}};
+  };
+
+  memgraph::query::DbAccessor query_dba(&dba);
+  EXPECT_EQ(PlanToJson(query_dba, last_op.get(), estimator), json::parse(R"(
+          {
+            "name" : "ScanAllByLabel",
+            "label" : "Label",
+            "output_symbol" : "node",
+            "estimated_rows" : 10.0,
+            "estimated_cost" : 11.0,
+            "index_alternatives" : [
+              { "label" : "Label", "property" : null, "vertices_count" : 10, "chosen" : true },
+              { "label" : "Label", "property" : "prop", "vertices_count" : 4, "chosen" : false }
+            ],
+            "input" : { "name" : "Once", "estimated_rows" : 1.0, "estimated_cost" : 0.0 }
+          })"));
+
+  std::stringstream printed;
+  PrettyPrint(query_dba, last_op.get(), estimator, &printed);
+  EXPECT_EQ(printed.str(),
+            " * ScanAllByLabel (node :Label) [estimated rows: 10, cost: 11, indices: :Label 10 (chosen), :Label {prop} "
+            "4]\n"
+            " * Once [estimated rows: 1, cost: 0]\n");
+}
@@ -0,0 +1,253 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "query/admission_control.hpp"
+#include "query/exceptions.hpp"
+#include "utils/exceptions.hpp"
+#include "utils/thread_pool.hpp"
+
+using namespace memgraph::query;
+using namespace std::chrono_literals;
+
+namespace {
+const auto kNoRole = []() -> std::optional<std::string> { return std::nullopt; };
+
+auto After(const std::chrono::steady_clock::duration duration) { return std::chrono::steady_clock::now() + duration; }
+}  // namespace
+
+TEST(AdmissionControlTest, ParseResourcePools) {
+  const auto pools = ParseResourcePools("oltp:64, reporting:2:1024");
+  ASSERT_EQ(pools.size(), 2);
+  EXPECT_EQ(pools[0].name, "oltp");
+  EXPECT_EQ(pools[0].max_concurrent_queries, 64);
+  EXPECT_FALSE(pools[0].memory_limit);
+  EXPECT_EQ(pools[1].name, "reporting");
+  EXPECT_EQ(pools[1].max_concurrent_queries, 2);
+  EXPECT_EQ(pools[1].memory_limit, 1024UL * 1024 * 1024);
+  EXPECT_TRUE(ParseResourcePools("").empty());
+
+  for (const auto *invalid : {"oltp", "oltp:0", "oltp:x", ":1", "oltp:1,oltp:2", "oltp:1:0", "oltp:1:2:3"}) {
+    EXPECT_THROW(ParseResourcePools(invalid), memgraph::utils::BasicException) << invalid;
+  }
+}
+
+TEST(AdmissionControlTest, ParseResourcePoolAssignments) {
+  const auto assignments = ParseResourcePoolAssignments("alice=reporting, role:analyst=reporting:-1,bob=oltp:5");
+  ASSERT_EQ(assignments.users.size(), 2);
+  EXPECT_EQ(assignments.users.at("alice").pool, "reporting");
+  EXPECT_EQ(assignments.users.at("alice").priority, 0);
+  EXPECT_EQ(assignments.users.at("bob").pool, "oltp");
+  EXPECT_EQ(assignments.users.at("bob").priority, 5);
+  ASSERT_EQ(assignments.roles.size(), 1);
+  EXPECT_EQ(assignments.roles.at("analyst").pool, "reporting");
+  EXPECT_EQ(assignments.roles.at("analyst").priority, -1);
+
+  for (const auto *invalid : {"alice", "alice=", "=oltp", "role:=oltp", "alice=oltp:x", "alice=a,alice=b"}) {
+    EXPECT_THROW(ParseResourcePoolAssignments(invalid), memgraph::utils::BasicException) << invalid;
+  }
+}
+
+TEST(AdmissionControlTest, Disabled) {
+  AdmissionController controller({}, {});
+  EXPECT_FALSE(controller.Enabled());
+  const auto ticket = controller.Admit(nullptr, kNoRole, After(0s), nullptr);
+  EXPECT_FALSE(ticket.memory_limit());
+}
+
+TEST(AdmissionControlTest, Assignment) {
+  AdmissionController controller(ParseResourcePools("default:1,reporting:1:100"),
+                                 ParseResourcePoolAssignments("alice=reporting,role:analyst=reporting"));
+  const std::string alice = "alice";
+  const std::string bob = "bob";
+  const auto analyst = []() -> std::optional<std::string> { return "analyst"; };
+
+  // Users without a pool share the default one.
+  auto anonymous_ticket = controller.Admit(nullptr, kNoRole, After(1s), nullptr);
+  EXPECT_FALSE(anonymous_ticket.memory_limit());
+  EXPECT_THROW(controller.Admit(&bob, kNoRole, After(10ms), nullptr), AdmissionTimeoutException);
+
+  // The reporting pool is assigned by user and by role.
+  auto alice_ticket = controller.Admit(&alice, kNoRole, After(1s), nullptr);
+  EXPECT_EQ(alice_ticket.memory_limit(), 100UL * 1024 * 1024);
+  EXPECT_THROW(controller.Admit(&bob, analyst, After(10ms), nullptr), AdmissionTimeoutException);
+  alice_ticket = {};
+  const auto analyst_ticket = controller.Admit(&bob, analyst, After(1s), nullptr);
+
+  const auto statistics = controller.Statistics();
+  ASSERT_EQ(statistics.size(), 2);
+  EXPECT_EQ(statistics[0].config.name, "default");
+  EXPECT_EQ(statistics[0].running, 1);
+  EXPECT_EQ(statistics[0].admitted, 1);
+  EXPECT_EQ(statistics[0].timed_out, 1);
+  EXPECT_EQ(statistics[1].config.name, "reporting");
+  EXPECT_EQ(statistics[1].running, 1);
+  EXPECT_EQ(statistics[1].admitted, 2);
+  EXPECT_EQ(statistics[1].timed_out, 1);
+}
+
+TEST(AdmissionControlTest, PriorityOrder) {
+  AdmissionController controller(ParseResourcePools("default:1"),
+                                 ParseResourcePoolAssignments("low=default:-1,high=default:1"));
+  const std::string low = "low";
+  const std::string high = "high";
+  auto running = std::make_optional(controller.Admit(nullptr, kNoRole, After(1s), nullptr));
+
+  std::mutex order_lock;
+  std::vector<std::string> order;
+  auto wait = [&](const std::string *username) {
+    return std::jthread([&, username] {
+      auto ticket = controller.Admit(username, kNoRole, After(10s), nullptr);
+      std::lock_guard guard(order_lock);
+      order.push_back(*username);
+    });
+  };
+  auto low_waiter = wait(&low);
+  while (controller.Statistics()[0].waiting < 1) std::this_thread::yield();
+  auto high_waiter = wait(&high);
+  while (controller.Statistics()[0].waiting < 2) std::this_thread::yield();
+
+  running.reset();
+  low_waiter.join();
+  high_waiter.join();
+  EXPECT_EQ(order, (std::vector<std::string>{"high", "low"}));
+
+  const auto statistics = controller.Statistics()[0];
+  EXPECT_EQ(statistics.running, 0);
+  EXPECT_EQ(statistics.waiting, 0);
+  EXPECT_EQ(statistics.admitted, 3);
+  EXPECT_EQ(statistics.queued, 2);
+  EXPECT_GT(statistics.max_wait.count(), 0);
+}
+
+TEST(AdmissionControlTest, Abort) {
+  AdmissionController controller(ParseResourcePools("default:1"), {});
+  const auto running = controller.Admit(nullptr, kNoRole, After(1s), nullptr);
+  std::atomic<bool> abort{true};
+  EXPECT_THROW(controller.Admit(nullptr, kNoRole, After(10s), &abort), HintedAbortError);
+  EXPECT_EQ(controller.Statistics()[0].waiting, 0);
+}
+
+TEST(AdmissionControlTest, PendingAdmission) {
+  AdmissionController controller(ParseResourcePools("default:1"), {});
+  auto running = std::make_optional(controller.Admit(nullptr, kNoRole, After(1s), nullptr));
+
+  auto result = controller.TryAdmit(nullptr, kNoRole, After(10s), nullptr);
+  ASSERT_TRUE(std::holds_alternative<AdmissionController::PendingAdmission>(result));
+  auto &pending = std::get<AdmissionController::PendingAdmission>(result);
+  EXPECT_FALSE(controller.TakeTicket(&pending));
+  std::promise<void> ready;
+  pending.OnReady([&] { ready.set_value(); });
+  EXPECT_EQ(controller.Statistics()[0].waiting, 1);
+
+  // The freed slot is reserved for the pending query.
+  running.reset();
+  ASSERT_EQ(ready.get_future().wait_for(10s), std::future_status::ready);
+  EXPECT_THROW(controller.Admit(nullptr, kNoRole, After(10ms), nullptr), AdmissionTimeoutException);
+  auto ticket = controller.TakeTicket(&pending);
+  ASSERT_TRUE(ticket);
+
+  const auto statistics = controller.Statistics()[0];
+  EXPECT_EQ(statistics.running, 1);
+  EXPECT_EQ(statistics.waiting, 0);
+  EXPECT_EQ(statistics.admitted, 2);
+  EXPECT_EQ(statistics.queued, 1);
+}
+
+TEST(AdmissionControlTest, PendingAdmissionTimeout) {
+  AdmissionController controller(ParseResourcePools("default:1"), {});
+  const auto running = controller.Admit(nullptr, kNoRole, After(1s), nullptr);
+
+  auto result = controller.TryAdmit(nullptr, kNoRole, After(10ms), nullptr);
+  auto &pending = std::get<AdmissionController::PendingAdmission>(result);
+  std::promise<void> ready;
+  pending.OnReady([&] { ready.set_value(); });
+  ASSERT_EQ(ready.get_future().wait_for(10s), std::future_status::ready);
+  EXPECT_THROW(controller.TakeTicket(&pending), AdmissionTimeoutException);
+  EXPECT_EQ(controller.Statistics()[0].waiting, 0);
+  EXPECT_EQ(controller.Statistics()[0].timed_out, 1);
+}
+
+TEST(AdmissionControlTest, CancelledPendingAdmission) {
+  AdmissionController controller(ParseResourcePools("default:1"), {});
+  auto running = std::make_optional(controller.Admit(nullptr, kNoRole, After(1s), nullptr));
+
+  // A query which stops waiting gives up its place, and one which stops after
+  // it was admitted frees its slot.
+  auto waiting = controller.TryAdmit(nullptr, kNoRole, After(10s), nullptr);
+  auto admitted = controller.TryAdmit(nullptr, kNoRole, After(10s), nullptr);
+  EXPECT_EQ(controller.Statistics()[0].waiting, 2);
+  waiting = AdmissionController::Ticket{};
+  running.reset();
+  EXPECT_EQ(controller.Statistics()[0].running, 1);
+  admitted = AdmissionController::Ticket{};
+  EXPECT_EQ(controller.Statistics()[0].running, 0);
+  EXPECT_EQ(controller.Statistics()[0].waiting, 0);
+}
+
+TEST(AdmissionControlTest, MoreWaitersThanWorkers) {
+  // Each session runs a query in two steps on a shared pool of workers, like
+  // the RUN and the PULL of a Bolt session, and holds its slot in between.
+  // The waiting sessions must not take up the workers which the admitted ones
+  // need to finish.
+  constexpr size_t kWorkers = 2;
+  constexpr int kSessions = 16;
+  AdmissionController controller(ParseResourcePools("default:1"), {});
+  memgraph::utils::ThreadPool workers(kWorkers);
+  std::atomic<int> finished{0};
+  std::promise<void> all_finished;
+
+  struct Session {
+    std::optional<AdmissionController::PendingAdmission> pending;
+    std::optional<AdmissionController::Ticket> ticket;
+  };
+  std::vector<Session> sessions(kSessions);
+
+  std::function<void(Session *)> run = [&](Session *session) {
+    if (!session->pending) {
+      auto result = controller.TryAdmit(nullptr, kNoRole, After(60s), nullptr);
+      if (auto *ticket = std::get_if<AdmissionController::Ticket>(&result)) {
+        session->ticket.emplace(std::move(*ticket));
+      } else {
+        session->pending.emplace(std::get<AdmissionController::PendingAdmission>(std::move(result)));
+      }
+    } else if (auto ticket = controller.TakeTicket(&*session->pending)) {
+      session->pending.reset();
+      session->ticket.emplace(std::move(*ticket));
+    }
+    if (session->pending) {
+      session->pending->OnReady([&, session] { workers.AddTask([&, session] { run(session); }); });
+      return;
+    }
+    workers.AddTask([&, session] {
+      session->ticket.reset();
+      if (++finished == kSessions) all_finished.set_value();
+    });
+  };
+  for (auto &session : sessions) {
+    workers.AddTask([&, session = &session] { run(session); });
+  }
+
+  ASSERT_EQ(all_finished.get_future().wait_for(60s), std::future_status::ready);
+  workers.Shutdown();
+  const auto statistics = controller.Statistics()[0];
+  EXPECT_EQ(statistics.running, 0);
+  EXPECT_EQ(statistics.admitted, kSessions);
+  EXPECT_GT(statistics.queued, 0);
+}
@@ -468,6 +468,15 @@ auto GetForeach(AstStorage &storage, NamedExpression *named_expr, const std::vec
   return storage.Create<query::Foreach>(named_expr, clauses);
 }
 
+/// Create the CALL { ... } clause with given subquery.
+auto GetCallSubquery(AstStorage &storage, SingleQuery *single_query, bool in_transactions = false,
+                     Expression *batch_size = nullptr) {
+  auto *call_subquery = storage.Create<query::CallSubquery>(single_query);
+  call_subquery->in_transactions_ = in_transactions;
+  call_subquery->batch_size_ = batch_size;
+  return call_subquery;
+}
+
 }  // namespace test_common
 
 }  // namespace memgraph::query
@@ -539,11 +548,13 @@ auto GetForeach(AstStorage &storage, NamedExpression *named_expr, const std::vec
 #define UNION(...) memgraph::query::test_common::GetCypherUnion(storage.Create<CypherUnion>(true), __VA_ARGS__)
 #define UNION_ALL(...) memgraph::query::test_common::GetCypherUnion(storage.Create<CypherUnion>(false), __VA_ARGS__)
 #define FOREACH(...) memgraph::query::test_common::GetForeach(storage, __VA_ARGS__)
+#define CALL_SUBQUERY(...) memgraph::query::test_common::GetCallSubquery(storage, __VA_ARGS__)
 // Various operators
 #define NOT(expr) storage.Create<memgraph::query::NotOperator>((expr))
 #define UPLUS(expr) storage.Create<memgraph::query::UnaryPlusOperator>((expr))
 #define UMINUS(expr) storage.Create<memgraph::query::UnaryMinusOperator>((expr))
 #define IS_NULL(expr) storage.Create<memgraph::query::IsNullOperator>((expr))
+#define EXISTS(pattern) storage.Create<memgraph::query::Exists>((pattern))
 #define ADD(expr1, expr2) storage.Create<memgraph::query::AdditionOperator>((expr1), (expr2))
 #define LESS(expr1, expr2) storage.Create<memgraph::query::LessOperator>((expr1), (expr2))
 #define LESS_EQ(expr1, expr2) storage.Create<memgraph::query::LessEqualOperator>((expr1), (expr2))
@@ -79,6 +79,12 @@ class QueryCostEstimator : public ::testing::Test {
     return cost_estimator.cost();
   }
 
+  auto Cardinality() {
+    CostEstimator<memgraph::query::DbAccessor> cost_estimator(&*dba, parameters_);
+    last_op_->Accept(cost_estimator);
+    return cost_estimator.cardinality();
+  }
+
   template <typename TLogicalOperator, typename... TArgs>
   void MakeOp(TArgs... args) {
     last_op_ = std::make_shared<TLogicalOperator>(args...);
@@ -174,6 +180,74 @@ TEST_F(QueryCostEstimator, Expand) {
   EXPECT_COST(CardParam::kExpand * CostParam::kExpand);
 }
 
+TEST_F(QueryCostEstimator, ExpandWithGraphStatistics) {
+  auto edge_type = db.NameToEdgeType("edge_type");
+  auto from = dba->InsertVertex();
+  auto to = dba->InsertVertex();
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(dba->InsertEdge(&from, &to, edge_type).HasValue());
+  }
+  dba->AdvanceCommand();
+  dba->AnalyzeGraph();
+  // 8 edges of the type on 2 vertices, so 4 per vertex in a single direction
+  MakeOp<Expand>(last_op_, NextSymbol(), NextSymbol(), NextSymbol(), EdgeAtom::Direction::OUT,
+                 std::vector<memgraph::storage::EdgeTypeId>{edge_type}, false, memgraph::storage::View::OLD);
+  EXPECT_COST(4 * CostParam::kExpand);
+  MakeOp<Expand>(std::make_shared<Once>(), NextSymbol(), NextSymbol(), NextSymbol(), EdgeAtom::Direction::BOTH,
+                 std::vector<memgraph::storage::EdgeTypeId>{}, false, memgraph::storage::View::OLD);
+  EXPECT_COST(8 * CostParam::kExpand);
+}
+
+TEST_F(QueryCostEstimator, ExpandWithLabelStatistics) {
+  auto edge_type = db.NameToEdgeType("edge_type");
+  auto from = dba->InsertVertex();
+  ASSERT_TRUE(from.AddLabel(label).HasValue());
+  auto to = dba->InsertVertex();
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(dba->InsertEdge(&from, &to, edge_type).HasValue());
+  }
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(dba->InsertEdge(&to, &from, edge_type).HasValue());
+  }
+  dba->AdvanceCommand();
+  dba->AnalyzeGraph();
+  // the single labeled vertex has 8 outgoing and 2 incoming edges
+  auto scan = std::make_shared<ScanAllByLabel>(last_op_, NextSymbol(), label);
+  MakeOp<Expand>(scan, scan->output_symbol_, NextSymbol(), NextSymbol(), EdgeAtom::Direction::OUT,
+                 std::vector<memgraph::storage::EdgeTypeId>{}, false, memgraph::storage::View::OLD);
+  EXPECT_FLOAT_EQ(Cardinality(), 8);
+  MakeOp<Expand>(scan, scan->output_symbol_, NextSymbol(), NextSymbol(), EdgeAtom::Direction::IN,
+                 std::vector<memgraph::storage::EdgeTypeId>{}, false, memgraph::storage::View::OLD);
+  EXPECT_FLOAT_EQ(Cardinality(), 2);
+}
+
+TEST_F(QueryCostEstimator, ScanAllById) {
+  MakeOp<ScanAllById>(last_op_, NextSymbol(), Literal(0));
+  EXPECT_COST(CostParam::kScanAllById);
+}
+
+TEST_F(QueryCostEstimator, FilterWithGraphStatistics) {
+  AddVertices(100, 100, 100);
+  dba->AnalyzeGraph();
+  auto symbol = NextSymbol();
+  MakeOp<ScanAllByLabel>(last_op_, symbol, label);
+  auto *lookup = storage_.Create<PropertyLookup>(storage_.Create<Identifier>("n")->MapTo(symbol),
+                                                 storage_.GetPropertyIx("property"));
+  auto scan = last_op_;
+  MakeOp<Filter>(scan, storage_.Create<EqualOperator>(lookup, Literal(42)));
+  EXPECT_COST(100 * CostParam::kScanAllByLabel + 100 * CostParam::kFilter);
+  EXPECT_NEAR(Cardinality(), 1, 0.5);
+  MakeOp<Filter>(scan, storage_.Create<GreaterEqualOperator>(lookup, Literal(50)));
+  EXPECT_NEAR(Cardinality(), 50, 5);
+  // filters which the statistics don't cover fall back to the constant selectivity
+  MakeOp<Filter>(scan, storage_.Create<EqualOperator>(Literal(1), Literal(42)));
+  EXPECT_FLOAT_EQ(Cardinality(), 100 * CardParam::kFilter);
+  // so do labels which weren't there when the statistics were collected
+  auto *identifier = storage_.Create<Identifier>("n")->MapTo(symbol);
+  MakeOp<Filter>(scan, storage_.Create<LabelsTest>(identifier, std::vector<LabelIx>{storage_.GetLabelIx("missing")}));
+  EXPECT_FLOAT_EQ(Cardinality(), 100 * CardParam::kFilter);
+}
+
 TEST_F(QueryCostEstimator, ExpandVariable) {
   MakeOp<ExpandVariable>(last_op_, NextSymbol(), NextSymbol(), NextSymbol(), EdgeAtom::Type::DEPTH_FIRST,
                          EdgeAtom::Direction::IN, std::vector<memgraph::storage::EdgeTypeId>{}, false, nullptr, nullptr,
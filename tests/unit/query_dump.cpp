@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -207,7 +207,7 @@ auto Execute(memgraph::storage::Storage *db, const std::string &query) {
   memgraph::query::Interpreter interpreter(&context);
   ResultStreamFaker stream(db);
 
-  auto [header, _, qid] = interpreter.Prepare(query, {}, nullptr);
+  auto [header, _, qid, statement_id] = interpreter.Prepare(query, {}, nullptr);
   stream.Header(header);
   auto summary = interpreter.PullAll(&stream);
   stream.Summary(summary);
@@ -763,7 +763,7 @@ class StatefulInterpreter {
   auto Execute(const std::string &query) {
     ResultStreamFaker stream(db_);
 
-    auto [header, _, qid] = interpreter_.Prepare(query, {}, nullptr);
+    auto [header, _, qid, statement_id] = interpreter_.Prepare(query, {}, nullptr);
     stream.Header(header);
     auto summary = interpreter_.PullAll(&stream);
     stream.Summary(summary);
@@ -37,6 +37,7 @@ namespace memgraph::query {
 }  // namespace memgraph::query
 
 using namespace memgraph::query::plan;
+using memgraph::query::Aggregation;
 using memgraph::query::AstStorage;
 using memgraph::query::SingleQuery;
 using memgraph::query::Symbol;
@@ -142,6 +143,36 @@ TYPED_TEST(TestPlanner, CreateNodeExpandNode) {
                        ExpectEmptyResult());
 }
 
+TYPED_TEST(TestPlanner, UnwindCreateNode) {
+  // Test UNWIND [1, 2] AS x CREATE (n {prop: x}) -[r :rel]-> (m), (l)
+  AstStorage storage;
+  FakeDbAccessor dba;
+  auto relationship = "rel";
+  auto node_n = NODE("n");
+  std::get<0>(node_n->properties_)[storage.GetPropertyIx("prop")] = IDENT("x");
+  auto *query = QUERY(SINGLE_QUERY(UNWIND(LIST(LITERAL(1), LITERAL(2)), AS("x")),
+                                   CREATE(PATTERN(node_n, EDGE("r", Direction::OUT, {relationship}), NODE("m")),
+                                          PATTERN(NODE("l")))));
+  CheckPlan<TypeParam>(query, storage, ExpectUnwindCreateNode(), ExpectCreateExpand(), ExpectCreateNode(),
+                       ExpectEmptyResult());
+}
+
+TYPED_TEST(TestPlanner, UnwindCreateNodeFollowedByMerge) {
+  // Test UNWIND [1, 2] AS x CREATE (n) MERGE (m)
+  AstStorage storage;
+  FakeDbAccessor dba;
+  auto *query = QUERY(SINGLE_QUERY(UNWIND(LIST(LITERAL(1), LITERAL(2)), AS("x")), CREATE(PATTERN(NODE("n"))),
+                                   MERGE(PATTERN(NODE("m")))));
+  // MERGE reads the nodes created for the previous rows, so they aren't
+  // created in a batch.
+  std::list<BaseOpChecker *> on_match{new ExpectScanAll()};
+  std::list<BaseOpChecker *> on_create{new ExpectCreateNode()};
+  CheckPlan<TypeParam>(query, storage, ExpectUnwind(), ExpectCreateNode(), ExpectMerge(on_match, on_create),
+                       ExpectEmptyResult());
+  DeleteListContent(&on_match);
+  DeleteListContent(&on_create);
+}
+
 TYPED_TEST(TestPlanner, CreateNamedPattern) {
   // Test CREATE p = (n) -[r :rel]-> (m)
   AstStorage storage;
@@ -755,6 +786,184 @@ TYPED_TEST(TestPlanner, MatchWhereBeforeExpand) {
   CheckPlan(planner.plan(), symbol_table, ExpectScanAll(), ExpectFilter(), ExpectExpand(), ExpectProduce());
 }
 
+TYPED_TEST(TestPlanner, MatchWherePatternPredicate) {
+  // Test MATCH (n) WHERE n.prop < 42 AND (n) --> () RETURN n
+  FakeDbAccessor dba;
+  auto prop = dba.Property("prop");
+  AstStorage storage;
+  auto *predicate = EXISTS(PATTERN(NODE("n"), storage.Create<EdgeAtom>(storage.Create<Identifier>("anon_r", false),
+                                                                         EdgeAtom::Type::SINGLE, EdgeAtom::Direction::OUT),
+                                   storage.Create<NodeAtom>(storage.Create<Identifier>("anon_m", false))));
+  auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n"))),
+                                   WHERE(AND(LESS(PROPERTY_LOOKUP("n", prop), LITERAL(42)), predicate)), RETURN("n")));
+  auto symbol_table = memgraph::query::MakeSymbolTable(query);
+  auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+  // We expect the cheaper Filter to come before the SemiApply.
+  std::list<BaseOpChecker *> subplan{new ExpectExpand()};
+  CheckPlan(planner.plan(), symbol_table, ExpectScanAll(), ExpectFilter(), ExpectSemiApply(false, subplan),
+            ExpectProduce());
+  DeleteListContent(&subplan);
+}
+
+TYPED_TEST(TestPlanner, MatchWhereNegatedPatternPredicate) {
+  // Test MATCH (n), (m) WHERE NOT (n) --> (m) RETURN n
+  FakeDbAccessor dba;
+  AstStorage storage;
+  auto *predicate = EXISTS(PATTERN(NODE("n"), storage.Create<EdgeAtom>(storage.Create<Identifier>("anon_r", false),
+                                                                         EdgeAtom::Type::SINGLE, EdgeAtom::Direction::OUT),
+                                   NODE("m")));
+  auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n")), PATTERN(NODE("m"))), WHERE(NOT(predicate)), RETURN("n")));
+  auto symbol_table = memgraph::query::MakeSymbolTable(query);
+  auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+  // Both endpoints are bound, so the subplan only checks the existence of
+  // the edge between them.
+  std::list<BaseOpChecker *> subplan{new ExpectExpand()};
+  CheckPlan(planner.plan(), symbol_table, ExpectScanAll(), ExpectScanAll(), ExpectSemiApply(true, subplan),
+            ExpectProduce());
+  DeleteListContent(&subplan);
+}
+
+TYPED_TEST(TestPlanner, MatchCallSubquery) {
+  // Test MATCH (n) CALL { WITH n MATCH (n) --> (m) RETURN m } RETURN n, m
+  FakeDbAccessor dba;
+  AstStorage storage;
+  auto *subquery = SINGLE_QUERY(WITH("n"), MATCH(PATTERN(NODE("n"), EDGE("r"), NODE("m"))), RETURN("m"));
+  auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n"))), CALL_SUBQUERY(subquery), RETURN("n", "m")));
+  auto symbol_table = memgraph::query::MakeSymbolTable(query);
+  auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+  std::list<BaseOpChecker *> subquery_plan{new ExpectProduce(), new ExpectExpand(), new ExpectProduce()};
+  CheckPlan(planner.plan(), symbol_table, ExpectScanAll(), ExpectApply(false, subquery_plan), ExpectProduce());
+  DeleteListContent(&subquery_plan);
+}
+
+TYPED_TEST(TestPlanner, UnwindCallSubqueryInTransactions) {
+  // Test UNWIND [1, 2] AS x CALL { WITH x CREATE (n) } IN TRANSACTIONS OF 1 ROWS
+  FakeDbAccessor dba;
+  AstStorage storage;
+  auto *subquery = SINGLE_QUERY(WITH("x"), CREATE(PATTERN(NODE("n"))));
+  auto *unwind = UNWIND(LIST(LITERAL(1), LITERAL(2)), AS("x"));
+  auto *query = QUERY(SINGLE_QUERY(unwind, CALL_SUBQUERY(subquery, true, LITERAL(1))));
+  auto symbol_table = memgraph::query::MakeSymbolTable(query);
+  auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+  // The input is accumulated so it doesn't see the periodically committed
+  // changes.
+  auto acc = ExpectAccumulate({symbol_table.at(*unwind->named_expression_)});
+  std::list<BaseOpChecker *> subquery_plan{new ExpectProduce(), new ExpectCreateNode(), new ExpectEmptyResult()};
+  CheckPlan(planner.plan(), symbol_table, ExpectUnwind(), acc, ExpectApply(true, subquery_plan), ExpectEmptyResult());
+  DeleteListContent(&subquery_plan);
+}
+
+TYPED_TEST(TestPlanner, MatchLabelAggregateFromIndex) {
+  FakeDbAccessor dba;
+  auto label = dba.Label("label");
+  auto prop = PROPERTY_PAIR("prop");
+  auto other_prop = PROPERTY_PAIR("other_prop");
+  dba.SetIndexCount(label, 1);
+  dba.SetIndexCount(label, prop.second, 1);
+  AstStorage storage;
+
+  {
+    // Test MATCH (n :label) RETURN COUNT(*) AS c, COUNT(n) AS cn, MIN(n.prop) AS mi, MAX(n.prop) AS ma
+    auto *count_all = storage.Create<Aggregation>(nullptr, nullptr, Aggregation::Op::COUNT, false);
+    auto *count_n = COUNT(IDENT("n"), false);
+    auto *min = storage.Create<Aggregation>(PROPERTY_LOOKUP("n", prop), nullptr, Aggregation::Op::MIN, false);
+    auto *max = storage.Create<Aggregation>(PROPERTY_LOOKUP("n", prop), nullptr, Aggregation::Op::MAX, false);
+    auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))),
+                                     RETURN(count_all, AS("c"), count_n, AS("cn"), min, AS("mi"), max, AS("ma"))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table,
+              ExpectAggregateFromIndex(
+                  label, {{count_all, std::nullopt}, {count_n, std::nullopt}, {min, prop.second}, {max, prop.second}}),
+              ExpectProduce());
+  }
+
+  {
+    // Test MATCH (n :label) RETURN COUNT(n.prop) AS c
+    auto *count = COUNT(PROPERTY_LOOKUP("n", prop), false);
+    auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))), RETURN(count, AS("c"))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table, ExpectAggregateFromIndex(label, {{count, prop.second}}), ExpectProduce());
+  }
+
+  {
+    // Test MATCH (n :label) RETURN MIN(n.other_prop) AS m
+    // There's no index on `other_prop`, so the vertices have to be scanned.
+    auto *min = storage.Create<Aggregation>(PROPERTY_LOOKUP("n", other_prop), nullptr, Aggregation::Op::MIN, false);
+    auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))), RETURN(min, AS("m"))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table, ExpectScanAllByLabel(), ExpectAggregate({min}, {}), ExpectProduce());
+  }
+
+  {
+    // Test MATCH (n :label) RETURN n.prop AS p, COUNT(*) AS c
+    // Grouping can't be done from the index.
+    auto *count = storage.Create<Aggregation>(nullptr, nullptr, Aggregation::Op::COUNT, false);
+    auto *n_prop = PROPERTY_LOOKUP("n", prop);
+    auto *query =
+        QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))), RETURN(n_prop, AS("p"), count, AS("c"))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table, ExpectScanAllByLabel(), ExpectAggregate({count}, {n_prop}),
+              ExpectProduce());
+  }
+}
+
+TYPED_TEST(TestPlanner, MatchRangeOrderedAggregate) {
+  FakeDbAccessor dba;
+  auto label = dba.Label("label");
+  auto prop = PROPERTY_PAIR("prop");
+  auto other_prop = PROPERTY_PAIR("other_prop");
+  dba.SetIndexCount(label, 1);
+  dba.SetIndexCount(label, prop.second, 1);
+  AstStorage storage;
+
+  {
+    // Test MATCH (n :label) WHERE n.prop > 1 RETURN n.prop AS p, COUNT(*) AS c
+    // The index yields the vertices ordered by `prop`, so groups are streamed.
+    auto *count = storage.Create<Aggregation>(nullptr, nullptr, Aggregation::Op::COUNT, false);
+    auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))),
+                                     WHERE(GREATER(PROPERTY_LOOKUP("n", prop), LITERAL(1))),
+                                     RETURN(PROPERTY_LOOKUP("n", prop), AS("p"), count, AS("c"))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table,
+              ExpectScanAllByLabelPropertyRange(label, prop.second, std::nullopt, std::nullopt),
+              ExpectOrderedAggregate(0), ExpectProduce());
+  }
+
+  {
+    // Test MATCH (n :label) WHERE n.prop > 1 RETURN n.other_prop AS p, COUNT(*) AS c
+    auto *count = storage.Create<Aggregation>(nullptr, nullptr, Aggregation::Op::COUNT, false);
+    auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))),
+                                     WHERE(GREATER(PROPERTY_LOOKUP("n", prop), LITERAL(1))),
+                                     RETURN(PROPERTY_LOOKUP("n", other_prop), AS("p"), count, AS("c"))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table,
+              ExpectScanAllByLabelPropertyRange(label, prop.second, std::nullopt, std::nullopt),
+              ExpectOrderedAggregate(std::nullopt), ExpectProduce());
+  }
+
+  {
+    // Test MATCH (n :label) WHERE n.prop > 1 WITH n.prop AS p, COUNT(*) AS c CREATE (m)
+    // The created vertices could be seen by the scan if the groups were
+    // streamed.
+    auto *count = storage.Create<Aggregation>(nullptr, nullptr, Aggregation::Op::COUNT, false);
+    auto *query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n", "label"))),
+                                     WHERE(GREATER(PROPERTY_LOOKUP("n", prop), LITERAL(1))),
+                                     WITH(PROPERTY_LOOKUP("n", prop), AS("p"), count, AS("c")),
+                                     CREATE(PATTERN(NODE("m")))));
+    auto symbol_table = memgraph::query::MakeSymbolTable(query);
+    auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+    CheckPlan(planner.plan(), symbol_table,
+              ExpectScanAllByLabelPropertyRange(label, prop.second, std::nullopt, std::nullopt),
+              ExpectOrderedAggregate(std::nullopt), ExpectProduce(), ExpectCreateNode(), ExpectEmptyResult());
+  }
+}
+
 TYPED_TEST(TestPlanner, MatchFilterPropIsNotNull) {
   FakeDbAccessor dba;
   auto label = dba.Label("label");
@@ -903,7 +1112,29 @@ TYPED_TEST(TestPlanner, UnwindMergeNodePropertyWithIndex) {
   std::list<BaseOpChecker *> on_create{new ExpectCreateNode()};
   auto symbol_table = memgraph::query::MakeSymbolTable(query);
   auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
-  CheckPlan(planner.plan(), symbol_table, ExpectUnwind(), ExpectMerge(on_match, on_create), ExpectEmptyResult());
+  CheckPlan(planner.plan(), symbol_table, ExpectUnwind(), ExpectMergeByLabelProperty(on_match, on_create),
+            ExpectEmptyResult());
+  DeleteListContent(&on_match);
+  DeleteListContent(&on_create);
+}
+
+TYPED_TEST(TestPlanner, MergeNodePropertyWithIndexOnCreateSet) {
+  // Test MERGE (n :label {prop: 1}) ON CREATE SET n.other = 2 with label-property index
+  AstStorage storage;
+  FakeDbAccessor dba;
+  const auto label_name = "label";
+  const auto label = dba.Label(label_name);
+  const auto property = PROPERTY_PAIR("prop");
+  dba.SetIndexCount(label, property.second, 1);
+  auto node_n = NODE("n", label_name);
+  std::get<0>(node_n->properties_)[storage.GetPropertyIx(property.first)] = LITERAL(1);
+  auto *query = QUERY(SINGLE_QUERY(
+      MERGE(PATTERN(node_n), ON_CREATE(SET(PROPERTY_LOOKUP("n", PROPERTY_PAIR("other")), LITERAL(2))))));
+  std::list<BaseOpChecker *> on_match{new ExpectScanAllByLabelPropertyValue(label, property, LITERAL(1))};
+  std::list<BaseOpChecker *> on_create{new ExpectCreateNode(), new ExpectSetProperty()};
+  auto symbol_table = memgraph::query::MakeSymbolTable(query);
+  auto planner = MakePlanner<TypeParam>(&dba, storage, symbol_table, query);
+  CheckPlan(planner.plan(), symbol_table, ExpectMergeByLabelProperty(on_match, on_create), ExpectEmptyResult());
   DeleteListContent(&on_match);
   DeleteListContent(&on_create);
 }
@@ -386,6 +386,122 @@ TEST(QueryPlan, AggregateMultipleGroupBy) {
   EXPECT_EQ(results.size(), 2 * 3 * 5);
 }
 
+TEST(QueryPlan, AggregateOrderedGroupBy) {
+  // The groups are streamed when the input is ordered by one of the group-by
+  // expressions, so they are produced in the order of the input.
+  memgraph::storage::Storage db;
+  auto storage_dba = db.Access();
+  memgraph::query::DbAccessor dba(&storage_dba);
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto aggregate_unwind = [&](Expression *input_list, bool group_by_y) {
+    // UNWIND input_list AS x UNWIND [true, false] AS y RETURN COUNT(x), AVG(x), x[, y]
+    auto x = symbol_table.CreateSymbol("x", true);
+    auto unwind_x = std::make_shared<plan::Unwind>(nullptr, input_list, x);
+    auto y = symbol_table.CreateSymbol("y", true);
+    auto unwind_y = std::make_shared<plan::Unwind>(unwind_x, LIST(LITERAL(true), LITERAL(false)), y);
+    auto x_expr = IDENT("x")->MapTo(x);
+    std::vector<Expression *> group_by{x_expr};
+    if (group_by_y) group_by.push_back(IDENT("y")->MapTo(y));
+    auto produce = MakeAggregationProduce(unwind_y, symbol_table, storage, {x_expr, x_expr},
+                                          {Aggregation::Op::COUNT, Aggregation::Op::AVG}, group_by, {}, false);
+    std::dynamic_pointer_cast<Aggregate>(produce->input())->ordered_group_by_ = 0;
+    auto context = MakeContext(storage, symbol_table, &dba);
+    return CollectProduce(*produce, &context);
+  };
+
+  {
+    auto results = aggregate_unwind(LIST(LITERAL(1), LITERAL(1), LITERAL(2), LITERAL(2.0), LITERAL(3)), false);
+    ASSERT_EQ(results.size(), 3);
+    const std::vector<int64_t> expected_counts{4, 4, 2};
+    const std::vector<double> expected_avgs{1.0, 2.0, 3.0};
+    for (size_t i = 0; i < results.size(); ++i) {
+      ASSERT_EQ(results[i].size(), 3);
+      EXPECT_EQ(results[i][0].ValueInt(), expected_counts[i]);
+      EXPECT_DOUBLE_EQ(results[i][1].ValueDouble(), expected_avgs[i]);
+      EXPECT_TRUE(TypedValue::BoolEqual{}(results[i][2], TypedValue(expected_avgs[i])));
+    }
+  }
+  {
+    // Groups sharing the ordered value are aggregated together.
+    auto results = aggregate_unwind(LIST(LITERAL(1), LITERAL(1), LITERAL(2)), true);
+    ASSERT_EQ(results.size(), 4);
+    for (size_t i = 0; i < results.size(); ++i) {
+      ASSERT_EQ(results[i].size(), 4);
+      EXPECT_EQ(results[i][2].ValueInt(), i < 2 ? 1 : 2);
+      EXPECT_EQ(results[i][0].ValueInt(), i < 2 ? 2 : 1);
+    }
+  }
+  {
+    // Without input there is a single row of default values, like when the
+    // groups aren't streamed.
+    auto results = aggregate_unwind(LIST(), false);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0][0].ValueInt(), 0);
+    EXPECT_TRUE(results[0][1].IsNull());
+  }
+}
+
+TEST(QueryPlan, AggregateOrderedGroupByMemory) {
+  // The memory of the streamed groups is reused once they are produced, so
+  // the memory of the cursor doesn't grow with the number of groups.
+  class CountingMemory final : public memgraph::utils::MemoryResource {
+   public:
+    size_t allocated_{0};
+
+   private:
+    void *DoAllocate(size_t bytes, size_t alignment) override {
+      allocated_ += bytes;
+      return memgraph::utils::NewDeleteResource()->Allocate(bytes, alignment);
+    }
+
+    void DoDeallocate(void *ptr, size_t bytes, size_t alignment) override {
+      memgraph::utils::NewDeleteResource()->Deallocate(ptr, bytes, alignment);
+    }
+
+    bool DoIsEqual(const memgraph::utils::MemoryResource &other) const noexcept override { return this == &other; }
+  };
+
+  memgraph::storage::Storage db;
+  auto storage_dba = db.Access();
+  memgraph::query::DbAccessor dba(&storage_dba);
+  auto prop = dba.NameToProperty("x");
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  // MATCH (n) RETURN COUNT(*), n.x with a group for each vertex, streamed
+  // since the vertices are scanned in the order of n.x.
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_x = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+  auto produce =
+      MakeAggregationProduce(n.op_, symbol_table, storage, {nullptr}, {Aggregation::Op::COUNT}, {n_x}, {}, false);
+  std::dynamic_pointer_cast<Aggregate>(produce->input())->ordered_group_by_ = 0;
+
+  int64_t vertices_count = 0;
+  auto aggregate_groups = [&](int64_t groups_count) {
+    for (; vertices_count < groups_count; ++vertices_count) {
+      auto vertex = dba.InsertVertex();
+      EXPECT_TRUE(vertex.SetProperty(prop, memgraph::storage::PropertyValue(vertices_count)).HasValue());
+    }
+    dba.AdvanceCommand();
+
+    CountingMemory upstream;
+    memgraph::utils::MonotonicBufferResource memory(1024, &upstream);
+    auto context = MakeContext(storage, symbol_table, &dba);
+    Frame frame(symbol_table.max_position());
+    auto cursor = produce->MakeCursor(&memory);
+    int64_t rows = 0;
+    while (cursor->Pull(frame, context)) ++rows;
+    EXPECT_EQ(rows, groups_count);
+    return upstream.allocated_;
+  };
+
+  const auto few_groups_memory = aggregate_groups(100);
+  const auto many_groups_memory = aggregate_groups(10000);
+  EXPECT_LT(many_groups_memory, 2 * few_groups_memory);
+}
+
 TEST(QueryPlan, AggregateNoInput) {
   memgraph::storage::Storage db;
   auto storage_dba = db.Access();
@@ -54,6 +54,7 @@ class PlanChecker : public virtual HierarchicalLogicalOperatorVisitor {
   }
 
   PRE_VISIT(CreateNode);
+  PRE_VISIT(UnwindCreateNode);
   PRE_VISIT(CreateExpand);
   PRE_VISIT(Delete);
   PRE_VISIT(ScanAll);
@@ -76,6 +77,7 @@ class PlanChecker : public virtual HierarchicalLogicalOperatorVisitor {
   PRE_VISIT(EdgeUniquenessFilter);
   PRE_VISIT(Accumulate);
   PRE_VISIT(Aggregate);
+  PRE_VISIT(AggregateFromIndex);
   PRE_VISIT(Skip);
   PRE_VISIT(Limit);
   PRE_VISIT(OrderBy);
@@ -84,11 +86,26 @@ class PlanChecker : public virtual HierarchicalLogicalOperatorVisitor {
     op.input()->Accept(*this);
     return false;
   }
+  bool PreVisit(MergeByLabelProperty &op) override {
+    CheckOp(op);
+    op.input()->Accept(*this);
+    return false;
+  }
   bool PreVisit(Optional &op) override {
     CheckOp(op);
     op.input()->Accept(*this);
     return false;
   }
+  bool PreVisit(SemiApply &op) override {
+    CheckOp(op);
+    op.input()->Accept(*this);
+    return false;
+  }
+  bool PreVisit(Apply &op) override {
+    CheckOp(op);
+    op.input()->Accept(*this);
+    return false;
+  }
   PRE_VISIT(Unwind);
   PRE_VISIT(Distinct);
 
@@ -135,6 +152,7 @@ class OpChecker : public BaseOpChecker {
 };
 
 using ExpectCreateNode = OpChecker<CreateNode>;
+using ExpectUnwindCreateNode = OpChecker<UnwindCreateNode>;
 using ExpectCreateExpand = OpChecker<CreateExpand>;
 using ExpectDelete = OpChecker<Delete>;
 using ExpectScanAll = OpChecker<ScanAll>;
@@ -235,6 +253,42 @@ class ExpectAggregate : public OpChecker<Aggregate> {
   std::unordered_set<memgraph::query::Expression *> group_by_;
 };
 
+class ExpectOrderedAggregate : public OpChecker<Aggregate> {
+ public:
+  explicit ExpectOrderedAggregate(std::optional<size_t> ordered_group_by) : ordered_group_by_(ordered_group_by) {}
+
+  void ExpectOp(Aggregate &op, const SymbolTable &) override { EXPECT_EQ(op.ordered_group_by_, ordered_group_by_); }
+
+ private:
+  std::optional<size_t> ordered_group_by_;
+};
+
+class ExpectAggregateFromIndex : public OpChecker<AggregateFromIndex> {
+ public:
+  ExpectAggregateFromIndex(memgraph::storage::LabelId label,
+                           const std::vector<std::pair<memgraph::query::Aggregation *,
+                                                       std::optional<memgraph::storage::PropertyId>>> &aggregations)
+      : label_(label), aggregations_(aggregations) {}
+
+  void ExpectOp(AggregateFromIndex &op, const SymbolTable &symbol_table) override {
+    EXPECT_EQ(op.label_, label_);
+    EXPECT_TRUE(dynamic_cast<Aggregate *>(op.fallback_.get()));
+    auto aggr_it = aggregations_.begin();
+    for (const auto &aggr_elem : op.aggregations_) {
+      ASSERT_NE(aggr_it, aggregations_.end());
+      const auto &[aggr, property] = *aggr_it++;
+      EXPECT_EQ(aggr_elem.op, aggr->op_);
+      EXPECT_EQ(aggr_elem.property, property);
+      EXPECT_EQ(aggr_elem.output_sym, symbol_table.at(*aggr));
+    }
+    EXPECT_EQ(aggr_it, aggregations_.end());
+  }
+
+ private:
+  memgraph::storage::LabelId label_;
+  std::vector<std::pair<memgraph::query::Aggregation *, std::optional<memgraph::storage::PropertyId>>> aggregations_;
+};
+
 class ExpectMerge : public OpChecker<Merge> {
  public:
   ExpectMerge(const std::list<BaseOpChecker *> &on_match, const std::list<BaseOpChecker *> &on_create)
@@ -252,6 +306,23 @@ class ExpectMerge : public OpChecker<Merge> {
   const std::list<BaseOpChecker *> &on_create_;
 };
 
+class ExpectMergeByLabelProperty : public OpChecker<MergeByLabelProperty> {
+ public:
+  ExpectMergeByLabelProperty(const std::list<BaseOpChecker *> &on_match, const std::list<BaseOpChecker *> &on_create)
+      : on_match_(on_match), on_create_(on_create) {}
+
+  void ExpectOp(MergeByLabelProperty &merge, const SymbolTable &symbol_table) override {
+    PlanChecker check_match(on_match_, symbol_table);
+    merge.merge_match_->Accept(check_match);
+    PlanChecker check_create(on_create_, symbol_table);
+    merge.merge_create_->Accept(check_create);
+  }
+
+ private:
+  const std::list<BaseOpChecker *> &on_match_;
+  const std::list<BaseOpChecker *> &on_create_;
+};
+
 class ExpectOptional : public OpChecker<Optional> {
  public:
   explicit ExpectOptional(const std::list<BaseOpChecker *> &optional) : optional_(optional) {}
@@ -272,6 +343,37 @@ class ExpectOptional : public OpChecker<Optional> {
   const std::list<BaseOpChecker *> &optional_;
 };
 
+class ExpectApply : public OpChecker<Apply> {
+ public:
+  ExpectApply(bool in_transactions, const std::list<BaseOpChecker *> &subquery)
+      : in_transactions_(in_transactions), subquery_(subquery) {}
+
+  void ExpectOp(Apply &apply, const SymbolTable &symbol_table) override {
+    EXPECT_EQ(apply.in_transactions_, in_transactions_);
+    PlanChecker check_subquery(subquery_, symbol_table);
+    apply.subquery_->Accept(check_subquery);
+  }
+
+ private:
+  bool in_transactions_;
+  const std::list<BaseOpChecker *> &subquery_;
+};
+
+class ExpectSemiApply : public OpChecker<SemiApply> {
+ public:
+  ExpectSemiApply(bool anti, const std::list<BaseOpChecker *> &subplan) : anti_(anti), subplan_(subplan) {}
+
+  void ExpectOp(SemiApply &semi_apply, const SymbolTable &symbol_table) override {
+    EXPECT_EQ(semi_apply.anti_, anti_);
+    PlanChecker check_subplan(subplan_, symbol_table);
+    semi_apply.subplan_->Accept(check_subplan);
+  }
+
+ private:
+  bool anti_;
+  const std::list<BaseOpChecker *> &subplan_;
+};
+
 class ExpectScanAllByLabelPropertyValue : public OpChecker<ScanAllByLabelPropertyValue> {
  public:
   ExpectScanAllByLabelPropertyValue(memgraph::storage::LabelId label,
@@ -437,6 +539,12 @@ class FakeDbAccessor {
     return false;
   }
 
+  std::shared_ptr<const memgraph::storage::GraphStatistics> GetGraphStatistics() const { return graph_statistics_; }
+
+  void SetGraphStatistics(memgraph::storage::GraphStatistics statistics) {
+    graph_statistics_ = std::make_shared<const memgraph::storage::GraphStatistics>(std::move(statistics));
+  }
+
   void SetIndexCount(memgraph::storage::LabelId label, int64_t count) { label_index_[label] = count; }
 
   void SetIndexCount(memgraph::storage::LabelId label, memgraph::storage::PropertyId property, int64_t count) {
@@ -487,6 +595,7 @@ class FakeDbAccessor {
 
   std::unordered_map<memgraph::storage::LabelId, int64_t> label_index_;
   std::vector<std::tuple<memgraph::storage::LabelId, memgraph::storage::PropertyId, int64_t>> label_property_index_;
+  std::shared_ptr<const memgraph::storage::GraphStatistics> graph_statistics_;
 };
 
 }  // namespace memgraph::query::plan
@@ -162,6 +162,74 @@ TEST(QueryPlan, CreateReturn) {
   EXPECT_EQ(1, CountIterable(dba.Vertices(memgraph::storage::View::OLD)));
 }
 
+TEST(QueryPlan, UnwindCreateNode) {
+  // test UNWIND [1, 2, 3] AS x CREATE (n:Number {value: x}) RETURN x, n
+  memgraph::storage::Storage db;
+  const auto label = db.NameToLabel("Number");
+  const auto property = db.NameToProperty("value");
+  ASSERT_FALSE(db.CreateIndex(label, property).HasError());
+  auto storage_dba = db.Access();
+  memgraph::query::DbAccessor dba(&storage_dba);
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto x = symbol_table.CreateSymbol("x", true);
+  NodeCreationInfo node;
+  node.symbol = symbol_table.CreateSymbol("n", true);
+  node.labels.emplace_back(label);
+  std::get<std::vector<std::pair<memgraph::storage::PropertyId, Expression *>>>(node.properties)
+      .emplace_back(property, IDENT("x")->MapTo(x));
+
+  auto unwind_create =
+      std::make_shared<UnwindCreateNode>(nullptr, LIST(LITERAL(1), LITERAL(2), LITERAL(3)), x, node);
+  auto named_expr_x = NEXPR("x", IDENT("x")->MapTo(x))->MapTo(symbol_table.CreateSymbol("named_expr_x", true));
+  auto named_expr_n =
+      NEXPR("n", IDENT("n")->MapTo(node.symbol))->MapTo(symbol_table.CreateSymbol("named_expr_n", true));
+  auto produce = MakeProduce(unwind_create, named_expr_x, named_expr_n);
+  auto context = MakeContext(storage, symbol_table, &dba);
+  auto results = CollectProduce(*produce, &context);
+  ASSERT_EQ(results.size(), 3);
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(results[i].size(), 2);
+    EXPECT_EQ(results[i][0].ValueInt(), i + 1);
+    auto maybe_value = results[i][1].ValueVertex().GetProperty(memgraph::storage::View::NEW, property);
+    ASSERT_TRUE(maybe_value.HasValue());
+    EXPECT_EQ(maybe_value->ValueInt(), i + 1);
+  }
+  EXPECT_EQ(context.execution_stats[ExecutionStats::Key::CREATED_NODES], 3);
+
+  dba.AdvanceCommand();
+  EXPECT_EQ(3, CountIterable(dba.Vertices(memgraph::storage::View::OLD)));
+  EXPECT_EQ(1, CountIterable(dba.Vertices(memgraph::storage::View::OLD, label, property,
+                                          memgraph::storage::PropertyValue(2))));
+}
+
+TEST(QueryPlan, UnwindCreateNodeStoppedEarly) {
+  // the vertices created for the values which weren't pulled are removed
+  memgraph::storage::Storage db;
+  auto storage_dba = db.Access();
+  memgraph::query::DbAccessor dba(&storage_dba);
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto x = symbol_table.CreateSymbol("x", true);
+  NodeCreationInfo node;
+  node.symbol = symbol_table.CreateSymbol("n", true);
+  auto unwind_create =
+      std::make_shared<UnwindCreateNode>(nullptr, LIST(LITERAL(1), LITERAL(2), LITERAL(3)), x, node);
+  auto context = MakeContext(storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = unwind_create->MakeCursor(memgraph::utils::NewDeleteResource());
+  ASSERT_TRUE(cursor->Pull(frame, context));
+  cursor->Shutdown();
+  EXPECT_EQ(context.execution_stats[ExecutionStats::Key::CREATED_NODES], 1);
+
+  dba.AdvanceCommand();
+  EXPECT_EQ(1, CountIterable(dba.Vertices(memgraph::storage::View::OLD)));
+}
+
 #ifdef MG_ENTERPRISE
 TEST(QueryPlan, FineGrainedCreateReturn) {
   memgraph::license::global_license_checker.EnableTesting();
@@ -1674,6 +1742,48 @@ TEST(QueryPlan, MergeNoInput) {
   EXPECT_EQ(1, CountIterable(dba.Vertices(memgraph::storage::View::OLD)));
 }
 
+TEST(QueryPlan, MergeByLabelProperty) {
+  // test UNWIND [1, 1, 2] AS x MERGE (n:Number {value: x}) with label-property index
+  memgraph::storage::Storage db;
+  const auto label = db.NameToLabel("Number");
+  const auto property = db.NameToProperty("value");
+  ASSERT_FALSE(db.CreateIndex(label, property).HasError());
+  auto storage_dba = db.Access();
+  memgraph::query::DbAccessor dba(&storage_dba);
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto x = symbol_table.CreateSymbol("x", true);
+  auto unwind = std::make_shared<plan::Unwind>(nullptr, LIST(LITERAL(1), LITERAL(1), LITERAL(2)), x);
+
+  // merge_match branch
+  auto n = MakeScanAllByLabelPropertyValue(storage, symbol_table, "n", label, property, "value", IDENT("x")->MapTo(x),
+                                           nullptr, memgraph::storage::View::NEW);
+
+  // merge_create branch
+  NodeCreationInfo node;
+  node.symbol = n.sym_;
+  node.labels.emplace_back(label);
+  std::get<std::vector<std::pair<memgraph::storage::PropertyId, Expression *>>>(node.properties)
+      .emplace_back(property, IDENT("x")->MapTo(x));
+  auto create = std::make_shared<CreateNode>(nullptr, node);
+
+  auto merge = std::make_shared<plan::MergeByLabelProperty>(unwind, n.op_, create, label, property,
+                                                            IDENT("x")->MapTo(x));
+  auto context = MakeContext(storage, symbol_table, &dba);
+  EXPECT_EQ(3, PullAll(*merge, &context));
+  dba.AdvanceCommand();
+  EXPECT_EQ(2, CountIterable(dba.Vertices(memgraph::storage::View::OLD)));
+  EXPECT_EQ(1, CountIterable(dba.Vertices(memgraph::storage::View::OLD, label, property,
+                                          memgraph::storage::PropertyValue(1))));
+
+  // The merged keys stay locked until the transaction ends.
+  auto other_dba = db.Access();
+  EXPECT_TRUE(other_dba.LockKey(label, property, memgraph::storage::PropertyValue(2)).HasError());
+  EXPECT_FALSE(other_dba.LockKey(label, property, memgraph::storage::PropertyValue(3)).HasError());
+}
+
 TEST(QueryPlan, SetPropertyOnNull) {
   // SET (Null).prop = 42
   memgraph::storage::Storage db;
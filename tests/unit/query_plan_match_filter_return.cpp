@@ -1777,6 +1777,9 @@ class QueryPlanExpandWeightedShortestPath : public testing::Test {
 
   Symbol total_weight = symbol_table.CreateSymbol("total_weight", true);
 
+  Symbol heuristic_edge = symbol_table.CreateSymbol("h_edge", true);
+  Symbol heuristic_node = symbol_table.CreateSymbol("h_node", true);
+
   void SetUp() {
     memgraph::license::global_license_checker.EnableTesting();
 
@@ -1808,7 +1811,7 @@ class QueryPlanExpandWeightedShortestPath : public testing::Test {
   // vertex)
   auto ExpandWShortest(EdgeAtom::Direction direction, std::optional<int> max_depth, Expression *where,
                        std::optional<int> node_id = 0, ScanAllTuple *existing_node_input = nullptr,
-                       memgraph::auth::User *user = nullptr) {
+                       memgraph::auth::User *user = nullptr, Expression *heuristic = nullptr) {
     // scan the nodes optionally filtering on property value
     auto n = MakeScanAll(storage, symbol_table, "n", existing_node_input ? existing_node_input->op_ : nullptr);
     auto last_op = n.op_;
@@ -1822,11 +1825,13 @@ class QueryPlanExpandWeightedShortestPath : public testing::Test {
     // expand wshortest
     auto node_sym = existing_node_input ? existing_node_input->sym_ : symbol_table.CreateSymbol("node", true);
     auto edge_list_sym = symbol_table.CreateSymbol("edgelist_", true);
+    std::optional<ExpansionLambda> heuristic_lambda;
+    if (heuristic) heuristic_lambda.emplace(ExpansionLambda{heuristic_edge, heuristic_node, heuristic});
     auto filter_lambda = last_op = std::make_shared<ExpandVariable>(
         last_op, n.sym_, node_sym, edge_list_sym, EdgeAtom::Type::WEIGHTED_SHORTEST_PATH, direction,
         std::vector<memgraph::storage::EdgeTypeId>{}, false, nullptr, max_depth ? LITERAL(max_depth.value()) : nullptr,
         existing_node_input != nullptr, ExpansionLambda{filter_edge, filter_node, where},
-        ExpansionLambda{weight_edge, weight_node, PROPERTY_LOOKUP(ident_e, prop)}, total_weight);
+        ExpansionLambda{weight_edge, weight_node, PROPERTY_LOOKUP(ident_e, prop)}, total_weight, heuristic_lambda);
 
     Frame frame(symbol_table.max_position());
     auto cursor = last_op->MakeCursor(memgraph::utils::NewDeleteResource());
@@ -2069,6 +2074,33 @@ TEST_F(QueryPlanExpandWeightedShortestPath, NegativeUpperBound) {
   EXPECT_THROW(ExpandWShortest(EdgeAtom::Direction::BOTH, -1, LITERAL(true)), QueryRuntimeException);
 }
 
+TEST_F(QueryPlanExpandWeightedShortestPath, Heuristic) {
+  // 4 - n.property never overestimates the remaining weight to v[4].
+  auto *ident_n = IDENT("n");
+  ident_n->MapTo(heuristic_node);
+  auto *heuristic = storage.Create<SubtractionOperator>(LITERAL(4), PROPERTY_LOOKUP(ident_n, prop));
+  auto results = ExpandWShortest(EdgeAtom::Direction::OUT, 1000, LITERAL(true), 0, nullptr, nullptr, heuristic);
+
+  // A* pops the vertices in the order of weight + estimate.
+  ASSERT_EQ(results.size(), 4);
+  EXPECT_EQ(GetProp(results[0].vertex), 2);
+  EXPECT_EQ(results[0].total_weight, 3);
+  EXPECT_EQ(GetProp(results[1].vertex), 3);
+  EXPECT_EQ(results[1].total_weight, 6);
+  EXPECT_EQ(GetProp(results[2].vertex), 1);
+  EXPECT_EQ(results[2].total_weight, 5);
+  EXPECT_EQ(GetProp(results[3].vertex), 4);
+  EXPECT_EQ(results[3].path.size(), 3);
+  EXPECT_EQ(results[3].total_weight, 9);
+}
+
+TEST_F(QueryPlanExpandWeightedShortestPath, NegativeHeuristic) {
+  EXPECT_THROW(ExpandWShortest(EdgeAtom::Direction::BOTH, 1000, LITERAL(true), 0, nullptr, nullptr, LITERAL(-1)),
+               QueryRuntimeException);
+  EXPECT_THROW(ExpandWShortest(EdgeAtom::Direction::BOTH, 1000, LITERAL(true), 0, nullptr, nullptr, LITERAL("far")),
+               QueryRuntimeException);
+}
+
 #if MG_ENTERPRISE
 TEST_F(QueryPlanExpandWeightedShortestPath, FineGrainedFiltering) {
   // All edge_types and labels allowed
@@ -2674,6 +2706,38 @@ TEST(QueryPlan, ExpandOptional) {
   EXPECT_EQ(2, v1_is_n_count);
 }
 
+TEST(QueryPlan, SemiApply) {
+  memgraph::storage::Storage db;
+  auto storage_dba = db.Access();
+  memgraph::query::DbAccessor dba(&storage_dba);
+  // Make a graph where only v1 has outgoing edges, but more than one.
+  auto v1 = dba.InsertVertex();
+  auto v2 = dba.InsertVertex();
+  auto edge_type = dba.NameToEdgeType("Edge");
+  ASSERT_TRUE(dba.InsertEdge(&v1, &v2, edge_type).HasValue());
+  ASSERT_TRUE(dba.InsertEdge(&v1, &v1, edge_type).HasValue());
+  dba.AdvanceCommand();
+
+  for (bool anti : {false, true}) {
+    AstStorage storage;
+    SymbolTable symbol_table;
+    // MATCH (n) WHERE [NOT] (n) -[r]-> (m)
+    auto n = MakeScanAll(storage, symbol_table, "n");
+    auto r_m = MakeExpand(storage, symbol_table, std::make_shared<Once>(std::vector<Symbol>{n.sym_}), n.sym_, "r",
+                          EdgeAtom::Direction::OUT, {}, "m", false, memgraph::storage::View::OLD);
+    auto semi_apply = std::make_shared<plan::SemiApply>(n.op_, r_m.op_, anti);
+    // RETURN n
+    auto n_ne = NEXPR("n", IDENT("n")->MapTo(n.sym_))->MapTo(symbol_table.CreateSymbol("n", true));
+    auto produce = MakeProduce(semi_apply, n_ne);
+    auto context = MakeContext(storage, symbol_table, &dba);
+    auto results = CollectProduce(*produce, &context);
+    // The subplan only determines whether the input row passes, so v1 is
+    // returned once even though it has two outgoing edges.
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0][0].ValueVertex(), anti ? v2 : v1);
+  }
+}
+
 TEST(QueryPlan, OptionalMatchEmptyDB) {
   memgraph::storage::Storage db;
   auto storage_dba = db.Access();
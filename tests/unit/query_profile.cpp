@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -270,3 +270,47 @@ TEST(QueryProfileTest, ComplicatedQuery) {
   EXPECT_EQ(children5[0]["name"], "Once");
   EXPECT_TRUE(children5[0]["children"].empty());
 }
+
+TEST(QueryProfileTest, MemoryAndHardwareCounters) {
+  std::chrono::duration<double> total_time{0.001};
+  ProfilingStats once{1, 10, 0, "Once", {}, 0, 0, 100, 1};
+  ProfilingStats aggregate{1, 90, 0, "Aggregate", {once}, 3072, 2048, 1000, 11};
+
+  auto table = ProfilingStatsToTable(ProfilingStatsWithTotalTime{aggregate, total_time});
+  ASSERT_EQ(table[0].size(), 6U);
+  EXPECT_EQ(table[0][4].ValueString(), "3.00KiB");
+  EXPECT_EQ(table[0][5].ValueString(), "2.00KiB");
+  EXPECT_EQ(table[1][4].ValueString(), "0B");
+
+  auto table_with_counters = ProfilingStatsToTable(ProfilingStatsWithTotalTime{aggregate, total_time, true, true});
+  ASSERT_EQ(table_with_counters[0].size(), 8U);
+  EXPECT_EQ(table_with_counters[0][6].ValueInt(), 900);
+  EXPECT_EQ(table_with_counters[0][7].ValueInt(), 10);
+  EXPECT_EQ(table_with_counters[1][6].ValueInt(), 100);
+
+  auto table_without_counters = ProfilingStatsToTable(ProfilingStatsWithTotalTime{aggregate, total_time, true, false});
+  ASSERT_EQ(table_without_counters[0].size(), 8U);
+  EXPECT_TRUE(table_without_counters[0][6].IsNull());
+  EXPECT_TRUE(table_without_counters[0][7].IsNull());
+
+  auto json = ProfilingStatsToJson(ProfilingStatsWithTotalTime{aggregate, total_time, true, true});
+  EXPECT_EQ(json["allocated_memory"], 3072);
+  EXPECT_EQ(json["peak_memory"], 2048);
+  EXPECT_EQ(json["cpu_cycles"], 900);
+  EXPECT_EQ(json["children"][0]["cache_misses"], 1);
+  EXPECT_FALSE(ProfilingStatsToJson(ProfilingStatsWithTotalTime{aggregate, total_time}).contains("cpu_cycles"));
+}
+
+TEST(QueryProfileTest, ProfilingMemoryResource) {
+  ProfilingMemoryUsage usage;
+  ProfilingMemoryResource memory(memgraph::utils::NewDeleteResource(), &usage);
+  auto *first = memory.Allocate(64);
+  auto *second = memory.Allocate(32);
+  memory.Deallocate(first, 64);
+  EXPECT_EQ(usage.allocated, 96);
+  EXPECT_EQ(usage.in_use, 32);
+  EXPECT_EQ(usage.peak, 96);
+  memory.Deallocate(second, 32);
+  EXPECT_EQ(usage.in_use, 0);
+  EXPECT_EQ(usage.peak, 96);
+}
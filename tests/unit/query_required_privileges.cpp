@@ -128,6 +128,24 @@ TEST_F(TestPrivilegeExtractor, ShowConstraintInfo) {
   EXPECT_THAT(GetRequiredPrivileges(query), UnorderedElementsAre(AuthQuery::Privilege::CONSTRAINT));
 }
 
+TEST_F(TestPrivilegeExtractor, ShowPlanCache) {
+  auto *query = storage.Create<InfoQuery>();
+  query->info_type_ = InfoQuery::InfoType::PLAN_CACHE;
+  EXPECT_THAT(GetRequiredPrivileges(query), UnorderedElementsAre(AuthQuery::Privilege::STATS));
+}
+
+TEST_F(TestPrivilegeExtractor, ShowQueryStatistics) {
+  auto *query = storage.Create<InfoQuery>();
+  query->info_type_ = InfoQuery::InfoType::QUERY_STATISTICS;
+  EXPECT_THAT(GetRequiredPrivileges(query), UnorderedElementsAre(AuthQuery::Privilege::STATS));
+}
+
+TEST_F(TestPrivilegeExtractor, ShowResourcePools) {
+  auto *query = storage.Create<InfoQuery>();
+  query->info_type_ = InfoQuery::InfoType::RESOURCE_POOLS;
+  EXPECT_THAT(GetRequiredPrivileges(query), UnorderedElementsAre(AuthQuery::Privilege::STATS));
+}
+
 TEST_F(TestPrivilegeExtractor, CreateConstraint) {
   auto *query = storage.Create<ConstraintQuery>();
   query->action_type_ = ConstraintQuery::ActionType::CREATE;
@@ -258,6 +258,58 @@ TEST_F(TestSymbolGenerator, MatchWithWhereUnbound) {
   EXPECT_THROW(memgraph::query::MakeSymbolTable(query), UnboundVariableError);
 }
 
+TEST_F(TestSymbolGenerator, MatchWherePatternPredicateUnbound) {
+  // Test MATCH (n) WHERE (n) --> (m) RETURN n
+  auto *predicate = EXISTS(PATTERN(NODE("n"), storage.Create<EdgeAtom>(storage.Create<Identifier>("anon_r", false),
+                                                                         EdgeAtom::Type::SINGLE, EdgeAtom::Direction::OUT),
+                                   NODE("m")));
+  auto query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n"))), WHERE(predicate), RETURN("n")));
+  EXPECT_THROW(memgraph::query::MakeSymbolTable(query), SemanticException);
+}
+
+TEST_F(TestSymbolGenerator, ReturnPatternPredicate) {
+  // Test MATCH (n) RETURN (n) --> ()
+  auto *predicate = EXISTS(PATTERN(NODE("n"), storage.Create<EdgeAtom>(storage.Create<Identifier>("anon_r", false),
+                                                                         EdgeAtom::Type::SINGLE, EdgeAtom::Direction::OUT),
+                                   storage.Create<NodeAtom>(storage.Create<Identifier>("anon_m", false))));
+  auto query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n"))), RETURN(predicate, AS("p"))));
+  EXPECT_THROW(memgraph::query::MakeSymbolTable(query), SemanticException);
+}
+
+TEST_F(TestSymbolGenerator, CallSubquery) {
+  // Test MATCH (n) CALL { WITH n MATCH (n) --> (m) RETURN m } RETURN n, m
+  auto *with_n = IDENT("n");
+  auto *n_in_subquery = NODE("n");
+  auto *return_m = IDENT("m");
+  auto *subquery = SINGLE_QUERY(WITH(with_n, AS("n")), MATCH(PATTERN(n_in_subquery, EDGE("r"), NODE("m"))),
+                                RETURN(return_m, AS("m")));
+  auto *outer_m = IDENT("m");
+  auto *node_n = NODE("n");
+  auto query = QUERY(SINGLE_QUERY(MATCH(PATTERN(node_n)), CALL_SUBQUERY(subquery),
+                                  RETURN(IDENT("n"), AS("n"), outer_m, AS("m"))));
+  auto symbol_table = memgraph::query::MakeSymbolTable(query);
+  // The imported variable refers to the outer `n`.
+  EXPECT_EQ(symbol_table.at(*node_n->identifier_), symbol_table.at(*with_n));
+  // The outer `m` is the one returned from the subquery.
+  auto *subquery_return = dynamic_cast<Return *>(subquery->clauses_.back());
+  EXPECT_EQ(symbol_table.at(*subquery_return->body_.named_expressions[0]), symbol_table.at(*outer_m));
+}
+
+TEST_F(TestSymbolGenerator, CallSubqueryUnboundOuterVariable) {
+  // Test MATCH (n) CALL { UNWIND [n] AS x RETURN x } RETURN x
+  // Outer variables are visible only when imported with a leading WITH.
+  auto *subquery = SINGLE_QUERY(UNWIND(LIST(IDENT("n")), AS("x")), RETURN("x"));
+  auto query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n"))), CALL_SUBQUERY(subquery), RETURN("x")));
+  EXPECT_THROW(memgraph::query::MakeSymbolTable(query), UnboundVariableError);
+}
+
+TEST_F(TestSymbolGenerator, CallSubqueryRedeclareVariable) {
+  // Test MATCH (n) CALL { MATCH (m) RETURN m AS n } RETURN n
+  auto *subquery = SINGLE_QUERY(MATCH(PATTERN(NODE("m"))), RETURN(IDENT("m"), AS("n")));
+  auto query = QUERY(SINGLE_QUERY(MATCH(PATTERN(NODE("n"))), CALL_SUBQUERY(subquery), RETURN("n")));
+  EXPECT_THROW(memgraph::query::MakeSymbolTable(query), RedeclareVariableError);
+}
+
 TEST_F(TestSymbolGenerator, CreateMultiExpand) {
   // Test CREATE (n) -[r :r]-> (m), (n) - [p :p]-> (l)
   auto r_type = "r";
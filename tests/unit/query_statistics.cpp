@@ -0,0 +1,90 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "query/query_statistics.hpp"
+
+using namespace memgraph::query;
+using namespace std::chrono_literals;
+
+TEST(QueryStatisticsTest, LatencyHistogramPercentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(50).count(), 0);
+  for (int i = 1; i <= 100; ++i) {
+    histogram.Add(std::chrono::duration<double>(i * 1e-3));
+  }
+  EXPECT_EQ(histogram.count(), 100);
+  // The estimates are within 20% above the real percentiles.
+  EXPECT_GE(histogram.Percentile(50).count(), 50e-3);
+  EXPECT_LE(histogram.Percentile(50).count(), 60e-3);
+  EXPECT_GE(histogram.Percentile(99).count(), 99e-3);
+  EXPECT_LE(histogram.Percentile(99).count(), 119e-3);
+  histogram.Add(0s);
+  histogram.Add(10h);
+  EXPECT_EQ(histogram.count(), 102);
+}
+
+TEST(QueryStatisticsTest, Aggregation) {
+  QueryStatisticsRegistry registry;
+  registry.Record(1, "MATCH (n) RETURN n", {.latency = 2s, .rows = 10, .plan_cache_hit = false, .peak_memory_bytes = 5});
+  registry.Record(1, "MATCH (n) RETURN n", {.latency = 1s, .rows = 10, .plan_cache_hit = true, .peak_memory_bytes = 3});
+  registry.Record(1, "MATCH (n) RETURN n", {.latency = 1s, .rows = 10, .plan_cache_hit = true, .peak_memory_bytes = 3});
+  registry.Record(2, "SHOW INDEX INFO", {.latency = 1ms, .rows = 1});
+
+  const auto snapshot = registry.Snapshot();
+  ASSERT_EQ(snapshot.size(), 2);
+  const auto &[hash, statistics] = snapshot[0];
+  EXPECT_EQ(hash, 1);
+  EXPECT_EQ(statistics.query, "MATCH (n) RETURN n");
+  EXPECT_EQ(statistics.calls, 3);
+  EXPECT_DOUBLE_EQ(statistics.total_latency.count(), 4);
+  EXPECT_DOUBLE_EQ(statistics.max_latency.count(), 2);
+  EXPECT_DOUBLE_EQ(statistics.LatencyPercentile(99).count(), 2);
+  EXPECT_EQ(statistics.rows, 30);
+  ASSERT_TRUE(statistics.PlanCacheHitRatio());
+  EXPECT_DOUBLE_EQ(*statistics.PlanCacheHitRatio(), 2.0 / 3);
+  EXPECT_EQ(statistics.peak_memory_bytes, 5);
+  EXPECT_FALSE(snapshot[1].second.PlanCacheHitRatio());
+
+  const auto json = QueryStatisticsToJson(registry.Snapshot(1));
+  ASSERT_EQ(json.size(), 1);
+  EXPECT_EQ(json[0]["calls"], 3);
+  EXPECT_EQ(json[0]["query_hash"], "1");
+
+  registry.Clear();
+  EXPECT_TRUE(registry.Snapshot().empty());
+}
+
+TEST(QueryStatisticsTest, EvictsLowestTotalLatency) {
+  const auto max_entries = FLAGS_query_statistics_max_entries;
+  FLAGS_query_statistics_max_entries = 8;
+  QueryStatisticsRegistry registry;
+  // A single slow call outweighs the frequent fast ones.
+  registry.Record(0, "slow", {.latency = 100ms});
+  registry.Record(1, "fast", {.latency = 1ms});
+  registry.Record(1, "fast", {.latency = 1ms});
+  for (uint64_t hash = 2; hash < 20; ++hash) {
+    registry.Record(hash, "cold", {.latency = 1ms});
+    EXPECT_LE(registry.Snapshot().size(), 8);
+  }
+  const auto snapshot = registry.Snapshot();
+  EXPECT_TRUE(std::any_of(snapshot.begin(), snapshot.end(), [](const auto &entry) { return entry.first == 0; }));
+  EXPECT_TRUE(std::any_of(snapshot.begin(), snapshot.end(), [](const auto &entry) { return entry.first == 19; }));
+
+  FLAGS_query_statistics_max_entries = 0;
+  registry.Clear();
+  registry.Record(0, "hot", {.latency = 1ms});
+  EXPECT_TRUE(registry.Snapshot().empty());
+  FLAGS_query_statistics_max_entries = max_entries;
+}
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -9,7 +9,9 @@
 // by the Apache License, Version 2.0, included in the file
 // licenses/APL.txt.
 
+#include <future>
 #include <thread>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -107,6 +109,84 @@ TEST(Rpc, Abort) {
   server.AwaitShutdown();
 }
 
+TEST(Rpc, CallAsync) {
+  memgraph::communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    memgraph::slk::Load(&req, req_reader);
+    std::this_thread::sleep_for(10ms);
+    SumRes res(req.x + req.y);
+    memgraph::slk::Save(res, res_builder);
+  });
+  server.Register<Echo>([](auto *req_reader, auto *res_builder) {
+    EchoMessage res;
+    memgraph::slk::Load(&res, req_reader);
+    memgraph::slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  memgraph::communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+
+  // All requests are sent before the first response is received.
+  std::vector<std::future<SumRes>> sums;
+  for (int i = 0; i < 10; ++i) {
+    sums.push_back(client.CallAsync<Sum>(i, i));
+  }
+  auto echo = client.CallAsync<Echo>("hello");
+  EXPECT_EQ(echo.get().data, "hello");
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(sums[i].get().sum, 2 * i);
+  }
+
+  // Synchronous calls from other threads share the connection with the
+  // streamed request.
+  auto stream = client.Stream<Echo>("hello");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&client, i] { EXPECT_EQ(client.Call<Sum>(i, 1).sum, i + 1); });
+  }
+  std::this_thread::sleep_for(10ms);
+  auto response = stream.AsyncResponse();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(response.get().data, "hello");
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, AbortAsync) {
+  memgraph::communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    memgraph::slk::Load(&req, req_reader);
+    std::this_thread::sleep_for(500ms);
+    SumRes res(req.x + req.y);
+    memgraph::slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  memgraph::communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+  auto first = client.CallAsync<Sum>(1, 2);
+  auto second = client.CallAsync<Sum>(3, 4);
+  client.Abort();
+  EXPECT_THROW(first.get(), RpcFailedException);
+  EXPECT_THROW(second.get(), RpcFailedException);
+
+  // The client reconnects on the next call.
+  EXPECT_EQ(client.Call<Sum>(5, 6).sum, 11);
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
 TEST(Rpc, ClientPool) {
   memgraph::communication::ServerContext server_context;
   Server server({"127.0.0.1", 0}, &server_context);
@@ -292,3 +372,86 @@ TEST(Rpc, StreamJumbo) {
   server.Shutdown();
   server.AwaitShutdown();
 }
+
+TEST(Rpc, CallWhileStreaming) {
+  memgraph::communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    memgraph::slk::Load(&req, req_reader);
+    SumRes res(req.x + req.y);
+    memgraph::slk::Save(res, res_builder);
+  });
+  server.Register<Echo>([](auto *req_reader, auto *res_builder) {
+    EchoMessage req;
+    memgraph::slk::Load(&req, req_reader);
+    std::string payload;
+    memgraph::slk::Load(&payload, req_reader);
+    EchoMessage res(req.data + payload);
+    memgraph::slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  // NOLINTNEXTLINE (bugprone-string-constructor)
+  std::string testdata1(5000000, 'a');
+  std::string testdata2(50000, 'b');
+
+  memgraph::communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+  auto stream = client.Stream<Echo>(testdata1);
+
+  // The call is answered while the streamed request is still being sent.
+  auto sum = client.Call<Sum>(10, 20);
+  EXPECT_EQ(sum.sum, 30);
+
+  memgraph::slk::Save(testdata2, stream.GetBuilder());
+  auto echo = stream.AwaitResponse();
+  EXPECT_EQ(echo.data, testdata1 + testdata2);
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, StreamAbandoned) {
+  memgraph::communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    memgraph::slk::Load(&req, req_reader);
+    SumRes res(req.x + req.y);
+    memgraph::slk::Save(res, res_builder);
+  });
+  server.Register<Echo>([](auto *req_reader, auto *res_builder) {
+    EchoMessage req;
+    memgraph::slk::Load(&req, req_reader);
+    std::string payload;
+    memgraph::slk::Load(&payload, req_reader);
+    EchoMessage res(req.data + payload);
+    memgraph::slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  // NOLINTNEXTLINE (bugprone-string-constructor)
+  std::string testdata(5000000, 'a');
+
+  memgraph::communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+  auto sum = client.CallAsync<Sum>(10, 20);
+  {
+    // The request is abandoned after a part of it was sent.
+    auto stream = client.Stream<Echo>(testdata);
+  }
+
+  // The calls on the connection aren't affected.
+  EXPECT_EQ(sum.get().sum, 30);
+  EXPECT_EQ(client.Call<Sum>(1, 2).sum, 3);
+  auto stream = client.Stream<Echo>("hello");
+  memgraph::slk::Save("world", stream.GetBuilder());
+  auto echo = stream.AwaitResponse();
+  EXPECT_EQ(echo.data, "helloworld");
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
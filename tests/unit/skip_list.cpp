@@ -478,6 +478,48 @@ TEST(SkipList, FindEqualOrGreater) {
   }
 }
 
+TEST(SkipList, FindLastSmallerAndLast) {
+  memgraph::utils::SkipList<uint64_t> list;
+
+  {
+    auto acc = list.access();
+    ASSERT_EQ(acc.last(), acc.end());
+    ASSERT_EQ(acc.find_last_smaller(1000), acc.end());
+    for (uint64_t i = 1000; i < 2000; i += 2) {
+      auto ret = acc.insert(i);
+      ASSERT_TRUE(ret.second);
+    }
+  }
+
+  {
+    auto acc = list.access();
+    auto last = acc.last();
+    ASSERT_NE(last, acc.end());
+    ASSERT_EQ(*last, 1998);
+    for (uint64_t i = 0; i <= 1000; ++i) {
+      auto it = acc.find_last_smaller(i);
+      ASSERT_EQ(it, acc.end());
+    }
+    for (uint64_t i = 1001; i < 2000; ++i) {
+      auto it = acc.find_last_smaller(i);
+      ASSERT_NE(it, acc.end());
+      ASSERT_EQ(*it, i - (i % 2 == 0 ? 2 : 1));
+    }
+    for (uint64_t i = 2000; i < 3000; ++i) {
+      auto it = acc.find_last_smaller(i);
+      ASSERT_NE(it, acc.end());
+      ASSERT_EQ(*it, 1998);
+    }
+  }
+
+  {
+    auto acc = list.access();
+    ASSERT_TRUE(acc.remove(1998));
+    ASSERT_EQ(*acc.last(), 1996);
+    ASSERT_EQ(*acc.find_last_smaller(1998), 1996);
+  }
+}
+
 struct Counter {
   int64_t key;
   int64_t value;
@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -14,6 +14,7 @@
 #include <cstring>
 #include <memory>
 #include <random>
+#include <span>
 #include <vector>
 
 #include "slk/streams.hpp"
@@ -296,6 +297,94 @@ TEST(Reader, MultipleSegments) {
   }
 }
 
+TEST(Builder, SaveReference) {
+  std::vector<uint8_t> buffer;
+  std::vector<const uint8_t *> references;
+  memgraph::slk::Builder builder(
+      [&buffer](const uint8_t *data, size_t size, bool have_more) {
+        for (size_t i = 0; i < size; ++i) buffer.push_back(data[i]);
+      },
+      [&buffer, &references](std::span<const std::span<const uint8_t>> buffers, bool have_more) {
+        for (const auto &data : buffers) {
+          references.push_back(data.data());
+          for (auto byte : data) buffer.push_back(byte);
+        }
+      });
+
+  auto small = GetRandomData(5);
+  auto large = GetRandomData(memgraph::slk::kSegmentMaxDataSize + 100);
+  builder.SaveReference(small.data(), small.size());
+  builder.SaveReference(large.data(), large.size());
+  builder.Finalize();
+
+  // The small data is copied into the buffered segment, while the large data
+  // is written from where it is in two segments of its own.
+  ASSERT_EQ(buffer.size(), small.size() + large.size() + 4 * sizeof(memgraph::slk::SegmentSize));
+  ASSERT_EQ(references.size(), 5);
+  ASSERT_EQ(references[2], large.data());
+  ASSERT_EQ(references[4], large.data() + memgraph::slk::kSegmentMaxDataSize);
+
+  auto splits = BufferToBinaryData(
+      buffer.data(), buffer.size(),
+      {sizeof(memgraph::slk::SegmentSize), small.size(), sizeof(memgraph::slk::SegmentSize),
+       memgraph::slk::kSegmentMaxDataSize, sizeof(memgraph::slk::SegmentSize),
+       large.size() - memgraph::slk::kSegmentMaxDataSize, sizeof(memgraph::slk::SegmentSize)});
+
+  auto datas =
+      BufferToBinaryData(large.data(), large.size(),
+                         {memgraph::slk::kSegmentMaxDataSize, large.size() - memgraph::slk::kSegmentMaxDataSize});
+
+  ASSERT_EQ(splits[0], SizeToBinaryData(small.size()));
+  ASSERT_EQ(splits[1], small);
+  ASSERT_EQ(splits[2], SizeToBinaryData(memgraph::slk::kSegmentMaxDataSize));
+  ASSERT_EQ(splits[3], datas[0]);
+  ASSERT_EQ(splits[4], SizeToBinaryData(large.size() - memgraph::slk::kSegmentMaxDataSize));
+  ASSERT_EQ(splits[5], datas[1]);
+  ASSERT_EQ(splits[6], SizeToBinaryData(0));
+}
+
+TEST(Builder, SaveReferenceWithoutVectorWrite) {
+  std::vector<uint8_t> buffer;
+  memgraph::slk::Builder builder([&buffer](const uint8_t *data, size_t size, bool have_more) {
+    for (size_t i = 0; i < size; ++i) buffer.push_back(data[i]);
+  });
+
+  auto input = GetRandomData(memgraph::slk::kSegmentMinReferenceSize);
+  builder.SaveReference(input.data(), input.size());
+  builder.Finalize();
+
+  auto splits =
+      BufferToBinaryData(buffer.data(), buffer.size(),
+                         {sizeof(memgraph::slk::SegmentSize), input.size(), sizeof(memgraph::slk::SegmentSize)});
+  ASSERT_EQ(splits[0], SizeToBinaryData(input.size()));
+  ASSERT_EQ(splits[1], input);
+  ASSERT_EQ(splits[2], SizeToBinaryData(0));
+}
+
+TEST(Reader, LoadView) {
+  std::vector<uint8_t> buffer;
+  memgraph::slk::Builder builder([&buffer](const uint8_t *data, size_t size, bool have_more) {
+    for (size_t i = 0; i < size; ++i) buffer.push_back(data[i]);
+  });
+
+  auto input = GetRandomData(memgraph::slk::kSegmentMaxDataSize + 100);
+  builder.Save(input.data(), input.size());
+  builder.Finalize();
+
+  memgraph::slk::Reader reader(buffer.data(), buffer.size());
+  std::vector<std::pair<const uint8_t *, size_t>> views;
+  reader.LoadView(input.size(), [&views](const uint8_t *data, size_t size) { views.emplace_back(data, size); });
+  reader.Finalize();
+
+  // The views point into the segments of the stream.
+  ASSERT_EQ(views.size(), 2);
+  ASSERT_EQ(views[0].first, buffer.data() + sizeof(memgraph::slk::SegmentSize));
+  ASSERT_EQ(views[1].first,
+            buffer.data() + 2 * sizeof(memgraph::slk::SegmentSize) + memgraph::slk::kSegmentMaxDataSize);
+  auto output = BinaryData(views[0].first, views[0].second) + BinaryData(views[1].first, views[1].second);
+  ASSERT_EQ(output, input);
+}
+
 TEST(CheckStreamComplete, SingleSegment) {
   std::vector<uint8_t> buffer;
   memgraph::slk::Builder builder([&buffer](const uint8_t *data, size_t size, bool have_more) {
@@ -418,3 +507,60 @@ TEST(CheckStreamComplete, InvalidSegment) {
   ASSERT_EQ(stream_size, 0);
   ASSERT_EQ(data_size, 0);
 }
+
+TEST(Reader, Parts) {
+  // Each write of the builder becomes a part of its own.
+  std::vector<std::vector<uint8_t>> parts;
+  memgraph::slk::Builder builder(
+      [&parts](const uint8_t *data, size_t size, bool have_more) { parts.emplace_back(data, data + size); });
+
+  auto input = GetRandomData(2 * memgraph::slk::kSegmentMaxDataSize + 100);
+  builder.Save(input.data(), input.size());
+  builder.Finalize();
+  ASSERT_EQ(parts.size(), 3);
+
+  std::vector<std::span<const uint8_t>> views(parts.begin(), parts.end());
+  auto [status, stream_size, data_size] = memgraph::slk::CheckStreamComplete(views);
+  ASSERT_EQ(status, memgraph::slk::StreamStatus::COMPLETE);
+  ASSERT_EQ(stream_size, input.size() + 4 * sizeof(memgraph::slk::SegmentSize));
+  ASSERT_EQ(data_size, input.size());
+
+  memgraph::slk::Reader reader(views);
+  std::vector<std::pair<const uint8_t *, size_t>> loaded;
+  reader.LoadView(input.size(), [&loaded](const uint8_t *data, size_t size) { loaded.emplace_back(data, size); });
+  reader.Finalize();
+
+  // The views point into the parts.
+  ASSERT_EQ(loaded.size(), 3);
+  BinaryData output(nullptr, 0);
+  for (size_t i = 0; i < loaded.size(); ++i) {
+    ASSERT_EQ(loaded[i].first, parts[i].data() + sizeof(memgraph::slk::SegmentSize));
+    output = output + BinaryData(loaded[i].first, loaded[i].second);
+  }
+  ASSERT_EQ(output, input);
+
+  // The parts alone aren't complete streams.
+  for (size_t i = 1; i < views.size(); ++i) {
+    auto [status, stream_size, data_size] =
+        memgraph::slk::CheckStreamComplete(std::span<const std::span<const uint8_t>>(views).first(i));
+    ASSERT_EQ(status, memgraph::slk::StreamStatus::PARTIAL);
+  }
+}
+
+TEST(CheckStreamComplete, SplitSegment) {
+  std::vector<uint8_t> buffer;
+  memgraph::slk::Builder builder([&buffer](const uint8_t *data, size_t size, bool have_more) {
+    for (size_t i = 0; i < size; ++i) buffer.push_back(data[i]);
+  });
+
+  auto input = GetRandomData(5);
+  builder.Save(input.data(), input.size());
+  builder.Finalize();
+
+  // A segment mustn't be split between the parts.
+  for (size_t i = 1; i < buffer.size() - sizeof(memgraph::slk::SegmentSize); ++i) {
+    const std::span<const uint8_t> parts[] = {{buffer.data(), i}, {buffer.data() + i, buffer.size() - i}};
+    auto [status, stream_size, data_size] = memgraph::slk::CheckStreamComplete(parts);
+    ASSERT_EQ(status, memgraph::slk::StreamStatus::INVALID);
+  }
+}
@@ -69,6 +69,82 @@ TEST(StorageV2, Commit) {
   }
 }
 
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST(StorageV2, PeriodicCommit) {
+  memgraph::storage::Storage store;
+  auto acc = store.Access();
+  auto vertex = acc.CreateVertex();
+  const auto gid = vertex.Gid();
+  ASSERT_FALSE(acc.PeriodicCommit().HasError());
+  {
+    auto other_acc = store.Access();
+    ASSERT_TRUE(other_acc.FindVertex(gid, memgraph::storage::View::OLD).has_value());
+    other_acc.Abort();
+  }
+
+  // The accessor keeps working in a new transaction and the vertex accessor
+  // obtained before the commit is still usable.
+  const auto label = acc.NameToLabel("label");
+  ASSERT_FALSE(vertex.AddLabel(label).HasError());
+  auto other_vertex = acc.CreateVertex();
+  const auto other_gid = other_vertex.Gid();
+  EXPECT_EQ(CountVertices(acc, memgraph::storage::View::NEW), 2U);
+  acc.Abort();
+
+  // Only the changes made after the periodic commit are undone.
+  auto check_acc = store.Access();
+  auto found = check_acc.FindVertex(gid, memgraph::storage::View::OLD);
+  ASSERT_TRUE(found.has_value());
+  ASSERT_FALSE(*found->HasLabel(label, memgraph::storage::View::OLD));
+  ASSERT_FALSE(check_acc.FindVertex(other_gid, memgraph::storage::View::OLD).has_value());
+  check_acc.Abort();
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST(StorageV2, CreateVertices) {
+  memgraph::storage::Storage store;
+  auto property = store.NameToProperty("property");
+  {
+    auto acc = store.Access();
+    EXPECT_TRUE(acc.CreateVertices(0).empty());
+    auto vertices = acc.CreateVertices(3);
+    ASSERT_EQ(vertices.size(), 3);
+    for (size_t i = 1; i < vertices.size(); ++i) {
+      EXPECT_EQ(vertices[i].Gid().AsUint(), vertices[i - 1].Gid().AsUint() + 1);
+    }
+    EXPECT_EQ(CountVertices(acc, memgraph::storage::View::OLD), 0U);
+    EXPECT_EQ(CountVertices(acc, memgraph::storage::View::NEW), 3U);
+
+    auto res = vertices[0].InitProperties({{property, memgraph::storage::PropertyValue(42)}});
+    ASSERT_TRUE(res.HasValue());
+    ASSERT_TRUE(*res);
+    res = vertices[0].InitProperties({{property, memgraph::storage::PropertyValue(43)}});
+    ASSERT_TRUE(res.HasValue());
+    ASSERT_FALSE(*res);
+    ASSERT_EQ(*vertices[0].GetProperty(property, memgraph::storage::View::NEW), memgraph::storage::PropertyValue(42));
+    ASSERT_TRUE(vertices[0].GetProperty(property, memgraph::storage::View::OLD)->IsNull());
+    ASSERT_FALSE(acc.Commit().HasError());
+  }
+  {
+    auto acc = store.Access();
+    EXPECT_EQ(CountVertices(acc, memgraph::storage::View::OLD), 3U);
+    auto vertex = acc.CreateVertex();
+    auto res = vertex.InitProperties({{property, memgraph::storage::PropertyValue(1)}});
+    ASSERT_TRUE(res.HasValue());
+    acc.Abort();
+  }
+  {
+    auto acc = store.Access();
+    EXPECT_EQ(CountVertices(acc, memgraph::storage::View::OLD), 3U);
+    int64_t with_property = 0;
+    for (auto vertex : acc.Vertices(memgraph::storage::View::OLD)) {
+      if (!vertex.GetProperty(property, memgraph::storage::View::OLD)->IsNull()) ++with_property;
+    }
+    EXPECT_EQ(with_property, 1);
+    acc.Abort();
+  }
+}
+
 // NOLINTNEXTLINE(hicpp-special-member-functions)
 TEST(StorageV2, Abort) {
   memgraph::storage::Storage store;
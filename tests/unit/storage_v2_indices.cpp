@@ -369,6 +369,36 @@ TEST_F(IndexTest, LabelIndexCountEstimate) {
   EXPECT_EQ(acc.ApproximateVertexCount(label2), 7);
 }
 
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(IndexTest, LabelIndexExactCount) {
+  EXPECT_FALSE(storage.CreateIndex(label1).HasError());
+
+  {
+    auto acc = storage.Access();
+    for (int i = 0; i < 10; ++i) {
+      auto vertex = CreateVertex(&acc);
+      ASSERT_NO_ERROR(vertex.AddLabel(label1));
+    }
+    EXPECT_EQ(acc.VertexCount(label1, View::OLD), 0);
+    EXPECT_EQ(acc.VertexCount(label1, View::NEW), 10);
+    ASSERT_NO_ERROR(acc.Commit());
+  }
+
+  {
+    // Removing and adding the label again creates duplicate index entries
+    // which must be counted only once.
+    auto acc = storage.Access();
+    int i = 0;
+    for (auto vertex : acc.Vertices(View::OLD)) {
+      ASSERT_NO_ERROR(vertex.RemoveLabel(label1));
+      if (i++ % 2) ASSERT_NO_ERROR(vertex.AddLabel(label1));
+    }
+    EXPECT_EQ(acc.VertexCount(label1, View::OLD), 10);
+    EXPECT_EQ(acc.VertexCount(label1, View::NEW), 5);
+    EXPECT_EQ(acc.ApproximateVertexCount(label1), 15);
+  }
+}
+
 // NOLINTNEXTLINE(hicpp-special-member-functions)
 TEST_F(IndexTest, LabelPropertyIndexCreateAndDrop) {
   EXPECT_EQ(storage.ListAllIndices().label_property.size(), 0);
@@ -624,6 +654,53 @@ TEST_F(IndexTest, LabelPropertyIndexCountEstimate) {
             2 + 3 + 4 + 5 + 6);
 }
 
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(IndexTest, LabelPropertyIndexExactCountMinMax) {
+  EXPECT_FALSE(storage.CreateIndex(label1, prop_val).HasError());
+
+  {
+    auto acc = storage.Access();
+    EXPECT_EQ(acc.VertexCount(label1, prop_val, View::OLD), 0);
+    EXPECT_TRUE(acc.MinPropertyValue(label1, prop_val, View::OLD).IsNull());
+    EXPECT_TRUE(acc.MaxPropertyValue(label1, prop_val, View::OLD).IsNull());
+
+    for (int i = 0; i < 10; ++i) {
+      auto vertex = CreateVertex(&acc);
+      ASSERT_NO_ERROR(vertex.AddLabel(label1));
+      ASSERT_NO_ERROR(vertex.SetProperty(prop_val, PropertyValue(i)));
+    }
+    // Vertices without the property or without the label aren't counted.
+    ASSERT_NO_ERROR(CreateVertex(&acc).AddLabel(label1));
+    ASSERT_NO_ERROR(CreateVertex(&acc).SetProperty(prop_val, PropertyValue(100)));
+
+    EXPECT_EQ(acc.VertexCount(label1, prop_val, View::NEW), 10);
+    EXPECT_EQ(acc.MinPropertyValue(label1, prop_val, View::NEW), PropertyValue(0));
+    EXPECT_EQ(acc.MaxPropertyValue(label1, prop_val, View::NEW), PropertyValue(9));
+    ASSERT_NO_ERROR(acc.Commit());
+  }
+
+  {
+    // The changed values are still in the index, but only the current ones
+    // are visible.
+    auto acc = storage.Access();
+    for (auto vertex : acc.Vertices(View::OLD)) {
+      auto value = vertex.GetProperty(prop_val, View::OLD);
+      ASSERT_TRUE(value.HasValue());
+      if (*value == PropertyValue(0) || *value == PropertyValue(9)) {
+        ASSERT_NO_ERROR(vertex.SetProperty(prop_val, PropertyValue(value->ValueInt() == 0 ? 5 : 4)));
+      } else if (*value == PropertyValue(1)) {
+        ASSERT_NO_ERROR(vertex.SetProperty(prop_val, PropertyValue()));
+      }
+    }
+    EXPECT_EQ(acc.VertexCount(label1, prop_val, View::OLD), 10);
+    EXPECT_EQ(acc.MinPropertyValue(label1, prop_val, View::OLD), PropertyValue(0));
+    EXPECT_EQ(acc.MaxPropertyValue(label1, prop_val, View::OLD), PropertyValue(9));
+    EXPECT_EQ(acc.VertexCount(label1, prop_val, View::NEW), 9);
+    EXPECT_EQ(acc.MinPropertyValue(label1, prop_val, View::NEW), PropertyValue(2));
+    EXPECT_EQ(acc.MaxPropertyValue(label1, prop_val, View::NEW), PropertyValue(8));
+  }
+}
+
 TEST_F(IndexTest, LabelPropertyIndexMixedIteration) {
   EXPECT_FALSE(storage.CreateIndex(label1, prop_val).HasError());
 
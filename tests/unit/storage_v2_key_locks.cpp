@@ -0,0 +1,167 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "storage/v2/key_locks.hpp"
+#include "storage/v2/storage.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace memgraph::storage;
+
+namespace {
+KeyLocks::Key MakeKey(int64_t value) {
+  return {LabelId::FromUint(1), PropertyId::FromUint(2), PropertyValue(value)};
+}
+}  // namespace
+
+TEST(KeyLocksTest, LockIsOwnedByTransaction) {
+  KeyLocks locks;
+  Transaction first(kTransactionInitialId, 1, IsolationLevel::SNAPSHOT_ISOLATION);
+  Transaction second(kTransactionInitialId + 1, 2, IsolationLevel::SNAPSHOT_ISOLATION);
+
+  auto locked = locks.Lock(MakeKey(1), first);
+  ASSERT_FALSE(locked.HasError());
+  EXPECT_TRUE(*locked);
+  // Locking the same key again is a no-op.
+  locked = locks.Lock(MakeKey(1), first);
+  ASSERT_FALSE(locked.HasError());
+  EXPECT_FALSE(*locked);
+  // Other keys are independent.
+  locked = locks.Lock(MakeKey(2), second);
+  ASSERT_FALSE(locked.HasError());
+  EXPECT_TRUE(*locked);
+
+  locked = locks.Lock(MakeKey(1), second, std::chrono::milliseconds(10));
+  ASSERT_TRUE(locked.HasError());
+  EXPECT_EQ(locked.GetError(), Error::SERIALIZATION_ERROR);
+
+  locks.Unlock({MakeKey(1)}, std::nullopt);
+  locked = locks.Lock(MakeKey(1), second);
+  ASSERT_FALSE(locked.HasError());
+  EXPECT_TRUE(*locked);
+}
+
+TEST(KeyLocksTest, WaitForOwner) {
+  for (const auto isolation_level : {IsolationLevel::SNAPSHOT_ISOLATION, IsolationLevel::READ_COMMITTED}) {
+    KeyLocks locks;
+    Transaction owner(kTransactionInitialId, 1, isolation_level);
+    Transaction waiter(kTransactionInitialId + 1, 2, isolation_level);
+    ASSERT_FALSE(locks.Lock(MakeKey(1), owner).HasError());
+
+    std::thread releaser([&locks] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      // Commits after the waiter started.
+      locks.Unlock({MakeKey(1)}, 3);
+    });
+    auto locked = locks.Lock(MakeKey(1), waiter, std::chrono::seconds(10));
+    releaser.join();
+    if (isolation_level == IsolationLevel::SNAPSHOT_ISOLATION) {
+      // The waiter can't see the changes of the owner.
+      ASSERT_TRUE(locked.HasError());
+      EXPECT_EQ(locked.GetError(), Error::SERIALIZATION_ERROR);
+    } else {
+      ASSERT_FALSE(locked.HasError());
+      EXPECT_TRUE(*locked);
+    }
+  }
+}
+
+TEST(KeyLocksTest, WaitForOwnerWithoutChanges) {
+  KeyLocks locks;
+  Transaction owner(kTransactionInitialId, 1, IsolationLevel::SNAPSHOT_ISOLATION);
+  Transaction waiter(kTransactionInitialId + 1, 2, IsolationLevel::SNAPSHOT_ISOLATION);
+  ASSERT_FALSE(locks.Lock(MakeKey(1), owner).HasError());
+
+  std::thread releaser([&locks] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    locks.Unlock({MakeKey(1)}, std::nullopt);
+  });
+  auto locked = locks.Lock(MakeKey(1), waiter, std::chrono::seconds(10));
+  releaser.join();
+  ASSERT_FALSE(locked.HasError());
+  EXPECT_TRUE(*locked);
+}
+
+TEST(KeyLocksTest, CommitTimestampKeptWithoutWaiters) {
+  KeyLocks locks;
+  Transaction owner(kTransactionInitialId, 1, IsolationLevel::SNAPSHOT_ISOLATION);
+  Transaction concurrent(kTransactionInitialId + 1, 2, IsolationLevel::SNAPSHOT_ISOLATION);
+  ASSERT_FALSE(locks.Lock(MakeKey(1), owner).HasError());
+  // Nobody waits for the lock when the owner commits.
+  locks.Unlock({MakeKey(1)}, 3);
+
+  auto locked = locks.Lock(MakeKey(1), concurrent);
+  ASSERT_TRUE(locked.HasError());
+  EXPECT_EQ(locked.GetError(), Error::SERIALIZATION_ERROR);
+
+  // The commit timestamp is kept while a transaction which can't see the
+  // changes is active.
+  locks.RemoveObsoleteEntries(2);
+  EXPECT_TRUE(locks.Lock(MakeKey(1), concurrent).HasError());
+
+  locks.RemoveObsoleteEntries(4);
+  Transaction later(kTransactionInitialId + 2, 4, IsolationLevel::SNAPSHOT_ISOLATION);
+  locked = locks.Lock(MakeKey(1), later);
+  ASSERT_FALSE(locked.HasError());
+  EXPECT_TRUE(*locked);
+}
+
+TEST(KeyLocksTest, WaitStopsOnAbort) {
+  KeyLocks locks;
+  Transaction owner(kTransactionInitialId, 1, IsolationLevel::SNAPSHOT_ISOLATION);
+  Transaction waiter(kTransactionInitialId + 1, 2, IsolationLevel::SNAPSHOT_ISOLATION);
+  ASSERT_FALSE(locks.Lock(MakeKey(1), owner).HasError());
+
+  std::atomic<bool> must_abort{false};
+  std::thread aborter([&must_abort] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    must_abort = true;
+  });
+  const auto start = std::chrono::steady_clock::now();
+  auto locked = locks.Lock(MakeKey(1), waiter, std::chrono::seconds(10), [&must_abort] { return must_abort.load(); });
+  aborter.join();
+  ASSERT_TRUE(locked.HasError());
+  EXPECT_EQ(locked.GetError(), Error::SERIALIZATION_ERROR);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(KeyLocksTest, ReleasedAtTransactionEnd) {
+  Storage storage({.transaction = {.isolation_level = IsolationLevel::READ_COMMITTED}});
+  const auto label = storage.NameToLabel("label");
+  const auto property = storage.NameToProperty("property");
+  auto first = storage.Access();
+  ASSERT_FALSE(first.LockKey(label, property, PropertyValue(1)).HasError());
+
+  std::thread committer([&first, label, property] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto vertex = first.CreateVertex();
+    ASSERT_FALSE(vertex.AddLabel(label).HasError());
+    ASSERT_FALSE(vertex.SetProperty(property, PropertyValue(1)).HasError());
+    ASSERT_FALSE(first.Commit().HasError());
+  });
+  auto second = storage.Access();
+  ASSERT_FALSE(second.LockKey(label, property, PropertyValue(1)).HasError());
+  committer.join();
+  // The key was upserted by the first transaction, which is now visible.
+  int64_t count = 0;
+  for ([[maybe_unused]] auto vertex : second.Vertices(label, View::NEW)) ++count;
+  EXPECT_EQ(count, 1);
+  second.Abort();
+
+  // Aborting releases the lock as well.
+  auto third = storage.Access();
+  ASSERT_FALSE(third.LockKey(label, property, PropertyValue(1)).HasError());
+}
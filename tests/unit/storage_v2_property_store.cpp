@@ -388,6 +388,41 @@ TEST(PropertyStore, FullSet) {
   }
 }
 
+TEST(PropertyStore, InitProperties) {
+  std::vector<memgraph::storage::PropertyValue> vec{memgraph::storage::PropertyValue(true),
+                                                    memgraph::storage::PropertyValue(123)};
+  std::map<memgraph::storage::PropertyId, memgraph::storage::PropertyValue> small{
+      {memgraph::storage::PropertyId::FromInt(1), memgraph::storage::PropertyValue(42)}};
+  std::map<memgraph::storage::PropertyId, memgraph::storage::PropertyValue> large{
+      {memgraph::storage::PropertyId::FromInt(1), memgraph::storage::PropertyValue(true)},
+      {memgraph::storage::PropertyId::FromInt(2), memgraph::storage::PropertyValue(123.5)},
+      {memgraph::storage::PropertyId::FromInt(3), memgraph::storage::PropertyValue(std::string(1000, 'a'))},
+      {memgraph::storage::PropertyId::FromInt(4), memgraph::storage::PropertyValue(vec)}};
+
+  for (const auto &data : {small, large}) {
+    memgraph::storage::PropertyStore props;
+    ASSERT_TRUE(props.InitProperties(data));
+    ASSERT_EQ(props.Properties(), data);
+    for (const auto &[prop, value] : data) {
+      ASSERT_EQ(props.GetProperty(prop), value);
+      TestIsPropertyEqual(props, prop, value);
+    }
+    // The store is the same as if the properties were set one by one.
+    auto extra = memgraph::storage::PropertyId::FromInt(5);
+    ASSERT_TRUE(props.SetProperty(extra, memgraph::storage::PropertyValue("extra")));
+    auto current = data;
+    current.emplace(extra, memgraph::storage::PropertyValue("extra"));
+    ASSERT_EQ(props.Properties(), current);
+
+    ASSERT_FALSE(props.InitProperties(data));
+    ASSERT_EQ(props.Properties(), current);
+  }
+
+  memgraph::storage::PropertyStore props;
+  ASSERT_TRUE(props.InitProperties({{memgraph::storage::PropertyId::FromInt(1), memgraph::storage::PropertyValue()}}));
+  ASSERT_EQ(props.Properties().size(), 0);
+}
+
 TEST(PropertyStore, IntEncoding) {
   std::map<memgraph::storage::PropertyId, memgraph::storage::PropertyValue> data{
       {memgraph::storage::PropertyId::FromUint(0UL),
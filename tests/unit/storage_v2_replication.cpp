@@ -1,4 +1,4 @@
-// Copyright 2022 Memgraph Ltd.
+// Copyright 2023 Memgraph Ltd.
 //
 // Use of this software is governed by the Business Source License
 // included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
@@ -510,11 +510,51 @@ TEST_F(ReplicationTest, BasicAsynchronousReplicationTest) {
     created_vertices.push_back(v.Gid());
     ASSERT_FALSE(acc.Commit().HasError());
 
-    if (i == 0) {
-      ASSERT_EQ(main_store.GetReplicaState("REPLICA_ASYNC"), memgraph::storage::replication::ReplicaState::REPLICATING);
-    } else {
-      ASSERT_EQ(main_store.GetReplicaState("REPLICA_ASYNC"), memgraph::storage::replication::ReplicaState::RECOVERY);
-    }
+    // The transactions are queued while the previous ones are being sent.
+    ASSERT_NE(main_store.GetReplicaState("REPLICA_ASYNC"), memgraph::storage::replication::ReplicaState::RECOVERY);
+  }
+
+  while (main_store.GetReplicaState("REPLICA_ASYNC") != memgraph::storage::replication::ReplicaState::READY) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  const auto replicas_info = main_store.ReplicasInfo();
+  ASSERT_EQ(replicas_info.size(), 1);
+  ASSERT_EQ(replicas_info[0].queue_info.queued_transactions, 0);
+
+  ASSERT_TRUE(std::all_of(created_vertices.begin(), created_vertices.end(), [&](const auto vertex_gid) {
+    auto acc = replica_store_async.Access();
+    auto v = acc.FindVertex(vertex_gid, memgraph::storage::View::OLD);
+    const bool exists = v.has_value();
+    EXPECT_FALSE(acc.Commit().HasError());
+    return exists;
+  }));
+}
+
+TEST_F(ReplicationTest, AsynchronousReplicationQueueOverflow) {
+  auto main_configuration = configuration;
+  main_configuration.replication.async_queue_size = 1;
+  memgraph::storage::Storage main_store(main_configuration);
+
+  memgraph::storage::Storage replica_store_async(configuration);
+
+  replica_store_async.SetReplicaRole(memgraph::io::network::Endpoint{local_host, ports[1]});
+
+  ASSERT_FALSE(main_store
+                   .RegisterReplica("REPLICA_ASYNC", memgraph::io::network::Endpoint{local_host, ports[1]},
+                                    memgraph::storage::replication::ReplicationMode::ASYNC,
+                                    memgraph::storage::replication::RegistrationMode::MUST_BE_INSTANTLY_VALID)
+                   .HasError());
+
+  // The replica falls behind by more transactions than fit into the queue, so
+  // it's recovered from the durability files.
+  static constexpr size_t vertices_create_num = 100;
+  std::vector<memgraph::storage::Gid> created_vertices;
+  for (size_t i = 0; i < vertices_create_num; ++i) {
+    auto acc = main_store.Access();
+    auto v = acc.CreateVertex();
+    created_vertices.push_back(v.Gid());
+    ASSERT_FALSE(acc.Commit().HasError());
   }
 
   while (main_store.GetReplicaState("REPLICA_ASYNC") != memgraph::storage::replication::ReplicaState::READY) {
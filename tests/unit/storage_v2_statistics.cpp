@@ -0,0 +1,159 @@
+// Copyright 2023 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "storage/v2/property_value.hpp"
+#include "storage/v2/statistics.hpp"
+#include "storage/v2/storage.hpp"
+#include "storage/v2/temporal.hpp"
+
+// NOLINTNEXTLINE(google-build-using-namespace)
+using namespace memgraph::storage;
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define ASSERT_NO_ERROR(result) ASSERT_FALSE((result).HasError())
+
+TEST(PropertyValueSamplerTest, ExactWhenEverythingIsSampled) {
+  PropertyValueSampler sampler(42);
+  for (int i = 0; i < 100; ++i) {
+    sampler.Add(PropertyValue(i / 2));
+  }
+  auto stats = std::move(sampler).Finish();
+  EXPECT_EQ(stats.count, 100);
+  EXPECT_EQ(stats.distinct_values_count, 50);
+  EXPECT_DOUBLE_EQ(stats.avg_group_size, 2);
+  EXPECT_DOUBLE_EQ(stats.histogram.EstimateEqual(PropertyValue(7)), 2);
+  EXPECT_DOUBLE_EQ(stats.histogram.EstimateEqual(PropertyValue(1000)), 0);
+  EXPECT_DOUBLE_EQ(stats.histogram.EstimateEqual(PropertyValue("7")), 0);
+  EXPECT_NEAR(stats.histogram.EstimateRange(memgraph::utils::MakeBoundInclusive(PropertyValue(25)), std::nullopt), 50,
+              4);
+  EXPECT_DOUBLE_EQ(stats.histogram.EstimateRange(std::nullopt, std::nullopt), 100);
+}
+
+TEST(PropertyValueSamplerTest, EstimatedFromSample) {
+  PropertyValueSampler sampler(42, 1000);
+  for (int i = 0; i < 100000; ++i) {
+    sampler.Add(PropertyValue(i % 1000));
+  }
+  auto stats = std::move(sampler).Finish();
+  EXPECT_EQ(stats.count, 100000);
+  EXPECT_GT(stats.distinct_values_count, 100);
+  EXPECT_LT(stats.distinct_values_count, 10000);
+  EXPECT_NEAR(stats.histogram.EstimateRange(std::nullopt, memgraph::utils::MakeBoundExclusive(PropertyValue(500))),
+              50000, 10000);
+}
+
+TEST(GraphStatisticsTest, JsonRoundTrip) {
+  NameIdMapper name_id_mapper;
+  const auto label = LabelId::FromUint(name_id_mapper.NameToId("label"));
+  const auto property = PropertyId::FromUint(name_id_mapper.NameToId("property"));
+  const auto edge_type = EdgeTypeId::FromUint(name_id_mapper.NameToId("edge_type"));
+
+  GraphStatistics statistics;
+  statistics.vertices_count = 3;
+  statistics.edges_count = 2;
+  statistics.labels[label] = {3, 1.5};
+  PropertyValueSampler sampler(42);
+  sampler.Add(PropertyValue("value"));
+  sampler.Add(PropertyValue(2));
+  sampler.Add(PropertyValue(TemporalData(TemporalType::Date, 5)));
+  statistics.label_properties.emplace(std::make_pair(label, property), std::move(sampler).Finish());
+  statistics.edge_types[edge_type] = {2, 1, 1, 2, 2};
+
+  const auto json = GraphStatisticsToJson(statistics, name_id_mapper);
+  NameIdMapper other_name_id_mapper;
+  const auto restored = JsonToGraphStatistics(json, &other_name_id_mapper);
+  ASSERT_TRUE(restored);
+  EXPECT_EQ(GraphStatisticsToJson(*restored, other_name_id_mapper), json);
+
+  EXPECT_FALSE(JsonToGraphStatistics(nlohmann::json::parse("{\"vertices_count\": \"three\"}"), &other_name_id_mapper));
+}
+
+TEST(GraphStatisticsTest, AnalyzeGraph) {
+  Storage storage;
+  auto acc = storage.Access();
+  const auto label = acc.NameToLabel("label");
+  const auto property = acc.NameToProperty("property");
+  const auto edge_type = acc.NameToEdgeType("edge_type");
+  auto hub = acc.CreateVertex();
+  ASSERT_NO_ERROR(hub.AddLabel(label));
+  for (int i = 0; i < 4; ++i) {
+    auto vertex = acc.CreateVertex();
+    ASSERT_NO_ERROR(vertex.SetProperty(property, PropertyValue(i)));
+    ASSERT_NO_ERROR(vertex.AddLabel(label));
+    ASSERT_NO_ERROR(acc.CreateEdge(&hub, &vertex, edge_type));
+  }
+  ASSERT_NO_ERROR(acc.Commit());
+
+  EXPECT_FALSE(storage.GetGraphStatistics());
+  auto analyze_acc = storage.Access();
+  const auto statistics = analyze_acc.AnalyzeGraph();
+  ASSERT_TRUE(statistics);
+  EXPECT_EQ(statistics, storage.GetGraphStatistics());
+  EXPECT_EQ(statistics->vertices_count, 5);
+  EXPECT_EQ(statistics->edges_count, 4);
+
+  const auto *label_stats = statistics->GetLabelStats(label);
+  ASSERT_TRUE(label_stats);
+  EXPECT_EQ(label_stats->count, 5);
+  EXPECT_DOUBLE_EQ(label_stats->avg_degree, 8.0 / 5);
+  EXPECT_DOUBLE_EQ(label_stats->avg_out_degree, 4.0 / 5);
+  EXPECT_DOUBLE_EQ(label_stats->avg_in_degree, 4.0 / 5);
+
+  const auto *label_property_stats = statistics->GetLabelPropertyStats(label, property);
+  ASSERT_TRUE(label_property_stats);
+  EXPECT_EQ(label_property_stats->count, 4);
+  EXPECT_EQ(label_property_stats->distinct_values_count, 4);
+
+  const auto *edge_type_stats = statistics->GetEdgeTypeStats(edge_type);
+  ASSERT_TRUE(edge_type_stats);
+  EXPECT_EQ(edge_type_stats->count, 4);
+  EXPECT_EQ(edge_type_stats->from_vertices_count, 1);
+  EXPECT_EQ(edge_type_stats->to_vertices_count, 4);
+  EXPECT_EQ(edge_type_stats->max_out_degree, 4);
+  EXPECT_EQ(edge_type_stats->max_in_degree, 1);
+
+  EXPECT_TRUE(storage.ClearGraphStatistics());
+  EXPECT_FALSE(storage.GetGraphStatistics());
+}
+
+TEST(GraphStatisticsTest, RestoredOnStartup) {
+  const auto storage_directory = std::filesystem::temp_directory_path() / "MG_test_unit_storage_v2_statistics";
+  std::filesystem::remove_all(storage_directory);
+  Config config{.durability = {.storage_directory = storage_directory, .recover_on_startup = true}};
+  {
+    Storage storage(config);
+    auto acc = storage.Access();
+    auto vertex = acc.CreateVertex();
+    ASSERT_NO_ERROR(vertex.AddLabel(acc.NameToLabel("label")));
+    ASSERT_NO_ERROR(acc.Commit());
+    auto analyze_acc = storage.Access();
+    analyze_acc.AnalyzeGraph();
+  }
+  {
+    Storage storage(config);
+    const auto statistics = storage.GetGraphStatistics();
+    ASSERT_TRUE(statistics);
+    EXPECT_EQ(statistics->vertices_count, 1);
+    const auto *label_stats = statistics->GetLabelStats(storage.NameToLabel("label"));
+    ASSERT_TRUE(label_stats);
+    EXPECT_EQ(label_stats->count, 1);
+    EXPECT_TRUE(storage.ClearGraphStatistics());
+  }
+  {
+    Storage storage(config);
+    EXPECT_FALSE(storage.GetGraphStatistics());
+  }
+  std::filesystem::remove_all(storage_directory);
+}